@@ -0,0 +1,102 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "contracts/IAudioEngine.h"
+#include "contracts/IParamBridge.h"
+#include "contracts/IRtCommandQueue.h"
+#include "runtime/AudioGraph.h"
+#include "runtime/CompiledAudioGraph.h"
+
+namespace avantgarde {
+std::unique_ptr<IAudioEngine> MakeAudioEngine(IRtCommandQueue* q, IParamBridge* p);
+}
+
+namespace avantgarde::bench {
+namespace {
+
+constexpr std::size_t kBlockFrames = 256;
+constexpr uint32_t kTracks = 8;
+
+// Синтетический трек: дешевый генератор, чтобы в замере доминировала маршрутизация.
+struct RampTrack final : ITrack {
+    float gain{0.1f};
+    uint32_t phase{0};
+
+    bool healthcheck() const noexcept override { return true; }
+    void addModule(std::unique_ptr<IAudioModule>) override {}
+    IAudioModule* getModule(std::size_t) override { return nullptr; }
+    void onRtCommand(const RtCommand&) noexcept override {}
+    bool getSnapshot(SnapshotRecord& out) const noexcept override {
+        out = SnapshotRecord{};
+        return true;
+    }
+    void process(const AudioProcessContext& ctx) override {
+        for (std::size_t i = 0; i < ctx.nframes; ++i) {
+            const float v = gain * static_cast<float>((phase + i) & 63U);
+            ctx.out[0][i] += v;
+            if (ctx.numOut > 1) ctx.out[1][i] += v;
+        }
+        phase += static_cast<uint32_t>(ctx.nframes);
+    }
+};
+
+enum class Routing { Fixed, GraphFlat, GraphBuses };
+
+// 8 треков -> master: напрямую (Fixed), через граф без шин (GraphFlat)
+// и через граф с двумя mix-шинами (GraphBuses).
+BenchResult runRouting(const std::string& name, Routing routing) {
+    auto engine = MakeAudioEngine(nullptr, nullptr);
+    engine->setSampleRate(48000.0);
+    for (uint32_t t = 0; t < kTracks; ++t) {
+        auto tr = std::make_unique<RampTrack>();
+        tr->gain = 0.01f * static_cast<float>(t + 1);
+        engine->registerTrack(std::move(tr));
+    }
+
+    AudioGraph graph;
+    if (routing != Routing::Fixed) {
+        const NodeKind source = static_cast<NodeKind>(GraphNodeKindValue::TrackSource);
+        const NodeKind mix = static_cast<NodeKind>(GraphNodeKindValue::Mix);
+        const NodeKind master = static_cast<NodeKind>(GraphNodeKindValue::MasterOut);
+        (void)graph.addNode({100, master, 0});
+        (void)graph.addNode({50, mix, 0});
+        (void)graph.addNode({51, mix, 0});
+        (void)graph.addEdge({50, 100});
+        (void)graph.addEdge({51, 100});
+        for (uint32_t t = 0; t < kTracks; ++t) {
+            const NodeId id = static_cast<NodeId>(t + 1);
+            (void)graph.addNode({id, source, 0});
+            (void)graph.bindTrack(id, t);
+            const NodeId dst = (routing == Routing::GraphFlat) ? NodeId{100}
+                                                               : static_cast<NodeId>(50 + t % 2);
+            (void)graph.addEdge({id, dst});
+        }
+        (void)engine->setRoutingGraph(&graph);
+    }
+
+    std::vector<float> out0(kBlockFrames), out1(kBlockFrames);
+    float* outs[2] = {out0.data(), out1.data()};
+    AudioProcessContext ctx{};
+    ctx.out = outs;
+    ctx.nframes = kBlockFrames;
+    ctx.numOut = 2;
+
+    return measure(name, static_cast<double>(kTracks) * static_cast<double>(kBlockFrames), "track-frame", [&]() {
+        engine->processBlock(ctx);
+        doNotOptimize(out0[0]);
+    });
+}
+
+} // namespace
+
+void registerAudioGraphBenches(std::vector<BenchCase>& out) {
+    out.push_back({"engine.routing.fixed", [](const std::string& n) { return runRouting(n, Routing::Fixed); }});
+    out.push_back({"engine.routing.graph_flat", [](const std::string& n) { return runRouting(n, Routing::GraphFlat); }});
+    out.push_back({"engine.routing.graph_buses", [](const std::string& n) { return runRouting(n, Routing::GraphBuses); }});
+}
+
+} // namespace avantgarde::bench
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace avantgarde::bench {
+
+// Результат одного микробенчмарка.
+struct BenchResult {
+    std::string name;
+    uint64_t iterations{0};
+    double nsPerIteration{0.0};
+    // Сколько "единиц работы" в одной итерации (кадров, голосов*кадров, команд...).
+    double itemsPerIteration{1.0};
+    std::string itemLabel{"item"};
+    // Байт входных данных за итерацию (декодеры); 0 — пропускная способность не считается.
+    double bytesPerIteration{0.0};
+
+    double nsPerItem() const noexcept {
+        return (itemsPerIteration > 0.0) ? (nsPerIteration / itemsPerIteration) : 0.0;
+    }
+    double mbPerSecond() const noexcept {
+        return (nsPerIteration > 0.0) ? (bytesPerIteration * 1e3 / nsPerIteration) : 0.0;
+    }
+};
+
+struct BenchCase {
+    std::string name;
+    BenchResult (*run)(const std::string& name);
+};
+
+// Не дает компилятору выкинуть результат измеряемого кода.
+template <class T>
+inline void doNotOptimize(T const& value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+// Прогрев + удвоение числа итераций, пока замер не займет minSeconds.
+template <class Fn>
+BenchResult measure(std::string name, double itemsPerIteration, std::string itemLabel, Fn&& fn,
+                    double minSeconds = 0.2) {
+    using Clock = std::chrono::steady_clock;
+    for (int i = 0; i < 16; ++i) {
+        fn();
+    }
+
+    uint64_t iters = 64;
+    double elapsedNs = 0.0;
+    for (;;) {
+        const auto t0 = Clock::now();
+        for (uint64_t i = 0; i < iters; ++i) {
+            fn();
+        }
+        elapsedNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+        if (elapsedNs >= minSeconds * 1e9 || iters >= (1ULL << 40)) {
+            break;
+        }
+        iters *= 2;
+    }
+
+    BenchResult r{};
+    r.name = std::move(name);
+    r.iterations = iters;
+    r.nsPerIteration = elapsedNs / static_cast<double>(iters);
+    r.itemsPerIteration = itemsPerIteration;
+    r.itemLabel = std::move(itemLabel);
+    return r;
+}
+
+// Регистрация наборов (по одному на подсистему).
+void registerClipTrackBenches(std::vector<BenchCase>& out);
+void registerVoicePoolBenches(std::vector<BenchCase>& out);
+void registerFxModuleBenches(std::vector<BenchCase>& out);
+void registerRtQueueBenches(std::vector<BenchCase>& out);
+void registerAudioGraphBenches(std::vector<BenchCase>& out);
+void registerUiRenderBenches(std::vector<BenchCase>& out);
+void registerWavDecoderBenches(std::vector<BenchCase>& out);
+
+} // namespace avantgarde::bench
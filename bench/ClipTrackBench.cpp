@@ -0,0 +1,119 @@
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "runtime/ClipTrack.cpp"
+
+namespace avantgarde::bench {
+namespace {
+
+constexpr std::size_t kBlockFrames = 256;
+
+SharedClipBuffer makeClip(int frames, int sampleRate) {
+    auto l = std::shared_ptr<float[]>(new float[static_cast<std::size_t>(frames)]);
+    auto r = std::shared_ptr<float[]>(new float[static_cast<std::size_t>(frames)]);
+    for (int i = 0; i < frames; ++i) {
+        l[static_cast<std::size_t>(i)] = 0.5f * std::sin(0.01f * static_cast<float>(i));
+        r[static_cast<std::size_t>(i)] = 0.5f * std::cos(0.013f * static_cast<float>(i));
+    }
+    SharedClipBuffer b{};
+    b.sampleRate = sampleRate;
+    b.channels = 2;
+    b.frames = frames;
+    b.ch0 = l;
+    b.ch1 = r;
+    return b;
+}
+
+RtCommand trackCmd(CmdId id, uint16_t index, float value, int16_t slot = -1) {
+    RtCommand c{};
+    c.id = toWireCmdId(id);
+    c.track = 0;
+    c.slot = slot;
+    c.index = index;
+    c.value = value;
+    return c;
+}
+
+// Рендер зацикленного клипа одним playhead на заданной скорости (ns на выходной кадр).
+// clipRate == 48000 и speed == 1 — путь без ресэмплинга; остальное — интерполяция.
+BenchResult runSpeed(const std::string& name, float speed, int clipRate) {
+    ClipTrackImpl track(48000.0, 0);
+    (void)track.loadSlotFromBuffer(0, makeClip(48000 * 4, clipRate));
+    (void)track.setSlotLooping(0, true);
+    track.onRtCommand(trackCmd(CmdId::ParamSet, toParamIndex(TrackParamId::FollowTransportEnabled), 0.0f));
+    track.onRtCommand(trackCmd(CmdId::ParamSet, toParamIndex(TrackParamId::LoopEnabled), 1.0f));
+    track.onRtCommand(trackCmd(CmdId::ParamSet, toParamIndex(TrackParamId::PlaybackInc), speed));
+    track.onRtCommand(trackCmd(CmdId::Play, 0, 1.0f, 0));
+
+    std::vector<float> out0(kBlockFrames), out1(kBlockFrames);
+    float* outs[2] = {out0.data(), out1.data()};
+    AudioProcessContext ctx{};
+    ctx.out = outs;
+    ctx.nframes = kBlockFrames;
+    ctx.numOut = 2;
+
+    return measure(name, static_cast<double>(kBlockFrames), "frame", [&]() {
+        track.process(ctx);
+        doNotOptimize(out0[0]);
+    });
+}
+
+// Tempo sync 4-секундного клипа на 2 такта: bpm задает скорость (90 -> 0.75, 160 -> 1.33),
+// mode — varispeed или WSOLA time-stretch (ns на выходной кадр).
+BenchResult runTempoSync(const std::string& name, float bpm, TempoSyncModeValue mode) {
+    ClipTrackImpl track(48000.0, 0);
+    (void)track.loadSlotFromBuffer(0, makeClip(48000 * 4, 48000));
+    (void)track.setSlotLooping(0, true);
+    (void)track.setSlotLengthInBars(0, 2);
+    track.onRtCommand(trackCmd(CmdId::ParamSet, toParamIndex(TrackParamId::FollowTransportEnabled), 0.0f));
+    track.onRtCommand(trackCmd(CmdId::ParamSet, toParamIndex(TrackParamId::TempoSyncMode), toParamValue(mode)));
+    track.onRtCommand(trackCmd(CmdId::SetTempoBpm, 0, bpm));
+    track.onRtCommand(trackCmd(CmdId::Play, 0, 1.0f, 0));
+
+    std::vector<float> out0(kBlockFrames), out1(kBlockFrames);
+    float* outs[2] = {out0.data(), out1.data()};
+    AudioProcessContext ctx{};
+    ctx.out = outs;
+    ctx.nframes = kBlockFrames;
+    ctx.numOut = 2;
+
+    return measure(name, static_cast<double>(kBlockFrames), "frame", [&]() {
+        track.process(ctx);
+        doNotOptimize(out0[0]);
+    });
+}
+
+// Анализ клипа для time-stretch при загрузке (ns на кадр клипа): 10 с stereo.
+BenchResult runStretchAnalysis(const std::string& name) {
+    const SharedClipBuffer clip = makeClip(48000 * 10, 48000);
+    return measure(name, static_cast<double>(clip.frames), "frame", [&]() {
+        const auto a = analyzeClipForStretch(clip);
+        doNotOptimize(a->mono[0]);
+    });
+}
+
+} // namespace
+
+void registerClipTrackBenches(std::vector<BenchCase>& out) {
+    out.push_back({"cliptrack.render.native_1x", [](const std::string& n) { return runSpeed(n, 1.0f, 48000); }});
+    out.push_back({"cliptrack.render.44k1_1x", [](const std::string& n) { return runSpeed(n, 1.0f, 44100); }});
+    out.push_back({"cliptrack.render.speed_0.5x", [](const std::string& n) { return runSpeed(n, 0.5f, 48000); }});
+    out.push_back({"cliptrack.render.speed_1.37x", [](const std::string& n) { return runSpeed(n, 1.37f, 48000); }});
+    out.push_back({"cliptrack.render.speed_2x", [](const std::string& n) { return runSpeed(n, 2.0f, 48000); }});
+    out.push_back({"cliptrack.render.speed_4x", [](const std::string& n) { return runSpeed(n, 4.0f, 48000); }});
+    out.push_back({"cliptrack.stretch.varispeed_0.75x",
+                   [](const std::string& n) { return runTempoSync(n, 90.0f, TempoSyncModeValue::Varispeed); }});
+    out.push_back({"cliptrack.stretch.wsola_0.75x",
+                   [](const std::string& n) { return runTempoSync(n, 90.0f, TempoSyncModeValue::Stretch); }});
+    out.push_back({"cliptrack.stretch.varispeed_1.33x",
+                   [](const std::string& n) { return runTempoSync(n, 160.0f, TempoSyncModeValue::Varispeed); }});
+    out.push_back({"cliptrack.stretch.wsola_1.33x",
+                   [](const std::string& n) { return runTempoSync(n, 160.0f, TempoSyncModeValue::Stretch); }});
+    out.push_back({"cliptrack.stretch.analysis_10s", [](const std::string& n) { return runStretchAnalysis(n); }});
+}
+
+} // namespace avantgarde::bench
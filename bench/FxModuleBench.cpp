@@ -0,0 +1,102 @@
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "contracts/IAudioModule.h"
+#include "contracts/ids.h"
+#include "module/BufferFxModule.h"
+#include "module/SchroederReverbModule.h"
+#include "module/StutterModule.h"
+#include "module/SuperGlitchModule.h"
+#include "module/GainSlewModule.cpp"
+#include "module/OnePoleHPFModule.cpp"
+
+namespace avantgarde::bench {
+namespace {
+
+constexpr std::size_t kBlockFrames = 256;
+constexpr double kSampleRate = 48000.0;
+
+// Один FX-модуль на стерео-блоке шума с бегущим транспортом (tempo-sync FX должны
+// реально переключать слайсы/гейты). ns на кадр блока.
+BenchResult runModule(const std::string& name,
+                      std::unique_ptr<IAudioModule> mod,
+                      std::vector<std::pair<uint16_t, float>> params,
+                      bool modulateParam0 = false) {
+    mod->init(kSampleRate, kBlockFrames);
+    mod->reset();
+    for (const auto& [index, value] : params) {
+        mod->setParam(index, value);
+    }
+
+    std::vector<float> in0(kBlockFrames), in1(kBlockFrames), out0(kBlockFrames), out1(kBlockFrames);
+    uint32_t seed = 0x12345u;
+    for (std::size_t i = 0; i < kBlockFrames; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        in0[i] = static_cast<float>(static_cast<int32_t>(seed >> 8) - (1 << 23)) / static_cast<float>(1 << 24);
+        in1[i] = 0.7f * in0[i];
+    }
+    const float* ins[2] = {in0.data(), in1.data()};
+    float* outs[2] = {out0.data(), out1.data()};
+    AudioProcessContext ctx{};
+    ctx.in = ins;
+    ctx.out = outs;
+    ctx.nframes = kBlockFrames;
+    ctx.numOut = 2;
+    ctx.transportValid = true;
+    ctx.transportPlaying = true;
+    ctx.transportBpm = 128.0f;
+
+    uint64_t block = 0;
+    return measure(name, static_cast<double>(kBlockFrames), "frame", [&]() {
+        if (modulateParam0) {
+            // Каждый блок — новая цель: модуль все время в режиме сглаживания.
+            mod->setParam(0, (block & 1u) ? 0.9f : 0.3f);
+        }
+        mod->beginBlock();
+        mod->process(ctx);
+        ctx.transportSampleTime += kBlockFrames;
+        ++block;
+        doNotOptimize(out0[0]);
+    });
+}
+
+} // namespace
+
+void registerFxModuleBenches(std::vector<BenchCase>& out) {
+    out.push_back({"fx.buffer_fx", [](const std::string& n) {
+        return runModule(n, std::make_unique<BufferFxModule>(),
+                         {{toParamIndex(BufferFxParamId::Mix), 1.0f},
+                          {toParamIndex(BufferFxParamId::Repeat), 0.8f},
+                          {toParamIndex(BufferFxParamId::Jitter), 0.5f}});
+    }});
+    out.push_back({"fx.super_glitch", [](const std::string& n) {
+        return runModule(n, std::make_unique<SuperGlitchModule>(),
+                         {{toParamIndex(SuperGlitchParamId::Mix), 1.0f},
+                          {toParamIndex(SuperGlitchParamId::Subslice), 0.75f},
+                          {toParamIndex(SuperGlitchParamId::Hold), 0.6f}});
+    }});
+    out.push_back({"fx.stutter", [](const std::string& n) {
+        return runModule(n, std::make_unique<StutterModule>(),
+                         {{toParamIndex(StutterParamId::Wet), 1.0f},
+                          {toParamIndex(StutterParamId::Rate), 0.7f},
+                          {toParamIndex(StutterParamId::Gate), 0.5f}});
+    }});
+    out.push_back({"fx.schroeder_reverb", [](const std::string& n) {
+        return runModule(n, std::make_unique<SchroederReverbModule>(),
+                         {{toParamIndex(ReverbParamId::Wet), 0.5f},
+                          {toParamIndex(ReverbParamId::Room), 0.8f}});
+    }});
+    out.push_back({"fx.one_pole_hpf", [](const std::string& n) {
+        return runModule(n, std::make_unique<OnePoleHPFModule>(), {{toParamIndex(HpfParamId::Cutoff), 0.3f}});
+    }});
+    out.push_back({"fx.gain_slew", [](const std::string& n) {
+        return runModule(n, std::make_unique<GainSlewModule>(), {}, /*modulateParam0*/ true);
+    }});
+}
+
+} // namespace avantgarde::bench
@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "contracts/IParameterized.h"
+#include "contracts/ids.h"
+#include "runtime/ParamBridgeDualBuffer.cpp"
+#include "runtime/RtCommandQueueSPSC.cpp"
+#include "service/audio/RecordRing.h"
+
+namespace avantgarde::bench {
+namespace {
+
+constexpr std::size_t kBatch = 64;
+
+// Пачка push, затем пачка pop — так очередь проходит и по заполнению, и по wrap-around.
+BenchResult runSpscPushPop(const std::string& name) {
+    RtCommandQueueSPSC q(1024);
+    RtCommand cmd{};
+    cmd.id = toWireCmdId(CmdId::ParamSet);
+    cmd.track = 0;
+    cmd.slot = 0;
+    return measure(name, static_cast<double>(kBatch), "command", [&]() {
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            cmd.index = static_cast<uint16_t>(i);
+            (void)q.push(cmd);
+        }
+        RtCommand out{};
+        float acc = 0.0f;
+        while (q.pop(out)) {
+            acc += out.value;
+        }
+        doNotOptimize(acc);
+    });
+}
+
+// Минимальная цель резолвера: стоимость замера — сам мост, а не setParam.
+struct SinkParams final : IParameterized {
+    float last{0.0f};
+    std::size_t getParamCount() const override { return 8; }
+    float getParam(std::size_t) const override { return last; }
+    void setParam(std::size_t, float v) override { last = v; }
+    const ParamMeta& getParamMeta(std::size_t) const override {
+        static const ParamMeta kMeta{};
+        return kMeta;
+    }
+};
+
+SinkParams gSink{};
+
+IParameterized* resolveSink(Target) noexcept { return &gSink; }
+
+// kBatch pushParam (control) + swapBuffers с применением через резолвер (RT пролог блока).
+BenchResult runParamBridge(const std::string& name) {
+    ParamBridgeDualBuffer pb(256, &resolveSink);
+    float v = 0.0f;
+    return measure(name, static_cast<double>(kBatch), "param", [&]() {
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            v = (v > 0.99f) ? 0.0f : v + 0.01f;
+            pb.pushParam(Target{0, static_cast<int>(i & 3u)}, i & 7u, v);
+        }
+        pb.swapBuffers();
+        doNotOptimize(gSink.last);
+    });
+}
+
+// Пустой swapBuffers: цена пролога блока, когда control ничего не прислал.
+BenchResult runParamBridgeIdle(const std::string& name) {
+    ParamBridgeDualBuffer pb(256, &resolveSink);
+    return measure(name, 1.0, "swap", [&]() {
+        pb.swapBuffers();
+        doNotOptimize(gSink.last);
+    });
+}
+
+// RT-цена записи master out: push блока 256 кадров stereo в кольцо рекордера
+// (consume — работа писателя, здесь только освобождает место).
+BenchResult runRecordRingPush(const std::string& name) {
+    constexpr std::size_t kFrames = 256;
+    RecordRing ring{};
+    (void)ring.allocate(2, 48000);
+    std::vector<float> l(kFrames, 0.25f);
+    std::vector<float> r(kFrames, -0.25f);
+    const float* ch[2] = {l.data(), r.data()};
+    return measure(name, static_cast<double>(kFrames), "frame", [&]() {
+        const bool ok = ring.push(ch, kFrames);
+        doNotOptimize(ok);
+        ring.consume(kFrames);
+    });
+}
+
+} // namespace
+
+void registerRtQueueBenches(std::vector<BenchCase>& out) {
+    out.push_back({"rtqueue.spsc.push_pop", runSpscPushPop});
+    out.push_back({"parambridge.push_swap", runParamBridge});
+    out.push_back({"parambridge.swap_idle", runParamBridgeIdle});
+    out.push_back({"recorder.ring.push", runRecordRingPush});
+}
+
+} // namespace avantgarde::bench
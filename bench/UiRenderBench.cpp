@@ -0,0 +1,105 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "contracts/IUi.h"
+#include "contracts/UiPreparedLayout.h"
+#include "platform/raspi/RpiPixelCanvas.h"
+#include "platform/raspi/RpiPrimitiveScenePainter.h"
+#include "service/ui/UiLayoutJsonLoader.h"
+#include "service/ui/UiWidgetFactory.h"
+#include "service/ui/layout/UiLayoutEngine.h"
+
+namespace avantgarde::bench {
+namespace {
+
+// Layout-шаблоны берем из дерева исходников: бенч не зависит от cwd запуска.
+const std::string kLayoutsDir = std::string(AVANTGARDE_SOURCE_DIR) + "/assets/ui/layouts";
+
+// Типичное состояние главного экрана: 8 треков с клипами, транспорт играет.
+UiState makeTracksState() {
+    UiState state{};
+    state.tracks.resize(8);
+    for (uint8_t t = 0; t < 8; ++t) {
+        state.tracks[t].id = t;
+        state.tracks[t].clipName = "loop_" + std::to_string(t) + ".wav";
+        state.tracks[t].state = (t % 2 == 0) ? UiTrackState::Playing : UiTrackState::Stopped;
+        state.tracks[t].meterPeak = 0.1f * static_cast<float>(t);
+    }
+    state.transport.playing = true;
+    state.transport.bpm = 128.0f;
+    return state;
+}
+
+UiNavState makeTracksNav() {
+    UiNavState nav{};
+    nav.scene = UiScene::Tracks;
+    nav.selectedTrack = 2;
+    return nav;
+}
+
+// Отметка "не удалось подготовить" вместо падения всего прогона.
+BenchResult skipped(const std::string& name, const char* why) {
+    std::fprintf(stderr, "%s: skipped (%s)\n", name.c_str(), why);
+    BenchResult r{};
+    r.name = name;
+    r.itemLabel = "skipped";
+    return r;
+}
+
+// measure + arrange дерева главного экрана (ns на вызов).
+BenchResult runArrange(const std::string& name) {
+    UiLayoutTemplate tpl{};
+    std::string err{};
+    if (!UiLayoutJsonLoader::loadFromFile(kLayoutsDir + "/tracks.json", tpl, err)) {
+        return skipped(name, err.c_str());
+    }
+    return measure(name, 1.0, "call", [&]() {
+        const UiLayoutEngine::Result r = UiLayoutEngine::arrange(tpl.root, 60, 24);
+        doNotOptimize(r.boxes.size());
+    });
+}
+
+// Полный кадр RPi painter-а (prepared layout главного экрана -> 800x480 canvas), ns на кадр.
+BenchResult runRpiPainter(const std::string& name) {
+    UiWidgetFactoryOptions options{};
+    options.layoutSearchRoots = {kLayoutsDir};
+    std::unique_ptr<IUiWidget> widget;
+    try {
+        widget = UiWidgetFactory(options).create(UiScene::Tracks);
+    } catch (const std::exception& ex) {
+        return skipped(name, ex.what());
+    }
+    const UiState state = makeTracksState();
+    const UiNavState nav = makeTracksNav();
+    UiPreparedLayout prepared{};
+    if (!widget || !widget->buildPreparedLayout(prepared, state, nav)) {
+        return skipped(name, "tracks layout was not prepared");
+    }
+
+    raspi::RpiPixelCanvas canvas;
+    canvas.resize(800, 480);
+    raspi::RpiPrimitiveScenePaintContext ctx{};
+    ctx.canvas = &canvas;
+    ctx.startTs = std::chrono::steady_clock::now();
+    ctx.cwd = std::string(AVANTGARDE_SOURCE_DIR);
+    return measure(name, 1.0, "frame", [&]() {
+        ++ctx.frameTick;
+        ctx.nowMs += 16;
+        raspi::renderPreparedLayoutScene(ctx, prepared);
+        doNotOptimize(canvas.pixels()[0]);
+    });
+}
+
+} // namespace
+
+void registerUiRenderBenches(std::vector<BenchCase>& out) {
+    out.push_back({"ui.layout.arrange_tracks", runArrange});
+    out.push_back({"ui.rpi_painter.tracks_800x480", runRpiPainter});
+}
+
+} // namespace avantgarde::bench
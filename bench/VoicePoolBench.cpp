@@ -0,0 +1,81 @@
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "runtime/ClipTrack.cpp"
+
+namespace avantgarde::bench {
+namespace {
+
+constexpr std::size_t kBlockFrames = 256;
+
+SharedClipBuffer makeStereoClip(int frames) {
+    auto l = std::shared_ptr<float[]>(new float[static_cast<std::size_t>(frames)]);
+    auto r = std::shared_ptr<float[]>(new float[static_cast<std::size_t>(frames)]);
+    for (int i = 0; i < frames; ++i) {
+        l[static_cast<std::size_t>(i)] = 0.5f * std::sin(0.01f * static_cast<float>(i));
+        r[static_cast<std::size_t>(i)] = 0.5f * std::cos(0.013f * static_cast<float>(i));
+    }
+    SharedClipBuffer b{};
+    b.sampleRate = 44100; // != host rate: держим inc != 1.0, как у реальных сэмплов
+    b.channels = 2;
+    b.frames = frames;
+    b.ch0 = l;
+    b.ch1 = r;
+    return b;
+}
+
+RtCommand trackCmd(CmdId id, uint16_t index, float value, int16_t slot = -1) {
+    RtCommand c{};
+    c.id = toWireCmdId(id);
+    c.track = 0;
+    c.slot = slot;
+    c.index = index;
+    c.value = value;
+    return c;
+}
+
+// Стоимость рендера блока с N одновременно звучащими голосами note-режима.
+BenchResult runVoices(const std::string& name, uint8_t voices) {
+    ClipTrackImpl track(48000.0, 0);
+    (void)track.loadSlotFromBuffer(0, makeStereoClip(48000 * 4));
+    (void)track.setSlotLooping(0, true);
+    (void)track.setNotePolyphony(std::max<uint8_t>(voices, 2), VoiceStealPolicyValue::Oldest);
+    track.onRtCommand(trackCmd(CmdId::ParamSet, toParamIndex(TrackParamId::FollowTransportEnabled), 0.0f));
+    track.onRtCommand(trackCmd(CmdId::ParamSet, toParamIndex(TrackParamId::PlaybackMode),
+                               toParamValue(TrackPlaybackModeValue::Note)));
+    track.onRtCommand(trackCmd(CmdId::ParamSet, toParamIndex(TrackParamId::LaunchPolicy),
+                               toParamValue(TrackLaunchPolicyValue::RetriggerOnNoteOn)));
+
+    std::vector<float> out0(kBlockFrames), out1(kBlockFrames);
+    float* outs[2] = {out0.data(), out1.data()};
+    AudioProcessContext ctx{};
+    ctx.out = outs;
+    ctx.nframes = kBlockFrames;
+    ctx.numOut = 2;
+
+    // Голоса стартуют со сдвигом, чтобы фазы не совпадали.
+    for (uint8_t v = 0; v < voices; ++v) {
+        track.onRtCommand(trackCmd(CmdId::NoteOn, static_cast<uint16_t>(60 + v), 1.0f));
+        track.process(ctx);
+    }
+
+    return measure(name, static_cast<double>(voices) * static_cast<double>(kBlockFrames), "voice-frame", [&]() {
+        track.process(ctx);
+        doNotOptimize(out0[0]);
+    });
+}
+
+} // namespace
+
+void registerVoicePoolBenches(std::vector<BenchCase>& out) {
+    out.push_back({"cliptrack.note_voices.1", [](const std::string& n) { return runVoices(n, 1); }});
+    out.push_back({"cliptrack.note_voices.4", [](const std::string& n) { return runVoices(n, 4); }});
+    out.push_back({"cliptrack.note_voices.8", [](const std::string& n) { return runVoices(n, 8); }});
+    out.push_back({"cliptrack.note_voices.16", [](const std::string& n) { return runVoices(n, 16); }});
+}
+
+} // namespace avantgarde::bench
@@ -0,0 +1,134 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "contracts/WavDecoder.h"
+
+namespace avantgarde::bench {
+namespace {
+
+constexpr uint32_t kSampleRate = 48000;
+constexpr uint32_t kChunk = WavDecoder::kChunkFrames;
+
+// Интерлив stereo-синуса в заданной кодировке (сырые байты data chunk).
+std::vector<uint8_t> makeInterleaved(WavDecoder::Encoding enc, uint32_t frames) {
+    const uint32_t bytes = (enc == WavDecoder::Encoding::Pcm16) ? 2u : (enc == WavDecoder::Encoding::Pcm24 ? 3u : 4u);
+    std::vector<uint8_t> out(static_cast<std::size_t>(frames) * 2u * bytes + wav_pcm::kReadPad);
+    uint8_t* p = out.data();
+    for (uint32_t i = 0; i < frames; ++i) {
+        for (int c = 0; c < 2; ++c) {
+            const float x = 0.5f * std::sin(0.01f * static_cast<float>(i) + static_cast<float>(c));
+            if (enc == WavDecoder::Encoding::Float32) {
+                std::memcpy(p, &x, 4);
+            } else {
+                const int32_t v = static_cast<int32_t>(x * 2147483647.0f);
+                std::memcpy(p, reinterpret_cast<const uint8_t*>(&v) + (4u - bytes), bytes);
+            }
+            p += bytes;
+        }
+    }
+    return out;
+}
+
+// RIFF/WAVE с одним fmt и data chunk.
+std::string writeWavFile(const std::string& name, WavDecoder::Encoding enc, uint32_t frames) {
+    const std::vector<uint8_t> data = makeInterleaved(enc, frames);
+    const uint32_t dataBytes = static_cast<uint32_t>(data.size() - wav_pcm::kReadPad);
+    const uint16_t bits = (enc == WavDecoder::Encoding::Pcm16) ? 16 : (enc == WavDecoder::Encoding::Pcm24 ? 24 : 32);
+    const uint16_t tag = (enc == WavDecoder::Encoding::Float32) ? 3 : 1;
+    const uint16_t channels = 2;
+    const uint16_t blockAlign = static_cast<uint16_t>(channels * bits / 8);
+    const uint32_t byteRate = kSampleRate * blockAlign;
+    const uint32_t riffSize = 4 + 8 + 16 + 8 + dataBytes;
+    const uint32_t fmtSize = 16;
+
+    const std::string path = (std::filesystem::temp_directory_path() / name).string();
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        return {};
+    }
+    std::fwrite("RIFF", 1, 4, f);
+    std::fwrite(&riffSize, 4, 1, f);
+    std::fwrite("WAVEfmt ", 1, 8, f);
+    std::fwrite(&fmtSize, 4, 1, f);
+    std::fwrite(&tag, 2, 1, f);
+    std::fwrite(&channels, 2, 1, f);
+    std::fwrite(&kSampleRate, 4, 1, f);
+    std::fwrite(&byteRate, 4, 1, f);
+    std::fwrite(&blockAlign, 2, 1, f);
+    std::fwrite(&bits, 2, 1, f);
+    std::fwrite("data", 1, 4, f);
+    std::fwrite(&dataBytes, 4, 1, f);
+    std::fwrite(data.data(), 1, dataBytes, f);
+    std::fclose(f);
+    return path;
+}
+
+// Только конверсия одного куска из памяти: векторное ядро + скалярный хвост.
+template <typename Packed, typename Load>
+BenchResult runConvert(const std::string& name, WavDecoder::Encoding enc, Packed packed, Load load, bool simd) {
+    const std::vector<uint8_t> raw = makeInterleaved(enc, kChunk);
+    const uint32_t sampleBytes = static_cast<uint32_t>((raw.size() - wav_pcm::kReadPad) / (2u * kChunk));
+    std::vector<float> l(kChunk), r(kChunk);
+    BenchResult res = measure(name, static_cast<double>(kChunk), "frame", [&]() {
+        const uint32_t done = simd ? packed(raw.data(), kChunk, l.data(), r.data()) : 0u;
+        wav_pcm::deinterleaveScalar(raw.data() + static_cast<std::size_t>(done) * 2u * sampleBytes, kChunk - done,
+                                    2u * sampleBytes, sampleBytes, l.data() + done, r.data() + done, load);
+        doNotOptimize(l[0]);
+        doNotOptimize(r[kChunk - 1]);
+    });
+    res.bytesPerIteration = static_cast<double>(raw.size() - wav_pcm::kReadPad);
+    return res;
+}
+
+// Весь файл (10 с stereo, из page cache) в planar-буферы через decodeWavFile().
+BenchResult runFile(const std::string& name, WavDecoder::Encoding enc) {
+    const uint32_t frames = kSampleRate * 10u;
+    const std::string path = writeWavFile("ag_bench_" + name + ".wav", enc, frames);
+    BenchResult res = measure(name, static_cast<double>(frames), "frame", [&]() {
+        WavDecodedPlanar wav{};
+        (void)decodeWavFile(path, wav);
+        doNotOptimize(wav.ch0);
+    });
+    std::error_code ec;
+    res.bytesPerIteration = static_cast<double>(std::filesystem::file_size(path, ec));
+    std::filesystem::remove(path, ec);
+    return res;
+}
+
+} // namespace
+
+void registerWavDecoderBenches(std::vector<BenchCase>& out) {
+    using Enc = WavDecoder::Encoding;
+    out.push_back({"wav.convert.pcm16_stereo.scalar", [](const std::string& n) {
+                       return runConvert(n, Enc::Pcm16, wav_pcm::pcm16Packed, wav_pcm::loadPcm16, false);
+                   }});
+    out.push_back({"wav.convert.pcm16_stereo.simd", [](const std::string& n) {
+                       return runConvert(n, Enc::Pcm16, wav_pcm::pcm16Packed, wav_pcm::loadPcm16, true);
+                   }});
+    out.push_back({"wav.convert.pcm24_stereo.scalar", [](const std::string& n) {
+                       return runConvert(n, Enc::Pcm24, wav_pcm::pcm24Packed, wav_pcm::loadPcm24, false);
+                   }});
+    out.push_back({"wav.convert.pcm24_stereo.simd", [](const std::string& n) {
+                       return runConvert(n, Enc::Pcm24, wav_pcm::pcm24Packed, wav_pcm::loadPcm24, true);
+                   }});
+    out.push_back({"wav.convert.pcm32_stereo.simd", [](const std::string& n) {
+                       return runConvert(n, Enc::Pcm32, wav_pcm::pcm32Packed, wav_pcm::loadPcm32, true);
+                   }});
+    out.push_back({"wav.convert.f32_stereo.scalar", [](const std::string& n) {
+                       return runConvert(n, Enc::Float32, wav_pcm::float32Packed, wav_pcm::loadFloat32, false);
+                   }});
+    out.push_back({"wav.convert.f32_stereo.simd", [](const std::string& n) {
+                       return runConvert(n, Enc::Float32, wav_pcm::float32Packed, wav_pcm::loadFloat32, true);
+                   }});
+    out.push_back({"wav.decode.pcm16_stereo_10s", [](const std::string& n) { return runFile(n, Enc::Pcm16); }});
+    out.push_back({"wav.decode.pcm24_stereo_10s", [](const std::string& n) { return runFile(n, Enc::Pcm24); }});
+    out.push_back({"wav.decode.f32_stereo_10s", [](const std::string& n) { return runFile(n, Enc::Float32); }});
+}
+
+} // namespace avantgarde::bench
@@ -0,0 +1,151 @@
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BenchHarness.h"
+
+using namespace avantgarde::bench;
+
+namespace {
+
+// Экранирование строки для JSON (имена бенчей/метки — ASCII, но метку задает пользователь).
+std::string jsonEscape(std::string_view s) {
+    std::string out;
+    out.reserve(s.size() + 2);
+    for (const char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+const char* buildArch() {
+#if defined(__aarch64__)
+    return "aarch64";
+#elif defined(__arm__)
+    return "arm";
+#elif defined(__x86_64__)
+    return "x86_64";
+#else
+    return "unknown";
+#endif
+}
+
+// Один JSON-документ на прогон: метаданные сборки + результаты (для сравнения прошивок).
+bool writeJson(const std::string& path, const std::string& label, const std::vector<BenchResult>& results) {
+    FILE* f = (path == "-") ? stdout : std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::fprintf(stderr, "Cannot open %s for writing\n", path.c_str());
+        return false;
+    }
+    std::fprintf(f, "{\n  \"schema\": 1,\n");
+    std::fprintf(f, "  \"label\": \"%s\",\n", jsonEscape(label).c_str());
+    std::fprintf(f, "  \"timestamp\": %lld,\n", static_cast<long long>(std::time(nullptr)));
+#if defined(__VERSION__)
+    std::fprintf(f, "  \"compiler\": \"%s\",\n", jsonEscape(__VERSION__).c_str());
+#endif
+    std::fprintf(f, "  \"arch\": \"%s\",\n", buildArch());
+#if defined(NDEBUG)
+    std::fprintf(f, "  \"optimized\": true,\n");
+#else
+    std::fprintf(f, "  \"optimized\": false,\n");
+#endif
+    std::fprintf(f, "  \"results\": [");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        std::fprintf(f,
+                     "%s\n    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_iteration\": %.3f, "
+                     "\"items_per_iteration\": %.1f, \"ns_per_item\": %.4f, \"item\": \"%s\", "
+                     "\"mb_per_s\": %.1f}",
+                     i ? "," : "",
+                     jsonEscape(r.name).c_str(),
+                     static_cast<unsigned long long>(r.iterations),
+                     r.nsPerIteration,
+                     r.itemsPerIteration,
+                     r.nsPerItem(),
+                     jsonEscape(r.itemLabel).c_str(),
+                     r.mbPerSecond());
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+    if (f != stdout) {
+        std::fclose(f);
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string jsonPath;
+    std::string label;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg.rfind("--filter=", 0) == 0) {
+            filter = std::string(arg.substr(9));
+            continue;
+        }
+        if (arg.rfind("--json=", 0) == 0) {
+            jsonPath = std::string(arg.substr(7));
+            continue;
+        }
+        if (arg.rfind("--label=", 0) == 0) {
+            label = std::string(arg.substr(8));
+            continue;
+        }
+        std::printf("Unknown option: %s\n", argv[i]);
+        std::printf("Usage: avantgarde_bench [--filter=substr] [--json=path|-] [--label=build-id]\n");
+        return 1;
+    }
+
+    std::vector<BenchCase> cases;
+    registerClipTrackBenches(cases);
+    registerVoicePoolBenches(cases);
+    registerFxModuleBenches(cases);
+    registerRtQueueBenches(cases);
+    registerAudioGraphBenches(cases);
+    registerUiRenderBenches(cases);
+    registerWavDecoderBenches(cases);
+
+    // С --json=- stdout занят документом: таблицу уводим в stderr.
+    FILE* table = (jsonPath == "-") ? stderr : stdout;
+    std::vector<BenchResult> results;
+    std::fprintf(table, "%-40s %12s %14s %14s\n", "benchmark", "iterations", "ns/iter", "ns/item");
+    for (const auto& c : cases) {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        const BenchResult r = c.run(c.name);
+        std::fprintf(table, "%-40s %12llu %14.1f %14.3f (%s)",
+                     r.name.c_str(),
+                     static_cast<unsigned long long>(r.iterations),
+                     r.nsPerIteration,
+                     r.nsPerItem(),
+                     r.itemLabel.c_str());
+        if (r.bytesPerIteration > 0.0) {
+            std::fprintf(table, " %10.1f MB/s", r.mbPerSecond());
+        }
+        std::fprintf(table, "\n");
+        std::fflush(table);
+        results.push_back(r);
+    }
+
+    if (!jsonPath.empty() && !writeJson(jsonPath, label, results)) {
+        return 1;
+    }
+    return 0;
+}
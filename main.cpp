@@ -1,30 +1,144 @@
+#include <algorithm>
 #include <cstdio>
 #include <cstdint>
 #include <cstdlib>
 #include <string>
 #include <string_view>
+#include <thread>
 
 #include "app/AppDiagnostics.h"
 #include "app/SamplerApplication.h"
 #include "app/SamplerIoLayer.h"
+#include "contracts/ClipSampleFormat.h"
 #include "contracts/IPlatform.h"
 #include "contracts/UiTheme.h"
 
 using namespace avantgarde;
 
-int main(int argc, char** argv) {
+namespace {
+
+// Разбор "--render pattern=N[,bars=M][,tail=SEC]".
+bool parseRenderSpec(std::string_view spec, SamplerOfflineRenderConfig& out) {
+    bool hasPattern = false;
+    while (!spec.empty()) {
+        const std::size_t comma = spec.find(',');
+        const std::string item(spec.substr(0, comma));
+        spec = (comma == std::string_view::npos) ? std::string_view{} : spec.substr(comma + 1);
+        const std::size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            return false;
+        }
+        const std::string key = item.substr(0, eq);
+        const char* value = item.c_str() + eq + 1;
+        char* end = nullptr;
+        if (key == "pattern") {
+            const long parsed = std::strtol(value, &end, 10);
+            if (!end || *end != '\0' || parsed < 1 || parsed >= kInvalidPatternId) {
+                return false;
+            }
+            out.pattern = static_cast<PatternId>(parsed);
+            hasPattern = true;
+        } else if (key == "bars") {
+            const long parsed = std::strtol(value, &end, 10);
+            if (!end || *end != '\0' || parsed < 1 || parsed > 4096) {
+                return false;
+            }
+            out.bars = static_cast<uint32_t>(parsed);
+        } else if (key == "tail") {
+            const float parsed = std::strtof(value, &end);
+            if (!end || *end != '\0' || !(parsed >= 0.0f) || parsed > 60.0f) {
+                return false;
+            }
+            out.tailSeconds = parsed;
+        } else {
+            return false;
+        }
+    }
+    return hasPattern;
+}
+
+// Опции командной строки, из которых собираются SamplerIoConfig и SamplerEngineConfig.
+struct CliOptions {
     SamplerUiMode uiMode = SamplerUiMode::GbWindow;
     UiTheme uiTheme = UiTheme::Default;
     bool uiThemeProvided = false;
-    uint8_t trackCount = 4;
     std::string rpiInputDevice = "/dev/input/event0";
     uint16_t rpiRotateDeg = 0;
+    uint8_t trackCount = 4;
+    uint8_t renderThreads = 0;
+    bool renderThreadsProvided = false;
+    uint8_t renderAheadBlocks = 0;
+    double clipStreamMinSeconds = 0.0;
+    std::string clipCacheDir{};
+    uint64_t clipCacheMaxMb = 1024;
+    uint64_t clipPoolMaxMb = 0;
+    uint8_t loadThreads = 2;
+    ClipSampleFormat clipFormat = ClipSampleFormat::Float32;
+    bool clipSrc = false;
+    bool tempoStretch = false;
+    uint8_t noteVoices = 1;
+    VoiceStealPolicyValue voiceSteal = VoiceStealPolicyValue::Oldest;
+    uint8_t auxBuses = 0;
+    float auxSend = 0.0f;
+    int renderBlockFrames = 1024;
+};
+
+SamplerIoConfig makeIoConfig(const CliOptions& opts) {
+    SamplerIoConfig io{};
+    io.mode = opts.uiMode;
+    io.theme = opts.uiTheme;
+    io.themeProvided = opts.uiThemeProvided;
+    io.rpiInputDevice = opts.rpiInputDevice;
+    io.rpiRotateDeg = opts.rpiRotateDeg;
+    return io;
+}
+
+SamplerEngineConfig makeEngineConfig(const CliOptions& opts, bool offlineRender) {
+    SamplerEngineConfig engine{};
+    engine.trackCount = opts.trackCount;
+    engine.renderWorkers = opts.renderThreads;
+    engine.renderAheadBlocks = opts.renderAheadBlocks;
+    engine.clipStreamMinSeconds = opts.clipStreamMinSeconds;
+    engine.clipCacheDir = opts.clipCacheDir;
+    engine.clipCacheMaxBytes = opts.clipCacheMaxMb << 20;
+    engine.clipFormat = opts.clipFormat;
+    engine.clipResampleOnLoad = opts.clipSrc;
+    engine.tempoSyncMode = opts.tempoStretch ? TempoSyncModeValue::Stretch : TempoSyncModeValue::Varispeed;
+    engine.clipPoolMaxBytes = opts.clipPoolMaxMb << 20;
+    engine.sampleLoadWorkers = opts.loadThreads;
+    engine.notePolyphony = opts.noteVoices;
+    engine.voiceSteal = opts.voiceSteal;
+    engine.auxBuses = opts.auxBuses;
+    if (offlineRender) {
+        // Офлайн дедлайна нет, а опоздавший блок render-ahead дал бы тишину в файле.
+        engine.renderAheadBlocks = 0;
+        // По той же причине не играем с диска: underrun в файле — это дыра.
+        engine.clipStreamMinSeconds = 0.0;
+        // Офлайн нет дедлайна устройства: крупные блоки и по умолчанию все ядра под треки.
+        engine.blockFrames = opts.renderBlockFrames;
+        if (!opts.renderThreadsProvided) {
+            const unsigned cores = std::thread::hardware_concurrency();
+            engine.renderWorkers = static_cast<uint8_t>(std::min(7U, (cores > 1U) ? cores - 1U : 0U));
+        }
+    }
+    return engine;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CliOptions opts{};
+    std::string recordPath{};
+    std::string stemRecordDir{};
+    WavSampleFormat recordFormat = WavSampleFormat::Pcm24;
+    bool offlineRender = false;
+    SamplerOfflineRenderConfig renderConfig{};
 
     int argi = 1;
     while (argi < argc) {
         const std::string arg = argv[argi];
         if (arg.rfind("--ui=", 0) == 0) {
-            if (!parseSamplerUiMode(std::string_view(arg).substr(5), uiMode)) {
+            if (!parseSamplerUiMode(std::string_view(arg).substr(5), opts.uiMode)) {
                 std::printf("Unsupported UI mode: %s\n", arg.c_str());
                 return 1;
             }
@@ -32,7 +146,7 @@ int main(int argc, char** argv) {
             continue;
         }
         if (arg == "--ui" && (argi + 1) < argc) {
-            if (!parseSamplerUiMode(argv[argi + 1], uiMode)) {
+            if (!parseSamplerUiMode(argv[argi + 1], opts.uiMode)) {
                 std::printf("Unsupported UI mode: %s\n", argv[argi + 1]);
                 return 1;
             }
@@ -40,20 +154,20 @@ int main(int argc, char** argv) {
             continue;
         }
         if (arg.rfind("--theme=", 0) == 0) {
-            if (!parseUiTheme(std::string_view(arg).substr(8), uiTheme)) {
+            if (!parseUiTheme(std::string_view(arg).substr(8), opts.uiTheme)) {
                 std::printf("Unsupported theme: %s\n", arg.c_str());
                 return 1;
             }
-            uiThemeProvided = true;
+            opts.uiThemeProvided = true;
             ++argi;
             continue;
         }
         if (arg == "--theme" && (argi + 1) < argc) {
-            if (!parseUiTheme(argv[argi + 1], uiTheme)) {
+            if (!parseUiTheme(argv[argi + 1], opts.uiTheme)) {
                 std::printf("Unsupported theme: %s\n", argv[argi + 1]);
                 return 1;
             }
-            uiThemeProvided = true;
+            opts.uiThemeProvided = true;
             argi += 2;
             continue;
         }
@@ -64,7 +178,7 @@ int main(int argc, char** argv) {
                 std::printf("Invalid --tracks value: %s (expected 1..32)\n", arg.c_str());
                 return 1;
             }
-            trackCount = static_cast<uint8_t>(parsed);
+            opts.trackCount = static_cast<uint8_t>(parsed);
             ++argi;
             continue;
         }
@@ -75,17 +189,269 @@ int main(int argc, char** argv) {
                 std::printf("Invalid --tracks value: %s (expected 1..32)\n", argv[argi + 1]);
                 return 1;
             }
-            trackCount = static_cast<uint8_t>(parsed);
+            opts.trackCount = static_cast<uint8_t>(parsed);
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--render-threads=", 0) == 0) {
+            char* end = nullptr;
+            const long parsed = std::strtol(arg.c_str() + 17, &end, 10);
+            if (!end || *end != '\0' || parsed < 0 || parsed > 7) {
+                std::printf("Invalid --render-threads value: %s (expected 0..7)\n", arg.c_str());
+                return 1;
+            }
+            opts.renderThreads = static_cast<uint8_t>(parsed);
+            opts.renderThreadsProvided = true;
+            ++argi;
+            continue;
+        }
+        if (arg == "--render-threads" && (argi + 1) < argc) {
+            char* end = nullptr;
+            const long parsed = std::strtol(argv[argi + 1], &end, 10);
+            if (!end || *end != '\0' || parsed < 0 || parsed > 7) {
+                std::printf("Invalid --render-threads value: %s (expected 0..7)\n", argv[argi + 1]);
+                return 1;
+            }
+            opts.renderThreads = static_cast<uint8_t>(parsed);
+            opts.renderThreadsProvided = true;
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--render-ahead=", 0) == 0) {
+            char* end = nullptr;
+            const long parsed = std::strtol(arg.c_str() + 15, &end, 10);
+            if (!end || *end != '\0' || parsed < 0 || parsed > 16) {
+                std::printf("Invalid --render-ahead value: %s (expected 0..16)\n", arg.c_str());
+                return 1;
+            }
+            opts.renderAheadBlocks = static_cast<uint8_t>(parsed);
+            ++argi;
+            continue;
+        }
+        if (arg == "--render-ahead" && (argi + 1) < argc) {
+            char* end = nullptr;
+            const long parsed = std::strtol(argv[argi + 1], &end, 10);
+            if (!end || *end != '\0' || parsed < 0 || parsed > 16) {
+                std::printf("Invalid --render-ahead value: %s (expected 0..16)\n", argv[argi + 1]);
+                return 1;
+            }
+            opts.renderAheadBlocks = static_cast<uint8_t>(parsed);
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--stream-clips-over=", 0) == 0) {
+            char* end = nullptr;
+            const double parsed = std::strtod(arg.c_str() + 20, &end);
+            if (!end || *end != '\0' || !(parsed >= 0.0)) {
+                std::printf("Invalid --stream-clips-over value: %s (expected seconds >= 0)\n", arg.c_str());
+                return 1;
+            }
+            opts.clipStreamMinSeconds = parsed;
+            ++argi;
+            continue;
+        }
+        if (arg == "--stream-clips-over" && (argi + 1) < argc) {
+            char* end = nullptr;
+            const double parsed = std::strtod(argv[argi + 1], &end);
+            if (!end || *end != '\0' || !(parsed >= 0.0)) {
+                std::printf("Invalid --stream-clips-over value: %s (expected seconds >= 0)\n", argv[argi + 1]);
+                return 1;
+            }
+            opts.clipStreamMinSeconds = parsed;
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--clip-cache=", 0) == 0) {
+            opts.clipCacheDir = std::string(std::string_view(arg).substr(13));
+            ++argi;
+            continue;
+        }
+        if (arg == "--clip-cache" && (argi + 1) < argc) {
+            opts.clipCacheDir = argv[argi + 1];
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--clip-cache-mb=", 0) == 0) {
+            char* end = nullptr;
+            const long long parsed = std::strtoll(arg.c_str() + 16, &end, 10);
+            if (!end || *end != '\0' || parsed < 0) {
+                std::printf("Invalid --clip-cache-mb value: %s (expected MB >= 0)\n", arg.c_str());
+                return 1;
+            }
+            opts.clipCacheMaxMb = static_cast<uint64_t>(parsed);
+            ++argi;
+            continue;
+        }
+        if (arg == "--clip-cache-mb" && (argi + 1) < argc) {
+            char* end = nullptr;
+            const long long parsed = std::strtoll(argv[argi + 1], &end, 10);
+            if (!end || *end != '\0' || parsed < 0) {
+                std::printf("Invalid --clip-cache-mb value: %s (expected MB >= 0)\n", argv[argi + 1]);
+                return 1;
+            }
+            opts.clipCacheMaxMb = static_cast<uint64_t>(parsed);
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--clip-pool-mb=", 0) == 0) {
+            char* end = nullptr;
+            const long long parsed = std::strtoll(arg.c_str() + 15, &end, 10);
+            if (!end || *end != '\0' || parsed < 0) {
+                std::printf("Invalid --clip-pool-mb value: %s (expected MB >= 0)\n", arg.c_str());
+                return 1;
+            }
+            opts.clipPoolMaxMb = static_cast<uint64_t>(parsed);
+            ++argi;
+            continue;
+        }
+        if (arg == "--clip-pool-mb" && (argi + 1) < argc) {
+            char* end = nullptr;
+            const long long parsed = std::strtoll(argv[argi + 1], &end, 10);
+            if (!end || *end != '\0' || parsed < 0) {
+                std::printf("Invalid --clip-pool-mb value: %s (expected MB >= 0)\n", argv[argi + 1]);
+                return 1;
+            }
+            opts.clipPoolMaxMb = static_cast<uint64_t>(parsed);
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--load-threads=", 0) == 0) {
+            char* end = nullptr;
+            const long parsed = std::strtol(arg.c_str() + 15, &end, 10);
+            if (!end || *end != '\0' || parsed < 1 || parsed > 8) {
+                std::printf("Invalid --load-threads value: %s (expected 1..8)\n", arg.c_str());
+                return 1;
+            }
+            opts.loadThreads = static_cast<uint8_t>(parsed);
+            ++argi;
+            continue;
+        }
+        if (arg == "--load-threads" && (argi + 1) < argc) {
+            char* end = nullptr;
+            const long parsed = std::strtol(argv[argi + 1], &end, 10);
+            if (!end || *end != '\0' || parsed < 1 || parsed > 8) {
+                std::printf("Invalid --load-threads value: %s (expected 1..8)\n", argv[argi + 1]);
+                return 1;
+            }
+            opts.loadThreads = static_cast<uint8_t>(parsed);
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--note-voices=", 0) == 0) {
+            char* end = nullptr;
+            const long parsed = std::strtol(arg.c_str() + 14, &end, 10);
+            if (!end || *end != '\0' || parsed < 1 || parsed > 16) {
+                std::printf("Invalid --note-voices value: %s (expected 1..16)\n", arg.c_str());
+                return 1;
+            }
+            opts.noteVoices = static_cast<uint8_t>(parsed);
+            ++argi;
+            continue;
+        }
+        if (arg == "--note-voices" && (argi + 1) < argc) {
+            char* end = nullptr;
+            const long parsed = std::strtol(argv[argi + 1], &end, 10);
+            if (!end || *end != '\0' || parsed < 1 || parsed > 16) {
+                std::printf("Invalid --note-voices value: %s (expected 1..16)\n", argv[argi + 1]);
+                return 1;
+            }
+            opts.noteVoices = static_cast<uint8_t>(parsed);
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--voice-steal=", 0) == 0) {
+            if (!parseVoiceStealPolicy(std::string_view(arg).substr(14), opts.voiceSteal)) {
+                std::printf("Invalid --voice-steal value: %s (expected: oldest|quietest)\n", arg.c_str());
+                return 1;
+            }
+            ++argi;
+            continue;
+        }
+        if (arg == "--voice-steal" && (argi + 1) < argc) {
+            if (!parseVoiceStealPolicy(argv[argi + 1], opts.voiceSteal)) {
+                std::printf("Invalid --voice-steal value: %s (expected: oldest|quietest)\n", argv[argi + 1]);
+                return 1;
+            }
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--aux-buses=", 0) == 0) {
+            char* end = nullptr;
+            const long parsed = std::strtol(arg.c_str() + 12, &end, 10);
+            if (!end || *end != '\0' || parsed < 0 || parsed > static_cast<long>(kMaxAuxBuses)) {
+                std::printf("Invalid --aux-buses value: %s (expected 0..%u)\n", arg.c_str(), kMaxAuxBuses);
+                return 1;
+            }
+            opts.auxBuses = static_cast<uint8_t>(parsed);
+            ++argi;
+            continue;
+        }
+        if (arg == "--aux-buses" && (argi + 1) < argc) {
+            char* end = nullptr;
+            const long parsed = std::strtol(argv[argi + 1], &end, 10);
+            if (!end || *end != '\0' || parsed < 0 || parsed > static_cast<long>(kMaxAuxBuses)) {
+                std::printf("Invalid --aux-buses value: %s (expected 0..%u)\n", argv[argi + 1], kMaxAuxBuses);
+                return 1;
+            }
+            opts.auxBuses = static_cast<uint8_t>(parsed);
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--aux-send=", 0) == 0) {
+            char* end = nullptr;
+            const double parsed = std::strtod(arg.c_str() + 11, &end);
+            if (!end || *end != '\0' || !(parsed >= 0.0 && parsed <= 1.0)) {
+                std::printf("Invalid --aux-send value: %s (expected 0..1)\n", arg.c_str());
+                return 1;
+            }
+            opts.auxSend = static_cast<float>(parsed);
+            ++argi;
+            continue;
+        }
+        if (arg == "--aux-send" && (argi + 1) < argc) {
+            char* end = nullptr;
+            const double parsed = std::strtod(argv[argi + 1], &end);
+            if (!end || *end != '\0' || !(parsed >= 0.0 && parsed <= 1.0)) {
+                std::printf("Invalid --aux-send value: %s (expected 0..1)\n", argv[argi + 1]);
+                return 1;
+            }
+            opts.auxSend = static_cast<float>(parsed);
+            argi += 2;
+            continue;
+        }
+        if (arg == "--clip-src") {
+            opts.clipSrc = true;
+            ++argi;
+            continue;
+        }
+        if (arg == "--tempo-stretch") {
+            opts.tempoStretch = true;
+            ++argi;
+            continue;
+        }
+        if (arg.rfind("--clip-format=", 0) == 0) {
+            if (!parseClipSampleFormat(std::string_view(arg).substr(14), opts.clipFormat)) {
+                std::printf("Invalid --clip-format value: %s (expected: f32|s16|f16)\n", arg.c_str());
+                return 1;
+            }
+            ++argi;
+            continue;
+        }
+        if (arg == "--clip-format" && (argi + 1) < argc) {
+            if (!parseClipSampleFormat(argv[argi + 1], opts.clipFormat)) {
+                std::printf("Invalid --clip-format value: %s (expected: f32|s16|f16)\n", argv[argi + 1]);
+                return 1;
+            }
             argi += 2;
             continue;
         }
         if (arg.rfind("--rpi-input=", 0) == 0) {
-            rpiInputDevice = std::string(std::string_view(arg).substr(12));
+            opts.rpiInputDevice = std::string(std::string_view(arg).substr(12));
             ++argi;
             continue;
         }
         if (arg == "--rpi-input" && (argi + 1) < argc) {
-            rpiInputDevice = argv[argi + 1];
+            opts.rpiInputDevice = argv[argi + 1];
             argi += 2;
             continue;
         }
@@ -96,7 +462,7 @@ int main(int argc, char** argv) {
                 std::printf("Invalid --rpi-rotate value: %s (expected 0|90|180|270)\n", arg.c_str());
                 return 1;
             }
-            rpiRotateDeg = static_cast<uint16_t>(parsed);
+            opts.rpiRotateDeg = static_cast<uint16_t>(parsed);
             ++argi;
             continue;
         }
@@ -107,10 +473,77 @@ int main(int argc, char** argv) {
                 std::printf("Invalid --rpi-rotate value: %s (expected 0|90|180|270)\n", argv[argi + 1]);
                 return 1;
             }
-            rpiRotateDeg = static_cast<uint16_t>(parsed);
+            opts.rpiRotateDeg = static_cast<uint16_t>(parsed);
             argi += 2;
             continue;
         }
+        if (arg.rfind("--render=", 0) == 0 || (arg == "--render" && (argi + 1) < argc)) {
+            const std::string_view spec = (arg == "--render") ? std::string_view(argv[argi + 1])
+                                                               : std::string_view(arg).substr(9);
+            if (!parseRenderSpec(spec, renderConfig)) {
+                std::printf("Invalid --render value: %.*s (expected pattern=N[,bars=M][,tail=SEC])\n",
+                            static_cast<int>(spec.size()), spec.data());
+                return 1;
+            }
+            offlineRender = true;
+            argi += (arg == "--render") ? 2 : 1;
+            continue;
+        }
+        if (arg.rfind("--out=", 0) == 0) {
+            renderConfig.outPath = std::string(std::string_view(arg).substr(6));
+            ++argi;
+            continue;
+        }
+        if (arg == "--out" && (argi + 1) < argc) {
+            renderConfig.outPath = argv[argi + 1];
+            argi += 2;
+            continue;
+        }
+        if (arg.rfind("--record=", 0) == 0) {
+            recordPath = std::string(std::string_view(arg).substr(9));
+            ++argi;
+            continue;
+        }
+        if (arg.rfind("--record-stems=", 0) == 0) {
+            stemRecordDir = std::string(std::string_view(arg).substr(15));
+            ++argi;
+            continue;
+        }
+        if (arg.rfind("--record-format=", 0) == 0) {
+            if (!parseWavSampleFormat(std::string_view(arg).substr(16), recordFormat)) {
+                std::printf("Unsupported record format: %s (expected s16|s24|f32)\n", arg.c_str());
+                return 1;
+            }
+            ++argi;
+            continue;
+        }
+        if (arg.rfind("--render-format=", 0) == 0) {
+            if (!parseWavSampleFormat(std::string_view(arg).substr(16), renderConfig.format)) {
+                std::printf("Unsupported render format: %s (expected s16|s24|f32)\n", arg.c_str());
+                return 1;
+            }
+            ++argi;
+            continue;
+        }
+        if (arg.rfind("--render-block=", 0) == 0) {
+            char* end = nullptr;
+            const long parsed = std::strtol(arg.c_str() + 15, &end, 10);
+            if (!end || *end != '\0' || parsed < 64 || parsed > 4096) {
+                std::printf("Invalid --render-block value: %s (expected 64..4096)\n", arg.c_str());
+                return 1;
+            }
+            opts.renderBlockFrames = static_cast<int>(parsed);
+            ++argi;
+            continue;
+        }
+        if (arg == "--render") {
+            std::printf("Missing value for --render (expected: pattern=N[,bars=M][,tail=SEC])\n");
+            return 1;
+        }
+        if (arg == "--out") {
+            std::printf("Missing value for --out (expected: path to .wav)\n");
+            return 1;
+        }
         if (arg == "--ui") {
             std::printf("Missing value for --ui (expected: gb-window|window|rpi-wrapper)\n");
             return 1;
@@ -123,6 +556,54 @@ int main(int argc, char** argv) {
             std::printf("Missing value for --tracks (expected: 1..32)\n");
             return 1;
         }
+        if (arg == "--render-threads") {
+            std::printf("Missing value for --render-threads (expected: 0..7)\n");
+            return 1;
+        }
+        if (arg == "--render-ahead") {
+            std::printf("Missing value for --render-ahead (expected: 0..16)\n");
+            return 1;
+        }
+        if (arg == "--clip-cache") {
+            std::printf("Missing value for --clip-cache (expected: directory)\n");
+            return 1;
+        }
+        if (arg == "--clip-cache-mb") {
+            std::printf("Missing value for --clip-cache-mb (expected: MB)\n");
+            return 1;
+        }
+        if (arg == "--clip-pool-mb") {
+            std::printf("Missing value for --clip-pool-mb (expected: MB)\n");
+            return 1;
+        }
+        if (arg == "--load-threads") {
+            std::printf("Missing value for --load-threads (expected: 1..8)\n");
+            return 1;
+        }
+        if (arg == "--clip-format") {
+            std::printf("Missing value for --clip-format (expected: f32|s16|f16)\n");
+            return 1;
+        }
+        if (arg == "--note-voices") {
+            std::printf("Missing value for --note-voices (expected: 1..16)\n");
+            return 1;
+        }
+        if (arg == "--voice-steal") {
+            std::printf("Missing value for --voice-steal (expected: oldest|quietest)\n");
+            return 1;
+        }
+        if (arg == "--aux-buses") {
+            std::printf("Missing value for --aux-buses (expected: 0..%u)\n", kMaxAuxBuses);
+            return 1;
+        }
+        if (arg == "--aux-send") {
+            std::printf("Missing value for --aux-send (expected: 0..1)\n");
+            return 1;
+        }
+        if (arg == "--stream-clips-over") {
+            std::printf("Missing value for --stream-clips-over (expected: seconds)\n");
+            return 1;
+        }
         if (arg == "--rpi-input") {
             std::printf("Missing value for --rpi-input (expected: /dev/input/eventX or empty)\n");
             return 1;
@@ -138,12 +619,25 @@ int main(int argc, char** argv) {
         break;
     }
 
+    if (!renderConfig.outPath.empty() && !offlineRender) {
+        std::printf("--out requires --render pattern=N\n");
+        return 1;
+    }
+    if ((!recordPath.empty() || !stemRecordDir.empty()) && offlineRender) {
+        std::printf("--record/--record-stems are for live sessions; --render writes --out itself\n");
+        return 1;
+    }
+    if (offlineRender && renderConfig.outPath.empty()) {
+        std::printf("--render requires --out file.wav\n");
+        return 1;
+    }
+
     // В framebuffer-режиме любой вывод в tty (stdout/stderr) визуально конфликтует
     // с кадром на /dev/fb0. По умолчанию оставляем только файловый лог.
     // Для отладки можно вернуть stderr через AVANTGARDE_LOG_STDERR=1.
     // Для полного отключения mute (stdout+stderr) можно выставить
     // AVANTGARDE_CONSOLE_STDIO=1 (не отключать stdio).
-    if (uiMode == SamplerUiMode::RpiWrapper) {
+    if (opts.uiMode == SamplerUiMode::RpiWrapper && !offlineRender) {
         const char* stderrEnv = std::getenv("AVANTGARDE_LOG_STDERR");
         const bool keepStderr = (stderrEnv && std::string_view(stderrEnv) == "1");
         AppDiagnostics::setStderrEnabled(keepStderr);
@@ -161,22 +655,24 @@ int main(int argc, char** argv) {
     AppDiagnostics::installCrashHandlers();
     AppDiagnostics::logf(AppLogLevel::Info, "main start argc=%d", argc);
 
-    SamplerAppConfig config{};
-    config.io.mode = uiMode;
-    config.io.theme = uiTheme;
-    config.io.themeProvided = uiThemeProvided;
-    config.io.rpiInputDevice = rpiInputDevice;
-    config.io.rpiRotateDeg = rpiRotateDeg;
-    config.engine.trackCount = trackCount;
-    config.audioHost = createDefaultAudioHost();
-    if (!config.audioHost) {
+    // engine/io собираются хелперами и инициализируют config сразу: value-init и
+    // присваивание строковых полей GCC 12 считает возможным чтением мусора (-Wmaybe-uninitialized).
+    SamplerAppConfig config{.engine = makeEngineConfig(opts, offlineRender), .io = makeIoConfig(opts)};
+    config.masterRecordPath = recordPath;
+    config.stemRecordDir = stemRecordDir;
+    config.auxSendLevel = opts.auxSend;
+    config.masterRecord.bitDepth = static_cast<int>(wavBytesPerSample(recordFormat) * 8u);
+    if (!offlineRender) {
+        config.audioHost = createDefaultAudioHost();
+    }
+    if (!offlineRender && !config.audioHost) {
         std::printf("Failed to create audio host for current platform\n");
         return 2;
     }
 
     for (int track = 0; argi < argc; ++argi, ++track) {
-        if (track >= trackCount) {
-            std::printf("Too many startup clips for --tracks=%u\n", static_cast<unsigned>(trackCount));
+        if (track >= opts.trackCount) {
+            std::printf("Too many startup clips for --tracks=%u\n", static_cast<unsigned>(opts.trackCount));
             return 1;
         }
         SamplerAppConfig::StartupClipLoad load{};
@@ -186,7 +682,7 @@ int main(int argc, char** argv) {
     }
 
     SamplerApplication app;
-    const int rc = app.run(config);
+    const int rc = offlineRender ? app.renderOffline(config, renderConfig) : app.run(config);
     AppDiagnostics::logf(AppLogLevel::Info, "main exit rc=%d", rc);
     AppDiagnostics::shutdown();
     return rc;
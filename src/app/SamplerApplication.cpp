@@ -14,6 +14,9 @@
 #include "contracts/FxRegistry.h"
 #include "contracts/IUiGestureInput.h"
 #include "contracts/ids.h"
+#include "module/SchroederReverbModule.h"
+#include "platform/offline/OfflineAudioHost.h"
+#include "service/audio/WavFileWriter.h"
 #include "service/sequencer/SequencerRecordRegistry.h"
 #include "service/sequencer/SequencerDispatchPlanner.h"
 #include "service/ui/UiWidgetFactory.h"
@@ -118,6 +121,34 @@ double currentRssMiB() noexcept {
     return -1.0;
 }
 
+// Строка heartbeat с DSP-нагрузкой: блок целиком и три самых тяжелых узла по p99.
+void logDspLoadHeartbeat(const SamplerEngineLayer& engine, DspLoadCapture& window) {
+    DspLoadReport report{};
+    engine.dspLoadReport(window, report);
+    if (report.block.blocks == 0) {
+        return;
+    }
+    std::string top{};
+    for (uint32_t i = 0; i < std::min<uint32_t>(report.siteCount, 3U); ++i) {
+        const DspLoadSiteStats& s = report.sites[i];
+        char label[32]{};
+        formatDspLoadSite(label, sizeof(label), s.kind, s.owner, s.slot);
+        char item[96]{};
+        std::snprintf(item, sizeof(item), " %s=%.0f/%.0fus", label, s.meanUs, s.p99Us);
+        top += item;
+    }
+    AppDiagnostics::logf(
+        AppLogLevel::Info,
+        "heartbeat dsp: blocks=%llu budgetUs=%.0f mean=%.1f%% p95=%.1f%% p99=%.1f%% maxUs=%.0f top(mean/p99):%s",
+        static_cast<unsigned long long>(report.block.blocks),
+        report.budgetUs,
+        report.block.meanPct,
+        report.budgetUs > 0.0f ? 100.0f * report.block.p95Us / report.budgetUs : 0.0f,
+        report.block.p99Pct,
+        report.block.maxUs,
+        top.c_str());
+}
+
 uint64_t steadyNowMs() noexcept {
     const auto now = std::chrono::steady_clock::now().time_since_epoch();
     return static_cast<uint64_t>(
@@ -204,70 +235,9 @@ int SamplerApplication::run(const SamplerAppConfig& config) {
         }
     }
 
-    trCtl_ = bootstrap.transport;
-    tracksCtl_ = bootstrap.tracks;
-    trCtl_.activeTrack = clampUiTrack_(trCtl_.activeTrack);
-    trCtl_.recordEnabled = false;
-    recordEnabled_ = false;
-    sequencerCursorInitialized_ = false;
-    sequencerCursorSample_ = 0;
-    sequencerByPattern_.clear();
-    sequencerPatternId_ =
-        (bootstrap.pattern.activeId == kInvalidPatternId) ? static_cast<PatternId>(1U) : bootstrap.pattern.activeId;
-    (void)ensureSequencerPattern_(sequencerPatternId_);
-
-    // Стартовая загрузка клипов живет в application-слое, а не в config движка.
-    for (const SamplerAppConfig::StartupClipLoad& load : config.startupClipLoads) {
-        if (load.path.empty()) {
-            continue;
-        }
-        if (load.track >= tracksCtl_.size()) {
-            continue;
-        }
-        const uint8_t t = load.track;
-        std::string clipName;
-        if (!engine_.loadSampleToTrack(t, load.path, clipName)) {
-            continue;
-        }
-        tracksCtl_[t].clipName = clipName;
-        tracksCtl_[t].clipPath = load.path;
-        tracksCtl_[t].muted = false;
-        tracksCtl_[t].armed = false;
-        tracksCtl_[t].loop = true;
-        tracksCtl_[t].playbackProfile = UiTrackPlaybackProfile::Loop;
-        tracksCtl_[t].trimStart01 = 0.0f;
-        tracksCtl_[t].trimEnd01 = 1.0f;
-    }
-
-    refreshAllTrackViewStates_();
-    sequencerParamMirror_.clear();
-    pendingLoopResets_.clear();
-    for (std::size_t i = 0; i < tracksCtl_.size(); ++i) {
-        const int16_t track = static_cast<int16_t>(i);
-        SequencerParamTarget speed{};
-        speed.track = track;
-        speed.slot = kRtSlotTrackParams;
-        speed.param = toParamIndex(TrackParamId::PlaybackInc);
-        sequencerParamMirror_[makeSequencerTargetKey_(speed)] = tracksCtl_[i].stretchRatio;
-
-        SequencerParamTarget gain{};
-        gain.track = track;
-        gain.slot = kRtSlotTrackParams;
-        gain.param = toParamIndex(TrackParamId::Gain01);
-        sequencerParamMirror_[makeSequencerTargetKey_(gain)] = tracksCtl_[i].gain01;
-
-        SequencerParamTarget start{};
-        start.track = track;
-        start.slot = kRtSlotTrackParams;
-        start.param = toParamIndex(TrackParamId::StartNorm);
-        sequencerParamMirror_[makeSequencerTargetKey_(start)] = tracksCtl_[i].trimStart01;
-
-        SequencerParamTarget end{};
-        end.track = track;
-        end.slot = kRtSlotTrackParams;
-        end.param = toParamIndex(TrackParamId::EndNorm);
-        sequencerParamMirror_[makeSequencerTargetKey_(end)] = tracksCtl_[i].trimEnd01;
-    }
+    resetControlState_(bootstrap);
+    applyAuxBuses_(config);
+    applyStartupClips_(config);
 
     // Публикуем начальный снапшот в UI store.
     UiState initialState{};
@@ -310,6 +280,21 @@ int SamplerApplication::run(const SamplerAppConfig& config) {
         return 3;
     }
     AppDiagnostics::log(AppLogLevel::Info, "engine start ok");
+    if (!config.masterRecordPath.empty()) {
+        if (engine_.startMasterRecording(config.masterRecordPath, config.masterRecord, error)) {
+            AppDiagnostics::logf(AppLogLevel::Info, "master recording to %s", config.masterRecordPath.c_str());
+        } else {
+            // Без записи сет все равно играет: это не повод не стартовать.
+            AppDiagnostics::logf(AppLogLevel::Error, "master recording failed: %s", error.c_str());
+        }
+    }
+    if (!config.stemRecordDir.empty()) {
+        if (engine_.startStemRecording(config.stemRecordDir, config.masterRecord, error)) {
+            AppDiagnostics::logf(AppLogLevel::Info, "stem recording to %s", config.stemRecordDir.c_str());
+        } else {
+            AppDiagnostics::logf(AppLogLevel::Error, "stem recording failed: %s", error.c_str());
+        }
+    }
 
     // 4) Запуск control-потока (обработка input -> intents).
     stopUi_.store(false, std::memory_order_release);
@@ -333,6 +318,13 @@ int SamplerApplication::run(const SamplerAppConfig& config) {
                 if (engine_.processPendingPatternSwitches()) {
                     stateChanged = true;
                 }
+                if (engine_.processPendingTrackFreezes()) {
+                    stateChanged = true;
+                }
+                if (engine_.processPendingSampleLoads()) {
+                    stateChanged = true;
+                }
+                engine_.reclaimRetiredTrackFx();
 
                 // Держим control-кэш синхронизированным с live transport/sampleTime,
                 // чтобы sequencer playback работал по актуальному времени.
@@ -408,6 +400,8 @@ int SamplerApplication::run(const SamplerAppConfig& config) {
 
     // 5) Главный цикл main thread: pump событий окна + рендер кадра.
     auto nextHeartbeat = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    // Окно DSP-профиля heartbeat: статистика за 5 с между двумя записями.
+    DspLoadCapture heartbeatLoadWindow{};
     auto nextRenderAt = std::chrono::steady_clock::now();
     constexpr auto kUiFrameInterval = std::chrono::milliseconds(16); // ~60 FPS cap
     while (!stopUi_.load(std::memory_order_acquire)) {
@@ -429,6 +423,7 @@ int SamplerApplication::run(const SamplerAppConfig& config) {
                     snap.transport.recordEnabled ? 1 : 0,
                     static_cast<unsigned>(sceneRaw),
                     rssMiB);
+                logDspLoadHeartbeat(engine_, heartbeatLoadWindow);
                 nextHeartbeat = nowHeartbeat + std::chrono::seconds(5);
             }
             const bool hadWindowEvents = io_.readWindowEvents();
@@ -467,10 +462,243 @@ int SamplerApplication::run(const SamplerAppConfig& config) {
         controlThread_.join();
     }
     engine_.stop();
+    if (!config.masterRecordPath.empty() || !config.stemRecordDir.empty()) {
+        const SamplerEngineTelemetry finalTelemetry = engine_.telemetryAndResetOverflow();
+        AppDiagnostics::logf(AppLogLevel::Info,
+                             "recording stopped: master_frames=%llu master_dropped_blocks=%llu "
+                             "stem_dropped_blocks=%llu",
+                             static_cast<unsigned long long>(finalTelemetry.masterRecordFrames),
+                             static_cast<unsigned long long>(finalTelemetry.masterRecordDroppedBlocks),
+                             static_cast<unsigned long long>(finalTelemetry.stemRecordDroppedBlocks));
+    }
     AppDiagnostics::log(AppLogLevel::Info, "run complete");
     return 0;
 }
 
+int SamplerApplication::renderOffline(const SamplerAppConfig& config, const SamplerOfflineRenderConfig& render) {
+    AppDiagnostics::logf(AppLogLevel::Info,
+                         "render begin: pattern=%u bars=%u block=%d workers=%u out=%s",
+                         static_cast<unsigned>(render.pattern),
+                         static_cast<unsigned>(render.bars),
+                         config.engine.blockFrames,
+                         static_cast<unsigned>(config.engine.renderWorkers),
+                         render.outPath.c_str());
+    // 1) Движок поверх offline-хоста: блоки тянет этот поток, устройство не открывается.
+    auto host = std::make_shared<OfflineAudioHost>();
+    UiState bootstrap{};
+    std::string error;
+    if (!engine_.init(config.engine, host, bootstrap, error)) {
+        std::printf("%s\n", error.c_str());
+        return 2;
+    }
+    sampleRateHz_ =
+        (std::isfinite(config.engine.sampleRate) && config.engine.sampleRate > 1.0)
+            ? config.engine.sampleRate
+            : 48000.0;
+    resetControlState_(bootstrap);
+    applyAuxBuses_(config);
+    applyStartupClips_(config);
+    if (!engine_.start(error)) {
+        std::printf("%s\n", error.c_str());
+        return 3;
+    }
+
+    const std::size_t blockFrames = static_cast<std::size_t>(std::max(1, config.engine.blockFrames));
+    const int numOut = std::clamp(config.engine.numOutput, 1, 2);
+    std::vector<float> outBuf(blockFrames * static_cast<std::size_t>(numOut), 0.0f);
+    float* outPtrs[2]{outBuf.data(), (numOut > 1) ? outBuf.data() + blockFrames : nullptr};
+
+    // 2) Паттерн активируем при остановленном транспорте: scheduler отдает switch
+    //    на первом же блоке, вывод этих блоков отбрасываем (время транспорта стоит).
+    if (render.pattern != engine_.patternUiState().activeId) {
+        if (!engine_.requestPatternSwitchTo(render.pattern)) {
+            std::printf("Unknown pattern: %u (bank size %u)\n",
+                        static_cast<unsigned>(render.pattern),
+                        static_cast<unsigned>(engine_.patternUiState().bankSize));
+            engine_.stop();
+            return 1;
+        }
+        bool switched = false;
+        for (int i = 0; i < 8 && !switched; ++i) {
+            (void)host->renderBlock(outPtrs, blockFrames);
+            switched = engine_.processPendingPatternSwitches();
+        }
+        if (!switched) {
+            std::printf("Pattern switch to %u did not complete\n", static_cast<unsigned>(render.pattern));
+            engine_.stop();
+            return 3;
+        }
+    }
+    // Пролог: применяем команды switch-плана/стартовых загрузок до первого музыкального блока.
+    (void)host->renderBlock(outPtrs, blockFrames);
+    syncPatternStateToUi_();
+
+    const uint32_t bars = (render.bars > 0U) ? render.bars : currentSequencerPattern_().lengthBars;
+    const double bpm = (std::isfinite(trCtl_.bpm) && trCtl_.bpm > 0.0f) ? static_cast<double>(trCtl_.bpm) : 120.0;
+    const double beatsPerBar =
+        static_cast<double>(std::max<uint8_t>(1U, trCtl_.tsNum)) * 4.0 /
+        static_cast<double>(std::max<uint8_t>(1U, trCtl_.tsDen));
+    const double samplesPerBar = sampleRateHz_ * 60.0 / bpm * beatsPerBar;
+    const uint64_t totalFrames =
+        static_cast<uint64_t>(std::llround(static_cast<double>(bars) * samplesPerBar)) +
+        static_cast<uint64_t>(std::llround(std::max(0.0f, render.tailSeconds) * sampleRateHz_));
+
+    WavFileWriter writer;
+    if (!writer.open(render.outPath, static_cast<int>(std::lround(sampleRateHz_)), numOut, render.format, error)) {
+        std::printf("%s\n", error.c_str());
+        engine_.stop();
+        return 1;
+    }
+
+    // 3) Рендер: между блоками — тот же control-шаг, что в live control loop
+    //    (pattern switch, sync transport, sequencer playback), но без сна и UI.
+    engine_.setTransportPlaying(true);
+    const auto wallStart = std::chrono::steady_clock::now();
+    uint64_t framesDone = 0;
+    bool ok = true;
+    while (framesDone < totalFrames) {
+        if (engine_.processPendingPatternSwitches()) {
+            syncPatternStateToUi_();
+        }
+        (void)engine_.syncUiCache(trCtl_, tracksCtl_);
+        trCtl_.recordEnabled = recordEnabled_;
+        (void)processSequencerPlayback_();
+
+        if (!host->renderBlock(outPtrs, blockFrames)) {
+            error = "offline render block failed";
+            ok = false;
+            break;
+        }
+        const std::size_t n = static_cast<std::size_t>(std::min<uint64_t>(blockFrames, totalFrames - framesDone));
+        if (!writer.write(outPtrs, n)) {
+            error = "wav write failed: " + render.outPath;
+            ok = false;
+            break;
+        }
+        framesDone += n;
+    }
+    const double wallSec =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    engine_.setTransportPlaying(false);
+    engine_.stop();
+
+    std::string closeError;
+    if (!writer.close(closeError) && ok) {
+        error = closeError;
+        ok = false;
+    }
+    if (!ok) {
+        std::printf("%s\n", error.c_str());
+        AppDiagnostics::logf(AppLogLevel::Error, "render failed: %s", error.c_str());
+        return 5;
+    }
+
+    const double audioSec = static_cast<double>(framesDone) / sampleRateHz_;
+    const double speed = (wallSec > 0.0) ? audioSec / wallSec : 0.0;
+    std::printf("Rendered pattern %u: %u bars, %.2f s of audio in %.2f s (x%.1f realtime) -> %s\n",
+                static_cast<unsigned>(render.pattern),
+                static_cast<unsigned>(bars),
+                audioSec,
+                wallSec,
+                speed,
+                render.outPath.c_str());
+    AppDiagnostics::logf(AppLogLevel::Info,
+                         "render complete: frames=%llu audioSec=%.2f wallSec=%.2f speed=x%.1f",
+                         static_cast<unsigned long long>(framesDone),
+                         audioSec,
+                         wallSec,
+                         speed);
+    return 0;
+}
+
+void SamplerApplication::resetControlState_(const UiState& bootstrap) {
+    trCtl_ = bootstrap.transport;
+    tracksCtl_ = bootstrap.tracks;
+    trCtl_.activeTrack = clampUiTrack_(trCtl_.activeTrack);
+    trCtl_.recordEnabled = false;
+    recordEnabled_ = false;
+    sequencerCursorInitialized_ = false;
+    sequencerCursorSample_ = 0;
+    sequencerByPattern_.clear();
+    sequencerPatternId_ =
+        (bootstrap.pattern.activeId == kInvalidPatternId) ? static_cast<PatternId>(1U) : bootstrap.pattern.activeId;
+    (void)ensureSequencerPattern_(sequencerPatternId_);
+}
+
+void SamplerApplication::applyAuxBuses_(const SamplerAppConfig& config) {
+    const uint8_t buses = static_cast<uint8_t>(std::min<uint32_t>(config.engine.auxBuses, kMaxAuxBuses));
+    for (uint8_t bus = 0; bus < buses; ++bus) {
+        if (!engine_.addFxToAux(bus, std::make_unique<SchroederReverbModule>())) {
+            AppDiagnostics::logf(AppLogLevel::Warn, "aux bus %u: reverb not added", static_cast<unsigned>(bus));
+            continue;
+        }
+        // Return-шина: в нее идет только посыл, сухой сигнал трек отдает сам.
+        (void)engine_.setAuxFxParam(bus, 0, SchroederReverbModule::P_WET, 1.0f);
+    }
+    if (buses == 0 || !(config.auxSendLevel > 0.0f)) {
+        return;
+    }
+    const float send = std::clamp(config.auxSendLevel, 0.0f, 1.0f);
+    for (uint8_t t = 0; t < tracksCtl_.size(); ++t) {
+        (void)engine_.setTrackParam(t, auxSendParamIndex(0), send);
+    }
+}
+
+void SamplerApplication::applyStartupClips_(const SamplerAppConfig& config) {
+    // Стартовая загрузка клипов живет в application-слое, а не в config движка.
+    for (const SamplerAppConfig::StartupClipLoad& load : config.startupClipLoads) {
+        if (load.path.empty()) {
+            continue;
+        }
+        if (load.track >= tracksCtl_.size()) {
+            continue;
+        }
+        const uint8_t t = load.track;
+        std::string clipName;
+        if (!engine_.loadSampleToTrack(t, load.path, clipName)) {
+            continue;
+        }
+        tracksCtl_[t].clipName = clipName;
+        tracksCtl_[t].clipPath = load.path;
+        tracksCtl_[t].muted = false;
+        tracksCtl_[t].armed = false;
+        tracksCtl_[t].loop = true;
+        tracksCtl_[t].playbackProfile = UiTrackPlaybackProfile::Loop;
+        tracksCtl_[t].trimStart01 = 0.0f;
+        tracksCtl_[t].trimEnd01 = 1.0f;
+    }
+
+    refreshAllTrackViewStates_();
+    sequencerParamMirror_.clear();
+    pendingLoopResets_.clear();
+    for (std::size_t i = 0; i < tracksCtl_.size(); ++i) {
+        const int16_t track = static_cast<int16_t>(i);
+        SequencerParamTarget speed{};
+        speed.track = track;
+        speed.slot = kRtSlotTrackParams;
+        speed.param = toParamIndex(TrackParamId::PlaybackInc);
+        sequencerParamMirror_[makeSequencerTargetKey_(speed)] = tracksCtl_[i].stretchRatio;
+
+        SequencerParamTarget gain{};
+        gain.track = track;
+        gain.slot = kRtSlotTrackParams;
+        gain.param = toParamIndex(TrackParamId::Gain01);
+        sequencerParamMirror_[makeSequencerTargetKey_(gain)] = tracksCtl_[i].gain01;
+
+        SequencerParamTarget start{};
+        start.track = track;
+        start.slot = kRtSlotTrackParams;
+        start.param = toParamIndex(TrackParamId::StartNorm);
+        sequencerParamMirror_[makeSequencerTargetKey_(start)] = tracksCtl_[i].trimStart01;
+
+        SequencerParamTarget end{};
+        end.track = track;
+        end.slot = kRtSlotTrackParams;
+        end.param = toParamIndex(TrackParamId::EndNorm);
+        sequencerParamMirror_[makeSequencerTargetKey_(end)] = tracksCtl_[i].trimEnd01;
+    }
+}
+
 uint8_t SamplerApplication::clampUiTrack_(uint8_t track) const noexcept {
     if (tracksCtl_.empty()) {
         return 0;
@@ -1525,6 +1753,8 @@ void SamplerApplication::renderUiOnce_() {
     telemetry.xruns = telemetryRt.xruns;
     telemetry.rtQueueOverflow = telemetryRt.rtQueueOverflow;
     telemetry.blockFrames = telemetryRt.blockFrames;
+    telemetry.meters = telemetryRt.meters;
+    telemetry.dspLoad = telemetryRt.dspLoad;
 
     const UiState state = uiComposer_.compose(uiStore_.snapshot(), telemetry);
 
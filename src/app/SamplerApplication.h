@@ -18,6 +18,7 @@
 #include "contracts/UiIntent.h"
 #include "service/UiStateComposer.h"
 #include "service/UiStateStore.h"
+#include "service/audio/WavFileWriter.h"
 #include "service/sequencer/AutomationLane.h"
 #include "service/sequencer/EventLane.h"
 #include "service/sequencer/SmoothedValue.h"
@@ -46,6 +47,28 @@ struct SamplerAppConfig {
     SamplerIoConfig io{};
     // Стартовые загрузки клипов (произвольный список пар track/path).
     std::vector<StartupClipLoad> startupClipLoads{};
+    // Запись master out с момента старта аудио до выхода (пусто — без записи).
+    std::string masterRecordPath{};
+    RecordConfig masterRecord{};
+    // Стемы треков в этот каталог (trackNN.wav), формат — как у masterRecord.
+    std::string stemRecordDir{};
+    // Стартовый посыл всех треков в aux-шину 0 (0..1). На каждую из engine.auxBuses
+    // шин приложение ставит реверб (100% wet): шина — общий return треков.
+    float auxSendLevel{0.0f};
+};
+
+// Параметры headless-рендера паттерна в WAV (--render pattern=N --out file.wav).
+struct SamplerOfflineRenderConfig {
+    // Какой паттерн банка рендерить.
+    PatternId pattern{1};
+    // Длина в тактах (0 = длина паттерна в секвенсоре).
+    uint32_t bars{0};
+    // Хвост после последнего такта (затухание реверба/дилея), секунды.
+    float tailSeconds{0.0f};
+    // Путь к выходному файлу.
+    std::string outPath{};
+    // Формат сэмплов файла.
+    WavSampleFormat format{WavSampleFormat::Pcm24};
 };
 
 // Оркестратор приложения.
@@ -59,8 +82,17 @@ public:
     // Полный жизненный цикл приложения:
     // init -> start -> event loop -> stop.
     int run(const SamplerAppConfig& config);
+    // Headless bounce: без IO/UI и аудиоустройства, блоки рендерятся подряд
+    // так быстро, как позволяет CPU; transport/sequencer/pattern switch — те же, что в run().
+    int renderOffline(const SamplerAppConfig& config, const SamplerOfflineRenderConfig& render);
 
 private:
+    // Сбросить control-кэши (transport/tracks/sequencer) из bootstrap-состояния движка.
+    void resetControlState_(const UiState& bootstrap);
+    // Загрузить стартовые клипы в треки и проинициализировать mirror параметров.
+    void applyStartupClips_(const SamplerAppConfig& config);
+    // Реверб по умолчанию на aux-шины и стартовые посылы треков.
+    void applyAuxBuses_(const SamplerAppConfig& config);
     // Ограничение UI-индекса трека в диапазон [0..N-1].
     uint8_t clampUiTrack_(uint8_t track) const noexcept;
 
@@ -2,9 +2,14 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <filesystem>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -27,7 +32,10 @@
 #include "service/pattern/PatternSwitchPlanApplier.h"
 #include "service/pattern/PatternSnapshotOrchestrator.h"
 #include "service/track/TrackFeatureResolver.h"
+#include "service/audio/AudioRecorder.h"
 #include "service/audio/BpmDetectorService.h"
+#include "service/audio/StemRecorder.h"
+#include "service/audio/ClipLoader.h"
 
 // Concrete runtime impls are compiled into this TU intentionally.
 #include "runtime/AudioEngine.cpp"
@@ -49,6 +57,8 @@ namespace {
 
 constexpr uint8_t kMinTrackCount = 1;
 constexpr uint8_t kMaxTrackCount = 32;
+// Окно DSP-профиля, которое видит HUD.
+constexpr auto kDspLoadHudWindow = std::chrono::seconds(1);
 
 // AVANTGARDE_QUANT_DEFAULT_TUNE:
 // Быстрая ручка UX для дефолтов квантизации.
@@ -59,6 +69,7 @@ constexpr QuantizeMode kDefaultPatternSwitchQuantize = QuantizeMode::Beat;
 // Резолвер ParamBridge использует эти указатели для адресации модулей.
 std::vector<ITrack*> gParamTracks{};
 IParameterized* gParamGlobalTransport{nullptr};
+IAudioEngine* gParamEngine{nullptr};
 
 uint8_t sanitizeTrackCount(uint8_t trackCount) noexcept {
     if (trackCount < kMinTrackCount) {
@@ -154,6 +165,16 @@ IParameterized* resolveParamTarget(Target target) noexcept {
         return gParamGlobalTransport;
     }
 
+    // Aux-шины движка:
+    // Target{trackId = kRtTrackAuxBase - bus, slotId >= 0} -> IAudioModule шины
+    uint32_t auxBus = 0;
+    if (fromRtAuxTrack(target.trackId, auxBus)) {
+        if (!gParamEngine || target.slotId < 0) {
+            return nullptr;
+        }
+        return gParamEngine->getAuxModule(auxBus, static_cast<std::size_t>(target.slotId));
+    }
+
     if (target.trackId < 0 || static_cast<std::size_t>(target.trackId) >= gParamTracks.size()) {
         return nullptr;
     }
@@ -232,6 +253,13 @@ void renderThunk(AudioProcessContext& ctx, void* user) noexcept {
     ru->engine->processBlock(ctx);
 }
 
+// Source BPM сэмпла (0 — не определился). Декодирует файл: вне RT и лучше вне control-потока.
+float detectSourceBpm(const std::string& path) {
+    BpmDetectorService detector{};
+    const BpmDetectionResult det = detector.detectFromFile(path, 1.0f);
+    return (det.ok && std::isfinite(det.sourceBpm) && det.sourceBpm > 0.0f) ? det.sourceBpm : 0.0f;
+}
+
 } // namespace
 
 struct SamplerEngineLayer::Impl {
@@ -279,11 +307,50 @@ struct SamplerEngineLayer::Impl {
     std::unordered_map<std::string, uint32_t> clipPathToRef{};
     // Обратный индекс clipRefId -> оригинальный path.
     std::unordered_map<uint32_t, std::string> clipRefToPath{};
-    // Кэш детекта исходного BPM сэмпла (source BPM, без speed/pitch трека).
+    // Кэш детекта исходного BPM сэмпла (source BPM, без speed/pitch трека; 0 — не определился).
     std::unordered_map<std::string, float> clipPathToSourceBpm{};
     // Генератор clipRefId для runtime-сессии.
     uint32_t nextClipRef{1};
+    // Freeze-рендер трека: идет в рабочем потоке, применяется control-потоком.
+    struct FreezeTask {
+        uint8_t track{0};
+        TrackFreezeJob job{};
+        SharedClipBuffer result{};
+        bool ok{false};
+        std::atomic<bool> done{false};
+        std::thread worker{};
+    };
+    std::vector<std::unique_ptr<FreezeTask>> freezeTasks{};
+    // clipRefId замороженного буфера в clipPool по треку (0 = трек не заморожен).
+    std::vector<uint32_t> frozenClipRefs{};
+    // Асинхронные загрузки сэмплов: билет ClipLoader -> куда применить результат.
+    struct PendingSampleLoad {
+        enum class Target : uint8_t { Track, Preview, Pool };
+        Target target{Target::Track};
+        uint8_t track{0};
+        uint32_t clipRefId{0};
+        TrackPlaybackProfileValue profile{TrackPlaybackProfileValue::Loop};
+        PreviewArgs preview{};
+        // false: клип уже в пуле, рабочая нить только детектит BPM.
+        bool decode{true};
+    };
+    std::unordered_map<uint64_t, PendingSampleLoad> pendingLoads{};
+    // Билет незавершенной загрузки по треку и для preview (0 = нет).
+    std::vector<uint64_t> trackLoadTickets{};
+    // Путь, который грузится в трек: UI показывает его имя вместо прежнего клипа.
+    std::vector<std::string> trackLoadPaths{};
+    uint64_t previewLoadTicket{0};
+    // Объявлен после clipPool: нити декодирования останавливаются раньше, чем умирает пул.
+    std::unique_ptr<ClipLoader> loader{};
     bool metronomeEnabled{false};
+    // Запись master out: sink подключен к движку с init(), вне записи writeBlock() — no-op.
+    AudioRecorder masterRecorder{};
+    // Запись стемов: RT extension движка (граница блока), sink-и подключаются к трекам на время записи.
+    StemRecorder stemRecorder{};
+    // Окно DSP-профиля для telemetry (HUD): пересчитывается не чаще kDspLoadHudWindow.
+    DspLoadCapture dspLoadHudWindow{};
+    DspLoadReport dspLoadHudReport{};
+    std::chrono::steady_clock::time_point dspLoadHudNextAt{};
     // Pattern engine: bank + schedя uler + snapshots.
     std::unique_ptr<PatternEngine> patternEngine{};
     // Оркестратор capture default/live pattern snapshot-ов.
@@ -306,6 +373,96 @@ struct SamplerEngineLayer::Impl {
     IClipTrack* clipAt(uint8_t trackId) const noexcept {
         return trackFeatures.clipTrack(trackId);
     }
+    // clipRefId для path (0 — файл не загрузился). Известный путь не декодируется заново;
+    // вытесненный по бюджету пула клип перечитывается под прежним clipRefId.
+    uint32_t clipRefForPath(const std::string& path) {
+        const auto it = clipPathToRef.find(path);
+        if (it != clipPathToRef.end()) {
+            return ensureClipResident(it->second) ? it->second : 0u;
+        }
+        const uint32_t clipRefId = nextClipRef;
+        std::string err{};
+        if (!clipPool.loadFromFile(clipRefId, path, &err)) {
+            return 0u;
+        }
+        ++nextClipRef;
+        clipPathToRef[path] = clipRefId;
+        clipRefToPath[clipRefId] = path;
+        return clipRefId;
+    }
+    bool ensureClipResident(uint32_t clipRefId) {
+        if (clipPool.contains(clipRefId)) {
+            return true;
+        }
+        const auto it = clipRefToPath.find(clipRefId);
+        std::string err{};
+        return it != clipRefToPath.end() && clipPool.loadFromFile(clipRefId, it->second, &err);
+    }
+    // Клипы всех снапшотов банка закрепляются в пуле: бюджет не вытеснит то, что
+    // понадобится pattern switch-у (иначе apply декодировал бы WAV на control-потоке).
+    void pinPatternClips() {
+        if (!patternEngine) {
+            return;
+        }
+        std::vector<uint32_t> refs{};
+        PatternState state{};
+        for (const PatternId id : patternOrder) {
+            if (!patternEngine->bank().get(id, state)) {
+                continue;
+            }
+            for (const PatternTrackSnapshot& tr : state.tracks) {
+                if (tr.clipRefId != 0u) {
+                    refs.push_back(tr.clipRefId);
+                }
+            }
+        }
+        clipPool.setPinned(refs);
+    }
+    // Поставить декодирование path в ClipLoader; BPM детектится там же, если его нет в кэше.
+    uint64_t submitLoad(const std::string& path, const PendingSampleLoad& pending) {
+        if (!loader) {
+            return 0u;
+        }
+        const bool wantBpm = pending.target == PendingSampleLoad::Target::Track &&
+                             clipPathToSourceBpm.find(path) == clipPathToSourceBpm.end();
+        const ClipBufferPool* pool = &clipPool;
+        const bool decode = pending.decode;
+        const uint64_t ticket = loader->submit(path, [pool, decode, wantBpm](const std::string& p,
+                                                                             ClipLoadResult& r,
+                                                                             const std::atomic<bool>& cancelled) {
+            if (decode && !pool->decodeFile(p, r.buffer, &r.error, &cancelled)) {
+                return false;
+            }
+            if (wantBpm && !cancelled.load(std::memory_order_relaxed)) {
+                r.sourceBpm = detectSourceBpm(p);
+            }
+            return true;
+        });
+        pendingLoads[ticket] = pending;
+        return ticket;
+    }
+    void cancelLoad(uint64_t& ticket) {
+        if (ticket == 0u) {
+            return;
+        }
+        if (loader) {
+            (void)loader->cancel(ticket);
+        }
+        pendingLoads.erase(ticket);
+        ticket = 0u;
+    }
+    // Отменить и дождаться всех freeze-рендеров (до разрушения треков).
+    void joinFreezeTasks() noexcept {
+        for (auto& task : freezeTasks) {
+            task->job.cancel.store(true, std::memory_order_relaxed);
+        }
+        for (auto& task : freezeTasks) {
+            if (task->worker.joinable()) {
+                task->worker.join();
+            }
+        }
+        freezeTasks.clear();
+    }
 };
 
 SamplerEngineLayer::SamplerEngineLayer()
@@ -314,6 +471,7 @@ SamplerEngineLayer::SamplerEngineLayer()
 SamplerEngineLayer::~SamplerEngineLayer() {
     stop();
     gParamGlobalTransport = nullptr;
+    gParamEngine = nullptr;
     gParamTracks.clear();
     delete impl_;
     impl_ = nullptr;
@@ -338,6 +496,15 @@ bool SamplerEngineLayer::init(const SamplerEngineConfig& config,
 
     impl_->engine.setSampleRate(config.sampleRate);
     impl_->trackCount = sanitizeTrackCount(config.trackCount);
+    impl_->frozenClipRefs.assign(impl_->trackCount, 0u);
+    impl_->trackLoadTickets.assign(impl_->trackCount, 0u);
+    impl_->trackLoadPaths.assign(impl_->trackCount, std::string{});
+    impl_->clipPool.setStreaming(config.clipStreamMinSeconds);
+    impl_->clipPool.setDecodeCache(config.clipCacheDir, config.clipCacheMaxBytes);
+    impl_->clipPool.setStorageFormat(config.clipFormat);
+    impl_->clipPool.setTargetSampleRate(config.clipResampleOnLoad ? static_cast<int>(config.sampleRate) : 0);
+    impl_->clipPool.setMemoryBudget(config.clipPoolMaxBytes);
+    impl_->loader = std::make_unique<ClipLoader>(config.sampleLoadWorkers);
     impl_->preview = MakeSamplePreviewEngine();
     impl_->metronomeEnabled = false;
 
@@ -345,7 +512,12 @@ bool SamplerEngineLayer::init(const SamplerEngineConfig& config,
     std::vector<std::unique_ptr<ITrack>> userTracks(impl_->trackCount);
     std::vector<ITrack*> userTrackPtrs(impl_->trackCount, nullptr);
     for (uint8_t t = 0; t < impl_->trackCount; ++t) {
-        userTracks[t] = std::make_unique<ClipTrackImpl>(config.sampleRate, t);
+        auto track = std::make_unique<ClipTrackImpl>(config.sampleRate, t);
+        (void)track->setNotePolyphony(config.notePolyphony, config.voiceSteal);
+        track->setFxResetOnClipSwap(config.fxResetOnClipSwap);
+        track->setParam(toParamIndex(TrackParamId::TempoSyncMode), toParamValue(config.tempoSyncMode));
+        track->mirrorParamForSnapshot(toParamIndex(TrackParamId::TempoSyncMode), toParamValue(config.tempoSyncMode));
+        userTracks[t] = std::move(track);
         userTrackPtrs[t] = userTracks[t].get();
     }
 
@@ -362,6 +534,7 @@ bool SamplerEngineLayer::init(const SamplerEngineConfig& config,
     }
     impl_->trackFeatures.bind(&impl_->tracks);
     gParamGlobalTransport = &impl_->transport;
+    gParamEngine = &impl_->engine;
     impl_->pb.setResolver(&resolveParamTarget);
 
     // Регистрируем пользовательские треки в engine.
@@ -369,6 +542,14 @@ bool SamplerEngineLayer::init(const SamplerEngineConfig& config,
         impl_->engine.registerTrack(std::move(userTracks[t]));
     }
 
+    // Параллельный рендер треков (воркеры поднимаются до старта аудиострима).
+    (void)impl_->engine.setRenderWorkers(config.renderWorkers);
+    (void)impl_->engine.setRenderAhead(config.renderAheadBlocks);
+    (void)impl_->engine.setAuxBusCount(std::min<uint32_t>(config.auxBuses, kMaxAuxBuses));
+    (void)impl_->engine.setMasterLimiter(config.masterLimiter);
+    // Sink ставится до старта стрима и не меняется: start/stop записи его не трогают.
+    impl_->engine.setMasterRecordSink(impl_->masterRecorder.rtSink());
+
     // Включаем транспорт и scheduler extension.
     impl_->engine.setTransportBridge(&impl_->transport);
     impl_->scheduler = std::make_unique<QuantizedSchedulerRtExtension>(
@@ -389,6 +570,7 @@ bool SamplerEngineLayer::init(const SamplerEngineConfig& config,
         config.sampleRate,
         static_cast<uint32_t>(std::max(1, config.numOutput)));
     impl_->engine.addRtExtension(impl_->metronomeRtExt.get());
+    impl_->engine.addRtExtension(&impl_->stemRecorder);
     impl_->patternApplyTarget = std::make_unique<SamplerEnginePatternApplyTarget>(*this);
     impl_->patternOrder.clear();
     const PatternTransportSnapshot bootstrapPatternTransport{
@@ -526,24 +708,139 @@ void SamplerEngineLayer::stop() noexcept {
     if (!impl_) {
         return;
     }
-    // Сначала гасим preview, затем останавливаем стрим.
+    // Сначала гасим preview, загрузки и freeze-рендеры, затем останавливаем стрим.
     previewStop();
+    for (uint64_t& ticket : impl_->trackLoadTickets) {
+        impl_->cancelLoad(ticket);
+    }
+    impl_->joinFreezeTasks();
     if (impl_->running && impl_->stream) {
         impl_->stream->stop();
         impl_->stream->close();
         impl_->stream.reset();
     }
     impl_->running = false;
+    stopMasterRecording();
+    stopStemRecording();
+}
+
+bool SamplerEngineLayer::startMasterRecording(const std::string& path, const RecordConfig& cfg, std::string& errorOut) {
+    if (!impl_ || !impl_->initialized) {
+        errorOut = "engine is not initialized";
+        return false;
+    }
+    RecordConfig effective = cfg;
+    effective.sampleRate = impl_->streamCfg.sampleRate;
+    // Sink читает ровно effective.channels каналов из ctx.out: больше, чем у
+    // потока, быть не может (стерео-запись моно-выхода пишется моно).
+    const int outChannels = impl_->stream ? impl_->stream->numOutput() : impl_->streamCfg.numOutput;
+    if (outChannels < 1) {
+        errorOut = "audio stream has no output channels";
+        return false;
+    }
+    effective.channels = std::min(effective.channels, outChannels);
+    if (!impl_->masterRecorder.start(path, effective)) {
+        errorOut = impl_->masterRecorder.lastError();
+        return false;
+    }
+    return true;
+}
+
+void SamplerEngineLayer::stopMasterRecording() noexcept {
+    if (!impl_) {
+        return;
+    }
+    try {
+        impl_->masterRecorder.stop();
+    } catch (...) {
+    }
+}
+
+bool SamplerEngineLayer::isMasterRecording() const noexcept {
+    return impl_ && impl_->masterRecorder.isRecording();
+}
+
+bool SamplerEngineLayer::startStemRecording(const std::string& directory, const RecordConfig& cfg, std::string& errorOut) {
+    if (!impl_ || !impl_->initialized) {
+        errorOut = "engine is not initialized";
+        return false;
+    }
+    stopStemRecording();
+    const std::size_t count = std::min<std::size_t>(impl_->trackCount, StemRecorder::kMaxStems);
+    std::vector<std::string> paths{};
+    paths.reserve(count);
+    for (std::size_t t = 0; t < count; ++t) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "track%02u.wav", static_cast<unsigned>(t + 1));
+        paths.push_back((std::filesystem::path(directory) / name).string());
+    }
+    // Sink-и подключаются до start(): первый записанный блок общий для всех треков.
+    for (std::size_t t = 0; t < count; ++t) {
+        if (IClipTrack* clip = impl_->clipAt(static_cast<uint8_t>(t))) {
+            clip->setStemSink(impl_->stemRecorder.stemSink(t));
+        }
+    }
+    RecordConfig effective = cfg;
+    effective.sampleRate = impl_->streamCfg.sampleRate;
+    if (!impl_->stemRecorder.start(paths, effective)) {
+        errorOut = impl_->stemRecorder.lastError();
+        stopStemRecording();
+        return false;
+    }
+    return true;
+}
+
+void SamplerEngineLayer::stopStemRecording() noexcept {
+    if (!impl_) {
+        return;
+    }
+    try {
+        impl_->stemRecorder.stop();
+    } catch (...) {
+        // Сток все равно отключаем ниже: accepting_ снят до первой точки, где stop() может бросить.
+    }
+    for (uint8_t t = 0; t < impl_->trackCount; ++t) {
+        if (IClipTrack* clip = impl_->clipAt(t)) {
+            clip->setStemSink(nullptr);
+        }
+    }
+}
+
+bool SamplerEngineLayer::isStemRecording() const noexcept {
+    return impl_ && impl_->stemRecorder.isRecording();
 }
 
 SamplerEngineTelemetry SamplerEngineLayer::telemetryAndResetOverflow() noexcept {
     SamplerEngineTelemetry out{};
-    if (!impl_ || !impl_->stream) {
+    if (!impl_) {
+        return out;
+    }
+    // Счетчики записи валидны и после stop(): итог последней записи.
+    out.masterRecording = impl_->masterRecorder.isRecording();
+    out.masterRecordFrames = impl_->masterRecorder.totalFramesWritten();
+    out.masterRecordDroppedBlocks = impl_->masterRecorder.droppedBlocks();
+    out.stemRecording = impl_->stemRecorder.isRecording();
+    out.stemRecordDroppedBlocks = impl_->stemRecorder.droppedBlocks();
+    if (!impl_->stream) {
         return out;
     }
     out.totalCallbacks = impl_->stream->totalCallbacks();
     out.xruns = impl_->stream->xruns();
     out.blockFrames = static_cast<uint32_t>(impl_->stream->blockFrames());
+    out.meters = impl_->engine.readMeters();
+    // Перцентили по паре блоков бессмысленны: HUD видит окно ~1 с, а не кадр UI.
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= impl_->dspLoadHudNextAt) {
+        dspLoadReport(impl_->dspLoadHudWindow, impl_->dspLoadHudReport);
+        impl_->dspLoadHudNextAt = now + kDspLoadHudWindow;
+    }
+    out.dspLoad = &impl_->dspLoadHudReport;
+    out.clipStreamUnderruns = impl_->clipPool.streamUnderruns();
+    const ClipPoolStats pool = impl_->clipPool.stats();
+    out.clipPoolResidentBytes = pool.residentBytes;
+    out.clipPoolHits = pool.hits;
+    out.clipPoolMisses = pool.misses;
+    out.clipPoolEvictions = pool.evictions;
     // overflow флаги читаются и сразу сбрасываются.
     out.rtQueueOverflow =
         impl_->qUi.overflowFlagAndReset() ||
@@ -552,6 +849,20 @@ SamplerEngineTelemetry SamplerEngineLayer::telemetryAndResetOverflow() noexcept
     return out;
 }
 
+void SamplerEngineLayer::dspLoadReport(DspLoadCapture& window, DspLoadReport& out) const {
+    out = DspLoadReport{};
+    if (!impl_) {
+        return;
+    }
+    DspLoadCapture now{};
+    impl_->engine.captureDspLoad(now);
+    const double sr = (impl_->streamCfg.sampleRate > 0) ? static_cast<double>(impl_->streamCfg.sampleRate) : 48000.0;
+    const int frames = impl_->stream ? impl_->stream->blockFrames() : impl_->streamCfg.blockFrames;
+    const double budgetUs = 1e6 * static_cast<double>(std::max(frames, 1)) / sr;
+    DspLoadProfiler::buildReport(now, window.sites.empty() ? nullptr : &window, budgetUs, out);
+    window = std::move(now);
+}
+
 void SamplerEngineLayer::setTransportPlaying(bool playing) noexcept {
     if (!impl_) {
         return;
@@ -779,6 +1090,27 @@ bool SamplerEngineLayer::setTrackTempoSync(uint8_t track, bool enabled) noexcept
     return ok;
 }
 
+bool SamplerEngineLayer::setTrackTempoSyncMode(uint8_t track, TempoSyncModeValue mode) noexcept {
+    if (!impl_ || impl_->tracks.empty()) {
+        return false;
+    }
+    const uint8_t t = clampTrack(track, impl_->trackCount);
+    ITrack* tr = impl_->trackAt(t);
+    if (!tr || !tr->healthcheck()) {
+        return false;
+    }
+    const bool ok = impl_->controlDispatcher.sendTrackParamSet(
+        static_cast<int16_t>(t),
+        TrackParamId::TempoSyncMode,
+        toParamValue(mode));
+    if (ok) {
+        if (IClipTrack* clip = impl_->clipAt(t)) {
+            clip->mirrorParamForSnapshot(toParamIndex(TrackParamId::TempoSyncMode), toParamValue(mode));
+        }
+    }
+    return ok;
+}
+
 bool SamplerEngineLayer::triggerTrackNoteOn(uint8_t track, uint8_t note, float velocity01) noexcept {
     if (!impl_ || impl_->tracks.empty()) {
         return false;
@@ -883,6 +1215,31 @@ bool SamplerEngineLayer::removeFxFromTrack(uint8_t track, uint8_t fxSlot) noexce
     return clip->removeModuleAt(static_cast<std::size_t>(fxSlot));
 }
 
+bool SamplerEngineLayer::addFxToAux(uint8_t bus, std::unique_ptr<IAudioModule> module) noexcept {
+    if (!impl_ || !module) {
+        return false;
+    }
+    // addAuxModule вызывается строго вне RT (init модуля + публикация снапшота).
+    return impl_->engine.addAuxModule(bus, std::move(module));
+}
+
+bool SamplerEngineLayer::setAuxFxParam(uint8_t bus,
+                                       uint8_t fxSlot,
+                                       uint16_t paramIndex,
+                                       float normalizedValue) noexcept {
+    if (!impl_ || bus >= kMaxAuxBuses) {
+        return false;
+    }
+    if (!impl_->engine.getAuxModule(bus, static_cast<std::size_t>(fxSlot))) {
+        return false;
+    }
+    return impl_->controlDispatcher.sendParamSet(
+        toRtAuxTrack(bus),
+        static_cast<int16_t>(fxSlot),
+        paramIndex,
+        normalizedValue);
+}
+
 bool SamplerEngineLayer::setFxParam(uint8_t track,
                                     uint8_t fxSlot,
                                     uint16_t paramIndex,
@@ -940,20 +1297,22 @@ bool SamplerEngineLayer::loadSampleToTrack(uint8_t track,
     }
 
     // 1) Резолвим clipRefId для path.
-    uint32_t clipRefId = 0;
-    const auto it = impl_->clipPathToRef.find(path);
-    if (it != impl_->clipPathToRef.end()) {
-        clipRefId = it->second;
-    } else {
-        clipRefId = impl_->nextClipRef++;
-        std::string err{};
-        if (!impl_->clipPool.loadFromFile(clipRefId, path, &err)) {
-            return false;
-        }
-        impl_->clipPathToRef[path] = clipRefId;
-        impl_->clipRefToPath[clipRefId] = path;
+    const uint32_t clipRefId = impl_->clipRefForPath(path);
+    if (clipRefId == 0u) {
+        return false;
+    }
+    if (!bindLoadedClip_(t, clipRefId, path)) {
+        return false;
     }
+    clipNameOut = clipNameFromPath(path);
+    return true;
+}
 
+bool SamplerEngineLayer::bindLoadedClip_(uint8_t t, uint32_t clipRefId, const std::string& path) noexcept {
+    IClipTrack* clip = impl_->clipAt(t);
+    if (!clip || !clip->healthcheck()) {
+        return false;
+    }
     // 2) Назначаем preloaded буфер треку без повторного декодирования.
     if (!impl_->clipPool.bindClipToTrack(*clip, 0, clipRefId)) {
         return false;
@@ -975,16 +1334,13 @@ bool SamplerEngineLayer::loadSampleToTrack(uint8_t track,
         const PatternTransportSnapshot transportSnap = readPatternTransportSnapshot(impl_->transport);
         float barsTempoBpm = transportSnap.bpm;
         if (!path.empty()) {
-            const auto itBpm = impl_->clipPathToSourceBpm.find(path);
-            if (itBpm != impl_->clipPathToSourceBpm.end()) {
+            auto itBpm = impl_->clipPathToSourceBpm.find(path);
+            if (itBpm == impl_->clipPathToSourceBpm.end()) {
+                // Асинхронная загрузка уже положила результат детекта из рабочей нити.
+                itBpm = impl_->clipPathToSourceBpm.emplace(path, detectSourceBpm(path)).first;
+            }
+            if (itBpm->second > 0.0f) {
                 barsTempoBpm = std::clamp(itBpm->second, 20.0f, 300.0f);
-            } else {
-                BpmDetectorService detector{};
-                const BpmDetectionResult det = detector.detectFromFile(path, 1.0f);
-                if (det.ok && std::isfinite(det.sourceBpm) && det.sourceBpm > 0.0f) {
-                    barsTempoBpm = std::clamp(det.sourceBpm, 20.0f, 300.0f);
-                    impl_->clipPathToSourceBpm[path] = barsTempoBpm;
-                }
             }
         }
         const uint32_t inferredBars =
@@ -1000,7 +1356,6 @@ bool SamplerEngineLayer::loadSampleToTrack(uint8_t track,
                 kRtValueOff);
         }
     }
-    clipNameOut = clipNameFromPath(path);
     return true;
 }
 
@@ -1042,7 +1397,7 @@ bool SamplerEngineLayer::setTrackClipRef(uint8_t track, uint32_t clipRefId) noex
     if (!clip || !clip->healthcheck()) {
         return false;
     }
-    const bool ok = impl_->clipPool.bindClipToTrack(*clip, 0, clipRefId);
+    const bool ok = impl_->ensureClipResident(clipRefId) && impl_->clipPool.bindClipToTrack(*clip, 0, clipRefId);
     if (ok) {
         clip->setClipRefId(clipRefId);
     }
@@ -1065,6 +1420,138 @@ bool SamplerEngineLayer::clearTrackSample(uint8_t track) noexcept {
     return ok;
 }
 
+bool SamplerEngineLayer::freezeTrack(uint8_t track) noexcept {
+    if (!impl_ || impl_->tracks.empty()) {
+        return false;
+    }
+    const uint8_t t = clampTrack(track, impl_->trackCount);
+    IClipTrack* clip = impl_->clipAt(t);
+    if (!clip || !clip->healthcheck() || clip->isFrozen()) {
+        return false;
+    }
+    for (const auto& task : impl_->freezeTasks) {
+        if (task->track == t) {
+            return false;
+        }
+    }
+    try {
+        auto task = std::make_unique<Impl::FreezeTask>();
+        task->track = t;
+        if (!clip->captureFreezeJob(task->job)) {
+            return false;
+        }
+        // Transport для tempo-sync FX берем с control-стороны, а не из RT-состояния трека.
+        const PatternTransportSnapshot transportSnap = readPatternTransportSnapshot(impl_->transport);
+        task->job.bpm = transportSnap.bpm;
+        task->job.tsNum = transportSnap.tsNum;
+        task->job.tsDen = transportSnap.tsDen;
+        Impl::FreezeTask* raw = task.get();
+        impl_->freezeTasks.push_back(std::move(task));
+        try {
+            // Рендер трогает только данные задания: трек тем временем играет как обычно.
+            raw->worker = std::thread([clip, raw]() {
+                try {
+                    raw->ok = clip->renderFreezeJob(raw->job, raw->result);
+                } catch (...) {
+                    raw->ok = false;
+                }
+                raw->done.store(true, std::memory_order_release);
+            });
+        } catch (...) {
+            impl_->freezeTasks.pop_back();
+            return false;
+        }
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+bool SamplerEngineLayer::unfreezeTrack(uint8_t track) noexcept {
+    if (!impl_ || impl_->tracks.empty()) {
+        return false;
+    }
+    const uint8_t t = clampTrack(track, impl_->trackCount);
+    bool cancelled = false;
+    for (auto& task : impl_->freezeTasks) {
+        if (task->track == t) {
+            // Результат отброшенного задания processPendingTrackFreezes() не применит.
+            task->job.cancel.store(true, std::memory_order_relaxed);
+            cancelled = true;
+        }
+    }
+    IClipTrack* clip = impl_->clipAt(t);
+    const bool unfrozen = clip && clip->unfreeze();
+    if (impl_->frozenClipRefs[t] != 0u) {
+        (void)impl_->clipPool.erase(impl_->frozenClipRefs[t]);
+        impl_->frozenClipRefs[t] = 0u;
+    }
+    return unfrozen || cancelled;
+}
+
+bool SamplerEngineLayer::isTrackFrozen(uint8_t track) const noexcept {
+    if (!impl_ || impl_->tracks.empty()) {
+        return false;
+    }
+    const IClipTrack* clip = impl_->clipAt(clampTrack(track, impl_->trackCount));
+    return clip && clip->isFrozen();
+}
+
+bool SamplerEngineLayer::processPendingTrackFreezes() noexcept {
+    if (!impl_) {
+        return false;
+    }
+    bool changed = false;
+    auto& tasks = impl_->freezeTasks;
+    for (auto it = tasks.begin(); it != tasks.end();) {
+        Impl::FreezeTask& task = **it;
+        if (!task.done.load(std::memory_order_acquire)) {
+            ++it;
+            continue;
+        }
+        task.worker.join();
+        IClipTrack* clip = impl_->clipAt(task.track);
+        if (task.ok && clip && !task.job.cancel.load(std::memory_order_relaxed)) {
+            const uint32_t clipRefId = impl_->nextClipRef;
+            if (impl_->clipPool.put(clipRefId, task.result)) {
+                // applyFreeze() откажет, если трек успел сменить клип или FX-цепочку.
+                if (clip->applyFreeze(task.job, task.result)) {
+                    ++impl_->nextClipRef;
+                    impl_->frozenClipRefs[task.track] = clipRefId;
+                    changed = true;
+                } else {
+                    (void)impl_->clipPool.erase(clipRefId);
+                }
+            }
+        }
+        it = tasks.erase(it);
+    }
+    // Загрузка/очистка слота снимает freeze в самом треке: освобождаем его буфер в пуле.
+    for (uint8_t t = 0; t < impl_->frozenClipRefs.size(); ++t) {
+        const IClipTrack* clip = impl_->clipAt(t);
+        if (impl_->frozenClipRefs[t] != 0u && !(clip && clip->isFrozen())) {
+            (void)impl_->clipPool.erase(impl_->frozenClipRefs[t]);
+            impl_->frozenClipRefs[t] = 0u;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void SamplerEngineLayer::reclaimRetiredTrackFx() noexcept {
+    if (!impl_) {
+        return;
+    }
+    try {
+        for (uint8_t t = 0; t < impl_->trackCount; ++t) {
+            if (IClipTrack* clip = impl_->clipAt(t)) {
+                clip->reclaimRetiredFx();
+            }
+        }
+    } catch (...) {
+    }
+}
+
 void SamplerEngineLayer::previewRequest(const std::string& path,
                                         float speed,
                                         float start01,
@@ -1076,33 +1563,37 @@ void SamplerEngineLayer::previewRequest(const std::string& path,
     if (!impl_->preview) {
         return;
     }
+    // Новый запрос заменяет недогруженный: пользователь уже пролистал тот файл.
+    impl_->cancelLoad(impl_->previewLoadTicket);
     if (path.empty()) {
         impl_->preview->stop();
         return;
     }
 
-    uint32_t clipRefId = 0u;
+    const PreviewArgs args{speed, start01, end01, gain01};
     const auto it = impl_->clipPathToRef.find(path);
-    if (it != impl_->clipPathToRef.end()) {
-        clipRefId = it->second;
-    } else {
-        clipRefId = impl_->nextClipRef++;
-        std::string err{};
-        if (!impl_->clipPool.loadFromFile(clipRefId, path, &err)) {
-            return;
-        }
-        impl_->clipPathToRef[path] = clipRefId;
-        impl_->clipRefToPath[clipRefId] = path;
+    if (it != impl_->clipPathToRef.end() && impl_->clipPool.contains(it->second)) {
+        // Тот же файл, что уже на треке, играет из пула сразу.
+        playPreview_(it->second, args);
+        return;
     }
+    // Декодирование — в ClipLoader; звук начнется в processPendingSampleLoads().
+    impl_->preview->stop();
+    Impl::PendingSampleLoad pending{};
+    pending.target = Impl::PendingSampleLoad::Target::Preview;
+    pending.preview = args;
+    impl_->previewLoadTicket = impl_->submitLoad(path, pending);
+}
 
+void SamplerEngineLayer::playPreview_(uint32_t clipRefId, const PreviewArgs& args) noexcept {
     SharedClipBuffer sample{};
     if (!impl_->clipPool.get(clipRefId, sample) || !sample.valid()) {
         impl_->preview->stop();
         return;
     }
 
-    const float safeStart01 = std::clamp(start01, 0.0f, 1.0f);
-    const float safeEnd01 = std::clamp(std::max(end01, safeStart01 + 0.01f), 0.0f, 1.0f);
+    const float safeStart01 = std::clamp(args.start01, 0.0f, 1.0f);
+    const float safeEnd01 = std::clamp(std::max(args.end01, safeStart01 + 0.01f), 0.0f, 1.0f);
     const int32_t frames = static_cast<int32_t>(sample.frames);
     SampleRegion region{};
     region.startFrame = std::clamp<int32_t>(
@@ -1115,11 +1606,11 @@ void SamplerEngineLayer::previewRequest(const std::string& path,
         std::max(1, frames));
 
     PreviewOptions options{};
-    options.gain = std::clamp(gain01, 0.0f, 1.0f);
+    options.gain = std::clamp(args.gain01, 0.0f, 1.0f);
     options.speed = 1.0f;
     impl_->preview->play(sample,
                          region,
-                         std::clamp(speed, 0.25f, 4.0f),
+                         std::clamp(args.speed, 0.25f, 4.0f),
                          SamplePreviewLoopMode::Off,
                          options);
 }
@@ -1128,12 +1619,132 @@ void SamplerEngineLayer::previewStop() noexcept {
     if (!impl_) {
         return;
     }
+    impl_->cancelLoad(impl_->previewLoadTicket);
     if (!impl_->preview) {
         return;
     }
     impl_->preview->stop();
 }
 
+SampleLoadStatus SamplerEngineLayer::requestSampleToTrack(uint8_t track,
+                                                          const std::string& path,
+                                                          TrackPlaybackProfileValue profile,
+                                                          std::string& clipNameOut) noexcept {
+    if (!impl_ || path.empty() || impl_->tracks.empty()) {
+        return SampleLoadStatus::Failed;
+    }
+    const uint8_t t = clampTrack(track, impl_->trackCount);
+    IClipTrack* clip = impl_->clipAt(t);
+    if (!clip || !clip->healthcheck()) {
+        return SampleLoadStatus::Failed;
+    }
+    // Повторный выбор на том же треке отменяет предыдущую недогруженную загрузку.
+    impl_->cancelLoad(impl_->trackLoadTickets[t]);
+    const auto it = impl_->clipPathToRef.find(path);
+    const bool resident = it != impl_->clipPathToRef.end() && impl_->clipPool.contains(it->second);
+    if (resident && impl_->clipPathToSourceBpm.count(path) != 0u) {
+        // Все уже в памяти: назначаем сразу, без рабочей нити.
+        if (!bindLoadedClip_(t, it->second, path)) {
+            return SampleLoadStatus::Failed;
+        }
+        (void)setTrackPlaybackProfile(t, profile);
+        clipNameOut = clipNameFromPath(path);
+        return SampleLoadStatus::Loaded;
+    }
+    Impl::PendingSampleLoad pending{};
+    pending.target = Impl::PendingSampleLoad::Target::Track;
+    pending.track = t;
+    pending.profile = profile;
+    pending.decode = !resident;
+    impl_->trackLoadTickets[t] = impl_->submitLoad(path, pending);
+    if (impl_->trackLoadTickets[t] == 0u) {
+        return SampleLoadStatus::Failed;
+    }
+    impl_->trackLoadPaths[t] = path;
+    clipNameOut = clipNameFromPath(path);
+    return SampleLoadStatus::Pending;
+}
+
+bool SamplerEngineLayer::requestClipPreload(uint32_t clipRefId, const std::string& path) noexcept {
+    if (!impl_ || clipRefId == 0u || path.empty()) {
+        return false;
+    }
+    Impl::PendingSampleLoad pending{};
+    pending.target = Impl::PendingSampleLoad::Target::Pool;
+    pending.clipRefId = clipRefId;
+    return impl_->submitLoad(path, pending) != 0u;
+}
+
+bool SamplerEngineLayer::isTrackLoading(uint8_t track) const noexcept {
+    if (!impl_ || impl_->trackLoadTickets.empty()) {
+        return false;
+    }
+    return impl_->trackLoadTickets[clampTrack(track, impl_->trackCount)] != 0u;
+}
+
+bool SamplerEngineLayer::processPendingSampleLoads() noexcept {
+    if (!impl_ || !impl_->loader) {
+        return false;
+    }
+    bool changed = false;
+    ClipLoadCompletion done{};
+    while (impl_->loader->poll(done)) {
+        const auto itPending = impl_->pendingLoads.find(done.ticket);
+        if (itPending == impl_->pendingLoads.end()) {
+            continue;
+        }
+        const Impl::PendingSampleLoad pending = itPending->second;
+        impl_->pendingLoads.erase(itPending);
+        if (pending.target == Impl::PendingSampleLoad::Target::Track) {
+            impl_->trackLoadTickets[pending.track] = 0u;
+        } else if (pending.target == Impl::PendingSampleLoad::Target::Preview) {
+            impl_->previewLoadTicket = 0u;
+        }
+        changed = true;
+        if (!done.ok) {
+            continue;
+        }
+        if (done.result.sourceBpm > 0.0f || pending.target == Impl::PendingSampleLoad::Target::Track) {
+            impl_->clipPathToSourceBpm.emplace(done.path, done.result.sourceBpm);
+        }
+
+        // Путь мог успеть загрузиться другим запросом: тогда пул сам отдаст тот же буфер (dedup).
+        uint32_t clipRefId = pending.clipRefId;
+        if (clipRefId == 0u) {
+            const auto itRef = impl_->clipPathToRef.find(done.path);
+            clipRefId = (itRef != impl_->clipPathToRef.end()) ? itRef->second : impl_->nextClipRef;
+        }
+        const bool stored = pending.decode ? impl_->clipPool.put(clipRefId, done.result.buffer)
+                                           : impl_->ensureClipResident(clipRefId);
+        if (!stored) {
+            continue;
+        }
+        impl_->clipPathToRef[done.path] = clipRefId;
+        impl_->clipRefToPath[clipRefId] = done.path;
+        if (clipRefId >= impl_->nextClipRef) {
+            impl_->nextClipRef = clipRefId + 1u;
+        }
+        // Ссылку на буфер держит теперь только пул: трек/preview ниже возьмут свою.
+        done.result.buffer = SharedClipBuffer{};
+
+        switch (pending.target) {
+            case Impl::PendingSampleLoad::Target::Track:
+                if (bindLoadedClip_(pending.track, clipRefId, done.path)) {
+                    (void)setTrackPlaybackProfile(pending.track, pending.profile);
+                }
+                break;
+            case Impl::PendingSampleLoad::Target::Preview:
+                if (impl_->preview) {
+                    playPreview_(clipRefId, pending.preview);
+                }
+                break;
+            case Impl::PendingSampleLoad::Target::Pool:
+                break;
+        }
+    }
+    return changed;
+}
+
 bool SamplerEngineLayer::requestPatternSwitchRelative(int delta) noexcept {
     if (!impl_ || !impl_->patternEngine || impl_->patternOrder.empty()) {
         return false;
@@ -1192,8 +1803,10 @@ bool SamplerEngineLayer::captureActivePatternSnapshot_() noexcept {
     if (!impl_ || !impl_->patternEngine || !impl_->patternSnapshotOrchestrator) {
         return false;
     }
-    return impl_->patternSnapshotOrchestrator->captureActivePattern(
+    const bool ok = impl_->patternSnapshotOrchestrator->captureActivePattern(
         std::span<ISnapshotable* const>(impl_->snapshotables.data(), impl_->snapshotables.size()));
+    impl_->pinPatternClips();
+    return ok;
 }
 
 bool SamplerEngineLayer::processPendingPatternSwitches() noexcept {
@@ -1282,6 +1895,8 @@ bool SamplerEngineLayer::syncUiCache(UiTransportState& transportInOut,
                               : UiTrackPlaybackMode::Looper;
         ui.loop = sh.loopEnabled;
         ui.tempoSync = sh.tempoSync;
+        const IClipTrack* clipTrack = impl_->clipAt(t);
+        ui.frozen = clipTrack && clipTrack->isFrozen();
         ui.playbackProfile = uiProfileFromModeLoop(
             (ui.playbackMode == UiTrackPlaybackMode::Note)
                 ? TrackPlaybackModeValue::Note
@@ -1304,7 +1919,11 @@ bool SamplerEngineLayer::syncUiCache(UiTransportState& transportInOut,
         }
 
         const uint32_t clipRef = sh.clipRefId;
-        if (clipRef == 0u) {
+        const bool loading = impl_->trackLoadTickets.size() > t && impl_->trackLoadTickets[t] != 0u;
+        if (loading) {
+            ui.clipPath = impl_->trackLoadPaths[t];
+            ui.clipName = clipNameFromPath(ui.clipPath);
+        } else if (clipRef == 0u) {
             ui.clipPath.clear();
             ui.clipName.clear();
         } else {
@@ -1318,7 +1937,9 @@ bool SamplerEngineLayer::syncUiCache(UiTransportState& transportInOut,
             }
         }
 
-        if (ui.clipName.empty()) {
+        if (loading) {
+            ui.state = UiTrackState::Loading;
+        } else if (ui.clipName.empty()) {
             ui.state = UiTrackState::Empty;
         } else if (transportInOut.playing) {
             ui.state = UiTrackState::Playing;
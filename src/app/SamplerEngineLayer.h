@@ -4,7 +4,9 @@
 #include <memory>
 #include <string>
 
+#include "contracts/IAudioEngine.h"
 #include "contracts/IAudioModule.h"
+#include "contracts/IAudioRecorder.h"
 #include "contracts/IUi.h"
 #include "contracts/IPlatform.h"
 #include "contracts/ITransport.h"
@@ -25,6 +27,38 @@ struct SamplerEngineConfig {
     int numInput{0};
     // Число выходных каналов хоста.
     int numOutput{2};
+    // Дополнительные RT-воркеры для параллельного рендера треков (0 = в аудио-нити).
+    uint8_t renderWorkers{0};
+    // Глубина render-ahead в блоках: треки, которые только играют клип по транспорту,
+    // рендерятся фоновой нитью заранее (0 = выключено, все треки в аудио-нити).
+    uint8_t renderAheadBlocks{0};
+    // Полифония note-режима на трек (1 = моно, как раньше) и политика кражи голосов.
+    uint8_t notePolyphony{1};
+    VoiceStealPolicyValue voiceSteal{VoiceStealPolicyValue::Oldest};
+    // Сбрасывать FX трека при смене клипа (false = хвосты переживают pattern switch).
+    bool fxResetOnClipSwap{false};
+    // Клипы длиннее этого (секунды) играются с диска: в памяти только голова (0 = все в память).
+    double clipStreamMinSeconds{0.0};
+    // Каталог кэша декодированных клипов (пусто = выключен) и его лимит в байтах.
+    std::string clipCacheDir{};
+    uint64_t clipCacheMaxBytes{uint64_t{1} << 30};
+    // Формат хранения клипов в памяти: int16/half вдвое экономят память и полосу.
+    ClipSampleFormat clipFormat{ClipSampleFormat::Float32};
+    // Приводить клипы к sampleRate движка полифазным SRC при загрузке (в нити загрузчика):
+    // на скорости 1.0 трек копирует сэмплы вместо cubic-интерполяции.
+    bool clipResampleOnLoad{false};
+    // Режим tempo sync треков по умолчанию: Stretch держит высоту клипа (WSOLA)
+    // ценой анализа клипа при загрузке и ~grain-а вычислений на 512 кадров в RT.
+    TempoSyncModeValue tempoSyncMode{TempoSyncModeValue::Varispeed};
+    // Бюджет памяти сэмплов пула клипов в байтах (0 = без лимита): сверх него
+    // вытесняются давно не игравшие клипы, которые не держит ни трек, ни preview.
+    uint64_t clipPoolMaxBytes{0};
+    // Нити асинхронной загрузки сэмплов (декодирование вне control-потока).
+    uint8_t sampleLoadWorkers{2};
+    // Число aux return-шин движка (0..kMaxAuxBuses): общие FX с посылами треков.
+    uint8_t auxBuses{0};
+    // Мастер-лимитер перед выходом хоста (вместо жесткого клипа при конвертации в int16).
+    MasterLimiterConfig masterLimiter{true};
 };
 
 // Runtime метрики из аудиохоста/RT очередей.
@@ -37,6 +71,31 @@ struct SamplerEngineTelemetry {
     bool rtQueueOverflow{false};
     // Текущий размер блока в кадрах.
     uint32_t blockFrames{0};
+    // Последний кадр метров движка; валиден до следующего вызова telemetryAndResetOverflow().
+    const EngineMeterFrame* meters{nullptr};
+    // Профиль DSP-нагрузки за последнее окно (~1 с); валиден до следующего вызова telemetryAndResetOverflow().
+    const DspLoadReport* dspLoad{nullptr};
+    // Underrun-ы потоковых клипов: RT не дождался кадров с диска (накопительно).
+    uint64_t clipStreamUnderruns{0};
+    // Пул клипов: память сэмплов и накопительные попадания/промахи/вытеснения.
+    uint64_t clipPoolResidentBytes{0};
+    uint64_t clipPoolHits{0};
+    uint64_t clipPoolMisses{0};
+    uint64_t clipPoolEvictions{0};
+    // Запись master out: кадров в файле и блоков, отброшенных из-за отставания диска.
+    bool masterRecording{false};
+    uint64_t masterRecordFrames{0};
+    uint64_t masterRecordDroppedBlocks{0};
+    // Запись стемов: блоки, замененные тишиной (сумма по трекам).
+    bool stemRecording{false};
+    uint64_t stemRecordDroppedBlocks{0};
+};
+
+// Итог запроса асинхронной загрузки сэмпла.
+enum class SampleLoadStatus : uint8_t {
+    Failed = 0,
+    Loaded,  // клип уже был в памяти и назначен сразу
+    Pending  // декодируется; результат применит processPendingSampleLoads()
 };
 
 // Изолированный слой Engine:
@@ -60,6 +119,22 @@ public:
 
     // Снять telemetry + очистить overflow-флаги очередей.
     SamplerEngineTelemetry telemetryAndResetOverflow() noexcept;
+    // Профиль DSP-нагрузки за окно с прошлого вызова с тем же window (вне RT).
+    // Каждый потребитель (heartbeat, HUD) держит свой window; первый вызов — статистика с запуска.
+    void dspLoadReport(DspLoadCapture& window, DspLoadReport& out) const;
+
+    // Запись master out на диск (AudioRecorder): RT только копирует блок в кольцо,
+    // файл пишет нить рекордера. cfg.sampleRate берется из движка.
+    bool startMasterRecording(const std::string& path, const RecordConfig& cfg, std::string& errorOut);
+    // Остановить запись и финализировать файл (вне RT). Вызывается и из stop(), поэтому
+    // исключения рекордера (join нити, mutex) гасятся внутри.
+    void stopMasterRecording() noexcept;
+    bool isMasterRecording() const noexcept;
+    // Запись стемов: post-FX выход каждого трека в directory/trackNN.wav (NN с 01),
+    // все стемы покадрово выровнены. cfg.channels игнорируется (стем — stereo).
+    bool startStemRecording(const std::string& directory, const RecordConfig& cfg, std::string& errorOut);
+    void stopStemRecording() noexcept;
+    bool isStemRecording() const noexcept;
 
     // Глобальные transport операции.
     void setTransportPlaying(bool playing) noexcept;
@@ -85,6 +160,8 @@ public:
     // ON  -> playbackInc следует за transport BPM/TS и bars,
     // OFF -> playbackInc остается ручным.
     bool setTrackTempoSync(uint8_t track, bool enabled) noexcept;
+    // Как tempo-sync подгоняет клип трека: varispeed (с высотой) или time-stretch.
+    bool setTrackTempoSyncMode(uint8_t track, TempoSyncModeValue mode) noexcept;
     // Отправить note-on в выбранный трек (для NOTE режима/секвенсора).
     bool triggerTrackNoteOn(uint8_t track, uint8_t note, float velocity01) noexcept;
     // Отправить note-off в выбранный трек.
@@ -97,18 +174,49 @@ public:
     bool addFxToTrack(uint8_t track, std::unique_ptr<IAudioModule> module) noexcept;
     // Удалить FX-модуль из цепочки выбранного трека по индексу (вне RT).
     bool removeFxFromTrack(uint8_t track, uint8_t fxSlot) noexcept;
+    // Добавить FX-модуль в конец цепочки aux-шины (вне RT).
+    bool addFxToAux(uint8_t bus, std::unique_ptr<IAudioModule> module) noexcept;
+    // Установить параметр FX-слота aux-шины (RT-safe через ParamSet команду).
+    bool setAuxFxParam(uint8_t bus, uint8_t fxSlot, uint16_t paramIndex, float normalizedValue) noexcept;
     // Установить параметр FX-слота (RT-safe через ParamSet команду).
     bool setFxParam(uint8_t track, uint8_t fxSlot, uint16_t paramIndex, float normalizedValue) noexcept;
     // Включить/выключить FX-слот без удаления из цепочки.
     bool setFxEnabled(uint8_t track, uint8_t fxSlot, bool enabled) noexcept;
+    // Синхронная загрузка (декодирует в вызывающем потоке): старт приложения, тесты.
     bool loadSampleToTrack(uint8_t track, const std::string& path, std::string& clipNameOut) noexcept;
+    // Асинхронная загрузка в трек: декодирование и детект BPM в ClipLoader, назначение
+    // клипа и профиль — в processPendingSampleLoads(). Новый запрос на тот же трек
+    // отменяет незавершенный; пока грузится, syncUiCache() отдает UiTrackState::Loading.
+    SampleLoadStatus requestSampleToTrack(uint8_t track,
+                                          const std::string& path,
+                                          TrackPlaybackProfileValue profile,
+                                          std::string& clipNameOut) noexcept;
+    bool isTrackLoading(uint8_t track) const noexcept;
+    // Асинхронный аналог preloadClipToPool().
+    bool requestClipPreload(uint32_t clipRefId, const std::string& path) noexcept;
+    // Применить завершенные асинхронные загрузки (control-поток).
+    bool processPendingSampleLoads() noexcept;
     // Предзагрузка WAV в clip-pool по стабильному clipRefId (без назначения треку).
     bool preloadClipToPool(uint32_t clipRefId, const std::string& path, std::string& errorOut) noexcept;
     // Назначить уже preloaded clipRef в слот трека без IO/декодирования.
     bool setTrackClipRef(uint8_t track, uint32_t clipRefId) noexcept;
     // Очистить загруженный сэмпл трека (slot0) без удаления FX-цепочки.
     bool clearTrackSample(uint8_t track) noexcept;
+    // Freeze трека: offline-рендер клипа через текущую FX-цепочку в рабочем потоке.
+    // Готовый буфер кладется в clip-pool и подменяет клип трека в processPendingTrackFreezes(),
+    // живая цепочка после этого не считается. false: пустой слот, Note-режим,
+    // FX без cloneForOffline(), трек уже заморожен или рендерится.
+    bool freezeTrack(uint8_t track) noexcept;
+    // Вернуть исходный клип и живую FX-цепочку (незавершенный рендер отменяется).
+    bool unfreezeTrack(uint8_t track) noexcept;
+    bool isTrackFrozen(uint8_t track) const noexcept;
+    // Применить завершенные freeze-рендеры (control-поток).
+    bool processPendingTrackFreezes() noexcept;
+    // Освободить снапшоты FX-цепочек треков, с которых RT уже ушел (control-поток, периодически).
+    void reclaimRetiredTrackFx() noexcept;
     // Preview-голос (отдельный sample-preview engine, не Track/не Transport).
+    // Файл не из пула декодируется асинхронно и зазвучит после processPendingSampleLoads();
+    // следующий запрос или previewStop() отменяют недогруженный.
     void previewRequest(const std::string& path,
                         float speed,
                         float start01,
@@ -128,6 +236,16 @@ public:
 private:
     // Зафиксировать runtime-state активного паттерна в snapshot manager.
     bool captureActivePatternSnapshot_() noexcept;
+    // Назначить клип пула треку: loop, bars по source BPM, tempo-sync (хвост загрузки сэмпла).
+    bool bindLoadedClip_(uint8_t track, uint32_t clipRefId, const std::string& path) noexcept;
+    // Параметры previewRequest(), отложенные до конца асинхронной загрузки.
+    struct PreviewArgs {
+        float speed{1.0f};
+        float start01{0.0f};
+        float end01{1.0f};
+        float gain01{1.0f};
+    };
+    void playPreview_(uint32_t clipRefId, const PreviewArgs& args) noexcept;
     // PImpl: прячем concrete runtime/platform детали из заголовка.
     struct Impl;
     Impl* impl_{nullptr};
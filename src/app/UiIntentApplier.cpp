@@ -255,6 +255,7 @@ bool UiIntentApplier::buildUndoIntent(const UiIntent& forward,
             return true;
         }
         case UiIntentType::ClearTrackSample:
+        case UiIntentType::SetTrackFrozen:
         case UiIntentType::SnapshotTriggerSlot:
         case UiIntentType::SnapshotCaptureSlot:
         case UiIntentType::SnapshotRecallSlot:
@@ -273,18 +274,24 @@ bool UiIntentApplier::apply(const UiIntent& intent, Context& ctx) const {
                 return false;
             }
             const uint8_t t = clampTrack_(intent.track, ctx.tracks);
+            // После загрузки клипа engine повторно применяет профиль трека,
+            // чтобы mode/loop/policy оставались консистентными.
+            const UiTrackPlaybackProfile profile = profileFromTrackView(ctx.tracks[t]);
             std::string clipName;
-            if (!ctx.engine.loadSampleToTrack(t, intent.path, clipName)) {
+            const SampleLoadStatus status =
+                ctx.engine.requestSampleToTrack(t, intent.path, toEngineProfile(profile), clipName);
+            if (status == SampleLoadStatus::Failed) {
                 return false;
             }
             ctx.tracks[t].clipName = clipName;
             ctx.tracks[t].clipPath = intent.path;
             ctx.tracks[t].muted = false;
-            const UiTrackPlaybackProfile profile = profileFromTrackView(ctx.tracks[t]);
-            // После загрузки клипа повторно применяем профиль трека,
-            // чтобы mode/loop/policy оставались консистентными.
-            (void)ctx.engine.setTrackPlaybackProfile(t, toEngineProfile(profile));
-            refreshTrackViewState_(t, ctx.transport, ctx.tracks);
+            if (status == SampleLoadStatus::Pending) {
+                // Состояние трека обновит syncUiCache(), когда декодирование завершится.
+                ctx.tracks[t].state = UiTrackState::Loading;
+            } else {
+                refreshTrackViewState_(t, ctx.transport, ctx.tracks);
+            }
             ctx.uiStore.setTrack(t, ctx.tracks[t]);
             return true;
         }
@@ -309,6 +316,22 @@ bool UiIntentApplier::apply(const UiIntent& intent, Context& ctx) const {
             ctx.uiStore.setTrack(t, ctx.tracks[t]);
             return true;
         }
+        case UiIntentType::SetTrackFrozen: {
+            if (ctx.tracks.empty()) {
+                return false;
+            }
+            const uint8_t t = clampTrack_(intent.track, ctx.tracks);
+            if (intent.value >= 0.5f) {
+                // Рендер асинхронный: frozen в UI-кэше выставит syncUiCache(), когда буфер подменится.
+                return ctx.engine.freezeTrack(t);
+            }
+            if (!ctx.engine.unfreezeTrack(t)) {
+                return false;
+            }
+            ctx.tracks[t].frozen = false;
+            ctx.uiStore.setTrack(t, ctx.tracks[t]);
+            return true;
+        }
         case UiIntentType::PreviewRequest:
             // Preview и global transport разделены:
             // preview-запрос не переключает transport-состояние.
@@ -0,0 +1,87 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "contracts/types.h"
+
+namespace avantgarde {
+
+/**
+ * Скалярные конверсии компактного хранения клипа (ClipSampleFormat).
+ *
+ * Чтение:
+ *  - Int16: x / 32768 — ровно то же значение, что дает декодер PCM16 WAV,
+ *    поэтому 16-битный источник в Int16 звучит бит-в-бит как во float;
+ *  - Float16: half -> float через сдвиг мантиссы и умножение на 2^112
+ *    (тот же прием, что в векторном ядре ClipResampleKernel.h; inf/NaN не хранятся).
+ *
+ * Запись (вне RT, при загрузке): клампит в [-1..1] и округляет к ближайшему.
+ */
+    inline float clipSampleFromInt16(int16_t v) noexcept {
+        return static_cast<float>(v) * (1.0f / 32768.0f);
+    }
+
+    inline float clipSampleFromHalf(uint16_t h) noexcept {
+        const uint32_t mag = static_cast<uint32_t>(h & 0x7FFFu) << 13;
+        float f = 0.0f;
+        std::memcpy(&f, &mag, sizeof(f));
+        f *= 0x1p112f;
+        uint32_t bits = 0;
+        std::memcpy(&bits, &f, sizeof(bits));
+        bits |= static_cast<uint32_t>(h & 0x8000u) << 16;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    inline int16_t clipSampleToInt16(float x) noexcept {
+        const float scaled = std::nearbyint(std::clamp(x, -1.0f, 1.0f) * 32768.0f);
+        return static_cast<int16_t>(std::clamp(scaled, -32768.0f, 32767.0f));
+    }
+
+    inline uint16_t clipSampleToHalf(float x) noexcept {
+        x = std::clamp(x, -1.0f, 1.0f);
+        uint32_t u = 0;
+        std::memcpy(&u, &x, sizeof(u));
+        const uint16_t sign = static_cast<uint16_t>((u >> 16) & 0x8000u);
+        u &= 0x7FFFFFFFu;
+        float f = 0.0f;
+        std::memcpy(&f, &u, sizeof(f));
+        // Обратный к чтению сдвиг экспоненты; младшие 13 бит округляем к ближайшему четному.
+        f *= 0x1p-112f;
+        std::memcpy(&u, &f, sizeof(u));
+        u += 0x0FFFu + ((u >> 13) & 1u);
+        return static_cast<uint16_t>(sign | static_cast<uint16_t>(u >> 13));
+    }
+
+// Сэмпл канала клипа в любом формате (вне горячих циклов: preview, freeze, тесты).
+    inline float clipSampleAt(const SharedClipBuffer& b, int channel, int frame) noexcept {
+        const int c = (channel == 1 && b.channels == 2) ? 1 : 0;
+        switch (b.format) {
+            case ClipSampleFormat::Int16:
+                return clipSampleFromInt16((c ? b.ch1Packed : b.ch0Packed)[frame]);
+            case ClipSampleFormat::Float16:
+                return clipSampleFromHalf(static_cast<uint16_t>((c ? b.ch1Packed : b.ch0Packed)[frame]));
+            case ClipSampleFormat::Float32:
+                break;
+        }
+        return (c ? b.ch1 : b.ch0)[frame];
+    }
+
+// Разбор CLI-значения формата: "f32" | "s16" | "f16".
+    inline bool parseClipSampleFormat(std::string_view text, ClipSampleFormat& out) noexcept {
+        if (text == "f32") {
+            out = ClipSampleFormat::Float32;
+        } else if (text == "s16") {
+            out = ClipSampleFormat::Int16;
+        } else if (text == "f16") {
+            out = ClipSampleFormat::Float16;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+} // namespace avantgarde
@@ -0,0 +1,146 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "contracts/ClipSampleFormat.h"
+#include "contracts/types.h"
+
+namespace avantgarde {
+
+/**
+ * ClipStretchAnalysis
+ *
+ * Данные клипа для time-stretch режима tempo sync (WSOLA, см. runtime/WsolaStretcher.h).
+ * Считаются один раз вне RT — в нити загрузчика (ClipBufferPool::decodeFile) или при
+ * назначении буфера треку, — поэтому RT-стоимость блока не зависит от содержимого клипа:
+ *  - mono: сумма каналов, усредненная по kDecimation кадров. По ней RT ищет точку
+ *    склейки кросс-корреляцией в kDecimation раз короче, чем по исходнику;
+ *  - onsets: кадры атак (энергия окна kOnsetWindow резко выше нескольких предыдущих).
+ *    Около атаки склейка не ищется: grain продолжает предыдущий, атака не размывается
+ *    и не повторяется при замедлении.
+ *
+ * Память: 4 байта на kDecimation кадров (у stereo float клипа это +1/8).
+ */
+    struct ClipStretchAnalysis {
+        static constexpr int kDecimation = 4;
+        static constexpr int kOnsetWindow = 256;
+        // Атака: энергия окна больше среднего kOnsetHistory предыдущих в kOnsetRatio раз (+6 дБ).
+        static constexpr int kOnsetHistory = 4;
+        static constexpr float kOnsetRatio = 4.0f;
+        // Порог энергии (средний квадрат ~ -50 dBFS): шум тишины атаками не считается.
+        static constexpr float kOnsetFloor = 1e-5f;
+        // Минимальный интервал между атаками, в окнах.
+        static constexpr int kOnsetMinGap = 4;
+
+        int frames{0};
+        std::vector<float> mono{};
+        // Кадры клипа, по возрастанию.
+        std::vector<int32_t> onsets{};
+
+        [[nodiscard]] std::size_t bytes() const noexcept {
+            return mono.size() * sizeof(float) + onsets.size() * sizeof(int32_t);
+        }
+    };
+
+    namespace detail_stretch {
+
+        // load(c, i) — сэмпл канала c (0/1) кадра i во float.
+        template <typename Load>
+        std::shared_ptr<const ClipStretchAnalysis> analyze(int frames, int channels, Load load) {
+            constexpr int kD = ClipStretchAnalysis::kDecimation;
+            constexpr int kWin = ClipStretchAnalysis::kOnsetWindow / kD;
+            if (frames <= 0) {
+                return nullptr;
+            }
+            std::shared_ptr<ClipStretchAnalysis> a{new (std::nothrow) ClipStretchAnalysis{}};
+            if (!a) {
+                return nullptr;
+            }
+            a->frames = frames;
+            const std::size_t n = static_cast<std::size_t>((frames + kD - 1) / kD);
+            try {
+                a->mono.resize(n);
+            } catch (const std::bad_alloc&) {
+                return nullptr;
+            }
+            const float chScale = (channels == 2) ? 0.5f : 1.0f;
+            for (std::size_t j = 0; j < n; ++j) {
+                const int i0 = static_cast<int>(j) * kD;
+                const int i1 = std::min(frames, i0 + kD);
+                float sum = 0.0f;
+                for (int i = i0; i < i1; ++i) {
+                    sum += (channels == 2) ? load(0, i) + load(1, i) : load(0, i);
+                }
+                a->mono[j] = sum * chScale / static_cast<float>(kD);
+            }
+
+            float history[ClipStretchAnalysis::kOnsetHistory] = {};
+            int historyCount = 0;
+            int lastOnsetWindow = -ClipStretchAnalysis::kOnsetMinGap;
+            const int windows = static_cast<int>(n) / kWin;
+            for (int w = 0; w < windows; ++w) {
+                const float* x = a->mono.data() + static_cast<std::size_t>(w) * kWin;
+                float energy = 0.0f;
+                float peak = 0.0f;
+                for (int k = 0; k < kWin; ++k) {
+                    energy += x[k] * x[k];
+                    peak = std::max(peak, x[k] * x[k]);
+                }
+                energy /= static_cast<float>(kWin);
+                float mean = 0.0f;
+                for (int h = 0; h < historyCount; ++h) {
+                    mean += history[h];
+                }
+                mean = (historyCount > 0) ? mean / static_cast<float>(historyCount) : 0.0f;
+                if (energy > ClipStretchAnalysis::kOnsetFloor && energy > ClipStretchAnalysis::kOnsetRatio * mean &&
+                    w - lastOnsetWindow >= ClipStretchAnalysis::kOnsetMinGap) {
+                    // Начало атаки — первый отсчет окна с четвертью пиковой энергии.
+                    int k = 0;
+                    while (k < kWin - 1 && x[k] * x[k] < 0.25f * peak) {
+                        ++k;
+                    }
+                    try {
+                        a->onsets.push_back(static_cast<int32_t>((w * kWin + k) * kD));
+                    } catch (const std::bad_alloc&) {
+                        return nullptr;
+                    }
+                    lastOnsetWindow = w;
+                }
+                std::copy_backward(history, history + ClipStretchAnalysis::kOnsetHistory - 1,
+                                   history + ClipStretchAnalysis::kOnsetHistory);
+                history[0] = energy;
+                historyCount = std::min(historyCount + 1, ClipStretchAnalysis::kOnsetHistory);
+            }
+            return a;
+        }
+
+    } // namespace detail_stretch
+
+    // Анализ planar float каналов (ch1 == nullptr — моно).
+    inline std::shared_ptr<const ClipStretchAnalysis> analyzeClipForStretch(const float* ch0, const float* ch1,
+                                                                            int frames) {
+        if (!ch0) {
+            return nullptr;
+        }
+        const float* c1 = ch1 ? ch1 : ch0;
+        return detail_stretch::analyze(frames, ch1 ? 2 : 1,
+                                       [ch0, c1](int c, int i) { return (c == 0 ? ch0 : c1)[i]; });
+    }
+
+    // То же для клипа, целиком лежащего в памяти (любой ClipSampleFormat). Потоковый — nullptr.
+    inline std::shared_ptr<const ClipStretchAnalysis> analyzeClipForStretch(const SharedClipBuffer& b) {
+        if (!b.valid() || b.stream) {
+            return nullptr;
+        }
+        if (b.format == ClipSampleFormat::Float32) {
+            return analyzeClipForStretch(b.ch0.get(), (b.channels == 2) ? b.ch1.get() : nullptr, b.frames);
+        }
+        return detail_stretch::analyze(b.frames, b.channels,
+                                       [&b](int c, int i) { return clipSampleAt(b, c, i); });
+    }
+
+} // namespace avantgarde
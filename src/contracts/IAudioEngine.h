@@ -4,6 +4,9 @@
 #include "IRtExtension.h"
 #include "IAudioRecorder.h"
 #include "ITransport.h"
+#include "IAudioGraph.h"
+#include "meter_types.h"
+#include "dsp_load_types.h"
 #include "types.h"
 
 /**
@@ -16,6 +19,14 @@
 namespace avantgarde {
 
 
+// Мастер-лимитер: стерео-связанный lookahead, задержка мастера = lookahead - 1 сэмпл.
+    struct MasterLimiterConfig {
+        bool enabled{false};
+        float lookaheadMs{1.5f};
+        float ceiling{0.966f};   // линейный порог (~ -0.3 dBFS)
+        float releaseMs{80.0f};
+    };
+
 // Аудио‑движок управляет треками, RT-командами и обработкой блока.
     struct IAudioEngine {
         virtual ~IAudioEngine() = default;
@@ -49,6 +60,42 @@ namespace avantgarde {
 
         virtual void setNumOutput(uint32_t n) noexcept = 0;
 
+// Параллельный рендер треков: число дополнительных RT-воркеров (0 = последовательно).
+// Вызывать только ВНЕ RT (до старта стрима).
+        virtual bool setRenderWorkers(uint32_t workers) = 0;
+
+// Render-ahead: фоновая нить (ниже приоритетом аудио-нити) рендерит треки, которых никто
+// не трогает (ITrack::canRenderAheadRt), на blocks блоков вперед; processBlock их только
+// микширует. Команда/правка трека возвращает его в RT. 0 = выключено.
+// Вызывать ВНЕ RT (до старта стрима), после регистрации треков.
+        virtual bool setRenderAhead(uint32_t blocks) = 0;
+
+// Маршрутизация треков через DSP-граф (вне RT). Граф компилируется сразу,
+// расписание подменяется на границе блока. nullptr — фиксированная маршрутизация
+// (все треки суммируются в master). false — граф не скомпилирован, текущая схема сохранена.
+        virtual bool setRoutingGraph(const IAudioGraph* graph) = 0;
+
+// Aux return-шины: общие FX-цепочки (reverb/delay) на весь микс (вне RT).
+// Треки посылают в шину ITrack::auxSendLevel(bus) своего выхода, результат цепочки
+// шины суммируется в master. Цепочки публикуются снапшотами — можно менять на ходу.
+        virtual bool setAuxBusCount(uint32_t buses) = 0;   // 0..kMaxAuxBuses
+        virtual bool addAuxModule(uint32_t bus, std::unique_ptr<IAudioModule> module) = 0;
+// Lock-free чтение опубликованной цепочки (resolver ParamBridge зовет его и из RT).
+        virtual IAudioModule* getAuxModule(uint32_t bus, std::size_t index) = 0;
+
+// Мастер-шина: lookahead-лимитер перед выходом/записью. Вызывать ВНЕ RT (до старта стрима):
+// линии задержки выделяются здесь.
+        virtual bool setMasterLimiter(const MasterLimiterConfig& cfg) = 0;
+
+// Метры треков/мастера: RT публикует кадр в конце каждого блока (один писатель).
+// Читатель — один поток (UI); указатель на последний кадр валиден до следующего вызова.
+        virtual const EngineMeterFrame* readMeters() noexcept = 0;
+
+// Профиль DSP-нагрузки: снимок накопленных RT-гистограмм тактов по узлам блока
+// (треки, FX-слоты треков, хуки RT-расширений, aux/мастер-шины). Вызывать вне RT;
+// статистику за окно между двумя снимками считает DspLoadProfiler::buildReport().
+        virtual void captureDspLoad(DspLoadCapture& out) const = 0;
+
     };
 
 } // namespace avantgarde
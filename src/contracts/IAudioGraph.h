@@ -2,7 +2,9 @@
 #define AVANTGARDE_CONTRACTS_IAudioGraph_H
 
 #include <cstdint>
+#include <memory>
 #include "graph_types.h"
+#include "IAudioModule.h"
 
 /**
  * IAudioGraph — контракт управления топологией DSP-графа (вне RT).
@@ -43,6 +45,14 @@ namespace avantgarde {
         virtual void        bumpRevision() noexcept = 0;
         // revision: текущее значение (Engine/кеши могут реагировать на изменение).
         virtual std::uint64_t revision() const noexcept = 0;
+
+        // -------- Привязки узлов к исполнителям (опционально) --------
+        // Топология хранит только форму; что именно "играет" в узле, решает приложение.
+        // Компилятор графа спрашивает привязки при сборке расписания (вне RT).
+        // nodeTrackIndex: индекс трека движка для узла-источника.
+        virtual bool nodeTrackIndex(NodeId /*id*/, std::uint32_t& /*outIndex*/) const noexcept { return false; }
+        // nodeModule: DSP-модуль узла (уже init()), владение разделяется с расписанием.
+        virtual std::shared_ptr<IAudioModule> nodeModule(NodeId /*id*/) const noexcept { return nullptr; }
     };
 
 } // namespace avantgarde
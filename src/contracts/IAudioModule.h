@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include "IParameterized.h"
 
 
@@ -12,7 +13,50 @@ namespace avantgarde {
         virtual ~IAudioModule() = default;
         virtual void init(double sampleRate, std::size_t maxFrames) = 0; // вне RT
         virtual void process(const AudioProcessContext& ctx) = 0; // RT, no‑throw
-        virtual void reset() = 0; // сброс внутренних состояний
+        // Сброс внутренних состояний. Без аллокаций: только чистит то, что выделил init(),
+        // поэтому трек вправе звать его из RT на границе блока. Многосекундные буферы модуль
+        // может дочищать в следующих process() — выход при этом как после полной очистки.
+        virtual void reset() = 0;
+
+        // Хвост: сколько кадров после последнего неслышного (< kSilenceLevel) входа выход
+        // модуля еще может быть слышен. Хост вправе не вызывать process(), пока вход тих
+        // дольше хвоста. RT-safe, читается после beginBlock(). kInfiniteTailFrames — модуль
+        // генерирует звук сам или оценка неизвестна: пропускать нельзя.
+        static constexpr uint32_t kInfiniteTailFrames = 0xFFFFFFFFu;
+        static constexpr float kSilenceLevel = 1e-6f; // ~ -120 dBFS
+        virtual uint32_t tailFrames() const noexcept { return kInfiniteTailFrames; }
+
+        // Хвост одно-полюсного контура y = pole * y + ...: кадров, пока состояние затухает
+        // ниже kSilenceLevel с запасом x4 на выброс при ступеньке. constexpr — модули
+        // выводят из своих коэффициентов константы хвоста; pole >= 1 не затухает.
+        static constexpr uint32_t onePoleTailFrames(float pole) noexcept {
+            if (!(pole > 0.0f)) return 0;
+            if (pole >= 1.0f) return kInfiniteTailFrames;
+            uint32_t frames = 0;
+            for (double g = 1.0; g > kSilenceLevel / 4.0; g *= pole) {
+                ++frames;
+            }
+            return frames;
+        }
+
+        // Независимая копия для offline-рендера (freeze трека): тот же тип и текущие
+        // параметры, уже прошедшая init(sampleRate, maxFrames), но без DSP-состояния
+        // оригинала. Вне RT; оригинал при этом может продолжать работать в RT.
+        // nullptr — модуль не умеет клонироваться.
+        virtual std::unique_ptr<IAudioModule> cloneForOffline(double /*sampleRate*/,
+                                                              std::size_t /*maxFrames*/) const {
+            return nullptr;
+        }
+
+    protected:
+        // Перенести значения параметров в копию и применить их (для cloneForOffline()).
+        void copyParamsTo_(IAudioModule& dst) const {
+            const std::size_t n = getParamCount();
+            for (std::size_t i = 0; i < n; ++i) {
+                dst.setParam(i, getParam(i));
+            }
+            dst.beginBlock();
+        }
     };
 
 
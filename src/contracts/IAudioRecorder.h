@@ -18,7 +18,7 @@ namespace avantgarde {
     struct IRtRecordSink {
         virtual ~IRtRecordSink() = default;
 
-        // Пишем один блок неинтерливнутых каналов: [channels][nframes]
+        // Пишем один блок неинтерливнутых каналов: [channels][nframes]; ch[c] == nullptr — тишина.
         // Возвращает false если внутренний кольцевой буфер переполнен (дроп кадра допустим).
         virtual bool writeBlock(const float* const* ch, int nframes) noexcept = 0;
 
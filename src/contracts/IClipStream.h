@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+namespace avantgarde {
+
+/**
+ * IClipStream
+ *
+ * Потоковый источник длинного клипа (см. SharedClipBuffer::stream).
+ * Первые streamHeadFrames кадров всегда в памяти (SharedClipBuffer::ch0/ch1),
+ * остальное I/O-нить подкачивает впереди playhead в lock-free кольца читателей.
+ *
+ * Читатель — один playhead (трек в Looper-режиме, голос note-режима): у каждого
+ * свое кольцо, поэтому голоса в разных местах клипа друг другу не мешают.
+ *
+ * ВАЖНО:
+ *  - openReaders()/closeReaders() — только вне RT;
+ *  - *Rt() — из нити, которая рендерит владельца читателя, без блокировок и аллокаций;
+ *  - нет данных к моменту чтения — тишина и +1 к underruns(), RT никогда не ждет диск.
+ */
+    struct IClipStream {
+        // Верхняя граница читателей одного потока (все треки, которым он назначен).
+        static constexpr uint32_t kMaxReaders = 256;
+
+        virtual ~IClipStream() = default;
+
+        // Зарезервировать count подряд идущих читателей. Возвращает индекс первого, -1 — нет места.
+        virtual int openReaders(uint32_t count) = 0;
+        virtual void closeReaders(int first, uint32_t count) noexcept = 0;
+
+        // Регион воспроизведения читателя в кадрах клипа: кольцо держится внутри него,
+        // а его начало подкачивается заранее (wrap лупа, retrigger), даже если оно вне головы.
+        virtual void setRegionRt(int reader, int64_t regionStart, int64_t regionEnd, bool loop) noexcept = 0;
+        // Скопировать кадры [frame, frame + count) в dst0/dst1 (dst1 == nullptr — только канал 0).
+        // false — часть кадров не успела подкачаться (в dst там нули).
+        // count = 0 — только сдвинуть курсор читателя (muted playhead тоже идет вперед).
+        virtual bool readRt(int reader, int64_t frame, uint32_t count, float* dst0, float* dst1) noexcept = 0;
+
+        // Сколько раз RT не нашел нужных кадров (все читатели, с момента открытия).
+        virtual uint64_t underruns() const noexcept = 0;
+    };
+
+} // namespace avantgarde
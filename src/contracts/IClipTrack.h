@@ -1,10 +1,46 @@
 #pragma once
 #include "ITrack.h"
+#include "IAudioModule.h"
+#include "IAudioRecorder.h"
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 namespace avantgarde {
 
+/**
+ * TrackFreezeJob
+ *
+ * Снимок трека для freeze (см. IClipTrack::captureFreezeJob()): исходный клип,
+ * playback-регион, скорость и независимые копии включенных FX.
+ * Задание владеет всеми своими данными, поэтому рендер можно вести в рабочем
+ * потоке, пока сам трек продолжает играть в RT.
+ */
+    struct TrackFreezeJob {
+        SharedClipBuffer source{};
+        // Playback-регион в кадрах исходного клипа.
+        double regionStart{0.0};
+        double regionEnd{0.0};
+        // Пользовательский speed (без компенсации sample rate клипа).
+        double playbackInc{1.0};
+        bool loop{false};
+        double outputSampleRate{48000.0};
+        // Transport, который увидят tempo-sync FX при offline-рендере.
+        // captureFreezeJob() их не заполняет: это делает вызывающий (control-поток).
+        float bpm{120.0f};
+        uint8_t tsNum{4};
+        uint8_t tsDen{4};
+        // Копии включенных FX в порядке цепочки (IAudioModule::cloneForOffline()).
+        std::vector<std::unique_ptr<IAudioModule>> fx{};
+        // Поколения клипа и FX-цепочки трека на момент снимка.
+        uint64_t clipGeneration{0};
+        uint64_t fxChainGeneration{0};
+        // Выставляется владельцем задания, чтобы прервать рендер.
+        std::atomic<bool> cancel{false};
+    };
+
 /**
  * IClipTrack
  *
@@ -150,6 +186,24 @@ namespace avantgarde {
          */
         virtual bool setSlotLooping(uint32_t slot, bool loop) = 0;
 
+        /**
+         * Настраивает полифонию note-режима.
+         *
+         * voices = 1 → монофонический режим (один playhead, retrigger по NoteOn);
+         * voices > 1 → каждый NoteOn получает свой голос из предвыделенного пула,
+         *              при нехватке голосов один из них крадется по политике steal.
+         *
+         * RT:
+         *  - Только вне RT. Применяется на границе следующего блока,
+         *    звучащие голоса при этом гасятся.
+         *
+         * @param voices число голосов [1 .. реализационный максимум]
+         * @param steal  политика кражи голоса
+         *
+         * @return true если значение принято
+         */
+        virtual bool setNotePolyphony(uint8_t voices, VoiceStealPolicyValue steal) = 0;
+
         /**
          * Удаляет FX-модуль из цепочки трека по индексу.
          *
@@ -162,6 +216,46 @@ namespace avantgarde {
          */
         virtual bool removeModuleAt(std::size_t index) = 0;
 
+        /**
+         * Освобождает снапшоты FX-цепочки (и удаленные модули), с которых RT уже ушел.
+         *
+         * Правки цепочки подчищают их и сами, но без следующей правки удаленный
+         * модуль жил бы до конца трека — поэтому control-поток зовет это периодически.
+         *
+         * RT:
+         *  - Только вне RT; без аллокаций, дешево при пустом retire-списке.
+         */
+        virtual void reclaimRetiredFx() = 0;
+
+        /**
+         * Политика FX-цепочки при смене клипа в слоте (loadSlotFrom*, pattern switch).
+         *
+         * on = false (по умолчанию) → состояние и хвосты FX переживают смену клипа;
+         * on = true                 → модули сбрасываются (IAudioModule::reset()) в RT,
+         *                             в первом блоке с новым клипом.
+         *
+         * Ни в одном режиме смена клипа не вызывает init() и не перевыделяет буферы FX.
+         * Freeze/unfreeze этой политикой не затрагиваются.
+         *
+         * RT:
+         *  - Только вне RT.
+         */
+        virtual void setFxResetOnClipSwap(bool on) noexcept = 0;
+
+        /**
+         * Запись стема: post-FX выход трека (то, что трек прибавляет к ctx.out).
+         *
+         * Поведение:
+         *  - каждый process() отдает в sink ровно ctx.nframes кадров stereo: куски
+         *    без звука (mute, gate закрыт, тихий хвост) — writeBlock() с nullptr
+         *    каналами, поэтому стемы разных треков совпадают покадрово;
+         *  - с подключенным sink трек не пропускается как idle и не уходит в render-ahead.
+         *
+         * RT:
+         *  - Только вне RT; sink должен жить, пока подключен (nullptr — отключить).
+         */
+        virtual void setStemSink(IRtRecordSink* sink) noexcept = 0;
+
         // Project-level clipRef (stable id для snapshot/pattern switch).
         // Это metadata-уровень, не DSP audio data.
         virtual void setClipRefId(uint32_t clipRefId) noexcept = 0;
@@ -169,6 +263,48 @@ namespace avantgarde {
         // Control-only mirror параметров для snapshot/UI.
         // Не должен менять RT playback-state напрямую.
         virtual void mirrorParamForSnapshot(uint16_t paramIndex, float value) noexcept = 0;
+
+        /**
+         * Freeze: снимок трека для offline-рендера через его FX-цепочку.
+         *
+         * Поведение:
+         *  - захватывает текущий клип, регион, speed/loop и клонирует включенные FX;
+         *  - bpm/tsNum/tsDen задания не трогает: их задает вызывающий;
+         *  - трек при этом не меняется.
+         *
+         * Ограничения:
+         *  - только Looper-режим, только если все включенные FX умеют cloneForOffline();
+         *  - false, если трек уже заморожен или слот пуст.
+         */
+        virtual bool captureFreezeJob(TrackFreezeJob& job) = 0;
+
+        /**
+         * Рендер задания в новый буфер (sampleRate = output rate трека).
+         *
+         * loop=true  → ровно один проход региона, с хвостами FX, завернутыми с конца
+         *              лупа в начало (как в установившемся зацикленном воспроизведении);
+         * loop=false → регион + хвост FX до тишины.
+         *
+         * Трогает только данные задания: можно звать из любого потока.
+         * false при ошибке или отмене (job.cancel).
+         */
+        virtual bool renderFreezeJob(TrackFreezeJob& job, SharedClipBuffer& out) const = 0;
+
+        /**
+         * Переключить playback на замороженный буфер: FX-цепочка и speed/trim
+         * в RT обходятся, gain/mute/посылы остаются живыми. Фаза воспроизведения
+         * сохраняется.
+         *
+         * false, если с момента captureFreezeJob() трек сменил клип или FX-цепочку.
+         */
+        virtual bool applyFreeze(const TrackFreezeJob& job, const SharedClipBuffer& frozen) = 0;
+
+        /**
+         * Вернуть исходный клип и живую FX-цепочку.
+         * Любая загрузка/очистка слота снимает freeze сама.
+         */
+        virtual bool unfreeze() = 0;
+        virtual bool isFrozen() const noexcept = 0;
     };
 
 } // namespace avantgarde
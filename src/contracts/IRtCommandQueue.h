@@ -32,7 +32,11 @@ namespace avantgarde {
 // ---------------------------------------------------------------------------
 //
 // Общий формат:
-//   RtCommand { id, track, slot, index, value }
+//   RtCommand { id, track, slot, index, value, frameInBlock }
+//
+//   frameInBlock — смещение внутри текущего аудио-блока (сэмплы). Команды,
+//   выпущенные RT-планировщиком в onBlockBegin, несут точный момент события;
+//   трек применяет их на этом сэмпле, разрезая рендер блока. 0 = начало блока.
 //
 // 1) Continue
 //   - Глобальная команда транспорта; track = -1, slot = -1; index/value игнорируются.
@@ -19,6 +19,7 @@ struct TrackSnapshot {
     TrackPlaybackModeValue playbackMode{TrackPlaybackModeValue::Looper};
     bool loopEnabled{true};
     bool tempoSync{true};
+    TempoSyncModeValue tempoSyncMode{TempoSyncModeValue::Varispeed};
     float trimStart01{0.0f};
     float trimEnd01{1.0f};
 };
@@ -26,6 +26,30 @@ namespace avantgarde {
         virtual void process(const AudioProcessContext& ctx) = 0; // RT‑safe
         // NEW: узкое RT-API для адресных команд (ParamSet, NoteOn/Off, ClipTrigger и т.п.)
         virtual void onRtCommand(const RtCommand& cmd) noexcept = 0;   // RT-safe, без аллокаций
+        // Уровень посыла выхода трека в aux-шину движка (RT-чтение после process()).
+        // 0 — трек в шину не посылает.
+        virtual float auxSendLevel(uint32_t /*bus*/) const noexcept { return 0.0f; }
+        // Такты счетчика профайлера, потраченные каждым FX-слотом в последнем process()
+        // (RT-чтение после process()). Возвращает число заполненных слотов; 0 — трек
+        // не профилирует свои FX и учитывается профайлером движка только целиком.
+        virtual uint32_t fxLoadTicks(uint64_t* /*out*/, uint32_t /*maxSlots*/) const noexcept { return 0; }
+        // RT, после drain команд блока и до process(): true — трек в этом блоке ничего не
+        // выдаст (нет клипа/gate закрыт, отложенных команд нет), и движок вправе не вызывать
+        // process(). false — по умолчанию: трек рендерится всегда.
+        virtual bool isIdleRt() noexcept { return false; }
+
+        // Render-ahead (IAudioEngine::setRenderAhead): движок может отдать трек фоновой нити,
+        // которая зовет process() на несколько блоков вперед, пока трек никто не трогает.
+        // RT, после process() блока: true — ближайшие блоки трека зависят только от
+        // transport-времени (нет отложенных команд, нот, записи). false по умолчанию.
+        virtual bool canRenderAheadRt() noexcept { return false; }
+        // Счетчик изменений трека, опубликованных вне RT (клип, FX-цепочка, loop...).
+        // Читается аудио-нитью, пока трек у воркера: любое изменение возвращает его в RT.
+        virtual uint64_t controlEpoch() const noexcept { return 0; }
+        // Позиция воспроизведения перед очередным блоком, отрендеренным заранее, и откат
+        // к ней, когда движок забирает трек с неотыгранными блоками (RT того, кто владеет треком).
+        virtual double renderPositionRt() const noexcept { return 0.0; }
+        virtual void seekRenderPositionRt(double /*position*/) noexcept {}
 
         // По умолчанию "чистый" трек может не экспонировать параметры.
         // ClipTrack/другие parameterized-track реализации должны это переопределять.
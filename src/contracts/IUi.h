@@ -7,6 +7,7 @@
 #include "ITransport.h"
 #include "IPattern.h"
 #include "ISequencer.h"
+#include "dsp_load_types.h"
 
 namespace avantgarde {
 
@@ -14,7 +15,8 @@ enum class UiTrackState : uint8_t {
     Empty = 0,
     Stopped,
     Playing,
-    Recording
+    Recording,
+    Loading // сэмпл декодируется асинхронно
 };
 
 // Упрощенный playback-режим трека для UI.
@@ -86,6 +88,8 @@ struct UiTrackStateView {
     // true: скорость трека темпо-синхронизирована с project BPM/TS (stretch-to-bars).
     // false: скорость трека ручная и не пересчитывается от BPM.
     bool tempoSync{true};
+    // true: трек заморожен (играет offline-рендер с FX, живая цепочка не считается).
+    bool frozen{false};
     uint8_t fxCount{0};
     // Канонические ID FX по слотам (слот 0 -> fxChainIds[0] и т.д.).
     // UI использует это для именования списка FX и подбора профиля параметров в редакторе.
@@ -93,6 +97,9 @@ struct UiTrackStateView {
     // Состояние FX-слотов: 1 = enabled, 0 = bypass.
     // Индекс совпадает с fxChainIds/слотом.
     std::vector<uint8_t> fxEnabled{};
+    // Метр выхода трека за последний блок (линейные peak/RMS).
+    float meterPeak{0.0f};
+    float meterRms{0.0f};
     std::string clipName;
     // Абсолютный/рабочий путь к загруженному сэмплу (для сервисов анализа).
     std::string clipPath;
@@ -102,6 +109,18 @@ struct UiTelemetryState {
     uint64_t totalCallbacks{0};
     uint64_t xruns{0};
     bool rtQueueOverflow{false};
+    // Метры мастера (линейные, после лимитера) и минимальный gain лимитера за блок.
+    float masterPeak[2]{0.0f, 0.0f};
+    float masterRms[2]{0.0f, 0.0f};
+    float limiterGain{1.0f};
+    // DSP-нагрузка блока за последнее окно профайлера (% длительности блока)
+    // и самый тяжелый узел по p99 (трек / FX-слот / RT-расширение / шина).
+    float dspLoadPct{0.0f};
+    float dspLoadP99Pct{0.0f};
+    DspLoadSiteKind dspTopKind{DspLoadSiteKind::Block};
+    uint16_t dspTopOwner{0};
+    uint16_t dspTopSlot{0};
+    float dspTopP99Pct{0.0f};
 };
 
 // Runtime-состояние pattern-подсистемы для UI.
@@ -93,6 +93,7 @@ struct UiAction {
         SceneTrackMenuSampleEdit,
         SceneTrackMenuSequencer,
         SceneTrackMenuPatternEdit,
+        SceneTrackMenuFreeze,
         SceneSampleMenuPreview,
         SceneSampleMenuLoadSample,
         SceneSampleMenuDetectBpm,
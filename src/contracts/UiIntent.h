@@ -33,6 +33,8 @@ enum class UiIntentType : uint8_t {
     LoadSampleToTrack,
     // Очистить загруженный сэмпл в выбранном треке (slot0).
     ClearTrackSample,
+    // Freeze/unfreeze трека (value: 1.0=freeze, 0.0=unfreeze).
+    SetTrackFrozen,
     // Добавить эффект в цепочку трека.
     AddFxToTrack,
     // Удалить эффект из цепочки трека.
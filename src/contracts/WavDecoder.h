@@ -0,0 +1,602 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AVANTGARDE_WAV_PCM_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AVANTGARDE_WAV_PCM_NEON 1
+#endif
+
+namespace avantgarde {
+
+/**
+ * Единый WAV-декодер всех загрузчиков: пул клипов, ClipTrack::loadSlotFromFile,
+ * потоковые клипы, детектор BPM и waveform в UI.
+ *
+ * Контейнеры: RIFF/WAVE и RF64/BW64 (размер data берется из ds64);
+ * WAVE_FORMAT_EXTENSIBLE — реальный формат из SubFormat GUID.
+ * Форматы: PCM16/PCM24/PCM32 и float32, 1–2 канала.
+ *
+ * data chunk читается кусками по kChunkFrames кадров прямо в planar-буферы
+ * назначения: сырые байты всего файла в памяти не держатся. Деинтерливинг
+ * и конверсия в float векторные (SSE2/NEON; PCM24 на NEON скалярный).
+ * Масштабы — степени двойки, поэтому векторный и скалярный пути дают
+ * бит-в-бит одно и то же.
+ *
+ * Header-only: нужен и runtime (ClipTrack), и service. Только вне RT.
+ * Предполагается little-endian хост (x86, ARM).
+ */
+    namespace wav_pcm {
+
+        constexpr float kScale16 = 1.0f / 32768.0f;
+        constexpr float kScale24 = 1.0f / 8388608.0f;
+        constexpr float kScale32 = 1.0f / 2147483648.0f;
+
+        inline float loadPcm16(const uint8_t* p) noexcept {
+            int16_t v = 0;
+            std::memcpy(&v, p, sizeof(v));
+            return static_cast<float>(v) * kScale16;
+        }
+
+        inline float loadPcm24(const uint8_t* p) noexcept {
+            const uint32_t u = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                               (static_cast<uint32_t>(p[2]) << 16);
+            return static_cast<float>(static_cast<int32_t>(u << 8) >> 8) * kScale24;
+        }
+
+        inline float loadPcm32(const uint8_t* p) noexcept {
+            int32_t v = 0;
+            std::memcpy(&v, p, sizeof(v));
+            return static_cast<float>(v) * kScale32;
+        }
+
+        inline float loadFloat32(const uint8_t* p) noexcept {
+            float v = 0.0f;
+            std::memcpy(&v, p, sizeof(v));
+            return std::clamp(v, -1.0f, 1.0f);
+        }
+
+        // Скалярный деинтерливинг с произвольным шагом кадра (хвосты и нестандартный blockAlign).
+        template <typename Load>
+        inline void deinterleaveScalar(const uint8_t* src, uint32_t n, uint32_t stride, uint32_t sampleBytes,
+                                       float* d0, float* d1, Load load) noexcept {
+            for (uint32_t i = 0; i < n; ++i, src += stride) {
+                d0[i] = load(src);
+                if (d1) {
+                    d1[i] = load(src + sampleBytes);
+                }
+            }
+        }
+
+        // Ниже: плотно упакованный интерлив (blockAlign == channels * sampleBytes).
+        // d1 == nullptr — моно. Возвращают число обработанных кадров; хвост добивает вызывающий.
+
+        inline uint32_t pcm16Packed(const uint8_t* src, uint32_t n, float* d0, float* d1) noexcept {
+            uint32_t i = 0;
+#if defined(AVANTGARDE_WAV_PCM_SSE2)
+            const __m128 k = _mm_set1_ps(kScale16);
+            if (!d1) {
+                for (; i + 8 <= n; i += 8) {
+                    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2u * i));
+                    const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+                    const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+                    _mm_storeu_ps(d0 + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), k));
+                    _mm_storeu_ps(d0 + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), k));
+                }
+            } else {
+                for (; i + 4 <= n; i += 4) {
+                    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4u * i));
+                    const __m128i l = _mm_srai_epi32(_mm_slli_epi32(x, 16), 16);
+                    const __m128i r = _mm_srai_epi32(x, 16);
+                    _mm_storeu_ps(d0 + i, _mm_mul_ps(_mm_cvtepi32_ps(l), k));
+                    _mm_storeu_ps(d1 + i, _mm_mul_ps(_mm_cvtepi32_ps(r), k));
+                }
+            }
+#elif defined(AVANTGARDE_WAV_PCM_NEON)
+            if (!d1) {
+                for (; i + 8 <= n; i += 8) {
+                    const int16x8_t x = vld1q_s16(reinterpret_cast<const int16_t*>(src + 2u * i));
+                    vst1q_f32(d0 + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), kScale16));
+                    vst1q_f32(d0 + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), kScale16));
+                }
+            } else {
+                for (; i + 4 <= n; i += 4) {
+                    const int16x4x2_t x = vld2_s16(reinterpret_cast<const int16_t*>(src + 4u * i));
+                    vst1q_f32(d0 + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(x.val[0])), kScale16));
+                    vst1q_f32(d1 + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(x.val[1])), kScale16));
+                }
+            }
+#else
+            (void)src;
+            (void)n;
+            (void)d0;
+            (void)d1;
+#endif
+            return i;
+        }
+
+        // Читает до 1 байта за концом данных: буфер источника дополнен kReadPad.
+        inline uint32_t pcm24Packed(const uint8_t* src, uint32_t n, float* d0, float* d1) noexcept {
+            uint32_t i = 0;
+#if defined(AVANTGARDE_WAV_PCM_SSE2)
+            const __m128 k = _mm_set1_ps(kScale24);
+            auto at = [](const uint8_t* p) noexcept {
+                int32_t v = 0;
+                std::memcpy(&v, p, sizeof(v));
+                return v;
+            };
+            // 24-битное значение в младших байтах: сдвиг влево и арифметический вправо расширяет знак.
+            auto widen = [&k](__m128i v) noexcept {
+                return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(v, 8), 8)), k);
+            };
+            if (!d1) {
+                for (; i + 4 <= n; i += 4) {
+                    const uint8_t* p = src + 3u * i;
+                    _mm_storeu_ps(d0 + i, widen(_mm_set_epi32(at(p + 9), at(p + 6), at(p + 3), at(p))));
+                }
+            } else {
+                for (; i + 4 <= n; i += 4) {
+                    const uint8_t* p = src + 6u * i;
+                    _mm_storeu_ps(d0 + i, widen(_mm_set_epi32(at(p + 18), at(p + 12), at(p + 6), at(p))));
+                    _mm_storeu_ps(d1 + i, widen(_mm_set_epi32(at(p + 21), at(p + 15), at(p + 9), at(p + 3))));
+                }
+            }
+#else
+            (void)src;
+            (void)n;
+            (void)d0;
+            (void)d1;
+#endif
+            return i;
+        }
+
+        inline uint32_t pcm32Packed(const uint8_t* src, uint32_t n, float* d0, float* d1) noexcept {
+            uint32_t i = 0;
+#if defined(AVANTGARDE_WAV_PCM_SSE2)
+            const __m128 k = _mm_set1_ps(kScale32);
+            if (!d1) {
+                for (; i + 4 <= n; i += 4) {
+                    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4u * i));
+                    _mm_storeu_ps(d0 + i, _mm_mul_ps(_mm_cvtepi32_ps(x), k));
+                }
+            } else {
+                for (; i + 4 <= n; i += 4) {
+                    // Тасуем int32 как float: перестановка бит не меняет.
+                    const __m128 a = _mm_loadu_ps(reinterpret_cast<const float*>(src + 8u * i));
+                    const __m128 b = _mm_loadu_ps(reinterpret_cast<const float*>(src + 8u * i + 16u));
+                    const __m128i l = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+                    const __m128i r = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+                    _mm_storeu_ps(d0 + i, _mm_mul_ps(_mm_cvtepi32_ps(l), k));
+                    _mm_storeu_ps(d1 + i, _mm_mul_ps(_mm_cvtepi32_ps(r), k));
+                }
+            }
+#elif defined(AVANTGARDE_WAV_PCM_NEON)
+            if (!d1) {
+                for (; i + 4 <= n; i += 4) {
+                    const int32x4_t x = vld1q_s32(reinterpret_cast<const int32_t*>(src + 4u * i));
+                    vst1q_f32(d0 + i, vmulq_n_f32(vcvtq_f32_s32(x), kScale32));
+                }
+            } else {
+                for (; i + 4 <= n; i += 4) {
+                    const int32x4x2_t x = vld2q_s32(reinterpret_cast<const int32_t*>(src + 8u * i));
+                    vst1q_f32(d0 + i, vmulq_n_f32(vcvtq_f32_s32(x.val[0]), kScale32));
+                    vst1q_f32(d1 + i, vmulq_n_f32(vcvtq_f32_s32(x.val[1]), kScale32));
+                }
+            }
+#else
+            (void)src;
+            (void)n;
+            (void)d0;
+            (void)d1;
+#endif
+            return i;
+        }
+
+        inline uint32_t float32Packed(const uint8_t* src, uint32_t n, float* d0, float* d1) noexcept {
+            uint32_t i = 0;
+#if defined(AVANTGARDE_WAV_PCM_SSE2)
+            const __m128 lo = _mm_set1_ps(-1.0f);
+            const __m128 hi = _mm_set1_ps(1.0f);
+            if (!d1) {
+                for (; i + 4 <= n; i += 4) {
+                    const __m128 x = _mm_loadu_ps(reinterpret_cast<const float*>(src + 4u * i));
+                    _mm_storeu_ps(d0 + i, _mm_min_ps(_mm_max_ps(x, lo), hi));
+                }
+            } else {
+                for (; i + 4 <= n; i += 4) {
+                    const __m128 a = _mm_loadu_ps(reinterpret_cast<const float*>(src + 8u * i));
+                    const __m128 b = _mm_loadu_ps(reinterpret_cast<const float*>(src + 8u * i + 16u));
+                    const __m128 l = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                    const __m128 r = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                    _mm_storeu_ps(d0 + i, _mm_min_ps(_mm_max_ps(l, lo), hi));
+                    _mm_storeu_ps(d1 + i, _mm_min_ps(_mm_max_ps(r, lo), hi));
+                }
+            }
+#elif defined(AVANTGARDE_WAV_PCM_NEON)
+            const float32x4_t lo = vdupq_n_f32(-1.0f);
+            const float32x4_t hi = vdupq_n_f32(1.0f);
+            if (!d1) {
+                for (; i + 4 <= n; i += 4) {
+                    const float32x4_t x = vld1q_f32(reinterpret_cast<const float*>(src + 4u * i));
+                    vst1q_f32(d0 + i, vminq_f32(vmaxq_f32(x, lo), hi));
+                }
+            } else {
+                for (; i + 4 <= n; i += 4) {
+                    const float32x4x2_t x = vld2q_f32(reinterpret_cast<const float*>(src + 8u * i));
+                    vst1q_f32(d0 + i, vminq_f32(vmaxq_f32(x.val[0], lo), hi));
+                    vst1q_f32(d1 + i, vminq_f32(vmaxq_f32(x.val[1], lo), hi));
+                }
+            }
+#else
+            (void)src;
+            (void)n;
+            (void)d0;
+            (void)d1;
+#endif
+            return i;
+        }
+
+        // Запас в конце буфера сырых байт под 4-байтную загрузку последнего PCM24-сэмпла.
+        constexpr std::size_t kReadPad = 4;
+
+    } // namespace wav_pcm
+
+    class WavDecoder {
+    public:
+        enum class Encoding : uint8_t {
+            Pcm16 = 0,
+            Pcm24,
+            Pcm32,
+            Float32
+        };
+
+        // Кадров за одно чтение в readAll(): ~128 KiB сырых байт для stereo float.
+        static constexpr uint32_t kChunkFrames = 16384;
+
+        bool open(const std::string& path, std::string* errorOut = nullptr) {
+            close();
+            file_.open(path, std::ios::binary);
+            if (!file_.is_open()) {
+                return fail_(errorOut, "cannot open file");
+            }
+
+            uint8_t riff[12];
+            if (!file_.read(reinterpret_cast<char*>(riff), 12)) {
+                return fail_(errorOut, "bad riff header");
+            }
+            rf64_ = std::memcmp(riff, "RF64", 4) == 0 || std::memcmp(riff, "BW64", 4) == 0;
+            if ((!rf64_ && std::memcmp(riff, "RIFF", 4) != 0) || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+                return fail_(errorOut, "not RIFF/WAVE");
+            }
+
+            bool haveFmt = false;
+            uint16_t audioFormat = 0;
+            uint16_t bitsPerSample = 0;
+            uint64_t ds64DataBytes = 0;
+            uint64_t dataBytes = 0;
+            while (true) {
+                uint8_t chdr[8];
+                if (!file_.read(reinterpret_cast<char*>(chdr), 8)) {
+                    return fail_(errorOut, "missing fmt/data chunk");
+                }
+                const uint32_t csize = u32_(chdr + 4);
+                if (std::memcmp(chdr, "ds64", 4) == 0) {
+                    // RF64: 64-битные размеры RIFF и data; в заголовках самих чанков 0xFFFFFFFF.
+                    if (csize < 24) {
+                        return fail_(errorOut, "invalid ds64 chunk size");
+                    }
+                    std::vector<uint8_t> buf(csize);
+                    if (!file_.read(reinterpret_cast<char*>(buf.data()), csize)) {
+                        return fail_(errorOut, "cannot read ds64 chunk");
+                    }
+                    ds64DataBytes = u64_(buf.data() + 8);
+                } else if (std::memcmp(chdr, "fmt ", 4) == 0) {
+                    if (csize < 16) {
+                        return fail_(errorOut, "invalid fmt chunk size");
+                    }
+                    std::vector<uint8_t> buf(csize);
+                    if (!file_.read(reinterpret_cast<char*>(buf.data()), csize)) {
+                        return fail_(errorOut, "cannot read fmt chunk");
+                    }
+                    audioFormat = u16_(buf.data() + 0);
+                    channels_ = u16_(buf.data() + 2);
+                    sampleRate_ = static_cast<int>(u32_(buf.data() + 4));
+                    blockAlign_ = u16_(buf.data() + 12);
+                    bitsPerSample = u16_(buf.data() + 14);
+                    if (audioFormat == kFormatExtensible) {
+                        // cbSize(2) validBits(2) channelMask(4) SubFormat(16): первые 2 байта GUID — формат.
+                        if (csize < 40) {
+                            return fail_(errorOut, "invalid extensible fmt chunk");
+                        }
+                        audioFormat = u16_(buf.data() + 24);
+                    }
+                    haveFmt = true;
+                } else if (std::memcmp(chdr, "data", 4) == 0) {
+                    dataOffset_ = static_cast<uint64_t>(file_.tellg());
+                    dataBytes = (rf64_ && csize == 0xFFFFFFFFu) ? ds64DataBytes : csize;
+                    break;
+                } else {
+                    file_.seekg(static_cast<std::streamoff>(csize), std::ios::cur);
+                }
+                if (csize & 1u) {
+                    file_.seekg(1, std::ios::cur);
+                }
+                if (!file_.good()) {
+                    return fail_(errorOut, "cannot skip unknown chunk");
+                }
+            }
+
+            if (!haveFmt) {
+                return fail_(errorOut, "missing fmt/data chunk");
+            }
+            if (audioFormat == 1 && bitsPerSample == 16) {
+                encoding_ = Encoding::Pcm16;
+            } else if (audioFormat == 1 && bitsPerSample == 24) {
+                encoding_ = Encoding::Pcm24;
+            } else if (audioFormat == 1 && bitsPerSample == 32) {
+                encoding_ = Encoding::Pcm32;
+            } else if (audioFormat == 3 && bitsPerSample == 32) {
+                encoding_ = Encoding::Float32;
+            } else {
+                return fail_(errorOut, "unsupported wav format");
+            }
+            if (channels_ != 1 && channels_ != 2) {
+                return fail_(errorOut, "unsupported channel count");
+            }
+            sampleBytes_ = bitsPerSample / 8u;
+            if (blockAlign_ < static_cast<uint32_t>(channels_) * sampleBytes_ || sampleRate_ <= 0) {
+                return fail_(errorOut, "invalid blockAlign");
+            }
+            // Data chunk мог быть обрезан при записи: верим размеру файла, а не заголовку.
+            file_.seekg(0, std::ios::end);
+            const uint64_t fileBytes = static_cast<uint64_t>(file_.tellg());
+            dataBytes = std::min<uint64_t>(dataBytes, (fileBytes > dataOffset_) ? fileBytes - dataOffset_ : 0);
+            frames_ = static_cast<int64_t>(dataBytes / blockAlign_);
+            if (frames_ <= 0) {
+                return fail_(errorOut, "empty audio data");
+            }
+            return true;
+        }
+
+        void close() noexcept {
+            if (file_.is_open()) {
+                file_.close();
+            }
+            file_.clear();
+            sampleRate_ = 0;
+            channels_ = 0;
+            frames_ = 0;
+            rf64_ = false;
+        }
+
+        bool isOpen() const noexcept { return file_.is_open(); }
+        int sampleRate() const noexcept { return sampleRate_; }
+        int channels() const noexcept { return channels_; }
+        int64_t frames() const noexcept { return frames_; }
+        Encoding encoding() const noexcept { return encoding_; }
+        bool isRf64() const noexcept { return rf64_; }
+
+        // Кадры [frame, frame + count) в dst0/dst1 (dst1 == nullptr — канал 1 не нужен;
+        // у моно-файла dst1 получает копию канала 0). Диапазон внутри [0, frames()).
+        bool read(int64_t frame, uint32_t count, float* dst0, float* dst1) {
+            if (!file_.is_open() || !dst0 || frame < 0 || frame + count > frames_) {
+                return false;
+            }
+            if (count == 0) {
+                return true;
+            }
+            file_.clear();
+            file_.seekg(static_cast<std::streamoff>(dataOffset_ + static_cast<uint64_t>(frame) * blockAlign_));
+            return readNext_(count, dst0, dst1);
+        }
+
+        // Весь файл в dst0/dst1 (по frames() элементов) последовательными кусками.
+        // cancel (если задан) проверяется между чанками: отмена — тоже false.
+        bool readAll(float* dst0, float* dst1, const std::atomic<bool>* cancel = nullptr) {
+            if (!file_.is_open() || !dst0) {
+                return false;
+            }
+            file_.clear();
+            file_.seekg(static_cast<std::streamoff>(dataOffset_));
+            for (int64_t done = 0; done < frames_;) {
+                if (cancel && cancel->load(std::memory_order_relaxed)) {
+                    return false;
+                }
+                const uint32_t n = static_cast<uint32_t>(std::min<int64_t>(kChunkFrames, frames_ - done));
+                if (!readNext_(n, dst0 + done, dst1 ? dst1 + done : nullptr)) {
+                    return false;
+                }
+                done += n;
+            }
+            return true;
+        }
+
+        // Весь файл, сведенный в моно 0.5 * (L + R), в dst (frames() элементов).
+        bool readAllMono(float* dst) {
+            if (!file_.is_open() || !dst) {
+                return false;
+            }
+            file_.clear();
+            file_.seekg(static_cast<std::streamoff>(dataOffset_));
+            spareR_.resize(kChunkFrames);
+            for (int64_t done = 0; done < frames_;) {
+                const uint32_t n = static_cast<uint32_t>(std::min<int64_t>(kChunkFrames, frames_ - done));
+                float* l = dst + done;
+                if (!readNext_(n, l, spareR_.data())) {
+                    return false;
+                }
+                const float* r = spareR_.data();
+                for (uint32_t i = 0; i < n; ++i) {
+                    l[i] = 0.5f * (l[i] + r[i]);
+                }
+                done += n;
+            }
+            return true;
+        }
+
+    private:
+        static constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+        static uint16_t u16_(const uint8_t* p) noexcept {
+            return static_cast<uint16_t>(p[0] | (p[1] << 8));
+        }
+        static uint32_t u32_(const uint8_t* p) noexcept {
+            return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                   (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        }
+        static uint64_t u64_(const uint8_t* p) noexcept {
+            return static_cast<uint64_t>(u32_(p)) | (static_cast<uint64_t>(u32_(p + 4)) << 32);
+        }
+
+        bool fail_(std::string* errorOut, const char* text) {
+            close();
+            if (errorOut) *errorOut = text;
+            return false;
+        }
+
+        // count кадров с текущей позиции файла.
+        bool readNext_(uint32_t count, float* dst0, float* dst1) {
+            const std::size_t bytes = static_cast<std::size_t>(count) * blockAlign_;
+            if (raw_.size() < bytes + wav_pcm::kReadPad) {
+                raw_.resize(bytes + wav_pcm::kReadPad);
+            }
+            if (!file_.read(reinterpret_cast<char*>(raw_.data()), static_cast<std::streamsize>(bytes))) {
+                return false;
+            }
+            const bool stereo = (channels_ == 2);
+            float* d1 = dst1;
+            if (stereo && !d1) {
+                // Канал 1 не нужен, но векторным ядрам проще его посчитать, чем пропустить.
+                spareDrop_.resize(std::max<std::size_t>(spareDrop_.size(), count));
+                d1 = spareDrop_.data();
+            }
+            convert_(raw_.data(), count, dst0, stereo ? d1 : nullptr);
+            if (!stereo && dst1) {
+                std::memcpy(dst1, dst0, sizeof(float) * count);
+            }
+            return true;
+        }
+
+        void convert_(const uint8_t* src, uint32_t n, float* d0, float* d1) const noexcept {
+            const uint32_t channels = d1 ? 2u : 1u;
+            const bool packed = blockAlign_ == channels * sampleBytes_;
+            uint32_t i = 0;
+            switch (encoding_) {
+                case Encoding::Pcm16:
+                    i = packed ? wav_pcm::pcm16Packed(src, n, d0, d1) : 0u;
+                    tail_(src, i, n, d0, d1, wav_pcm::loadPcm16);
+                    break;
+                case Encoding::Pcm24:
+                    i = packed ? wav_pcm::pcm24Packed(src, n, d0, d1) : 0u;
+                    tail_(src, i, n, d0, d1, wav_pcm::loadPcm24);
+                    break;
+                case Encoding::Pcm32:
+                    i = packed ? wav_pcm::pcm32Packed(src, n, d0, d1) : 0u;
+                    tail_(src, i, n, d0, d1, wav_pcm::loadPcm32);
+                    break;
+                case Encoding::Float32:
+                    i = packed ? wav_pcm::float32Packed(src, n, d0, d1) : 0u;
+                    tail_(src, i, n, d0, d1, wav_pcm::loadFloat32);
+                    break;
+            }
+        }
+
+        template <typename Load>
+        void tail_(const uint8_t* src, uint32_t from, uint32_t n, float* d0, float* d1, Load load) const noexcept {
+            wav_pcm::deinterleaveScalar(src + static_cast<std::size_t>(from) * blockAlign_, n - from, blockAlign_,
+                                        sampleBytes_, d0 + from, d1 ? d1 + from : nullptr, load);
+        }
+
+        std::ifstream file_{};
+        int sampleRate_{0};
+        int channels_{0};
+        int64_t frames_{0};
+        Encoding encoding_{Encoding::Pcm16};
+        uint32_t sampleBytes_{0};
+        uint32_t blockAlign_{0};
+        uint64_t dataOffset_{0};
+        bool rf64_{false};
+        std::vector<uint8_t> raw_{};
+        std::vector<float> spareR_{};
+        std::vector<float> spareDrop_{};
+    };
+
+    // Целиком декодированный файл в planar float (загрузчики клипов).
+    struct WavDecodedPlanar {
+        int sampleRate{0};
+        int channels{0};
+        int frames{0};
+        std::unique_ptr<float[]> ch0{};
+        std::unique_ptr<float[]> ch1{}; // только для stereo
+    };
+
+    // cancel: флаг отмены загрузчика (ClipLoader), опрашивается между чанками data.
+    inline bool decodeWavFile(const std::string& path,
+                              WavDecodedPlanar& out,
+                              std::string* errorOut = nullptr,
+                              const std::atomic<bool>* cancel = nullptr) {
+        out = WavDecodedPlanar{};
+        WavDecoder dec{};
+        if (!dec.open(path, errorOut)) {
+            return false;
+        }
+        if (dec.frames() > static_cast<int64_t>(INT32_MAX)) {
+            if (errorOut) *errorOut = "file too long for in-memory clip";
+            return false;
+        }
+        const auto frames = static_cast<std::size_t>(dec.frames());
+        out.ch0.reset(new (std::nothrow) float[frames]);
+        if (dec.channels() == 2) {
+            out.ch1.reset(new (std::nothrow) float[frames]);
+        }
+        if (!out.ch0 || (dec.channels() == 2 && !out.ch1)) {
+            out = WavDecodedPlanar{};
+            if (errorOut) *errorOut = "alloc channel buffer failed";
+            return false;
+        }
+        if (!dec.readAll(out.ch0.get(), out.ch1.get(), cancel)) {
+            out = WavDecodedPlanar{};
+            if (errorOut) {
+                *errorOut = (cancel && cancel->load(std::memory_order_relaxed)) ? "cancelled" : "cannot read data chunk";
+            }
+            return false;
+        }
+        out.sampleRate = dec.sampleRate();
+        out.channels = dec.channels();
+        out.frames = static_cast<int>(frames);
+        return true;
+    }
+
+    // Моно-сведение 0.5 * (L + R) (анализ: BPM, waveform).
+    inline bool decodeWavFileMono(const std::string& path,
+                                  int& sampleRateOut,
+                                  std::vector<float>& monoOut,
+                                  std::string* errorOut = nullptr) {
+        sampleRateOut = 0;
+        monoOut.clear();
+        WavDecoder dec{};
+        if (!dec.open(path, errorOut)) {
+            return false;
+        }
+        monoOut.resize(static_cast<std::size_t>(dec.frames()));
+        if (!dec.readAllMono(monoOut.data())) {
+            monoOut.clear();
+            if (errorOut) *errorOut = "cannot read data chunk";
+            return false;
+        }
+        sampleRateOut = dec.sampleRate();
+        return true;
+    }
+
+} // namespace avantgarde
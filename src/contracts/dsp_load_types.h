@@ -0,0 +1,94 @@
+#ifndef AVANTGARDE_CONTRACTS_DSP_LOAD_TYPES_H
+#define AVANTGARDE_CONTRACTS_DSP_LOAD_TYPES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/**
+ * dsp_load_types.h — профиль DSP-нагрузки движка (RT -> control/UI).
+ *
+ * RT замеряет такты каждого узла блока (трек, FX-слот трека, хук RT-расширения,
+ * aux-шина, мастер-шина, блок целиком) и копит их в lock-free гистограммы.
+ * Control-поток снимает накопленные счетчики (DspLoadCapture) и считает
+ * статистику за окно между двумя снимками (DspLoadReport): среднее,
+ * перцентили и долю бюджета блока (nframes / sampleRate).
+ */
+namespace avantgarde {
+
+    // Что именно замерено. owner/slot трактуются по виду узла.
+    enum class DspLoadSiteKind : std::uint8_t {
+        Block = 0,   // processBlock целиком
+        Track,       // ITrack::process (вместе с его FX); owner = индекс трека
+        TrackFx,     // IAudioModule::process в цепочке трека; owner = трек, slot = FX-слот
+        RtExtBegin,  // IRtExtension::onBlockBegin; owner = порядок регистрации
+        RtExtEnd,    // IRtExtension::onBlockEnd; owner = порядок регистрации
+        AuxBus,      // FX-цепочка aux-шины целиком; owner = шина
+        MasterBus,   // мастер-лимитер + метры
+    };
+
+    // Лог-линейная гистограмма тактов: 4 корзины на октаву.
+    inline constexpr std::uint32_t kDspLoadHistogramBins = 128;
+    // Сколько самых тяжелых узлов попадает в отчет.
+    inline constexpr std::uint32_t kMaxDspLoadReportSites = 16;
+
+    // Накопленные с запуска счетчики одного узла (сырые такты).
+    struct DspLoadSiteCounters {
+        std::uint16_t site{0};
+        DspLoadSiteKind kind{DspLoadSiteKind::Block};
+        std::uint16_t owner{0};
+        std::uint16_t slot{0};
+        std::uint64_t count{0};     // число замеров (блоков)
+        std::uint64_t sumTicks{0};
+        std::uint64_t maxTicks{0};  // максимум за все время
+        std::uint32_t bins[kDspLoadHistogramBins]{};
+    };
+
+    // Снимок счетчиков профайлера. Только узлы, которые хоть раз замерялись.
+    struct DspLoadCapture {
+        double ticksPerUs{0.0};     // калибровка счетчика тактов
+        std::vector<DspLoadSiteCounters> sites{};
+    };
+
+    struct DspLoadSiteStats {
+        DspLoadSiteKind kind{DspLoadSiteKind::Block};
+        std::uint16_t owner{0};
+        std::uint16_t slot{0};
+        std::uint64_t blocks{0};   // замеров за окно
+        float meanUs{0.0f};
+        float p50Us{0.0f};
+        float p95Us{0.0f};
+        float p99Us{0.0f};
+        float maxUs{0.0f};         // верхняя граница (точность корзины гистограммы)
+        float meanPct{0.0f};       // meanUs в процентах бюджета блока
+        float p99Pct{0.0f};
+    };
+
+    // Статистика за окно между двумя снимками.
+    struct DspLoadReport {
+        float budgetUs{0.0f};              // длительность блока
+        DspLoadSiteStats block{};          // processBlock целиком
+        std::uint32_t siteCount{0};        // сколько элементов sites[] валидны
+        DspLoadSiteStats sites[kMaxDspLoadReportSites]{}; // без Block, по убыванию p99
+    };
+
+    // Короткая метка узла для логов/HUD: T1, T1.FX2, EXT0+, EXT0-, AUX1, MASTER, BLOCK
+    // (треки, FX-слоты и шины нумеруются с 1, как в UI).
+    inline void formatDspLoadSite(char* buf, std::size_t size,
+                                  DspLoadSiteKind kind, unsigned owner, unsigned slot) noexcept {
+        switch (kind) {
+            case DspLoadSiteKind::Block: std::snprintf(buf, size, "BLOCK"); break;
+            case DspLoadSiteKind::Track: std::snprintf(buf, size, "T%u", owner + 1u); break;
+            case DspLoadSiteKind::TrackFx: std::snprintf(buf, size, "T%u.FX%u", owner + 1u, slot + 1u); break;
+            case DspLoadSiteKind::RtExtBegin: std::snprintf(buf, size, "EXT%u+", owner); break;
+            case DspLoadSiteKind::RtExtEnd: std::snprintf(buf, size, "EXT%u-", owner); break;
+            case DspLoadSiteKind::AuxBus: std::snprintf(buf, size, "AUX%u", owner + 1u); break;
+            case DspLoadSiteKind::MasterBus: std::snprintf(buf, size, "MASTER"); break;
+            default: std::snprintf(buf, size, "?"); break;
+        }
+    }
+
+} // namespace avantgarde
+
+#endif // AVANTGARDE_CONTRACTS_DSP_LOAD_TYPES_H
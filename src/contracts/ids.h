@@ -32,6 +32,10 @@ namespace avantgarde {
     // Базовые значения wire-протокола RtCommand.
     constexpr int16_t kRtTrackGlobal = -1;
     constexpr int16_t kRtSlotTrackParams = -1;
+    // Aux return-шины движка: track = kRtTrackAuxBase - bus, slot = FX-слот шины.
+    // Тот же адрес используется в Target для ParamBridge.
+    constexpr int16_t kRtTrackAuxBase = -8;
+    constexpr uint32_t kMaxAuxBuses = 4;
     constexpr int16_t kRtClipSlot0 = 0;
     constexpr uint16_t kRtIndexUnused = 0;
     constexpr float kRtValueOff = 0.0f;
@@ -76,7 +80,14 @@ namespace avantgarde {
         PlayheadNorm = 11,
         // true: трек подстраивает playbackInc от transport BPM/TS и bars (tempo sync on).
         // false: playbackInc полностью ручной и не меняется от BPM/TS.
-        TempoSyncEnabled = 12
+        TempoSyncEnabled = 12,
+        // Уровни посыла трека в aux return-шины движка [0..1] (post-fader).
+        AuxSendA = 13,
+        AuxSendB = 14,
+        AuxSendC = 15,
+        AuxSendD = 16,
+        // Как tempo sync подгоняет клип под такты (см. TempoSyncModeValue).
+        TempoSyncMode = 17
     };
 
     // Track playback mode:
@@ -87,6 +98,14 @@ namespace avantgarde {
         Note = 1
     };
 
+    // Режим tempo sync:
+    // - Varispeed: клип ускоряется/замедляется вместе с высотой (ресемплинг).
+    // - Stretch: длина подгоняется time-stretch'ем (WSOLA), высота клипа сохраняется.
+    enum class TempoSyncModeValue : uint8_t {
+        Varispeed = 0,
+        Stretch = 1
+    };
+
     // Политика старта при новом trigger/note-on:
     // - IgnoreIfPlaying: если уже играет, новый trigger игнорируется.
     // - RetriggerOnNoteOn: новый trigger сбрасывает playhead в начало.
@@ -103,6 +122,26 @@ namespace avantgarde {
         ByNoteOff = 1
     };
 
+    // Выбор голоса для кражи, когда все голоса note-режима заняты:
+    // - Oldest: самый давно стартовавший голос.
+    // - Quietest: голос с минимальным пиком последнего блока.
+    enum class VoiceStealPolicyValue : uint8_t {
+        Oldest = 0,
+        Quietest = 1
+    };
+
+    // "oldest" | "quietest" (CLI --voice-steal). Вне RT.
+    inline bool parseVoiceStealPolicy(std::string_view s, VoiceStealPolicyValue& out) noexcept {
+        if (s == "oldest") {
+            out = VoiceStealPolicyValue::Oldest;
+        } else if (s == "quietest") {
+            out = VoiceStealPolicyValue::Quietest;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
     // Пользовательские профили режима трека (4 режима "из коробки").
     // Это UX-уровень: один профиль разворачивается в набор mode/policy/loop параметров.
     enum class TrackPlaybackProfileValue : uint8_t {
@@ -205,6 +244,28 @@ namespace avantgarde {
         return static_cast<float>(static_cast<uint8_t>(v));
     }
 
+    constexpr float toParamValue(TempoSyncModeValue v) noexcept {
+        return static_cast<float>(static_cast<uint8_t>(v));
+    }
+
+    constexpr uint16_t auxSendParamIndex(uint32_t bus) noexcept {
+        return static_cast<uint16_t>(toParamIndex(TrackParamId::AuxSendA) + bus);
+    }
+
+    constexpr int16_t toRtAuxTrack(uint32_t bus) noexcept {
+        return static_cast<int16_t>(kRtTrackAuxBase - static_cast<int16_t>(bus));
+    }
+
+    // true, если track адресует aux-шину; bus — ее индекс.
+    constexpr bool fromRtAuxTrack(int track, uint32_t& bus) noexcept {
+        const int b = kRtTrackAuxBase - track;
+        if (b < 0 || b >= static_cast<int>(kMaxAuxBuses)) {
+            return false;
+        }
+        bus = static_cast<uint32_t>(b);
+        return true;
+    }
+
     constexpr uint16_t toParamIndex(TransportParamId id) noexcept {
         return static_cast<uint16_t>(id);
     }
@@ -0,0 +1,34 @@
+#ifndef AVANTGARDE_CONTRACTS_METER_TYPES_H
+#define AVANTGARDE_CONTRACTS_METER_TYPES_H
+
+#include <cstdint>
+
+/**
+ * meter_types.h — POD-кадр метров движка (RT -> UI).
+ *
+ * Кадр пишет только аудио-нить (один писатель) в конце блока;
+ * UI читает последний опубликованный кадр на месте, без копирования
+ * (см. IAudioEngine::readMeters()).
+ *
+ * Все уровни линейные (1.0 = 0 dBFS); перевод в dB — на стороне UI.
+ */
+namespace avantgarde {
+
+    inline constexpr std::uint32_t kMaxMeterTracks = 32;
+
+    struct LevelMeter {
+        float peak{0.0f}; // max |x| за блок
+        float rms{0.0f};  // sqrt(mean(x^2)) за блок
+    };
+
+    struct EngineMeterFrame {
+        std::uint64_t blockIndex{0};   // номер блока, в котором кадр снят (0 = еще не было)
+        LevelMeter master[2]{};        // L/R после мастер-лимитера
+        float limiterGain{1.0f};       // минимальный gain лимитера за блок (1 = не срабатывал)
+        std::uint32_t trackCount{0};   // сколько элементов tracks[] валидны
+        LevelMeter tracks[kMaxMeterTracks]{}; // выход трека (стерео-связанный), порядок регистрации
+    };
+
+} // namespace avantgarde
+
+#endif // AVANTGARDE_CONTRACTS_METER_TYPES_H
@@ -43,6 +43,16 @@ namespace avantgarde {
         float    value;
     };
 
+    struct IClipStream; // IClipStream.h
+    struct ClipStretchAnalysis; // ClipStretchAnalysis.h
+
+// Формат хранения сэмплов клипа в памяти (конверсия — см. ClipSampleFormat.h).
+    enum class ClipSampleFormat : uint8_t {
+        Float32 = 0, // float [-1..1]
+        Int16 = 1,   // int16 PCM, x / 32768
+        Float16 = 2  // биты IEEE half
+    };
+
 // Разделяемый planar-аудиобуфер клипа.
 // Используется для preloaded clip-pool и быстрого переключения по clipRefId
 // без повторного IO/декодирования файла.
@@ -50,16 +60,40 @@ namespace avantgarde {
         int sampleRate{0}; // Hz
         int channels{0};   // 1 или 2
         int frames{0};     // количество сэмпл-фреймов на канал
-        std::shared_ptr<const float[]> ch0{}; // planar channel 0, size=frames
-        std::shared_ptr<const float[]> ch1{}; // planar channel 1, size=frames (может быть nullptr для mono)
+        std::shared_ptr<const float[]> ch0{}; // planar channel 0, size=residentFrames()
+        std::shared_ptr<const float[]> ch1{}; // planar channel 1, size=residentFrames() (может быть nullptr для mono)
+        // Компактное хранение (format != Float32): каналы лежат в ch0Packed/ch1Packed
+        // (int16 PCM или биты half), а ch0/ch1 пусты.
+        ClipSampleFormat format{ClipSampleFormat::Float32};
+        std::shared_ptr<const int16_t[]> ch0Packed{};
+        std::shared_ptr<const int16_t[]> ch1Packed{};
+        // Длинный клип с диска: в ch0/ch1 только первые streamHeadFrames кадров,
+        // остальное читается через stream (nullptr — клип целиком в памяти).
+        std::shared_ptr<IClipStream> stream{};
+        int streamHeadFrames{0};
+        // Анализ для time-stretch (см. ClipStretchAnalysis.h); строится при загрузке,
+        // у потоковых клипов отсутствует.
+        std::shared_ptr<const ClipStretchAnalysis> stretch{};
+
+        // Сколько кадров можно читать прямо из ch0/ch1.
+        [[nodiscard]] int residentFrames() const noexcept {
+            return stream ? streamHeadFrames : frames;
+        }
 
         [[nodiscard]] bool valid() const noexcept {
             if (sampleRate <= 0 || frames <= 0) {
                 return false;
             }
+            if (stream && (streamHeadFrames <= 0 || streamHeadFrames > frames)) {
+                return false;
+            }
             if (channels != 1 && channels != 2) {
                 return false;
             }
+            if (format != ClipSampleFormat::Float32) {
+                // Потоковый клип всегда float: голова читается тем же путем, что и кольца.
+                return !stream && ch0Packed && (channels == 1 || ch1Packed);
+            }
             if (!ch0) {
                 return false;
             }
@@ -93,6 +127,10 @@ namespace avantgarde {
         int16_t slot; // FX‑слот или -1
         uint16_t index; // индекс параметра (для ParamSet)
         float value; // полезная нагрузка
+        // Смещение (в сэмплах) от начала аудио-блока, в котором команда применяется.
+        // 0 = начало блока (поведение по умолчанию для UI/control-команд);
+        // заполняется RT-планировщиками, знающими точный момент события.
+        uint32_t frameInBlock{0};
     };
     static_assert(std::is_trivially_copyable<RtCommand>::value, "RtCommand must be POD");
 
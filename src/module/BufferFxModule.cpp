@@ -18,8 +18,13 @@ constexpr uint32_t kMaxCrossfadeSamples = 128U;
 constexpr float kDcBlockR = 0.995f;
 constexpr float kSaturationDriveBase = 1.15f;
 constexpr float kWetSmoothAlpha = 0.25f;
+// DC-блокер и wet-сглаживание стоят последовательно: хвосты складываются.
+constexpr uint32_t kFilterTailFrames =
+    IAudioModule::onePoleTailFrames(kDcBlockR) + IAudioModule::onePoleTailFrames(1.0f - kWetSmoothAlpha);
 // Компромисс памяти/функционала: максимум 8 секунд буфера на один инстанс.
 constexpr double kMaxBufferSeconds = 8.0;
+// Сколько кадров ring обнуляет один process() после reset(): 128 KB на блок вместо 3 MB разом.
+constexpr uint32_t kResetClearFrames = 16384U;
 
 // Musical fractions in bars.
 constexpr std::array<float, 5> kSliceBars = {
@@ -71,6 +76,7 @@ void BufferFxModule::init(double sampleRate, std::size_t /*maxFrames*/) {
     ringL_.assign(ringCapacity_, 0.0f);
     ringR_.assign(ringCapacity_, 0.0f);
     writePos_ = 0U;
+    clearPos_ = ringCapacity_;
     localSampleCounter_ = 0U;
     effectiveBpm_ = 120.0f;
     rngState_ = 0x13572468u;
@@ -95,6 +101,15 @@ void BufferFxModule::process(const AudioProcessContext& ctx) noexcept {
         return;
     }
 
+    if (clearPos_ < ringCapacity_) {
+        // Кусок не меньше блока: запись (с 0 после reset()) не догонит очистку.
+        const uint32_t chunk = std::max<uint32_t>(kResetClearFrames, static_cast<uint32_t>(ctx.nframes));
+        const uint32_t end = std::min<uint32_t>(ringCapacity_, clearPos_ + chunk);
+        std::fill(ringL_.begin() + clearPos_, ringL_.begin() + end, 0.0f);
+        std::fill(ringR_.begin() + clearPos_, ringR_.begin() + end, 0.0f);
+        clearPos_ = end;
+    }
+
     if (ctx.transportValid) {
         effectiveBpm_ = clampToRangeF_(ctx.transportBpm, kMinBpm, kMaxBpm);
     }
@@ -252,14 +267,14 @@ void BufferFxModule::process(const AudioProcessContext& ctx) noexcept {
             float curL = 0.0f;
             float curR = 0.0f;
             if (state_.current.active) {
-                curL = renderVoiceSample_(state_.current, ringL_, state_.bufferSizeSamples);
-                curR = renderVoiceSample_(state_.current, ringR_, state_.bufferSizeSamples);
+                curL = renderVoiceSample_(state_.current, ringL_, state_.bufferSizeSamples, clearPos_);
+                curR = renderVoiceSample_(state_.current, ringR_, state_.bufferSizeSamples, clearPos_);
                 advanceVoice_(state_.current);
             }
 
             if (state_.inTransition && state_.next.active) {
-                const float nxtL = renderVoiceSample_(state_.next, ringL_, state_.bufferSizeSamples);
-                const float nxtR = renderVoiceSample_(state_.next, ringR_, state_.bufferSizeSamples);
+                const float nxtL = renderVoiceSample_(state_.next, ringL_, state_.bufferSizeSamples, clearPos_);
+                const float nxtR = renderVoiceSample_(state_.next, ringR_, state_.bufferSizeSamples, clearPos_);
                 advanceVoice_(state_.next);
 
                 const float a = (state_.transitionSamples > 0U)
@@ -310,8 +325,8 @@ void BufferFxModule::process(const AudioProcessContext& ctx) noexcept {
 }
 
 void BufferFxModule::reset() {
-    std::fill(ringL_.begin(), ringL_.end(), 0.0f);
-    std::fill(ringR_.begin(), ringR_.end(), 0.0f);
+    // O(1) для RT-сброса на границе блока: ring дочищает process(), см. clearPos_.
+    clearPos_ = 0U;
     writePos_ = 0U;
     localSampleCounter_ = 0U;
     state_ = RtState{};
@@ -509,7 +524,7 @@ uint32_t BufferFxModule::wrapIndex_(int64_t i, uint32_t size) noexcept {
     return static_cast<uint32_t>(mod < 0 ? mod + static_cast<int64_t>(size) : mod);
 }
 
-float BufferFxModule::readCubic_(const std::vector<float>& ring, float pos, uint32_t size) noexcept {
+float BufferFxModule::readCubic_(const std::vector<float>& ring, float pos, uint32_t size, uint32_t validEnd) noexcept {
     if (ring.empty() || size == 0U) {
         return 0.0f;
     }
@@ -522,10 +537,10 @@ float BufferFxModule::readCubic_(const std::vector<float>& ring, float pos, uint
     const uint32_t i2u = wrapIndex_(i1 + 1, size);
     const uint32_t i3u = wrapIndex_(i1 + 2, size);
 
-    const float y0 = ring[i0u];
-    const float y1 = ring[i1u];
-    const float y2 = ring[i2u];
-    const float y3 = ring[i3u];
+    const float y0 = (i0u < validEnd) ? ring[i0u] : 0.0f;
+    const float y1 = (i1u < validEnd) ? ring[i1u] : 0.0f;
+    const float y2 = (i2u < validEnd) ? ring[i2u] : 0.0f;
+    const float y3 = (i3u < validEnd) ? ring[i3u] : 0.0f;
 
     const float a0 = -0.5f * y0 + 1.5f * y1 - 1.5f * y2 + 0.5f * y3;
     const float a1 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
@@ -542,7 +557,8 @@ float BufferFxModule::findTransientScore_(float prev, float cur) noexcept {
 
 float BufferFxModule::renderVoiceSample_(const SliceVoice& voice,
                                          const std::vector<float>& ring,
-                                         uint32_t ringSize) noexcept {
+                                         uint32_t ringSize,
+                                         uint32_t validEnd) noexcept {
     if (!voice.active || ring.empty() || ringSize == 0U || voice.sliceLength == 0U) {
         return 0.0f;
     }
@@ -559,7 +575,7 @@ float BufferFxModule::renderVoiceSample_(const SliceVoice& voice,
     if (voice.reverse) {
         absPos = static_cast<float>(voice.sliceStart) + (sliceLen - 1.0f - local);
     }
-    return readCubic_(ring, wrapPos_(absPos, ringSize), ringSize);
+    return readCubic_(ring, wrapPos_(absPos, ringSize), ringSize, validEnd);
 }
 
 void BufferFxModule::advanceVoice_(SliceVoice& voice) noexcept {
@@ -712,6 +728,19 @@ void BufferFxModule::triggerSliceAtSample_(uint64_t quantizedSample,
     state_.active = true;
 }
 
+uint32_t BufferFxModule::tailFrames() const noexcept {
+    // Wet читается только из ring (активная часть — bufferSizeSamples <= ringCapacity_):
+    // за ringCapacity_ тихих кадров она целиком перезаписана тишиной.
+    return ringCapacity_ + kFilterTailFrames;
+}
+
+std::unique_ptr<IAudioModule> BufferFxModule::cloneForOffline(double sampleRate, std::size_t maxFrames) const {
+    auto copy = std::make_unique<BufferFxModule>();
+    copy->init(sampleRate, maxFrames);
+    copyParamsTo_(*copy);
+    return copy;
+}
+
 float BufferFxModule::dcBlock_(float x, float& x1, float& y1) noexcept {
     const float y = x - x1 + kDcBlockR * y1;
     x1 = x;
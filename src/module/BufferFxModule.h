@@ -4,6 +4,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "contracts/IAudioModule.h"
@@ -40,6 +41,8 @@ public:
     void beginBlock() noexcept override;
     void process(const AudioProcessContext& ctx) noexcept override;
     void reset() override;
+    uint32_t tailFrames() const noexcept override;
+    std::unique_ptr<IAudioModule> cloneForOffline(double sampleRate, std::size_t maxFrames) const override;
 
     // ---- IParameterized ----
     std::size_t getParamCount() const override;
@@ -131,12 +134,14 @@ private:
 
     static float wrapPos_(float pos, uint32_t size) noexcept;
     static uint32_t wrapIndex_(int64_t i, uint32_t size) noexcept;
-    static float readCubic_(const std::vector<float>& ring, float pos, uint32_t size) noexcept;
+    // Отсчеты с индексом >= validEnd (еще не очищены после reset()) читаются как 0.
+    static float readCubic_(const std::vector<float>& ring, float pos, uint32_t size, uint32_t validEnd) noexcept;
     static float findTransientScore_(float prev, float cur) noexcept;
 
     static float renderVoiceSample_(const SliceVoice& voice,
                                     const std::vector<float>& ring,
-                                    uint32_t ringSize) noexcept;
+                                    uint32_t ringSize,
+                                    uint32_t validEnd) noexcept;
     static void advanceVoice_(SliceVoice& voice) noexcept;
     void setActivePhraseParams_(uint32_t bufferSizeSamples,
                                 uint32_t sliceSamples,
@@ -169,6 +174,9 @@ private:
     std::vector<float> ringL_{};
     std::vector<float> ringR_{};
     uint32_t writePos_{0};
+    // reset() не чистит ring сразу (~3 MB за один RT-блок): process() обнуляет его
+    // кусками с начала, опережая запись; все от clearPos_ и дальше считается тишиной.
+    uint32_t clearPos_{0};
     uint32_t rngState_{0x13572468u};
 
     std::atomic<Params> write_{Params{}};
@@ -3,6 +3,7 @@
 #include <atomic>
 #include <cmath>
 #include <cstddef>
+#include <memory>
 
 namespace avantgarde {
 
@@ -46,6 +47,16 @@ namespace avantgarde {
             // step_ посчитаем в process()
         }
 
+        // Чистое усиление без памяти: тихий вход — тихий выход.
+        uint32_t tailFrames() const noexcept override { return 0; }
+
+        std::unique_ptr<IAudioModule> cloneForOffline(double sampleRate, std::size_t maxFrames) const override {
+            auto copy = std::make_unique<GainSlewModule>(mode_, blocks_, ms_);
+            copy->init(sampleRate, maxFrames);
+            copyParamsTo_(*copy);
+            return copy;
+        }
+
         void process(const AudioProcessContext& ctx) noexcept override {
             // ленивый расчёт длительности/шага рампы (только один раз на старт рампы)
             if (rampInitPending_) {
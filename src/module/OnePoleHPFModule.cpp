@@ -1,6 +1,7 @@
 #include "contracts/IAudioModule.h"
 #include <cmath>
 #include <algorithm>
+#include <memory>
 
 namespace avantgarde {
 
@@ -51,6 +52,23 @@ namespace avantgarde {
             prevY_ = py;
         }
 
+        // Состояние затухает в a_ раз за кадр; запас x4 на выброс HPF при ступеньке.
+        // a_ >= 1 (cutoff у нуля) не затухает: пропускать process() нельзя.
+        uint32_t tailFrames() const noexcept override {
+            if (a_ >= 1.0f) return kInfiniteTailFrames;
+            if (!(a_ > 0.0f)) return 0;
+            const double frames = std::ceil(std::log(static_cast<double>(kSilenceLevel) / 4.0) /
+                                            std::log(static_cast<double>(a_)));
+            return static_cast<uint32_t>(std::min(frames, static_cast<double>(kInfiniteTailFrames - 1U)));
+        }
+
+        std::unique_ptr<IAudioModule> cloneForOffline(double sampleRate, std::size_t maxFrames) const override {
+            auto copy = std::make_unique<OnePoleHPFModule>();
+            copy->init(sampleRate, maxFrames);
+            copyParamsTo_(*copy);
+            return copy;
+        }
+
         // ---- параметрический интерфейс по контракту ----
         std::size_t getParamCount() const noexcept override {
             return kParamCount;
@@ -17,6 +17,9 @@ constexpr float kAllpassFeedback = 0.5f;
 // Повышен относительно классического freeverb-уровня,
 // чтобы wet ощущался равномернее в диапазоне 0..1.
 constexpr float kInputGain = 0.04f;
+// Запас по уровню для оценки хвоста: резонансный подъем comb-ов (до 1/(1-fb))
+// и makeup wet-усиления (до ~8x) поверх входного драйва.
+constexpr double kTailHeadroom = 32.0;
 
 } // namespace
 
@@ -216,6 +219,34 @@ void SchroederReverbModule::configureDelayLines_() {
     }
 }
 
+uint32_t SchroederReverbModule::tailFrames() const noexcept {
+    // Comb затухает не медленнее feedback_ за проход (low-pass в контуре с DC-усилением 1),
+    // allpass — kAllpassFeedback за проход; линии включены последовательно.
+    const double floorLn = std::log(static_cast<double>(kSilenceLevel) / kTailHeadroom);
+    std::size_t combLen = 0;
+    for (std::size_t i = 0; i < combL_.size(); ++i) {
+        combLen = std::max({combLen, combL_[i].buf.size(), combR_[i].buf.size()});
+    }
+    std::size_t apLenL = 0;
+    std::size_t apLenR = 0;
+    for (std::size_t i = 0; i < apL_.size(); ++i) {
+        apLenL += apL_[i].buf.size();
+        apLenR += apR_[i].buf.size();
+    }
+    const double combPasses = std::ceil(floorLn / std::log(static_cast<double>(feedback_)));
+    const double apPasses = std::ceil(floorLn / std::log(static_cast<double>(kAllpassFeedback)));
+    const double frames = combPasses * static_cast<double>(combLen) +
+                          apPasses * static_cast<double>(std::max(apLenL, apLenR));
+    return static_cast<uint32_t>(std::min(frames, static_cast<double>(kInfiniteTailFrames - 1U)));
+}
+
+std::unique_ptr<IAudioModule> SchroederReverbModule::cloneForOffline(double sampleRate, std::size_t maxFrames) const {
+    auto copy = std::make_unique<SchroederReverbModule>();
+    copy->init(sampleRate, maxFrames);
+    copyParamsTo_(*copy);
+    return copy;
+}
+
 float SchroederReverbModule::clamp01_(float v) noexcept {
     return std::clamp(v, 0.0f, 1.0f);
 }
@@ -4,6 +4,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "contracts/IAudioModule.h"
@@ -31,6 +32,8 @@ public:
     void beginBlock() noexcept override;
     void process(const AudioProcessContext& ctx) noexcept override;
     void reset() override;
+    uint32_t tailFrames() const noexcept override;
+    std::unique_ptr<IAudioModule> cloneForOffline(double sampleRate, std::size_t maxFrames) const override;
 
     // ---- IParameterized ----
     std::size_t getParamCount() const override;
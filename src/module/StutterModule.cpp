@@ -10,6 +10,8 @@ namespace {
 constexpr float kMinBpm = 20.0f;
 constexpr float kMaxBpm = 300.0f;
 constexpr std::size_t kMaxCrossfadeSamples = 24;
+// Кадров ring, которые обнуляет один process() после reset().
+constexpr std::size_t kResetClearFrames = 16384;
 
 } // namespace
 
@@ -28,6 +30,7 @@ void StutterModule::init(double sampleRate, std::size_t /*maxFrames*/) {
     ringL_.assign(ringSize_, 0.0f);
     ringR_.assign(ringSize_, 0.0f);
     writePos_ = 0;
+    clearPos_ = ringSize_;
     localSampleCounter_ = 0;
     read_ = write_.load(std::memory_order_relaxed);
 }
@@ -48,6 +51,14 @@ void StutterModule::process(const AudioProcessContext& ctx) noexcept {
         return;
     }
 
+    if (clearPos_ < ringSize_) {
+        // Кусок не меньше блока: запись (с 0 после reset()) не догонит очистку.
+        const std::size_t end = std::min(ringSize_, clearPos_ + std::max(kResetClearFrames, ctx.nframes));
+        std::fill(ringL_.begin() + static_cast<std::ptrdiff_t>(clearPos_), ringL_.begin() + static_cast<std::ptrdiff_t>(end), 0.0f);
+        std::fill(ringR_.begin() + static_cast<std::ptrdiff_t>(clearPos_), ringR_.begin() + static_cast<std::ptrdiff_t>(end), 0.0f);
+        clearPos_ = end;
+    }
+
     const float bpm = std::clamp(ctx.transportBpm, kMinBpm, kMaxBpm);
     const float beatsPerStep = mapRateToBeats_(read_.rate);
     const double stepSamplesF = sampleRate_ * (60.0 / static_cast<double>(bpm)) * static_cast<double>(beatsPerStep);
@@ -140,12 +151,25 @@ void StutterModule::process(const AudioProcessContext& ctx) noexcept {
 }
 
 void StutterModule::reset() {
-    std::fill(ringL_.begin(), ringL_.end(), 0.0f);
-    std::fill(ringR_.begin(), ringR_.end(), 0.0f);
+    // O(1) для RT-сброса на границе блока: ring дочищает process(), см. clearPos_.
+    clearPos_ = 0U;
     writePos_ = 0U;
     localSampleCounter_ = 0U;
 }
 
+uint32_t StutterModule::tailFrames() const noexcept {
+    // Повторы и gate читают только ring без обратной связи: через ringSize_ тихих
+    // кадров в нем не остается ничего, кроме тишины.
+    return static_cast<uint32_t>(std::min<std::size_t>(ringSize_, kInfiniteTailFrames - 1U));
+}
+
+std::unique_ptr<IAudioModule> StutterModule::cloneForOffline(double sampleRate, std::size_t maxFrames) const {
+    auto copy = std::make_unique<StutterModule>();
+    copy->init(sampleRate, maxFrames);
+    copyParamsTo_(*copy);
+    return copy;
+}
+
 std::size_t StutterModule::getParamCount() const {
     return NUM_PARAMS;
 }
@@ -233,7 +257,7 @@ float StutterModule::sampleAtDelay_(const std::vector<float>& ring,
     }
     const std::size_t d = (delay >= ringSize_) ? (ringSize_ - 1U) : delay;
     const std::size_t idx = (writePos + ringSize_ - d) % ringSize_;
-    return ring[idx];
+    return (idx < clearPos_) ? ring[idx] : 0.0f;
 }
 
 float StutterModule::gateEnvelope_(std::size_t indexInSubStep,
@@ -4,6 +4,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "contracts/IAudioModule.h"
@@ -37,6 +38,8 @@ public:
     void beginBlock() noexcept override;
     void process(const AudioProcessContext& ctx) noexcept override;
     void reset() override;
+    uint32_t tailFrames() const noexcept override;
+    std::unique_ptr<IAudioModule> cloneForOffline(double sampleRate, std::size_t maxFrames) const override;
 
     // ---- IParameterized ----
     std::size_t getParamCount() const override;
@@ -64,6 +67,9 @@ private:
     std::vector<float> ringL_{};
     std::vector<float> ringR_{};
     std::size_t writePos_{0};
+    // Как у BufferFx: reset() не чистит 16-секундный ring в RT разом, process() обнуляет
+    // его кусками впереди записи; отсчеты от clearPos_ и дальше читаются как тишина.
+    std::size_t clearPos_{0};
     uint64_t localSampleCounter_{0};
 
     std::atomic<Params> write_{Params{}};
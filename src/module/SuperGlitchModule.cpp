@@ -11,6 +11,9 @@ constexpr float kMinBpm = 20.0f;
 constexpr float kMaxBpm = 300.0f;
 constexpr float kDcBlockR = 0.995f;
 constexpr float kWetSmoothAlpha = 0.22f;
+// DC-блокер и wet-сглаживание стоят последовательно: хвосты складываются.
+constexpr uint32_t kFilterTailFrames =
+    IAudioModule::onePoleTailFrames(kDcBlockR) + IAudioModule::onePoleTailFrames(1.0f - kWetSmoothAlpha);
 constexpr uint32_t kMinSliceSamples = 8U;
 constexpr uint32_t kMaxCrossfadeSamples = 128U;
 constexpr double kMaxBufferSeconds = 8.0;
@@ -604,6 +607,19 @@ void SuperGlitchModule::applyPendingPhraseParams_() noexcept {
     state_.pendingPhraseParams = false;
 }
 
+uint32_t SuperGlitchModule::tailFrames() const noexcept {
+    // Фразы захватываются из ring PhraseCapture, который пишется каждый кадр:
+    // через ringCapacity_ тихих кадров захватывать уже нечего.
+    return ringCapacity_ + kFilterTailFrames;
+}
+
+std::unique_ptr<IAudioModule> SuperGlitchModule::cloneForOffline(double sampleRate, std::size_t maxFrames) const {
+    auto copy = std::make_unique<SuperGlitchModule>();
+    copy->init(sampleRate, maxFrames);
+    copyParamsTo_(*copy);
+    return copy;
+}
+
 float SuperGlitchModule::dcBlock_(float x, float& x1, float& y1) noexcept {
     const float y = x - x1 + kDcBlockR * y1;
     x1 = x;
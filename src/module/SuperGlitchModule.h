@@ -4,6 +4,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 
 #include "contracts/IAudioModule.h"
 #include "module/GlitchVoice.h"
@@ -36,6 +37,8 @@ public:
     void beginBlock() noexcept override;
     void process(const AudioProcessContext& ctx) noexcept override;
     void reset() override;
+    uint32_t tailFrames() const noexcept override;
+    std::unique_ptr<IAudioModule> cloneForOffline(double sampleRate, std::size_t maxFrames) const override;
 
     std::size_t getParamCount() const override;
     float getParam(std::size_t index) const override;
@@ -0,0 +1,114 @@
+#include "platform/offline/OfflineAudioHost.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace avantgarde {
+
+class OfflineAudioStream final : public IAudioStream {
+public:
+    OfflineAudioStream(OfflineAudioHost* owner, const StreamConfig& cfg) noexcept
+        : owner_(owner),
+          cfg_(cfg) {
+        cfg_.numInput = 0;
+        cfg_.numOutput = std::clamp(cfg_.numOutput, 1, 2);
+        if (cfg_.sampleRate <= 0) {
+            cfg_.sampleRate = 48000;
+        }
+        if (cfg_.blockFrames <= 0) {
+            cfg_.blockFrames = 256;
+        }
+    }
+
+    ~OfflineAudioStream() override {
+        if (owner_) {
+            owner_->detach_(this);
+        }
+    }
+
+    bool start(AudioRenderCb render, void* user) noexcept override {
+        render_ = render;
+        user_ = user;
+        running_ = (render_ != nullptr);
+        return running_;
+    }
+
+    void stop() noexcept override { running_ = false; }
+    void close() noexcept override { stop(); }
+
+    int sampleRate() const noexcept override { return cfg_.sampleRate; }
+    int blockFrames() const noexcept override { return cfg_.blockFrames; }
+    int numInput() const noexcept override { return 0; }
+    int numOutput() const noexcept override { return cfg_.numOutput; }
+    uint64_t totalCallbacks() const noexcept override { return totalCallbacks_; }
+    uint64_t xruns() const noexcept override { return 0; }
+
+    bool render(float** out, std::size_t nframes) noexcept {
+        if (!running_ || !out || nframes == 0 || nframes > static_cast<std::size_t>(cfg_.blockFrames)) {
+            return false;
+        }
+        for (int ch = 0; ch < cfg_.numOutput; ++ch) {
+            std::memset(out[ch], 0, nframes * sizeof(float));
+        }
+        AudioProcessContext ctx{};
+        ctx.in = nullptr;
+        ctx.out = out;
+        ctx.numOut = static_cast<uint32_t>(cfg_.numOutput);
+        ctx.nframes = nframes;
+        render_(ctx, user_);
+        ++totalCallbacks_;
+        return true;
+    }
+
+    void orphan() noexcept { owner_ = nullptr; }
+
+private:
+    OfflineAudioHost* owner_{nullptr};
+    StreamConfig cfg_{};
+    AudioRenderCb render_{nullptr};
+    void* user_{nullptr};
+    bool running_{false};
+    uint64_t totalCallbacks_{0};
+};
+
+OfflineAudioHost::~OfflineAudioHost() {
+    if (stream_) {
+        stream_->orphan();
+    }
+}
+
+std::vector<AudioDeviceInfo> OfflineAudioHost::enumerate() {
+    AudioDeviceInfo dev{};
+    dev.id = "offline";
+    dev.name = "Offline render";
+    dev.maxInput = 0;
+    dev.maxOutput = 2;
+    dev.isDefault = true;
+    return {dev};
+}
+
+std::unique_ptr<IAudioStream> OfflineAudioHost::openStream(const StreamConfig& cfg,
+                                                           const std::string&,
+                                                           const std::string&,
+                                                           NonRtNotifyCb,
+                                                           void*) {
+    if (stream_) {
+        // Один активный стрим на хост: прежний больше не адресуется renderBlock().
+        stream_->orphan();
+    }
+    auto stream = std::make_unique<OfflineAudioStream>(this, cfg);
+    stream_ = stream.get();
+    return stream;
+}
+
+bool OfflineAudioHost::renderBlock(float** out, std::size_t nframes) noexcept {
+    return stream_ && stream_->render(out, nframes);
+}
+
+void OfflineAudioHost::detach_(OfflineAudioStream* stream) noexcept {
+    if (stream_ == stream) {
+        stream_ = nullptr;
+    }
+}
+
+} // namespace avantgarde
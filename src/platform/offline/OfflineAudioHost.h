@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "contracts/IPlatform.h"
+
+namespace avantgarde {
+
+class OfflineAudioStream;
+
+// Аудиохост без устройства: рендер-колбэк вызывается синхронно из потока-владельца
+// (renderBlock), а не из аудио-нити по таймеру устройства. Используется для
+// headless bounce быстрее реального времени; xrun-ов по определению нет.
+class OfflineAudioHost final : public IAudioHost {
+public:
+    OfflineAudioHost() = default;
+    ~OfflineAudioHost() override;
+
+    std::vector<AudioDeviceInfo> enumerate() override;
+    std::unique_ptr<IAudioStream> openStream(const StreamConfig& cfg,
+                                             const std::string& inputDeviceId,
+                                             const std::string& outputDeviceId,
+                                             NonRtNotifyCb onNotify = nullptr,
+                                             void* notifyUser = nullptr) override;
+
+    // Отрендерить один блок в out[numOutput][nframes] (nframes <= blockFrames стрима).
+    // false: стрим не открыт/не запущен или блок больше заявленного.
+    bool renderBlock(float** out, std::size_t nframes) noexcept;
+
+private:
+    friend class OfflineAudioStream;
+    void detach_(OfflineAudioStream* stream) noexcept;
+
+    // Последний открытый стрим; сбрасывается в его деструкторе.
+    OfflineAudioStream* stream_{nullptr};
+};
+
+} // namespace avantgarde
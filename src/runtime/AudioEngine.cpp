@@ -10,6 +10,18 @@
 #include <vector>
 #include <memory>
 #include "contracts/ids.h"
+#include "runtime/RtWorkerPool.h"
+#include "runtime/CompiledAudioGraph.h"
+#include "runtime/ClipResampleKernel.h"
+#include "runtime/DspLoadProfiler.h"
+#include "runtime/LookaheadLimiter.h"
+#include "runtime/RenderAheadPool.h"
+#include "runtime/TripleBuffer.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <mutex>
 #include <utility>
 #include <cstdint>
 #include <cstring>
@@ -30,11 +42,184 @@ namespace avantgarde {
 
         // --- вне RT ---
         void registerTrack(std::unique_ptr<ITrack> track) override {
+            trackPtrs_.push_back(track.get());
             tracks_.push_back(std::move(track));
+            // Шина трека нужна только для параллельного рендера, но выделяем ее сразу:
+            // включение воркеров не должно зависеть от порядка вызовов.
+            trackBuses_.emplace_back(static_cast<std::size_t>(kTrackBusChannels) * kTrackBusFrames, 0.0f);
+        }
+
+        /**
+         * setRenderWorkers
+         *
+         * Включает параллельный рендер треков на workers дополнительных нитях
+         * (аудио-нить тоже берет задачи). Каждый трек пишет в свою предвыделенную
+         * шину, после чего движок суммирует шины в master в порядке регистрации —
+         * результат не зависит от того, какой воркер какой трек отрендерил.
+         *
+         * Ограничения:
+         *  - вызывать только ВНЕ RT (до старта аудиострима);
+         *  - воркеры пиннятся на CPU 1..N (CPU 0 остается аудио-нити/ОС).
+         */
+        bool setRenderWorkers(uint32_t workers) override {
+            return workerPool_.start(workers, /*firstCpu*/ 1, kRenderWorkerRtPriority);
+        }
+
+        /**
+         * setRenderAhead
+         *
+         * Треки, которые только играют клип по транспорту (ITrack::canRenderAheadRt),
+         * отдаются фоновой нити: она рендерит их на blocks блоков вперед в lock-free кольца,
+         * а processBlock лишь копирует готовый блок в шину трека. Любая команда треку
+         * (ParamSet, триггер, pattern switch), публикация вне RT (ITrack::controlEpoch),
+         * смена темпа/размера блока или play/stop возвращают трек в RT-рендер.
+         *
+         * Ограничения:
+         *  - вызывать только ВНЕ RT (до старта стрима), после регистрации треков;
+         *  - работает в пути шин треков: граф маршрутизации (setRoutingGraph) держит все треки в RT;
+         *  - параметры треков должны приходить RtCommand'ами: записи ParamBridge напрямую
+         *    в трек движок не видит.
+         */
+        bool setRenderAhead(uint32_t blocks) override {
+            return renderAhead_.start(trackPtrs_.data(), static_cast<uint32_t>(trackPtrs_.size()), blocks,
+                                      kRenderAheadRtPriority);
+        }
+
+        /**
+         * setRoutingGraph
+         *
+         * Компилирует граф в плоское расписание (вне RT) и публикует его для RT:
+         * аудио-нить подхватывает новое расписание в начале следующего блока.
+         * Старое расписание освобождается только после того, как RT подтвердил переход.
+         *
+         * Ограничения:
+         *  - вызывать ВНЕ RT, после регистрации треков (расписание привязано к их числу);
+         *  - в режиме графа треки рендерятся последовательно в порядке расписания;
+         *  - модули Module-узлов инициализирует compile() под sampleRate_ движка; модули,
+         *    которые уже играют в опубликованных расписаниях, сохраняют свое состояние.
+         */
+        bool setRoutingGraph(const IAudioGraph* graph) override {
+            std::unique_ptr<CompiledAudioGraph> compiled;
+            if (graph) {
+                std::vector<const CompiledAudioGraph*> live;
+                if (routingCtl_) {
+                    live.push_back(routingCtl_->graph.get());
+                }
+                for (const auto& r : retiredRouting_) {
+                    live.push_back(r->graph.get());
+                }
+                compiled = CompiledAudioGraph::compile(*graph, tracks_.size(), sampleRate_, live);
+                if (!compiled) {
+                    return false;
+                }
+            }
+            auto next = std::make_unique<RoutingSnapshot>();
+            next->generation = ++routingGenCtl_;
+            next->graph = std::move(compiled);
+            routingRt_.store(next.get(), std::memory_order_release);
+            if (routingCtl_) {
+                retiredRouting_.push_back(std::move(routingCtl_));
+            }
+            routingCtl_ = std::move(next);
+            reclaimRetiredRouting_();
+            return true;
+        }
+
+        /**
+         * setAuxBusCount / addAuxModule
+         *
+         * Aux return-шины: одна FX-цепочка (reverb/delay) на весь микс вместо
+         * копии в каждом треке. Трек посылает в шину свой выход с уровнем
+         * ITrack::auxSendLevel(bus) (ParamBridge/RtCommand ParamSet, TrackParamId::AuxSendA..D),
+         * результат цепочки шины суммируется в master.
+         *
+         * Цепочки публикуются неизменяемыми снапшотами (как FX-цепочка ClipTrack),
+         * поэтому шины и модули можно добавлять при работающем стриме.
+         * В режиме графа (setRoutingGraph) шины не используются: общие FX там — Module-узлы.
+         */
+        bool setAuxBusCount(uint32_t buses) override {
+            if (buses > kMaxAuxBuses) {
+                return false;
+            }
+            const std::lock_guard<std::mutex> lock(auxMutex_);
+            if (buses > 0 && auxBuffers_.empty()) {
+                // Выделяем сразу под все шины: после публикации буферы не переаллоцируются.
+                auxBuffers_.assign(static_cast<std::size_t>(kMaxAuxBuses) * 2u * kTrackBusChannels * kTrackBusFrames,
+                                   0.0f);
+            }
+            auxBusCountCtl_ = buses;
+            publishAuxLocked_();
+            return true;
+        }
+
+        bool addAuxModule(uint32_t bus, std::unique_ptr<IAudioModule> module) override {
+            if (!module) {
+                return false;
+            }
+            const std::lock_guard<std::mutex> lock(auxMutex_);
+            if (bus >= auxBusCountCtl_) {
+                return false;
+            }
+            module->init(sampleRate_, kTrackBusFrames);
+            auxChainsCtl_[bus].push_back(std::shared_ptr<IAudioModule>(std::move(module)));
+            publishAuxLocked_();
+            return true;
+        }
+
+        IAudioModule* getAuxModule(uint32_t bus, std::size_t index) override {
+            const AuxSnapshot* aux = auxRt_.load(std::memory_order_acquire);
+            if (!aux || bus >= aux->busCount || index >= aux->chains[bus].size()) {
+                return nullptr;
+            }
+            return aux->chains[bus][index].get();
+        }
+
+        /**
+         * setMasterLimiter
+         *
+         * Мастер-шина: lookahead-лимитер после треков, aux-возвратов и RT-эпилогов
+         * (метроном), перед записью master out. Вместо жесткого клипа в хосте —
+         * плавное ограничение без овершута; цена — задержка мастера на lookahead-1 сэмпл.
+         *
+         * Вызывать ВНЕ RT (до старта стрима): линии задержки выделяются здесь.
+         */
+        bool setMasterLimiter(const MasterLimiterConfig& cfg) override {
+            limiterCfg_ = cfg;
+            if (!cfg.enabled) {
+                limiterEnabled_ = false;
+                return true;
+            }
+            if (!(cfg.lookaheadMs > 0.0f) || !(cfg.ceiling > 0.0f) || !(cfg.releaseMs > 0.0f)) {
+                return false;
+            }
+            prepareLimiter_();
+            limiterEnabled_ = true;
+            return true;
+        }
+
+        const EngineMeterFrame* readMeters() noexcept override {
+            return &meters_.read();
+        }
+
+        void captureDspLoad(DspLoadCapture& out) const override {
+            loadProfiler_.capture(out);
         }
 
         void setSampleRate(double sr) override {
             sampleRate_ = sr;
+            if (limiterCfg_.enabled) {
+                prepareLimiter_();
+            }
+            // Вне RT (до старта): aux-модули и модули графа переинициализируем под новую частоту.
+            if (routingCtl_ && routingCtl_->graph) {
+                routingCtl_->graph->initModules(sampleRate_);
+            }
+            const std::lock_guard<std::mutex> lock(auxMutex_);
+            for (auto& chain : auxChainsCtl_) {
+                for (auto& m : chain) {
+                    m->init(sampleRate_, kTrackBusFrames);
+                }
+            }
         }
 
         void setAudioHost(std::shared_ptr<void> host) noexcept override {
@@ -99,10 +284,15 @@ namespace avantgarde {
         void processBlock(const AudioProcessContext& ctx) override {
             // Локальная копия контекста: в нее движок вкладывает transport snapshot
             // текущего блока, после чего эта же структура уходит во все RT-узлы.
+            const uint64_t blockT0 = DspLoadProfiler::nowTicks();
             AudioProcessContext rtCtx = ctx;
             if (rtCtx.numOut == 0) {
                 rtCtx.numOut = numOut_;
             }
+            EngineMeterFrame& meters = meters_.writeSlot();
+            meters.trackCount = 0;
+            meters.limiterGain = 1.0f;
+
             // 0) очистка master out перед миксом
             // (по контракту ctx.out должен быть валидным, но можно добавить guard если хочешь)
             const uint32_t clearOut = std::min<uint32_t>(numOut_, rtCtx.numOut);
@@ -153,7 +343,10 @@ namespace avantgarde {
 
             // 4) RT extensions — пролог блока (секвенсор/квантизация генерят события)
             for (uint32_t i = 0; i < rtExtCount_; ++i) {
+                const uint64_t t0 = DspLoadProfiler::nowTicks();
                 rtExt_[i]->onBlockBegin(rtCtx);
+                loadProfiler_.recordRt(DspLoadProfiler::siteOf(DspLoadSiteKind::RtExtBegin, i),
+                                       DspLoadProfiler::nowTicks() - t0);
             }
 
             // 4.5) Второй drain: применяем команды, которые extensions могли запушить в rtQueue_
@@ -163,13 +356,56 @@ namespace avantgarde {
             }
 
             // 5) Треки: генерят/миксят в ctx.out
-            for (auto& t : tracks_) {
-                t->process(rtCtx);
+            //    (через скомпилированный граф, либо через собственные шины треков —
+            //    на воркерах, если они есть, — с детерминированной суммой;
+            //    прямой последовательный микс — только если блок не влезает в шины).
+            //    Aux-шины и метры треков снимаются с шин треков.
+            CompiledAudioGraph* graph = acquireRoutingRt_();
+            const AuxSnapshot* aux = acquireAuxRt_();
+            const uint32_t auxBuses = (aux && canUseTrackBuses_(rtCtx)) ? aux->busCount : 0u;
+            // Render-ahead живет только в пути шин: для графа и больших блоков забираем
+            // все треки; кто еще занят воркером, в этом блоке рендерится через шины (молчит).
+            const bool graphReady = graph && graph->canProcess(rtCtx, trackPtrs_.size());
+            bool aheadClear = true;
+            if (graphReady || !canUseTrackBuses_(rtCtx)) {
+                aheadClear = renderAhead_.revokeAllRt();
+            } else {
+                renderAhead_.syncRt(rtCtx);
+            }
+            if (graphReady && aheadClear) {
+                graph->process(rtCtx, trackPtrs_.data(), &loadProfiler_);
+            } else if (canUseTrackBuses_(rtCtx) && isIdleRt_(aux, auxBuses)) {
+                // Idle: ни один трек ничего не выдаст, хвосты aux-цепочек затухли —
+                // без диспетчеризации на воркеры, очистки шин и сумм. Выход уже обнулен.
+                meters.trackCount = static_cast<uint32_t>(std::min<std::size_t>(tracks_.size(), kMaxMeterTracks));
+                for (uint32_t t = 0; t < meters.trackCount; ++t) {
+                    meters.tracks[t] = LevelMeter{};
+                }
+            } else if (canUseTrackBuses_(rtCtx)) {
+                // Шины треков нужны и для метров: метр снимается в том же проходе, что и сумма.
+                renderTrackBuses_(rtCtx, auxBuses, meters);
+                if (auxBuses > 0) {
+                    processAuxBusesRt_(rtCtx, *aux);
+                }
+            } else {
+                for (std::size_t t = 0; t < tracks_.size(); ++t) {
+                    if (renderAhead_.ownedByWorkerRt(static_cast<uint32_t>(t))) {
+                        continue;
+                    }
+                    loadProfiler_.processTrackRt(*tracks_[t], static_cast<uint32_t>(t), rtCtx);
+                }
+            }
+            // 5.5) Треки, которые снова никто не трогает, отдаем воркеру render-ahead.
+            if (!graphReady && canUseTrackBuses_(rtCtx)) {
+                renderAhead_.armRt(rtCtx);
             }
 
             // 6) RT extensions — эпилог блока
             for (uint32_t i = 0; i < rtExtCount_; ++i) {
+                const uint64_t t0 = DspLoadProfiler::nowTicks();
                 rtExt_[i]->onBlockEnd(rtCtx);
+                loadProfiler_.recordRt(DspLoadProfiler::siteOf(DspLoadSiteKind::RtExtEnd, i),
+                                       DspLoadProfiler::nowTicks() - t0);
             }
 
             // 6.5) Продвигаем transport sampleTime только в режиме PLAY.
@@ -182,18 +418,311 @@ namespace avantgarde {
                 }
             }
 
+            // 6.7) Мастер-шина: лимитер и метры (после метронома, перед записью).
+            const uint64_t masterT0 = DspLoadProfiler::nowTicks();
+            processMasterBusRt_(rtCtx, meters);
+            loadProfiler_.recordRt(DspLoadProfiler::siteOf(DspLoadSiteKind::MasterBus),
+                                   DspLoadProfiler::nowTicks() - masterT0);
+            meters.blockIndex = ++blockIndex_;
+            meters_.publish();
+
             // 7) Запись master out (если подключен sink)
             if (masterSink_) {
                 (void)masterSink_->writeBlock(rtCtx.out, static_cast<int>(rtCtx.nframes));
             }
+
+            // 8) Профиль: блок целиком (включая drain команд и запись).
+            loadProfiler_.recordRt(DspLoadProfiler::siteOf(DspLoadSiteKind::Block),
+                                   DspLoadProfiler::nowTicks() - blockT0);
         }
 
     private:
+        // Неизменяемый снапшот aux-цепочек, который читает RT (как FxChainSnapshot в ClipTrack).
+        struct AuxSnapshot {
+            uint64_t generation{0};
+            uint32_t busCount{0};
+            std::array<std::vector<std::shared_ptr<IAudioModule>>, kMaxAuxBuses> chains{};
+        };
+
+        bool canUseTrackBuses_(const AudioProcessContext& ctx) const noexcept {
+            return ctx.out != nullptr &&
+                   ctx.nframes <= kTrackBusFrames &&
+                   ctx.numOut <= kTrackBusChannels;
+        }
+
+        // Рендер каждого трека в свою шину (на воркерах, если они есть),
+        // затем сумма в master и посылы в первые auxBuses aux-шин.
+        void renderTrackBuses_(const AudioProcessContext& ctx, uint32_t auxBuses, EngineMeterFrame& meters) noexcept {
+            blockCtx_ = ctx;
+            workerPool_.parallelFor(&AudioEngine::renderTrackTask_, this,
+                                    static_cast<uint32_t>(tracks_.size()));
+
+            const std::size_t n = ctx.nframes;
+            for (uint32_t a = 0; a < auxBuses; ++a) {
+                for (uint32_t ch = 0; ch < kTrackBusChannels; ++ch) {
+                    std::memset(auxChannel_(a, 0, ch), 0, n * sizeof(float));
+                }
+            }
+
+            // Финальная сумма строго в порядке регистрации треков:
+            // тот же порядок сложений, что и в последовательном пути.
+            // Метр трека (peak/RMS, стерео-связанный) считается в том же векторном проходе.
+            const std::size_t metered = std::min<std::size_t>(tracks_.size(), kMaxMeterTracks);
+            meters.trackCount = static_cast<uint32_t>(metered);
+            for (std::size_t t = 0; t < tracks_.size(); ++t) {
+                const float* bus = trackBuses_[t].data();
+                float peak = 0.0f;
+                float sumSq = 0.0f;
+                for (uint32_t ch = 0; ch < ctx.numOut; ++ch) {
+                    float* dst = ctx.out[ch];
+                    if (!dst) continue;
+                    const float* src = bus + static_cast<std::size_t>(ch) * kTrackBusFrames;
+                    clip_kernel::mixAddMeter(dst, src, n, peak, sumSq);
+                }
+                if (t < metered) {
+                    meters.tracks[t] = meterFrom_(peak, sumSq, n * ctx.numOut);
+                }
+                for (uint32_t a = 0; a < auxBuses; ++a) {
+                    const float send = tracks_[t]->auxSendLevel(a);
+                    if (!(send > 0.0f)) continue;
+                    for (uint32_t ch = 0; ch < ctx.numOut; ++ch) {
+                        float* dst = auxChannel_(a, 0, ch);
+                        const float* src = bus + static_cast<std::size_t>(ch) * kTrackBusFrames;
+                        for (std::size_t i = 0; i < n; ++i) {
+                            dst[i] += send * src[i];
+                        }
+                    }
+                }
+            }
+        }
+
+        static LevelMeter meterFrom_(float peak, float sumSq, std::size_t samples) noexcept {
+            LevelMeter m{};
+            m.peak = peak;
+            m.rms = (samples > 0) ? std::sqrt(sumSq / static_cast<float>(samples)) : 0.0f;
+            return m;
+        }
+
+        void prepareLimiter_() {
+            const double sr = (sampleRate_ > 1.0) ? sampleRate_ : 48000.0;
+            const auto lookahead = static_cast<uint32_t>(
+                std::max(1.0, std::round(static_cast<double>(limiterCfg_.lookaheadMs) * 0.001 * sr)));
+            limiter_.prepare(sr, lookahead, limiterCfg_.ceiling, limiterCfg_.releaseMs);
+        }
+
+        // RT. Лимитер (стерео-связанный, первые 2 канала) и метры мастера.
+        void processMasterBusRt_(const AudioProcessContext& ctx, EngineMeterFrame& meters) noexcept {
+            const uint32_t chs = (ctx.out != nullptr) ? std::min<uint32_t>(ctx.numOut, 2u) : 0u;
+            bool outValid = chs > 0;
+            for (uint32_t ch = 0; ch < chs; ++ch) {
+                outValid = outValid && ctx.out[ch] != nullptr;
+            }
+            if (!outValid) {
+                meters.master[0] = LevelMeter{};
+                meters.master[1] = LevelMeter{};
+                return;
+            }
+            if (limiterEnabled_) {
+                meters.limiterGain = limiter_.process(ctx.out, chs, ctx.nframes);
+            }
+            for (uint32_t ch = 0; ch < 2u; ++ch) {
+                // Моно-выход: правый метр повторяет левый.
+                const float* src = ctx.out[std::min(ch, chs - 1u)];
+                float peak = 0.0f;
+                float sumSq = 0.0f;
+                clip_kernel::accumulateMeter(src, ctx.nframes, peak, sumSq);
+                meters.master[ch] = meterFrom_(peak, sumSq, ctx.nframes);
+            }
+        }
+
+        // RT. Блок можно не рендерить: каждый трек idle (опрос применяет его отложенные
+        // обновления) и хвосты aux-цепочек гарантированно затухли.
+        bool isIdleRt_(const AuxSnapshot* aux, uint32_t auxBuses) noexcept {
+            for (std::size_t t = 0; t < tracks_.size(); ++t) {
+                // Трек у воркера render-ahead играет (и его нельзя опрашивать).
+                if (renderAhead_.ownedByWorkerRt(static_cast<uint32_t>(t)) || !tracks_[t]->isIdleRt()) {
+                    return false;
+                }
+            }
+            if (!aux) {
+                return true;
+            }
+            syncAuxQuietRt_(*aux);
+            for (uint32_t a = 0; a < auxBuses; ++a) {
+                if (auxQuietFramesRt_[a] < chainTailFrames_(aux->chains[a])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Сумма хвостов модулей цепочки (насыщающая); kInfiniteTailFrames -> UINT64_MAX.
+        static uint64_t chainTailFrames_(const std::vector<std::shared_ptr<IAudioModule>>& chain) noexcept {
+            uint64_t total = 0;
+            for (const auto& mod : chain) {
+                const uint32_t tail = mod->tailFrames();
+                if (tail == IAudioModule::kInfiniteTailFrames || total > UINT64_MAX - tail) {
+                    return UINT64_MAX;
+                }
+                total += tail;
+            }
+            return total;
+        }
+
+        // Новое поколение aux-снапшота: состояние цепочек могло смениться — счет тишины заново.
+        void syncAuxQuietRt_(const AuxSnapshot& aux) noexcept {
+            if (aux.generation != auxQuietGenRt_) {
+                auxQuietGenRt_ = aux.generation;
+                auxQuietFramesRt_.fill(0);
+            }
+        }
+
+        // FX-цепочки aux-шин (ping-pong между двумя буферами шины) и возврат в master.
+        // Цепочка крутится и без посылов в этом блоке — хвосты reverb/delay должны дозвучать;
+        // пропускается, только когда вход шины тих дольше хвоста цепочки.
+        void processAuxBusesRt_(const AudioProcessContext& ctx, const AuxSnapshot& aux) noexcept {
+            syncAuxQuietRt_(aux);
+            for (uint32_t a = 0; a < aux.busCount; ++a) {
+                const uint64_t busT0 = DspLoadProfiler::nowTicks();
+                bool quietIn = true;
+                for (uint32_t ch = 0; ch < kTrackBusChannels && quietIn; ++ch) {
+                    const float* in = auxChannel_(a, 0, ch);
+                    for (std::size_t i = 0; i < ctx.nframes; ++i) {
+                        if (std::fabs(in[i]) >= IAudioModule::kSilenceLevel) {
+                            quietIn = false;
+                            break;
+                        }
+                    }
+                }
+                const uint64_t quietBefore = auxQuietFramesRt_[a];
+                auxQuietFramesRt_[a] = !quietIn ? 0U
+                                       : (quietBefore > UINT64_MAX - ctx.nframes) ? UINT64_MAX
+                                                                                  : quietBefore + ctx.nframes;
+                if (quietIn && quietBefore >= chainTailFrames_(aux.chains[a])) {
+                    loadProfiler_.recordRt(DspLoadProfiler::siteOf(DspLoadSiteKind::AuxBus, a),
+                                           DspLoadProfiler::nowTicks() - busT0);
+                    continue;
+                }
+                uint32_t side = 0;
+                for (const auto& mod : aux.chains[a]) {
+                    const float* inPtrs[kTrackBusChannels]{};
+                    float* outPtrs[kTrackBusChannels]{};
+                    for (uint32_t ch = 0; ch < kTrackBusChannels; ++ch) {
+                        inPtrs[ch] = auxChannel_(a, side, ch);
+                        outPtrs[ch] = auxChannel_(a, side ^ 1u, ch);
+                    }
+                    AudioProcessContext modCtx = ctx;
+                    modCtx.in = inPtrs;
+                    modCtx.out = outPtrs;
+                    modCtx.numOut = kTrackBusChannels;
+                    mod->process(modCtx);
+                    side ^= 1u;
+                }
+                for (uint32_t ch = 0; ch < ctx.numOut; ++ch) {
+                    float* dst = ctx.out[ch];
+                    if (!dst) continue;
+                    const float* src = auxChannel_(a, side, ch);
+                    for (std::size_t i = 0; i < ctx.nframes; ++i) {
+                        dst[i] += src[i];
+                    }
+                }
+                loadProfiler_.recordRt(DspLoadProfiler::siteOf(DspLoadSiteKind::AuxBus, a),
+                                       DspLoadProfiler::nowTicks() - busT0);
+            }
+        }
+
+        // [bus][side][channel][kTrackBusFrames]
+        float* auxChannel_(uint32_t bus, uint32_t side, uint32_t ch) noexcept {
+            return auxBuffers_.data() +
+                   ((static_cast<std::size_t>(bus) * 2u + side) * kTrackBusChannels + ch) * kTrackBusFrames;
+        }
+
+        // control thread only, под auxMutex_.
+        void publishAuxLocked_() {
+            auto next = std::make_unique<AuxSnapshot>();
+            next->generation = ++auxGenCtl_;
+            next->busCount = auxBusCountCtl_;
+            next->chains = auxChainsCtl_;
+            auxRt_.store(next.get(), std::memory_order_release);
+            if (auxCtl_) {
+                retiredAux_.push_back(std::move(auxCtl_));
+            }
+            auxCtl_ = std::move(next);
+            const uint64_t rtGen = rtAuxGen_.load(std::memory_order_acquire);
+            retiredAux_.erase(
+                std::remove_if(retiredAux_.begin(),
+                               retiredAux_.end(),
+                               [rtGen](const std::unique_ptr<AuxSnapshot>& a) {
+                                   return a->generation < rtGen;
+                               }),
+                retiredAux_.end());
+        }
+
+        const AuxSnapshot* acquireAuxRt_() noexcept {
+            const AuxSnapshot* aux = auxRt_.load(std::memory_order_acquire);
+            if (aux) {
+                rtAuxGen_.store(aux->generation, std::memory_order_release);
+            }
+            return aux;
+        }
+
+        // RT: текущее опубликованное расписание графа; подтверждаем его поколение.
+        CompiledAudioGraph* acquireRoutingRt_() noexcept {
+            RoutingSnapshot* snap = routingRt_.load(std::memory_order_acquire);
+            if (!snap) {
+                return nullptr;
+            }
+            rtRoutingGen_.store(snap->generation, std::memory_order_release);
+            return snap->graph.get();
+        }
+
+        // Вне RT. Снимки с generation < rtRoutingGen_ RT уже никогда не прочитает.
+        void reclaimRetiredRouting_() {
+            const uint64_t rtGen = rtRoutingGen_.load(std::memory_order_acquire);
+            retiredRouting_.erase(
+                std::remove_if(retiredRouting_.begin(),
+                               retiredRouting_.end(),
+                               [rtGen](const std::unique_ptr<RoutingSnapshot>& r) {
+                                   return r->generation < rtGen;
+                               }),
+                retiredRouting_.end());
+        }
+
+        // Выполняется на воркере или на аудио-нити; трогает только свой трек и свою шину.
+        static void renderTrackTask_(void* user, uint32_t index) noexcept {
+            auto* self = static_cast<AudioEngine*>(user);
+            const AudioProcessContext& ctx = self->blockCtx_;
+            float* bus = self->trackBuses_[index].data();
+
+            float* outPtrs[kTrackBusChannels]{};
+            for (uint32_t ch = 0; ch < ctx.numOut; ++ch) {
+                outPtrs[ch] = bus + static_cast<std::size_t>(ch) * kTrackBusFrames;
+                std::memset(outPtrs[ch], 0, ctx.nframes * sizeof(float));
+            }
+            AudioProcessContext trackCtx = ctx;
+            trackCtx.out = outPtrs;
+            if (self->renderAhead_.readRt(index, trackCtx)) {
+                return;
+            }
+            self->loadProfiler_.processTrackRt(*self->tracks_[index], index, trackCtx);
+        }
+
         // Минимальная RT-обработка команд: зарезервировано под транспорт/квантизацию.
         void handleRtCommand(const RtCommand& rc) noexcept {
             const int t = rc.track;
+            uint32_t auxBus = 0;
             if (t >= 0 && static_cast<std::size_t>(t) < tracks_.size()) {
-                tracks_[t]->onRtCommand(rc); // RT-чисто, без аллокаций
+                // Трек у воркера render-ahead: команда заберет его обратно (или дождется этого).
+                if (renderAhead_.admitCommandRt(static_cast<uint32_t>(t), rc)) {
+                    tracks_[t]->onRtCommand(rc); // RT-чисто, без аллокаций
+                }
+            } else if (fromRtAuxTrack(t, auxBus)) {
+                // ParamSet в FX-слот aux-шины (value нормализован, как у FX трека).
+                if (fromWireCmdId(rc.id) == CmdId::ParamSet && rc.slot >= 0) {
+                    if (IAudioModule* mod = getAuxModule(auxBus, static_cast<std::size_t>(rc.slot))) {
+                        mod->setParam(rc.index, std::clamp(rc.value, 0.0f, 1.0f));
+                    }
+                }
             } else {
                 // Глобальные transport-команды прокидываем всем трекам, которым это важно
                 // (например, auto stretch-to-bars в ClipTrack).
@@ -203,8 +732,10 @@ namespace avantgarde {
                         id == CmdId::SetTimeSig ||
                         id == CmdId::Play ||
                         id == CmdId::Stop) {
-                        for (auto& tr : tracks_) {
-                            tr->onRtCommand(rc);
+                        for (std::size_t i = 0; i < tracks_.size(); ++i) {
+                            if (renderAhead_.admitCommandRt(static_cast<uint32_t>(i), rc)) {
+                                tracks_[i]->onRtCommand(rc);
+                            }
                         }
                     }
                 }
@@ -214,6 +745,7 @@ namespace avantgarde {
     private:
         uint32_t numOut_{2};
         static constexpr uint32_t kMaxRtExtensions = 8;
+        static_assert(kMaxRtExtensions <= DspLoadProfiler::kMaxRtExtensions, "every RT extension needs a profiler site");
 
         std::vector<std::unique_ptr<ITrack>> tracks_; // “DSP-юниты”, которые в RT генерируют/миксят звук в master буфер.
         IRtCommandQueue* rtQueue_{nullptr};           // почта команд Control→RT.
@@ -229,6 +761,58 @@ namespace avantgarde {
 
         // NEW: мастер-синк для записи (не владеем)
         IRtRecordSink* masterSink_{nullptr};
+
+        // Параллельный рендер треков.
+        static constexpr uint32_t kTrackBusChannels = 2;
+        static constexpr std::size_t kTrackBusFrames = 4096;
+        // Чуть ниже типичного приоритета аудио-нити ALSA/JACK.
+        static constexpr int kRenderWorkerRtPriority = 70;
+        // Render-ahead ниже и аудио-нити, и воркеров блока: он заполняет кольца в паузах.
+        static constexpr int kRenderAheadRtPriority = 40;
+        RtWorkerPool workerPool_{};
+        // Предвыделенные шины треков: [channel][kTrackBusFrames], индекс = индекс трека.
+        std::vector<std::vector<float>> trackBuses_{};
+        // Контекст текущего блока для задач воркеров (валиден только внутри parallelFor).
+        AudioProcessContext blockCtx_{};
+        // Кольца render-ahead; объявлены после tracks_ — нить воркера гасится раньше треков.
+        RenderAheadPool renderAhead_{};
+
+        // Маршрутизация через граф: неизменяемые снимки расписания (как FX-цепочка ClipTrack).
+        struct RoutingSnapshot {
+            uint64_t generation{0};
+            std::unique_ptr<CompiledAudioGraph> graph{}; // nullptr — фиксированная маршрутизация
+        };
+        std::vector<ITrack*> trackPtrs_{};                    // для расписания: индекс = индекс трека
+        std::unique_ptr<RoutingSnapshot> routingCtl_{};
+        std::vector<std::unique_ptr<RoutingSnapshot>> retiredRouting_{};
+        std::atomic<RoutingSnapshot*> routingRt_{nullptr};
+        std::atomic<uint64_t> rtRoutingGen_{0};
+        uint64_t routingGenCtl_{0};
+
+        // Aux return-шины.
+        std::mutex auxMutex_{};
+        uint32_t auxBusCountCtl_{0};
+        std::array<std::vector<std::shared_ptr<IAudioModule>>, kMaxAuxBuses> auxChainsCtl_{};
+        std::unique_ptr<AuxSnapshot> auxCtl_{};
+        std::vector<std::unique_ptr<AuxSnapshot>> retiredAux_{};
+        std::atomic<const AuxSnapshot*> auxRt_{nullptr};
+        std::atomic<uint64_t> rtAuxGen_{0};
+        uint64_t auxGenCtl_{0};
+        // Вход/ping-pong буферы шин: [bus][side][channel][kTrackBusFrames], side 0 — сумма посылов.
+        std::vector<float> auxBuffers_{};
+        // Детектор тишины на входе aux-шин (RT-only): кадров подряд ниже kSilenceLevel.
+        std::array<uint64_t, kMaxAuxBuses> auxQuietFramesRt_{};
+        uint64_t auxQuietGenRt_{0};
+
+        // Мастер-шина.
+        MasterLimiterConfig limiterCfg_{};
+        bool limiterEnabled_{false};
+        LookaheadLimiter limiter_{};
+        // Метры: пишет только RT (конец блока), читает один UI-поток.
+        TripleBuffer<EngineMeterFrame> meters_{};
+        uint64_t blockIndex_{0};
+        // Профиль DSP-нагрузки: у каждого узла один писатель (аудио-нить или воркер его трека).
+        DspLoadProfiler loadProfiler_{};
     };
 
 // Фабрика (без отдельного заголовка; тесты объявляют её как extern)
@@ -0,0 +1,271 @@
+#include "runtime/AudioGraph.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace avantgarde {
+
+namespace {
+
+bool nodeLess(const GraphNodeDesc& a, const GraphNodeDesc& b) noexcept {
+    return a.id < b.id;
+}
+
+bool edgeLess(const GraphEdgeDesc& a, const GraphEdgeDesc& b) noexcept {
+    return (a.fromId != b.fromId) ? (a.fromId < b.fromId) : (a.toId < b.toId);
+}
+
+bool edgeEq(const GraphEdgeDesc& a, const GraphEdgeDesc& b) noexcept {
+    return a.fromId == b.fromId && a.toId == b.toId;
+}
+
+std::size_t indexOf(const std::vector<GraphNodeDesc>& nodes, NodeId id) noexcept {
+    const auto it = std::lower_bound(nodes.begin(), nodes.end(), GraphNodeDesc{id, 0, 0}, nodeLess);
+    if (it == nodes.end() || it->id != id) {
+        return nodes.size();
+    }
+    return static_cast<std::size_t>(it - nodes.begin());
+}
+
+} // namespace
+
+AudioGraph::AudioGraph() {
+    nodes_.reserve(kMaxNodes);
+}
+
+bool AudioGraph::validate(const std::vector<GraphNodeDesc>& nodes,
+                          const std::vector<GraphEdgeDesc>& edges) noexcept {
+    // Ожидаем уже отсортированные массивы (apply_ сортирует до вызова).
+    if (nodes.size() > kMaxNodes) {
+        return false;
+    }
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].paramCount > kMaxParamsPerNode) {
+            return false;
+        }
+        if (i > 0 && nodes[i - 1].id == nodes[i].id) {
+            return false;
+        }
+    }
+
+    // Kahn по фиксированным массивам: n <= kMaxNodes, без аллокаций.
+    std::uint16_t indegree[kMaxNodes]{};
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        const GraphEdgeDesc& e = edges[i];
+        if (e.fromId == e.toId) {
+            return false;
+        }
+        if (i > 0 && edgeEq(edges[i - 1], e)) {
+            return false;
+        }
+        const std::size_t from = indexOf(nodes, e.fromId);
+        const std::size_t to = indexOf(nodes, e.toId);
+        if (from == nodes.size() || to == nodes.size()) {
+            return false;
+        }
+        ++indegree[to];
+    }
+
+    std::uint16_t queue[kMaxNodes]{};
+    std::size_t head = 0;
+    std::size_t tail = 0;
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (indegree[i] == 0) {
+            queue[tail++] = static_cast<std::uint16_t>(i);
+        }
+    }
+    std::size_t visited = 0;
+    while (head < tail) {
+        const NodeId id = nodes[queue[head++]].id;
+        ++visited;
+        // Ребра отсортированы по fromId — исходящие из id лежат одним диапазоном.
+        auto it = std::lower_bound(edges.begin(), edges.end(), GraphEdgeDesc{id, 0}, edgeLess);
+        for (; it != edges.end() && it->fromId == id; ++it) {
+            const std::size_t to = indexOf(nodes, it->toId);
+            if (--indegree[to] == 0) {
+                queue[tail++] = static_cast<std::uint16_t>(to);
+            }
+        }
+    }
+    return visited == nodes.size();
+}
+
+bool AudioGraph::getTopology(GraphTopoView& view) const noexcept {
+    if (!view.nodeCount || !view.edgeCount) {
+        return false;
+    }
+    if (*view.nodeCount < nodes_.size() || *view.edgeCount < edges_.size()) {
+        return false;
+    }
+    if ((!nodes_.empty() && !view.nodes) || (!edges_.empty() && !view.edges)) {
+        return false;
+    }
+    std::copy(nodes_.begin(), nodes_.end(), view.nodes);
+    std::copy(edges_.begin(), edges_.end(), view.edges);
+    *view.nodeCount = static_cast<std::uint16_t>(nodes_.size());
+    *view.edgeCount = static_cast<std::uint16_t>(edges_.size());
+    return true;
+}
+
+bool AudioGraph::setTopology(const GraphTopoView& view) noexcept {
+    if (!view.nodeCount || !view.edgeCount) {
+        return false;
+    }
+    const std::size_t nn = *view.nodeCount;
+    const std::size_t ne = *view.edgeCount;
+    if ((nn > 0 && !view.nodes) || (ne > 0 && !view.edges) || nn > kMaxNodes) {
+        return false;
+    }
+    try {
+        std::vector<GraphNodeDesc> nodes(view.nodes, view.nodes + nn);
+        std::vector<GraphEdgeDesc> edges(view.edges, view.edges + ne);
+        return apply_(std::move(nodes), std::move(edges));
+    } catch (...) {
+        return false;
+    }
+}
+
+bool AudioGraph::addNode(const GraphNodeDesc& nd) noexcept {
+    try {
+        std::vector<GraphNodeDesc> nodes = nodes_;
+        nodes.push_back(nd);
+        return apply_(std::move(nodes), edges_);
+    } catch (...) {
+        return false;
+    }
+}
+
+bool AudioGraph::removeNode(NodeId id) noexcept {
+    if (!hasNode_(id)) {
+        return false;
+    }
+    try {
+        std::vector<GraphNodeDesc> nodes;
+        nodes.reserve(nodes_.size());
+        for (const auto& n : nodes_) {
+            if (n.id != id) {
+                nodes.push_back(n);
+            }
+        }
+        // Вместе с узлом уходят все его ребра.
+        std::vector<GraphEdgeDesc> edges;
+        edges.reserve(edges_.size());
+        for (const auto& e : edges_) {
+            if (e.fromId != id && e.toId != id) {
+                edges.push_back(e);
+            }
+        }
+        return apply_(std::move(nodes), std::move(edges));
+    } catch (...) {
+        return false;
+    }
+}
+
+bool AudioGraph::addEdge(const GraphEdgeDesc& e) noexcept {
+    try {
+        std::vector<GraphEdgeDesc> edges = edges_;
+        edges.push_back(e);
+        return apply_(nodes_, std::move(edges));
+    } catch (...) {
+        return false;
+    }
+}
+
+bool AudioGraph::removeEdge(NodeId fromId, NodeId toId) noexcept {
+    const GraphEdgeDesc key{fromId, toId};
+    const auto it = std::lower_bound(edges_.begin(), edges_.end(), key, edgeLess);
+    if (it == edges_.end() || !edgeEq(*it, key)) {
+        return false;
+    }
+    edges_.erase(it);
+    return true;
+}
+
+bool AudioGraph::nodeTrackIndex(NodeId id, std::uint32_t& outIndex) const noexcept {
+    const Binding* b = findBinding_(id);
+    if (!b || !b->hasTrack) {
+        return false;
+    }
+    outIndex = b->trackIndex;
+    return true;
+}
+
+std::shared_ptr<IAudioModule> AudioGraph::nodeModule(NodeId id) const noexcept {
+    const Binding* b = findBinding_(id);
+    return b ? b->module : nullptr;
+}
+
+bool AudioGraph::bindTrack(NodeId id, std::uint32_t trackIndex) noexcept {
+    if (!hasNode_(id)) {
+        return false;
+    }
+    try {
+        Binding* b = ensureBinding_(id);
+        b->hasTrack = true;
+        b->trackIndex = trackIndex;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool AudioGraph::bindModule(NodeId id, std::shared_ptr<IAudioModule> module) noexcept {
+    if (!hasNode_(id)) {
+        return false;
+    }
+    try {
+        ensureBinding_(id)->module = std::move(module);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool AudioGraph::apply_(std::vector<GraphNodeDesc> nodes, std::vector<GraphEdgeDesc> edges) noexcept {
+    std::sort(nodes.begin(), nodes.end(), nodeLess);
+    std::sort(edges.begin(), edges.end(), edgeLess);
+    if (!validate(nodes, edges)) {
+        return false;
+    }
+    nodes_.swap(nodes);
+    edges_.swap(edges);
+    // Привязки исчезнувших узлов больше не нужны (и не должны "ожить" при повторном id).
+    bindings_.erase(std::remove_if(bindings_.begin(), bindings_.end(),
+                                   [this](const Binding& b) { return !hasNode_(b.id); }),
+                    bindings_.end());
+    return true;
+}
+
+bool AudioGraph::hasNode_(NodeId id) const noexcept {
+    return indexOf(nodes_, id) != nodes_.size();
+}
+
+AudioGraph::Binding* AudioGraph::findBinding_(NodeId id) noexcept {
+    for (auto& b : bindings_) {
+        if (b.id == id) {
+            return &b;
+        }
+    }
+    return nullptr;
+}
+
+const AudioGraph::Binding* AudioGraph::findBinding_(NodeId id) const noexcept {
+    for (const auto& b : bindings_) {
+        if (b.id == id) {
+            return &b;
+        }
+    }
+    return nullptr;
+}
+
+AudioGraph::Binding* AudioGraph::ensureBinding_(NodeId id) {
+    if (Binding* b = findBinding_(id)) {
+        return b;
+    }
+    Binding b{};
+    b.id = id;
+    bindings_.push_back(std::move(b));
+    return &bindings_.back();
+}
+
+} // namespace avantgarde
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "contracts/IAudioGraph.h"
+
+namespace avantgarde {
+
+// Реализация IAudioGraph: хранит и валидирует топологию (вне RT).
+//
+// Узлы и ребра всегда лежат отсортированными (id / (from, to)), поэтому
+// getTopology() отдает детерминированный снимок без дополнительной сортировки.
+// Любая мутация валидируется целиком (см. graph_types.h); невалидная
+// топология не применяется, состояние остается прежним.
+class AudioGraph final : public IAudioGraph {
+public:
+    AudioGraph();
+
+    bool getTopology(GraphTopoView& view) const noexcept override;
+    bool setTopology(const GraphTopoView& view) noexcept override;
+
+    bool addNode(const GraphNodeDesc& nd) noexcept override;
+    bool removeNode(NodeId id) noexcept override;
+    bool addEdge(const GraphEdgeDesc& e) noexcept override;
+    bool removeEdge(NodeId fromId, NodeId toId) noexcept override;
+
+    void bumpRevision() noexcept override { ++revision_; }
+    std::uint64_t revision() const noexcept override { return revision_; }
+
+    bool nodeTrackIndex(NodeId id, std::uint32_t& outIndex) const noexcept override;
+    std::shared_ptr<IAudioModule> nodeModule(NodeId id) const noexcept override;
+
+    // Привязки (вне RT). Узел должен существовать; привязка удаляется вместе с узлом.
+    bool bindTrack(NodeId id, std::uint32_t trackIndex) noexcept;
+    bool bindModule(NodeId id, std::shared_ptr<IAudioModule> module) noexcept;
+
+    std::size_t nodeCount() const noexcept { return nodes_.size(); }
+    std::size_t edgeCount() const noexcept { return edges_.size(); }
+
+    // Полная проверка инвариантов graph_types.h (уникальность, лимиты, ссылки, дубли, DAG).
+    static bool validate(const std::vector<GraphNodeDesc>& nodes,
+                         const std::vector<GraphEdgeDesc>& edges) noexcept;
+
+private:
+    struct Binding {
+        NodeId id{0};
+        bool hasTrack{false};
+        std::uint32_t trackIndex{0};
+        std::shared_ptr<IAudioModule> module{};
+    };
+
+    bool apply_(std::vector<GraphNodeDesc> nodes, std::vector<GraphEdgeDesc> edges) noexcept;
+    bool hasNode_(NodeId id) const noexcept;
+    Binding* findBinding_(NodeId id) noexcept;
+    const Binding* findBinding_(NodeId id) const noexcept;
+    Binding* ensureBinding_(NodeId id);
+
+    std::vector<GraphNodeDesc> nodes_{};
+    std::vector<GraphEdgeDesc> edges_{};
+    std::vector<Binding> bindings_{};
+    std::uint64_t revision_{0};
+};
+
+} // namespace avantgarde
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "contracts/ClipSampleFormat.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AVANTGARDE_CLIP_KERNEL_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AVANTGARDE_CLIP_KERNEL_NEON 1
+#endif
+
+namespace avantgarde {
+
+// ============================================================
+// Векторный cubic-Hermite ресемплер клипа (горячий цикл ClipTrack).
+//
+// Ядро считает "чистый" отрезок: без wrap/конца региона, без phase reset
+// внутри отрезка, все 4 тапа лежат внутри [0, len). Границы, wrap и
+// события обрабатывает вызывающая сторона (ClipTrackImpl::renderClipChunk_).
+//
+// Специализации на этапе компиляции:
+//  - Stereo: моно-клип пишет один результат в оба канала;
+//  - Fade:   линейный fade f_k = (fadeNum0 + fadeStep * k) / fadeDen;
+//  - inc == 1.0: дробная часть постоянна -> 4-тап FIR по непрерывным загрузкам,
+//    а при frac == 0 — просто копия с gain;
+//  - тип хранения S (ClipSampleFormat): float, int16_t (PCM16) или uint16_t (биты half).
+//    16-битные тапы переводятся во float прямо в загрузке (load4/load1), без буфера.
+//
+// Порядок float-операций совпадает со скалярным detail_interp::cubicHermite,
+// чтобы быстрый и скалярный пути давали одинаковый сигнал.
+// ============================================================
+
+    namespace clip_kernel {
+
+#if defined(AVANTGARDE_CLIP_KERNEL_SSE2)
+        using vf4 = __m128;
+        static inline vf4 vload(const float* p) noexcept { return _mm_loadu_ps(p); }
+        static inline void vstore(float* p, vf4 v) noexcept { _mm_storeu_ps(p, v); }
+        static inline vf4 vsplat(float x) noexcept { return _mm_set1_ps(x); }
+        static inline vf4 vset(float a, float b, float c, float d) noexcept { return _mm_setr_ps(a, b, c, d); }
+        static inline vf4 vadd(vf4 a, vf4 b) noexcept { return _mm_add_ps(a, b); }
+        static inline vf4 vsub(vf4 a, vf4 b) noexcept { return _mm_sub_ps(a, b); }
+        static inline vf4 vmul(vf4 a, vf4 b) noexcept { return _mm_mul_ps(a, b); }
+        static inline vf4 vmax(vf4 a, vf4 b) noexcept { return _mm_max_ps(a, b); }
+        static inline vf4 vabs(vf4 a) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+#elif defined(AVANTGARDE_CLIP_KERNEL_NEON)
+        using vf4 = float32x4_t;
+        static inline vf4 vload(const float* p) noexcept { return vld1q_f32(p); }
+        static inline void vstore(float* p, vf4 v) noexcept { vst1q_f32(p, v); }
+        static inline vf4 vsplat(float x) noexcept { return vdupq_n_f32(x); }
+        static inline vf4 vset(float a, float b, float c, float d) noexcept {
+            const float tmp[4] = {a, b, c, d};
+            return vld1q_f32(tmp);
+        }
+        static inline vf4 vadd(vf4 a, vf4 b) noexcept { return vaddq_f32(a, b); }
+        static inline vf4 vsub(vf4 a, vf4 b) noexcept { return vsubq_f32(a, b); }
+        static inline vf4 vmul(vf4 a, vf4 b) noexcept { return vmulq_f32(a, b); }
+        static inline vf4 vmax(vf4 a, vf4 b) noexcept { return vmaxq_f32(a, b); }
+        static inline vf4 vabs(vf4 a) noexcept { return vabsq_f32(a); }
+#else
+        // Переносимый фолбэк: та же структура кода, компилятор волен автовекторизовать.
+        struct vf4 { float v[4]; };
+        static inline vf4 vload(const float* p) noexcept { return vf4{{p[0], p[1], p[2], p[3]}}; }
+        static inline void vstore(float* p, vf4 x) noexcept {
+            p[0] = x.v[0]; p[1] = x.v[1]; p[2] = x.v[2]; p[3] = x.v[3];
+        }
+        static inline vf4 vsplat(float x) noexcept { return vf4{{x, x, x, x}}; }
+        static inline vf4 vset(float a, float b, float c, float d) noexcept { return vf4{{a, b, c, d}}; }
+        static inline vf4 vadd(vf4 a, vf4 b) noexcept {
+            return vf4{{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+        }
+        static inline vf4 vsub(vf4 a, vf4 b) noexcept {
+            return vf4{{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+        }
+        static inline vf4 vmul(vf4 a, vf4 b) noexcept {
+            return vf4{{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+        }
+        static inline vf4 vmax(vf4 a, vf4 b) noexcept {
+            return vf4{{a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1],
+                        a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3]}};
+        }
+        static inline vf4 vabs(vf4 a) noexcept {
+            return vf4{{a.v[0] < 0.0f ? -a.v[0] : a.v[0], a.v[1] < 0.0f ? -a.v[1] : a.v[1],
+                        a.v[2] < 0.0f ? -a.v[2] : a.v[2], a.v[3] < 0.0f ? -a.v[3] : a.v[3]}};
+        }
+#endif
+
+        // Загрузка тапов из хранения клипа во float: 4 подряд (load4) и один (load1).
+        // Значения совпадают со скалярными clipSampleFromInt16/clipSampleFromHalf.
+        static inline float load1(const float* p) noexcept { return *p; }
+        static inline float load1(const int16_t* p) noexcept { return clipSampleFromInt16(*p); }
+        static inline float load1(const uint16_t* p) noexcept { return clipSampleFromHalf(*p); }
+
+        static inline vf4 load4(const float* p) noexcept { return vload(p); }
+#if defined(AVANTGARDE_CLIP_KERNEL_SSE2)
+        static inline vf4 load4(const int16_t* p) noexcept {
+            const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+            const __m128i wide = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            return _mm_mul_ps(_mm_cvtepi32_ps(wide), _mm_set1_ps(1.0f / 32768.0f));
+        }
+        static inline vf4 load4(const uint16_t* p) noexcept {
+            const __m128i v = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)),
+                                                 _mm_setzero_si128());
+            const __m128i sign = _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x8000)), 16);
+            const __m128i mag = _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x7FFF)), 13);
+            const __m128 f = _mm_mul_ps(_mm_castsi128_ps(mag), _mm_set1_ps(0x1p112f));
+            return _mm_or_ps(f, _mm_castsi128_ps(sign));
+        }
+#elif defined(AVANTGARDE_CLIP_KERNEL_NEON)
+        static inline vf4 load4(const int16_t* p) noexcept {
+            return vmulq_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(p))), vdupq_n_f32(1.0f / 32768.0f));
+        }
+        static inline vf4 load4(const uint16_t* p) noexcept {
+            const uint32x4_t v = vmovl_u16(vld1_u16(p));
+            const uint32x4_t sign = vshlq_n_u32(vandq_u32(v, vdupq_n_u32(0x8000U)), 16);
+            const uint32x4_t mag = vshlq_n_u32(vandq_u32(v, vdupq_n_u32(0x7FFFU)), 13);
+            const float32x4_t f = vmulq_f32(vreinterpretq_f32_u32(mag), vdupq_n_f32(0x1p112f));
+            return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(f), sign));
+        }
+#else
+        static inline vf4 load4(const int16_t* p) noexcept {
+            return vf4{{load1(p), load1(p + 1), load1(p + 2), load1(p + 3)}};
+        }
+        static inline vf4 load4(const uint16_t* p) noexcept {
+            return vf4{{load1(p), load1(p + 1), load1(p + 2), load1(p + 3)}};
+        }
+#endif
+
+        // Тот же порядок операций, что у скалярного cubicHermite.
+        static inline vf4 hermite4(vf4 y0, vf4 y1, vf4 y2, vf4 y3, vf4 t) noexcept {
+            const vf4 half = vsplat(0.5f);
+            const vf4 c0 = y1;
+            const vf4 c1 = vmul(half, vsub(y2, y0));
+            const vf4 c2 = vsub(vadd(vsub(y0, vmul(vsplat(2.5f), y1)), vmul(vsplat(2.0f), y2)), vmul(half, y3));
+            const vf4 c3 = vadd(vmul(half, vsub(y3, y0)), vmul(vsplat(1.5f), vsub(y1, y2)));
+            return vadd(vmul(vadd(vmul(vadd(vmul(c3, t), c2), t), c1), t), c0);
+        }
+
+        static inline float hermite1(float y0, float y1, float y2, float y3, float t) noexcept {
+            const float c0 = y1;
+            const float c1 = 0.5f * (y2 - y0);
+            const float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+            const float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+            return ((c3 * t + c2) * t + c1) * t + c0;
+        }
+
+        template <typename S>
+        struct CubicRunT {
+            const S* c0 = nullptr;
+            const S* c1 = nullptr; // только для Stereo
+            double inc = 1.0;
+            float gain = 1.0f;
+            // Параметры линейного fade (только для Fade=true).
+            int32_t fadeNum0 = 0;
+            int32_t fadeStep = 0;
+            float fadeDen = 1.0f;
+            float* out0 = nullptr;
+            float* out1 = nullptr;
+        };
+        using CubicRun = CubicRunT<float>;
+
+        template <bool Fade, typename S>
+        static inline float fadeAt(const CubicRunT<S>& r, std::size_t k) noexcept {
+            if constexpr (Fade) {
+                return static_cast<float>(r.fadeNum0 + r.fadeStep * static_cast<int32_t>(k)) / r.fadeDen;
+            } else {
+                (void)r;
+                (void)k;
+                return 1.0f;
+            }
+        }
+
+        template <bool Fade, typename S>
+        static inline vf4 fade4(const CubicRunT<S>& r, std::size_t k) noexcept {
+            return vset(fadeAt<Fade>(r, k), fadeAt<Fade>(r, k + 1), fadeAt<Fade>(r, k + 2), fadeAt<Fade>(r, k + 3));
+        }
+
+        template <bool Stereo, bool Fade, typename S>
+        static inline void storeScaled_(const CubicRunT<S>& r, std::size_t k, vf4 s0, vf4 s1) noexcept {
+            const vf4 g = vsplat(r.gain);
+            vf4 o0 = vmul(s0, g);
+            vf4 o1 = Stereo ? vmul(s1, g) : o0;
+            if constexpr (Fade) {
+                const vf4 f = fade4<Fade>(r, k);
+                o0 = vmul(o0, f);
+                o1 = Stereo ? vmul(o1, f) : o0;
+            }
+            vstore(r.out0 + k, o0);
+            vstore(r.out1 + k, o1);
+        }
+
+        template <bool Stereo, bool Fade, typename S>
+        static inline void storeScaled1_(const CubicRunT<S>& r, std::size_t k, float s0, float s1) noexcept {
+            float o0 = s0 * r.gain;
+            float o1 = Stereo ? s1 * r.gain : o0;
+            if constexpr (Fade) {
+                const float f = fadeAt<Fade>(r, k);
+                o0 = o0 * f;
+                o1 = Stereo ? o1 * f : o0;
+            }
+            r.out0[k] = o0;
+            r.out1[k] = o1;
+        }
+
+        // inc == 1.0: все кадры имеют одинаковый frac, тапы идут подряд.
+        template <bool Stereo, bool Fade, typename S>
+        static inline void runUnitInc_(const CubicRunT<S>& r, double& ph, std::size_t n) noexcept {
+            const int i1 = static_cast<int>(ph);
+            const float frac = static_cast<float>(ph - static_cast<double>(i1));
+            const S* s0 = r.c0 + i1;
+            const S* s1 = Stereo ? (r.c1 + i1) : nullptr;
+            const std::size_t n4 = n & ~static_cast<std::size_t>(3);
+            std::size_t k = 0;
+            if (frac == 0.0f) {
+                // Быстрый путь: точное попадание в сэмплы -> копия с gain.
+                for (; k < n4; k += 4) {
+                    storeScaled_<Stereo, Fade>(r, k, load4(s0 + k), Stereo ? load4(s1 + k) : vsplat(0.0f));
+                }
+                for (; k < n; ++k) {
+                    storeScaled1_<Stereo, Fade>(r, k, load1(s0 + k), Stereo ? load1(s1 + k) : 0.0f);
+                }
+            } else {
+                const vf4 t = vsplat(frac);
+                for (; k < n4; k += 4) {
+                    const vf4 a = hermite4(load4(s0 + k - 1), load4(s0 + k), load4(s0 + k + 1), load4(s0 + k + 2), t);
+                    vf4 b = a;
+                    if constexpr (Stereo) {
+                        b = hermite4(load4(s1 + k - 1), load4(s1 + k), load4(s1 + k + 1), load4(s1 + k + 2), t);
+                    }
+                    storeScaled_<Stereo, Fade>(r, k, a, b);
+                }
+                for (; k < n; ++k) {
+                    const float a = hermite1(load1(s0 + k - 1), load1(s0 + k), load1(s0 + k + 1), load1(s0 + k + 2), frac);
+                    const float b = Stereo ? hermite1(load1(s1 + k - 1), load1(s1 + k), load1(s1 + k + 1),
+                                                      load1(s1 + k + 2), frac)
+                                           : a;
+                    storeScaled1_<Stereo, Fade>(r, k, a, b);
+                }
+            }
+            ph += static_cast<double>(n);
+        }
+
+        // Произвольный inc: фаза копится тем же сложением, что и в скалярном пути,
+        // тапы собираются по 4 кадра, полином считается векторно.
+        template <bool Stereo, bool Fade, typename S>
+        static inline void runAnyInc_(const CubicRunT<S>& r, double& ph, std::size_t n) noexcept {
+            const S* c0 = r.c0;
+            const S* c1 = r.c1;
+            const std::size_t n4 = n & ~static_cast<std::size_t>(3);
+            std::size_t k = 0;
+            for (; k < n4; k += 4) {
+                int idx[4];
+                float t[4];
+                for (int l = 0; l < 4; ++l) {
+                    idx[l] = static_cast<int>(ph);
+                    t[l] = static_cast<float>(ph - static_cast<double>(idx[l]));
+                    ph += r.inc;
+                }
+                const vf4 tv = vset(t[0], t[1], t[2], t[3]);
+                // Тапы кадра l лежат подряд: c[idx - 1 .. idx + 2] — одна загрузка load4 на кадр,
+                // затем транспонирование в 4 вектора по позиции тапа.
+                float tap[4][4];
+                for (int l = 0; l < 4; ++l) {
+                    vstore(tap[l], load4(c0 + idx[l] - 1));
+                }
+                const vf4 a = hermite4(vset(tap[0][0], tap[1][0], tap[2][0], tap[3][0]),
+                                       vset(tap[0][1], tap[1][1], tap[2][1], tap[3][1]),
+                                       vset(tap[0][2], tap[1][2], tap[2][2], tap[3][2]),
+                                       vset(tap[0][3], tap[1][3], tap[2][3], tap[3][3]),
+                                       tv);
+                vf4 b = a;
+                if constexpr (Stereo) {
+                    for (int l = 0; l < 4; ++l) {
+                        vstore(tap[l], load4(c1 + idx[l] - 1));
+                    }
+                    b = hermite4(vset(tap[0][0], tap[1][0], tap[2][0], tap[3][0]),
+                                 vset(tap[0][1], tap[1][1], tap[2][1], tap[3][1]),
+                                 vset(tap[0][2], tap[1][2], tap[2][2], tap[3][2]),
+                                 vset(tap[0][3], tap[1][3], tap[2][3], tap[3][3]),
+                                 tv);
+                }
+                storeScaled_<Stereo, Fade>(r, k, a, b);
+            }
+            for (; k < n; ++k) {
+                const int i1 = static_cast<int>(ph);
+                const float t = static_cast<float>(ph - static_cast<double>(i1));
+                const float a = hermite1(load1(c0 + i1 - 1), load1(c0 + i1), load1(c0 + i1 + 1), load1(c0 + i1 + 2), t);
+                const float b = Stereo ? hermite1(load1(c1 + i1 - 1), load1(c1 + i1), load1(c1 + i1 + 1),
+                                                  load1(c1 + i1 + 2), t)
+                                       : a;
+                storeScaled1_<Stereo, Fade>(r, k, a, b);
+                ph += r.inc;
+            }
+        }
+
+        // Предусловие: для всех k < n фаза ph_k (ph + k * inc) удовлетворяет
+        // 1 <= ph_k и floor(ph_k) + 2 <= len - 1. ph продвигается на n шагов.
+        template <bool Stereo, bool Fade, typename S>
+        static inline void renderCubicRun(const CubicRunT<S>& r, double& ph, std::size_t n) noexcept {
+            if (r.inc == 1.0) {
+                runUnitInc_<Stereo, Fade>(r, ph, n);
+            } else {
+                runAnyInc_<Stereo, Fade>(r, ph, n);
+            }
+        }
+
+        // Микс голоса в сумму: dst[k] += src[k]. Возвращает пиковый |src|
+        // (дешевая оценка громкости голоса для stealing "quietest").
+        static inline float mixAddPeak(float* dst, const float* src, std::size_t n) noexcept {
+            const std::size_t n4 = n & ~static_cast<std::size_t>(3);
+            vf4 peak = vsplat(0.0f);
+            std::size_t k = 0;
+            for (; k < n4; k += 4) {
+                const vf4 v = vload(src + k);
+                vstore(dst + k, vadd(vload(dst + k), v));
+                peak = vmax(peak, vabs(v));
+            }
+            float lanes[4];
+            vstore(lanes, peak);
+            float p = lanes[0];
+            for (int l = 1; l < 4; ++l) {
+                if (lanes[l] > p) p = lanes[l];
+            }
+            for (; k < n; ++k) {
+                dst[k] += src[k];
+                const float a = src[k] < 0.0f ? -src[k] : src[k];
+                if (a > p) p = a;
+            }
+            return p;
+        }
+
+        static inline float hmax4_(vf4 v) noexcept {
+            float lanes[4];
+            vstore(lanes, v);
+            float p = lanes[0];
+            for (int l = 1; l < 4; ++l) {
+                if (lanes[l] > p) p = lanes[l];
+            }
+            return p;
+        }
+
+        static inline float hsum4_(vf4 v) noexcept {
+            float lanes[4];
+            vstore(lanes, v);
+            return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        }
+
+        // Метр за один проход: peak = max(peak, |src|), sumSq += src^2.
+        // Используется и метрами движка (не только ClipTrack).
+        static inline void accumulateMeter(const float* src, std::size_t n, float& peak, float& sumSq) noexcept {
+            const std::size_t n4 = n & ~static_cast<std::size_t>(3);
+            vf4 vp = vsplat(0.0f);
+            vf4 vs = vsplat(0.0f);
+            std::size_t k = 0;
+            for (; k < n4; k += 4) {
+                const vf4 v = vload(src + k);
+                vp = vmax(vp, vabs(v));
+                vs = vadd(vs, vmul(v, v));
+            }
+            float p = hmax4_(vp);
+            float s = hsum4_(vs);
+            for (; k < n; ++k) {
+                const float a = src[k] < 0.0f ? -src[k] : src[k];
+                if (a > p) p = a;
+                s += src[k] * src[k];
+            }
+            if (p > peak) peak = p;
+            sumSq += s;
+        }
+
+        // dst[k] += src[k] и метр src за тот же проход (сумма — в том же порядке, что и скалярный микс).
+        static inline void mixAddMeter(float* dst, const float* src, std::size_t n, float& peak, float& sumSq) noexcept {
+            const std::size_t n4 = n & ~static_cast<std::size_t>(3);
+            vf4 vp = vsplat(0.0f);
+            vf4 vs = vsplat(0.0f);
+            std::size_t k = 0;
+            for (; k < n4; k += 4) {
+                const vf4 v = vload(src + k);
+                vstore(dst + k, vadd(vload(dst + k), v));
+                vp = vmax(vp, vabs(v));
+                vs = vadd(vs, vmul(v, v));
+            }
+            float p = hmax4_(vp);
+            float s = hsum4_(vs);
+            for (; k < n; ++k) {
+                dst[k] += src[k];
+                const float a = src[k] < 0.0f ? -src[k] : src[k];
+                if (a > p) p = a;
+                s += src[k] * src[k];
+            }
+            if (p > peak) peak = p;
+            sumSq += s;
+        }
+
+    } // namespace clip_kernel
+
+} // namespace avantgarde
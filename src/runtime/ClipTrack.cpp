@@ -4,193 +4,22 @@
 #include <cmath>
 #include <cstdint>
 #include <cstring>
-#include <fstream>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 #include "contracts/ids.h"
+#include "contracts/IClipStream.h"
 #include "contracts/IClipTrack.h" // IClipTrack, ITrack, RtCommand, AudioProcessContext, CmdId
+#include "contracts/WavDecoder.h"
+#include "runtime/ClipResampleKernel.h"
+#include "runtime/DspLoadProfiler.h"
+#include "runtime/WsolaStretcher.h"
 
 namespace avantgarde {
 
-// ============================================================
-// Minimal WAV decoder (RIFF/WAVE, little-endian)
-// Supports:
-//  - PCM (fmt=1): 16-bit, 24-bit
-//  - IEEE float (fmt=3): 32-bit float
-//  - channels: 1 or 2
-// Output:
-//  - planar float32 buffers (ch0, ch1)
-// ============================================================
-
-    namespace detail_wav {
-
-        static inline uint16_t read_u16_le(const uint8_t* p) {
-            return (uint16_t)(p[0] | (p[1] << 8));
-        }
-        static inline uint32_t read_u32_le(const uint8_t* p) {
-            return (uint32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24));
-        }
-        static inline bool read_exact(std::ifstream& f, void* dst, std::size_t n) {
-            f.read(reinterpret_cast<char*>(dst), (std::streamsize)n);
-            return f.good();
-        }
-
-        struct WavFmt {
-            uint16_t audioFormat = 0;     // 1=PCM, 3=IEEE float
-            uint16_t numChannels = 0;     // 1..2 (в MVP)
-            uint32_t sampleRate  = 0;
-            uint16_t bitsPerSample = 0;   // 16/24/32
-            uint16_t blockAlign = 0;      // bytes per frame
-        };
-
-        static inline bool decode_wav_to_planar_f32(
-                const char* path,
-                int& outSampleRate,
-                int& outChannels,
-                int& outFrames,
-                std::unique_ptr<float[]>& outCh0,
-                std::unique_ptr<float[]>& outCh1
-        ) {
-            outSampleRate = 0; outChannels = 0; outFrames = 0;
-            outCh0.reset(); outCh1.reset();
-            if (!path) return false;
-
-            std::ifstream f(path, std::ios::binary);
-            if (!f.is_open()) return false;
-
-            // RIFF header: "RIFF" + size + "WAVE"
-            uint8_t riff[12];
-            if (!read_exact(f, riff, 12)) return false;
-            if (std::memcmp(riff + 0, "RIFF", 4) != 0) return false;
-            if (std::memcmp(riff + 8, "WAVE", 4) != 0) return false;
-
-            bool haveFmt = false;
-            bool haveData = false;
-            WavFmt fmt{};
-            std::vector<uint8_t> dataBytes;
-
-            while (f.good() && !(haveFmt && haveData)) {
-                uint8_t chdr[8];
-                if (!read_exact(f, chdr, 8)) break;
-
-                const uint32_t csize = read_u32_le(chdr + 4);
-                const bool pad = (csize & 1u) != 0;
-
-                if (std::memcmp(chdr + 0, "fmt ", 4) == 0) {
-                    if (csize < 16) return false;
-                    std::vector<uint8_t> buf(csize);
-                    if (!read_exact(f, buf.data(), csize)) return false;
-
-                    fmt.audioFormat   = read_u16_le(buf.data() + 0);
-                    fmt.numChannels   = read_u16_le(buf.data() + 2);
-                    fmt.sampleRate    = read_u32_le(buf.data() + 4);
-                    fmt.blockAlign    = read_u16_le(buf.data() + 12);
-                    fmt.bitsPerSample = read_u16_le(buf.data() + 14);
-
-                    haveFmt = true;
-                }
-                else if (std::memcmp(chdr + 0, "data", 4) == 0) {
-                    dataBytes.resize(csize);
-                    if (csize > 0) {
-                        if (!read_exact(f, dataBytes.data(), csize)) return false;
-                    }
-                    haveData = true;
-                }
-                else {
-                    f.seekg((std::streamoff)csize, std::ios::cur);
-                    if (!f.good()) return false;
-                }
-
-                if (pad) {
-                    f.seekg(1, std::ios::cur);
-                    if (!f.good()) return false;
-                }
-            }
-
-            if (!haveFmt || !haveData) return false;
-
-            // Validate
-            if (!(fmt.audioFormat == 1 || fmt.audioFormat == 3)) return false;
-            if (!(fmt.numChannels == 1 || fmt.numChannels == 2)) return false;
-            if (!(fmt.bitsPerSample == 16 || fmt.bitsPerSample == 24 || fmt.bitsPerSample == 32)) return false;
-            if (fmt.blockAlign == 0) return false;
-
-            const uint32_t bytesPerFrame = fmt.blockAlign;
-            const uint32_t totalFrames = (uint32_t)(dataBytes.size() / bytesPerFrame);
-            if (totalFrames == 0) return false;
-            outSampleRate = (int)fmt.sampleRate;
-            outChannels   = (int)fmt.numChannels;
-            outFrames     = (int)totalFrames;
-
-            outCh0.reset(new (std::nothrow) float[totalFrames]);
-            if (!outCh0) return false;
-            if (outChannels == 2) {
-                outCh1.reset(new (std::nothrow) float[totalFrames]);
-                if (!outCh1) return false;
-            }
-
-            const uint8_t* src = dataBytes.data();
-            const int ch = outChannels;
-
-            auto clamp1 = [](float x) -> float {
-                if (x > 1.0f) return 1.0f;
-                if (x < -1.0f) return -1.0f;
-                return x;
-            };
-
-            // IEEE float32
-            if (fmt.audioFormat == 3 && fmt.bitsPerSample == 32) {
-                for (uint32_t i = 0; i < totalFrames; ++i) {
-                    const float* fr = reinterpret_cast<const float*>(src + i * bytesPerFrame);
-                    outCh0[i] = clamp1(fr[0]);
-                    if (ch == 2) outCh1[i] = clamp1(fr[1]);
-                }
-                return true;
-            }
-
-            // PCM16
-            if (fmt.audioFormat == 1 && fmt.bitsPerSample == 16) {
-                for (uint32_t i = 0; i < totalFrames; ++i) {
-                    const uint8_t* fr = src + i * bytesPerFrame;
-                    int16_t s0 = (int16_t)read_u16_le(fr + 0);
-                    outCh0[i] = (float)s0 / 32768.0f;
-                    if (ch == 2) {
-                        int16_t s1 = (int16_t)read_u16_le(fr + 2);
-                        outCh1[i] = (float)s1 / 32768.0f;
-                    }
-                }
-                return true;
-            }
-
-            // PCM24
-            if (fmt.audioFormat == 1 && fmt.bitsPerSample == 24) {
-                auto read_s24 = [](const uint8_t* p) -> int32_t {
-                    int32_t v = (int32_t)(p[0] | (p[1] << 8) | (p[2] << 16));
-                    if (v & 0x00800000) v |= 0xFF000000; // sign extend
-                    return v;
-                };
-
-                for (uint32_t i = 0; i < totalFrames; ++i) {
-                    const uint8_t* fr = src + i * bytesPerFrame;
-                    int32_t s0 = read_s24(fr + 0);
-                    outCh0[i] = (float)s0 / 8388608.0f; // 2^23
-                    if (ch == 2) {
-                        int32_t s1 = read_s24(fr + 3);
-                        outCh1[i] = (float)s1 / 8388608.0f;
-                    }
-                }
-                return true;
-            }
-
-            // PCM32 int not supported in MVP
-            return false;
-        }
-
-    } // namespace detail_wav
-
     namespace detail_interp {
 
         static inline float clampf(float x, float lo, float hi) noexcept {
@@ -211,18 +40,20 @@ namespace avantgarde {
             return ((c3 * t + c2) * t + c1) * t + c0;
         }
 
-        static inline float sampleCubic(const float* src, int len, double phase, bool loop) noexcept {
+        // S — тип хранения клипа (float / int16_t / uint16_t-half), см. clip_kernel::load1.
+        template <typename S>
+        static inline float sampleCubic(const S* src, int len, double phase, bool loop) noexcept {
             if (!src || len <= 0) return 0.0f;
-            if (len == 1) return src[0];
+            if (len == 1) return clip_kernel::load1(src);
 
             double ph = phase;
             if (loop) {
                 while (ph < 0.0) ph += static_cast<double>(len);
                 while (ph >= static_cast<double>(len)) ph -= static_cast<double>(len);
             } else {
-                if (ph <= 0.0) return src[0];
+                if (ph <= 0.0) return clip_kernel::load1(src);
                 const double maxPh = static_cast<double>(len - 1);
-                if (ph >= maxPh) return src[len - 1];
+                if (ph >= maxPh) return clip_kernel::load1(src + len - 1);
             }
 
             const int i1 = static_cast<int>(ph);
@@ -242,7 +73,8 @@ namespace avantgarde {
                 i3 = std::min(len - 1, i3);
             }
 
-            return cubicHermite(src[i0], src[i1], src[i2], src[i3], frac);
+            return cubicHermite(clip_kernel::load1(src + i0), clip_kernel::load1(src + i1),
+                                clip_kernel::load1(src + i2), clip_kernel::load1(src + i3), frac);
         }
 
     } // namespace detail_interp
@@ -274,16 +106,20 @@ namespace avantgarde {
             // outside-RT: module is fully prepared here
             mod->init(moduleSampleRate_, kFxScratchFrames);
             mod->reset();
-            std::shared_ptr<IAudioModule> shared(std::move(mod));
+            auto slot = std::make_shared<FxSlot>();
+            slot->module = std::shared_ptr<IAudioModule>(std::move(mod));
             const std::lock_guard<std::mutex> lock(modulesMutex_);
-            modules_.push_back(std::move(shared));
-            moduleEnabled_.push_back(1U);
+            modulesCtl_.push_back(std::move(slot));
+            publishFxChainLocked_();
         }
 
         IAudioModule* getModule(std::size_t index) override {
-            const std::lock_guard<std::mutex> lock(modulesMutex_);
-            if (index >= modules_.size()) return nullptr;
-            return modules_[index].get();
+            // Lock-free чтение опубликованного снапшота: getModule зовется и из control,
+            // и из RT (resolver ParamBridge в swapBuffers()). Снапшот не освобождается,
+            // пока RT не подтвердил переход на более новое поколение цепочки.
+            const FxChainSnapshot* chain = fxChainRt_.load(std::memory_order_acquire);
+            if (!chain || index >= chain->slots.size()) return nullptr;
+            return chain->slots[index]->module.get();
         }
 
         // ---- IParameterized (track-level surface) ----
@@ -319,6 +155,13 @@ namespace avantgarde {
                     return detail_interp::clampf(uiPlayheadNorm_.load(std::memory_order_relaxed), 0.0f, 1.0f);
                 case TrackParamId::TempoSyncEnabled:
                     return playbackRt_.stretchToBars ? 1.0f : 0.0f;
+                case TrackParamId::TempoSyncMode:
+                    return toParamValue(playbackRt_.tempoSyncMode);
+                case TrackParamId::AuxSendA:
+                case TrackParamId::AuxSendB:
+                case TrackParamId::AuxSendC:
+                case TrackParamId::AuxSendD:
+                    return playbackRt_.auxSend[index - toParamIndex(TrackParamId::AuxSendA)];
                 default:
                     return 0.0f;
             }
@@ -328,6 +171,18 @@ namespace avantgarde {
             applyTrackParam_(static_cast<uint16_t>(index), value);
         }
 
+        float auxSendLevel(uint32_t bus) const noexcept override {
+            return (bus < kMaxAuxBuses) ? playbackRt_.auxSend[bus] : 0.0f;
+        }
+
+        uint32_t fxLoadTicks(uint64_t* out, uint32_t maxSlots) const noexcept override {
+            const uint32_t n = std::min(fxLoadSlotsRt_, maxSlots);
+            for (uint32_t i = 0; i < n; ++i) {
+                out[i] = fxLoadTicksRt_[i];
+            }
+            return n;
+        }
+
         const ParamMeta& getParamMeta(std::size_t index) const override {
             const auto& meta = trackParamMeta_();
             if (index >= meta.size()) {
@@ -349,17 +204,84 @@ namespace avantgarde {
 
         bool removeModuleAt(std::size_t index) override {
             const std::lock_guard<std::mutex> lock(modulesMutex_);
-            if (index >= modules_.size()) {
+            if (index >= modulesCtl_.size()) {
                 return false;
             }
-            modules_.erase(modules_.begin() + static_cast<std::ptrdiff_t>(index));
-            if (index < moduleEnabled_.size()) {
-                moduleEnabled_.erase(moduleEnabled_.begin() + static_cast<std::ptrdiff_t>(index));
-            }
+            // Сам модуль живет в старом снапшоте до тех пор, пока RT не перейдет
+            // на новое поколение; освобождение — в reclaimRetiredFxChainsLocked_()
+            // (следующая правка цепочки или control-тик reclaimRetiredFx()).
+            modulesCtl_.erase(modulesCtl_.begin() + static_cast<std::ptrdiff_t>(index));
+            publishFxChainLocked_();
             return true;
         }
 
+        void reclaimRetiredFx() override {
+            const std::lock_guard<std::mutex> lock(modulesMutex_);
+            reclaimRetiredFxChainsLocked_();
+        }
+
         void process(const AudioProcessContext& ctx) override {
+            // Такты FX копятся по всем отрезкам блока (chunk'и, sample-accurate сегменты).
+            fxLoadTicksRt_.fill(0);
+            fxLoadSlotsRt_ = 0;
+            stemRt_ = stemSink_.load(std::memory_order_acquire);
+            stemCursorRt_ = 0;
+            if (timedCmdCount_ == 0 || ctx.nframes == 0) {
+                renderSpanRt_(ctx);
+                stemPadRt_(ctx.nframes);
+                return;
+            }
+
+            // Sample-accurate команды: режем рендер блока на отрезки по frameInBlock
+            // (так же, как phaseResetFrameInBlock режет рендер внутри renderClipChunk_).
+            std::size_t cursor = 0;
+            std::size_t next = 0;
+            while (next < timedCmdCount_ && timedCmds_[next].frameInBlock < ctx.nframes) {
+                const std::size_t at = timedCmds_[next].frameInBlock;
+                if (at > cursor) {
+                    renderSegmentRt_(ctx, cursor, at - cursor);
+                    cursor = at;
+                }
+                applyRtCommand_(timedCmds_[next]);
+                ++next;
+            }
+            if (cursor < ctx.nframes) {
+                renderSegmentRt_(ctx, cursor, ctx.nframes - cursor);
+            }
+            stemPadRt_(ctx.nframes);
+
+            // Команды с моментом за пределами блока переносим в следующий блок.
+            std::size_t kept = 0;
+            for (std::size_t i = next; i < timedCmdCount_; ++i) {
+                RtCommand c = timedCmds_[i];
+                c.frameInBlock -= static_cast<uint32_t>(ctx.nframes);
+                timedCmds_[kept++] = c;
+            }
+            timedCmdCount_ = kept;
+        }
+
+    private:
+        // Рендер отрезка [start, start + frames) текущего блока как самостоятельного
+        // под-блока: сдвигаем выходные указатели и transport sample time.
+        void renderSegmentRt_(const AudioProcessContext& ctx, std::size_t start, std::size_t frames) noexcept {
+            AudioProcessContext seg = ctx;
+            float* segOut[2]{};
+            if (ctx.out) {
+                const uint32_t outCh = std::min<uint32_t>((ctx.numOut > 0U) ? ctx.numOut : 1U, 2U);
+                for (uint32_t ch = 0; ch < outCh; ++ch) {
+                    segOut[ch] = ctx.out[ch] ? ctx.out[ch] + start : nullptr;
+                }
+                seg.out = segOut;
+                seg.numOut = outCh;
+            }
+            seg.nframes = frames;
+            seg.transportSampleTime = ctx.transportSampleTime + static_cast<uint64_t>(start);
+            spanStartRt_ = start;
+            renderSpanRt_(seg);
+            spanStartRt_ = 0;
+        }
+
+        void renderSpanRt_(const AudioProcessContext& ctx) noexcept {
             // RT boundary: apply any pending control updates
             rtApplyPending_();
 
@@ -382,12 +304,12 @@ namespace avantgarde {
             if (!runGate) {
                 // Даже когда трек "молчит", UI должен видеть актуальную фазу трекового курсора.
                 uiPlayheadNorm_.store(computePlayheadNormRt_(), std::memory_order_relaxed);
+                stretchActiveRt_ = false;
                 return;
             }
             const bool muted = playbackRt_.muted;
 
-            const float* c0 = clip->ch[0];
-            const float* c1 = (clip->channels == 2) ? clip->ch[1] : nullptr;
+            const ClipSamples samples{clip->format, clip->ch[0], (clip->channels == 2) ? clip->ch[1] : nullptr};
 
             double ph = playbackRt_.playhead;
             const int len = clip->frames;
@@ -399,7 +321,7 @@ namespace avantgarde {
             // Базовый шаг по исходному клипу:
             // 1) компенсация sample rate clip -> output (иначе 44.1k клип в 48k host звучит быстрее);
             // 2) пользовательский speed (playbackInc).
-            const double speed = static_cast<double>(detail_interp::clampf(playbackRt_.playbackInc, 0.05f, 8.0f));
+            const double speed = clipSpeedRt_();
             const double clipToOutRate =
                     (clip->sampleRate > 0 && outputSampleRate_ > 1.0)
                     ? (static_cast<double>(clip->sampleRate) / outputSampleRate_)
@@ -441,23 +363,67 @@ namespace avantgarde {
                 }
             }
 
-            std::vector<std::shared_ptr<IAudioModule>> modulesSnapshot{};
-            std::vector<uint8_t> moduleEnabledSnapshot{};
-            {
-                const std::lock_guard<std::mutex> lock(modulesMutex_);
-                modulesSnapshot = modules_;
-                moduleEnabledSnapshot = moduleEnabled_;
+            // Неизменяемый снапшот цепочки: без lock/копий/refcount-трафика в RT.
+            const FxChainSnapshot* chain = acquireFxChainRt_();
+            const std::size_t fxCount = chain ? chain->slots.size() : 0U;
+            if (fxResetPendingRt_) {
+                // Смена клипа с включенным сбросом или unfreeze: reset() только чистит уже
+                // выделенные буферы, поэтому его можно звать здесь, на границе блока. Модули
+                // с многосекундными ring (BufferFx, Stutter) дочищают их в следующих process().
+                fxResetPendingRt_ = false;
+                for (std::size_t i = 0; i < fxCount; ++i) {
+                    chain->slots[i]->module->reset();
+                }
             }
-            const bool hasEnabledFx =
-                !modulesSnapshot.empty() &&
-                std::any_of(moduleEnabledSnapshot.begin(), moduleEnabledSnapshot.end(), [](uint8_t e) { return e != 0U; });
-            const bool hasFx = hasEnabledFx && !muted;
+            bool hasEnabledFx = false;
+            uint64_t enabledMask = 0;
+            for (std::size_t i = 0; i < fxCount; ++i) {
+                if (chain->slots[i]->enabled.load(std::memory_order_relaxed) != 0U) {
+                    hasEnabledFx = true;
+                    enabledMask |= (i < 64U) ? (uint64_t{1} << i) : 0U;
+                }
+            }
+            // Новая цепочка или включенный слот: состояние модулей могло остаться
+            // от давнего сигнала — счет тишины на входе начинаем заново.
+            const uint64_t chainGen = chain ? chain->generation : 0U;
+            if (chainGen != quietChainGenRt_ || enabledMask != quietFxMaskRt_) {
+                quietChainGenRt_ = chainGen;
+                quietFxMaskRt_ = enabledMask;
+                quietFramesRt_ = 0;
+            }
+            // Замороженный клип уже прошел через цепочку offline: живые FX обходим.
+            const bool hasFx = hasEnabledFx && !muted && !clip->frozen;
+            // Суммарный хвост цепочки: сколько тихих кадров на входе нужно, чтобы ее выход
+            // гарантированно стал тишиной. Без FX хвоста нет.
+            uint64_t chainTail = 0;
             if (hasFx) {
-                for (std::size_t i = 0; i < modulesSnapshot.size(); ++i) {
-                    if (i < moduleEnabledSnapshot.size() && moduleEnabledSnapshot[i] == 0U) {
+                fxLoadSlotsRt_ = static_cast<uint32_t>(std::min<std::size_t>(fxCount, fxLoadTicksRt_.size()));
+                for (std::size_t i = 0; i < fxCount; ++i) {
+                    const FxSlot& slot = *chain->slots[i];
+                    if (slot.enabled.load(std::memory_order_relaxed) == 0U) {
                         continue;
                     }
-                    modulesSnapshot[i]->beginBlock();
+                    slot.module->beginBlock();
+                    const uint32_t tail = slot.module->tailFrames();
+                    chainTail = (tail == IAudioModule::kInfiniteTailFrames) ? UINT64_MAX
+                                                                              : satAdd_(chainTail, tail);
+                }
+            }
+
+            const bool polyActive = notePolyActiveRt_();
+
+            // Tempo sync без сдвига высоты: playhead идет с тем же inc (длина петли и сетка
+            // как у varispeed), а звук собирает stretcher_ с шагом clipToOutRate.
+            const bool useStretch = playbackRt_.stretchToBars &&
+                                    playbackRt_.tempoSyncMode == TempoSyncModeValue::Stretch &&
+                                    playbackRt_.playbackMode == TrackPlaybackModeValue::Looper &&
+                                    clip->stretch && !clip->stream && !clip->frozen && !polyActive && !muted;
+            if (useStretch) {
+                if (!stretchActiveRt_ || clip != stretchClipRt_) {
+                    stretcher_.reset();
+                } else if (ph != stretchNextPh_) {
+                    // Playhead сдвинули между блоками (retrigger, trim, render-ahead seek).
+                    stretcher_.realign();
                 }
             }
 
@@ -467,42 +433,138 @@ namespace avantgarde {
                    // а в one-shot режиме можем выйти раньше, когда gate погаснет.
                    (playbackRt_.followTransport || playbackRt_.oneshotRunning)) {
                 const std::size_t chunk = std::min(kFxScratchFrames, ctx.nframes - offset);
-                const std::size_t produced =
-                    renderClipChunk_(chunk,
-                                     c0,
-                                     c1,
-                                     len,
-                                     loop,
-                                     g,
-                                     inc,
-                                     regionStart,
-                                     regionEnd,
-                                     ph,
-                                     offset,
-                                     phaseResetFrameInBlock,
-                                     phaseResetPlayhead,
-                                     phaseResetFadeSamples);
+                std::size_t produced = 0;
+                if (polyActive) {
+                    // Полифонический note-режим: каждый голос со своим playhead.
+                    produced = muted ? advanceNoteVoicesChunk_(chunk, loop, inc, regionStart, regionEnd)
+                                     : renderNoteVoicesChunk_(chunk, samples, len, loop, g, inc, regionStart, regionEnd);
+                    if (!anyVoiceActiveRt_()) {
+                        playbackRt_.oneshotRunning = false;
+                    }
+                } else {
+                    bool reachedEnd = false;
+                    if (muted) {
+                        produced = advanceClipChunk_(chunk,
+                                                     loop,
+                                                     inc,
+                                                     regionStart,
+                                                     regionEnd,
+                                                     ph,
+                                                     offset,
+                                                     phaseResetFrameInBlock,
+                                                     phaseResetPlayhead,
+                                                     phaseResetFadeSamples,
+                                                     playbackRt_.phaseResetFadeInRemaining,
+                                                     reachedEnd);
+                        if (clip->stream) {
+                            // I/O-нить подкачивает кольцо от текущей позиции, даже если трек не слышно.
+                            clip->stream->setRegionRt(clip->streamReader,
+                                                      static_cast<int64_t>(regionStart),
+                                                      static_cast<int64_t>(std::ceil(regionEnd)),
+                                                      loop);
+                            (void)clip->stream->readRt(clip->streamReader, static_cast<int64_t>(ph), 0,
+                                                       nullptr, nullptr);
+                        }
+                    } else if (useStretch) {
+                        produced = renderStretchChunk_(chunk,
+                                                       *clip,
+                                                       loop,
+                                                       g,
+                                                       inc,
+                                                       clipToOutRate,
+                                                       regionStart,
+                                                       regionEnd,
+                                                       ph,
+                                                       offset,
+                                                       phaseResetFrameInBlock,
+                                                       phaseResetPlayhead,
+                                                       fxA0_.data(),
+                                                       fxA1_.data(),
+                                                       reachedEnd);
+                    } else if (clip->stream) {
+                        produced = renderStreamChunk_(chunk,
+                                                      *clip,
+                                                      clip->streamReader,
+                                                      loop,
+                                                      g,
+                                                      inc,
+                                                      regionStart,
+                                                      regionEnd,
+                                                      ph,
+                                                      offset,
+                                                      phaseResetFrameInBlock,
+                                                      phaseResetPlayhead,
+                                                      phaseResetFadeSamples,
+                                                      fxA0_.data(),
+                                                      fxA1_.data(),
+                                                      playbackRt_.phaseResetFadeInRemaining,
+                                                      reachedEnd);
+                    } else {
+                        produced = renderClipChunk_(chunk,
+                                                    samples,
+                                                    len,
+                                                    loop,
+                                                    g,
+                                                    inc,
+                                                    regionStart,
+                                                    regionEnd,
+                                                    ph,
+                                                    offset,
+                                                    phaseResetFrameInBlock,
+                                                    phaseResetPlayhead,
+                                                    phaseResetFadeSamples,
+                                                    fxA0_.data(),
+                                                    fxA1_.data(),
+                                                    playbackRt_.phaseResetFadeInRemaining,
+                                                    reachedEnd);
+                    }
+                    if (reachedEnd) {
+                        // Хвост последнего grain-а к следующему запуску не относится.
+                        stretcher_.reset();
+                        // Для followTransport one-shot флаг не используем:
+                        // просто остаемся в "конце клипа" и выдаем тишину до retrigger.
+                        if (playbackRt_.followTransport) {
+                            ph = regionEnd;
+                        } else {
+                            // В one-shot режиме конец клипа автоматически гасит local gate.
+                            playbackRt_.oneshotRunning = false;
+                            ph = regionStart;
+                        }
+                    }
+                }
                 if (produced == 0) {
                     break;
                 }
 
                 // Mute не должен останавливать внутренний playback:
-                // playhead продолжает идти, но в master ничего не пишем.
+                // playhead продолжает идти (без рендера, см. advanceClipChunk_),
+                // но в master ничего не пишем.
                 if (muted) {
                     offset += produced;
                     continue;
                 }
 
+                // Тихий вход цепочки дольше ее хвоста: выход трека — тишина,
+                // FX и микс пропускаем (состояние модулей уже затухло).
+                const bool quietIn = isQuietChunk_(fxA0_.data(), fxA1_.data(), produced);
+                const uint64_t quietBefore = quietFramesRt_;
+                quietFramesRt_ = quietIn ? satAdd_(quietFramesRt_, produced) : 0U;
+                if (quietIn && quietBefore >= chainTail) {
+                    offset += produced;
+                    continue;
+                }
+
                 const float* mix0 = fxA0_.data();
                 const float* mix1 = fxA1_.data();
 
                 if (hasFx) {
                     bool useAasInput = true;
-                    for (std::size_t i = 0; i < modulesSnapshot.size(); ++i) {
-                        if (i < moduleEnabledSnapshot.size() && moduleEnabledSnapshot[i] == 0U) {
+                    for (std::size_t i = 0; i < fxCount; ++i) {
+                        const FxSlot& slot = *chain->slots[i];
+                        if (slot.enabled.load(std::memory_order_relaxed) == 0U) {
                             continue;
                         }
-                        auto& mod = modulesSnapshot[i];
+                        IAudioModule* mod = slot.module.get();
                         const float* inPtrs[2];
                         float* outPtrs[2];
                         if (useAasInput) {
@@ -532,7 +594,11 @@ namespace avantgarde {
                         // Важно для tempo-sync FX: время должно идти внутри блока,
                         // иначе LFO/step-логика будет "перезапускаться" на каждом chunk.
                         modCtx.transportSampleTime = ctx.transportSampleTime + static_cast<uint64_t>(offset);
+                        const uint64_t fxT0 = DspLoadProfiler::nowTicks();
                         mod->process(modCtx);
+                        if (i < fxLoadTicksRt_.size()) {
+                            fxLoadTicksRt_[i] += DspLoadProfiler::nowTicks() - fxT0;
+                        }
                         useAasInput = !useAasInput;
                     }
 
@@ -541,6 +607,7 @@ namespace avantgarde {
                     mix1 = useAasInput ? fxA1_.data() : fxB1_.data();
                 }
 
+                stemWriteRt_(spanStartRt_ + offset, mix0, mix1, produced);
                 for (std::size_t i = 0; i < produced; ++i) {
                     out0[offset + i] += mix0[i];
                     if (out1) {
@@ -551,11 +618,99 @@ namespace avantgarde {
                 offset += produced;
             }
 
+            if (polyActive) {
+                // UI-курсор показывает самый свежий голос.
+                ph = latestVoicePlayheadRt_(ph);
+            }
             playbackRt_.playhead = ph;
             uiPlayheadNorm_.store(computePlayheadNormRt_(), std::memory_order_relaxed);
+            stretchActiveRt_ = useStretch;
+            stretchClipRt_ = clip;
+            stretchNextPh_ = ph;
         }
 
+    public:
         void onRtCommand(const RtCommand& cmd) noexcept override {
+            if (cmd.frameInBlock == 0U && timedCmdCount_ == 0) {
+                applyRtCommand_(cmd);
+                return;
+            }
+            if (timedCmdCount_ == kMaxTimedRtCommands) {
+                // Очередь полна: команду применяем раньше срока, но не раньше уже
+                // отложенных с моментом не позже ее (NoteOn/NoteOff не меняются местами).
+                std::size_t due = 0;
+                while (due < timedCmdCount_ && timedCmds_[due].frameInBlock <= cmd.frameInBlock) {
+                    applyRtCommand_(timedCmds_[due]);
+                    ++due;
+                }
+                std::copy(timedCmds_.begin() + static_cast<std::ptrdiff_t>(due),
+                          timedCmds_.begin() + static_cast<std::ptrdiff_t>(timedCmdCount_),
+                          timedCmds_.begin());
+                timedCmdCount_ -= due;
+                if (timedCmdCount_ == kMaxTimedRtCommands) {
+                    // Все отложенные позже нее: применение сейчас порядок не нарушает.
+                    applyRtCommand_(cmd);
+                    return;
+                }
+            }
+            // Откладываем до нужного сэмпла; применит process(). Команда на начало
+            // блока тоже встает в очередь, если в ней есть перенесенные из прошлого
+            // блока: иначе она обогнала бы их.
+            // Вставка с сохранением порядка: при равном смещении — FIFO.
+            std::size_t pos = timedCmdCount_;
+            while (pos > 0 && timedCmds_[pos - 1].frameInBlock > cmd.frameInBlock) {
+                timedCmds_[pos] = timedCmds_[pos - 1];
+                --pos;
+            }
+            timedCmds_[pos] = cmd;
+            ++timedCmdCount_;
+        }
+
+        bool isIdleRt() noexcept override {
+            rtApplyPending_();
+            // Стему нужна тишина и за пропущенный блок.
+            if (timedCmdCount_ != 0 || stemSink_.load(std::memory_order_relaxed) != nullptr) {
+                return false;
+            }
+            const ClipBuffer* clip = playbackRt_.clip;
+            const bool runGate = playbackRt_.followTransport ? playbackRt_.transportRunning : playbackRt_.oneshotRunning;
+            if (clip && clip->frames > 0 && runGate) {
+                return false;
+            }
+            // process() ничего бы не отрендерил: обновляем только UI-курсор (как ветка !runGate).
+            uiPlayheadNorm_.store(computePlayheadNormRt_(), std::memory_order_relaxed);
+            return true;
+        }
+
+        bool canRenderAheadRt() noexcept override {
+            rtApplyPending_();
+            // Стем пишется в порядке отыгрыша: блоки, выброшенные при возврате трека, в нем лишние.
+            if (timedCmdCount_ != 0 || playbackRt_.pendingPhaseResync || playbackRt_.armed ||
+                stemSink_.load(std::memory_order_relaxed) != nullptr) {
+                return false;
+            }
+            // Заранее рендерим только клип, который живет по транспорту: note-режим и
+            // one-shot gate ждут триггеров, которых воркер не увидит.
+            const ClipBuffer* clip = playbackRt_.clip;
+            return clip && clip->frames > 0 &&
+                   playbackRt_.followTransport && playbackRt_.transportRunning &&
+                   playbackRt_.playbackMode != TrackPlaybackModeValue::Note;
+        }
+
+        uint64_t controlEpoch() const noexcept override {
+            return controlEpoch_.load(std::memory_order_acquire);
+        }
+
+        double renderPositionRt() const noexcept override {
+            return playbackRt_.playhead;
+        }
+
+        void seekRenderPositionRt(double position) noexcept override {
+            playbackRt_.playhead = position;
+        }
+
+    private:
+        void applyRtCommand_(const RtCommand& cmd) noexcept {
             rtApplyPending_();
 
             const CmdId cid = fromWireCmdId(cmd.id);
@@ -594,6 +749,7 @@ namespace avantgarde {
                     playbackRt_.playhead = clipRegionStartFrameRt_();
                     playbackRt_.noteHeld = false;
                     playbackRt_.noteDetuneNorm = 0.0f;
+                    clearNoteVoicesRt_();
                 } break;
 
                 case CmdId::NoteOn: {
@@ -604,7 +760,9 @@ namespace avantgarde {
                     playbackRt_.noteHeld = true; // понадобится при stopPolicy=ByNoteOff
                     // NoteOn запускает проигрывание только при one-shot gate режиме.
                     // В follow-transport режиме трек живет по global transport.playing.
-                    if (!playbackRt_.followTransport) {
+                    if (notePolyActiveRt_()) {
+                        startNoteVoiceRt_(cmd.index);
+                    } else if (!playbackRt_.followTransport) {
                         triggerPlaybackRt_();
                     }
                 } break;
@@ -615,6 +773,13 @@ namespace avantgarde {
                     }
                     // Защита от "чужого" NoteOff:
                     // останавливаемся только если отпускание пришло для activeNote.
+                    if (notePolyActiveRt_()) {
+                        releaseNoteVoicesRt_(cmd.index);
+                        if (playbackRt_.activeNote == cmd.index) {
+                            playbackRt_.noteHeld = false;
+                        }
+                        break;
+                    }
                     const bool sameNote = (playbackRt_.activeNote == cmd.index);
                     if (!sameNote) {
                         break;
@@ -643,28 +808,14 @@ namespace avantgarde {
                 case CmdId::ParamSet: {
                     if (cmd.slot >= 0) {
                         const std::size_t fxSlot = static_cast<std::size_t>(cmd.slot);
-                        std::shared_ptr<IAudioModule> mod{};
-                        bool handledFxParam = false;
-                        {
-                            const std::lock_guard<std::mutex> lock(modulesMutex_);
-                            if (fxSlot < modules_.size()) {
-                                handledFxParam = true;
-                                mod = modules_[fxSlot];
-                                if (cmd.index == toParamIndex(FxCommonParamId::Enabled)) {
-                                    if (fxSlot < moduleEnabled_.size()) {
-                                        moduleEnabled_[fxSlot] = (cmd.value >= 0.5f) ? 1U : 0U;
-                                    }
-                                    mod.reset();
-                                }
-                            }
-                        }
-                        if (handledFxParam) {
+                        const FxChainSnapshot* chain = acquireFxChainRt_();
+                        if (chain && fxSlot < chain->slots.size()) {
+                            FxSlot& slot = *chain->slots[fxSlot];
                             if (cmd.index == toParamIndex(FxCommonParamId::Enabled)) {
+                                slot.enabled.store((cmd.value >= 0.5f) ? 1U : 0U, std::memory_order_relaxed);
                                 break;
                             }
-                            if (mod) {
-                                mod->setParam(cmd.index, detail_interp::clampf(cmd.value, 0.0f, 1.0f));
-                            }
+                            slot.module->setParam(cmd.index, detail_interp::clampf(cmd.value, 0.0f, 1.0f));
                             break;
                         }
                         // Backward compatibility для старых тестов/клиентов:
@@ -724,64 +875,72 @@ namespace avantgarde {
             }
         }
 
+    public:
         // ---- IClipTrack ----
         uint32_t numSlots() const noexcept override { return 1; }
 
         bool loadSlotFromFile(uint32_t slot, const char* path) override {
-            if (slot != 0u) return false;
+            if (slot != 0u || !path) return false;
 
-            int sr = 0, ch = 0, frames = 0;
-            std::unique_ptr<float[]> c0, c1;
-            if (!detail_wav::decode_wav_to_planar_f32(path, sr, ch, frames, c0, c1)) {
+            WavDecodedPlanar wav{};
+            if (!decodeWavFile(path, wav)) {
                 return false;
             }
+            const int ch = wav.channels;
 
             auto b = std::make_shared<ClipBuffer>();
-            b->sampleRate = sr;
+            b->sampleRate = wav.sampleRate;
             b->channels   = ch;
-            b->frames     = frames;
-            b->ch0Shared  = std::shared_ptr<const float[]>(c0.release(), std::default_delete<float[]>());
+            b->frames     = wav.frames;
+            b->ch0Shared  = std::shared_ptr<const float[]>(wav.ch0.release(), std::default_delete<float[]>());
             b->ch1Shared  = (ch == 2)
-                            ? std::shared_ptr<const float[]>(c1.release(), std::default_delete<float[]>())
+                            ? std::shared_ptr<const float[]>(wav.ch1.release(), std::default_delete<float[]>())
                             : std::shared_ptr<const float[]>{};
             b->ch[0]      = b->ch0Shared.get();
             b->ch[1]      = (ch == 2) ? b->ch1Shared.get() : nullptr;
             if (!b->ch[0] || (ch == 2 && !b->ch[1])) {
                 return false;
             }
+            b->stretch = analyzeClipForStretch(static_cast<const float*>(b->ch[0]),
+                                               static_cast<const float*>(b->ch[1]), b->frames);
 
             clipRefId_.store(0u, std::memory_order_relaxed);
             snapshotCtl_.clipRefId = 0u;
-            return publishClipAndResetFx_(std::move(b));
+            return publishLoadedClip_(std::move(b));
         }
 
         bool loadSlotFromBuffer(uint32_t slot, const SharedClipBuffer& buffer) override {
             if (slot != 0u) return false;
-            if (!buffer.valid()) return false;
 
-            auto b = std::make_shared<ClipBuffer>();
-            b->sampleRate = buffer.sampleRate;
-            b->channels = buffer.channels;
-            b->frames = buffer.frames;
-            b->ch0Shared = buffer.ch0;
-            b->ch1Shared = buffer.ch1;
-            b->ch[0] = b->ch0Shared.get();
-            b->ch[1] = (buffer.channels == 2) ? b->ch1Shared.get() : nullptr;
-            if (!b->ch[0] || (buffer.channels == 2 && !b->ch[1])) {
-                return false;
+            auto b = makeClipBuffer_(buffer);
+            if (!b) return false;
+            if (!b->stretch && !b->stream) {
+                // Буфер не из пула (пул считает анализ в нити загрузчика).
+                b->stretch = analyzeClipForStretch(buffer);
+            }
+            if (b->stream && streamWin0_.empty()) {
+                // Окно выделяется один раз на трек, до того как RT увидит потоковый клип.
+                streamWin0_.assign(kStreamWindowFrames, 0.0f);
+                streamWin1_.assign(kStreamWindowFrames, 0.0f);
             }
 
             clipRefId_.store(0u, std::memory_order_relaxed);
             snapshotCtl_.clipRefId = 0u;
-            return publishClipAndResetFx_(std::move(b));
+            return publishLoadedClip_(std::move(b));
         }
 
         bool clearSlot(uint32_t slot) override {
             if (slot != 0u) return false;
 
+            ++clipGenerationCtl_;
+            unfrozenClipCtl_.reset();
+            if (clipCtl_ && (clipCtl_->frozen || clipCtl_->stream)) {
+                retiredClipCtl_ = clipCtl_;
+            }
             clipCtl_.reset();
             pendingClip_.store(nullptr, std::memory_order_release);
             pendingClear_.store(true, std::memory_order_release);
+            bumpControlEpoch_();
             clipRefId_.store(0u, std::memory_order_relaxed);
             snapshotCtl_.clipRefId = 0u;
             return true;
@@ -791,6 +950,7 @@ namespace avantgarde {
             if (slot != 0u) return false;
             // MVP: только флаг armed (память под запись пока не готовим)
             recArmed_.store(on, std::memory_order_relaxed);
+            bumpControlEpoch_();
             return true;
         }
 
@@ -804,6 +964,18 @@ namespace avantgarde {
             // Явное ручное отключение остается доступным через TrackParamId::TempoSyncEnabled.
             pendingStretchMode_.store(1, std::memory_order_release);
             pendingStretchRecalc_.store(true, std::memory_order_release);
+            bumpControlEpoch_();
+            return true;
+        }
+
+        bool setNotePolyphony(uint8_t voices, VoiceStealPolicyValue steal) override {
+            if (voices == 0 || voices > kMaxNoteVoices) {
+                return false;
+            }
+            // Контракт: только вне RT. Голоса предвыделены, RT лишь меняет лимит.
+            const uint32_t packed = (static_cast<uint32_t>(steal) << 8) | voices;
+            pendingPolyphony_.store(packed, std::memory_order_release);
+            bumpControlEpoch_();
             return true;
         }
 
@@ -813,9 +985,20 @@ namespace avantgarde {
             // Контракт: только вне RT. Мы публикуем флаг в RT через pendingLoop_.
             pendingLoop_.store(loop ? 1u : 0u, std::memory_order_release);
             snapshotCtl_.loopEnabled = loop;
+            bumpControlEpoch_();
             return true;
         }
 
+        void setFxResetOnClipSwap(bool on) noexcept override {
+            fxResetOnClipSwap_.store(on, std::memory_order_relaxed);
+        }
+
+        void setStemSink(IRtRecordSink* sink) noexcept override {
+            stemSink_.store(sink, std::memory_order_release);
+            // Трек у воркера render-ahead возвращается аудио-нити.
+            bumpControlEpoch_();
+        }
+
         void setClipRefId(uint32_t clipRefId) noexcept override {
             clipRefId_.store(clipRefId, std::memory_order_relaxed);
             snapshotCtl_.clipRefId = clipRefId;
@@ -863,15 +1046,225 @@ namespace avantgarde {
             }
             if (paramIndex == toParamIndex(TrackParamId::TempoSyncEnabled)) {
                 snapshotCtl_.tempoSync = (value >= 0.5f);
+                return;
+            }
+            if (paramIndex == toParamIndex(TrackParamId::TempoSyncMode)) {
+                snapshotCtl_.tempoSyncMode = parseTempoSyncMode_(value);
+            }
+        }
+
+        // ---- Freeze ----
+        bool captureFreezeJob(TrackFreezeJob& job) override {
+            if (unfrozenClipCtl_ || !clipCtl_) return false;
+            // Потоковый клип целиком не в памяти: offline-рендеру нечего читать.
+            if (clipCtl_->stream) return false;
+            // Note-режим играет клип с высоты нот: один рендер его не заменит.
+            if (getParam(toParamIndex(TrackParamId::PlaybackMode)) >= 0.5f) return false;
+            // Offline-рендер — varispeed: time-stretch звучал бы иначе.
+            if (getParam(toParamIndex(TrackParamId::TempoSyncEnabled)) >= 0.5f &&
+                getParam(toParamIndex(TrackParamId::TempoSyncMode)) >= 0.5f) {
+                return false;
+            }
+
+            const ClipBuffer& clip = *clipCtl_;
+            job.source = SharedClipBuffer{clip.sampleRate, clip.channels, clip.frames, clip.ch0Shared, clip.ch1Shared};
+            job.source.format = clip.format;
+            job.source.ch0Packed = clip.ch0Packed;
+            job.source.ch1Packed = clip.ch1Packed;
+            const float startNorm = getParam(toParamIndex(TrackParamId::StartNorm));
+            const float endNorm = getParam(toParamIndex(TrackParamId::EndNorm));
+            job.regionStart = regionStartFrame_(clip.frames, startNorm);
+            job.regionEnd = regionEndFrame_(clip.frames, startNorm, endNorm);
+            // Под tempo-sync это уже пересчитанный от BPM шаг: то, что звучит сейчас.
+            job.playbackInc = getParam(toParamIndex(TrackParamId::PlaybackInc));
+            // setSlotLooping, еще не подхваченный RT, уже определяет, что будет звучать.
+            const uint32_t pendingLoop = pendingLoop_.load(std::memory_order_acquire);
+            job.loop = (pendingLoop != 0xFFFFFFFFu) ? (pendingLoop != 0u)
+                                                    : (getParam(toParamIndex(TrackParamId::LoopEnabled)) >= 0.5f);
+            job.outputSampleRate = outputSampleRate_;
+            // bpm/tsNum/tsDen не трогаем: transport трека — RT-состояние, его
+            // заполняет вызывающий из control-стороны.
+            job.clipGeneration = clipGenerationCtl_;
+            job.cancel.store(false, std::memory_order_relaxed);
+
+            job.fx.clear();
+            const std::lock_guard<std::mutex> lock(modulesMutex_);
+            for (const auto& slot : modulesCtl_) {
+                if (slot->enabled.load(std::memory_order_relaxed) == 0U) {
+                    continue;
+                }
+                auto copy = slot->module->cloneForOffline(moduleSampleRate_, kFxScratchFrames);
+                if (!copy) {
+                    job.fx.clear();
+                    return false;
+                }
+                job.fx.push_back(std::move(copy));
+            }
+            job.fxChainGeneration = fxChainGenCtl_;
+            return true;
+        }
+
+        bool renderFreezeJob(TrackFreezeJob& job, SharedClipBuffer& out) const override {
+            const SharedClipBuffer& src = job.source;
+            if (!src.valid() || !(job.outputSampleRate > 1.0)) return false;
+
+            const FreezeGeometry geo = freezeGeometry_(job);
+            // Хвост цепочки после конца региона; неизвестный хвост режем сверху.
+            const uint64_t maxTail = static_cast<uint64_t>(kFreezeMaxTailSeconds * job.outputSampleRate);
+            uint64_t tail = 0;
+            for (const auto& mod : job.fx) {
+                if (!mod) return false;
+                const uint32_t t = mod->tailFrames();
+                tail = (t == IAudioModule::kInfiniteTailFrames) ? maxTail : satAdd_(tail, t);
+            }
+            tail = std::min(tail, maxTail);
+            // Луп: прогреваем цепочку целыми проходами, пока хвост не завернется
+            // с конца в начало, и пишем следующий проход. One-shot: регион + хвост.
+            const uint64_t warmup = job.loop ? ((tail + geo.passFrames - 1U) / geo.passFrames) * geo.passFrames : 0U;
+            const uint64_t recorded = job.loop ? geo.passFrames : geo.passFrames + tail;
+            if (recorded > static_cast<uint64_t>(std::numeric_limits<int>::max())) return false;
+
+            const int channels = (src.channels == 2 || !job.fx.empty()) ? 2 : 1;
+            std::unique_ptr<float[]> dst0(new float[recorded]);
+            std::unique_ptr<float[]> dst1(channels == 2 ? new float[recorded] : nullptr);
+            std::vector<float> a0(kFxScratchFrames), a1(kFxScratchFrames);
+            std::vector<float> b0(kFxScratchFrames), b1(kFxScratchFrames);
+            const bool mono = src.channels != 2;
+
+            const uint64_t total = warmup + recorded;
+            for (uint64_t pos = 0; pos < total;) {
+                if (job.cancel.load(std::memory_order_relaxed)) return false;
+                const std::size_t n = static_cast<std::size_t>(std::min<uint64_t>(kFxScratchFrames, total - pos));
+                for (std::size_t i = 0; i < n; ++i) {
+                    const uint64_t frame = pos + i;
+                    // Позиция каждого кадра считается от начала прохода: без накопления ошибки.
+                    const uint64_t k = job.loop ? (frame % geo.passFrames) : frame;
+                    if (!job.loop && k >= geo.passFrames) {
+                        a0[i] = 0.0f;
+                        a1[i] = 0.0f;
+                        continue;
+                    }
+                    const double ph = job.regionStart + static_cast<double>(k) * geo.inc;
+                    a0[i] = sampleSourceCubic_(src, 0, ph, job.loop);
+                    a1[i] = mono ? a0[i] : sampleSourceCubic_(src, 1, ph, job.loop);
+                }
+
+                bool useAasInput = true;
+                for (const auto& mod : job.fx) {
+                    const float* inPtrs[2] = {useAasInput ? a0.data() : b0.data(), useAasInput ? a1.data() : b1.data()};
+                    float* outPtrs[2] = {useAasInput ? b0.data() : a0.data(), useAasInput ? b1.data() : a1.data()};
+                    AudioProcessContext modCtx{};
+                    modCtx.in = inPtrs;
+                    modCtx.out = outPtrs;
+                    modCtx.numOut = 2U;
+                    modCtx.nframes = n;
+                    modCtx.transportValid = true;
+                    modCtx.transportPlaying = true;
+                    modCtx.transportTsNum = job.tsNum;
+                    modCtx.transportTsDen = job.tsDen;
+                    modCtx.transportBpm = job.bpm;
+                    modCtx.transportSampleTime = pos;
+                    mod->beginBlock();
+                    mod->process(modCtx);
+                    useAasInput = !useAasInput;
+                }
+                const float* mix0 = useAasInput ? a0.data() : b0.data();
+                const float* mix1 = useAasInput ? a1.data() : b1.data();
+
+                for (std::size_t i = 0; i < n; ++i) {
+                    const uint64_t frame = pos + i;
+                    if (frame < warmup) continue;
+                    dst0[frame - warmup] = mix0[i];
+                    if (dst1) dst1[frame - warmup] = mix1[i];
+                }
+                pos += n;
             }
+
+            uint64_t frames = recorded;
+            if (!job.loop) {
+                // Хвост дописан с запасом: срезаем неслышный конец, регион не трогаем.
+                while (frames > geo.passFrames &&
+                       std::fabs(dst0[frames - 1U]) < IAudioModule::kSilenceLevel &&
+                       (!dst1 || std::fabs(dst1[frames - 1U]) < IAudioModule::kSilenceLevel)) {
+                    --frames;
+                }
+            }
+            out = SharedClipBuffer{};
+            out.sampleRate = static_cast<int>(std::lround(job.outputSampleRate));
+            out.channels = channels;
+            out.frames = static_cast<int>(frames);
+            out.ch0 = std::shared_ptr<const float[]>(dst0.release(), std::default_delete<float[]>());
+            if (dst1) {
+                out.ch1 = std::shared_ptr<const float[]>(dst1.release(), std::default_delete<float[]>());
+            }
+            return out.valid();
+        }
+
+        bool applyFreeze(const TrackFreezeJob& job, const SharedClipBuffer& frozen) override {
+            if (unfrozenClipCtl_ || !clipCtl_ || job.clipGeneration != clipGenerationCtl_) return false;
+            {
+                const std::lock_guard<std::mutex> lock(modulesMutex_);
+                if (job.fxChainGeneration != fxChainGenCtl_) return false;
+            }
+            auto b = makeClipBuffer_(frozen);
+            if (!b) return false;
+
+            const FreezeGeometry geo = freezeGeometry_(job);
+            b->frozen = true;
+            b->frozenFrom = clipCtl_.get();
+            b->frozenRegionStart = job.regionStart;
+            b->frozenInc = geo.inc;
+            // Исходник держим сами: его же вернет unfreeze(), и RT сверяет с ним frozenFrom.
+            unfrozenClipCtl_ = clipCtl_;
+            publishClip_(std::move(b));
+            return true;
+        }
+
+        bool unfreeze() override {
+            if (!unfrozenClipCtl_) return false;
+            // Сброс цепочки (состояние с момента freeze) делает RT на границе блока,
+            // в котором подхватит исходник: см. fxResetPendingRt_.
+            auto original = std::move(unfrozenClipCtl_);
+            publishClip_(std::move(original));
+            return true;
+        }
+
+        bool isFrozen() const noexcept override {
+            return unfrozenClipCtl_ != nullptr;
         }
 
     private:
         static constexpr std::size_t kFxScratchFrames = 2048;
+        // Верхняя граница хвоста FX в freeze-рендере (и оценка для kInfiniteTailFrames).
+        static constexpr double kFreezeMaxTailSeconds = 30.0;
+        // Верхняя граница полифонии note-режима (голоса предвыделены).
+        static constexpr uint8_t kMaxNoteVoices = 16;
+        // Слоты голосов: вдвое больше полифонии, чтобы украденный/отпущенный голос
+        // дозвучал свой fade-out, пока новый уже играет в свободном слоте.
+        static constexpr uint8_t kNoteVoiceSlots = 2 * kMaxNoteVoices;
+        // Читатели потокового клипа: основной playhead + по одному на слот голоса.
+        static constexpr uint32_t kStreamReadersPerClip = 1U + kNoteVoiceSlots;
+        // Окно кадров потокового клипа под один отрезок рендера (с запасом под cubic).
+        static constexpr std::size_t kStreamWindowFrames = kFxScratchFrames * 4U + 8U;
+        // Длина fade-in нового голоса и fade-out украденного/отпущенного
+        // (и one-shot голоса перед концом региона).
+        static constexpr uint32_t kVoiceFadeSamples = 64;
+        // Емкость очереди sample-accurate команд на трек (RT-only, без аллокаций).
+        static constexpr std::size_t kMaxTimedRtCommands = 64;
+
+        // Каналы клипа в формате хранения: c0/c1 указывают на float, int16_t
+        // или биты half (uint16_t) в зависимости от format; c1 == nullptr — моно.
+        struct ClipSamples {
+            ClipSampleFormat format;
+            const void* c0;
+            const void* c1;
+        };
 
+        // Рендер чанка клипа в dst0/dst1. Диспетчеризация на специализацию
+        // (формат x моно/стерео x loop/one-shot) делается один раз на чанк, а не на сэмпл.
+        // reachedEnd=true: one-shot дошел до конца региона (решение — у вызывающего).
         std::size_t renderClipChunk_(std::size_t maxFrames,
-                                     const float* c0,
-                                     const float* c1,
+                                     const ClipSamples& samples,
                                      int len,
                                      bool loop,
                                      float gain,
@@ -882,64 +1275,518 @@ namespace avantgarde {
                                      std::size_t blockOffset,
                                      int64_t phaseResetFrameInBlock,
                                      double phaseResetPlayhead,
-                                     uint32_t phaseResetFadeSamples) noexcept {
+                                     uint32_t phaseResetFadeSamples,
+                                     float* dst0,
+                                     float* dst1,
+                                     uint32_t& fadeInRemaining,
+                                     bool& reachedEnd) noexcept {
+            reachedEnd = false;
+            const ChunkTail t{len, gain, inc, regionStart, regionEnd, blockOffset,
+                              phaseResetFrameInBlock, phaseResetPlayhead, phaseResetFadeSamples, dst0, dst1};
+            switch (samples.format) {
+                case ClipSampleFormat::Int16:
+                    return renderClipChunkAs_<int16_t>(maxFrames, samples, t, loop, ph, fadeInRemaining, reachedEnd);
+                case ClipSampleFormat::Float16:
+                    return renderClipChunkAs_<uint16_t>(maxFrames, samples, t, loop, ph, fadeInRemaining, reachedEnd);
+                case ClipSampleFormat::Float32:
+                    break;
+            }
+            return renderClipChunkAs_<float>(maxFrames, samples, t, loop, ph, fadeInRemaining, reachedEnd);
+        }
+
+        // Неизменяемые на время чанка параметры рендера (кроме каналов).
+        struct ChunkTail {
+            int len;
+            float gain;
+            double inc;
+            double regionStart;
+            double regionEnd;
+            std::size_t blockOffset;
+            int64_t phaseResetFrameInBlock;
+            double phaseResetPlayhead;
+            uint32_t phaseResetFadeSamples;
+            float* dst0;
+            float* dst1;
+        };
+
+        template <typename S>
+        struct ChunkArgs : ChunkTail {
+            const S* c0;
+            const S* c1;
+        };
+
+        template <typename S>
+        std::size_t renderClipChunkAs_(std::size_t maxFrames,
+                                       const ClipSamples& samples,
+                                       const ChunkTail& t,
+                                       bool loop,
+                                       double& ph,
+                                       uint32_t& fadeInRemaining,
+                                       bool& reachedEnd) noexcept {
+            ChunkArgs<S> a{};
+            static_cast<ChunkTail&>(a) = t;
+            a.c0 = static_cast<const S*>(samples.c0);
+            a.c1 = samples.c1 ? static_cast<const S*>(samples.c1) : a.c0;
+            if (samples.c1) {
+                return loop ? renderClipChunkT_<true, true>(maxFrames, a, ph, fadeInRemaining, reachedEnd)
+                            : renderClipChunkT_<true, false>(maxFrames, a, ph, fadeInRemaining, reachedEnd);
+            }
+            return loop ? renderClipChunkT_<false, true>(maxFrames, a, ph, fadeInRemaining, reachedEnd)
+                        : renderClipChunkT_<false, false>(maxFrames, a, ph, fadeInRemaining, reachedEnd);
+        }
+
+        // Короче этого отрезок быстрее досчитать скалярно.
+        static constexpr std::size_t kMinKernelRun = 8;
+
+        template <bool Stereo, bool Loop, typename S>
+        std::size_t renderClipChunkT_(std::size_t maxFrames,
+                                      const ChunkArgs<S>& a,
+                                      double& ph,
+                                      uint32_t& fadeInRemaining,
+                                      bool& reachedEnd) noexcept {
+            const uint32_t fadeSamples = a.phaseResetFadeSamples;
             std::size_t produced = 0;
-            const double span = std::max(1.0, regionEnd - regionStart);
-            for (; produced < maxFrames; ++produced) {
-                const std::size_t absFrameInBlock = blockOffset + produced;
-                if (phaseResetFrameInBlock >= 0 &&
-                    absFrameInBlock == static_cast<std::size_t>(phaseResetFrameInBlock)) {
-                    ph = std::clamp(phaseResetPlayhead, regionStart, std::max(regionStart, regionEnd - 1.0));
-                    if (phaseResetFadeSamples > 0) {
-                        playbackRt_.phaseResetFadeInRemaining = phaseResetFadeSamples;
+            const double span = std::max(1.0, a.regionEnd - a.regionStart);
+            while (produced < maxFrames) {
+                const std::size_t absFrameInBlock = a.blockOffset + produced;
+                if (a.phaseResetFrameInBlock >= 0 &&
+                    absFrameInBlock == static_cast<std::size_t>(a.phaseResetFrameInBlock)) {
+                    ph = std::clamp(a.phaseResetPlayhead, a.regionStart, std::max(a.regionStart, a.regionEnd - 1.0));
+                    if (fadeSamples > 0) {
+                        fadeInRemaining = fadeSamples;
                     }
                 }
-                if (ph < regionStart) {
-                    ph = regionStart;
+                if (ph < a.regionStart) {
+                    ph = a.regionStart;
                 }
-                if (!loop && ph >= regionEnd) {
-                    // Для followTransport one-shot флаг не используем:
-                    // просто остаемся в "конце клипа" и выдаем тишину до retrigger.
-                    if (playbackRt_.followTransport) {
-                        ph = regionEnd;
-                    } else {
-                        // В one-shot режиме конец клипа автоматически гасит local gate.
-                        playbackRt_.oneshotRunning = false;
-                        ph = regionStart;
+                if constexpr (!Loop) {
+                    if (ph >= a.regionEnd) {
+                        reachedEnd = true;
+                        break;
                     }
-                    break;
+                } else {
+                    while (ph >= a.regionEnd) ph -= span;
+                    while (ph < a.regionStart) ph += span;
                 }
 
-                while (loop && ph >= regionEnd) ph -= span;
-                while (loop && ph < regionStart) ph += span;
+                // Быстрый путь: векторное ядро на отрезке без событий и границ.
+                const std::size_t run = kernelRunLength_(maxFrames - produced, absFrameInBlock, a.len, a.inc,
+                                                         a.regionEnd, ph, a.phaseResetFrameInBlock,
+                                                         fadeSamples, fadeInRemaining);
+                if (run >= kMinKernelRun) {
+                    clip_kernel::CubicRunT<S> r{};
+                    r.c0 = a.c0;
+                    r.c1 = a.c1;
+                    r.inc = a.inc;
+                    r.gain = a.gain;
+                    r.out0 = a.dst0 + produced;
+                    r.out1 = a.dst1 + produced;
+                    if (fadeInRemaining > 0 && fadeSamples > 0) {
+                        // Линейный fade-in после phase-jump: (done + 1) / F.
+                        r.fadeNum0 = static_cast<int32_t>(fadeSamples - fadeInRemaining + 1U);
+                        r.fadeStep = 1;
+                        r.fadeDen = static_cast<float>(fadeSamples);
+                        clip_kernel::renderCubicRun<Stereo, true>(r, ph, run);
+                        fadeInRemaining -= static_cast<uint32_t>(run);
+                    } else if (fadeOutActive_(absFrameInBlock, a.phaseResetFrameInBlock, fadeSamples)) {
+                        // Линейный fade-out перед phase-jump: dist / F.
+                        r.fadeNum0 = static_cast<int32_t>(static_cast<std::size_t>(a.phaseResetFrameInBlock) -
+                                                          absFrameInBlock);
+                        r.fadeStep = -1;
+                        r.fadeDen = static_cast<float>(fadeSamples);
+                        clip_kernel::renderCubicRun<Stereo, true>(r, ph, run);
+                    } else {
+                        clip_kernel::renderCubicRun<Stereo, false>(r, ph, run);
+                    }
+                    produced += run;
+                    continue;
+                }
 
-                const float src0 = detail_interp::sampleCubic(c0, len, ph, loop);
-                const float src1 = c1 ? detail_interp::sampleCubic(c1, len, ph, loop) : src0;
+                // Скалярный путь: края клипа/региона, wrap, перекрытие fade-ов.
+                const float src0 = detail_interp::sampleCubic(a.c0, a.len, ph, Loop);
+                const float src1 = Stereo ? detail_interp::sampleCubic(a.c1, a.len, ph, Loop) : src0;
 
                 float edgeFade = 1.0f;
-                if (phaseResetFrameInBlock >= 0 &&
-                    absFrameInBlock < static_cast<std::size_t>(phaseResetFrameInBlock) &&
-                    phaseResetFadeSamples > 0) {
-                    const std::size_t dist = static_cast<std::size_t>(phaseResetFrameInBlock) - absFrameInBlock;
-                    if (dist <= phaseResetFadeSamples) {
-                        edgeFade = std::min(edgeFade,
-                                            static_cast<float>(dist) / static_cast<float>(phaseResetFadeSamples));
-                    }
+                if (fadeOutActive_(absFrameInBlock, a.phaseResetFrameInBlock, fadeSamples)) {
+                    const std::size_t dist = static_cast<std::size_t>(a.phaseResetFrameInBlock) - absFrameInBlock;
+                    edgeFade = std::min(edgeFade, static_cast<float>(dist) / static_cast<float>(fadeSamples));
                 }
-                if (playbackRt_.phaseResetFadeInRemaining > 0 && phaseResetFadeSamples > 0) {
-                    const uint32_t done = phaseResetFadeSamples - playbackRt_.phaseResetFadeInRemaining;
-                    const float in = static_cast<float>(done + 1U) / static_cast<float>(phaseResetFadeSamples);
+                if (fadeInRemaining > 0 && fadeSamples > 0) {
+                    const uint32_t done = fadeSamples - fadeInRemaining;
+                    const float in = static_cast<float>(done + 1U) / static_cast<float>(fadeSamples);
                     edgeFade = std::min(edgeFade, detail_interp::clampf(in, 0.0f, 1.0f));
-                    --playbackRt_.phaseResetFadeInRemaining;
+                    --fadeInRemaining;
                 }
 
-                fxA0_[produced] = src0 * gain * edgeFade;
-                fxA1_[produced] = src1 * gain * edgeFade;
-                ph += inc;
+                a.dst0[produced] = src0 * a.gain * edgeFade;
+                a.dst1[produced] = src1 * a.gain * edgeFade;
+                ph += a.inc;
+                ++produced;
             }
             return produced;
         }
 
+        // Голос полифонического note-режима: свой playhead поверх общего клипа.
+        struct NoteVoice {
+            double playhead = 0.0;
+            // Порядковый номер старта (для stealing "oldest").
+            uint64_t serial = 0;
+            // Пиковый уровень последнего чанка (для stealing "quietest").
+            float level = 0.0f;
+            uint32_t fadeInRemaining = 0;
+            // > 0: голос отпущен/украден и доигрывает fade-out (в полифонию не входит).
+            uint32_t fadeOutRemaining = 0;
+            uint16_t note = 0;
+            bool active = false;
+        };
+
+        bool notePolyActiveRt_() const noexcept {
+            return notePolyphonyRt_ > 1 &&
+                   playbackRt_.playbackMode == TrackPlaybackModeValue::Note &&
+                   !playbackRt_.followTransport;
+        }
+
+        // Используемые слоты: под каждый звучащий голос — еще один под его хвост.
+        uint8_t noteVoiceSlotsRt_() const noexcept {
+            return static_cast<uint8_t>(std::min<uint32_t>(kNoteVoiceSlots, 2U * notePolyphonyRt_));
+        }
+
+        bool anyVoiceActiveRt_() const noexcept {
+            for (uint8_t i = 0; i < noteVoiceSlotsRt_(); ++i) {
+                if (noteVoices_[i].active) return true;
+            }
+            return false;
+        }
+
+        void clearNoteVoicesRt_() noexcept {
+            for (auto& v : noteVoices_) {
+                v.active = false;
+                v.fadeOutRemaining = 0;
+            }
+        }
+
+        double latestVoicePlayheadRt_(double fallback) const noexcept {
+            const NoteVoice* latest = nullptr;
+            for (uint8_t i = 0; i < noteVoiceSlotsRt_(); ++i) {
+                const NoteVoice& v = noteVoices_[i];
+                if (v.active && v.fadeOutRemaining == 0 && (!latest || v.serial > latest->serial)) latest = &v;
+            }
+            return latest ? latest->playhead : fallback;
+        }
+
+        void startNoteVoiceRt_(uint16_t note) noexcept {
+            if (!playbackRt_.clip || playbackRt_.clip->frames <= 0) {
+                return;
+            }
+            NoteVoice* slot = nullptr;
+            NoteVoice* victim = nullptr;
+            NoteVoice* shortestTail = nullptr;
+            uint8_t sounding = 0;
+            for (uint8_t i = 0; i < noteVoiceSlotsRt_(); ++i) {
+                NoteVoice& v = noteVoices_[i];
+                if (!v.active) {
+                    if (!slot) slot = &v;
+                    continue;
+                }
+                if (v.fadeOutRemaining > 0) {
+                    if (!shortestTail || v.fadeOutRemaining < shortestTail->fadeOutRemaining) shortestTail = &v;
+                    continue;
+                }
+                if (v.note == note &&
+                    playbackRt_.launchPolicy == TrackLaunchPolicyValue::IgnoreIfPlaying) {
+                    // IgnoreIfPlaying действует по-нотно: та же клавиша не перезапускается.
+                    return;
+                }
+                ++sounding;
+                const bool better = !victim ||
+                    ((voiceStealRt_ == VoiceStealPolicyValue::Quietest)
+                         ? (v.level < victim->level || (v.level == victim->level && v.serial < victim->serial))
+                         : (v.serial < victim->serial));
+                if (better) victim = &v;
+            }
+            if (sounding >= notePolyphonyRt_ && victim) {
+                // Все голоса заняты: крадем по политике (oldest/quietest), но жертва
+                // не обрывается, а гаснет за kVoiceFadeSamples рядом с новым голосом.
+                victim->fadeOutRemaining = kVoiceFadeSamples;
+            }
+            if (!slot) {
+                // Свободных слотов нет только при частых steal внутри fade-out:
+                // жертвуем хвостом, которому осталось доиграть меньше всего.
+                slot = shortestTail ? shortestTail : victim;
+            }
+            if (!slot) {
+                return;
+            }
+            slot->playhead = clipRegionStartFrameRt_();
+            slot->serial = ++noteVoiceSerial_;
+            slot->level = 1.0f;
+            slot->fadeInRemaining = kVoiceFadeSamples;
+            slot->fadeOutRemaining = 0;
+            slot->note = note;
+            slot->active = true;
+            playbackRt_.oneshotRunning = true;
+        }
+
+        void releaseNoteVoicesRt_(uint16_t note) noexcept {
+            if (playbackRt_.stopPolicy != TrackStopPolicyValue::ByNoteOff) {
+                return;
+            }
+            for (uint8_t i = 0; i < noteVoiceSlotsRt_(); ++i) {
+                NoteVoice& v = noteVoices_[i];
+                if (v.active && v.fadeOutRemaining == 0 && v.note == note) v.fadeOutRemaining = kVoiceFadeSamples;
+            }
+            if (!anyVoiceActiveRt_()) {
+                playbackRt_.oneshotRunning = false;
+            }
+        }
+
+        // Рендер одного голоса в fxB0_/fxB1_ на chunk кадров. Fade-out хвоста —
+        // это fade-out ядра перед phase reset, который стоит сразу за последним
+        // кадром хвоста и поэтому не наступает. One-shot голос заранее уходит
+        // в fade-out так, чтобы тот закончился ровно на конце региона.
+        std::size_t renderNoteVoice_(NoteVoice& v,
+                                     int reader,
+                                     std::size_t chunk,
+                                     const ClipSamples& samples,
+                                     int len,
+                                     bool loop,
+                                     float gain,
+                                     double inc,
+                                     double regionStart,
+                                     double regionEnd) noexcept {
+            const ClipBuffer* clip = playbackRt_.clip;
+            std::size_t done = 0;
+            while (done < chunk && v.active) {
+                std::size_t want = chunk - done;
+                if (!loop && v.fadeOutRemaining == 0) {
+                    const double toEnd = std::ceil((regionEnd - v.playhead) / inc);
+                    if (toEnd <= static_cast<double>(kVoiceFadeSamples)) {
+                        v.fadeOutRemaining = static_cast<uint32_t>(std::max(1.0, toEnd));
+                    } else {
+                        want = std::min(want, static_cast<std::size_t>(toEnd) - kVoiceFadeSamples);
+                    }
+                }
+                int64_t fadeOutEnd = -1;
+                if (v.fadeOutRemaining > 0) {
+                    want = std::min<std::size_t>(want, v.fadeOutRemaining);
+                    fadeOutEnd = static_cast<int64_t>(v.fadeOutRemaining);
+                }
+                bool reachedEnd = false;
+                const std::size_t n =
+                    (clip && clip->stream)
+                        ? renderStreamChunk_(want, *clip, reader, loop, gain, inc, regionStart, regionEnd,
+                                             v.playhead, 0, fadeOutEnd, v.playhead, kVoiceFadeSamples,
+                                             fxB0_.data() + done, fxB1_.data() + done, v.fadeInRemaining,
+                                             reachedEnd)
+                        : renderClipChunk_(want, samples, len, loop, gain, inc, regionStart, regionEnd,
+                                           v.playhead, 0, fadeOutEnd, v.playhead, kVoiceFadeSamples,
+                                           fxB0_.data() + done, fxB1_.data() + done, v.fadeInRemaining,
+                                           reachedEnd);
+                done += n;
+                if (v.fadeOutRemaining > 0) {
+                    v.fadeOutRemaining -= std::min<uint32_t>(v.fadeOutRemaining, static_cast<uint32_t>(n));
+                    if (v.fadeOutRemaining == 0) {
+                        v.active = false;
+                    }
+                }
+                if (reachedEnd || n == 0) {
+                    v.active = false;
+                    v.fadeOutRemaining = 0;
+                }
+            }
+            return done;
+        }
+
+        // Рендер всех активных голосов в fxA0_/fxA1_: каждый голос считается ядром
+        // в fxB0_/fxB1_ (свободны до FX-стадии) и векторно подмешивается в сумму.
+        std::size_t renderNoteVoicesChunk_(std::size_t chunk,
+                                           const ClipSamples& samples,
+                                           int len,
+                                           bool loop,
+                                           float gain,
+                                           double inc,
+                                           double regionStart,
+                                           double regionEnd) noexcept {
+            std::fill_n(fxA0_.data(), chunk, 0.0f);
+            std::fill_n(fxA1_.data(), chunk, 0.0f);
+            const int readerBase = playbackRt_.clip ? playbackRt_.clip->streamReader + 1 : 0;
+            for (uint8_t i = 0; i < noteVoiceSlotsRt_(); ++i) {
+                NoteVoice& v = noteVoices_[i];
+                if (!v.active) continue;
+                const std::size_t n =
+                    renderNoteVoice_(v, readerBase + i, chunk, samples, len, loop, gain, inc, regionStart, regionEnd);
+                v.level = clip_kernel::mixAddPeak(fxA0_.data(), fxB0_.data(), n);
+                (void)clip_kernel::mixAddPeak(fxA1_.data(), fxB1_.data(), n);
+            }
+            return chunk;
+        }
+
+        // Продвижение playhead без рендера (muted): та же семантика phase reset,
+        // wrap и конца региона, что у renderClipChunkT_, но O(событий) вместо O(кадров).
+        static std::size_t advanceClipChunk_(std::size_t maxFrames,
+                                             bool loop,
+                                             double inc,
+                                             double regionStart,
+                                             double regionEnd,
+                                             double& ph,
+                                             std::size_t blockOffset,
+                                             int64_t phaseResetFrameInBlock,
+                                             double phaseResetPlayhead,
+                                             uint32_t phaseResetFadeSamples,
+                                             uint32_t& fadeInRemaining,
+                                             bool& reachedEnd) noexcept {
+            reachedEnd = false;
+            std::size_t produced = 0;
+            const double span = std::max(1.0, regionEnd - regionStart);
+            while (produced < maxFrames) {
+                const std::size_t absFrameInBlock = blockOffset + produced;
+                std::size_t run = maxFrames - produced;
+                if (phaseResetFrameInBlock >= 0) {
+                    const std::size_t resetAt = static_cast<std::size_t>(phaseResetFrameInBlock);
+                    if (absFrameInBlock == resetAt) {
+                        ph = std::clamp(phaseResetPlayhead, regionStart, std::max(regionStart, regionEnd - 1.0));
+                        if (phaseResetFadeSamples > 0) {
+                            fadeInRemaining = phaseResetFadeSamples;
+                        }
+                    } else if (absFrameInBlock < resetAt) {
+                        run = std::min(run, resetAt - absFrameInBlock);
+                    }
+                }
+                if (ph < regionStart) {
+                    ph = regionStart;
+                }
+                if (!loop) {
+                    if (ph >= regionEnd) {
+                        reachedEnd = true;
+                        break;
+                    }
+                } else {
+                    while (ph >= regionEnd) ph -= span;
+                    while (ph < regionStart) ph += span;
+                }
+                // Кадров с ph_k < regionEnd до wrap/конца региона.
+                const double toEnd = std::ceil((regionEnd - ph) / inc);
+                if (toEnd < static_cast<double>(run)) {
+                    run = std::max<std::size_t>(1U, static_cast<std::size_t>(toEnd));
+                }
+                ph += static_cast<double>(run) * inc;
+                if (phaseResetFadeSamples > 0) {
+                    fadeInRemaining -= std::min<uint32_t>(fadeInRemaining, static_cast<uint32_t>(run));
+                }
+                produced += run;
+            }
+            return produced;
+        }
+
+        // Muted-аналог renderNoteVoicesChunk_: голоса идут и гаснут на конце региона
+        // без рендера (level для stealing "quietest" остается от последнего рендера).
+        std::size_t advanceNoteVoicesChunk_(std::size_t chunk,
+                                            bool loop,
+                                            double inc,
+                                            double regionStart,
+                                            double regionEnd) noexcept {
+            for (uint8_t i = 0; i < noteVoiceSlotsRt_(); ++i) {
+                NoteVoice& v = noteVoices_[i];
+                if (!v.active) continue;
+                if (v.fadeOutRemaining > 0) {
+                    // Хвост в muted не слышен: слот освобождается сразу.
+                    v.active = false;
+                    v.fadeOutRemaining = 0;
+                    continue;
+                }
+                bool reachedEnd = false;
+                (void)advanceClipChunk_(chunk, loop, inc, regionStart, regionEnd, v.playhead, 0, -1, v.playhead,
+                                        kVoiceFadeSamples, v.fadeInRemaining, reachedEnd);
+                const ClipBuffer* clip = playbackRt_.clip;
+                if (clip && clip->stream) {
+                    const int reader = clip->streamReader + 1 + i;
+                    clip->stream->setRegionRt(reader, static_cast<int64_t>(regionStart),
+                                              static_cast<int64_t>(std::ceil(regionEnd)), loop);
+                    (void)clip->stream->readRt(reader, static_cast<int64_t>(v.playhead), 0, nullptr, nullptr);
+                }
+                if (reachedEnd) {
+                    v.active = false;
+                }
+            }
+            return chunk;
+        }
+
+        // Весь чанк ниже IAudioModule::kSilenceLevel (ранний выход на первом слышимом сэмпле).
+        static bool isQuietChunk_(const float* a, const float* b, std::size_t n) noexcept {
+            constexpr float kLevel = IAudioModule::kSilenceLevel;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (std::fabs(a[i]) >= kLevel || std::fabs(b[i]) >= kLevel) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static uint64_t satAdd_(uint64_t a, uint64_t b) noexcept {
+            return (a > UINT64_MAX - b) ? UINT64_MAX : a + b;
+        }
+
+        static bool fadeOutActive_(std::size_t absFrameInBlock,
+                                   int64_t phaseResetFrameInBlock,
+                                   uint32_t phaseResetFadeSamples) noexcept {
+            if (phaseResetFrameInBlock < 0 || phaseResetFadeSamples == 0 ||
+                absFrameInBlock >= static_cast<std::size_t>(phaseResetFrameInBlock)) {
+                return false;
+            }
+            return static_cast<std::size_t>(phaseResetFrameInBlock) - absFrameInBlock <= phaseResetFadeSamples;
+        }
+
+        // Сколько кадров подряд (начиная с текущего) можно отдать векторному ядру:
+        // без phase reset, без смены fade-режима, без wrap/конца региона и
+        // с 4 тапами строго внутри клипа. 0 — считать скалярно.
+        static std::size_t kernelRunLength_(std::size_t maxRun,
+                                     std::size_t absFrameInBlock,
+                                     int len,
+                                     double inc,
+                                     double regionEnd,
+                                     double ph,
+                                     int64_t phaseResetFrameInBlock,
+                                     uint32_t phaseResetFadeSamples,
+                                     uint32_t fadeIn) noexcept {
+            if (ph < 1.0 || len < 4) {
+                return 0;
+            }
+            // Фаза: ph_k < regionEnd (нет wrap/конца) и floor(ph_k) + 2 <= len - 1.
+            // Запас в 1 кадр страхует от округления при накоплении ph += inc.
+            const double limit = std::min(regionEnd, static_cast<double>(len - 2));
+            if (ph >= limit) {
+                return 0;
+            }
+            const double byPhase = (limit - ph) / inc;
+            std::size_t run = (byPhase >= static_cast<double>(maxRun) + 1.0)
+                                  ? maxRun
+                                  : static_cast<std::size_t>(std::max(0.0, byPhase - 1.0));
+
+            const bool fadeInActive = (fadeIn > 0 && phaseResetFadeSamples > 0);
+            if (fadeInActive) {
+                run = std::min<std::size_t>(run, fadeIn);
+            }
+            if (phaseResetFrameInBlock >= 0) {
+                const std::size_t resetAt = static_cast<std::size_t>(phaseResetFrameInBlock);
+                if (absFrameInBlock < resetAt) {
+                    // Не перешагиваем кадр phase reset.
+                    run = std::min(run, resetAt - absFrameInBlock);
+                    if (phaseResetFadeSamples > 0) {
+                        const std::size_t fadeOutStart =
+                            (resetAt > phaseResetFadeSamples) ? (resetAt - phaseResetFadeSamples) : 0U;
+                        if (absFrameInBlock < fadeOutStart) {
+                            // До окна fade-out — отрезок без fade-out.
+                            run = std::min(run, fadeOutStart - absFrameInBlock);
+                        } else if (fadeInActive) {
+                            // Перекрытие fade-in и fade-out (min двух рамп) — скалярно.
+                            return 0;
+                        }
+                    }
+                }
+            }
+            return run;
+        }
+
         struct ClipBuffer {
             int sampleRate = 0;
             int channels = 0; // 1 or 2
@@ -947,9 +1794,214 @@ namespace avantgarde {
 
             // Разделяемое владение каналами позволяет быстро переключать клипы
             // между треками/паттернами без повторного декодирования и копирования.
+            // Компактный клип (format != Float32) владеет ch*Packed, а ch[] указывает
+            // на них: RT читает каналы в формате хранения (см. ClipSamples).
+            ClipSampleFormat format = ClipSampleFormat::Float32;
             std::shared_ptr<const float[]> ch0Shared;
             std::shared_ptr<const float[]> ch1Shared;
-            const float* ch[2] = {nullptr, nullptr};
+            std::shared_ptr<const int16_t[]> ch0Packed;
+            std::shared_ptr<const int16_t[]> ch1Packed;
+            const void* ch[2] = {nullptr, nullptr};
+
+            // Freeze: буфер — offline-рендер клипа frozenFrom через FX-цепочку трека
+            // (уже в output rate, speed и trim запечены). Кадр k замороженного буфера
+            // соответствует позиции frozenRegionStart + k * frozenInc в исходном клипе.
+            bool frozen = false;
+            const ClipBuffer* frozenFrom = nullptr;
+            double frozenRegionStart = 0.0;
+            double frozenInc = 1.0;
+
+            // Потоковый клип: ch[] — только голова (residentFrames кадров), остальное
+            // читается через stream. Читатели: streamReader — основной playhead,
+            // streamReader + 1 + i — голос i note-режима.
+            std::shared_ptr<IClipStream> stream;
+            int residentFrames = 0;
+            int streamReader = -1;
+
+            // Анализ для tempo sync Stretch (ClipStretchAnalysis.h); nullptr — только varispeed.
+            std::shared_ptr<const ClipStretchAnalysis> stretch;
+
+            ClipBuffer() = default;
+            ClipBuffer(const ClipBuffer&) = delete;
+            ClipBuffer& operator=(const ClipBuffer&) = delete;
+            ~ClipBuffer() {
+                if (stream) {
+                    stream->closeReaders(streamReader, kStreamReadersPerClip);
+                }
+            }
+        };
+
+        // Рендер чанка потокового клипа: playhead режется на отрезки, кадры каждого
+        // отрезка (с соседями для cubic) копируются из потока в окно streamWin*_,
+        // и окно играется обычным renderClipChunk_ в локальных координатах.
+        // Phase reset и wrap лупа делаются здесь, на границах отрезков, в координатах клипа.
+        std::size_t renderStreamChunk_(std::size_t maxFrames,
+                                       const ClipBuffer& clip,
+                                       int reader,
+                                       bool loop,
+                                       float gain,
+                                       double inc,
+                                       double regionStart,
+                                       double regionEnd,
+                                       double& ph,
+                                       std::size_t blockOffset,
+                                       int64_t phaseResetFrameInBlock,
+                                       double phaseResetPlayhead,
+                                       uint32_t phaseResetFadeSamples,
+                                       float* dst0,
+                                       float* dst1,
+                                       uint32_t& fadeInRemaining,
+                                       bool& reachedEnd) noexcept {
+            reachedEnd = false;
+            if (streamWin0_.size() < kStreamWindowFrames) {
+                return 0;
+            }
+            IClipStream& stream = *clip.stream;
+            stream.setRegionRt(reader, static_cast<int64_t>(regionStart), static_cast<int64_t>(std::ceil(regionEnd)), loop);
+            float* win0 = streamWin0_.data();
+            float* win1 = (clip.channels == 2) ? streamWin1_.data() : nullptr;
+            // Сколько кадров выхода помещается в окно: floor(ph) - 1 .. floor(ph + (run - 1) * inc) + 2.
+            const std::size_t maxRun =
+                std::max<std::size_t>(1, static_cast<std::size_t>(static_cast<double>(kStreamWindowFrames - 5U) / inc));
+            const double span = std::max(1.0, regionEnd - regionStart);
+            std::size_t produced = 0;
+            while (produced < maxFrames) {
+                const std::size_t absFrameInBlock = blockOffset + produced;
+                std::size_t run = std::min(maxFrames - produced, maxRun);
+                if (phaseResetFrameInBlock >= 0) {
+                    const std::size_t resetAt = static_cast<std::size_t>(phaseResetFrameInBlock);
+                    if (absFrameInBlock == resetAt) {
+                        ph = std::clamp(phaseResetPlayhead, regionStart, std::max(regionStart, regionEnd - 1.0));
+                        if (phaseResetFadeSamples > 0) {
+                            fadeInRemaining = phaseResetFadeSamples;
+                        }
+                    } else if (absFrameInBlock < resetAt) {
+                        run = std::min(run, resetAt - absFrameInBlock);
+                    }
+                }
+                if (ph < regionStart) {
+                    ph = regionStart;
+                }
+                if (ph >= regionEnd) {
+                    if (!loop) {
+                        reachedEnd = true;
+                        break;
+                    }
+                    while (ph >= regionEnd) ph -= span;
+                    while (ph < regionStart) ph += span;
+                }
+
+                // Отрезок не заходит за конец региона: поток держит за ним только соседей cubic.
+                const double toEnd = std::ceil((regionEnd - ph) / inc);
+                run = std::min(run, static_cast<std::size_t>(std::max(1.0, toEnd)));
+                const double last = ph + static_cast<double>(run - 1U) * inc;
+                const int64_t winStart = std::max<int64_t>(0, static_cast<int64_t>(std::floor(ph)) - 1);
+                const int64_t winEnd = std::min<int64_t>(clip.frames, static_cast<int64_t>(std::floor(last)) + 3);
+                const int winLen = static_cast<int>(winEnd - winStart);
+                // Недокачанные кадры приходят нулями (и считаются в underruns потока).
+                (void)stream.readRt(reader, winStart, static_cast<uint32_t>(winLen), win0, win1);
+
+                const double origin = static_cast<double>(winStart);
+                double localPh = ph - origin;
+                bool segmentEnd = false;
+                // Wrap лупа — забота этого цикла: внутри окна отрезок всегда one-shot.
+                const ClipSamples window{ClipSampleFormat::Float32, win0, win1};
+                const std::size_t n = renderClipChunk_(run, window, winLen, false, gain, inc,
+                                                       regionStart - origin, regionEnd - origin, localPh,
+                                                       absFrameInBlock, phaseResetFrameInBlock,
+                                                       phaseResetPlayhead - origin, phaseResetFadeSamples,
+                                                       dst0 + produced, dst1 + produced, fadeInRemaining,
+                                                       segmentEnd);
+                ph = localPh + origin;
+                produced += n;
+                if (segmentEnd && !loop) {
+                    reachedEnd = true;
+                    break;
+                }
+            }
+            return produced;
+        }
+
+        // Рендер чанка в режиме tempo sync Stretch. Playhead ph идет с шагом inc, как в
+        // renderClipChunk_, и задает stretcher_ позицию каждого нового grain-а; grain читается
+        // с шагом rate (только компенсация частоты клипа). Phase reset — realign() вместо
+        // fade: переход на новую позицию дает перекрытие grain-ов.
+        std::size_t renderStretchChunk_(std::size_t maxFrames,
+                                        const ClipBuffer& clip,
+                                        bool loop,
+                                        float gain,
+                                        double inc,
+                                        double rate,
+                                        double regionStart,
+                                        double regionEnd,
+                                        double& ph,
+                                        std::size_t blockOffset,
+                                        int64_t phaseResetFrameInBlock,
+                                        double phaseResetPlayhead,
+                                        float* dst0,
+                                        float* dst1,
+                                        bool& reachedEnd) noexcept {
+            reachedEnd = false;
+            WsolaSource src{};
+            src.format = clip.format;
+            src.c0 = clip.ch[0];
+            src.c1 = (clip.channels == 2) ? clip.ch[1] : nullptr;
+            src.frames = clip.frames;
+            src.regionStart = regionStart;
+            src.regionEnd = regionEnd;
+            src.loop = loop;
+            src.analysis = clip.stretch.get();
+            const double span = std::max(1.0, regionEnd - regionStart);
+            std::size_t produced = 0;
+            while (produced < maxFrames) {
+                const std::size_t absFrameInBlock = blockOffset + produced;
+                std::size_t run = maxFrames - produced;
+                if (phaseResetFrameInBlock >= 0) {
+                    const std::size_t resetAt = static_cast<std::size_t>(phaseResetFrameInBlock);
+                    if (absFrameInBlock == resetAt) {
+                        ph = std::clamp(phaseResetPlayhead, regionStart, std::max(regionStart, regionEnd - 1.0));
+                        stretcher_.realign();
+                    } else if (absFrameInBlock < resetAt) {
+                        run = std::min(run, resetAt - absFrameInBlock);
+                    }
+                }
+                if (ph < regionStart) {
+                    ph = regionStart;
+                }
+                if (ph >= regionEnd) {
+                    if (!loop) {
+                        reachedEnd = true;
+                        break;
+                    }
+                    // Wrap лупа stretcher_ видит сам: следующий grain встает к новому ph.
+                    while (ph >= regionEnd) ph -= span;
+                    while (ph < regionStart) ph += span;
+                }
+                const double toEnd = std::ceil((regionEnd - ph) / inc);
+                run = std::min(run, static_cast<std::size_t>(std::max(1.0, toEnd)));
+                const std::size_t n = stretcher_.render(src, ph, rate, gain, dst0 + produced, dst1 + produced, run);
+                if (n == 0) {
+                    break;
+                }
+                ph += static_cast<double>(n) * inc;
+                produced += n;
+            }
+            return produced;
+        }
+
+        // Слот FX-цепочки: модуль + enabled-флаг.
+        // Разделяется между поколениями снапшотов, поэтому enabled переживает add/remove соседей.
+        struct FxSlot {
+            std::shared_ptr<IAudioModule> module;
+            // Пишется только RT (ParamSet Enabled), читается RT.
+            std::atomic<uint8_t> enabled{1U};
+        };
+
+        // Неизменяемый снапшот FX-цепочки, который читает RT.
+        // После публикации не модифицируется; освобождается только control-потоком.
+        struct FxChainSnapshot {
+            uint64_t generation = 0;
+            std::vector<std::shared_ptr<FxSlot>> slots;
         };
 
         struct ClipPlaybackRtState {
@@ -971,8 +2023,12 @@ namespace avantgarde {
             uint8_t transportTsDen = 4;
             // Режим автоматического пересчета playbackInc под target bars.
             bool stretchToBars = false;
+            // Как stretchToBars подгоняет клип: varispeed или time-stretch без сдвига высоты.
+            TempoSyncModeValue tempoSyncMode = TempoSyncModeValue::Varispeed;
             // Линейный трековый gain [0..1] перед FX-цепочкой.
             float gain = 1.0f;
+            // Посылы выхода трека в aux-шины движка [0..1] (после FX-цепочки и mute).
+            std::array<float, kMaxAuxBuses> auxSend{};
             // Mute-гейт: если true, в master ничего не пишем, но фаза не останавливается.
             bool muted = false;
             // Arm-флаг трека (используется записью/овердабом).
@@ -1027,31 +2083,61 @@ namespace avantgarde {
             return (v <= 0) ? TrackStopPolicyValue::ManualStop : TrackStopPolicyValue::ByNoteOff;
         }
 
-        double clipRegionStartFrameRt_() const noexcept {
-            const ClipBuffer* clip = playbackRt_.clip;
-            if (!clip || clip->frames <= 1) {
+        static TempoSyncModeValue parseTempoSyncMode_(float value) noexcept {
+            const int v = static_cast<int>(std::lround(value));
+            return (v <= 0) ? TempoSyncModeValue::Varispeed : TempoSyncModeValue::Stretch;
+        }
+
+        static double regionStartFrame_(int frames, float startNorm) noexcept {
+            if (frames <= 1) {
                 return 0.0;
             }
-            const double maxIndex = static_cast<double>(clip->frames - 1);
-            const double start = static_cast<double>(
-                detail_interp::clampf(playbackRt_.startNorm, 0.0f, 0.99f)) * maxIndex;
+            const double maxIndex = static_cast<double>(frames - 1);
+            const double start = static_cast<double>(detail_interp::clampf(startNorm, 0.0f, 0.99f)) * maxIndex;
             return std::clamp(start, 0.0, maxIndex);
         }
 
-        double clipRegionEndFrameRt_() const noexcept {
-            const ClipBuffer* clip = playbackRt_.clip;
-            if (!clip || clip->frames <= 1) {
+        static double regionEndFrame_(int frames, float startNorm, float endNorm) noexcept {
+            if (frames <= 1) {
                 return 1.0;
             }
-            const double totalFrames = static_cast<double>(clip->frames);
-            const double start = clipRegionStartFrameRt_();
-            double end = static_cast<double>(detail_interp::clampf(playbackRt_.endNorm, 0.01f, 1.0f)) * totalFrames;
+            const double totalFrames = static_cast<double>(frames);
+            const double start = regionStartFrame_(frames, startNorm);
+            double end = static_cast<double>(detail_interp::clampf(endNorm, 0.01f, 1.0f)) * totalFrames;
             if (end <= start + 1.0) {
                 end = std::min(totalFrames, start + 1.0);
             }
             return std::clamp(end, start + 1.0, totalFrames);
         }
 
+        // Замороженный буфер играется целиком: trim уже запечен в рендер.
+        double clipRegionStartFrameRt_() const noexcept {
+            const ClipBuffer* clip = playbackRt_.clip;
+            if (!clip || clip->frozen) {
+                return 0.0;
+            }
+            return regionStartFrame_(clip->frames, playbackRt_.startNorm);
+        }
+
+        double clipRegionEndFrameRt_() const noexcept {
+            const ClipBuffer* clip = playbackRt_.clip;
+            if (!clip) {
+                return 1.0;
+            }
+            if (clip->frozen) {
+                return static_cast<double>(std::max(1, clip->frames));
+            }
+            return regionEndFrame_(clip->frames, playbackRt_.startNorm, playbackRt_.endNorm);
+        }
+
+        // Пользовательский speed; у замороженного буфера он уже запечен.
+        double clipSpeedRt_() const noexcept {
+            if (playbackRt_.clip && playbackRt_.clip->frozen) {
+                return 1.0;
+            }
+            return static_cast<double>(detail_interp::clampf(playbackRt_.playbackInc, 0.05f, 8.0f));
+        }
+
         // Унифицированный запуск one-shot playback по trigger/note-on.
         // Поведение зависит от launchPolicy:
         // - IgnoreIfPlaying: если трек уже играет, новый trigger игнорируем;
@@ -1083,8 +2169,8 @@ namespace avantgarde {
             return kNoMeta;
         }
 
-        static const std::array<ParamMeta, 13>& trackParamMeta_() {
-            static const std::array<ParamMeta, 13> kMeta{{
+        static const std::array<ParamMeta, 18>& trackParamMeta_() {
+            static const std::array<ParamMeta, 18> kMeta{{
                 ParamMeta{.name = "track.gain", .minValue = 0.0f, .maxValue = 1.0f, .logarithmic = false, .unit = "norm"},
                 ParamMeta{.name = "track.loop", .minValue = 0.0f, .maxValue = 1.0f, .logarithmic = false, .unit = "bool"},
                 ParamMeta{.name = "track.playback_inc", .minValue = 0.05f, .maxValue = 8.0f, .logarithmic = false, .unit = "ratio"},
@@ -1098,6 +2184,11 @@ namespace avantgarde {
                 ParamMeta{.name = "track.end_norm", .minValue = 0.0f, .maxValue = 1.0f, .logarithmic = false, .unit = "norm"},
                 ParamMeta{.name = "track.playhead_norm", .minValue = 0.0f, .maxValue = 1.0f, .logarithmic = false, .unit = "readonly"},
                 ParamMeta{.name = "track.tempo_sync", .minValue = 0.0f, .maxValue = 1.0f, .logarithmic = false, .unit = "bool"},
+                ParamMeta{.name = "track.send_a", .minValue = 0.0f, .maxValue = 1.0f, .logarithmic = false, .unit = "norm"},
+                ParamMeta{.name = "track.send_b", .minValue = 0.0f, .maxValue = 1.0f, .logarithmic = false, .unit = "norm"},
+                ParamMeta{.name = "track.send_c", .minValue = 0.0f, .maxValue = 1.0f, .logarithmic = false, .unit = "norm"},
+                ParamMeta{.name = "track.send_d", .minValue = 0.0f, .maxValue = 1.0f, .logarithmic = false, .unit = "norm"},
+                ParamMeta{.name = "track.tempo_sync_mode", .minValue = 0.0f, .maxValue = 1.0f, .logarithmic = false, .unit = "enum"},
             }};
             return kMeta;
         }
@@ -1158,6 +2249,7 @@ namespace avantgarde {
                     // При смене режима сбрасываем note-state, чтобы избежать "залипших" нот.
                     playbackRt_.noteHeld = false;
                     playbackRt_.noteDetuneNorm = 0.0f;
+                    clearNoteVoicesRt_();
                 } break;
                 case TrackParamId::LaunchPolicy:
                     playbackRt_.launchPolicy = parseLaunchPolicy_(value);
@@ -1196,6 +2288,18 @@ namespace avantgarde {
                     // При включении sync пересчитываем скорость от текущего transport/clip.
                     pendingStretchRecalc_.store(true, std::memory_order_release);
                     break;
+                case TrackParamId::TempoSyncMode:
+                    // Длина петли в обоих режимах одна (playhead идет с тем же шагом),
+                    // меняется только способ чтения клипа — phase reset не нужен.
+                    playbackRt_.tempoSyncMode = parseTempoSyncMode_(value);
+                    break;
+                case TrackParamId::AuxSendA:
+                case TrackParamId::AuxSendB:
+                case TrackParamId::AuxSendC:
+                case TrackParamId::AuxSendD:
+                    playbackRt_.auxSend[index - toParamIndex(TrackParamId::AuxSendA)] =
+                        detail_interp::clampf(value, 0.0f, 1.0f);
+                    break;
                 default:
                     break;
             }
@@ -1224,6 +2328,10 @@ namespace avantgarde {
             if (!clip || clip->frames <= 0 || clip->sampleRate <= 0) {
                 return 1.0f;
             }
+            if (clip->frozen) {
+                // Длина замороженного буфера не длина клипа: speed пересчитаем после unfreeze.
+                return playbackRt_.playbackInc;
+            }
 
             const uint32_t bars = std::max<uint32_t>(1, slotBars_.load(std::memory_order_relaxed));
             const float bpm = detail_interp::clampf(playbackRt_.transportBpm, 20.0f, 300.0f);
@@ -1292,8 +2400,7 @@ namespace avantgarde {
             const double regionEnd = clipRegionEndFrameRt_();
             const double span = std::max(1.0, regionEnd - regionStart);
 
-            const double speed = static_cast<double>(
-                detail_interp::clampf(playbackRt_.playbackInc, 0.05f, 8.0f));
+            const double speed = clipSpeedRt_();
             const double clipToOutRate =
                 (clip->sampleRate > 0 && outputSampleRate_ > 1.0)
                     ? (static_cast<double>(clip->sampleRate) / outputSampleRate_)
@@ -1316,7 +2423,78 @@ namespace avantgarde {
             return std::clamp(regionStart + norm * span, regionStart, std::max(regionStart, regionEnd - 1.0));
         }
 
-        bool publishClipAndResetFx_(std::shared_ptr<ClipBuffer>&& b) {
+        static std::shared_ptr<ClipBuffer> makeClipBuffer_(const SharedClipBuffer& buffer) {
+            if (!buffer.valid()) return nullptr;
+            auto b = std::make_shared<ClipBuffer>();
+            b->sampleRate = buffer.sampleRate;
+            b->channels = buffer.channels;
+            b->frames = buffer.frames;
+            b->format = buffer.format;
+            b->ch0Shared = buffer.ch0;
+            b->ch1Shared = buffer.ch1;
+            b->ch0Packed = buffer.ch0Packed;
+            b->ch1Packed = buffer.ch1Packed;
+            if (b->format == ClipSampleFormat::Float32) {
+                b->ch[0] = b->ch0Shared.get();
+                b->ch[1] = (buffer.channels == 2) ? b->ch1Shared.get() : nullptr;
+            } else {
+                b->ch[0] = b->ch0Packed.get();
+                b->ch[1] = (buffer.channels == 2) ? b->ch1Packed.get() : nullptr;
+            }
+            if (!b->ch[0] || (buffer.channels == 2 && !b->ch[1])) {
+                return nullptr;
+            }
+            b->residentFrames = buffer.residentFrames();
+            b->stretch = buffer.stretch;
+            if (buffer.stream) {
+                b->streamReader = buffer.stream->openReaders(kStreamReadersPerClip);
+                if (b->streamReader < 0) {
+                    return nullptr;
+                }
+                b->stream = buffer.stream;
+            }
+            return b;
+        }
+
+        // Cubic-сэмпл канала исходника freeze-рендера в его формате хранения.
+        static float sampleSourceCubic_(const SharedClipBuffer& src, int channel, double ph, bool loop) noexcept {
+            const bool second = channel == 1 && src.channels == 2;
+            switch (src.format) {
+                case ClipSampleFormat::Int16:
+                    return detail_interp::sampleCubic((second ? src.ch1Packed : src.ch0Packed).get(), src.frames,
+                                                      ph, loop);
+                case ClipSampleFormat::Float16:
+                    return detail_interp::sampleCubic(
+                        reinterpret_cast<const uint16_t*>((second ? src.ch1Packed : src.ch0Packed).get()),
+                        src.frames, ph, loop);
+                case ClipSampleFormat::Float32:
+                    break;
+            }
+            return detail_interp::sampleCubic((second ? src.ch1 : src.ch0).get(), src.frames, ph, loop);
+        }
+
+        // Геометрия freeze-рендера: длина прохода региона в выходных кадрах и шаг
+        // по исходнику на выходной кадр. Для лупа шаг подогнан под целое число кадров
+        // прохода, иначе замороженный луп уплывал бы от transport-сетки.
+        struct FreezeGeometry {
+            uint64_t passFrames = 1;
+            double inc = 1.0;
+        };
+
+        static FreezeGeometry freezeGeometry_(const TrackFreezeJob& job) noexcept {
+            const double clipToOutRate = (job.source.sampleRate > 0 && job.outputSampleRate > 1.0)
+                                             ? static_cast<double>(job.source.sampleRate) / job.outputSampleRate
+                                             : 1.0;
+            const double speed = std::clamp(job.playbackInc, 0.05, 8.0);
+            const double inc = std::max(1e-6, clipToOutRate * speed);
+            const double span = std::max(1.0, job.regionEnd - job.regionStart);
+            FreezeGeometry geo{};
+            geo.passFrames = std::max<uint64_t>(1U, static_cast<uint64_t>(std::llround(span / inc)));
+            geo.inc = job.loop ? span / static_cast<double>(geo.passFrames) : inc;
+            return geo;
+        }
+
+        bool publishLoadedClip_(std::shared_ptr<ClipBuffer>&& b) {
             if (!b || b->frames <= 0 || b->sampleRate <= 0 || !b->ch[0]) {
                 return false;
             }
@@ -1329,27 +2507,93 @@ namespace avantgarde {
 
             // Контракт: если слот был в воспроизведении, реализация должна безопасно остановить.
             // Мы публикуем новый клип атомарно на границе блока через pendingClip_.
+            // FX-цепочку не трогаем: init() здесь перевыделял бы буферы модулей, которые
+            // в этот момент может читать RT. Хвосты переживают смену клипа; сброс, если
+            // он включен (setFxResetOnClipSwap), делает сам RT на границе блока.
             publishClip_(std::move(b));
+            return true;
+        }
 
-            // Переинициализируем FX-блоки вне RT для детерминированного состояния
-            // после смены исходного клипа.
-            std::vector<std::shared_ptr<IAudioModule>> modulesSnapshot{};
-            {
-                const std::lock_guard<std::mutex> lock(modulesMutex_);
-                modulesSnapshot = modules_;
+        // control thread only, под modulesMutex_.
+        // Собираем новый неизменяемый снапшот целиком вне RT (все аллокации здесь)
+        // и атомарно подменяем им опубликованный. Предыдущий уходит в retire-список.
+        void publishFxChainLocked_() {
+            auto next = std::make_unique<FxChainSnapshot>();
+            next->generation = ++fxChainGenCtl_;
+            next->slots = modulesCtl_;
+            fxChainRt_.store(next.get(), std::memory_order_release);
+            bumpControlEpoch_();
+            if (fxChainCtl_) {
+                retiredFxChains_.push_back(std::move(fxChainCtl_));
             }
-            for (auto& mod : modulesSnapshot) {
-                mod->init(moduleSampleRate_, kFxScratchFrames);
-                mod->reset();
+            fxChainCtl_ = std::move(next);
+            reclaimRetiredFxChainsLocked_();
+        }
+
+        // control thread only, под modulesMutex_.
+        // RT публикует поколение цепочки, с которой работает (rtFxChainGen_).
+        // Поколения монотонны, поэтому все снапшоты с generation < rtFxChainGen_
+        // RT уже никогда не прочитает — их можно освобождать (вместе с удаленными модулями).
+        void reclaimRetiredFxChainsLocked_() {
+            const uint64_t rtGen = rtFxChainGen_.load(std::memory_order_acquire);
+            retiredFxChains_.erase(
+                std::remove_if(retiredFxChains_.begin(),
+                               retiredFxChains_.end(),
+                               [rtGen](const std::unique_ptr<FxChainSnapshot>& c) {
+                                   return c->generation < rtGen;
+                               }),
+                retiredFxChains_.end());
+        }
+
+        // RT: берем текущий опубликованный снапшот и подтверждаем его поколение.
+        const FxChainSnapshot* acquireFxChainRt_() noexcept {
+            const FxChainSnapshot* chain = fxChainRt_.load(std::memory_order_acquire);
+            if (chain) {
+                rtFxChainGen_.store(chain->generation, std::memory_order_release);
             }
-            return true;
+            return chain;
         }
 
         void publishClip_(std::shared_ptr<ClipBuffer>&& b) {
             // control thread only
+            ++clipGenerationCtl_;
+            if (!b->frozen) {
+                // Новый материал в слоте снимает freeze.
+                unfrozenClipCtl_.reset();
+            }
+            if (clipCtl_ && (clipCtl_->frozen || clipCtl_->stream)) {
+                // RT может дочитывать замороженный/потоковый буфер до границы блока
+                // (у потокового вместе с ним закрылись бы его читатели).
+                retiredClipCtl_ = clipCtl_;
+            }
             clipCtl_ = std::move(b);
             pendingClip_.store(clipCtl_.get(), std::memory_order_release);
             pendingClear_.store(false, std::memory_order_release);
+            bumpControlEpoch_();
+        }
+
+        // Стем: тишина от курсора до at (кадр блока), затем n кадров выхода трека.
+        void stemWriteRt_(std::size_t at, const float* s0, const float* s1, std::size_t n) noexcept {
+            if (!stemRt_) {
+                return;
+            }
+            stemPadRt_(at);
+            const float* ch[2] = {s0, s1};
+            (void)stemRt_->writeBlock(ch, static_cast<int>(n));
+            stemCursorRt_ = at + n;
+        }
+
+        void stemPadRt_(std::size_t upTo) noexcept {
+            if (!stemRt_ || upTo <= stemCursorRt_) {
+                return;
+            }
+            const float* silent[2] = {nullptr, nullptr};
+            (void)stemRt_->writeBlock(silent, static_cast<int>(upTo - stemCursorRt_));
+            stemCursorRt_ = upTo;
+        }
+
+        void bumpControlEpoch_() noexcept {
+            controlEpoch_.fetch_add(1, std::memory_order_release);
         }
 
         void rtApplyPending_() noexcept {
@@ -1361,16 +2605,47 @@ namespace avantgarde {
                 // Любая clear-операция должна безусловно погасить локальное проигрывание.
                 playbackRt_.oneshotRunning = false;
                 playbackRt_.playhead = 0.0;
+                clearNoteVoicesRt_();
             }
 
             // Apply pending clip publish
             if (const ClipBuffer* p = pendingClip_.exchange(nullptr, std::memory_order_acq_rel)) {
-                playbackRt_.clip = p;
-                playbackRt_.oneshotRunning = false;  // безопасно: при смене клипа останавливаем one-shot gate
-                playbackRt_.playhead = clipRegionStartFrameRt_();
+                const ClipBuffer* prev = playbackRt_.clip;
+                if (prev && ((p->frozen && p->frozenFrom == prev) || (prev->frozen && prev->frozenFrom == p))) {
+                    // Freeze/unfreeze того же материала: gate и фаза сохраняются,
+                    // playhead пересчитываем между кадрами исходника и рендера.
+                    playbackRt_.clip = p;
+                    if (p->frozen) {
+                        playbackRt_.playhead = std::max(0.0, (playbackRt_.playhead - p->frozenRegionStart) / p->frozenInc);
+                    } else {
+                        playbackRt_.playhead = prev->frozenRegionStart + playbackRt_.playhead * prev->frozenInc;
+                        if (!playbackRt_.loop && playbackRt_.playhead >= clipRegionEndFrameRt_()) {
+                            // Хвост FX после конца региона: one-shot уже доиграл.
+                            playbackRt_.oneshotRunning = false;
+                        }
+                        // Пока клип был заморожен, FX не работали: живые модули стартуют с чистого состояния.
+                        fxResetPendingRt_ = true;
+                    }
+                } else {
+                    playbackRt_.clip = p;
+                    playbackRt_.oneshotRunning = false;  // безопасно: при смене клипа останавливаем one-shot gate
+                    playbackRt_.playhead = clipRegionStartFrameRt_();
+                    clearNoteVoicesRt_();
+                    if (fxResetOnClipSwap_.load(std::memory_order_relaxed)) {
+                        fxResetPendingRt_ = true;
+                    }
+                }
                 clipChanged = true;
             }
 
+            // Конфиг полифонии (из setNotePolyphony): packed (steal << 8) | voices.
+            const uint32_t poly = pendingPolyphony_.exchange(0xFFFFFFFFu, std::memory_order_acq_rel);
+            if (poly != 0xFFFFFFFFu) {
+                notePolyphonyRt_ = static_cast<uint8_t>(poly & 0xFFu);
+                voiceStealRt_ = static_cast<VoiceStealPolicyValue>((poly >> 8) & 0xFFu);
+                clearNoteVoicesRt_();
+            }
+
             // Apply pending loop set (from control method)
             const uint32_t pl = pendingLoop_.exchange(0xFFFFFFFFu, std::memory_order_acq_rel);
             if (pl != 0xFFFFFFFFu) {
@@ -1404,9 +2679,18 @@ namespace avantgarde {
         }
 
     private:
+        // Сериализует control-side мутации цепочки; RT этот mutex не берет.
         mutable std::mutex modulesMutex_{};
-        std::vector<std::shared_ptr<IAudioModule>> modules_{};
-        std::vector<uint8_t> moduleEnabled_{};
+        // Control-копия порядка FX-слотов (источник для следующего снапшота).
+        std::vector<std::shared_ptr<FxSlot>> modulesCtl_{};
+        // Текущий опубликованный снапшот (владение control) и его RT-указатель.
+        std::unique_ptr<FxChainSnapshot> fxChainCtl_{};
+        std::atomic<const FxChainSnapshot*> fxChainRt_{nullptr};
+        // Снапшоты, замененные новыми, но еще потенциально читаемые RT.
+        std::vector<std::unique_ptr<FxChainSnapshot>> retiredFxChains_{};
+        uint64_t fxChainGenCtl_{0};
+        // Поколение снапшота, который RT взял последним.
+        std::atomic<uint64_t> rtFxChainGen_{0};
         double moduleSampleRate_{48000.0};
         double outputSampleRate_{48000.0};
         uint8_t trackId_{0};
@@ -1415,8 +2699,41 @@ namespace avantgarde {
         std::array<float, kFxScratchFrames> fxA1_{};
         std::array<float, kFxScratchFrames> fxB0_{};
         std::array<float, kFxScratchFrames> fxB1_{};
+        // Tempo sync Stretch (RT-only): stretcher и то, с чем он работал в прошлом блоке.
+        WsolaStretcher stretcher_{};
+        const ClipBuffer* stretchClipRt_{nullptr};
+        double stretchNextPh_{0.0};
+        bool stretchActiveRt_{false};
+        // Окно потокового клипа (выделяется вне RT при первой загрузке такого клипа).
+        std::vector<float> streamWin0_{};
+        std::vector<float> streamWin1_{};
+        // Такты каждого FX-слота за текущий process() (см. fxLoadTicks()).
+        std::array<uint64_t, DspLoadProfiler::kMaxFxSlots> fxLoadTicksRt_{};
+        // Детектор тишины на входе FX-цепочки (RT-only): кадров подряд ниже kSilenceLevel
+        // и для какого поколения цепочки/маски включенных слотов они посчитаны.
+        uint64_t quietFramesRt_{0};
+        uint64_t quietChainGenRt_{0};
+        uint64_t quietFxMaskRt_{0};
+        uint32_t fxLoadSlotsRt_{0};
+
+        // Полифонический note-режим (RT-only, предвыделено).
+        std::array<NoteVoice, kNoteVoiceSlots> noteVoices_{};
+        uint64_t noteVoiceSerial_{0};
+        uint8_t notePolyphonyRt_{1};
+        VoiceStealPolicyValue voiceStealRt_{VoiceStealPolicyValue::Oldest};
+        std::atomic<uint32_t> pendingPolyphony_{0xFFFFFFFFu};
+
+        // Отложенные sample-accurate команды (RT-only), отсортированы по frameInBlock.
+        std::array<RtCommand, kMaxTimedRtCommands> timedCmds_{};
+        std::size_t timedCmdCount_{0};
 
         std::shared_ptr<ClipBuffer> clipCtl_; // “флешка с аудио”, которую держит control-мир.
+        // Freeze: исходный клип, пока в слоте играет замороженный рендер (nullptr — не заморожен),
+        // и последний снятый замороженный/потоковый буфер, который RT мог еще не отпустить.
+        std::shared_ptr<ClipBuffer> unfrozenClipCtl_;
+        std::shared_ptr<ClipBuffer> retiredClipCtl_;
+        // Счетчик смен клипа в слоте: freeze-задание применяется только к тому клипу, с которого снято.
+        uint64_t clipGenerationCtl_{0};
 
         // В RT ждёт новый клип, который надо сделать текущим источником аудио
         // либо nullptr = “нет нового клипа”
@@ -1437,6 +2754,19 @@ namespace avantgarde {
         std::atomic<uint32_t> slotBars_{4};
         // Stable clipRef id для snapshot/pattern switch.
         std::atomic<uint32_t> clipRefId_{0u};
+        // Сброс FX при смене клипа: флаг пишет control, сам reset() делает RT
+        // в первом отрендеренном блоке с новым клипом.
+        std::atomic<bool> fxResetOnClipSwap_{false};
+        // RT: сбросить цепочку в начале рендера (смена клипа с флагом выше или unfreeze).
+        bool fxResetPendingRt_{false};
+        // Счетчик публикаций вне RT (см. ITrack::controlEpoch()).
+        std::atomic<uint64_t> controlEpoch_{0};
+        // Запись стема (setStemSink): sink снимается в начале process(), курсор — кадр блока,
+        // до которого стем уже получил данные; spanStartRt_ — начало текущего отрезка блока.
+        std::atomic<IRtRecordSink*> stemSink_{nullptr};
+        IRtRecordSink* stemRt_{nullptr};
+        std::size_t stemCursorRt_{0};
+        std::size_t spanStartRt_{0};
         // Control-side snapshot (без записи в RT-state).
         TrackSnapshot snapshotCtl_{};
         // RT->UI публикация трекового playhead внутри trim-региона [0..1].
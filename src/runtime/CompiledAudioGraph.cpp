@@ -0,0 +1,406 @@
+#include "runtime/CompiledAudioGraph.h"
+
+#include "runtime/AudioGraph.h"
+#include "runtime/DspLoadProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace avantgarde {
+
+namespace {
+
+// Максимум ребер в DAG из kMaxNodes узлов.
+constexpr std::size_t kMaxEdges = static_cast<std::size_t>(kMaxNodes) * (kMaxNodes - 1) / 2;
+
+// Простой free-list буферов: LIFO, чтобы только что освобожденный
+// (горячий в кеше) буфер переиспользовался первым.
+struct BufferAllocator {
+    std::vector<uint16_t> freeList{};
+    uint16_t highWater{0};
+
+    uint16_t acquire() {
+        if (!freeList.empty()) {
+            const uint16_t b = freeList.back();
+            freeList.pop_back();
+            return b;
+        }
+        return highWater++;
+    }
+    void release(uint16_t b) { freeList.push_back(b); }
+};
+
+void setError(GraphCompileError* out, GraphCompileError e) noexcept {
+    if (out) {
+        *out = e;
+    }
+}
+
+} // namespace
+
+std::unique_ptr<CompiledAudioGraph> CompiledAudioGraph::compile(const IAudioGraph& graph,
+                                                                std::size_t trackCount,
+                                                                double sampleRate,
+                                                                const std::vector<const CompiledAudioGraph*>& live,
+                                                                GraphCompileError* outError) {
+    setError(outError, GraphCompileError::None);
+
+    // ---- 1) Снимок топологии ----
+    std::vector<GraphNodeDesc> nodes(kMaxNodes);
+    std::vector<GraphEdgeDesc> edges(kMaxEdges);
+    uint16_t nodeCount = static_cast<uint16_t>(nodes.size());
+    uint16_t edgeCount = static_cast<uint16_t>(edges.size());
+    GraphTopoView view{nodes.data(), edges.data(), &nodeCount, &edgeCount};
+    if (!graph.getTopology(view)) {
+        setError(outError, GraphCompileError::InvalidTopology);
+        return nullptr;
+    }
+    nodes.resize(nodeCount);
+    edges.resize(edgeCount);
+    // Чужая реализация IAudioGraph могла не проверить инварианты — проверяем сами.
+    if (!AudioGraph::validate(nodes, edges)) {
+        setError(outError, GraphCompileError::InvalidTopology);
+        return nullptr;
+    }
+
+    const std::size_t n = nodes.size();
+    auto indexOf = [&nodes](NodeId id) {
+        const auto it = std::lower_bound(nodes.begin(), nodes.end(), id,
+                                         [](const GraphNodeDesc& d, NodeId v) { return d.id < v; });
+        return static_cast<std::size_t>(it - nodes.begin());
+    };
+
+    // Входы в порядке ребер (fromId по возрастанию) — это порядок суммирования.
+    std::vector<std::vector<std::size_t>> ins(n);
+    std::vector<std::vector<std::size_t>> outs(n);
+    for (const auto& e : edges) {
+        const std::size_t from = indexOf(e.fromId);
+        const std::size_t to = indexOf(e.toId);
+        ins[to].push_back(from);
+        outs[from].push_back(to);
+    }
+
+    // ---- 2) Типы узлов и привязки ----
+    std::size_t master = n;
+    std::vector<uint32_t> trackOf(n, 0);
+    std::vector<std::shared_ptr<IAudioModule>> moduleOf(n);
+    std::vector<bool> trackBound(trackCount, false);
+    for (std::size_t i = 0; i < n; ++i) {
+        switch (static_cast<GraphNodeKindValue>(nodes[i].kind)) {
+            case GraphNodeKindValue::TrackSource: {
+                if (!ins[i].empty()) {
+                    setError(outError, GraphCompileError::SourceHasInputs);
+                    return nullptr;
+                }
+                uint32_t t = 0;
+                if (!graph.nodeTrackIndex(nodes[i].id, t) || t >= trackCount) {
+                    setError(outError, GraphCompileError::UnboundTrack);
+                    return nullptr;
+                }
+                if (trackBound[t]) {
+                    setError(outError, GraphCompileError::DuplicateTrack);
+                    return nullptr;
+                }
+                trackBound[t] = true;
+                trackOf[i] = t;
+                break;
+            }
+            case GraphNodeKindValue::Mix:
+                break;
+            case GraphNodeKindValue::Module:
+                moduleOf[i] = graph.nodeModule(nodes[i].id);
+                if (!moduleOf[i]) {
+                    setError(outError, GraphCompileError::UnboundModule);
+                    return nullptr;
+                }
+                break;
+            case GraphNodeKindValue::MasterOut:
+                if (master != n) {
+                    setError(outError, GraphCompileError::MultipleMasters);
+                    return nullptr;
+                }
+                if (!outs[i].empty()) {
+                    setError(outError, GraphCompileError::MasterHasOutputs);
+                    return nullptr;
+                }
+                master = i;
+                break;
+            default:
+                setError(outError, GraphCompileError::UnknownKind);
+                return nullptr;
+        }
+    }
+    if (master == n) {
+        setError(outError, GraphCompileError::NoMaster);
+        return nullptr;
+    }
+
+    // ---- 3) Отсечение: живы узлы, из которых достижим master, и все источники ----
+    std::vector<bool> reach(n, false);
+    {
+        std::vector<std::size_t> stack{master};
+        reach[master] = true;
+        while (!stack.empty()) {
+            const std::size_t v = stack.back();
+            stack.pop_back();
+            for (std::size_t u : ins[v]) {
+                if (!reach[u]) {
+                    reach[u] = true;
+                    stack.push_back(u);
+                }
+            }
+        }
+    }
+    auto isSource = [&nodes](std::size_t i) {
+        return static_cast<GraphNodeKindValue>(nodes[i].kind) == GraphNodeKindValue::TrackSource;
+    };
+
+    // ---- 4) Детерминированный топологический порядок (Kahn) ----
+    // Входы живого узла всегда живы (иначе из них был бы путь в master).
+    // Готовые потребители идут раньше новых источников: шина сворачивается сразу,
+    // как только готовы ее входы, и пик одновременно живых буферов остается малым.
+    // Внутри каждой группы — меньший id первым.
+    std::vector<std::size_t> order;
+    order.reserve(n);
+    {
+        std::vector<std::size_t> indegree(n, 0);
+        std::vector<bool> ready(n, false);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (reach[i] || isSource(i)) {
+                indegree[i] = ins[i].size();
+                ready[i] = (indegree[i] == 0);
+            }
+        }
+        for (;;) {
+            std::size_t next = n;
+            std::size_t nextSource = n;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!ready[i]) {
+                    continue;
+                }
+                if (!isSource(i)) {
+                    next = i;
+                    break;
+                }
+                if (nextSource == n) {
+                    nextSource = i;
+                }
+            }
+            if (next == n) {
+                next = nextSource;
+            }
+            if (next == n) {
+                break;
+            }
+            ready[next] = false;
+            order.push_back(next);
+            for (std::size_t v : outs[next]) {
+                if (reach[v] && --indegree[v] == 0) {
+                    ready[v] = true;
+                }
+            }
+        }
+    }
+
+    // ---- 5) Расписание + назначение буферов по живучести ----
+    std::unique_ptr<CompiledAudioGraph> g(new CompiledAudioGraph());
+    g->trackCount_ = trackCount;
+    BufferAllocator alloc;
+
+    // Оставшиеся потребители выхода узла (только живые).
+    std::vector<std::size_t> uses(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t v : outs[i]) {
+            if (reach[v]) {
+                ++uses[i];
+            }
+        }
+    }
+    std::vector<uint16_t> bufOf(n, kNoBuffer);
+
+    // Треки вне графа тоже рендерятся (результат отбрасывается), как и источники без маршрута:
+    // иначе их плейхеды/запись отстанут от транспорта.
+    for (std::size_t t = 0; t < trackCount; ++t) {
+        if (trackBound[t]) {
+            continue;
+        }
+        Step s{};
+        s.op = StepOp::RenderTrack;
+        s.track = static_cast<uint32_t>(t);
+        s.out = alloc.acquire();
+        alloc.release(s.out);
+        g->steps_.push_back(s);
+    }
+
+    auto consumeInputs = [&](std::size_t node, uint16_t keep) {
+        for (std::size_t u : ins[node]) {
+            if (--uses[u] == 0 && bufOf[u] != keep) {
+                alloc.release(bufOf[u]);
+            }
+        }
+    };
+
+    for (std::size_t i : order) {
+        Step s{};
+        s.inBegin = static_cast<uint32_t>(g->inputs_.size());
+        s.inCount = static_cast<uint32_t>(ins[i].size());
+        for (std::size_t u : ins[i]) {
+            g->inputs_.push_back(bufOf[u]);
+        }
+
+        switch (static_cast<GraphNodeKindValue>(nodes[i].kind)) {
+            case GraphNodeKindValue::TrackSource:
+                s.op = StepOp::RenderTrack;
+                s.track = trackOf[i];
+                s.out = alloc.acquire();
+                break;
+            case GraphNodeKindValue::Mix: {
+                s.op = StepOp::Mix;
+                // На месте: первый вход умирает на этом шаге — пишем сумму прямо в него.
+                const bool inPlace = !ins[i].empty() && uses[ins[i].front()] == 1;
+                s.out = inPlace ? bufOf[ins[i].front()] : alloc.acquire();
+                consumeInputs(i, s.out);
+                break;
+            }
+            case GraphNodeKindValue::Module:
+                s.op = StepOp::Module;
+                s.module = moduleOf[i].get();
+                g->modules_.push_back(moduleOf[i]);
+                // Модули работают in -> out в разных буферах (как FX-цепочка трека).
+                if (ins[i].size() != 1) {
+                    s.tmp = alloc.acquire();
+                }
+                s.out = alloc.acquire();
+                if (s.tmp != kNoBuffer) {
+                    alloc.release(s.tmp);
+                }
+                consumeInputs(i, kNoBuffer);
+                break;
+            case GraphNodeKindValue::MasterOut:
+                s.op = StepOp::Master;
+                consumeInputs(i, kNoBuffer);
+                break;
+        }
+
+        bufOf[i] = s.out;
+        if (s.op != StepOp::Master && uses[i] == 0) {
+            // Источник без маршрута в master: отрендерили и сразу вернули буфер.
+            alloc.release(s.out);
+        }
+        g->steps_.push_back(s);
+    }
+
+    g->bufferCount_ = alloc.highWater;
+    g->buffers_.assign(g->bufferCount_ * kChannels * kMaxBlockFrames, 0.0f);
+
+    // ---- 6) Модули: блок графа не больше kMaxBlockFrames (canProcess), под него и init ----
+    std::vector<IAudioModule*> inited;
+    for (const auto& m : g->modules_) {
+        const bool running = std::any_of(live.begin(), live.end(), [&m](const CompiledAudioGraph* l) {
+            return l && l->usesModule(m.get());
+        });
+        if (running || std::find(inited.begin(), inited.end(), m.get()) != inited.end()) {
+            continue;
+        }
+        m->init(sampleRate, kMaxBlockFrames);
+        inited.push_back(m.get());
+    }
+    return g;
+}
+
+void CompiledAudioGraph::initModules(double sampleRate) {
+    std::vector<IAudioModule*> inited;
+    for (const auto& m : modules_) {
+        if (std::find(inited.begin(), inited.end(), m.get()) == inited.end()) {
+            m->init(sampleRate, kMaxBlockFrames);
+            inited.push_back(m.get());
+        }
+    }
+}
+
+bool CompiledAudioGraph::usesModule(const IAudioModule* module) const noexcept {
+    return std::any_of(modules_.begin(), modules_.end(),
+                       [module](const std::shared_ptr<IAudioModule>& m) { return m.get() == module; });
+}
+
+void CompiledAudioGraph::sumInputsRt_(const Step& s, uint16_t dst, std::size_t n) noexcept {
+    for (uint32_t ch = 0; ch < kChannels; ++ch) {
+        float* d = channel_(dst, ch);
+        if (s.inCount == 0) {
+            std::memset(d, 0, n * sizeof(float));
+            continue;
+        }
+        const uint16_t first = inputs_[s.inBegin];
+        if (first != dst) {
+            std::memcpy(d, channel_(first, ch), n * sizeof(float));
+        }
+        for (uint32_t k = 1; k < s.inCount; ++k) {
+            const float* src = channel_(inputs_[s.inBegin + k], ch);
+            for (std::size_t i = 0; i < n; ++i) {
+                d[i] += src[i];
+            }
+        }
+    }
+}
+
+void CompiledAudioGraph::process(const AudioProcessContext& ctx, ITrack* const* tracks, DspLoadProfiler* profiler) noexcept {
+    const std::size_t n = ctx.nframes;
+    for (const Step& s : steps_) {
+        switch (s.op) {
+            case StepOp::RenderTrack: {
+                float* outPtrs[kChannels]{};
+                for (uint32_t ch = 0; ch < kChannels; ++ch) {
+                    outPtrs[ch] = channel_(s.out, ch);
+                    std::memset(outPtrs[ch], 0, n * sizeof(float));
+                }
+                AudioProcessContext trackCtx = ctx;
+                trackCtx.out = outPtrs;
+                if (profiler) {
+                    profiler->processTrackRt(*tracks[s.track], s.track, trackCtx);
+                } else {
+                    tracks[s.track]->process(trackCtx);
+                }
+                break;
+            }
+            case StepOp::Mix:
+                sumInputsRt_(s, s.out, n);
+                break;
+            case StepOp::Module: {
+                uint16_t in = s.tmp;
+                if (s.inCount == 1) {
+                    in = inputs_[s.inBegin];
+                } else {
+                    sumInputsRt_(s, s.tmp, n);
+                }
+                const float* inPtrs[kChannels]{};
+                float* outPtrs[kChannels]{};
+                for (uint32_t ch = 0; ch < kChannels; ++ch) {
+                    inPtrs[ch] = channel_(in, ch);
+                    outPtrs[ch] = channel_(s.out, ch);
+                }
+                AudioProcessContext modCtx = ctx;
+                modCtx.in = inPtrs;
+                modCtx.out = outPtrs;
+                modCtx.numOut = kChannels;
+                s.module->process(modCtx);
+                break;
+            }
+            case StepOp::Master:
+                for (uint32_t k = 0; k < s.inCount; ++k) {
+                    const uint16_t b = inputs_[s.inBegin + k];
+                    for (uint32_t ch = 0; ch < ctx.numOut; ++ch) {
+                        float* dst = ctx.out[ch];
+                        if (!dst) continue;
+                        const float* src = channel_(b, ch);
+                        for (std::size_t i = 0; i < n; ++i) {
+                            dst[i] += src[i];
+                        }
+                    }
+                }
+                break;
+        }
+    }
+}
+
+} // namespace avantgarde
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "contracts/IAudioGraph.h"
+#include "contracts/ITrack.h"
+#include "contracts/types.h"
+
+namespace avantgarde {
+
+class DspLoadProfiler;
+
+// Коды NodeKind, которые понимает исполнитель графа движка.
+enum class GraphNodeKindValue : NodeKind {
+    TrackSource = 1, // выход трека движка (nodeTrackIndex), без входов
+    Mix = 2,         // сумма входов
+    Module = 3,      // IAudioModule (nodeModule): сумма входов -> process -> выход
+    MasterOut = 4,   // ровно один на граф; сумма входов уходит в ctx.out
+};
+
+enum class GraphCompileError : uint8_t {
+    None = 0,
+    InvalidTopology,   // не удалось прочитать топологию / нарушены инварианты
+    UnknownKind,
+    NoMaster,
+    MultipleMasters,
+    MasterHasOutputs,
+    SourceHasInputs,
+    UnboundTrack,      // нет привязки или индекс вне [0..trackCount)
+    DuplicateTrack,    // один трек привязан к нескольким узлам
+    UnboundModule,
+};
+
+// Скомпилированный граф: плоское расписание шагов + пул scratch-буферов.
+//
+// compile() (вне RT):
+//  - валидирует топологию и привязки;
+//  - отбрасывает узлы, из которых нет пути в MasterOut (кроме источников:
+//    трек рендерится всегда, чтобы его плейхед/состояние не "замерзали");
+//  - строит детерминированный топологический порядок (Kahn: готовые потребители
+//    раньше новых источников, внутри группы — меньший id);
+//  - назначает буферы по живучести: буфер возвращается в free-list после
+//    последнего потребителя, Mix пишет "на месте" в буфер первого входа,
+//    если этот вход на нем умирает;
+//  - вызывает init(sampleRate, kMaxBlockFrames) модулей Module-узлов. Модули, которые
+//    уже исполняются расписаниями из live, не трогаются: RT может быть внутри их process().
+//
+// process() (RT): только проход по массиву шагов — без аллокаций, поиска и ветвления по графу.
+// Треки передаются снаружи: расписание хранит их индексы, движок — владеет.
+class CompiledAudioGraph {
+public:
+    static constexpr uint32_t kChannels = 2;
+    static constexpr std::size_t kMaxBlockFrames = 4096;
+
+    static std::unique_ptr<CompiledAudioGraph> compile(const IAudioGraph& graph,
+                                                       std::size_t trackCount,
+                                                       double sampleRate,
+                                                       const std::vector<const CompiledAudioGraph*>& live = {},
+                                                       GraphCompileError* outError = nullptr);
+
+    // Вне RT, пока расписание не исполняется (смена частоты до старта стрима).
+    void initModules(double sampleRate);
+    bool usesModule(const IAudioModule* module) const noexcept;
+
+    // RT. Блок помещается в буферы расписания (и в maxFrames модулей) и набор треков совпадает
+    // с тем, под который компилировали.
+    bool canProcess(const AudioProcessContext& ctx, std::size_t trackCount) const noexcept {
+        return ctx.out != nullptr &&
+               ctx.nframes <= kMaxBlockFrames &&
+               ctx.numOut <= kChannels &&
+               trackCount == trackCount_;
+    }
+
+    // RT. Добавляет результат графа в ctx.out (master уже очищен движком).
+    // profiler != nullptr — треки замеряются им (Module-узлы входят только в общий замер блока).
+    void process(const AudioProcessContext& ctx, ITrack* const* tracks, DspLoadProfiler* profiler = nullptr) noexcept;
+
+    std::size_t stepCount() const noexcept { return steps_.size(); }
+    std::size_t bufferCount() const noexcept { return bufferCount_; }
+    std::size_t trackCount() const noexcept { return trackCount_; }
+
+private:
+    enum class StepOp : uint8_t { RenderTrack, Mix, Module, Master };
+
+    static constexpr uint16_t kNoBuffer = 0xFFFF;
+
+    struct Step {
+        StepOp op{StepOp::Mix};
+        uint16_t out{kNoBuffer};     // выходной буфер (Master — нет)
+        uint16_t tmp{kNoBuffer};     // Module: сумма нескольких входов
+        uint32_t inBegin{0};         // диапазон в inputs_
+        uint32_t inCount{0};
+        uint32_t track{0};           // RenderTrack
+        IAudioModule* module{nullptr};
+    };
+
+    CompiledAudioGraph() = default;
+
+    float* channel_(uint16_t buffer, uint32_t ch) noexcept {
+        return buffers_.data() + (static_cast<std::size_t>(buffer) * kChannels + ch) * kMaxBlockFrames;
+    }
+    // dst = сумма входов шага (если dst совпадает с первым входом — он уже на месте).
+    void sumInputsRt_(const Step& s, uint16_t dst, std::size_t n) noexcept;
+
+    std::vector<Step> steps_{};
+    std::vector<uint16_t> inputs_{};
+    std::vector<float> buffers_{};
+    std::size_t bufferCount_{0};
+    std::size_t trackCount_{0};
+    // Держим модули живыми, пока расписание может исполняться на RT.
+    std::vector<std::shared_ptr<IAudioModule>> modules_{};
+};
+
+} // namespace avantgarde
@@ -0,0 +1,252 @@
+#include "runtime/DspLoadProfiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace avantgarde {
+namespace {
+
+// Фиксированная раскладка таблицы узлов.
+constexpr uint32_t kSiteBlock = 0;
+constexpr uint32_t kSiteMaster = 1;
+constexpr uint32_t kSiteExtBegin = 2;
+constexpr uint32_t kSiteExtEnd = kSiteExtBegin + DspLoadProfiler::kMaxRtExtensions;
+constexpr uint32_t kSiteAux = kSiteExtEnd + DspLoadProfiler::kMaxRtExtensions;
+constexpr uint32_t kSiteTrack = kSiteAux + kMaxAuxBuses;
+constexpr uint32_t kSiteTrackFx = kSiteTrack + DspLoadProfiler::kMaxTracks;
+constexpr uint32_t kSiteCount = kSiteTrackFx + DspLoadProfiler::kMaxTracks * DspLoadProfiler::kMaxFxSlots;
+
+// Корзины 0..3 — точные значения 0..3 такта; дальше 4 корзины на октаву.
+constexpr uint32_t kSubBins = 4;
+
+// Значение в бинах по квантилю q (линейная интерполяция внутри корзины).
+double percentileTicks_(const uint32_t* bins, uint64_t count, double q) noexcept {
+    if (count == 0) {
+        return 0.0;
+    }
+    const double target = std::max(1.0, q * static_cast<double>(count));
+    double cum = 0.0;
+    for (uint32_t b = 0; b < kDspLoadHistogramBins; ++b) {
+        if (bins[b] == 0) continue;
+        const double next = cum + static_cast<double>(bins[b]);
+        if (next >= target) {
+            const double lo = static_cast<double>(DspLoadProfiler::binLowerTicks(b));
+            const double hi = (b + 1 < kDspLoadHistogramBins)
+                                  ? static_cast<double>(DspLoadProfiler::binLowerTicks(b + 1))
+                                  : lo * 2.0;
+            const double frac = (target - cum) / static_cast<double>(bins[b]);
+            return lo + frac * (hi - lo);
+        }
+        cum = next;
+    }
+    return static_cast<double>(DspLoadProfiler::binLowerTicks(kDspLoadHistogramBins - 1));
+}
+
+} // namespace
+
+DspLoadProfiler::DspLoadProfiler()
+    : sites_(std::make_unique<Site[]>(kSiteCount)),
+      originTicks_(nowTicks()),
+      originTime_(std::chrono::steady_clock::now()) {}
+
+uint32_t DspLoadProfiler::siteOf(DspLoadSiteKind kind, uint32_t owner, uint32_t slot) noexcept {
+    switch (kind) {
+        case DspLoadSiteKind::Block:
+            return kSiteBlock;
+        case DspLoadSiteKind::MasterBus:
+            return kSiteMaster;
+        case DspLoadSiteKind::RtExtBegin:
+            return owner < kMaxRtExtensions ? kSiteExtBegin + owner : kNoSite;
+        case DspLoadSiteKind::RtExtEnd:
+            return owner < kMaxRtExtensions ? kSiteExtEnd + owner : kNoSite;
+        case DspLoadSiteKind::AuxBus:
+            return owner < kMaxAuxBuses ? kSiteAux + owner : kNoSite;
+        case DspLoadSiteKind::Track:
+            return owner < kMaxTracks ? kSiteTrack + owner : kNoSite;
+        case DspLoadSiteKind::TrackFx:
+            return (owner < kMaxTracks && slot < kMaxFxSlots) ? kSiteTrackFx + owner * kMaxFxSlots + slot : kNoSite;
+    }
+    return kNoSite;
+}
+
+void DspLoadProfiler::describe_(uint32_t site, DspLoadSiteCounters& out) noexcept {
+    out.site = static_cast<uint16_t>(site);
+    out.owner = 0;
+    out.slot = 0;
+    if (site == kSiteBlock) {
+        out.kind = DspLoadSiteKind::Block;
+    } else if (site == kSiteMaster) {
+        out.kind = DspLoadSiteKind::MasterBus;
+    } else if (site < kSiteExtEnd) {
+        out.kind = DspLoadSiteKind::RtExtBegin;
+        out.owner = static_cast<uint16_t>(site - kSiteExtBegin);
+    } else if (site < kSiteAux) {
+        out.kind = DspLoadSiteKind::RtExtEnd;
+        out.owner = static_cast<uint16_t>(site - kSiteExtEnd);
+    } else if (site < kSiteTrack) {
+        out.kind = DspLoadSiteKind::AuxBus;
+        out.owner = static_cast<uint16_t>(site - kSiteAux);
+    } else if (site < kSiteTrackFx) {
+        out.kind = DspLoadSiteKind::Track;
+        out.owner = static_cast<uint16_t>(site - kSiteTrack);
+    } else {
+        out.kind = DspLoadSiteKind::TrackFx;
+        out.owner = static_cast<uint16_t>((site - kSiteTrackFx) / kMaxFxSlots);
+        out.slot = static_cast<uint16_t>((site - kSiteTrackFx) % kMaxFxSlots);
+    }
+}
+
+uint32_t DspLoadProfiler::binOf(uint64_t ticks) noexcept {
+    if (ticks < kSubBins) {
+        return static_cast<uint32_t>(ticks);
+    }
+    const uint32_t octave = static_cast<uint32_t>(std::bit_width(ticks)) - 1u; // >= 2
+    const uint32_t sub = static_cast<uint32_t>(ticks >> (octave - 2u)) & (kSubBins - 1u);
+    return std::min(kDspLoadHistogramBins - 1u, (octave - 1u) * kSubBins + sub);
+}
+
+uint64_t DspLoadProfiler::binLowerTicks(uint32_t bin) noexcept {
+    if (bin < kSubBins) {
+        return bin;
+    }
+    const uint32_t octave = bin / kSubBins + 1u;
+    const uint64_t sub = bin % kSubBins;
+    return (kSubBins + sub) << (octave - 2u);
+}
+
+void DspLoadProfiler::recordRt(uint32_t site, uint64_t ticks) noexcept {
+    if (site >= kSiteCount) {
+        return;
+    }
+    Site& s = sites_[site];
+    // Один писатель на узел: обычные load+store вместо fetch_add.
+    std::atomic<uint32_t>& bin = s.bins[binOf(ticks)];
+    bin.store(bin.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+    s.sumTicks.store(s.sumTicks.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+    if (ticks > s.maxTicks.load(std::memory_order_relaxed)) {
+        s.maxTicks.store(ticks, std::memory_order_relaxed);
+    }
+    s.count.store(s.count.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+}
+
+void DspLoadProfiler::processTrackRt(ITrack& track, uint32_t trackIndex, const AudioProcessContext& ctx) noexcept {
+    const uint64_t t0 = nowTicks();
+    track.process(ctx);
+    recordRt(siteOf(DspLoadSiteKind::Track, trackIndex), nowTicks() - t0);
+    if (trackIndex >= kMaxTracks) {
+        return;
+    }
+    uint64_t fxTicks[kMaxFxSlots]{};
+    const uint32_t slots = std::min(track.fxLoadTicks(fxTicks, kMaxFxSlots), kMaxFxSlots);
+    for (uint32_t s = 0; s < slots; ++s) {
+        // Выключенный/отсутствующий слот не тратит такты — не засоряем его гистограмму нулями.
+        if (fxTicks[s] > 0) {
+            recordRt(kSiteTrackFx + trackIndex * kMaxFxSlots + s, fxTicks[s]);
+        }
+    }
+}
+
+void DspLoadProfiler::capture(DspLoadCapture& out) const {
+    const uint64_t ticks = nowTicks();
+    const auto now = std::chrono::steady_clock::now();
+    const double us = std::chrono::duration<double, std::micro>(now - originTime_).count();
+    out.ticksPerUs = (us > 0.0 && ticks > originTicks_) ? static_cast<double>(ticks - originTicks_) / us : 0.0;
+#if defined(__aarch64__)
+    // Частота виртуального таймера известна точно — калибровка не нужна.
+    uint64_t freq = 0;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+    if (freq > 0) {
+        out.ticksPerUs = static_cast<double>(freq) * 1e-6;
+    }
+#endif
+
+    out.sites.clear();
+    for (uint32_t i = 0; i < kSiteCount; ++i) {
+        const Site& s = sites_[i];
+        const uint64_t count = s.count.load(std::memory_order_relaxed);
+        if (count == 0) continue;
+        DspLoadSiteCounters c{};
+        describe_(i, c);
+        c.count = count;
+        c.sumTicks = s.sumTicks.load(std::memory_order_relaxed);
+        c.maxTicks = s.maxTicks.load(std::memory_order_relaxed);
+        for (uint32_t b = 0; b < kDspLoadHistogramBins; ++b) {
+            c.bins[b] = s.bins[b].load(std::memory_order_relaxed);
+        }
+        out.sites.push_back(c);
+    }
+}
+
+void DspLoadProfiler::buildReport(const DspLoadCapture& now,
+                                  const DspLoadCapture* since,
+                                  double budgetUs,
+                                  DspLoadReport& out) {
+    out = DspLoadReport{};
+    out.budgetUs = static_cast<float>(budgetUs);
+    const double tpu = now.ticksPerUs;
+    if (!(tpu > 0.0)) {
+        return;
+    }
+    const auto pct = [budgetUs](double v) {
+        return budgetUs > 0.0 ? static_cast<float>(100.0 * v / budgetUs) : 0.0f;
+    };
+
+    std::vector<DspLoadSiteStats> stats;
+    stats.reserve(now.sites.size());
+    std::size_t j = 0;
+    for (const DspLoadSiteCounters& cur : now.sites) {
+        // Оба снимка отсортированы по site: сливаем за один проход.
+        const DspLoadSiteCounters* prev = nullptr;
+        if (since) {
+            while (j < since->sites.size() && since->sites[j].site < cur.site) ++j;
+            if (j < since->sites.size() && since->sites[j].site == cur.site) prev = &since->sites[j];
+        }
+        const uint64_t count = cur.count - (prev ? std::min(prev->count, cur.count) : 0);
+        if (count == 0) continue;
+
+        uint32_t bins[kDspLoadHistogramBins]{};
+        uint32_t top = 0;
+        for (uint32_t b = 0; b < kDspLoadHistogramBins; ++b) {
+            const uint32_t p = prev ? prev->bins[b] : 0u;
+            bins[b] = cur.bins[b] > p ? cur.bins[b] - p : 0u;
+            if (bins[b] != 0) top = b;
+        }
+        const uint64_t sum = cur.sumTicks - (prev ? std::min(prev->sumTicks, cur.sumTicks) : 0);
+        // Точный максимум есть только за все время: если он в верхней корзине окна — берем его,
+        // иначе верхнюю границу этой корзины.
+        const uint64_t topUpper = (top + 1 < kDspLoadHistogramBins) ? binLowerTicks(top + 1) : cur.maxTicks;
+        const double maxTicks = static_cast<double>(std::min(cur.maxTicks, topUpper));
+
+        DspLoadSiteStats st{};
+        st.kind = cur.kind;
+        st.owner = cur.owner;
+        st.slot = cur.slot;
+        st.blocks = count;
+        const double meanUs = static_cast<double>(sum) / static_cast<double>(count) / tpu;
+        const double p99Us = std::min(percentileTicks_(bins, count, 0.99), maxTicks) / tpu;
+        st.meanUs = static_cast<float>(meanUs);
+        st.p50Us = static_cast<float>(std::min(percentileTicks_(bins, count, 0.50), maxTicks) / tpu);
+        st.p95Us = static_cast<float>(std::min(percentileTicks_(bins, count, 0.95), maxTicks) / tpu);
+        st.p99Us = static_cast<float>(p99Us);
+        st.maxUs = static_cast<float>(maxTicks / tpu);
+        st.meanPct = pct(meanUs);
+        st.p99Pct = pct(p99Us);
+
+        if (cur.kind == DspLoadSiteKind::Block) {
+            out.block = st;
+        } else {
+            stats.push_back(st);
+        }
+    }
+
+    const std::size_t keep = std::min<std::size_t>(stats.size(), kMaxDspLoadReportSites);
+    std::partial_sort(stats.begin(), stats.begin() + static_cast<std::ptrdiff_t>(keep), stats.end(),
+                      [](const DspLoadSiteStats& a, const DspLoadSiteStats& b) { return a.p99Us > b.p99Us; });
+    for (std::size_t i = 0; i < keep; ++i) {
+        out.sites[i] = stats[i];
+    }
+    out.siteCount = static_cast<uint32_t>(keep);
+}
+
+} // namespace avantgarde
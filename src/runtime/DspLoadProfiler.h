@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "contracts/ITrack.h"
+#include "contracts/dsp_load_types.h"
+#include "contracts/ids.h"
+#include "contracts/meter_types.h"
+#include "contracts/types.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace avantgarde {
+
+// Профайлер DSP-нагрузки движка.
+//
+// Узлы блока (трек, FX-слот трека, хуки RT-расширений, aux/мастер-шины, блок целиком)
+// имеют фиксированные индексы — таблица выделяется один раз в конструкторе.
+// У каждого узла в любой момент один писатель (аудио-нить или воркер, рендерящий трек),
+// поэтому RT пишет relaxed load+store без RMW-инструкций; control читает те же
+// атомики relaxed — снимок может "разъехаться" на один блок, для статистики это неважно.
+//
+// Такты: TSC на x86, виртуальный таймер на AArch64, иначе steady_clock (нс).
+// Перевод в микросекунды калибруется на стороне control по steady_clock.
+class DspLoadProfiler {
+public:
+    static constexpr uint32_t kMaxTracks = kMaxMeterTracks;
+    static constexpr uint32_t kMaxFxSlots = 8;
+    static constexpr uint32_t kMaxRtExtensions = 8;
+    static constexpr uint32_t kNoSite = 0xFFFFFFFFu;
+
+    DspLoadProfiler();
+
+    // RT. Текущее значение счетчика тактов.
+    static uint64_t nowTicks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t v;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+        return v;
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Индекс узла; kNoSite, если owner/slot вне фиксированной таблицы.
+    static uint32_t siteOf(DspLoadSiteKind kind, uint32_t owner = 0, uint32_t slot = 0) noexcept;
+
+    // RT. Один замер узла.
+    void recordRt(uint32_t site, uint64_t ticks) noexcept;
+
+    // RT. track.process() с замером трека и его FX-слотов (ITrack::fxLoadTicks).
+    void processTrackRt(ITrack& track, uint32_t trackIndex, const AudioProcessContext& ctx) noexcept;
+
+    // Control. Снимок накопленных счетчиков (только узлы с замерами).
+    void capture(DspLoadCapture& out) const;
+
+    // Статистика за окно [since, now]; since == nullptr — с запуска.
+    // budgetUs — длительность блока (nframes / sampleRate).
+    static void buildReport(const DspLoadCapture& now,
+                            const DspLoadCapture* since,
+                            double budgetUs,
+                            DspLoadReport& out);
+
+    // Корзина гистограммы для числа тактов и нижняя граница корзины.
+    static uint32_t binOf(uint64_t ticks) noexcept;
+    static uint64_t binLowerTicks(uint32_t bin) noexcept;
+
+private:
+    struct Site {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sumTicks{0};
+        std::atomic<uint64_t> maxTicks{0};
+        std::atomic<uint32_t> bins[kDspLoadHistogramBins]{};
+    };
+
+    static void describe_(uint32_t site, DspLoadSiteCounters& out) noexcept;
+
+    std::unique_ptr<Site[]> sites_{};
+    // Опорная точка калибровки тактов.
+    uint64_t originTicks_{0};
+    std::chrono::steady_clock::time_point originTime_{};
+};
+
+} // namespace avantgarde
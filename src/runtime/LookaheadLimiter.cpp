@@ -0,0 +1,95 @@
+#include "runtime/LookaheadLimiter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace avantgarde {
+
+void LookaheadLimiter::prepare(double sampleRate, uint32_t lookaheadSamples, float ceiling, float releaseMs) {
+    window_ = std::max<uint32_t>(1u, lookaheadSamples);
+    ceiling_ = (ceiling > 0.0f) ? ceiling : 1.0f;
+    const double sr = (sampleRate > 1.0) ? sampleRate : 48000.0;
+    const double releaseSamples = std::max(1.0, static_cast<double>(releaseMs) * 0.001 * sr);
+    releaseCoef_ = static_cast<float>(1.0 - std::exp(-1.0 / releaseSamples));
+
+    delay_.assign(static_cast<std::size_t>(kMaxChannels) * window_, 0.0f);
+    minVal_.assign(window_, 1.0f);
+    minIdx_.assign(window_, 0);
+    box_.assign(window_, 1.0f);
+    reset();
+}
+
+void LookaheadLimiter::reset() noexcept {
+    std::fill(delay_.begin(), delay_.end(), 0.0f);
+    std::fill(box_.begin(), box_.end(), 1.0f);
+    delayPos_ = 0;
+    minHead_ = 0;
+    minCount_ = 0;
+    boxPos_ = 0;
+    boxSum_ = static_cast<double>(window_);
+    gain_ = 1.0f;
+    sampleIndex_ = 0;
+}
+
+float LookaheadLimiter::process(float* const* ch, uint32_t numCh, std::size_t n) noexcept {
+    if (window_ == 0 || numCh == 0) {
+        return 1.0f;
+    }
+    numCh = std::min(numCh, kMaxChannels);
+    const uint32_t w = window_;
+    float minGain = 1.0f;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        // 1) требуемый gain входного сэмпла (стерео-связка по максимуму модуля)
+        float peak = 0.0f;
+        for (uint32_t c = 0; c < numCh; ++c) {
+            peak = std::max(peak, std::fabs(ch[c][i]));
+        }
+        const float req = (peak > ceiling_) ? (ceiling_ / peak) : 1.0f;
+
+        // 2) скользящий минимум за последние w сэмплов. Голова истекает до push:
+        //    иначе в кольце из w слотов на миг окажется w+1 элемент.
+        if (minCount_ > 0 && minIdx_[minHead_] + w <= sampleIndex_) {
+            minHead_ = (minHead_ + 1) % w;
+            --minCount_;
+        }
+        while (minCount_ > 0) {
+            const uint32_t back = (minHead_ + minCount_ - 1) % w;
+            if (minVal_[back] < req) break;
+            --minCount_;
+        }
+        const uint32_t slot = (minHead_ + minCount_) % w;
+        minVal_[slot] = req;
+        minIdx_[slot] = sampleIndex_;
+        ++minCount_;
+        const float held = minVal_[minHead_];
+
+        // 3) box-среднее удержанного минимума (плавная атака длиной w)
+        boxSum_ += static_cast<double>(held) - static_cast<double>(box_[boxPos_]);
+        box_[boxPos_] = held;
+        boxPos_ = (boxPos_ + 1 == w) ? 0 : boxPos_ + 1;
+        const float target = std::min(1.0f, static_cast<float>(boxSum_ / static_cast<double>(w)));
+
+        // 4) release: вверх — экспоненциально, вниз — сразу до цели
+        float g = gain_ + (target - gain_) * releaseCoef_;
+        if (g > target) g = target;
+        gain_ = g;
+        if (g < minGain) minGain = g;
+
+        // 5) задержанный сигнал * gain; страховочный клип на погрешность суммы box
+        for (uint32_t c = 0; c < numCh; ++c) {
+            float* line = delay_.data() + static_cast<std::size_t>(c) * w;
+            const float in = ch[c][i];
+            // Окно w: читаем сэмпл, записанный w-1 шагов назад (при w == 1 — текущий).
+            const uint32_t readPos = (delayPos_ + 1 == w) ? 0 : delayPos_ + 1;
+            line[delayPos_] = in;
+            const float out = line[(w == 1) ? delayPos_ : readPos] * g;
+            ch[c][i] = std::clamp(out, -ceiling_, ceiling_);
+        }
+        delayPos_ = (delayPos_ + 1 == w) ? 0 : delayPos_ + 1;
+        ++sampleIndex_;
+    }
+    return minGain;
+}
+
+} // namespace avantgarde
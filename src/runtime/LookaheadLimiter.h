@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace avantgarde {
+
+// Стерео-связанный lookahead-лимитер мастер-шины.
+//
+// Схема (без овершута по построению):
+//  1) требуемый gain каждого входного сэмпла: min(1, ceiling / max|x_ch|);
+//  2) скользящий минимум за окно A (lookahead) — монотонная очередь на кольце;
+//  3) box-среднее того же минимума за A сэмплов — плавная атака без ступенек;
+//  4) release: gain растет к цели экспоненциально, но никогда не выше цели;
+//  5) сигнал задержан на A-1 сэмпл, поэтому каждый выходной сэмпл умножается на gain,
+//     который не превышает его собственный требуемый.
+//
+// prepare() — вне RT (все буферы здесь), process() — RT: без аллокаций и ветвлений по размеру.
+class LookaheadLimiter {
+public:
+    static constexpr uint32_t kMaxChannels = 2;
+
+    // Вне RT. lookaheadSamples >= 1. ceiling — линейный порог (например 0.966 ≈ -0.3 dBFS).
+    void prepare(double sampleRate, uint32_t lookaheadSamples, float ceiling, float releaseMs);
+    // RT. Сброс состояния (тишина в линиях задержки, gain = 1).
+    void reset() noexcept;
+
+    bool prepared() const noexcept { return window_ > 0; }
+    uint32_t latencySamples() const noexcept { return window_ > 0 ? window_ - 1 : 0; }
+
+    // RT. In-place по numCh (<= kMaxChannels) каналам. Возвращает минимальный gain за вызов.
+    float process(float* const* ch, uint32_t numCh, std::size_t n) noexcept;
+
+private:
+    uint32_t window_{0};
+    float ceiling_{1.0f};
+    float releaseCoef_{0.0f};
+    float gain_{1.0f};
+
+    // Линии задержки сигнала: [kMaxChannels][window_].
+    std::vector<float> delay_{};
+    uint32_t delayPos_{0};
+
+    // Монотонная очередь минимума: (значение, номер сэмпла) в кольце размера window_.
+    std::vector<float> minVal_{};
+    std::vector<uint64_t> minIdx_{};
+    uint32_t minHead_{0};
+    uint32_t minCount_{0};
+
+    // Box-среднее удержанного минимума.
+    std::vector<float> box_{};
+    uint32_t boxPos_{0};
+    double boxSum_{0.0};
+
+    uint64_t sampleIndex_{0};
+};
+
+} // namespace avantgarde
@@ -104,7 +104,7 @@ float MetronomeRtExtension::renderVoicesSample_() noexcept {
         if (!v.active) {
             continue;
         }
-        sum += std::sinf(v.phase) * v.env * v.gain;
+        sum += std::sin(v.phase) * v.env * v.gain;
         v.phase += v.phaseInc;
         if (v.phase >= kTwoPi) {
             v.phase -= kTwoPi;
@@ -153,7 +153,13 @@ void QuantizedSchedulerRtExtension::dispatchDue(uint64_t blockStart, uint64_t bl
             continue;
         }
 
-        if (!outQueue_->push(p.cmd)) {
+        // Точный момент внутри блока: команда должна сработать на dueSample,
+        // а не на начале блока. Просроченные команды — на начало блока.
+        RtCommand out = p.cmd;
+        out.frameInBlock = (p.dueSample > blockStart)
+                               ? static_cast<uint32_t>(p.dueSample - blockStart)
+                               : 0U;
+        if (!outQueue_->push(out)) {
             overflow_.store(true, std::memory_order_relaxed);
             ++i;
             continue;
@@ -0,0 +1,299 @@
+#include "runtime/RenderAheadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace avantgarde {
+
+namespace {
+
+// Воркер без работы просыпается сам хотя бы так часто (quit/опоздавший wake).
+constexpr auto kIdleWait = std::chrono::milliseconds(5);
+
+void configureCurrentThread(int rtPriority) noexcept {
+#if defined(__linux__)
+    if (rtPriority > 0) {
+        sched_param sp{};
+        sp.sched_priority = rtPriority;
+        // Без CAP_SYS_NICE/rtprio лимита вызов вернет EPERM — остаемся на SCHED_OTHER.
+        (void)pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+    }
+#else
+    (void)rtPriority;
+#endif
+}
+
+} // namespace
+
+RenderAheadPool::~RenderAheadPool() {
+    stop();
+}
+
+bool RenderAheadPool::start(ITrack* const* tracks, uint32_t trackCount, uint32_t blocks, int rtPriority) {
+    stop();
+    if (blocks == 0 || trackCount == 0 || !tracks) {
+        return true;
+    }
+    blocks_ = std::min(blocks, kMaxBlocks);
+    laneCount_ = trackCount;
+    lanes_ = std::make_unique<Lane[]>(trackCount);
+    for (uint32_t t = 0; t < trackCount; ++t) {
+        lanes_[t].track = tracks[t];
+        lanes_[t].audio.assign(static_cast<std::size_t>(blocks_) * kChannels * kMaxBlockFrames, 0.0f);
+    }
+    quit_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread([this, rtPriority]() { workerLoop_(rtPriority); });
+    return true;
+}
+
+void RenderAheadPool::stop() noexcept {
+    if (thread_.joinable()) {
+        quit_.store(true, std::memory_order_release);
+        if (!wakePending_.exchange(true, std::memory_order_acq_rel)) {
+            wake_.release();
+        }
+        thread_.join();
+    }
+    while (wake_.try_acquire()) {
+    }
+    wakePending_.store(false, std::memory_order_relaxed);
+    lanes_.reset();
+    laneCount_ = 0;
+    blocks_ = 0;
+}
+
+bool RenderAheadPool::admitCommandRt(uint32_t track, const RtCommand& cmd) noexcept {
+    if (track >= laneCount_) {
+        return true;
+    }
+    Lane& lane = lanes_[track];
+    // Трек трогают прямо сейчас: отсчет до передачи воркеру начинаем заново.
+    lane.holdBlocks = 0;
+    if (reclaimRt_(lane)) {
+        return true;
+    }
+    if (lane.deferredCount < kMaxDeferredCommands) {
+        lane.deferred[lane.deferredCount++] = cmd;
+    }
+    return false;
+}
+
+void RenderAheadPool::syncRt(const AudioProcessContext& ctx) noexcept {
+    for (uint32_t t = 0; t < laneCount_; ++t) {
+        Lane& lane = lanes_[t];
+        lane.serve = Serve::Track;
+        if (lane.owner.load(std::memory_order_acquire) == kOwnerRt) {
+            continue;
+        }
+        const uint32_t r = lane.read.load(std::memory_order_relaxed);
+        const uint32_t w = lane.write.load(std::memory_order_acquire);
+        const bool headReady = (r != w) && lane.chunks[r % blocks_].transportSampleTime == ctx.transportSampleTime;
+        const bool valid = headReady &&
+                           !lane.revoke.load(std::memory_order_relaxed) &&
+                           sameStream_(lane.ctx, ctx) &&
+                           lane.track->controlEpoch() == lane.epoch;
+        if (valid) {
+            lane.serve = Serve::Chunk;
+            continue;
+        }
+        if (r == w) {
+            underruns_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (reclaimRt_(lane)) {
+            continue;
+        }
+        // Воркер еще внутри process(): трек заберем в следующем блоке, а этот — из кольца,
+        // если там есть именно он (непрерывность важнее на один блок запоздавшей правки).
+        lane.serve = headReady ? Serve::Chunk : Serve::Silence;
+    }
+}
+
+bool RenderAheadPool::revokeAllRt() noexcept {
+    bool all = true;
+    for (uint32_t t = 0; t < laneCount_; ++t) {
+        Lane& lane = lanes_[t];
+        lane.holdBlocks = 0;
+        lane.serve = Serve::Track;
+        if (!reclaimRt_(lane)) {
+            lane.serve = Serve::Silence;
+            all = false;
+        }
+    }
+    return all;
+}
+
+bool RenderAheadPool::ownedByWorkerRt(uint32_t track) const noexcept {
+    return track < laneCount_ && lanes_[track].serve != Serve::Track;
+}
+
+bool RenderAheadPool::readRt(uint32_t track, const AudioProcessContext& trackCtx) noexcept {
+    if (track >= laneCount_) {
+        return false;
+    }
+    Lane& lane = lanes_[track];
+    if (lane.serve == Serve::Track) {
+        return false;
+    }
+    if (lane.serve == Serve::Chunk) {
+        const uint32_t r = lane.read.load(std::memory_order_relaxed);
+        const uint32_t slot = r % blocks_;
+        const uint32_t chs = std::min(trackCtx.numOut, kChannels);
+        for (uint32_t ch = 0; ch < chs; ++ch) {
+            if (trackCtx.out[ch]) {
+                std::memcpy(trackCtx.out[ch], channel_(lane, slot, ch), trackCtx.nframes * sizeof(float));
+            }
+        }
+        // Слот свободен для воркера только после копии.
+        lane.read.store(r + 1, std::memory_order_release);
+        blocksServed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void RenderAheadPool::armRt(const AudioProcessContext& ctx) noexcept {
+    if (!enabled()) {
+        return;
+    }
+    // Заранее можно рендерить только идущий транспорт: время следующего блока известно.
+    const bool streamOk = ctx.transportValid && ctx.transportPlaying && ctx.nframes > 0 &&
+                          ctx.nframes <= kMaxBlockFrames && ctx.numOut <= kChannels;
+    bool wake = false;
+    for (uint32_t t = 0; t < laneCount_; ++t) {
+        Lane& lane = lanes_[t];
+        // Из Rt трек выводит только аудио-нить: relaxed достаточно.
+        if (lane.owner.load(std::memory_order_relaxed) != kOwnerRt) {
+            wake = true;
+            continue;
+        }
+        // Эпоху снимаем до проверки: правка вне RT после нее вернет трек аудио-нити.
+        const uint64_t epoch = lane.track->controlEpoch();
+        if (!streamOk || !lane.track->canRenderAheadRt()) {
+            lane.holdBlocks = 0;
+            continue;
+        }
+        if (++lane.holdBlocks < kArmHoldBlocks) {
+            continue;
+        }
+        lane.holdBlocks = 0;
+        lane.ctx = ctx;
+        lane.ctx.in = nullptr;
+        lane.ctx.out = nullptr;
+        lane.writeTime = ctx.transportSampleTime + static_cast<uint64_t>(ctx.nframes);
+        lane.epoch = epoch;
+        lane.read.store(0, std::memory_order_relaxed);
+        lane.write.store(0, std::memory_order_relaxed);
+        lane.revoke.store(false, std::memory_order_relaxed);
+        lane.owner.store(kOwnerAhead, std::memory_order_release);
+        wake = true;
+    }
+    if (wake && !wakePending_.exchange(true, std::memory_order_acq_rel)) {
+        wake_.release();
+    }
+}
+
+bool RenderAheadPool::reclaimRt_(Lane& lane) noexcept {
+    if (lane.owner.load(std::memory_order_acquire) == kOwnerRt) {
+        return true;
+    }
+    lane.revoke.store(true, std::memory_order_release);
+    uint32_t expected = kOwnerAhead;
+    if (!lane.owner.compare_exchange_strong(expected, kOwnerRt, std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+        return false; // Busy
+    }
+    // Неотыгранные блоки выбрасываем: трек продолжит с начала первого из них.
+    // Если трек успел подхватить правку вне RT, позиция из кольца к нему уже не относится.
+    const uint32_t r = lane.read.load(std::memory_order_relaxed);
+    const uint32_t w = lane.write.load(std::memory_order_acquire);
+    if (r != w && lane.track->controlEpoch() == lane.epoch) {
+        lane.track->seekRenderPositionRt(lane.chunks[r % blocks_].position);
+    }
+    lane.read.store(0, std::memory_order_relaxed);
+    lane.write.store(0, std::memory_order_relaxed);
+    lane.revoke.store(false, std::memory_order_relaxed);
+    lane.holdBlocks = 0;
+    for (uint32_t i = 0; i < lane.deferredCount; ++i) {
+        lane.track->onRtCommand(lane.deferred[i]);
+    }
+    lane.deferredCount = 0;
+    revokes_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool RenderAheadPool::sameStream_(const AudioProcessContext& a, const AudioProcessContext& b) noexcept {
+    return a.nframes == b.nframes &&
+           a.numOut == b.numOut &&
+           a.transportValid == b.transportValid &&
+           a.transportPlaying == b.transportPlaying &&
+           a.transportTsNum == b.transportTsNum &&
+           a.transportTsDen == b.transportTsDen &&
+           a.transportBpm == b.transportBpm &&
+           a.transportQuant == b.transportQuant;
+}
+
+bool RenderAheadPool::renderOneBlock_(Lane& lane) noexcept {
+    if (lane.revoke.load(std::memory_order_acquire) ||
+        lane.write.load(std::memory_order_relaxed) - lane.read.load(std::memory_order_relaxed) >= blocks_) {
+        return false;
+    }
+    uint32_t expected = kOwnerAhead;
+    if (!lane.owner.compare_exchange_strong(expected, kOwnerBusy, std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+        return false;
+    }
+    const uint32_t w = lane.write.load(std::memory_order_relaxed);
+    const uint32_t r = lane.read.load(std::memory_order_acquire);
+    if (lane.revoke.load(std::memory_order_acquire) || w - r >= blocks_) {
+        lane.owner.store(kOwnerAhead, std::memory_order_release);
+        return false;
+    }
+
+    const uint32_t slot = w % blocks_;
+    AudioProcessContext ctx = lane.ctx;
+    const uint32_t chs = std::clamp<uint32_t>(ctx.numOut, 1u, kChannels);
+    float* outs[kChannels]{};
+    for (uint32_t ch = 0; ch < chs; ++ch) {
+        outs[ch] = channel_(lane, slot, ch);
+        std::memset(outs[ch], 0, ctx.nframes * sizeof(float));
+    }
+    ctx.out = outs;
+    ctx.numOut = chs;
+    ctx.transportSampleTime = lane.writeTime;
+
+    Chunk& chunk = lane.chunks[slot];
+    chunk.transportSampleTime = lane.writeTime;
+    chunk.position = lane.track->renderPositionRt();
+    lane.track->process(ctx);
+    lane.writeTime += static_cast<uint64_t>(ctx.nframes);
+
+    lane.write.store(w + 1, std::memory_order_release);
+    lane.owner.store(kOwnerAhead, std::memory_order_release);
+    return true;
+}
+
+void RenderAheadPool::workerLoop_(int rtPriority) noexcept {
+    configureCurrentThread(rtPriority);
+    while (!quit_.load(std::memory_order_acquire)) {
+        // Сначала съедаем wake, потом снимаем флаг: так аудио-нить не отпустит
+        // семафор второй раз, пока первый permit не забран.
+        while (wake_.try_acquire()) {
+        }
+        wakePending_.store(false, std::memory_order_release);
+        // По блоку на трек за проход: кольца заполняются равномерно.
+        bool progressed = false;
+        for (uint32_t t = 0; t < laneCount_; ++t) {
+            progressed = renderOneBlock_(lanes_[t]) || progressed;
+        }
+        if (!progressed) {
+            (void)wake_.try_acquire_for(kIdleWait);
+        }
+    }
+}
+
+} // namespace avantgarde
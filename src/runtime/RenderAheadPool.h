@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+#include "contracts/ITrack.h"
+#include "contracts/types.h"
+
+namespace avantgarde {
+
+// Render-ahead: фоновая нить рендерит "неинтерактивные" треки на несколько блоков
+// вперед в lock-free кольца, аудио-нить такие треки только микширует.
+//
+// Модель владения (на трек, atomic owner):
+// - Rt    — трек принадлежит аудио-нити: команды и process() как обычно;
+// - Ahead — трек отдан воркеру: аудио-нить его не трогает, читает готовые блоки из кольца;
+// - Busy  — воркер прямо сейчас внутри process() этого трека.
+// Аудио-нить забирает трек обратно CAS Ahead -> Rt и никогда не ждет воркер:
+// если он Busy, команды трека откладываются (kMaxDeferredCommands), а блок берется
+// из кольца (или трек молчит, если кольцо пусто) — до следующего блока.
+// При возврате неотыгранные блоки выбрасываются, позиция трека откатывается
+// на начало первого из них (ITrack::seekRenderPositionRt).
+//
+// start()/stop() — только вне RT. Все *Rt() — только из аудио-нити
+// (readRt() — из задачи рендера своего трека, в т.ч. на RtWorkerPool).
+class RenderAheadPool {
+public:
+    static constexpr uint32_t kMaxBlocks = 16;
+    static constexpr std::size_t kMaxBlockFrames = 1024;
+    static constexpr uint32_t kChannels = 2;
+    static constexpr uint32_t kMaxDeferredCommands = 32;
+    // Столько блоков подряд трек должен оставаться пригодным, прежде чем его отдадут
+    // воркеру: правка ручкой не должна гонять трек туда-обратно каждый блок.
+    static constexpr uint32_t kArmHoldBlocks = 8;
+
+    RenderAheadPool() noexcept = default;
+    ~RenderAheadPool();
+
+    RenderAheadPool(const RenderAheadPool&) = delete;
+    RenderAheadPool& operator=(const RenderAheadPool&) = delete;
+
+    // Вне RT. blocks — глубина колец (clamp до kMaxBlocks), 0 — выключено.
+    // Кольца выделяются под переданные треки; воркер получает SCHED_FIFO с rtPriority
+    // (<=0 — не трогаем приоритет), если это разрешено системой.
+    bool start(ITrack* const* tracks, uint32_t trackCount, uint32_t blocks, int rtPriority);
+    void stop() noexcept;
+
+    bool enabled() const noexcept { return blocks_ > 0; }
+
+    // RT. Команда адресована треку: true — доставить ее треку сейчас (трек у аудио-нити
+    // или только что возвращен ей), false — трек занят воркером, команда отложена.
+    bool admitCommandRt(uint32_t track, const RtCommand& cmd) noexcept;
+    // RT, после drain команд и до рендера треков: проверка колец (transport, размер блока,
+    // изменения трека вне RT) и возврат треков, которые больше нельзя рендерить заранее.
+    void syncRt(const AudioProcessContext& ctx) noexcept;
+    // RT. Вернуть все треки аудио-нити (граф маршрутизации, нестандартный блок).
+    // false — кто-то еще занят воркером: в этом блоке его нельзя трогать.
+    bool revokeAllRt() noexcept;
+    // RT. true — трек в этом блоке не принадлежит аудио-нити (ее process() звать нельзя).
+    bool ownedByWorkerRt(uint32_t track) const noexcept;
+    // RT, задача рендера трека. true — выход трека взят из кольца (или тишина),
+    // false — трек рендерится аудио-нитью как обычно.
+    bool readRt(uint32_t track, const AudioProcessContext& trackCtx) noexcept;
+    // RT, после рендера треков блока: отдать воркеру треки, готовые к render-ahead.
+    void armRt(const AudioProcessContext& ctx) noexcept;
+
+    // Счетчики для диагностики (читаются вне RT, приблизительно).
+    uint64_t blocksServed() const noexcept { return blocksServed_.load(std::memory_order_relaxed); }
+    uint64_t underruns() const noexcept { return underruns_.load(std::memory_order_relaxed); }
+    uint64_t revokes() const noexcept { return revokes_.load(std::memory_order_relaxed); }
+
+private:
+    enum : uint32_t { kOwnerRt = 0, kOwnerAhead = 1, kOwnerBusy = 2 };
+    enum class Serve : uint8_t { Track, Chunk, Silence };
+
+    struct Chunk {
+        uint64_t transportSampleTime{0};
+        double position{0.0};
+    };
+
+    struct Lane {
+        ITrack* track{nullptr};
+        std::atomic<uint32_t> owner{kOwnerRt};
+        // Аудио-нить просит вернуть трек: воркер больше не начинает новых блоков.
+        std::atomic<bool> revoke{false};
+        // SPSC: write — воркер, read — аудио-нить. Монотонные счетчики блоков.
+        std::atomic<uint32_t> write{0};
+        std::atomic<uint32_t> read{0};
+        std::array<Chunk, kMaxBlocks> chunks{};
+        // [block][channel][kMaxBlockFrames]
+        std::vector<float> audio{};
+
+        // Шаблон контекста и время следующего блока воркера (пишет аудио-нить до
+        // передачи трека, дальше — только воркер).
+        AudioProcessContext ctx{};
+        uint64_t writeTime{0};
+
+        // Только аудио-нить.
+        uint64_t epoch{0};
+        uint32_t holdBlocks{0};
+        Serve serve{Serve::Track};
+        std::array<RtCommand, kMaxDeferredCommands> deferred{};
+        uint32_t deferredCount{0};
+    };
+
+    float* channel_(Lane& lane, uint32_t block, uint32_t ch) noexcept {
+        return lane.audio.data() + (static_cast<std::size_t>(block) * kChannels + ch) * kMaxBlockFrames;
+    }
+
+    bool reclaimRt_(Lane& lane) noexcept;
+    static bool sameStream_(const AudioProcessContext& a, const AudioProcessContext& b) noexcept;
+    bool renderOneBlock_(Lane& lane) noexcept;
+    void workerLoop_(int rtPriority) noexcept;
+
+    std::unique_ptr<Lane[]> lanes_{};
+    uint32_t laneCount_{0};
+    uint32_t blocks_{0};
+
+    std::thread thread_{};
+    std::atomic<bool> quit_{false};
+    std::binary_semaphore wake_{0};
+    std::atomic<bool> wakePending_{false};
+
+    std::atomic<uint64_t> blocksServed_{0};
+    std::atomic<uint64_t> underruns_{0};
+    std::atomic<uint64_t> revokes_{0};
+};
+
+} // namespace avantgarde
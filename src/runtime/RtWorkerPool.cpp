@@ -0,0 +1,146 @@
+#include "runtime/RtWorkerPool.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace avantgarde {
+
+namespace {
+
+inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+void configureCurrentThread(int cpu, int rtPriority) noexcept {
+#if defined(__linux__)
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+    if (rtPriority > 0) {
+        sched_param sp{};
+        sp.sched_priority = rtPriority;
+        // Без CAP_SYS_NICE/rtprio лимита вызов вернет EPERM — остаемся на SCHED_OTHER.
+        (void)pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+    }
+#else
+    (void)cpu;
+    (void)rtPriority;
+#endif
+}
+
+} // namespace
+
+RtWorkerPool::~RtWorkerPool() {
+    stop();
+}
+
+bool RtWorkerPool::start(uint32_t numWorkers, int firstCpu, int rtPriority) {
+    stop();
+    const uint32_t n = std::min(numWorkers, kMaxWorkers);
+    if (n == 0) {
+        return true;
+    }
+
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    quit_.store(false, std::memory_order_relaxed);
+    work_.store(0, std::memory_order_relaxed);
+    threads_.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        const int cpu = (firstCpu >= 0)
+                            ? static_cast<int>((static_cast<unsigned>(firstCpu) + i) % hw)
+                            : -1;
+        threads_.emplace_back([this, cpu, rtPriority]() { workerLoop_(cpu, rtPriority); });
+    }
+    return true;
+}
+
+void RtWorkerPool::stop() noexcept {
+    if (threads_.empty()) {
+        return;
+    }
+    quit_.store(true, std::memory_order_release);
+    wake_.release(static_cast<std::ptrdiff_t>(threads_.size()));
+    for (auto& t : threads_) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+    threads_.clear();
+    // Лишние permits (если воркер вышел раньше, чем съел свой) не должны
+    // разбудить следующий набор потоков вхолостую.
+    while (wake_.try_acquire()) {
+    }
+}
+
+void RtWorkerPool::parallelFor(TaskFn fn, void* user, uint32_t count) noexcept {
+    if (!fn || count == 0) {
+        return;
+    }
+    if (threads_.empty() || count == 1) {
+        for (uint32_t i = 0; i < count; ++i) {
+            fn(user, i);
+        }
+        return;
+    }
+
+    fn_.store(fn, std::memory_order_relaxed);
+    user_.store(user, std::memory_order_relaxed);
+    done_.store(0, std::memory_order_relaxed);
+    // Публикация задания: release гарантирует видимость fn/user для воркера,
+    // который получит индекс < count через fetch_add (acq_rel).
+    work_.store(static_cast<uint64_t>(count) << 32, std::memory_order_release);
+
+    const uint32_t toWake = std::min<uint32_t>(static_cast<uint32_t>(threads_.size()), count - 1);
+    wake_.release(static_cast<std::ptrdiff_t>(toWake));
+
+    runClaimedTasks_();
+
+    uint32_t spins = 0;
+    while (done_.load(std::memory_order_acquire) < count) {
+        if (++spins < 2048) {
+            cpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    // Закрываем задание: опоздавший воркер увидит count=0 и уснет.
+    work_.store(0, std::memory_order_relaxed);
+}
+
+void RtWorkerPool::runClaimedTasks_() noexcept {
+    for (;;) {
+        const uint64_t w = work_.fetch_add(1, std::memory_order_acq_rel);
+        const uint32_t i = static_cast<uint32_t>(w & 0xFFFFFFFFu);
+        const uint32_t count = static_cast<uint32_t>(w >> 32);
+        if (i >= count) {
+            return;
+        }
+        TaskFn fn = fn_.load(std::memory_order_relaxed);
+        fn(user_.load(std::memory_order_relaxed), i);
+        done_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void RtWorkerPool::workerLoop_(int cpu, int rtPriority) noexcept {
+    configureCurrentThread(cpu, rtPriority);
+    for (;;) {
+        wake_.acquire();
+        if (quit_.load(std::memory_order_acquire)) {
+            return;
+        }
+        runClaimedTasks_();
+    }
+}
+
+} // namespace avantgarde
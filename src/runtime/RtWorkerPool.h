@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+namespace avantgarde {
+
+// RT-safe пул воркеров для параллельного рендера внутри аудио-блока.
+//
+// Модель:
+// - start()/stop() — только вне RT (создание/join потоков, affinity, приоритет);
+// - parallelFor() — из аудио-нити: без аллокаций и mutex'ов.
+//   Задачи раздаются через atomic fetch_add, вызывающая нить тоже берет задачи,
+//   а затем дожидается завершения остальных (spin + yield).
+//
+// Порядок выполнения задач НЕ детерминирован — детерминизм результата
+// обеспечивает вызывающая сторона (каждая задача пишет в свой буфер).
+class RtWorkerPool {
+public:
+    using TaskFn = void (*)(void* user, uint32_t taskIndex) noexcept;
+
+    static constexpr uint32_t kMaxWorkers = 7;
+
+    RtWorkerPool() noexcept = default;
+    ~RtWorkerPool();
+
+    RtWorkerPool(const RtWorkerPool&) = delete;
+    RtWorkerPool& operator=(const RtWorkerPool&) = delete;
+
+    // Вне RT. Поднимает numWorkers потоков (clamp до kMaxWorkers).
+    // Воркер i пиннится на CPU (firstCpu + i) % hw_concurrency и, если разрешено
+    // системой, получает SCHED_FIFO с rtPriority (<=0 — не трогаем приоритет).
+    // Повторный вызов пересоздает пул. numWorkers=0 — пул выключен.
+    bool start(uint32_t numWorkers, int firstCpu = 1, int rtPriority = 0);
+    // Вне RT. Будит и join'ит все воркеры.
+    void stop() noexcept;
+
+    uint32_t numWorkers() const noexcept { return static_cast<uint32_t>(threads_.size()); }
+
+    // RT. Выполнить fn(user, i) для i в [0..count) на воркерах + текущей нити.
+    // Возвращается после завершения всех задач.
+    void parallelFor(TaskFn fn, void* user, uint32_t count) noexcept;
+
+private:
+    void workerLoop_(int cpu, int rtPriority) noexcept;
+    void runClaimedTasks_() noexcept;
+
+    std::vector<std::thread> threads_{};
+    std::counting_semaphore<> wake_{0};
+    std::atomic<bool> quit_{false};
+
+    std::atomic<TaskFn> fn_{nullptr};
+    std::atomic<void*> user_{nullptr};
+    // Упакованное состояние задания: (count << 32) | nextIndex.
+    // count и индекс читаются одним fetch_add, поэтому опоздавший воркер
+    // не может сопоставить старый индекс с count следующего задания.
+    // work_ == 0 — задания нет.
+    std::atomic<uint64_t> work_{0};
+    std::atomic<uint32_t> done_{0};
+};
+
+} // namespace avantgarde
@@ -1,4 +1,5 @@
 #include "contracts/ISamplePreviewEngine.h"
+#include "contracts/ClipSampleFormat.h"
 
 #include <algorithm>
 #include <atomic>
@@ -46,7 +47,8 @@ public:
         clipCtl_ = std::make_shared<SharedClipBuffer>(sample);
         pendingClip_.store(clipCtl_.get(), std::memory_order_release);
 
-        const SampleRegion safe = sanitizeRegion(region, static_cast<int32_t>(sample.frames));
+        // У потокового клипа preview играет только голову: RT-чтение с диска здесь не нужно.
+        const SampleRegion safe = sanitizeRegion(region, static_cast<int32_t>(sample.residentFrames()));
         regionStart_.store(safe.startFrame, std::memory_order_release);
         regionEnd_.store(safe.endFrame, std::memory_order_release);
         loopMode_.store(loopMode, std::memory_order_release);
@@ -69,7 +71,7 @@ public:
     void setLoop(const SampleRegion& region,
                  SamplePreviewLoopMode loopMode) noexcept override {
         const SharedClipBuffer* clip = clipRt_;
-        const int32_t total = (clip && clip->valid()) ? static_cast<int32_t>(clip->frames) : 2;
+        const int32_t total = (clip && clip->valid()) ? static_cast<int32_t>(clip->residentFrames()) : 2;
         const SampleRegion safe = sanitizeRegion(region, total);
         regionStart_.store(safe.startFrame, std::memory_order_release);
         regionEnd_.store(safe.endFrame, std::memory_order_release);
@@ -123,7 +125,7 @@ public:
                         regionStart_.load(std::memory_order_acquire),
                         regionEnd_.load(std::memory_order_acquire),
                     },
-                    static_cast<int32_t>(clip->frames));
+                    static_cast<int32_t>(clip->residentFrames()));
                 regionStartRt_ = safe.startFrame;
                 regionEndRt_ = safe.endFrame;
                 loopRt_ = (loopMode_.load(std::memory_order_acquire) == SamplePreviewLoopMode::On);
@@ -141,14 +143,8 @@ public:
             return;
         }
 
+        // valid() гарантирует каналы в формате хранения; моно читается как оба канала.
         const SharedClipBuffer* clip = clipRt_;
-        const float* ch0 = clip->ch0.get();
-        const float* ch1 = (clip->channels == 2 && clip->ch1) ? clip->ch1.get() : clip->ch0.get();
-        if (!ch0 || !ch1) {
-            runningRt_ = false;
-            uiPlaying_.store(false, std::memory_order_relaxed);
-            return;
-        }
 
         // Runtime-параметры допускают "живое" изменение на лету.
         {
@@ -157,7 +153,7 @@ public:
                     regionStart_.load(std::memory_order_acquire),
                     regionEnd_.load(std::memory_order_acquire),
                 },
-                static_cast<int32_t>(clip->frames));
+                static_cast<int32_t>(clip->residentFrames()));
             regionStartRt_ = safe.startFrame;
             regionEndRt_ = safe.endFrame;
             loopRt_ = (loopMode_.load(std::memory_order_acquire) == SamplePreviewLoopMode::On);
@@ -187,8 +183,10 @@ public:
                 i1 = loopRt_ ? start : (end - 1);
             }
             const float frac = clamp01(static_cast<float>(readPosRt_ - static_cast<double>(i0)));
-            const float l = ch0[i0] + (ch0[i1] - ch0[i0]) * frac;
-            const float r = ch1[i0] + (ch1[i1] - ch1[i0]) * frac;
+            const float l0 = clipSampleAt(*clip, 0, i0);
+            const float r0 = clipSampleAt(*clip, 1, i0);
+            const float l = l0 + (clipSampleAt(*clip, 0, i1) - l0) * frac;
+            const float r = r0 + (clipSampleAt(*clip, 1, i1) - r0) * frac;
 
             if (out0 == out1) {
                 // Mono out: чтобы не удваивать уровень, сводим L/R в mono-среднее.
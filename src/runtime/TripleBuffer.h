@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace avantgarde {
+
+// Lock-free тройной буфер: один писатель (RT), один читатель (UI).
+//
+// Писатель заполняет свой back-слот и публикует его обменом с middle;
+// читатель забирает middle, только если там свежие данные, и читает свой
+// front-слот на месте — без копирования и без ожидания писателя.
+// Ни одна из сторон не блокирует другую; читатель видит последний
+// опубликованный кадр (промежуточные могут быть пропущены).
+template <class T>
+class TripleBuffer {
+public:
+    // Писатель: слот для заполнения (валиден до publish()).
+    T& writeSlot() noexcept { return slots_[back_]; }
+
+    // Писатель: опубликовать заполненный слот.
+    void publish() noexcept {
+        back_ = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Читатель: последний опубликованный кадр. Ссылка валидна до следующего read().
+    const T& read() noexcept {
+        if (middle_.load(std::memory_order_relaxed) & kFresh) {
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+        }
+        return slots_[front_];
+    }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    T slots_[3]{};
+    uint8_t back_{0};                 // только писатель
+    std::atomic<uint8_t> middle_{1};  // индекс | kFresh
+    uint8_t front_{2};                // только читатель
+};
+
+} // namespace avantgarde
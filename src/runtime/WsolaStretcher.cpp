@@ -0,0 +1,342 @@
+#include "runtime/WsolaStretcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "runtime/ClipResampleKernel.h"
+
+namespace avantgarde {
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586;
+
+// Кадры playback-региона: луп заворачивает индекс, one-shot вне региона — тишина (-1).
+struct RegionIndex {
+    int64_t start{0};
+    int64_t end{0};
+    bool loop{false};
+
+    int64_t map(int64_t i) const noexcept {
+        if (i >= start && i < end) {
+            return i;
+        }
+        if (!loop) {
+            return -1;
+        }
+        const int64_t span = end - start;
+        int64_t r = (i - start) % span;
+        if (r < 0) {
+            r += span;
+        }
+        return start + r;
+    }
+};
+
+RegionIndex regionIndex(const WsolaSource& src) noexcept {
+    RegionIndex r{};
+    r.start = std::clamp<int64_t>(static_cast<int64_t>(std::floor(src.regionStart)), 0, src.frames - 1);
+    r.end = std::clamp<int64_t>(static_cast<int64_t>(std::ceil(src.regionEnd)), r.start + 1, src.frames);
+    r.loop = src.loop;
+    return r;
+}
+
+template <typename S>
+float sampleAt(const S* ch, int64_t i) noexcept {
+    return (i < 0) ? 0.0f : clip_kernel::load1(ch + i);
+}
+
+// acc[k] += w[k] * x(start + k * rate), k < n. Целый start при rate == 1 — без интерполяции.
+template <typename S>
+void accumulate(const S* ch, const RegionIndex& r, double start, double rate, const float* w, float* acc,
+                std::size_t n) noexcept {
+    if (rate == 1.0 && start == std::floor(start)) {
+        const int64_t s = static_cast<int64_t>(start);
+        if (s >= r.start && s + static_cast<int64_t>(n) <= r.end) {
+            const S* x = ch + s;
+            for (std::size_t k = 0; k < n; ++k) {
+                acc[k] += w[k] * clip_kernel::load1(x + k);
+            }
+            return;
+        }
+        for (std::size_t k = 0; k < n; ++k) {
+            acc[k] += w[k] * sampleAt(ch, r.map(s + static_cast<int64_t>(k)));
+        }
+        return;
+    }
+    for (std::size_t k = 0; k < n; ++k) {
+        const double pos = start + static_cast<double>(k) * rate;
+        const double fl = std::floor(pos);
+        const int64_t i0 = static_cast<int64_t>(fl);
+        const float frac = static_cast<float>(pos - fl);
+        const float a = sampleAt(ch, r.map(i0));
+        const float b = sampleAt(ch, r.map(i0 + 1));
+        acc[k] += w[k] * (a + frac * (b - a));
+    }
+}
+
+template <typename S>
+float monoAt(const S* c0, const S* c1, int64_t i) noexcept {
+    return c1 ? 0.5f * (clip_kernel::load1(c0 + i) + clip_kernel::load1(c1 + i)) : clip_kernel::load1(c0 + i);
+}
+
+// Уточнение склейки по исходнику: лучший старт в [center - radius, center + radius] ∩ [lo, hi]
+// для отрезка target длиной n (моно с естественного продолжения).
+template <typename S>
+int64_t refine(const S* c0, const S* c1, const float* target, std::size_t n, int64_t center, int64_t radius,
+               int64_t lo, int64_t hi) noexcept {
+    int64_t best = center;
+    double bestScore = -std::numeric_limits<double>::infinity();
+    for (int64_t s = std::max(lo, center - radius); s <= std::min(hi, center + radius); ++s) {
+        float dot = 0.0f;
+        float energy = 0.0f;
+        for (std::size_t k = 0; k < n; ++k) {
+            const float x = monoAt(c0, c1, s + static_cast<int64_t>(k));
+            dot += target[k] * x;
+            energy += x * x;
+        }
+        const double score = static_cast<double>(dot) / std::sqrt(static_cast<double>(energy) + 1e-9);
+        if (score > bestScore) {
+            bestScore = score;
+            best = s;
+        }
+    }
+    return best;
+}
+
+// Вызвать fn(c0, c1) с каналами в типе хранения.
+template <typename Fn>
+void withChannels(const WsolaSource& src, Fn&& fn) noexcept {
+    switch (src.format) {
+        case ClipSampleFormat::Int16:
+            fn(static_cast<const int16_t*>(src.c0), static_cast<const int16_t*>(src.c1));
+            return;
+        case ClipSampleFormat::Float16:
+            fn(static_cast<const uint16_t*>(src.c0), static_cast<const uint16_t*>(src.c1));
+            return;
+        case ClipSampleFormat::Float32:
+            break;
+    }
+    fn(static_cast<const float*>(src.c0), static_cast<const float*>(src.c1));
+}
+
+} // namespace
+
+WsolaStretcher::WsolaStretcher() noexcept {
+    // Периодическое окно Ханна: w[k] + w[k + kHop] == 1.
+    for (std::size_t k = 0; k < kGrain; ++k) {
+        window_[k] = static_cast<float>(0.5 - 0.5 * std::cos(kTwoPi * static_cast<double>(k) / kGrain));
+    }
+}
+
+void WsolaStretcher::reset() noexcept {
+    primed_ = false;
+    forceAlign_ = false;
+    readyPos_ = kHop;
+}
+
+void WsolaStretcher::realign() noexcept {
+    if (primed_) {
+        forceAlign_ = true;
+    }
+}
+
+std::size_t WsolaStretcher::render(const WsolaSource& src, double nominal, double rate, float gain,
+                                   float* dst0, float* dst1, std::size_t maxFrames) noexcept {
+    if (!src.c0 || src.frames <= 0 || maxFrames == 0) {
+        return 0;
+    }
+    if (readyPos_ >= kHop) {
+        synthesize_(src, nominal, rate);
+    }
+    const std::size_t n = std::min(maxFrames, kHop - readyPos_);
+    const float* r0 = ready0_.data() + readyPos_;
+    const float* r1 = (src.c1 ? ready1_.data() : ready0_.data()) + readyPos_;
+    for (std::size_t k = 0; k < n; ++k) {
+        dst0[k] = gain * r0[k];
+        if (dst1) {
+            dst1[k] = gain * r1[k];
+        }
+    }
+    readyPos_ += n;
+    return n;
+}
+
+void WsolaStretcher::synthesize_(const WsolaSource& src, double nominal, double rate) noexcept {
+    const RegionIndex r = regionIndex(src);
+    double start = 0.0;
+    if (!primed_) {
+        // Вторая половина "предыдущего" grain-а — тот же материал с nominal: первый
+        // grain дополняет его до единичного окна, и выход начинается без fade-in.
+        start = std::round(nominal);
+        acc0_.fill(0.0f);
+        acc1_.fill(0.0f);
+        withChannels(src, [&](const auto* c0, const auto* c1) {
+            accumulate(c0, r, start, rate, window_.data() + kHop, acc0_.data(), kHop);
+            if (c1) {
+                accumulate(c1, r, start, rate, window_.data() + kHop, acc1_.data(), kHop);
+            }
+        });
+        primed_ = true;
+        forceAlign_ = false;
+    } else {
+        start = chooseStart_(src, nominal, rate);
+    }
+
+    withChannels(src, [&](const auto* c0, const auto* c1) {
+        accumulate(c0, r, start, rate, window_.data(), acc0_.data(), kGrain);
+        if (c1) {
+            accumulate(c1, r, start, rate, window_.data(), acc1_.data(), kGrain);
+        }
+    });
+    std::memcpy(ready0_.data(), acc0_.data(), kHop * sizeof(float));
+    std::memcpy(ready1_.data(), acc1_.data(), kHop * sizeof(float));
+    std::memmove(acc0_.data(), acc0_.data() + kHop, kHop * sizeof(float));
+    std::memmove(acc1_.data(), acc1_.data() + kHop, kHop * sizeof(float));
+    std::fill(acc0_.begin() + kHop, acc0_.end(), 0.0f);
+    std::fill(acc1_.begin() + kHop, acc1_.end(), 0.0f);
+    prevStart_ = start;
+    readyPos_ = 0;
+    ++grains_;
+}
+
+double WsolaStretcher::chooseStart_(const WsolaSource& src, double nominal, double rate) noexcept {
+    const RegionIndex r = regionIndex(src);
+    const double hopSpan = static_cast<double>(kHop) * rate;
+    const double grainSpan = static_cast<double>(kGrain) * rate;
+
+    // Естественное продолжение предыдущего grain-а; в лупе — его образ, ближайший к nominal.
+    double natural = prevStart_ + hopSpan;
+    if (src.loop) {
+        const double span = static_cast<double>(r.end - r.start);
+        while (natural >= static_cast<double>(r.end)) {
+            natural -= span;
+        }
+        if (natural - nominal > 0.5 * span) {
+            natural -= span;
+        } else if (nominal - natural > 0.5 * span) {
+            natural += span;
+        }
+    }
+    if (forceAlign_) {
+        forceAlign_ = false;
+        return std::round(nominal);
+    }
+    // Playhead не разошелся с grain-ами (rate == inc): продолжение и есть идеальная склейка.
+    if (std::fabs(natural - nominal) < 1.0) {
+        return natural;
+    }
+    const ClipStretchAnalysis* a = src.analysis;
+    if (!a || a->frames != src.frames || rate > kMaxSearchRate) {
+        return std::round(nominal);
+    }
+    const bool canHold = std::fabs(natural - nominal) <= grainSpan;
+    double lo = nominal - kSearchFrames;
+    double hi = nominal + kSearchFrames;
+    const auto& onsets = a->onsets;
+    // Атака в хвосте предыдущего grain-а (его перекрытие со следующим) или между ним и
+    // окном поиска (ускорение): продолжаем как есть — обе половины перекрытия несут
+    // атаку в одной фазе, и она не пропадает.
+    const auto next = std::lower_bound(onsets.begin(), onsets.end(), static_cast<int32_t>(std::ceil(natural - hopSpan)));
+    if (canHold && next != onsets.end() && static_cast<double>(*next) < std::max(natural + hopSpan, lo)) {
+        ++onsetHolds_;
+        return natural;
+    }
+    // Уже сыгранную атаку (до natural) не повторяем: замедление тянуло бы склейку назад к ней.
+    // Пока playhead ее не догнал, идем дальше естественным продолжением.
+    const auto played = std::lower_bound(onsets.begin(), onsets.end(), static_cast<int32_t>(std::ceil(natural)));
+    if (played != onsets.begin()) {
+        lo = std::max(lo, static_cast<double>(*(played - 1) + ClipStretchAnalysis::kOnsetWindow));
+    }
+    if (lo > hi) {
+        return natural;
+    }
+    // Поиск без заворота лупа: отрезок корреляции целиком внутри региона.
+    lo = std::max(lo, static_cast<double>(r.start));
+    hi = std::min(hi, static_cast<double>(r.end) - hopSpan - 1.0);
+    if (lo > hi || natural < static_cast<double>(r.start) || natural + hopSpan >= static_cast<double>(r.end) - 1.0) {
+        return canHold ? natural : std::clamp(std::round(nominal), lo, std::max(lo, hi));
+    }
+    return searchStart_(src, natural, lo, hi, rate);
+}
+
+double WsolaStretcher::searchStart_(const WsolaSource& src, double natural, double lo, double hi,
+                                    double rate) noexcept {
+    constexpr int64_t kD = ClipStretchAnalysis::kDecimation;
+    const ClipStretchAnalysis& a = *src.analysis;
+    const float* m = a.mono.data();
+    const int64_t mn = static_cast<int64_t>(a.mono.size());
+    const double hopSpan = static_cast<double>(kHop) * rate;
+    const std::size_t len = std::clamp<std::size_t>(static_cast<std::size_t>(hopSpan) / kD, 1, target_.size());
+
+    const int64_t t0 = static_cast<int64_t>(std::floor(natural)) / kD;
+    const int64_t c0 = static_cast<int64_t>(std::ceil(lo / kD));
+    const int64_t c1 = std::min(static_cast<int64_t>(std::floor(hi / kD)), mn - static_cast<int64_t>(len));
+    if (t0 + static_cast<int64_t>(len) > mn || c0 > c1) {
+        return natural;
+    }
+    std::copy_n(m + t0, len, target_.data());
+    float targetEnergy = 0.0f;
+    for (std::size_t k = 0; k < len; ++k) {
+        targetEnergy += target_[k] * target_[k];
+    }
+    if (targetEnergy < ClipStretchAnalysis::kOnsetFloor * static_cast<float>(len)) {
+        // Тишина: склеивать не с чем, идем ровно за playhead.
+        return std::clamp(std::round(0.5 * (lo + hi)), lo, hi);
+    }
+
+    // Грубо: нормированная корреляция по прореженной моно-сумме, энергия кандидата — скользящая.
+    double energy = 0.0;
+    for (std::size_t k = 0; k < len; ++k) {
+        energy += static_cast<double>(m[c0 + static_cast<int64_t>(k)]) * m[c0 + static_cast<int64_t>(k)];
+    }
+    int64_t best = c0;
+    double bestScore = -std::numeric_limits<double>::infinity();
+    for (int64_t c = c0; c <= c1; ++c) {
+        const float* x = m + c;
+        float s0 = 0.0f;
+        float s1 = 0.0f;
+        float s2 = 0.0f;
+        float s3 = 0.0f;
+        std::size_t k = 0;
+        for (; k + 4 <= len; k += 4) {
+            s0 += target_[k] * x[k];
+            s1 += target_[k + 1] * x[k + 1];
+            s2 += target_[k + 2] * x[k + 2];
+            s3 += target_[k + 3] * x[k + 3];
+        }
+        for (; k < len; ++k) {
+            s0 += target_[k] * x[k];
+        }
+        const double score = static_cast<double>((s0 + s1) + (s2 + s3)) / std::sqrt(std::max(energy, 0.0) + 1e-9);
+        if (score > bestScore) {
+            bestScore = score;
+            best = c;
+        }
+        if (c + static_cast<int64_t>(len) < mn) {
+            energy += static_cast<double>(x[len]) * x[len] - static_cast<double>(x[0]) * x[0];
+        }
+    }
+
+    const int64_t coarse = best * kD;
+    if (rate != 1.0) {
+        return std::clamp(static_cast<double>(coarse), lo, hi);
+    }
+    // Точно: ±(kDecimation - 1) кадров вокруг грубой оценки по исходнику.
+    const int64_t nat = static_cast<int64_t>(std::floor(natural));
+    int64_t fine = coarse;
+    withChannels(src, [&](const auto* ch0, const auto* ch1) {
+        using S = std::remove_cv_t<std::remove_pointer_t<decltype(ch0)>>;
+        float targetFull[kHop];
+        for (std::size_t k = 0; k < kHop; ++k) {
+            targetFull[k] = monoAt<S>(ch0, ch1, nat + static_cast<int64_t>(k));
+        }
+        fine = refine<S>(ch0, ch1, targetFull, kHop, coarse, kD - 1, static_cast<int64_t>(std::ceil(lo)),
+                         static_cast<int64_t>(std::floor(hi)));
+    });
+    return static_cast<double>(fine);
+}
+
+} // namespace avantgarde
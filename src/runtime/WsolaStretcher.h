@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "contracts/ClipStretchAnalysis.h"
+#include "contracts/types.h"
+
+namespace avantgarde {
+
+// Клип, который растягивает WsolaStretcher: каналы в формате хранения и playback-регион.
+struct WsolaSource {
+    ClipSampleFormat format{ClipSampleFormat::Float32};
+    const void* c0{nullptr};
+    const void* c1{nullptr}; // nullptr — моно (оба выхода получают канал 0)
+    int frames{0};
+    double regionStart{0.0};
+    double regionEnd{0.0};
+    bool loop{false};
+    // Анализ клипа (ClipStretchAnalysis.h); nullptr — склейка без поиска.
+    const ClipStretchAnalysis* analysis{nullptr};
+};
+
+// WSOLA time-stretch клипа для tempo sync без сдвига высоты (RT, один playhead).
+//
+// Выход собирается из grain-ов длиной kGrain кадров с окном Ханна и шагом kHop
+// (перекрытие 50%, сумма окон = 1). Каждый grain читается из клипа с шагом rate
+// (компенсация частоты клипа — высота не меняется), а его начало — рядом с nominal:
+// позицией playhead, которая идет по клипу со скоростью tempo sync. Из окна
+// ±kSearchFrames вокруг nominal выбирается начало, чей отрезок лучше всего
+// коррелирует с естественным продолжением предыдущего grain-а — склейки без
+// фазовых провалов.
+//
+// Вся подготовка — вне RT (ClipStretchAnalysis): корреляция идет по прореженной
+// моно-сумме и уточняется по исходнику только в ±(kDecimation - 1) кадрах, а около
+// атак поиск не нужен вовсе. Стоимость одного grain-а ограничена константами ниже,
+// grain считается раз в kHop кадров выхода.
+//
+// Сбой позиции (retrigger, phase reset, wrap руками) — realign(): следующий grain
+// встает ровно на nominal, а перекрытие с предыдущим дает плавный переход.
+class WsolaStretcher {
+public:
+    static constexpr std::size_t kHop = 512;
+    static constexpr std::size_t kGrain = 2 * kHop;
+    // Радиус поиска склейки в кадрах клипа (~5 мс на 48 кГц).
+    static constexpr int kSearchFrames = 256;
+    // Выше этого rate (клип много выше частоты выхода) склейка не ищется.
+    static constexpr double kMaxSearchRate = 4.0;
+
+    WsolaStretcher() noexcept;
+
+    // RT. Забыть историю: следующий grain начнется ровно с nominal без перехода.
+    void reset() noexcept;
+    // RT. Playhead прыгнул: следующий grain — ровно nominal, переход через перекрытие.
+    void realign() noexcept;
+
+    // RT. До maxFrames кадров выхода (меньше — на границе grain-а) в dst0/dst1 с gain.
+    // nominal — позиция клипа для первого выходного кадра; используется, только если
+    // с этого кадра начинается новый grain. rate — шаг чтения клипа на кадр выхода.
+    std::size_t render(const WsolaSource& src, double nominal, double rate, float gain,
+                       float* dst0, float* dst1, std::size_t maxFrames) noexcept;
+
+    // Статистика для тестов и бенчмарков: grain-ы всего, из них продолжений у атак.
+    uint64_t grains() const noexcept { return grains_; }
+    uint64_t onsetHolds() const noexcept { return onsetHolds_; }
+
+private:
+    void synthesize_(const WsolaSource& src, double nominal, double rate) noexcept;
+    double chooseStart_(const WsolaSource& src, double nominal, double rate) noexcept;
+    double searchStart_(const WsolaSource& src, double natural, double lo, double hi, double rate) noexcept;
+
+    std::array<float, kGrain> window_{};
+    std::array<float, kGrain> acc0_{};
+    std::array<float, kGrain> acc1_{};
+    std::array<float, kHop> ready0_{};
+    std::array<float, kHop> ready1_{};
+    // Отрезок естественного продолжения в прореженной моно-сумме.
+    std::array<float, static_cast<std::size_t>(kHop * kMaxSearchRate) / ClipStretchAnalysis::kDecimation + 1>
+        target_{};
+    std::size_t readyPos_{kHop};
+    double prevStart_{0.0};
+    bool primed_{false};
+    bool forceAlign_{false};
+    uint64_t grains_{0};
+    uint64_t onsetHolds_{0};
+};
+
+} // namespace avantgarde
@@ -9,6 +9,33 @@ UiState UiStateComposer::compose(const UiState& baseState,
     out.telemetry.xruns = runtimeTelemetry.xruns;
     out.telemetry.rtQueueOverflow = runtimeTelemetry.rtQueueOverflow;
     out.transport.sampleTime = runtimeTelemetry.totalCallbacks * static_cast<uint64_t>(runtimeTelemetry.blockFrames);
+
+    if (const EngineMeterFrame* m = runtimeTelemetry.meters) {
+        for (int ch = 0; ch < 2; ++ch) {
+            out.telemetry.masterPeak[ch] = m->master[ch].peak;
+            out.telemetry.masterRms[ch] = m->master[ch].rms;
+        }
+        out.telemetry.limiterGain = m->limiterGain;
+        // Индекс трека в UiState совпадает с порядком регистрации в движке.
+        for (auto& track : out.tracks) {
+            if (track.id < m->trackCount) {
+                track.meterPeak = m->tracks[track.id].peak;
+                track.meterRms = m->tracks[track.id].rms;
+            }
+        }
+    }
+
+    if (const DspLoadReport* load = runtimeTelemetry.dspLoad) {
+        out.telemetry.dspLoadPct = load->block.meanPct;
+        out.telemetry.dspLoadP99Pct = load->block.p99Pct;
+        if (load->siteCount > 0) {
+            const DspLoadSiteStats& top = load->sites[0];
+            out.telemetry.dspTopKind = top.kind;
+            out.telemetry.dspTopOwner = top.owner;
+            out.telemetry.dspTopSlot = top.slot;
+            out.telemetry.dspTopP99Pct = top.p99Pct;
+        }
+    }
     return out;
 }
 
@@ -3,6 +3,8 @@
 #include <cstdint>
 
 #include "contracts/IUi.h"
+#include "contracts/dsp_load_types.h"
+#include "contracts/meter_types.h"
 
 namespace avantgarde {
 
@@ -11,6 +13,10 @@ struct UiRuntimeTelemetryView {
     uint64_t xruns{0};
     bool rtQueueOverflow{false};
     uint32_t blockFrames{0};
+    // Последний кадр метров движка (читается на месте, без промежуточной копии); может быть nullptr.
+    const EngineMeterFrame* meters{nullptr};
+    // Последнее окно профайлера DSP-нагрузки; может быть nullptr.
+    const DspLoadReport* dspLoad{nullptr};
 };
 
 class UiStateComposer {
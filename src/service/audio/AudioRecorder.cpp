@@ -0,0 +1,161 @@
+#include "service/audio/AudioRecorder.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace avantgarde {
+namespace {
+
+// Период опроса кольца писателем: ~1/200 емкости кольца по умолчанию.
+constexpr auto kIdleWait = std::chrono::milliseconds(20);
+// Кадров за один peek(): кусок кодирования между проверками кольца.
+constexpr std::size_t kDrainFrames = 16384;
+
+bool parseBitDepth(int bitDepth, WavSampleFormat& out) noexcept {
+    switch (bitDepth) {
+        case 16: out = WavSampleFormat::Pcm16; return true;
+        case 24: out = WavSampleFormat::Pcm24; return true;
+        case 32: out = WavSampleFormat::Float32; return true;
+        default: return false;
+    }
+}
+
+} // namespace
+
+AudioRecorder::AudioRecorder(double ringSeconds)
+    : ringSeconds_(ringSeconds > 0.0 ? ringSeconds : kDefaultRingSeconds) {}
+
+AudioRecorder::~AudioRecorder() {
+    stop();
+}
+
+bool AudioRecorder::start(const std::string& filePath, const RecordConfig& cfg) {
+    stop();
+    const std::lock_guard<std::mutex> lock(mutex_);
+    error_.clear();
+    WavSampleFormat format = WavSampleFormat::Pcm24;
+    if (!parseBitDepth(cfg.bitDepth, format)) {
+        error_ = "unsupported record bit depth: " + std::to_string(cfg.bitDepth);
+        return false;
+    }
+    if (cfg.format != "wav" && cfg.format != "rf64") {
+        error_ = "unsupported record format: " + cfg.format;
+        return false;
+    }
+    if (cfg.sampleRate <= 0 || cfg.channels <= 0 || cfg.channels > RecordRing::kMaxChannels) {
+        error_ = "invalid record config";
+        return false;
+    }
+    const auto ringFrames = static_cast<std::size_t>(std::ceil(ringSeconds_ * cfg.sampleRate));
+    if (!ring_.allocate(cfg.channels, ringFrames)) {
+        error_ = "alloc record ring failed";
+        return false;
+    }
+    if (!file_.open(filePath, cfg.sampleRate, cfg.channels, format, cfg.format == "rf64", error_)) {
+        return false;
+    }
+    markers_.clear();
+    markers_.reserve(kMarkerRing);
+    markerHead_.store(0, std::memory_order_relaxed);
+    markerTail_.store(0, std::memory_order_relaxed);
+    framesWritten_.store(0, std::memory_order_relaxed);
+    droppedBlocks_.store(0, std::memory_order_relaxed);
+    quit_ = false;
+    thread_ = std::thread([this]() { writerLoop_(); });
+    recording_.store(true, std::memory_order_release);
+    accepting_.store(true);
+    return true;
+}
+
+void AudioRecorder::stop() {
+    if (!recording_.load(std::memory_order_acquire)) {
+        return;
+    }
+    accepting_.store(false);
+    // Блок, уже прошедший проверку accepting_, допишется до освобождения кольца.
+    while (inRt_.load() != 0) {
+        std::this_thread::yield();
+    }
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    const std::lock_guard<std::mutex> lock(mutex_);
+    std::string err;
+    if (!file_.close(markers_, err) && error_.empty()) {
+        error_ = err;
+    }
+    recording_.store(false, std::memory_order_release);
+}
+
+bool AudioRecorder::writeBlock(const float* const* ch, int nframes) noexcept {
+    inRt_.fetch_add(1);
+    if (!accepting_.load() || !ch || nframes <= 0) {
+        inRt_.fetch_sub(1);
+        return true;
+    }
+    const bool ok = ring_.push(ch, static_cast<std::size_t>(nframes));
+    if (!ok) {
+        droppedBlocks_.fetch_add(1, std::memory_order_relaxed);
+    }
+    inRt_.fetch_sub(1);
+    return ok;
+}
+
+void AudioRecorder::mark(uint32_t code) noexcept {
+    inRt_.fetch_add(1);
+    if (accepting_.load()) {
+        const uint32_t head = markerHead_.load(std::memory_order_relaxed);
+        if (head - markerTail_.load(std::memory_order_acquire) < kMarkerRing) {
+            markerRing_[head % kMarkerRing] = RecordMarker{ring_.writePosition(), code};
+            markerHead_.store(head + 1, std::memory_order_release);
+        }
+    }
+    inRt_.fetch_sub(1);
+}
+
+std::string AudioRecorder::lastError() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+void AudioRecorder::writerLoop_() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!quit_) {
+        lock.unlock();
+        drain_();
+        lock.lock();
+        cv_.wait_for(lock, kIdleWait, [this]() { return quit_; });
+    }
+    lock.unlock();
+    // После stop() RT больше не пишет: добираем остаток кольца.
+    drain_();
+}
+
+void AudioRecorder::drain_() {
+    RecordRing::Span spans[2];
+    int count = 0;
+    while ((count = ring_.peek(kDrainFrames, spans)) > 0) {
+        std::size_t frames = 0;
+        for (int s = 0; s < count; ++s) {
+            // Ошибка диска: кадры выбрасываются, чтобы RT не упирался в полное кольцо.
+            if (!file_.failed() && file_.append(spans[s].ch, spans[s].frames)) {
+                framesWritten_.fetch_add(spans[s].frames, std::memory_order_relaxed);
+            }
+            frames += spans[s].frames;
+        }
+        ring_.consume(frames);
+    }
+    const uint32_t head = markerHead_.load(std::memory_order_acquire);
+    uint32_t tail = markerTail_.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail) {
+        markers_.push_back(markerRing_[tail % kMarkerRing]);
+    }
+    markerTail_.store(tail, std::memory_order_release);
+}
+
+} // namespace avantgarde
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "contracts/IAudioRecorder.h"
+#include "service/audio/RecordFileWriter.h"
+#include "service/audio/RecordRing.h"
+
+namespace avantgarde {
+
+// Запись master out на диск: IAudioRecorder (control) + IRtRecordSink (RT) в одном объекте.
+//
+// RT-сторона — только копия блока в предвыделенное RecordRing (memcpy на канал) и
+// атомики: ни файлового IO, ни блокировок, ни аллокаций. Если кольцо заполнено
+// (диск отстал дольше ringSeconds), блок отбрасывается целиком и считается в
+// droppedBlocks() — xrun-а нет никогда, в файле будет пропуск.
+//
+// Нить писателя просыпается раз в kIdleWait (RT ее не будит: notify — системный
+// вызов), забирает из кольца все готовое и кодирует в RecordFileWriter: WAV или
+// RF64, 16/24/32f, запись кусками по 1 MiB с резервом места fallocate().
+//
+// cfg.format: "wav" — RIFF, для записи длиннее 4 GiB автоматически RF64;
+// "rf64" — RF64 всегда. cfg.bitDepth: 16 | 24 | 32 (float). Пишутся первые
+// cfg.channels каналов блока.
+//
+// Маркеры mark(code) привязываются к кадру файла, на котором вызваны, и
+// попадают в cue chunk при stop().
+class AudioRecorder final : public IAudioRecorder, public IRtRecordSink {
+public:
+    static constexpr double kDefaultRingSeconds = 4.0;
+    // Маркеров между проходами писателя (переполнение — маркер теряется).
+    static constexpr std::size_t kMarkerRing = 256;
+
+    explicit AudioRecorder(double ringSeconds = kDefaultRingSeconds);
+    ~AudioRecorder() override;
+
+    AudioRecorder(const AudioRecorder&) = delete;
+    AudioRecorder& operator=(const AudioRecorder&) = delete;
+
+    bool start(const std::string& filePath, const RecordConfig& cfg) override;
+    void stop() override;
+    bool isRecording() const noexcept override { return recording_.load(std::memory_order_acquire); }
+    IRtRecordSink* rtSink() noexcept override { return this; }
+    uint64_t totalFramesWritten() const noexcept override {
+        return framesWritten_.load(std::memory_order_relaxed);
+    }
+    uint64_t droppedBlocks() const noexcept override { return droppedBlocks_.load(std::memory_order_relaxed); }
+
+    // RT. Вне записи — no-op (true); false — блок не влез в кольцо.
+    bool writeBlock(const float* const* ch, int nframes) noexcept override;
+    void mark(uint32_t code) noexcept override;
+
+    // Вне RT: ошибка start()/последней записи; пусто — все в порядке.
+    std::string lastError() const;
+    // Вне RT: маркеры последней записи (кадры файла), валидны после stop().
+    const std::vector<RecordMarker>& markers() const noexcept { return markers_; }
+    // Финализирована ли последняя запись как RF64.
+    bool wroteRf64() const noexcept { return file_.wroteRf64(); }
+
+private:
+    void writerLoop_();
+    // Нить писателя: кольцо -> файл, маркеры -> markers_.
+    void drain_();
+
+    double ringSeconds_{kDefaultRingSeconds};
+    RecordRing ring_{};
+    RecordFileWriter file_{};
+
+    // RT -> писатель: SPSC маркеров.
+    std::array<RecordMarker, kMarkerRing> markerRing_{};
+    std::atomic<uint32_t> markerHead_{0};
+    std::atomic<uint32_t> markerTail_{0};
+    std::vector<RecordMarker> markers_{};
+
+    // accepting_ снимается в stop(), после чего stop() ждет inRt_ == 0: RT,
+    // успевший пройти проверку, дописывает блок в еще живое кольцо.
+    std::atomic<bool> accepting_{false};
+    std::atomic<int> inRt_{0};
+    std::atomic<bool> recording_{false};
+    std::atomic<uint64_t> framesWritten_{0};
+    std::atomic<uint64_t> droppedBlocks_{0};
+
+    mutable std::mutex mutex_{};
+    std::condition_variable cv_{};
+    bool quit_{false};
+    std::string error_{};
+    std::thread thread_{};
+};
+
+} // namespace avantgarde
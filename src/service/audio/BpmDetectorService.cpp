@@ -3,15 +3,14 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
-#include <cstring>
-#include <fstream>
 #include <initializer_list>
 #include <limits>
-#include <memory>
 #include <set>
 #include <utility>
 #include <vector>
 
+#include "contracts/WavDecoder.h"
+
 namespace avantgarde {
 namespace {
 
@@ -20,184 +19,10 @@ struct DecodedWavMono {
     std::vector<float> mono{};
 };
 
-uint16_t readU16Le(const uint8_t* p) noexcept {
-    return static_cast<uint16_t>(p[0] | (p[1] << 8));
-}
-
-uint32_t readU32Le(const uint8_t* p) noexcept {
-    return static_cast<uint32_t>(p[0] |
-                                 (p[1] << 8) |
-                                 (p[2] << 16) |
-                                 (p[3] << 24));
-}
-
-bool readExact(std::ifstream& in, void* dst, std::size_t n) {
-    in.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(n));
-    return in.good();
-}
-
 bool decodeWavMono(const std::string& path, DecodedWavMono& out, std::string& error) {
     out = DecodedWavMono{};
     error.clear();
-
-    std::ifstream in(path, std::ios::binary);
-    if (!in.is_open()) {
-        error = "cannot open file";
-        return false;
-    }
-
-    uint8_t riff[12]{};
-    if (!readExact(in, riff, sizeof(riff))) {
-        error = "cannot read RIFF header";
-        return false;
-    }
-    if (std::memcmp(riff + 0, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
-        error = "not a RIFF/WAVE file";
-        return false;
-    }
-
-    struct Fmt {
-        uint16_t audioFormat{0};   // 1=PCM, 3=float
-        uint16_t numChannels{0};   // 1..2
-        uint32_t sampleRate{0};
-        uint16_t bitsPerSample{0}; // 16/24/32
-        uint16_t blockAlign{0};
-    } fmt{};
-
-    bool haveFmt = false;
-    bool haveData = false;
-    std::vector<uint8_t> data{};
-
-    while (in.good() && !(haveFmt && haveData)) {
-        uint8_t chdr[8]{};
-        if (!readExact(in, chdr, sizeof(chdr))) {
-            break;
-        }
-        const uint32_t csize = readU32Le(chdr + 4);
-        const bool hasPad = (csize & 1U) != 0U;
-
-        if (std::memcmp(chdr, "fmt ", 4) == 0) {
-            if (csize < 16U) {
-                error = "invalid fmt chunk";
-                return false;
-            }
-            std::vector<uint8_t> buf(csize);
-            if (!readExact(in, buf.data(), csize)) {
-                error = "cannot read fmt chunk";
-                return false;
-            }
-            fmt.audioFormat = readU16Le(buf.data() + 0);
-            fmt.numChannels = readU16Le(buf.data() + 2);
-            fmt.sampleRate = readU32Le(buf.data() + 4);
-            fmt.blockAlign = readU16Le(buf.data() + 12);
-            fmt.bitsPerSample = readU16Le(buf.data() + 14);
-            haveFmt = true;
-        } else if (std::memcmp(chdr, "data", 4) == 0) {
-            data.resize(csize);
-            if (csize > 0U && !readExact(in, data.data(), csize)) {
-                error = "cannot read data chunk";
-                return false;
-            }
-            haveData = true;
-        } else {
-            in.seekg(static_cast<std::streamoff>(csize), std::ios::cur);
-            if (!in.good()) {
-                error = "cannot skip unknown chunk";
-                return false;
-            }
-        }
-
-        if (hasPad) {
-            in.seekg(1, std::ios::cur);
-            if (!in.good()) {
-                error = "cannot skip chunk padding";
-                return false;
-            }
-        }
-    }
-
-    if (!haveFmt || !haveData) {
-        error = "wav missing fmt/data chunk";
-        return false;
-    }
-    if (!(fmt.audioFormat == 1U || fmt.audioFormat == 3U)) {
-        error = "unsupported wav format (expect PCM/float)";
-        return false;
-    }
-    if (!(fmt.numChannels == 1U || fmt.numChannels == 2U)) {
-        error = "unsupported channel count";
-        return false;
-    }
-    if (!(fmt.bitsPerSample == 16U || fmt.bitsPerSample == 24U || fmt.bitsPerSample == 32U)) {
-        error = "unsupported bits per sample";
-        return false;
-    }
-    if (fmt.sampleRate == 0U || fmt.blockAlign == 0U) {
-        error = "invalid fmt values";
-        return false;
-    }
-
-    const uint32_t frames = static_cast<uint32_t>(data.size() / fmt.blockAlign);
-    if (frames == 0U) {
-        error = "empty audio data";
-        return false;
-    }
-    out.sampleRate = static_cast<int>(fmt.sampleRate);
-    out.mono.assign(frames, 0.0f);
-
-    auto clamp1 = [](float x) noexcept {
-        return std::clamp(x, -1.0f, 1.0f);
-    };
-
-    const uint8_t* src = data.data();
-    if (fmt.audioFormat == 3U && fmt.bitsPerSample == 32U) {
-        for (uint32_t i = 0; i < frames; ++i) {
-            const float* fr = reinterpret_cast<const float*>(src + i * fmt.blockAlign);
-            const float l = clamp1(fr[0]);
-            const float r = (fmt.numChannels == 2U) ? clamp1(fr[1]) : l;
-            out.mono[i] = 0.5f * (l + r);
-        }
-        return true;
-    }
-
-    if (fmt.audioFormat == 1U && fmt.bitsPerSample == 16U) {
-        for (uint32_t i = 0; i < frames; ++i) {
-            const uint8_t* fr = src + i * fmt.blockAlign;
-            const int16_t s0 = static_cast<int16_t>(readU16Le(fr + 0));
-            const float l = static_cast<float>(s0) / 32768.0f;
-            float r = l;
-            if (fmt.numChannels == 2U) {
-                const int16_t s1 = static_cast<int16_t>(readU16Le(fr + 2));
-                r = static_cast<float>(s1) / 32768.0f;
-            }
-            out.mono[i] = 0.5f * (l + r);
-        }
-        return true;
-    }
-
-    if (fmt.audioFormat == 1U && fmt.bitsPerSample == 24U) {
-        auto readS24 = [](const uint8_t* p) noexcept {
-            int32_t v = static_cast<int32_t>(p[0] | (p[1] << 8) | (p[2] << 16));
-            if ((v & 0x00800000) != 0) {
-                v |= 0xFF000000;
-            }
-            return v;
-        };
-
-        for (uint32_t i = 0; i < frames; ++i) {
-            const uint8_t* fr = src + i * fmt.blockAlign;
-            const float l = static_cast<float>(readS24(fr + 0)) / 8388608.0f;
-            float r = l;
-            if (fmt.numChannels == 2U) {
-                r = static_cast<float>(readS24(fr + 3)) / 8388608.0f;
-            }
-            out.mono[i] = 0.5f * (l + r);
-        }
-        return true;
-    }
-
-    error = "unsupported wav pcm mode";
-    return false;
+    return decodeWavFileMono(path, out.sampleRate, out.mono, &error);
 }
 
 float bpmFromLag(int sampleRate, int hop, int lag) {
@@ -0,0 +1,328 @@
+#include "service/audio/ClipDecodeCache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace avantgarde {
+namespace {
+
+namespace fs = std::filesystem;
+
+// 02: в заголовке формат хранения сэмплов (float32 / int16 / half).
+constexpr char kMagic[8] = {'A', 'G', 'C', 'L', 'I', 'P', '0', '2'};
+constexpr const char* kEntrySuffix = ".agclip";
+// Выравнивание данных каналов: кратно страницам и Linux (4K), и macOS arm64 (16K).
+constexpr uint64_t kPageAlign = 16384;
+// Предзагрузка страниц при mmap (Linux); на других ОС их подтянет mlock()/memcpy.
+#ifdef MAP_POPULATE
+constexpr int kPopulateFlag = MAP_POPULATE;
+#else
+constexpr int kPopulateFlag = 0;
+#endif
+// Сколько байт с начала и конца источника входит в хэш содержимого.
+constexpr std::size_t kFingerprintBytes = 64 * 1024;
+
+// Заголовок записи (little-endian, в начале первой страницы).
+struct EntryHeader {
+    char magic[8];
+    uint32_t sampleRate;
+    uint32_t channels;
+    uint64_t frames;
+    uint64_t dataOffset;    // начало канала 0
+    uint64_t channelStride; // байт между началами каналов
+    uint32_t sampleFormat;  // ClipSampleFormat
+    uint32_t reserved;
+};
+static_assert(std::is_trivially_copyable<EntryHeader>::value, "EntryHeader must be POD");
+
+uint64_t alignUp(uint64_t v) noexcept {
+    return (v + kPageAlign - 1U) / kPageAlign * kPageAlign;
+}
+
+// FNV-1a 64.
+uint64_t hashBytes(uint64_t h, const uint8_t* p, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::string hex64(uint64_t v) {
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(v));
+    return buf;
+}
+
+bool isEntry(const fs::path& p) {
+    return p.extension() == kEntrySuffix;
+}
+
+uint64_t bytesPerSample(ClipSampleFormat format) noexcept {
+    return (format == ClipSampleFormat::Float32) ? sizeof(float) : sizeof(int16_t);
+}
+
+} // namespace
+
+ClipDecodeCache::ClipDecodeCache(std::string directory, uint64_t maxBytes)
+    : directory_(std::move(directory)), maxBytes_(maxBytes) {
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+}
+
+bool ClipDecodeCache::keyFor_(const std::string& path, std::string& keyOut) const {
+    std::error_code ec;
+    const uint64_t size = fs::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    const auto mtime = fs::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    // Хэш всего файла стоил бы столько же, сколько декодирование: берем размер,
+    // заголовок с началом данных и хвост. Остальное страхует mtime.
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open()) {
+        return false;
+    }
+    std::vector<uint8_t> buf(static_cast<std::size_t>(std::min<uint64_t>(size, kFingerprintBytes)));
+    uint64_t h = 14695981039346656037ULL;
+    h = hashBytes(h, reinterpret_cast<const uint8_t*>(&size), sizeof(size));
+    if (!f.read(reinterpret_cast<char*>(buf.data()), static_cast<std::streamsize>(buf.size()))) {
+        return false;
+    }
+    h = hashBytes(h, buf.data(), buf.size());
+    if (size > kFingerprintBytes) {
+        const uint64_t tail = std::min<uint64_t>(size - kFingerprintBytes, kFingerprintBytes);
+        f.seekg(static_cast<std::streamoff>(size - tail));
+        if (!f.read(reinterpret_cast<char*>(buf.data()), static_cast<std::streamsize>(tail))) {
+            return false;
+        }
+        h = hashBytes(h, buf.data(), static_cast<std::size_t>(tail));
+    }
+    keyOut = hex64(h) + "-" + hex64(static_cast<uint64_t>(mtime.time_since_epoch().count()));
+    return true;
+}
+
+std::string ClipDecodeCache::entryPath_(const std::string& key) const {
+    return (fs::path(directory_) / (key + kEntrySuffix)).string();
+}
+
+bool ClipDecodeCache::load(const std::string& path, SharedClipBuffer& out) {
+    std::string key;
+    if (!keyFor_(path, key)) {
+        ++misses_;
+        return false;
+    }
+    const std::string entry = entryPath_(key);
+    const int fd = ::open(entry.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ++misses_;
+        return false;
+    }
+    struct stat st {};
+    void* base = MAP_FAILED;
+    std::size_t mapSize = 0;
+    if (::fstat(fd, &st) == 0 && static_cast<uint64_t>(st.st_size) >= sizeof(EntryHeader)) {
+        mapSize = static_cast<std::size_t>(st.st_size);
+        base = ::mmap(nullptr, mapSize, PROT_READ, MAP_SHARED | kPopulateFlag, fd, 0);
+    }
+    // Отображение держит файл само: дескриптор больше не нужен.
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        ++misses_;
+        return false;
+    }
+    // Клип читает аудио-нить: страницы подгружаются здесь, на нити загрузки, и
+    // закрепляются, чтобы вытеснение page cache не дало major fault (чтение SD) в RT.
+    // Не вышло закрепить (RLIMIT_MEMLOCK) — копия в анонимную память, ее не вытесняют.
+    if (::mlock(base, mapSize) != 0) {
+        void* anon = ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (anon != MAP_FAILED) {
+            std::memcpy(anon, base, mapSize);
+            (void)::mprotect(anon, mapSize, PROT_READ);
+        }
+        ::munmap(base, mapSize);
+        if (anon == MAP_FAILED) {
+            ++misses_;
+            return false;
+        }
+        base = anon;
+    }
+    std::shared_ptr<void> mapping(base, [mapSize](void* p) { ::munmap(p, mapSize); });
+
+    EntryHeader h{};
+    std::memcpy(&h, base, sizeof(h));
+    const auto format = static_cast<ClipSampleFormat>(h.sampleFormat);
+    const uint64_t sampleBytes = bytesPerSample(format);
+    const bool sane = std::memcmp(h.magic, kMagic, sizeof(kMagic)) == 0 &&
+                      h.sampleFormat <= static_cast<uint32_t>(ClipSampleFormat::Float16) &&
+                      h.sampleRate > 0 && (h.channels == 1 || h.channels == 2) &&
+                      h.frames > 0 && h.frames <= static_cast<uint64_t>(INT32_MAX) &&
+                      h.dataOffset % kPageAlign == 0 && h.channelStride >= h.frames * sampleBytes &&
+                      h.dataOffset + h.channelStride * (h.channels - 1U) + h.frames * sampleBytes <= mapSize;
+    if (!sane) {
+        // Недописанная или чужая запись: убираем, следующий store() положит новую.
+        std::error_code ec;
+        fs::remove(entry, ec);
+        ++misses_;
+        return false;
+    }
+
+    const auto* bytes = static_cast<const uint8_t*>(base);
+    SharedClipBuffer b{};
+    b.sampleRate = static_cast<int>(h.sampleRate);
+    b.channels = static_cast<int>(h.channels);
+    b.frames = static_cast<int>(h.frames);
+    b.format = format;
+    for (uint32_t c = 0; c < h.channels; ++c) {
+        const uint8_t* data = bytes + h.dataOffset + h.channelStride * c;
+        if (format == ClipSampleFormat::Float32) {
+            (c == 0 ? b.ch0 : b.ch1) = std::shared_ptr<const float[]>(mapping, reinterpret_cast<const float*>(data));
+        } else {
+            (c == 0 ? b.ch0Packed : b.ch1Packed) =
+                std::shared_ptr<const int16_t[]>(mapping, reinterpret_cast<const int16_t*>(data));
+        }
+    }
+    if (!b.valid()) {
+        ++misses_;
+        return false;
+    }
+    // mtime записи — отметка последнего использования для вытеснения.
+    std::error_code ec;
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+    out = std::move(b);
+    ++hits_;
+    return true;
+}
+
+bool ClipDecodeCache::store(const std::string& path, const SharedClipBuffer& decoded) {
+    if (!decoded.valid() || decoded.stream) {
+        return false;
+    }
+    std::string key;
+    if (!keyFor_(path, key)) {
+        return false;
+    }
+    const uint64_t frames = static_cast<uint64_t>(decoded.frames);
+    const uint64_t dataBytes = frames * bytesPerSample(decoded.format);
+    const uint64_t stride = alignUp(dataBytes);
+    const uint64_t total = kPageAlign + stride * static_cast<uint64_t>(decoded.channels);
+    if (maxBytes_ > 0 && total > maxBytes_) {
+        return false;
+    }
+
+    const std::string entry = entryPath_(key);
+    // Пишем во временный файл и переименовываем: читатель не увидит половину записи.
+    // Имя уникально и между процессами, и между нитями загрузки одного процесса.
+    static std::atomic<uint64_t> tmpSeq{0};
+    const std::string tmp = entry + ".tmp" + std::to_string(static_cast<long long>(::getpid())) + "-" +
+                            std::to_string(tmpSeq.fetch_add(1, std::memory_order_relaxed));
+    bool ok = false;
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (f.is_open()) {
+            EntryHeader h{};
+            std::memcpy(h.magic, kMagic, sizeof(kMagic));
+            h.sampleRate = static_cast<uint32_t>(decoded.sampleRate);
+            h.channels = static_cast<uint32_t>(decoded.channels);
+            h.frames = frames;
+            h.dataOffset = kPageAlign;
+            h.channelStride = stride;
+            h.sampleFormat = static_cast<uint32_t>(decoded.format);
+            const std::vector<char> pad(static_cast<std::size_t>(kPageAlign), 0);
+            f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            f.write(pad.data(), static_cast<std::streamsize>(kPageAlign - sizeof(h)));
+            const bool packed = decoded.format != ClipSampleFormat::Float32;
+            const void* ch[2] = {packed ? static_cast<const void*>(decoded.ch0Packed.get()) : decoded.ch0.get(),
+                                 packed ? static_cast<const void*>(decoded.ch1Packed.get()) : decoded.ch1.get()};
+            for (int c = 0; c < decoded.channels; ++c) {
+                f.write(static_cast<const char*>(ch[c]), static_cast<std::streamsize>(dataBytes));
+                f.write(pad.data(), static_cast<std::streamsize>(stride - dataBytes));
+            }
+            ok = f.good();
+        }
+    }
+    std::error_code ec;
+    if (ok) {
+        fs::rename(tmp, entry, ec);
+        ok = !ec;
+    }
+    if (!ok) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    evict_(entry);
+    return true;
+}
+
+uint64_t ClipDecodeCache::diskBytes() const {
+    uint64_t total = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+        if (isEntry(it->path())) {
+            const uint64_t size = it->file_size(ec);
+            total += ec ? 0 : size;
+            ec.clear();
+        }
+    }
+    return total;
+}
+
+void ClipDecodeCache::evict_(const std::string& keep) {
+    if (maxBytes_ == 0) {
+        return;
+    }
+    struct Item {
+        fs::path path;
+        fs::file_time_type used;
+        uint64_t bytes;
+    };
+    std::vector<Item> items;
+    uint64_t total = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!isEntry(it->path())) {
+            continue;
+        }
+        std::error_code itemEc;
+        Item item{it->path(), it->last_write_time(itemEc), it->file_size(itemEc)};
+        if (itemEc) {
+            continue;
+        }
+        total += item.bytes;
+        items.push_back(std::move(item));
+    }
+    if (total <= maxBytes_) {
+        return;
+    }
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.used < b.used; });
+    for (const Item& item : items) {
+        if (total <= maxBytes_) {
+            break;
+        }
+        if (item.path == fs::path(keep)) {
+            continue;
+        }
+        // Уже отображенные страницы переживают unlink: играющие клипы не пострадают.
+        if (fs::remove(item.path, ec)) {
+            total -= item.bytes;
+        }
+    }
+}
+
+} // namespace avantgarde
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "contracts/types.h"
+
+namespace avantgarde {
+
+// Кэш декодированных клипов на диске: planar в формате хранения клипа (float32,
+// int16 или half — см. ClipSampleFormat), каналы выровнены по страницам,
+// запись отображается mmap-ом прямо в SharedClipBuffer — без разбора WAV и копий,
+// а повторные загрузки одного клипа делят страницы через page cache ОС.
+// Страницы подгружаются и закрепляются (mlock) в load(), чтобы RT не ловил page fault;
+// без права на mlock запись копируется в анонимную память.
+//
+// Ключ — отпечаток содержимого источника (размер + хэш начала и конца файла) и его mtime:
+// перезаписанный сэмпл дает промах, а не устаревший звук.
+// Каталог ограничен maxBytes: после store() давно не использованные записи удаляются
+// (уже отображенные буферы остаются валидны до последнего владельца).
+// Только вне RT; load()/store() можно звать из нескольких нитей загрузки.
+class ClipDecodeCache {
+public:
+    ClipDecodeCache(std::string directory, uint64_t maxBytes);
+
+    ClipDecodeCache(const ClipDecodeCache&) = delete;
+    ClipDecodeCache& operator=(const ClipDecodeCache&) = delete;
+
+    // Отобразить декодированную копию path. false — промах (или битая запись).
+    bool load(const std::string& path, SharedClipBuffer& out);
+    // Сохранить клип, целиком лежащий в памяти, и ужать каталог до maxBytes.
+    bool store(const std::string& path, const SharedClipBuffer& decoded);
+
+    const std::string& directory() const noexcept { return directory_; }
+    uint64_t maxBytes() const noexcept { return maxBytes_; }
+    uint64_t hits() const noexcept { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const noexcept { return misses_.load(std::memory_order_relaxed); }
+    // Суммарный размер записей в каталоге.
+    uint64_t diskBytes() const;
+
+private:
+    // Имя записи: <хэш содержимого>-<mtime>.
+    bool keyFor_(const std::string& path, std::string& keyOut) const;
+    std::string entryPath_(const std::string& key) const;
+    void evict_(const std::string& keep);
+
+    std::string directory_{};
+    uint64_t maxBytes_{0};
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+};
+
+} // namespace avantgarde
@@ -0,0 +1,117 @@
+#include "service/audio/ClipLoader.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace avantgarde {
+
+ClipLoader::ClipLoader(unsigned workers) : workerCount_(std::max(1u, workers)) {}
+
+ClipLoader::~ClipLoader() {
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+        queue_.clear();
+        // Декодируемые сейчас задания тоже бросаем: их результат некому забрать.
+        for (auto& running : decoding_) {
+            running.second->store(true, std::memory_order_relaxed);
+        }
+    }
+    cv_.notify_all();
+    for (auto& w : workers_) {
+        if (w.joinable()) {
+            w.join();
+        }
+    }
+}
+
+uint64_t ClipLoader::submit(std::string path, Job job) {
+    uint64_t ticket = 0;
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        ticket = nextTicket_++;
+        queue_.push_back(Task{ticket, std::move(path), std::move(job), std::make_shared<std::atomic<bool>>(false)});
+        states_[ticket] = ClipLoadState::Queued;
+        if (workers_.empty()) {
+            for (unsigned i = 0; i < workerCount_; ++i) {
+                workers_.emplace_back([this]() { workerLoop_(); });
+            }
+        }
+    }
+    cv_.notify_one();
+    return ticket;
+}
+
+bool ClipLoader::cancel(uint64_t ticket) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = states_.find(ticket);
+    if (it == states_.end()) {
+        return false;
+    }
+    if (it->second == ClipLoadState::Queued) {
+        queue_.erase(std::find_if(queue_.begin(), queue_.end(), [ticket](const Task& t) { return t.ticket == ticket; }));
+    } else if (it->second == ClipLoadState::Done || it->second == ClipLoadState::Failed) {
+        done_.erase(std::find_if(done_.begin(), done_.end(),
+                                 [ticket](const ClipLoadCompletion& c) { return c.ticket == ticket; }));
+    } else if (const auto running = decoding_.find(ticket); running != decoding_.end()) {
+        // Decoding: задание прервется на ближайшей проверке флага,
+        // а нить увидит пропавший билет и выбросит результат.
+        running->second->store(true, std::memory_order_relaxed);
+    }
+    states_.erase(it);
+    return true;
+}
+
+ClipLoadState ClipLoader::state(uint64_t ticket) const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = states_.find(ticket);
+    return (it != states_.end()) ? it->second : ClipLoadState::None;
+}
+
+bool ClipLoader::poll(ClipLoadCompletion& out) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (done_.empty()) {
+        return false;
+    }
+    out = std::move(done_.front());
+    done_.pop_front();
+    states_.erase(out.ticket);
+    return true;
+}
+
+std::size_t ClipLoader::inFlight() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return states_.size() - done_.size();
+}
+
+void ClipLoader::workerLoop_() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this]() { return quit_ || !queue_.empty(); });
+        if (quit_) {
+            return;
+        }
+        Task task = std::move(queue_.front());
+        queue_.pop_front();
+        states_[task.ticket] = ClipLoadState::Decoding;
+        decoding_[task.ticket] = task.cancelled;
+        lock.unlock();
+
+        ClipLoadCompletion c{};
+        c.ticket = task.ticket;
+        c.ok = task.job && task.job(task.path, c.result, *task.cancelled);
+        c.path = std::move(task.path);
+
+        lock.lock();
+        decoding_.erase(c.ticket);
+        const auto it = states_.find(c.ticket);
+        if (it == states_.end()) {
+            // Отменен, пока декодировался.
+            continue;
+        }
+        it->second = c.ok ? ClipLoadState::Done : ClipLoadState::Failed;
+        done_.push_back(std::move(c));
+    }
+}
+
+} // namespace avantgarde
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "contracts/types.h"
+
+namespace avantgarde {
+
+// Состояние задания загрузки (см. ClipLoader::state()).
+enum class ClipLoadState : uint8_t {
+    None = 0, // неизвестный билет: отменен или результат уже забран poll()
+    Queued,   // ждет свободную рабочую нить
+    Decoding, // в работе
+    Done,     // готово, ждет poll()
+    Failed    // ошибка, ждет poll()
+};
+
+// Что рабочая нить возвращает control-потоку.
+struct ClipLoadResult {
+    SharedClipBuffer buffer{};
+    float sourceBpm{0.0f}; // 0 — не определялся
+    std::string error{};
+};
+
+struct ClipLoadCompletion {
+    uint64_t ticket{0};
+    std::string path{};
+    bool ok{false};
+    ClipLoadResult result{};
+};
+
+// Пул рабочих нитей декодирования сэмплов: control-поток ставит задания (submit),
+// нити параллельно декодируют файлы, готовые результаты control-поток забирает
+// через poll() в своем цикле — пул клипов и треки трогает только он.
+//
+// Отмена (пользователь пролистал файл): задание в очереди снимается сразу,
+// уже декодируемому взводится флаг cancelled — задание бросает работу на
+// ближайшей проверке, а результат в любом случае выбрасывается без completion.
+class ClipLoader {
+public:
+    // Работа задания в рабочей нити. false — ошибка (текст в result.error).
+    // cancelled взводится из cancel(): долгим заданиям стоит его опрашивать.
+    using Job = std::function<bool(const std::string& path, ClipLoadResult& result, const std::atomic<bool>& cancelled)>;
+
+    explicit ClipLoader(unsigned workers);
+    ~ClipLoader();
+
+    ClipLoader(const ClipLoader&) = delete;
+    ClipLoader& operator=(const ClipLoader&) = delete;
+
+    // Поставить задание; билет > 0. Нити стартуют с первым заданием.
+    uint64_t submit(std::string path, Job job);
+    // true, если задание еще не завершилось и теперь не даст completion.
+    bool cancel(uint64_t ticket);
+    ClipLoadState state(uint64_t ticket) const;
+    // Забрать один готовый результат (control-поток).
+    bool poll(ClipLoadCompletion& out);
+    // Заданий в очереди и в работе.
+    std::size_t inFlight() const;
+
+private:
+    struct Task {
+        uint64_t ticket{0};
+        std::string path{};
+        Job job{};
+        std::shared_ptr<std::atomic<bool>> cancelled{};
+    };
+
+    void workerLoop_();
+
+    const unsigned workerCount_;
+    mutable std::mutex mutex_{};
+    std::condition_variable cv_{};
+    std::deque<Task> queue_{};
+    std::deque<ClipLoadCompletion> done_{};
+    std::unordered_map<uint64_t, ClipLoadState> states_{};
+    // Флаги отмены заданий в состоянии Decoding.
+    std::unordered_map<uint64_t, std::shared_ptr<std::atomic<bool>>> decoding_{};
+    std::vector<std::thread> workers_{};
+    uint64_t nextTicket_{1};
+    bool quit_{false};
+};
+
+} // namespace avantgarde
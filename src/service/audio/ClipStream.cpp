@@ -0,0 +1,367 @@
+#include "service/audio/ClipStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+namespace avantgarde {
+namespace {
+
+// Соседи cubic-интерполятора по обе стороны от курсора.
+constexpr int64_t kGuardFrames = 4;
+// Без работы I/O-нить заглядывает к читателям хотя бы так часто.
+constexpr auto kIdleWait = std::chrono::milliseconds(2);
+
+void copyWrapped(const std::vector<float>& ring, int64_t frame, uint32_t count, float* dst) noexcept {
+    const std::size_t size = ring.size();
+    const std::size_t pos = static_cast<std::size_t>(frame) % size;
+    const std::size_t first = std::min<std::size_t>(count, size - pos);
+    std::memcpy(dst, ring.data() + pos, first * sizeof(float));
+    if (first < count) {
+        std::memcpy(dst + first, ring.data(), (count - first) * sizeof(float));
+    }
+}
+
+} // namespace
+
+std::shared_ptr<ClipStream> ClipStream::open(const std::string& path,
+                                             double headSeconds,
+                                             SharedClipBuffer& out,
+                                             std::string* errorOut) {
+    out = SharedClipBuffer{};
+    std::shared_ptr<ClipStream> s{new ClipStream()};
+    if (!s->file_.open(path, errorOut)) {
+        return nullptr;
+    }
+    if (s->file_.frames() > INT_MAX) {
+        if (errorOut) *errorOut = "clip too long";
+        return nullptr;
+    }
+    s->channels_ = s->file_.channels();
+    s->frames_ = s->file_.frames();
+    const double wanted = std::max(0.0, headSeconds) * static_cast<double>(s->file_.sampleRate());
+    s->headFrames_ = std::clamp<int64_t>(static_cast<int64_t>(std::llround(wanted)), 1, s->frames_);
+
+    const std::size_t head = static_cast<std::size_t>(s->headFrames_);
+    std::unique_ptr<float[]> h0{new (std::nothrow) float[head]};
+    std::unique_ptr<float[]> h1{(s->channels_ == 2) ? new (std::nothrow) float[head] : nullptr};
+    if (!h0 || (s->channels_ == 2 && !h1)) {
+        if (errorOut) *errorOut = "alloc head failed";
+        return nullptr;
+    }
+    if (!s->file_.read(0, static_cast<uint32_t>(head), h0.get(), h1.get())) {
+        if (errorOut) *errorOut = "cannot read audio data";
+        return nullptr;
+    }
+    s->head_[0] = std::shared_ptr<const float[]>(h0.release(), std::default_delete<float[]>());
+    s->head_[1] = (s->channels_ == 2)
+                  ? std::shared_ptr<const float[]>(h1.release(), std::default_delete<float[]>())
+                  : s->head_[0];
+    s->readers_ = std::make_unique<Reader[]>(kMaxReaders);
+
+    out.sampleRate = s->file_.sampleRate();
+    out.channels = s->channels_;
+    out.frames = static_cast<int>(s->frames_);
+    out.ch0 = s->head_[0];
+    out.ch1 = (s->channels_ == 2) ? s->head_[1] : std::shared_ptr<const float[]>{};
+    out.stream = s;
+    out.streamHeadFrames = static_cast<int>(s->headFrames_);
+    return s;
+}
+
+int ClipStream::openReaders(uint32_t count) {
+    if (count == 0 || count > kMaxReaders) {
+        return -1;
+    }
+    const std::lock_guard<std::mutex> lock(readersMutex_);
+    uint32_t run = 0;
+    for (uint32_t i = 0; i < kMaxReaders; ++i) {
+        run = readers_[i].open.load(std::memory_order_relaxed) ? 0 : run + 1;
+        if (run < count) {
+            continue;
+        }
+        const uint32_t first = i + 1 - count;
+        for (uint32_t k = first; k <= i; ++k) {
+            Reader& r = readers_[k];
+            // Кольца прошлого владельца — те же кадры того же файла: оставляем.
+            r.used.store(false, std::memory_order_relaxed);
+            r.cursor.store(0, std::memory_order_relaxed);
+            r.regionStart.store(0, std::memory_order_relaxed);
+            r.regionEnd.store(-1, std::memory_order_relaxed);
+            r.loop.store(false, std::memory_order_relaxed);
+            r.open.store(true, std::memory_order_release);
+        }
+        return static_cast<int>(first);
+    }
+    return -1;
+}
+
+void ClipStream::closeReaders(int first, uint32_t count) noexcept {
+    if (first < 0) {
+        return;
+    }
+    const std::lock_guard<std::mutex> lock(readersMutex_);
+    const uint32_t end = std::min<uint32_t>(kMaxReaders, static_cast<uint32_t>(first) + count);
+    for (uint32_t k = static_cast<uint32_t>(first); k < end; ++k) {
+        readers_[k].open.store(false, std::memory_order_release);
+    }
+}
+
+void ClipStream::setRegionRt(int reader, int64_t regionStart, int64_t regionEnd, bool loop) noexcept {
+    if (reader < 0 || reader >= static_cast<int>(kMaxReaders)) {
+        return;
+    }
+    Reader& r = readers_[reader];
+    r.regionStart.store(regionStart, std::memory_order_relaxed);
+    r.regionEnd.store(regionEnd, std::memory_order_relaxed);
+    r.loop.store(loop, std::memory_order_relaxed);
+}
+
+bool ClipStream::readRt(int reader, int64_t frame, uint32_t count, float* dst0, float* dst1) noexcept {
+    if (reader < 0 || reader >= static_cast<int>(kMaxReaders)) {
+        if (dst0) std::fill_n(dst0, count, 0.0f);
+        if (dst1) std::fill_n(dst1, count, 0.0f);
+        return false;
+    }
+    Reader& r = readers_[reader];
+    r.cursor.store(frame, std::memory_order_relaxed);
+    r.used.store(true, std::memory_order_relaxed);
+
+    uint32_t done = 0;
+    while (done < count) {
+        const int64_t f = frame + done;
+        const uint32_t left = count - done;
+        float* d0 = dst0 + done;
+        float* d1 = dst1 ? dst1 + done : nullptr;
+        uint32_t n = 0;
+        if (f >= 0 && f < headFrames_) {
+            n = static_cast<uint32_t>(std::min<int64_t>(left, headFrames_ - f));
+            std::memcpy(d0, head_[0].get() + f, n * sizeof(float));
+            if (d1) std::memcpy(d1, head_[1].get() + f, n * sizeof(float));
+        } else if (r.ready.load(std::memory_order_acquire)) {
+            n = copyLead_(r, f, left, d0, d1);
+            if (n == 0) n = copyRing_(r, f, left, d0, d1);
+        }
+        if (n == 0) {
+            break;
+        }
+        done += n;
+    }
+    if (done < count) {
+        std::fill_n(dst0 + done, count - done, 0.0f);
+        if (dst1) std::fill_n(dst1 + done, count - done, 0.0f);
+        underruns_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+uint32_t ClipStream::copyRing_(Reader& r, int64_t frame, uint32_t count, float* dst0, float* dst1) const noexcept {
+    const uint32_t seq = r.ringSeq.load(std::memory_order_acquire);
+    if (seq & 1u) {
+        return 0;
+    }
+    const int64_t base = r.ringBase.load(std::memory_order_acquire);
+    const int64_t end = r.ringEnd.load(std::memory_order_acquire);
+    if (frame < base || frame >= end) {
+        return 0;
+    }
+    const uint32_t n = static_cast<uint32_t>(std::min<int64_t>(count, end - frame));
+    copyWrapped(r.ring[0], frame, n, dst0);
+    if (dst1) copyWrapped(r.ring[(channels_ == 2) ? 1 : 0], frame, n, dst1);
+    // Кадры годны, если за время копии ring не переехал и I/O не начал их перезапись.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (r.ringSeq.load(std::memory_order_relaxed) != seq || r.ringBase.load(std::memory_order_relaxed) > frame) {
+        return 0;
+    }
+    return n;
+}
+
+uint32_t ClipStream::copyLead_(Reader& r, int64_t frame, uint32_t count, float* dst0, float* dst1) const noexcept {
+    const uint32_t seq = r.leadSeq.load(std::memory_order_acquire);
+    if (seq & 1u) {
+        return 0;
+    }
+    const int64_t start = r.leadStart.load(std::memory_order_relaxed);
+    const int64_t end = r.leadEnd.load(std::memory_order_relaxed);
+    if (frame < start || frame >= end) {
+        return 0;
+    }
+    const uint32_t n = static_cast<uint32_t>(std::min<int64_t>(count, end - frame));
+    const std::size_t at = static_cast<std::size_t>(frame - start);
+    std::memcpy(dst0, r.lead[0].data() + at, n * sizeof(float));
+    if (dst1) std::memcpy(dst1, r.lead[(channels_ == 2) ? 1 : 0].data() + at, n * sizeof(float));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (r.leadSeq.load(std::memory_order_relaxed) != seq) {
+        return 0;
+    }
+    return n;
+}
+
+bool ClipStream::serviceIo() {
+    if (!readers_) {
+        return false;
+    }
+    bool progressed = false;
+    for (uint32_t i = 0; i < kMaxReaders; ++i) {
+        Reader& r = readers_[i];
+        if (!r.open.load(std::memory_order_acquire) || !r.used.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        if (!r.ready.load(std::memory_order_relaxed)) {
+            for (int ch = 0; ch < channels_; ++ch) {
+                r.ring[ch].assign(kRingFrames, 0.0f);
+                r.lead[ch].assign(kLeadFrames, 0.0f);
+            }
+            r.ready.store(true, std::memory_order_release);
+            progressed = true;
+        }
+        progressed = serviceLead_(r) || progressed;
+        progressed = serviceRing_(r) || progressed;
+    }
+    return progressed;
+}
+
+bool ClipStream::serviceLead_(Reader& r) {
+    const int64_t regionStart = r.regionStart.load(std::memory_order_relaxed);
+    // Начало региона в голове (с соседями интерполятора) — lead не нужен.
+    if (regionStart + kGuardFrames <= headFrames_) {
+        return false;
+    }
+    const int64_t want = std::clamp<int64_t>(regionStart - kGuardFrames, 0, frames_ - 1);
+    // leadStart/leadEnd пишет только эта нить.
+    if (r.leadStart.load(std::memory_order_relaxed) == want && r.leadEnd.load(std::memory_order_relaxed) > want) {
+        return false;
+    }
+    const uint32_t n = static_cast<uint32_t>(std::min<int64_t>(kLeadFrames, frames_ - want));
+    const uint32_t seq = r.leadSeq.load(std::memory_order_relaxed);
+    r.leadSeq.store(seq + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const bool ok = file_.read(want, n, r.lead[0].data(), (channels_ == 2) ? r.lead[1].data() : nullptr);
+    r.leadStart.store(want, std::memory_order_relaxed);
+    r.leadEnd.store(ok ? want + n : want, std::memory_order_relaxed);
+    r.leadSeq.store(seq + 2u, std::memory_order_release);
+    return ok;
+}
+
+bool ClipStream::serviceRing_(Reader& r) {
+    const int64_t cursor = std::max<int64_t>(0, r.cursor.load(std::memory_order_relaxed));
+    const int64_t regionEnd = r.regionEnd.load(std::memory_order_relaxed);
+    const bool loop = r.loop.load(std::memory_order_relaxed);
+
+    // Первый кадр, который RT возьмет из ring: голова и lead отдают свое сами.
+    int64_t need = cursor;
+    if (need < headFrames_) {
+        need = headFrames_;
+    } else {
+        const int64_t leadStart = r.leadStart.load(std::memory_order_relaxed);
+        const int64_t leadEnd = r.leadEnd.load(std::memory_order_relaxed);
+        if (need >= leadStart && need < leadEnd) {
+            need = leadEnd;
+        }
+    }
+    // Луп дальше своего конца не читает: после wrap курсор вернется в голову/lead.
+    const int64_t limit = (loop && regionEnd > 0) ? std::min(frames_, regionEnd + kGuardFrames) : frames_;
+    if (need >= limit) {
+        return false;
+    }
+
+    int64_t base = r.ringBase.load(std::memory_order_relaxed);
+    int64_t end = r.ringEnd.load(std::memory_order_relaxed);
+    if (need < base || need > end) {
+        // Курсор ушел из окна (seek, retrigger, wrap): ring переезжает целиком.
+        const uint32_t seq = r.ringSeq.load(std::memory_order_relaxed);
+        r.ringSeq.store(seq + 1u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        r.ringBase.store(need, std::memory_order_relaxed);
+        r.ringEnd.store(need, std::memory_order_relaxed);
+        r.ringSeq.store(seq + 2u, std::memory_order_release);
+        base = need;
+        end = need;
+    }
+
+    // Все, что ниже курсора (с запасом на соседей), RT уже не прочитает.
+    const int64_t keepFrom = std::max(base, std::min(cursor, need) - kGuardFrames);
+    const int64_t room = static_cast<int64_t>(kRingFrames) - (end - keepFrom);
+    const int64_t n = std::min({room, static_cast<int64_t>(kIoChunkFrames), limit - end});
+    if (n <= 0) {
+        return false;
+    }
+    if (end + n - static_cast<int64_t>(kRingFrames) > base) {
+        // Сначала объявляем перезаписываемые кадры недоступными, потом пишем.
+        r.ringBase.store(end + n - static_cast<int64_t>(kRingFrames), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    int64_t written = 0;
+    while (written < n) {
+        const std::size_t pos = static_cast<std::size_t>((end + written) % kRingFrames);
+        const uint32_t part = static_cast<uint32_t>(std::min<int64_t>(n - written, kRingFrames - pos));
+        float* d1 = (channels_ == 2) ? r.ring[1].data() + pos : nullptr;
+        if (!file_.read(end + written, part, r.ring[0].data() + pos, d1)) {
+            break;
+        }
+        written += part;
+    }
+    if (written > 0) {
+        r.ringEnd.store(end + written, std::memory_order_release);
+    }
+    return written > 0;
+}
+
+ClipStreamPrefetcher::~ClipStreamPrefetcher() {
+    stop();
+}
+
+void ClipStreamPrefetcher::add(const std::shared_ptr<ClipStream>& stream) {
+    if (!stream) {
+        return;
+    }
+    const std::lock_guard<std::mutex> lock(mutex_);
+    streams_.push_back(stream);
+    if (!thread_.joinable()) {
+        quit_ = false;
+        thread_ = std::thread([this]() { loop_(); });
+    }
+}
+
+void ClipStreamPrefetcher::stop() noexcept {
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ClipStreamPrefetcher::loop_() {
+    std::vector<std::shared_ptr<ClipStream>> live{};
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!quit_) {
+        streams_.erase(std::remove_if(streams_.begin(),
+                                      streams_.end(),
+                                      [](const std::weak_ptr<ClipStream>& w) { return w.expired(); }),
+                       streams_.end());
+        for (const auto& w : streams_) {
+            if (auto s = w.lock()) {
+                live.push_back(std::move(s));
+            }
+        }
+        lock.unlock();
+        bool progressed = false;
+        for (const auto& s : live) {
+            progressed = s->serviceIo() || progressed;
+        }
+        live.clear();
+        lock.lock();
+        if (!progressed) {
+            cv_.wait_for(lock, kIdleWait, [this]() { return quit_; });
+        }
+    }
+}
+
+} // namespace avantgarde
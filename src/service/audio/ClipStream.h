@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "contracts/IClipStream.h"
+#include "contracts/WavDecoder.h"
+#include "contracts/types.h"
+
+namespace avantgarde {
+
+// Длинный WAV, который не декодируется целиком: голова в памяти, остальное
+// ClipStreamPrefetcher подкачивает по кускам в кольца читателей.
+//
+// Читатель держит два окна:
+// - ring — непрерывный отрезок файла впереди курсора (SPSC: I/O пишет в конец,
+//   RT читает; перед перезаписью старых кадров I/O сдвигает ringBase);
+// - lead — начало региона читателя, если оно за пределами головы: wrap лупа
+//   и retrigger попадают в готовые кадры, пока ring переезжает на новое место.
+// Переезд ring и перезаливка lead идут под seqlock: RT копирует кадры и проверяет,
+// что окно за это время не сменилось, иначе считает их недоступными.
+//
+// Память не зависит от длины клипа: голова + (ring + lead) на каждого читателя,
+// которого RT хоть раз использовал (буферы выделяет I/O-нить по первому обращению).
+class ClipStream final : public IClipStream {
+public:
+    static constexpr uint32_t kRingFrames = 32768;
+    static constexpr uint32_t kLeadFrames = 16384;
+    // Кадров, которые I/O-нить читает за один заход к читателю.
+    static constexpr uint32_t kIoChunkFrames = 8192;
+
+    // Вне RT: открыть файл и прочитать голову (headSeconds). out — готовый дескриптор
+    // клипа: frames — полная длина, ch0/ch1 — голова, stream — этот поток.
+    static std::shared_ptr<ClipStream> open(const std::string& path,
+                                            double headSeconds,
+                                            SharedClipBuffer& out,
+                                            std::string* errorOut = nullptr);
+
+    int openReaders(uint32_t count) override;
+    void closeReaders(int first, uint32_t count) noexcept override;
+    void setRegionRt(int reader, int64_t regionStart, int64_t regionEnd, bool loop) noexcept override;
+    bool readRt(int reader, int64_t frame, uint32_t count, float* dst0, float* dst1) noexcept override;
+    uint64_t underruns() const noexcept override { return underruns_.load(std::memory_order_relaxed); }
+
+    // I/O-нить: по куску каждому используемому читателю. true — что-то прочитано.
+    bool serviceIo();
+
+    int64_t frames() const noexcept { return frames_; }
+    int64_t headFrames() const noexcept { return headFrames_; }
+
+private:
+    struct Reader {
+        std::atomic<bool> open{false};
+        // RT -> I/O.
+        std::atomic<bool> used{false};
+        std::atomic<int64_t> cursor{0};
+        std::atomic<int64_t> regionStart{0};
+        std::atomic<int64_t> regionEnd{-1};
+        std::atomic<bool> loop{false};
+
+        // I/O -> RT: буферы выделены и больше не перевыделяются.
+        std::atomic<bool> ready{false};
+        std::vector<float> ring[2]{};
+        std::atomic<uint32_t> ringSeq{0};
+        std::atomic<int64_t> ringBase{0};
+        std::atomic<int64_t> ringEnd{0};
+        std::vector<float> lead[2]{};
+        std::atomic<uint32_t> leadSeq{0};
+        std::atomic<int64_t> leadStart{0};
+        std::atomic<int64_t> leadEnd{0};
+    };
+
+    ClipStream() = default;
+
+    uint32_t copyRing_(Reader& r, int64_t frame, uint32_t count, float* dst0, float* dst1) const noexcept;
+    uint32_t copyLead_(Reader& r, int64_t frame, uint32_t count, float* dst0, float* dst1) const noexcept;
+    bool serviceLead_(Reader& r);
+    bool serviceRing_(Reader& r);
+
+    WavDecoder file_{}; // после open() — только I/O-нить
+    int channels_{0};
+    int64_t frames_{0};
+    int64_t headFrames_{0};
+    std::shared_ptr<const float[]> head_[2]{};
+
+    std::unique_ptr<Reader[]> readers_{};
+    std::mutex readersMutex_{};
+    std::atomic<uint64_t> underruns_{0};
+};
+
+// Фоновая I/O-нить, обслуживающая все открытые потоки. Держит их по weak_ptr:
+// поток, который больше никому не нужен, просто выпадает из обхода.
+class ClipStreamPrefetcher {
+public:
+    ClipStreamPrefetcher() = default;
+    ~ClipStreamPrefetcher();
+
+    ClipStreamPrefetcher(const ClipStreamPrefetcher&) = delete;
+    ClipStreamPrefetcher& operator=(const ClipStreamPrefetcher&) = delete;
+
+    // Вне RT. Нить стартует с первым потоком.
+    void add(const std::shared_ptr<ClipStream>& stream);
+    void stop() noexcept;
+
+private:
+    void loop_();
+
+    std::mutex mutex_{};
+    std::condition_variable cv_{};
+    std::vector<std::weak_ptr<ClipStream>> streams_{};
+    std::thread thread_{};
+    bool quit_{false};
+};
+
+} // namespace avantgarde
@@ -0,0 +1,138 @@
+#include "service/audio/PolyphaseResampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace avantgarde {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kKaiserBeta = 8.6;
+// Срез относительно Найквиста: переходная полоса 64-тапового фильтра укладывается до Найквиста.
+constexpr double kCutoff = 0.92;
+// Потолок длины фильтра при сильном понижении частоты (192k -> 8k и ниже).
+constexpr int kMaxHalfTaps = 1024;
+
+// Модифицированная функция Бесселя I0 (ряд; для beta < 20 сходится за ~25 членов).
+double besselI0(double x) noexcept {
+    double sum = 1.0;
+    double term = 1.0;
+    const double q = 0.25 * x * x;
+    for (int k = 1; k < 64; ++k) {
+        term *= q / static_cast<double>(k * k);
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+float dot(const float* a, const float* b, int n) noexcept {
+    float s0 = 0.0f;
+    float s1 = 0.0f;
+    float s2 = 0.0f;
+    float s3 = 0.0f;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; ++i) {
+        s0 += a[i] * b[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+} // namespace
+
+PolyphaseResampler::PolyphaseResampler(int inRate, int outRate) {
+    if (inRate <= 0 || outRate <= 0) {
+        return;
+    }
+    const int g = std::gcd(inRate, outRate);
+    up_ = static_cast<uint32_t>(outRate / g);
+    down_ = static_cast<uint32_t>(inRate / g);
+
+    const double scale = std::min(1.0, static_cast<double>(up_) / static_cast<double>(down_));
+    halfTaps_ = std::min(kMaxHalfTaps, static_cast<int>(std::ceil(kHalfTaps / scale)));
+    taps_ = static_cast<uint32_t>(2 * halfTaps_);
+    exactPhases_ = up_ <= kMaxPhases;
+    phases_ = exactPhases_ ? up_ : kMaxPhases;
+
+    // fc — в циклах на входной сэмпл; при понижении частоты режем ниже нового Найквиста.
+    const double fc = 0.5 * scale * kCutoff;
+    const double i0Beta = besselI0(kKaiserBeta);
+    table_.assign(static_cast<std::size_t>(phases_ + 1u) * taps_, 0.0f);
+    std::vector<double> h(taps_);
+    for (uint32_t p = 0; p <= phases_; ++p) {
+        const double frac = static_cast<double>(p) / static_cast<double>(phases_);
+        double sum = 0.0;
+        for (uint32_t k = 0; k < taps_; ++k) {
+            // Расстояние от выходной точки до тапа: тап k — входной сэмпл idx - halfTaps + 1 + k.
+            const double d = frac + static_cast<double>(halfTaps_ - 1) - static_cast<double>(k);
+            const double x = 2.0 * fc * d;
+            const double sinc = (std::fabs(x) < 1e-12) ? 1.0 : std::sin(kPi * x) / (kPi * x);
+            const double r = d / static_cast<double>(halfTaps_);
+            const double window = (std::fabs(r) >= 1.0) ? 0.0 : besselI0(kKaiserBeta * std::sqrt(1.0 - r * r)) / i0Beta;
+            h[k] = sinc * window;
+            sum += h[k];
+        }
+        float* row = table_.data() + static_cast<std::size_t>(p) * taps_;
+        for (uint32_t k = 0; k < taps_; ++k) {
+            row[k] = static_cast<float>(h[k] / sum);
+        }
+    }
+}
+
+int64_t PolyphaseResampler::outputFrames(int64_t inFrames) const noexcept {
+    if (!valid() || inFrames <= 0) {
+        return 0;
+    }
+    return (inFrames * static_cast<int64_t>(up_) + static_cast<int64_t>(down_) - 1) / static_cast<int64_t>(down_);
+}
+
+void PolyphaseResampler::process(const float* in, int64_t inFrames, float* out) const noexcept {
+    const int64_t outFrames = outputFrames(inFrames);
+    const int taps = static_cast<int>(taps_);
+    const int64_t idxStep = static_cast<int64_t>(down_ / up_);
+    const uint32_t fracStep = down_ % up_;
+
+    int64_t idx = 0;   // входной сэмпл слева от выходной точки
+    uint32_t frac = 0; // дробная часть позиции, в 1/up_ сэмпла
+    for (int64_t n = 0; n < outFrames; ++n) {
+        const int64_t start = idx - halfTaps_ + 1;
+        // Края клипа: недостающие тапы — тишина.
+        const int64_t k0 = std::max<int64_t>(0, -start);
+        const int64_t k1 = std::min<int64_t>(taps, inFrames - start);
+        const int count = static_cast<int>(k1 - k0);
+        const float* x = (count > 0) ? in + start + k0 : in;
+
+        if (count <= 0) {
+            out[n] = 0.0f;
+        } else if (exactPhases_) {
+            out[n] = dot(row_(frac) + k0, x, count);
+        } else {
+            // Свертка линейна по коэффициентам: смешиваем результаты соседних фаз,
+            // а не строки таблицы — без временного буфера под промежуточную фазу.
+            const double pos = static_cast<double>(frac) * phases_ / static_cast<double>(up_);
+            const uint32_t p = static_cast<uint32_t>(pos);
+            const float w = static_cast<float>(pos - p);
+            const float ya = dot(row_(p) + k0, x, count);
+            const float yb = dot(row_(p + 1u) + k0, x, count);
+            out[n] = ya + w * (yb - ya);
+        }
+
+        idx += idxStep;
+        frac += fracStep;
+        if (frac >= up_) {
+            frac -= up_;
+            ++idx;
+        }
+    }
+}
+
+} // namespace avantgarde
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace avantgarde {
+
+// Полифазный windowed-sinc SRC целого буфера (вне RT: загрузка клипа в пул).
+//
+// Отношение частот сокращается до up/down (44100 -> 48000: 160/147); на каждую
+// фазу — свой набор kHalfTaps * 2 коэффициентов (окно Кайзера, beta 8.6, ~85 дБ),
+// нормированный на единичное усиление на DC. При понижении частоты срез
+// сдвигается вниз и фильтр удлиняется пропорционально.
+// Если фаз больше kMaxPhases (редкие отношения вроде 47999/48000), таблица
+// строится на kMaxPhases фаз, а промежуточные интерполируются линейно.
+class PolyphaseResampler {
+public:
+    static constexpr int kHalfTaps = 32;
+    static constexpr uint32_t kMaxPhases = 1024;
+
+    PolyphaseResampler(int inRate, int outRate);
+
+    bool valid() const noexcept { return up_ > 0u; }
+    uint32_t upFactor() const noexcept { return up_; }
+    uint32_t downFactor() const noexcept { return down_; }
+
+    // Кадров на выходе для inFrames на входе: ceil(inFrames * up / down).
+    int64_t outputFrames(int64_t inFrames) const noexcept;
+    // Один канал целиком: out — outputFrames(inFrames) элементов. За краями входа — тишина.
+    void process(const float* in, int64_t inFrames, float* out) const noexcept;
+
+private:
+    const float* row_(uint32_t phase) const noexcept { return table_.data() + static_cast<std::size_t>(phase) * taps_; }
+
+    uint32_t up_{0};
+    uint32_t down_{0};
+    uint32_t phases_{0};
+    uint32_t taps_{0};
+    int halfTaps_{0};
+    bool exactPhases_{true};
+    // (phases_ + 1) строк по taps_: последняя — фаза 1.0 для интерполяции.
+    std::vector<float> table_{};
+};
+
+} // namespace avantgarde
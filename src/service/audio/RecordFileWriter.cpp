@@ -0,0 +1,309 @@
+#include "service/audio/RecordFileWriter.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace avantgarde {
+namespace {
+
+constexpr uint16_t kWavFormatPcm = 1u;
+constexpr uint16_t kWavFormatIeeeFloat = 3u;
+constexpr uint32_t kFmtChunkBytes = 16u;
+constexpr uint32_t kFactChunkBytes = 4u;
+// ds64: размер RIFF, размер data, число кадров (по 8 байт) + длина пустой таблицы.
+constexpr uint32_t kDs64ChunkBytes = 28u;
+constexpr uint32_t kCuePointBytes = 24u;
+constexpr uint32_t kNoSize = 0xFFFFFFFFu;
+// Кадров на один проход encodeWavFrames(): запас буфера сверх kWriteBytes.
+constexpr std::size_t kEncodeFrames = 4096;
+
+void putU16(uint8_t* p, uint16_t v) noexcept {
+    p[0] = static_cast<uint8_t>(v & 0xFFu);
+    p[1] = static_cast<uint8_t>((v >> 8) & 0xFFu);
+}
+
+void putU32(uint8_t* p, uint32_t v) noexcept {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<uint8_t>((v >> (8 * i)) & 0xFFu);
+    }
+}
+
+void putU64(uint8_t* p, uint64_t v) noexcept {
+    for (int i = 0; i < 8; ++i) {
+        p[i] = static_cast<uint8_t>((v >> (8 * i)) & 0xFFu);
+    }
+}
+
+} // namespace
+
+RecordFileWriter::~RecordFileWriter() {
+    std::string ignored;
+    (void)close({}, ignored);
+}
+
+bool RecordFileWriter::open(const std::string& path,
+                            int sampleRate,
+                            int channels,
+                            WavSampleFormat format,
+                            bool forceRf64,
+                            std::string& errorOut) {
+    std::string ignored;
+    (void)close({}, ignored);
+    if (sampleRate <= 0 || channels <= 0 || channels > kMaxChannels) {
+        errorOut = "invalid record stream config";
+        return false;
+    }
+    if (!buffer_) {
+        bufferBytes_ = kWriteBytes + kEncodeFrames * kMaxChannels * sizeof(float);
+        buffer_.reset(static_cast<uint8_t*>(std::aligned_alloc(kBufferAlign, bufferBytes_)));
+        if (!buffer_) {
+            errorOut = "alloc record buffer failed";
+            return false;
+        }
+    }
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        errorOut = "cannot open for writing: " + path;
+        return false;
+    }
+    sampleRate_ = sampleRate;
+    channels_ = channels;
+    format_ = format;
+    forceRf64_ = forceRf64;
+    wroteRf64_ = false;
+    ioFailed_ = false;
+    preallocate_ = true;
+    framesWritten_ = 0;
+    fileOffset_ = 0;
+    reserved_ = 0;
+    // Заголовок-заглушка — начало первого куска; настоящий пишется в close().
+    fill_ = headerBytes_();
+    buildHeader_(buffer_.get(), 0u, fill_, false);
+    return true;
+}
+
+bool RecordFileWriter::append(const float* const* ch, std::size_t frames) noexcept {
+    if (fd_ < 0 || ioFailed_) {
+        return false;
+    }
+    const std::size_t frameBytes = static_cast<std::size_t>(channels_) * wavBytesPerSample(format_);
+    const float* cursor[kMaxChannels]{};
+    std::size_t done = 0;
+    while (done < frames) {
+        const std::size_t n = std::min(kEncodeFrames, frames - done);
+        for (int c = 0; c < channels_; ++c) {
+            cursor[c] = ch[c] ? ch[c] + done : nullptr;
+        }
+        encodeWavFrames(cursor, channels_, n, format_, buffer_.get() + fill_);
+        fill_ += n * frameBytes;
+        done += n;
+        framesWritten_ += n;
+        if (fill_ >= kWriteBytes && !flushFull_()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RecordFileWriter::close(const std::vector<RecordMarker>& markers, std::string& errorOut) {
+    if (fd_ < 0) {
+        return true;
+    }
+    bool ok = !ioFailed_;
+    const uint64_t dataBytes =
+        framesWritten_ * static_cast<uint64_t>(channels_) * wavBytesPerSample(format_);
+
+    // Хвост после data: байт выравнивания chunk-а и маркеры.
+    std::vector<uint8_t> tail{};
+    if (dataBytes & 1u) {
+        tail.push_back(0u);
+    }
+    std::vector<RecordMarker> cues{};
+    for (const RecordMarker& m : markers) {
+        // Позиция cue 32-битная: маркеры после ~24 ч записи на 48 кГц не выразить.
+        if (m.frame <= framesWritten_ && m.frame <= kNoSize) {
+            cues.push_back(m);
+        }
+    }
+    if (!cues.empty()) {
+        const std::size_t cueAt = tail.size();
+        tail.resize(cueAt + 12 + kCuePointBytes * cues.size());
+        uint8_t* p = tail.data() + cueAt;
+        std::memcpy(p, "cue ", 4);
+        putU32(p + 4, static_cast<uint32_t>(4 + kCuePointBytes * cues.size()));
+        putU32(p + 8, static_cast<uint32_t>(cues.size()));
+        p += 12;
+        for (std::size_t i = 0; i < cues.size(); ++i, p += kCuePointBytes) {
+            putU32(p, static_cast<uint32_t>(i + 1));
+            putU32(p + 4, static_cast<uint32_t>(cues[i].frame));
+            std::memcpy(p + 8, "data", 4);
+            putU32(p + 12, 0u);
+            putU32(p + 16, 0u);
+            putU32(p + 20, static_cast<uint32_t>(cues[i].frame));
+        }
+        // LIST/adtl: метка каждой точки — код маркера в десятичном виде.
+        std::vector<uint8_t> adtl{'a', 'd', 't', 'l'};
+        for (std::size_t i = 0; i < cues.size(); ++i) {
+            const std::string text = std::to_string(cues[i].code);
+            const uint32_t size = static_cast<uint32_t>(4 + text.size() + 1);
+            uint8_t h[12]{};
+            std::memcpy(h, "labl", 4);
+            putU32(h + 4, size);
+            putU32(h + 8, static_cast<uint32_t>(i + 1));
+            adtl.insert(adtl.end(), h, h + 12);
+            adtl.insert(adtl.end(), text.begin(), text.end());
+            adtl.push_back(0u);
+            if (size & 1u) {
+                adtl.push_back(0u);
+            }
+        }
+        uint8_t list[8]{};
+        std::memcpy(list, "LIST", 4);
+        putU32(list + 4, static_cast<uint32_t>(adtl.size()));
+        tail.insert(tail.end(), list, list + 8);
+        tail.insert(tail.end(), adtl.begin(), adtl.end());
+    }
+
+    if (ok && !tail.empty()) {
+        // Хвост влезает в запас буфера почти всегда; иначе — отдельной записью.
+        if (fill_ + tail.size() <= bufferBytes_) {
+            std::memcpy(buffer_.get() + fill_, tail.data(), tail.size());
+            fill_ += tail.size();
+            tail.clear();
+        }
+    }
+    if (ok && fill_ > 0) {
+        ok = writeAll_(buffer_.get(), fill_, fileOffset_);
+        fileOffset_ += fill_;
+        fill_ = 0;
+    }
+    if (ok && !tail.empty()) {
+        ok = writeAll_(tail.data(), tail.size(), fileOffset_);
+        fileOffset_ += tail.size();
+    }
+    const uint64_t fileBytes = fileOffset_;
+    if (ok) {
+        // Классический RIFF выражает до 4 GiB; дальше — RF64 (ds64 на месте JUNK).
+        wroteRf64_ = forceRf64_ || fileBytes - 8u > kNoSize;
+        uint8_t header[128]{};
+        const std::size_t hb = headerBytes_();
+        buildHeader_(header, dataBytes, fileBytes, wroteRf64_);
+        ok = writeAll_(header, hb, 0u);
+        if (!ok) {
+            errorOut = "record header finalize failed";
+        }
+    } else {
+        errorOut = "record data write failed";
+    }
+    // Резерв fallocate() за концом данных отрезается.
+    if (::ftruncate(fd_, static_cast<off_t>(fileBytes)) != 0 && ok) {
+        errorOut = "record truncate failed";
+        ok = false;
+    }
+    if (::fsync(fd_) != 0 && ok) {
+        errorOut = "record sync failed";
+        ok = false;
+    }
+    if (::close(fd_) != 0 && ok) {
+        errorOut = "record close failed";
+        ok = false;
+    }
+    fd_ = -1;
+    return ok;
+}
+
+std::size_t RecordFileWriter::headerBytes_() const noexcept {
+    const bool isFloat = (format_ == WavSampleFormat::Float32);
+    return 12 + (8 + kDs64ChunkBytes) + (8 + kFmtChunkBytes) + (isFloat ? 8 + kFactChunkBytes : 0u) + 8;
+}
+
+void RecordFileWriter::buildHeader_(uint8_t* dst, uint64_t dataBytes, uint64_t fileBytes, bool rf64) const noexcept {
+    const bool isFloat = (format_ == WavSampleFormat::Float32);
+    const uint32_t bps = wavBytesPerSample(format_);
+    const uint16_t blockAlign = static_cast<uint16_t>(static_cast<uint32_t>(channels_) * bps);
+    const uint64_t riffBytes = fileBytes - 8u;
+
+    uint8_t* p = dst;
+    std::memcpy(p, rf64 ? "RF64" : "RIFF", 4);
+    putU32(p + 4, rf64 ? kNoSize : static_cast<uint32_t>(riffBytes));
+    std::memcpy(p + 8, "WAVE", 4);
+    p += 12;
+    std::memcpy(p, rf64 ? "ds64" : "JUNK", 4);
+    putU32(p + 4, kDs64ChunkBytes);
+    std::memset(p + 8, 0, kDs64ChunkBytes);
+    if (rf64) {
+        putU64(p + 8, riffBytes);
+        putU64(p + 16, dataBytes);
+        putU64(p + 24, framesWritten_);
+    }
+    p += 8 + kDs64ChunkBytes;
+    std::memcpy(p, "fmt ", 4);
+    putU32(p + 4, kFmtChunkBytes);
+    putU16(p + 8, isFloat ? kWavFormatIeeeFloat : kWavFormatPcm);
+    putU16(p + 10, static_cast<uint16_t>(channels_));
+    putU32(p + 12, static_cast<uint32_t>(sampleRate_));
+    putU32(p + 16, static_cast<uint32_t>(sampleRate_) * blockAlign);
+    putU16(p + 20, blockAlign);
+    putU16(p + 22, static_cast<uint16_t>(bps * 8u));
+    p += 8 + kFmtChunkBytes;
+    if (isFloat) {
+        std::memcpy(p, "fact", 4);
+        putU32(p + 4, kFactChunkBytes);
+        putU32(p + 8, rf64 ? kNoSize : static_cast<uint32_t>(framesWritten_));
+        p += 8 + kFactChunkBytes;
+    }
+    std::memcpy(p, "data", 4);
+    putU32(p + 4, rf64 ? kNoSize : static_cast<uint32_t>(dataBytes));
+}
+
+bool RecordFileWriter::writeAll_(const uint8_t* data, std::size_t bytes, uint64_t offset) noexcept {
+    while (bytes > 0) {
+        const ssize_t n = ::pwrite(fd_, data, bytes, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ioFailed_ = true;
+            return false;
+        }
+        data += n;
+        bytes -= static_cast<std::size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+bool RecordFileWriter::flushFull_() noexcept {
+    while (fill_ >= kWriteBytes) {
+        reserve_(fileOffset_ + kWriteBytes);
+        if (!writeAll_(buffer_.get(), kWriteBytes, fileOffset_)) {
+            return false;
+        }
+        fileOffset_ += kWriteBytes;
+        fill_ -= kWriteBytes;
+        std::memmove(buffer_.get(), buffer_.get() + kWriteBytes, fill_);
+    }
+    return true;
+}
+
+void RecordFileWriter::reserve_(uint64_t end) noexcept {
+#if defined(__linux__)
+    if (!preallocate_ || end <= reserved_) {
+        return;
+    }
+    // Без эмуляции posix_fallocate(): если FS не умеет резерв, просто пишем дальше.
+    if (::fallocate(fd_, 0, static_cast<off_t>(reserved_), static_cast<off_t>(kPreallocStep)) == 0) {
+        reserved_ += kPreallocStep;
+    } else {
+        preallocate_ = false;
+    }
+#else
+    (void)end;
+#endif
+}
+
+} // namespace avantgarde
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "service/audio/WavFileWriter.h"
+
+namespace avantgarde {
+
+// Маркер записи: кадр файла и код события (IRtRecordSink::mark).
+struct RecordMarker {
+    uint64_t frame{0};
+    uint32_t code{0};
+};
+
+// Файл длинной записи с диска нити писателя (AudioRecorder, стемы).
+//
+// В отличие от WavFileWriter (offline-рендер) рассчитан на часы записи на SD-карту:
+// - данные копятся в выровненном буфере и уходят на диск кусками по kWriteBytes
+//   со смещений, кратных kWriteBytes (заголовок — начало первого куска);
+// - место под файл резервируется fallocate() шагами kPreallocStep (Linux): файл
+//   лежит непрерывно, а FS не ищет свободные блоки на каждой записи; в close()
+//   хвост резерва отрезается;
+// - заголовок фиксированной длины: chunk JUNK зарезервирован под ds64, поэтому
+//   запись длиннее 4 GiB финализируется как RF64 без сдвига данных;
+// - маркеры пишутся в cue + LIST/adtl/labl после data.
+// Только вне RT.
+class RecordFileWriter {
+public:
+    static constexpr std::size_t kWriteBytes = std::size_t{1} << 20;
+    static constexpr std::size_t kBufferAlign = 4096;
+    static constexpr uint64_t kPreallocStep = uint64_t{64} << 20;
+    static constexpr int kMaxChannels = 8;
+
+    RecordFileWriter() = default;
+    ~RecordFileWriter();
+
+    RecordFileWriter(const RecordFileWriter&) = delete;
+    RecordFileWriter& operator=(const RecordFileWriter&) = delete;
+
+    // forceRf64: RF64 независимо от длины (иначе — RIFF, RF64 только если не влезло в 4 GiB).
+    bool open(const std::string& path,
+              int sampleRate,
+              int channels,
+              WavSampleFormat format,
+              bool forceRf64,
+              std::string& errorOut);
+    // Дописать frames кадров planar float (ch[c] == nullptr — тишина).
+    bool append(const float* const* ch, std::size_t frames) noexcept;
+    // Дописать хвост, маркеры и заголовок, обрезать резерв и закрыть файл.
+    bool close(const std::vector<RecordMarker>& markers, std::string& errorOut);
+
+    bool isOpen() const noexcept { return fd_ >= 0; }
+    bool failed() const noexcept { return ioFailed_; }
+    uint64_t framesWritten() const noexcept { return framesWritten_; }
+    // После close(): финализирован ли файл как RF64.
+    bool wroteRf64() const noexcept { return wroteRf64_; }
+
+private:
+    struct FreeDeleter {
+        void operator()(uint8_t* p) const noexcept { std::free(p); }
+    };
+
+    std::size_t headerBytes_() const noexcept;
+    void buildHeader_(uint8_t* dst, uint64_t dataBytes, uint64_t fileBytes, bool rf64) const noexcept;
+    bool writeAll_(const uint8_t* data, std::size_t bytes, uint64_t offset) noexcept;
+    bool flushFull_() noexcept;
+    void reserve_(uint64_t end) noexcept;
+
+    int fd_{-1};
+    int sampleRate_{48000};
+    int channels_{2};
+    WavSampleFormat format_{WavSampleFormat::Pcm24};
+    bool forceRf64_{false};
+    bool wroteRf64_{false};
+    bool ioFailed_{false};
+    bool preallocate_{true};
+    uint64_t framesWritten_{0};
+    // Байт файла, уже отданных на диск (всегда кратно kWriteBytes до close()).
+    uint64_t fileOffset_{0};
+    uint64_t reserved_{0};
+    std::unique_ptr<uint8_t[], FreeDeleter> buffer_{};
+    std::size_t bufferBytes_{0};
+    std::size_t fill_{0};
+};
+
+} // namespace avantgarde
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace avantgarde {
+
+// SPSC-кольцо planar float кадров между RT-колбэком и нитью записи на диск.
+//
+// Память выделяется один раз в allocate() (вне RT) и дальше не трогается: RT
+// только копирует блок в кольцо, запись на диск идет целиком в нити писателя.
+// Емкость — степень двойки, позиции — 64-битные счетчики кадров (без wrap-а),
+// поэтому переполнение видно без отдельного флага.
+//
+// push() пишет блок целиком или не пишет вовсе: в файле нет полу-блоков, а
+// потерянный блок считает вызывающий (droppedBlocks).
+class RecordRing {
+public:
+    static constexpr int kMaxChannels = 8;
+
+    // Непрерывный отрезок кольца для чтения (до двух на wrap).
+    struct Span {
+        const float* ch[kMaxChannels]{};
+        std::size_t frames{0};
+    };
+
+    // Вне RT и без конкурентных push/consume. minFrames округляется вверх до степени двойки.
+    bool allocate(int channels, std::size_t minFrames) {
+        if (channels <= 0 || channels > kMaxChannels || minFrames == 0) {
+            return false;
+        }
+        std::size_t cap = 1;
+        while (cap < minFrames) {
+            cap <<= 1;
+        }
+        if (channels != channels_ || cap != capacity_) {
+            data_.reset(new (std::nothrow) float[cap * static_cast<std::size_t>(channels)]);
+            if (!data_) {
+                channels_ = 0;
+                capacity_ = 0;
+                return false;
+            }
+        }
+        channels_ = channels;
+        capacity_ = cap;
+        mask_ = cap - 1;
+        writePos_.store(0, std::memory_order_relaxed);
+        readPos_.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    int channels() const noexcept { return channels_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    // RT (producer). ch[c] для c < channels(); nullptr — тишина. false — места нет.
+    bool push(const float* const* ch, std::size_t frames) noexcept {
+        const uint64_t w = writePos_.load(std::memory_order_relaxed);
+        const uint64_t r = readPos_.load(std::memory_order_acquire);
+        if (frames == 0 || frames > capacity_ - static_cast<std::size_t>(w - r)) {
+            return frames == 0;
+        }
+        const std::size_t pos = static_cast<std::size_t>(w) & mask_;
+        const std::size_t first = std::min(frames, capacity_ - pos);
+        for (int c = 0; c < channels_; ++c) {
+            float* dst = data_.get() + static_cast<std::size_t>(c) * capacity_;
+            const float* src = ch[c];
+            if (src) {
+                std::memcpy(dst + pos, src, first * sizeof(float));
+                std::memcpy(dst, src + first, (frames - first) * sizeof(float));
+            } else {
+                std::memset(dst + pos, 0, first * sizeof(float));
+                std::memset(dst, 0, (frames - first) * sizeof(float));
+            }
+        }
+        writePos_.store(w + frames, std::memory_order_release);
+        return true;
+    }
+
+    // Кадров, записанных producer-ом за все время (позиция следующего push).
+    uint64_t writePosition() const noexcept { return writePos_.load(std::memory_order_acquire); }
+
+    // Consumer: до двух отрезков с готовыми кадрами (не больше maxFrames). Возвращает число отрезков.
+    int peek(std::size_t maxFrames, Span (&out)[2]) const noexcept {
+        const uint64_t r = readPos_.load(std::memory_order_relaxed);
+        const uint64_t w = writePos_.load(std::memory_order_acquire);
+        const std::size_t avail = std::min(static_cast<std::size_t>(w - r), maxFrames);
+        if (avail == 0) {
+            return 0;
+        }
+        const std::size_t pos = static_cast<std::size_t>(r) & mask_;
+        const std::size_t first = std::min(avail, capacity_ - pos);
+        for (int c = 0; c < channels_; ++c) {
+            const float* base = data_.get() + static_cast<std::size_t>(c) * capacity_;
+            out[0].ch[c] = base + pos;
+            out[1].ch[c] = base;
+        }
+        out[0].frames = first;
+        out[1].frames = avail - first;
+        return (avail > first) ? 2 : 1;
+    }
+
+    // Consumer: освободить frames кадров, отданных peek().
+    void consume(std::size_t frames) noexcept {
+        readPos_.store(readPos_.load(std::memory_order_relaxed) + frames, std::memory_order_release);
+    }
+
+    std::size_t readable() const noexcept {
+        return static_cast<std::size_t>(writePos_.load(std::memory_order_acquire) -
+                                        readPos_.load(std::memory_order_relaxed));
+    }
+
+private:
+    std::unique_ptr<float[]> data_{};
+    int channels_{0};
+    std::size_t capacity_{0};
+    std::size_t mask_{0};
+    // Разные cache line: RT и писатель не делят строку на каждом блоке.
+    alignas(64) std::atomic<uint64_t> writePos_{0};
+    alignas(64) std::atomic<uint64_t> readPos_{0};
+};
+
+} // namespace avantgarde
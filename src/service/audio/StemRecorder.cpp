@@ -0,0 +1,267 @@
+#include "service/audio/StemRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace avantgarde {
+namespace {
+
+constexpr auto kIdleWait = std::chrono::milliseconds(20);
+constexpr std::size_t kDrainFrames = 16384;
+constexpr int kStemChannels = 2;
+// Сколько stop() ждет границы блока (несколько блоков любого разумного размера).
+constexpr auto kCloseWait = std::chrono::milliseconds(200);
+
+bool parseBitDepth(int bitDepth, WavSampleFormat& out) noexcept {
+    switch (bitDepth) {
+        case 16: out = WavSampleFormat::Pcm16; return true;
+        case 24: out = WavSampleFormat::Pcm24; return true;
+        case 32: out = WavSampleFormat::Float32; return true;
+        default: return false;
+    }
+}
+
+} // namespace
+
+bool StemRecorder::Stem::writeBlock(const float* const* ch, int nframes) noexcept {
+    owner->inRt_.fetch_add(1);
+    if (!owner->blockOpen_.load() || !ch || nframes <= 0) {
+        owner->inRt_.fetch_sub(1);
+        return true;
+    }
+    const auto frames = static_cast<std::size_t>(nframes);
+    if (pendingGapRt > 0) {
+        publishGapRt_();
+    }
+    // Пропуск, который некуда записать, пропускает и этот блок: иначе кадры встанут раньше тишины.
+    const bool ok = pendingGapRt == 0 && ring.push(ch, frames);
+    if (!ok) {
+        pendingGapRt += frames;
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    owner->inRt_.fetch_sub(1);
+    return ok;
+}
+
+void StemRecorder::Stem::publishGapRt_() noexcept {
+    const uint32_t head = gapHead.load(std::memory_order_relaxed);
+    if (head - gapTail.load(std::memory_order_acquire) >= kGapRing) {
+        return;
+    }
+    gaps[head % kGapRing] = Gap{ring.writePosition(), pendingGapRt};
+    // Пропуск публикуется раньше следующих кадров кольца (см. drainStem_).
+    gapHead.store(head + 1, std::memory_order_release);
+    pendingGapRt = 0;
+}
+
+StemRecorder::StemRecorder(double ringSeconds)
+    : ringSeconds_(ringSeconds > 0.0 ? ringSeconds : kDefaultRingSeconds) {
+    // Кольца выделяет start(): неподключенный стем памяти не занимает.
+    for (auto& stem : stems_) {
+        stem = std::make_unique<Stem>();
+        stem->owner = this;
+    }
+}
+
+StemRecorder::~StemRecorder() {
+    stop();
+}
+
+bool StemRecorder::start(const std::vector<std::string>& paths, const RecordConfig& cfg) {
+    stop();
+    const std::lock_guard<std::mutex> lock(mutex_);
+    error_.clear();
+    WavSampleFormat format = WavSampleFormat::Pcm24;
+    if (!parseBitDepth(cfg.bitDepth, format)) {
+        error_ = "unsupported record bit depth: " + std::to_string(cfg.bitDepth);
+        return false;
+    }
+    if (cfg.format != "wav" && cfg.format != "rf64") {
+        error_ = "unsupported record format: " + cfg.format;
+        return false;
+    }
+    if (paths.empty() || paths.size() > kMaxStems || cfg.sampleRate <= 0) {
+        error_ = "invalid stem record config";
+        return false;
+    }
+    const auto ringFrames = static_cast<std::size_t>(std::ceil(ringSeconds_ * cfg.sampleRate));
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        Stem& stem = *stems_[i];
+        bool ok = stem.ring.allocate(kStemChannels, ringFrames);
+        if (!ok) {
+            error_ = "alloc stem ring failed";
+        } else {
+            ok = stem.file.open(paths[i], cfg.sampleRate, kStemChannels, format, cfg.format == "rf64", error_);
+        }
+        if (!ok) {
+            std::string ignored;
+            for (std::size_t k = 0; k < i; ++k) {
+                (void)stems_[k]->file.close({}, ignored);
+            }
+            return false;
+        }
+        stem.gapHead.store(0, std::memory_order_relaxed);
+        stem.gapTail.store(0, std::memory_order_relaxed);
+        stem.pendingGapRt = 0;
+        stem.consumed = 0;
+        stem.framesWritten.store(0, std::memory_order_relaxed);
+        stem.dropped.store(0, std::memory_order_relaxed);
+    }
+    stemCount_ = paths.size();
+    quit_ = false;
+    thread_ = std::thread([this]() { writerLoop_(); });
+    recording_.store(true, std::memory_order_release);
+    accepting_.store(true);
+    return true;
+}
+
+void StemRecorder::stop() {
+    if (!recording_.load(std::memory_order_acquire)) {
+        return;
+    }
+    accepting_.store(false);
+    // Даем аудио-нити закрыть запись на границе блока: ждем блок, чей onBlockBegin()
+    // уже увидел accepting_ == false. Блок, успевший открыться до этого, к тому
+    // моменту дописан целиком. Запись закрыта и RT вне рекордера — ждать нечего;
+    // если стрим стоит, закрываем сами по таймауту.
+    const uint64_t begun = blocksBegun_.load();
+    const auto deadline = std::chrono::steady_clock::now() + kCloseWait;
+    while ((blockOpen_.load() || inRt_.load() != 0) && lastClosedBlock_.load() <= begun &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    blockOpen_.store(false);
+    while (inRt_.load() != 0) {
+        std::this_thread::yield();
+    }
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    const std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t longest = 0;
+    for (std::size_t i = 0; i < stemCount_; ++i) {
+        Stem& stem = *stems_[i];
+        // Блоки, потерянные перед самым stop(): тишина в конце, длина стемов одна.
+        appendSilence_(stem, stem.pendingGapRt);
+        stem.pendingGapRt = 0;
+        longest = std::max(longest, stem.framesWritten.load(std::memory_order_relaxed));
+    }
+    for (std::size_t i = 0; i < stemCount_; ++i) {
+        Stem& stem = *stems_[i];
+        // Закрытие по таймауту посреди блока (аудио-нить зависла): часть стемов блок
+        // уже записала, остальные добиваются тишиной до общей длины.
+        appendSilence_(stem, longest - stem.framesWritten.load(std::memory_order_relaxed));
+        std::string err;
+        if (!stem.file.close({}, err) && error_.empty()) {
+            error_ = err;
+        }
+    }
+    recording_.store(false, std::memory_order_release);
+}
+
+IRtRecordSink* StemRecorder::stemSink(std::size_t index) noexcept {
+    return (index < kMaxStems) ? stems_[index].get() : nullptr;
+}
+
+void StemRecorder::onBlockBegin(const AudioProcessContext&) noexcept {
+    // inRt_ держит stop() от закрытия, пока accepting_ прочитан, но блок еще не помечен.
+    inRt_.fetch_add(1);
+    const bool open = accepting_.load();
+    blockOpen_.store(open);
+    const uint64_t block = blocksBegun_.fetch_add(1) + 1;
+    if (!open) {
+        lastClosedBlock_.store(block);
+    }
+    inRt_.fetch_sub(1);
+}
+
+uint64_t StemRecorder::stemFramesWritten(std::size_t index) const noexcept {
+    return (index < stemCount_) ? stems_[index]->framesWritten.load(std::memory_order_relaxed) : 0u;
+}
+
+uint64_t StemRecorder::droppedBlocks() const noexcept {
+    uint64_t sum = 0;
+    for (std::size_t i = 0; i < stemCount_; ++i) {
+        sum += stems_[i]->dropped.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+std::string StemRecorder::lastError() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+void StemRecorder::writerLoop_() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::size_t count = stemCount_;
+    while (!quit_) {
+        lock.unlock();
+        for (std::size_t i = 0; i < count; ++i) {
+            drainStem_(*stems_[i], kBatchFrames);
+        }
+        lock.lock();
+        cv_.wait_for(lock, kIdleWait, [this]() { return quit_; });
+    }
+    lock.unlock();
+    for (std::size_t i = 0; i < count; ++i) {
+        drainStem_(*stems_[i], 0);
+    }
+}
+
+void StemRecorder::drainStem_(Stem& stem, std::size_t minFrames) {
+    if (stem.ring.readable() < minFrames) {
+        return;
+    }
+    RecordRing::Span spans[2];
+    for (;;) {
+        // Сначала объем кольца, потом пропуски: пропуск, опубликованный раньше
+        // видимых кадров, после acquire writePos виден гарантированно.
+        const std::size_t avail = stem.ring.readable();
+        const uint32_t head = stem.gapHead.load(std::memory_order_acquire);
+        const uint32_t tail = stem.gapTail.load(std::memory_order_relaxed);
+        std::size_t limit = avail;
+        if (tail != head) {
+            const Gap& gap = stem.gaps[tail % kGapRing];
+            if (gap.at <= stem.consumed) {
+                appendSilence_(stem, gap.frames);
+                stem.gapTail.store(tail + 1, std::memory_order_release);
+                continue;
+            }
+            limit = static_cast<std::size_t>(std::min<uint64_t>(avail, gap.at - stem.consumed));
+        }
+        const int count = stem.ring.peek(std::min(limit, kDrainFrames), spans);
+        if (count == 0) {
+            break;
+        }
+        std::size_t frames = 0;
+        for (int s = 0; s < count; ++s) {
+            if (!stem.file.failed() && stem.file.append(spans[s].ch, spans[s].frames)) {
+                stem.framesWritten.fetch_add(spans[s].frames, std::memory_order_relaxed);
+            }
+            frames += spans[s].frames;
+        }
+        stem.ring.consume(frames);
+        stem.consumed += frames;
+    }
+}
+
+void StemRecorder::appendSilence_(Stem& stem, uint64_t frames) {
+    const float* silent[kStemChannels] = {nullptr, nullptr};
+    while (frames > 0 && !stem.file.failed()) {
+        const std::size_t n = static_cast<std::size_t>(std::min<uint64_t>(frames, kDrainFrames));
+        if (!stem.file.append(silent, n)) {
+            break;
+        }
+        stem.framesWritten.fetch_add(n, std::memory_order_relaxed);
+        frames -= n;
+    }
+}
+
+} // namespace avantgarde
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "contracts/IAudioRecorder.h"
+#include "contracts/IRtExtension.h"
+#include "service/audio/RecordFileWriter.h"
+#include "service/audio/RecordRing.h"
+
+namespace avantgarde {
+
+// Запись стемов: post-FX выход каждого трека в свой файл (IClipTrack::setStemSink).
+//
+// На трек — свой IRtRecordSink с предвыделенным RecordRing: RT только копирует
+// отрезки выхода трека в кольцо. Все файлы пишет одна нить: она обходит стемы
+// по очереди и забирает кольцо, только когда в нем набралось kBatchFrames (или
+// при stop()), — диск видит крупные последовательные записи по RecordFileWriter::
+// kWriteBytes, а fallocate() держит каждый файл непрерывным (SD-карты).
+//
+// Стемы обязаны совпадать покадрово:
+// - запись открывается и закрывается на границе блока: StemRecorder — IRtExtension
+//   движка, onBlockBegin() фиксирует на весь блок, пишут ли стемы;
+// - блок, не влезший в кольцо, не выбрасывается из таймлайна, а записывается
+//   тишиной той же длины на своем месте (dropped — счетчик таких блоков).
+// Sink-и стемов живут столько же, сколько рекордер: их подключают к трекам до
+// start() и снимают после stop(). cfg — как у AudioRecorder, кроме channels:
+// стем всегда stereo.
+class StemRecorder final : public IRtExtension {
+public:
+    static constexpr double kDefaultRingSeconds = 4.0;
+    static constexpr std::size_t kMaxStems = 32;
+    // Минимум кадров стема на один заход писателя (~0.34 с на 48 кГц).
+    static constexpr std::size_t kBatchFrames = 16384;
+    // Пропусков между проходами писателя; при переполнении копятся в один.
+    static constexpr std::size_t kGapRing = 64;
+
+    explicit StemRecorder(double ringSeconds = kDefaultRingSeconds);
+    ~StemRecorder() override;
+
+    StemRecorder(const StemRecorder&) = delete;
+    StemRecorder& operator=(const StemRecorder&) = delete;
+
+    // Вне RT: по файлу на путь, стем i пишет в paths[i] (не больше kMaxStems).
+    // Ошибка любого файла — не пишется ни один. Запись начнется со следующего блока.
+    bool start(const std::vector<std::string>& paths, const RecordConfig& cfg);
+    // Вне RT: дописать кольца и финализировать все файлы.
+    void stop();
+    bool isRecording() const noexcept { return recording_.load(std::memory_order_acquire); }
+
+    std::size_t stemCount() const noexcept { return stemCount_; }
+    // Sink стема index (RT-часть); nullptr при index >= kMaxStems. Вне записи — no-op.
+    IRtRecordSink* stemSink(std::size_t index) noexcept;
+
+    // RT: граница блока (AudioEngine::addRtExtension).
+    void onBlockBegin(const AudioProcessContext& ctx) noexcept override;
+    void onBlockEnd(const AudioProcessContext&) noexcept override {}
+
+    uint64_t stemFramesWritten(std::size_t index) const noexcept;
+    // Сумма по стемам.
+    uint64_t droppedBlocks() const noexcept;
+    std::string lastError() const;
+
+private:
+    struct Gap {
+        uint64_t at{0};     // позиция кольца, перед которой вставить тишину
+        uint64_t frames{0};
+    };
+
+    struct Stem final : IRtRecordSink {
+        StemRecorder* owner{nullptr};
+        RecordRing ring{};
+        RecordFileWriter file{};
+        // RT -> писатель: SPSC пропусков.
+        std::array<Gap, kGapRing> gaps{};
+        std::atomic<uint32_t> gapHead{0};
+        std::atomic<uint32_t> gapTail{0};
+        // RT-only: потерянные кадры, еще не опубликованные в gaps.
+        uint64_t pendingGapRt{0};
+        // Писатель: кадров кольца, уже отданных в файл.
+        uint64_t consumed{0};
+        std::atomic<uint64_t> framesWritten{0};
+        std::atomic<uint64_t> dropped{0};
+
+        bool writeBlock(const float* const* ch, int nframes) noexcept override;
+        void mark(uint32_t) noexcept override {}
+        void publishGapRt_() noexcept;
+    };
+
+    void writerLoop_();
+    // Нить писателя: забрать из кольца стема до конца или пока не меньше minFrames.
+    void drainStem_(Stem& stem, std::size_t minFrames);
+    void appendSilence_(Stem& stem, uint64_t frames);
+
+    double ringSeconds_{kDefaultRingSeconds};
+    std::array<std::unique_ptr<Stem>, kMaxStems> stems_{};
+    std::size_t stemCount_{0};
+
+    // accepting_ — запрос control-а, blockOpen_ — его значение, снятое в начале блока.
+    // stop() ждет начала блока, который уже увидел accepting_ == false (lastClosedBlock_ —
+    // его номер в blocksBegun_): блок, открытый до stop(), дописывается всеми стемами.
+    std::atomic<bool> accepting_{false};
+    std::atomic<bool> blockOpen_{false};
+    std::atomic<uint64_t> blocksBegun_{0};
+    std::atomic<uint64_t> lastClosedBlock_{0};
+    std::atomic<int> inRt_{0};
+    std::atomic<bool> recording_{false};
+
+    mutable std::mutex mutex_{};
+    std::condition_variable cv_{};
+    bool quit_{false};
+    std::string error_{};
+    std::thread thread_{};
+};
+
+} // namespace avantgarde
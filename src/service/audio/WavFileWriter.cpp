@@ -0,0 +1,211 @@
+#include "service/audio/WavFileWriter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace avantgarde {
+namespace {
+
+constexpr uint16_t kWavFormatPcm = 1u;
+constexpr uint16_t kWavFormatIeeeFloat = 3u;
+// RIFF + fmt(16) + fact + data: для float формата fact обязателен по спецификации.
+constexpr uint32_t kFmtChunkBytes = 16u;
+constexpr uint32_t kFactChunkBytes = 4u;
+
+void putU16(uint8_t* p, uint16_t v) noexcept {
+    p[0] = static_cast<uint8_t>(v & 0xFFu);
+    p[1] = static_cast<uint8_t>((v >> 8) & 0xFFu);
+}
+
+void putU32(uint8_t* p, uint32_t v) noexcept {
+    p[0] = static_cast<uint8_t>(v & 0xFFu);
+    p[1] = static_cast<uint8_t>((v >> 8) & 0xFFu);
+    p[2] = static_cast<uint8_t>((v >> 16) & 0xFFu);
+    p[3] = static_cast<uint8_t>((v >> 24) & 0xFFu);
+}
+
+int32_t floatToPcm(float x, float scale, int32_t maxValue) noexcept {
+    if (!std::isfinite(x)) {
+        return 0;
+    }
+    const float clamped = std::clamp(x, -1.0f, 1.0f);
+    const long v = std::lround(clamped * scale);
+    return static_cast<int32_t>(std::clamp<long>(v, -static_cast<long>(maxValue) - 1, maxValue));
+}
+
+} // namespace
+
+uint32_t wavBytesPerSample(WavSampleFormat format) noexcept {
+    switch (format) {
+        case WavSampleFormat::Pcm16: return 2u;
+        case WavSampleFormat::Pcm24: return 3u;
+        case WavSampleFormat::Float32:
+        default:
+            return 4u;
+    }
+}
+
+void encodeWavFrames(const float* const* ch,
+                     int channels,
+                     std::size_t frames,
+                     WavSampleFormat format,
+                     uint8_t* dst) noexcept {
+    const uint32_t bps = wavBytesPerSample(format);
+    const std::size_t chs = static_cast<std::size_t>(channels);
+    for (std::size_t i = 0; i < frames; ++i) {
+        for (std::size_t c = 0; c < chs; ++c) {
+            const float x = ch[c] ? ch[c][i] : 0.0f;
+            switch (format) {
+                case WavSampleFormat::Pcm16:
+                    putU16(dst, static_cast<uint16_t>(floatToPcm(x, 32767.0f, 32767)));
+                    break;
+                case WavSampleFormat::Pcm24: {
+                    const uint32_t v = static_cast<uint32_t>(floatToPcm(x, 8388607.0f, 8388607));
+                    dst[0] = static_cast<uint8_t>(v & 0xFFu);
+                    dst[1] = static_cast<uint8_t>((v >> 8) & 0xFFu);
+                    dst[2] = static_cast<uint8_t>((v >> 16) & 0xFFu);
+                    break;
+                }
+                case WavSampleFormat::Float32:
+                default: {
+                    uint32_t bits = 0;
+                    std::memcpy(&bits, &x, sizeof(bits));
+                    putU32(dst, bits);
+                    break;
+                }
+            }
+            dst += bps;
+        }
+    }
+}
+
+bool parseWavSampleFormat(std::string_view text, WavSampleFormat& out) noexcept {
+    if (text == "s16") {
+        out = WavSampleFormat::Pcm16;
+        return true;
+    }
+    if (text == "s24") {
+        out = WavSampleFormat::Pcm24;
+        return true;
+    }
+    if (text == "f32") {
+        out = WavSampleFormat::Float32;
+        return true;
+    }
+    return false;
+}
+
+WavFileWriter::~WavFileWriter() {
+    std::string ignored;
+    (void)close(ignored);
+}
+
+bool WavFileWriter::open(const std::string& path,
+                         int sampleRate,
+                         int channels,
+                         WavSampleFormat format,
+                         std::string& errorOut) {
+    std::string ignored;
+    (void)close(ignored);
+    if (sampleRate <= 0 || channels <= 0 || channels > 8) {
+        errorOut = "invalid wav stream config";
+        return false;
+    }
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        errorOut = "cannot open for writing: " + path;
+        return false;
+    }
+    sampleRate_ = sampleRate;
+    channels_ = channels;
+    format_ = format;
+    framesWritten_ = 0;
+    ioFailed_ = false;
+    if (!writeHeader_(0u)) {
+        errorOut = "wav header write failed";
+        std::fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool WavFileWriter::write(const float* const* ch, std::size_t frames) {
+    if (!file_ || ioFailed_ || !ch || frames == 0) {
+        return file_ != nullptr && !ioFailed_;
+    }
+    const std::size_t chs = static_cast<std::size_t>(channels_);
+    scratch_.resize(frames * chs * wavBytesPerSample(format_));
+    encodeWavFrames(ch, channels_, frames, format_, scratch_.data());
+    if (std::fwrite(scratch_.data(), 1, scratch_.size(), file_) != scratch_.size()) {
+        ioFailed_ = true;
+        return false;
+    }
+    framesWritten_ += frames;
+    return true;
+}
+
+bool WavFileWriter::close(std::string& errorOut) {
+    if (!file_) {
+        return true;
+    }
+    bool ok = !ioFailed_;
+    const uint64_t dataBytes = framesWritten_ * static_cast<uint64_t>(channels_) * wavBytesPerSample(format_);
+    if (dataBytes > std::numeric_limits<uint32_t>::max() - 64u) {
+        // Классический RIFF ограничен 4 GiB: заголовок не выразит такой размер.
+        errorOut = "wav data exceeds 4 GiB";
+        ok = false;
+    } else if (ok) {
+        if (std::fseek(file_, 0, SEEK_SET) != 0 || !writeHeader_(static_cast<uint32_t>(dataBytes))) {
+            errorOut = "wav header finalize failed";
+            ok = false;
+        }
+    } else {
+        errorOut = "wav data write failed";
+    }
+    if (std::fclose(file_) != 0 && ok) {
+        errorOut = "wav close failed";
+        ok = false;
+    }
+    file_ = nullptr;
+    return ok;
+}
+
+bool WavFileWriter::writeHeader_(uint32_t dataBytes) {
+    const bool isFloat = (format_ == WavSampleFormat::Float32);
+    const uint32_t bps = wavBytesPerSample(format_);
+    const uint16_t blockAlign = static_cast<uint16_t>(static_cast<uint32_t>(channels_) * bps);
+    const uint32_t factBytes = isFloat ? (8u + kFactChunkBytes) : 0u;
+
+    uint8_t h[12 + 8 + kFmtChunkBytes + 8 + kFactChunkBytes + 8]{};
+    uint8_t* p = h;
+    std::memcpy(p, "RIFF", 4);
+    putU32(p + 4, 4u + (8u + kFmtChunkBytes) + factBytes + 8u + dataBytes);
+    std::memcpy(p + 8, "WAVE", 4);
+    p += 12;
+    std::memcpy(p, "fmt ", 4);
+    putU32(p + 4, kFmtChunkBytes);
+    putU16(p + 8, isFloat ? kWavFormatIeeeFloat : kWavFormatPcm);
+    putU16(p + 10, static_cast<uint16_t>(channels_));
+    putU32(p + 12, static_cast<uint32_t>(sampleRate_));
+    putU32(p + 16, static_cast<uint32_t>(sampleRate_) * blockAlign);
+    putU16(p + 20, blockAlign);
+    putU16(p + 22, static_cast<uint16_t>(bps * 8u));
+    p += 8 + kFmtChunkBytes;
+    if (isFloat) {
+        std::memcpy(p, "fact", 4);
+        putU32(p + 4, kFactChunkBytes);
+        putU32(p + 8, static_cast<uint32_t>(framesWritten_));
+        p += 8 + kFactChunkBytes;
+    }
+    std::memcpy(p, "data", 4);
+    putU32(p + 4, dataBytes);
+    p += 8;
+
+    const std::size_t n = static_cast<std::size_t>(p - h);
+    return std::fwrite(h, 1, n, file_) == n;
+}
+
+} // namespace avantgarde
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace avantgarde {
+
+// Формат сэмплов в выходном WAV.
+enum class WavSampleFormat : uint8_t {
+    Pcm16 = 0,
+    Pcm24 = 1,
+    Float32 = 2
+};
+
+// Разбор CLI-значения формата: "s16" | "s24" | "f32".
+bool parseWavSampleFormat(std::string_view text, WavSampleFormat& out) noexcept;
+
+// Байт на сэмпл одного канала в data chunk.
+uint32_t wavBytesPerSample(WavSampleFormat format) noexcept;
+
+// Interleave + конверсия frames кадров planar float в байты data chunk:
+// dst — frames * channels * wavBytesPerSample(format) байт; ch[c] == nullptr — тишина.
+// Без аллокаций: общий код WavFileWriter и записи на диск (AudioRecorder).
+void encodeWavFrames(const float* const* ch,
+                     int channels,
+                     std::size_t frames,
+                     WavSampleFormat format,
+                     uint8_t* dst) noexcept;
+
+// Потоковая запись WAV (RIFF, little-endian) из planar float блоков.
+// Важно:
+// - только вне RT (файловый IO, аллокации);
+// - размеры chunk-ов дописываются в close(), до этого файл невалиден;
+// - PCM-форматы клипуются в [-1..1], Float32 пишется как есть (WAVE_FORMAT_IEEE_FLOAT).
+class WavFileWriter {
+public:
+    WavFileWriter() = default;
+    ~WavFileWriter();
+
+    WavFileWriter(const WavFileWriter&) = delete;
+    WavFileWriter& operator=(const WavFileWriter&) = delete;
+
+    // Открыть файл и записать заголовок-заглушку.
+    bool open(const std::string& path,
+              int sampleRate,
+              int channels,
+              WavSampleFormat format,
+              std::string& errorOut);
+    // Дописать frames кадров: ch[channel][frame], channel < channels().
+    bool write(const float* const* ch, std::size_t frames);
+    // Финализировать заголовок и закрыть файл.
+    bool close(std::string& errorOut);
+
+    bool isOpen() const noexcept { return file_ != nullptr; }
+    int channels() const noexcept { return channels_; }
+    uint64_t framesWritten() const noexcept { return framesWritten_; }
+
+private:
+    bool writeHeader_(uint32_t dataBytes);
+
+    std::FILE* file_{nullptr};
+    int sampleRate_{48000};
+    int channels_{2};
+    WavSampleFormat format_{WavSampleFormat::Pcm24};
+    uint64_t framesWritten_{0};
+    bool ioFailed_{false};
+    // Буфер interleave одного вызова write() (переиспользуется).
+    std::vector<uint8_t> scratch_{};
+};
+
+} // namespace avantgarde
@@ -1,222 +1,325 @@
 #include "service/pattern/ClipBufferPool.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
-#include <fstream>
+#include <iterator>
 #include <memory>
 #include <vector>
 
+#include "contracts/ClipSampleFormat.h"
+#include "contracts/ClipStretchAnalysis.h"
+#include "contracts/IClipStream.h"
+#include "contracts/WavDecoder.h"
+#include "service/audio/ClipDecodeCache.h"
+#include "service/audio/ClipStream.h"
+#include "service/audio/PolyphaseResampler.h"
+
 namespace avantgarde {
 namespace {
 
-static inline uint16_t read_u16_le(const uint8_t* p) {
-    return static_cast<uint16_t>(p[0] | (p[1] << 8));
-}
-static inline uint32_t read_u32_le(const uint8_t* p) {
-    return static_cast<uint32_t>(p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24));
-}
-static inline bool read_exact(std::ifstream& f, void* dst, std::size_t n) {
-    f.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(n));
-    return f.good();
-}
-
-struct WavFmt {
-    uint16_t audioFormat{0};   // 1=PCM, 3=float32
-    uint16_t numChannels{0};   // 1..2
-    uint32_t sampleRate{0};
-    uint16_t bitsPerSample{0}; // 16/24/32
-    uint16_t blockAlign{0};
-};
-
-bool decode_wav_to_shared_planar(const char* path, SharedClipBuffer& out, std::string* errorOut) {
+bool decode_wav_to_shared_planar(const std::string& path,
+                                 SharedClipBuffer& out,
+                                 std::string* errorOut,
+                                 const std::atomic<bool>* cancel = nullptr) {
     out = SharedClipBuffer{};
-    if (!path) {
-        if (errorOut) *errorOut = "path is null";
+    WavDecodedPlanar wav{};
+    if (!decodeWavFile(path, wav, errorOut, cancel)) {
         return false;
     }
-
-    std::ifstream f(path, std::ios::binary);
-    if (!f.is_open()) {
-        if (errorOut) *errorOut = "cannot open file";
+    out.sampleRate = wav.sampleRate;
+    out.channels = wav.channels;
+    out.frames = wav.frames;
+    out.ch0 = std::shared_ptr<const float[]>(wav.ch0.release(), std::default_delete<float[]>());
+    out.ch1 = (out.channels == 2)
+              ? std::shared_ptr<const float[]>(wav.ch1.release(), std::default_delete<float[]>())
+              : std::shared_ptr<const float[]>{};
+    if (!out.valid()) {
+        if (errorOut) *errorOut = "decoded buffer invalid";
         return false;
     }
+    return true;
+}
 
-    uint8_t riff[12];
-    if (!read_exact(f, riff, 12)) {
-        if (errorOut) *errorOut = "bad riff header";
+// Привести float-клип к частоте rate полифазным SRC (один раз при загрузке:
+// дальше трек на скорости 1.0 идет по пути копирования, без интерполяции).
+bool resample_clip(const SharedClipBuffer& in, int rate, SharedClipBuffer& out) {
+    if (!in.valid() || in.stream || in.format != ClipSampleFormat::Float32) {
         return false;
     }
-    if (std::memcmp(riff + 0, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
-        if (errorOut) *errorOut = "not RIFF/WAVE";
+    const PolyphaseResampler src(in.sampleRate, rate);
+    const int64_t frames = src.outputFrames(in.frames);
+    if (!src.valid() || frames <= 0 || frames > static_cast<int64_t>(INT32_MAX)) {
         return false;
     }
+    SharedClipBuffer b{};
+    b.sampleRate = rate;
+    b.channels = in.channels;
+    b.frames = static_cast<int>(frames);
+    for (int c = 0; c < in.channels; ++c) {
+        std::unique_ptr<float[]> dst{new (std::nothrow) float[static_cast<std::size_t>(frames)]};
+        if (!dst) {
+            return false;
+        }
+        src.process((c == 0 ? in.ch0 : in.ch1).get(), in.frames, dst.get());
+        (c == 0 ? b.ch0 : b.ch1) = std::shared_ptr<const float[]>(dst.release(), std::default_delete<float[]>());
+    }
+    out = std::move(b);
+    return out.valid();
+}
 
-    bool haveFmt = false;
-    bool haveData = false;
-    WavFmt fmt{};
-    std::vector<uint8_t> dataBytes;
-
-    while (f.good() && !(haveFmt && haveData)) {
-        uint8_t chdr[8];
-        if (!read_exact(f, chdr, 8)) break;
-        const uint32_t csize = read_u32_le(chdr + 4);
-        const bool pad = (csize & 1u) != 0;
-
-        if (std::memcmp(chdr + 0, "fmt ", 4) == 0) {
-            if (csize < 16) {
-                if (errorOut) *errorOut = "invalid fmt chunk size";
-                return false;
-            }
-            std::vector<uint8_t> buf(csize);
-            if (!read_exact(f, buf.data(), csize)) {
-                if (errorOut) *errorOut = "cannot read fmt chunk";
-                return false;
-            }
-            fmt.audioFormat = read_u16_le(buf.data() + 0);
-            fmt.numChannels = read_u16_le(buf.data() + 2);
-            fmt.sampleRate = read_u32_le(buf.data() + 4);
-            fmt.blockAlign = read_u16_le(buf.data() + 12);
-            fmt.bitsPerSample = read_u16_le(buf.data() + 14);
-            haveFmt = true;
-        } else if (std::memcmp(chdr + 0, "data", 4) == 0) {
-            dataBytes.resize(csize);
-            if (csize > 0 && !read_exact(f, dataBytes.data(), csize)) {
-                if (errorOut) *errorOut = "cannot read data chunk";
+// Перекодировать клип, целиком лежащий в памяти, в формат хранения format.
+// Для PCM16-источника Float32 -> Int16 без потерь: x * 32768 — исходное целое.
+bool convert_clip_format(const SharedClipBuffer& in, ClipSampleFormat format, SharedClipBuffer& out) {
+    if (!in.valid() || in.stream) {
+        return false;
+    }
+    if (in.format == format) {
+        out = in;
+        return true;
+    }
+    const std::size_t frames = static_cast<std::size_t>(in.frames);
+    SharedClipBuffer b{};
+    b.sampleRate = in.sampleRate;
+    b.channels = in.channels;
+    b.frames = in.frames;
+    b.format = format;
+    // Анализ для time-stretch от формата хранения не зависит.
+    b.stretch = in.stretch;
+    for (int c = 0; c < in.channels; ++c) {
+        if (format == ClipSampleFormat::Float32) {
+            std::unique_ptr<float[]> dst{new (std::nothrow) float[frames]};
+            if (!dst) {
                 return false;
             }
-            haveData = true;
-        } else {
-            f.seekg(static_cast<std::streamoff>(csize), std::ios::cur);
-            if (!f.good()) {
-                if (errorOut) *errorOut = "cannot skip unknown chunk";
-                return false;
+            for (std::size_t i = 0; i < frames; ++i) {
+                dst[i] = clipSampleAt(in, c, static_cast<int>(i));
             }
+            (c == 0 ? b.ch0 : b.ch1) = std::shared_ptr<const float[]>(dst.release(), std::default_delete<float[]>());
+            continue;
         }
-
-        if (pad) {
-            f.seekg(1, std::ios::cur);
-            if (!f.good()) {
-                if (errorOut) *errorOut = "cannot skip pad byte";
-                return false;
-            }
+        std::unique_ptr<int16_t[]> dst{new (std::nothrow) int16_t[frames]};
+        if (!dst) {
+            return false;
+        }
+        for (std::size_t i = 0; i < frames; ++i) {
+            const float x = clipSampleAt(in, c, static_cast<int>(i));
+            dst[i] = (format == ClipSampleFormat::Int16) ? clipSampleToInt16(x)
+                                                         : static_cast<int16_t>(clipSampleToHalf(x));
         }
+        (c == 0 ? b.ch0Packed : b.ch1Packed) =
+            std::shared_ptr<const int16_t[]>(dst.release(), std::default_delete<int16_t[]>());
     }
-
-    if (!haveFmt || !haveData) {
-        if (errorOut) *errorOut = "missing fmt/data chunk";
+    if (!b.valid()) {
         return false;
     }
+    out = std::move(b);
+    return true;
+}
 
-    if (!(fmt.audioFormat == 1 || fmt.audioFormat == 3)) {
-        if (errorOut) *errorOut = "unsupported wav format";
-        return false;
-    }
-    if (!(fmt.numChannels == 1 || fmt.numChannels == 2)) {
-        if (errorOut) *errorOut = "unsupported channel count";
-        return false;
-    }
-    if (!(fmt.bitsPerSample == 16 || fmt.bitsPerSample == 24 || fmt.bitsPerSample == 32)) {
-        if (errorOut) *errorOut = "unsupported bit depth";
-        return false;
-    }
-    if (fmt.blockAlign == 0) {
-        if (errorOut) *errorOut = "invalid blockAlign";
-        return false;
-    }
+// Байты сэмплов клипа в памяти (у потокового — только голова).
+uint64_t clip_resident_bytes(const SharedClipBuffer& b) noexcept {
+    const uint64_t sampleBytes = (b.format == ClipSampleFormat::Float32) ? sizeof(float) : sizeof(int16_t);
+    return static_cast<uint64_t>(b.residentFrames()) * static_cast<uint64_t>(b.channels) * sampleBytes;
+}
 
-    const uint32_t bytesPerFrame = fmt.blockAlign;
-    const uint32_t totalFrames = static_cast<uint32_t>(dataBytes.size() / bytesPerFrame);
-    if (totalFrames == 0) {
-        if (errorOut) *errorOut = "empty audio data";
-        return false;
+const void* clip_channel_data(const SharedClipBuffer& b, int channel) noexcept {
+    if (b.format != ClipSampleFormat::Float32) {
+        return (channel == 0 ? b.ch0Packed : b.ch1Packed).get();
     }
+    return (channel == 0 ? b.ch0 : b.ch1).get();
+}
 
-    std::unique_ptr<float[]> ch0{new (std::nothrow) float[totalFrames]};
-    if (!ch0) {
-        if (errorOut) *errorOut = "alloc ch0 failed";
-        return false;
-    }
-    std::unique_ptr<float[]> ch1{};
-    if (fmt.numChannels == 2) {
-        ch1.reset(new (std::nothrow) float[totalFrames]);
-        if (!ch1) {
-            if (errorOut) *errorOut = "alloc ch1 failed";
-            return false;
-        }
+// Ключ данных клипа: у потокового — сам поток, иначе канал 0.
+const void* clip_storage_key(const SharedClipBuffer& b) noexcept {
+    return b.stream ? static_cast<const void*>(b.stream.get()) : clip_channel_data(b, 0);
+}
+
+// Держит ли данные кто-то кроме пула. Трек (ClipBuffer) и preview хранят копии
+// shared_ptr каналов/потока, поэтому их видно по use_count() без отдельного учета.
+bool clip_referenced_outside(const SharedClipBuffer& b) noexcept {
+    if (b.stream) {
+        return b.stream.use_count() > 1;
     }
+    const bool packed = b.format != ClipSampleFormat::Float32;
+    const long uses = packed ? b.ch0Packed.use_count() : b.ch0.use_count();
+    // Каналы из одного mmap (кэш декодирования) делят control block: пул держит его дважды.
+    const bool oneBlock = b.channels == 2 &&
+                          (packed ? (!b.ch0Packed.owner_before(b.ch1Packed) && !b.ch1Packed.owner_before(b.ch0Packed))
+                                  : (!b.ch0.owner_before(b.ch1) && !b.ch1.owner_before(b.ch0)));
+    return uses > (oneBlock ? 2 : 1);
+}
 
-    const uint8_t* src = dataBytes.data();
-    auto clamp1 = [](float x) -> float {
-        if (x > 1.0f) return 1.0f;
-        if (x < -1.0f) return -1.0f;
-        return x;
+// Хэш содержимого (FNV-1a по 64-битным словам): формат, геометрия и сэмплы.
+uint64_t clip_content_hash(const SharedClipBuffer& b) noexcept {
+    uint64_t h = 14695981039346656037ULL;
+    const auto mix = [&h](uint64_t v) {
+        h ^= v;
+        h *= 1099511628211ULL;
     };
-
-    if (fmt.audioFormat == 3 && fmt.bitsPerSample == 32) {
-        for (uint32_t i = 0; i < totalFrames; ++i) {
-            const float* fr = reinterpret_cast<const float*>(src + i * bytesPerFrame);
-            ch0[i] = clamp1(fr[0]);
-            if (fmt.numChannels == 2) ch1[i] = clamp1(fr[1]);
-        }
-    } else if (fmt.audioFormat == 1 && fmt.bitsPerSample == 16) {
-        for (uint32_t i = 0; i < totalFrames; ++i) {
-            const uint8_t* fr = src + i * bytesPerFrame;
-            int16_t s0 = static_cast<int16_t>(read_u16_le(fr + 0));
-            ch0[i] = static_cast<float>(s0) / 32768.0f;
-            if (fmt.numChannels == 2) {
-                int16_t s1 = static_cast<int16_t>(read_u16_le(fr + 2));
-                ch1[i] = static_cast<float>(s1) / 32768.0f;
-            }
+    mix(static_cast<uint64_t>(b.format));
+    mix(static_cast<uint64_t>(b.sampleRate));
+    mix(static_cast<uint64_t>(b.channels));
+    mix(static_cast<uint64_t>(b.frames));
+    const std::size_t bytes = static_cast<std::size_t>(clip_resident_bytes(b) / static_cast<uint64_t>(b.channels));
+    for (int c = 0; c < b.channels; ++c) {
+        const auto* p = static_cast<const uint8_t*>(clip_channel_data(b, c));
+        std::size_t i = 0;
+        for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+            uint64_t w = 0;
+            std::memcpy(&w, p + i, sizeof(w));
+            mix(w);
         }
-    } else if (fmt.audioFormat == 1 && fmt.bitsPerSample == 24) {
-        auto read_s24 = [](const uint8_t* p) -> int32_t {
-            int32_t v = static_cast<int32_t>(p[0] | (p[1] << 8) | (p[2] << 16));
-            if (v & 0x00800000) v |= 0xFF000000;
-            return v;
-        };
-        for (uint32_t i = 0; i < totalFrames; ++i) {
-            const uint8_t* fr = src + i * bytesPerFrame;
-            int32_t s0 = read_s24(fr + 0);
-            ch0[i] = static_cast<float>(s0) / 8388608.0f;
-            if (fmt.numChannels == 2) {
-                int32_t s1 = read_s24(fr + 3);
-                ch1[i] = static_cast<float>(s1) / 8388608.0f;
-            }
+        for (; i < bytes; ++i) {
+            mix(p[i]);
         }
-    } else {
-        if (errorOut) *errorOut = "unsupported PCM variant";
-        return false;
     }
+    return h;
+}
 
-    out.sampleRate = static_cast<int>(fmt.sampleRate);
-    out.channels = static_cast<int>(fmt.numChannels);
-    out.frames = static_cast<int>(totalFrames);
-    out.ch0 = std::shared_ptr<const float[]>(ch0.release(), std::default_delete<float[]>());
-    out.ch1 = (out.channels == 2)
-              ? std::shared_ptr<const float[]>(ch1.release(), std::default_delete<float[]>())
-              : std::shared_ptr<const float[]>{};
-    if (!out.valid()) {
-        if (errorOut) *errorOut = "decoded buffer invalid";
+bool clip_content_equal(const SharedClipBuffer& a, const SharedClipBuffer& b) noexcept {
+    if (a.format != b.format || a.sampleRate != b.sampleRate || a.channels != b.channels || a.frames != b.frames) {
         return false;
     }
+    const std::size_t bytes = static_cast<std::size_t>(clip_resident_bytes(a) / static_cast<uint64_t>(a.channels));
+    for (int c = 0; c < a.channels; ++c) {
+        if (std::memcmp(clip_channel_data(a, c), clip_channel_data(b, c), bytes) != 0) {
+            return false;
+        }
+    }
     return true;
 }
 
 } // namespace
 
+ClipBufferPool::ClipBufferPool() = default;
+
+ClipBufferPool::~ClipBufferPool() = default;
+
+void ClipBufferPool::setStreaming(double minSeconds, double headSeconds) {
+    streamMinSeconds_ = std::max(0.0, minSeconds);
+    streamHeadSeconds_ = std::max(0.1, headSeconds);
+    if (streamMinSeconds_ > 0.0 && !prefetcher_) {
+        // Заранее: decodeFile() зовется из рабочих нитей и пул не меняет.
+        prefetcher_ = std::make_unique<ClipStreamPrefetcher>();
+    }
+}
+
+void ClipBufferPool::setDecodeCache(const std::string& directory, uint64_t maxBytes) {
+    decodeCache_ = directory.empty() ? nullptr : std::make_unique<ClipDecodeCache>(directory, maxBytes);
+}
+
+void ClipBufferPool::setMemoryBudget(uint64_t maxBytes) {
+    budgetBytes_ = maxBytes;
+    enforceBudget_(nullptr);
+}
+
+void ClipBufferPool::setPinned(const std::vector<uint32_t>& clipRefIds) {
+    pinned_.clear();
+    pinned_.insert(clipRefIds.begin(), clipRefIds.end());
+}
+
+ClipPoolStats ClipBufferPool::stats() const noexcept {
+    ClipPoolStats out = stats_;
+    out.residentBytes = residentBytes_;
+    out.budgetBytes = budgetBytes_;
+    out.clips = buffers_.size();
+    out.buffers = storage_.size();
+    return out;
+}
+
+uint64_t ClipBufferPool::streamUnderruns() const noexcept {
+    uint64_t total = 0;
+    for (const auto& [key, storage] : storage_) {
+        (void)key;
+        if (storage.buffer.stream) {
+            total += storage.buffer.stream->underruns();
+        }
+    }
+    return total;
+}
+
 bool ClipBufferPool::loadFromFile(uint32_t clipRefId, const std::string& path, std::string* errorOut) {
     if (clipRefId == 0) {
         if (errorOut) *errorOut = "clipRefId=0 is reserved";
         return false;
     }
+    SharedClipBuffer decoded{};
+    if (!decodeFile(path, decoded, errorOut)) {
+        return false;
+    }
+    insert_(clipRefId, std::move(decoded));
+    return true;
+}
+
+bool ClipBufferPool::decodeFile(const std::string& path,
+                                SharedClipBuffer& out,
+                                std::string* errorOut,
+                                const std::atomic<bool>* cancel) const {
+    // Отмененная загрузка бросает работу между этапами: результат все равно выбросят.
+    const auto cancelled = [cancel, errorOut]() {
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            if (errorOut) *errorOut = "cancelled";
+            return true;
+        }
+        return false;
+    };
     if (path.empty()) {
         if (errorOut) *errorOut = "path is empty";
         return false;
     }
+    if (streamMinSeconds_ > 0.0) {
+        // Длину узнаем по заголовку, не читая data chunk.
+        WavDecoder probe{};
+        if (probe.open(path, nullptr) &&
+            static_cast<double>(probe.frames()) > streamMinSeconds_ * static_cast<double>(probe.sampleRate())) {
+            probe.close();
+            SharedClipBuffer streamed{};
+            auto stream = ClipStream::open(path, streamHeadSeconds_, streamed, errorOut);
+            if (!stream) {
+                return false;
+            }
+            prefetcher_->add(stream);
+            stream.reset();
+            out = std::move(streamed);
+            return true;
+        }
+    }
     SharedClipBuffer decoded{};
-    if (!decode_wav_to_shared_planar(path.c_str(), decoded, errorOut)) {
+    // Запись с другой частотой — от запуска с другим SRC: пересчитываем из источника, а не из копии.
+    if (decodeCache_ && decodeCache_->load(path, decoded) &&
+        (targetSampleRate_ <= 0 || decoded.sampleRate == targetSampleRate_)) {
+        // Запись могла остаться от запуска с другим форматом хранения.
+        if (decoded.format != storageFormat_ && !convert_clip_format(decoded, storageFormat_, decoded)) {
+            if (errorOut) *errorOut = "sample format conversion failed";
+            return false;
+        }
+        decoded.stretch = analyzeClipForStretch(decoded);
+        out = std::move(decoded);
+        return true;
+    }
+    if (!decode_wav_to_shared_planar(path, decoded, errorOut, cancel) || cancelled()) {
+        return false;
+    }
+    if (targetSampleRate_ > 0 && decoded.sampleRate != targetSampleRate_ &&
+        !resample_clip(decoded, targetSampleRate_, decoded)) {
+        if (errorOut) *errorOut = "sample rate conversion failed";
+        return false;
+    }
+    if (cancelled()) {
         return false;
     }
-    buffers_[clipRefId] = std::move(decoded);
+    if (!convert_clip_format(decoded, storageFormat_, decoded)) {
+        if (errorOut) *errorOut = "sample format conversion failed";
+        return false;
+    }
+    if (decodeCache_) {
+        // Кэш — ускорение, а не условие загрузки: ошибка записи не мешает клипу.
+        (void)decodeCache_->store(path, decoded);
+    }
+    // Анализ для tempo sync Stretch — здесь, в нити загрузчика, а не в RT и не в control.
+    decoded.stretch = analyzeClipForStretch(decoded);
+    out = std::move(decoded);
     return true;
 }
 
@@ -224,7 +327,20 @@ bool ClipBufferPool::put(uint32_t clipRefId, const SharedClipBuffer& buffer) {
     if (clipRefId == 0 || !buffer.valid()) {
         return false;
     }
-    buffers_[clipRefId] = buffer;
+    insert_(clipRefId, buffer);
+    return true;
+}
+
+bool ClipBufferPool::convertClip(uint32_t clipRefId, ClipSampleFormat format) {
+    const auto it = buffers_.find(clipRefId);
+    if (it == buffers_.end()) {
+        return false;
+    }
+    SharedClipBuffer converted{};
+    if (!convert_clip_format(storage_.at(it->second).buffer, format, converted)) {
+        return false;
+    }
+    insert_(clipRefId, std::move(converted));
     return true;
 }
 
@@ -235,14 +351,24 @@ bool ClipBufferPool::contains(uint32_t clipRefId) const noexcept {
 bool ClipBufferPool::get(uint32_t clipRefId, SharedClipBuffer& out) const noexcept {
     const auto it = buffers_.find(clipRefId);
     if (it == buffers_.end()) {
+        ++stats_.misses;
         return false;
     }
-    out = it->second;
+    Storage& storage = storage_.find(it->second)->second;
+    storage.lastUse = ++useClock_;
+    ++stats_.hits;
+    out = storage.buffer;
     return true;
 }
 
 bool ClipBufferPool::erase(uint32_t clipRefId) noexcept {
-    return buffers_.erase(clipRefId) > 0;
+    const auto it = buffers_.find(clipRefId);
+    if (it == buffers_.end()) {
+        return false;
+    }
+    release_(it->second);
+    buffers_.erase(it);
+    return true;
 }
 
 std::size_t ClipBufferPool::size() const noexcept {
@@ -257,5 +383,99 @@ bool ClipBufferPool::bindClipToTrack(IClipTrack& track, uint32_t slot, uint32_t
     return track.loadSlotFromBuffer(slot, b);
 }
 
-} // namespace avantgarde
+void ClipBufferPool::insert_(uint32_t clipRefId, SharedClipBuffer buffer) {
+    const void* key = clip_storage_key(buffer);
+    uint64_t hash = 0;
+    if (!buffer.stream && storage_.find(key) == storage_.end()) {
+        // Тот же звук уже в пуле (другой путь, копия файла, повторный freeze): делим буфер.
+        hash = clip_content_hash(buffer);
+        for (auto [it, end] = storageByHash_.equal_range(hash); it != end; ++it) {
+            const Storage& same = storage_.at(it->second);
+            if (clip_content_equal(same.buffer, buffer)) {
+                key = it->second;
+                ++stats_.dedupHits;
+                break;
+            }
+        }
+    }
+
+    const auto prev = buffers_.find(clipRefId);
+    if (prev != buffers_.end()) {
+        if (prev->second == key) {
+            storage_.at(key).lastUse = ++useClock_;
+            return;
+        }
+        release_(prev->second);
+        buffers_.erase(prev);
+    }
+
+    auto [sit, inserted] = storage_.try_emplace(key);
+    Storage& storage = sit->second;
+    if (inserted) {
+        storage.bytes = clip_resident_bytes(buffer);
+        storage.contentHash = hash;
+        storage.buffer = std::move(buffer);
+        residentBytes_ += storage.bytes;
+        if (!storage.buffer.stream) {
+            storageByHash_.emplace(hash, key);
+        }
+    }
+    ++storage.refs;
+    storage.lastUse = ++useClock_;
+    buffers_[clipRefId] = key;
+    enforceBudget_(key);
+}
 
+void ClipBufferPool::release_(const void* key) noexcept {
+    const auto it = storage_.find(key);
+    if (it == storage_.end() || --it->second.refs > 0) {
+        return;
+    }
+    if (!it->second.buffer.stream) {
+        for (auto [h, end] = storageByHash_.equal_range(it->second.contentHash); h != end; ++h) {
+            if (h->second == key) {
+                storageByHash_.erase(h);
+                break;
+            }
+        }
+    }
+    residentBytes_ -= it->second.bytes;
+    storage_.erase(it);
+}
+
+bool ClipBufferPool::pinnedStorage_(const void* key) const noexcept {
+    for (const uint32_t id : pinned_) {
+        const auto it = buffers_.find(id);
+        if (it != buffers_.end() && it->second == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ClipBufferPool::enforceBudget_(const void* keep) {
+    while (budgetBytes_ > 0 && residentBytes_ > budgetBytes_) {
+        // Самый давно использованный буфер, который не держит ни трек, ни preview, ни паттерн.
+        const void* victim = nullptr;
+        uint64_t oldest = UINT64_MAX;
+        for (const auto& [key, storage] : storage_) {
+            if (key != keep && storage.lastUse < oldest && !clip_referenced_outside(storage.buffer) &&
+                !pinnedStorage_(key)) {
+                victim = key;
+                oldest = storage.lastUse;
+            }
+        }
+        if (!victim) {
+            // Все, что сверх бюджета, сейчас звучит: превышение временное, до следующей загрузки.
+            return;
+        }
+        for (auto it = buffers_.begin(); it != buffers_.end();) {
+            it = (it->second == victim) ? buffers_.erase(it) : std::next(it);
+        }
+        storage_.at(victim).refs = 1;
+        release_(victim);
+        ++stats_.evictions;
+    }
+}
+
+} // namespace avantgarde
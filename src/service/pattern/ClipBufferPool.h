@@ -1,13 +1,33 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "contracts/IClipTrack.h"
 
 namespace avantgarde {
 
+class ClipDecodeCache;
+class ClipStreamPrefetcher;
+
+// Статистика пула (см. ClipBufferPool::stats()).
+struct ClipPoolStats {
+    uint64_t hits{0};          // get()/bindClipToTrack() нашли клип
+    uint64_t misses{0};        // ... не нашли: не загружен или вытеснен
+    uint64_t evictions{0};     // буферы, вытесненные по бюджету
+    uint64_t dedupHits{0};     // загрузки, отданные уже лежащему в пуле буферу того же содержимого
+    uint64_t residentBytes{0}; // сэмплы в памяти; общий буфер считается один раз
+    uint64_t budgetBytes{0};   // 0 — без лимита
+    std::size_t clips{0};      // clipRefId в пуле
+    std::size_t buffers{0};    // различных буферов под ними
+};
+
 /**
  * @brief In-memory пул preloaded клипов по clipRefId.
  *
@@ -15,9 +35,88 @@ namespace avantgarde {
  * - загружать WAV один раз (вне RT);
  * - хранить декодированные planar буферы в памяти;
  * - быстро назначать буфер треку без IO через loadSlotFromBuffer().
+ *
+ * Длинные клипы (см. setStreaming()) целиком не декодируются: в пуле лежит
+ * голова + IClipStream, остальное с диска подкачивает фоновая I/O-нить пула.
+ *
+ * С кэшем декодирования (см. setDecodeCache()) повторная загрузка того же файла
+ * не декодирует WAV, а отображает готовый planar-буфер с диска.
+ *
+ * Формат хранения (см. setStorageFormat()/convertClip()): float32 либо компактный
+ * int16/half — вдвое меньше памяти и полосы; во float переводит ядро ресэмплера трека.
+ *
+ * Частота (см. setTargetSampleRate()): клипы другой частоты один раз приводятся
+ * к частоте движка полифазным SRC, и на скорости 1.0 трек не интерполирует.
+ *
+ * Память (см. setMemoryBudget()): clipRefId с одинаковым содержимым делят один буфер
+ * (хэш сэмплов + побайтовая сверка), а сверх бюджета вытесняются давно не использованные
+ * буферы — кроме тех, что сейчас держит трек или preview, и закрепленных clipRefId
+ * (setPinned(): на них ссылаются снапшоты паттернов). Вытесненный clipRefId
+ * пропадает из пула: get() промахивается, и владелец перечитывает файл.
  */
 class ClipBufferPool final {
 public:
+    ClipBufferPool();
+    ~ClipBufferPool();
+
+    ClipBufferPool(const ClipBufferPool&) = delete;
+    ClipBufferPool& operator=(const ClipBufferPool&) = delete;
+
+    /**
+     * @brief Включить потоковое чтение длинных клипов (действует на следующие loadFromFile()).
+     * @param minSeconds Клипы длиннее этого читаются с диска; 0 — всегда целиком в память.
+     * @param headSeconds Сколько секунд от начала клипа держать в памяти.
+     */
+    void setStreaming(double minSeconds, double headSeconds = 2.0);
+    /**
+     * @brief Суммарные underrun-ы потоковых клипов пула (RT не дождался данных с диска).
+     */
+    uint64_t streamUnderruns() const noexcept;
+    /**
+     * @brief Подключить кэш декодированных клипов (действует на следующие loadFromFile()).
+     * @param directory Каталог кэша; пустая строка — кэш выключен.
+     * @param maxBytes Лимит размера каталога (0 — без лимита).
+     */
+    void setDecodeCache(const std::string& directory, uint64_t maxBytes);
+    /**
+     * @brief Текущий кэш декодирования (nullptr — выключен).
+     */
+    const ClipDecodeCache* decodeCache() const noexcept { return decodeCache_.get(); }
+    /**
+     * @brief Формат хранения клипов, целиком лежащих в памяти (действует на следующие loadFromFile()).
+     * Потоковые клипы всегда float32.
+     */
+    void setStorageFormat(ClipSampleFormat format) noexcept { storageFormat_ = format; }
+    ClipSampleFormat storageFormat() const noexcept { return storageFormat_; }
+    /**
+     * @brief Частота, к которой приводятся клипы при загрузке (действует на следующие loadFromFile()).
+     * @param sampleRate Обычно частота движка; 0 — клипы хранятся в частоте файла.
+     * Потоковые клипы не конвертируются: их ресэмплирует трек, как и раньше.
+     */
+    void setTargetSampleRate(int sampleRate) noexcept { targetSampleRate_ = std::max(0, sampleRate); }
+    int targetSampleRate() const noexcept { return targetSampleRate_; }
+    /**
+     * @brief Перекодировать уже загруженный клип в другой формат хранения.
+     * Треки, которым клип уже назначен, держат старый буфер до следующего bind.
+     * @return true если клип найден, не потоковый и перекодирован.
+     */
+    bool convertClip(uint32_t clipRefId, ClipSampleFormat format);
+    /**
+     * @brief Лимит памяти сэмплов пула (0 — без лимита); лишнее вытесняется сразу.
+     */
+    void setMemoryBudget(uint64_t maxBytes);
+    uint64_t memoryBudget() const noexcept { return budgetBytes_; }
+    /**
+     * @brief Заменить набор clipRefId, которые бюджет не вытесняет (клипы снапшотов паттернов:
+     * switch должен найти их в пуле, а не декодировать заново на control-потоке).
+     * Открепленные id вытесняются не сразу, а при следующей загрузке.
+     */
+    void setPinned(const std::vector<uint32_t>& clipRefIds);
+    bool isPinned(uint32_t clipRefId) const noexcept { return pinned_.count(clipRefId) != 0; }
+    /**
+     * @brief Счетчики попаданий/вытеснений и текущий объем пула.
+     */
+    ClipPoolStats stats() const noexcept;
     /**
      * @brief Загрузить WAV в пул под заданным clipRefId.
      * @param clipRefId Идентификатор клипа в проекте/паттерне.
@@ -26,6 +125,17 @@ public:
      * @return true при успешной загрузке и сохранении в пул.
      */
     bool loadFromFile(uint32_t clipRefId, const std::string& path, std::string* errorOut = nullptr);
+    /**
+     * @brief Декодировать WAV так же, как loadFromFile() (поток, кэш, формат хранения), не трогая пул.
+     * Можно звать из рабочих нитей параллельно с операциями пула на control-потоке;
+     * настройки (setStreaming/setDecodeCache/setStorageFormat) в это время не меняются.
+     * Результат кладется в пул через put().
+     * cancel (флаг ClipLoader) опрашивается между чанками WAV и перед SRC/конвертацией формата.
+     */
+    bool decodeFile(const std::string& path,
+                    SharedClipBuffer& out,
+                    std::string* errorOut = nullptr,
+                    const std::atomic<bool>* cancel = nullptr) const;
     /**
      * @brief Положить заранее подготовленный буфер в пул.
      * @param clipRefId Идентификатор клипа.
@@ -34,7 +144,7 @@ public:
      */
     bool put(uint32_t clipRefId, const SharedClipBuffer& buffer);
     /**
-     * @brief Проверить наличие буфера в пуле.
+     * @brief Проверить наличие буфера в пуле (не считается обращением для LRU и stats).
      * @param clipRefId Идентификатор клипа.
      * @return true если буфер есть.
      */
@@ -67,7 +177,39 @@ public:
     bool bindClipToTrack(IClipTrack& track, uint32_t slot, uint32_t clipRefId) const;
 
 private:
-    std::unordered_map<uint32_t, SharedClipBuffer> buffers_{};
+    // Буфер в памяти и все clipRefId, которые на него указывают.
+    struct Storage {
+        SharedClipBuffer buffer{};
+        uint64_t bytes{0};
+        uint64_t contentHash{0};
+        uint64_t lastUse{0};
+        uint32_t refs{0};
+    };
+
+    // Положить буфер под clipRefId (с дедупликацией) и ужать пул до бюджета.
+    void insert_(uint32_t clipRefId, SharedClipBuffer buffer);
+    // Снять одну ссылку clipRefId с буфера; последний освобождает его.
+    void release_(const void* key) noexcept;
+    void enforceBudget_(const void* keep);
+    // На буфер ссылается закрепленный clipRefId.
+    bool pinnedStorage_(const void* key) const noexcept;
+
+    // clipRefId -> ключ буфера (данные канала 0 или поток).
+    std::unordered_map<uint32_t, const void*> buffers_{};
+    // get() const обновляет LRU-метку и счетчики.
+    mutable std::unordered_map<const void*, Storage> storage_{};
+    std::unordered_multimap<uint64_t, const void*> storageByHash_{};
+    uint64_t residentBytes_{0};
+    uint64_t budgetBytes_{0};
+    std::unordered_set<uint32_t> pinned_{};
+    mutable uint64_t useClock_{0};
+    mutable ClipPoolStats stats_{};
+    double streamMinSeconds_{0.0};
+    double streamHeadSeconds_{2.0};
+    ClipSampleFormat storageFormat_{ClipSampleFormat::Float32};
+    int targetSampleRate_{0};
+    std::unique_ptr<ClipStreamPrefetcher> prefetcher_{};
+    std::unique_ptr<ClipDecodeCache> decodeCache_{};
 };
 
 } // namespace avantgarde
@@ -80,6 +80,9 @@ void PatternSnapshotBuilder::copyTrackSnapshotToPattern_(const TrackSnapshot& sr
     dst.trackParams.push_back(ParamKV{
         toParamIndex(TrackParamId::TempoSyncEnabled),
         src.tempoSync ? 1.0f : 0.0f});
+    dst.trackParams.push_back(ParamKV{
+        toParamIndex(TrackParamId::TempoSyncMode),
+        toParamValue(src.tempoSyncMode)});
 }
 
 void PatternSnapshotBuilder::applyLayoutDefaults_(PatternState& state,
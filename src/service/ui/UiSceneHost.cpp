@@ -347,6 +347,7 @@ WidgetOutput UiSceneHost::onGlobalAction_(UiAction& action, const UiState& rtSta
         case UiAction::Id::SceneTrackMenuSampleEdit:
         case UiAction::Id::SceneTrackMenuSequencer:
         case UiAction::Id::SceneTrackMenuPatternEdit:
+        case UiAction::Id::SceneTrackMenuFreeze:
         case UiAction::Id::SceneSampleMenuPreview:
         case UiAction::Id::SceneSampleMenuLoadSample:
         case UiAction::Id::SceneSampleMenuDetectBpm:
@@ -5,11 +5,11 @@
 #include <cstdint>
 #include <cstring>
 #include <cstdio>
-#include <fstream>
 #include <limits>
 #include <string>
 #include <vector>
 
+#include "contracts/WavDecoder.h"
 #include "service/ui/UiBindResolver.h"
 #include "service/ui/UiCapabilityService.h"
 #include "service/ui/UiTargetResolver.h"
@@ -18,22 +18,6 @@
 namespace avantgarde {
 namespace {
 
-uint16_t readU16Le(const uint8_t* p) noexcept {
-    return static_cast<uint16_t>(p[0] | (p[1] << 8));
-}
-
-uint32_t readU32Le(const uint8_t* p) noexcept {
-    return static_cast<uint32_t>(p[0] |
-                                 (p[1] << 8) |
-                                 (p[2] << 16) |
-                                 (p[3] << 24));
-}
-
-bool readExact(std::ifstream& in, void* dst, std::size_t n) {
-    in.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(n));
-    return in.good();
-}
-
 bool intentFromTarget(std::string_view targetCanonical,
                       uint8_t selectedTrack,
                       float value,
@@ -203,148 +187,8 @@ bool SampleEditWidget::decodeWavMono_(const std::string& path,
     if (path.empty()) {
         return false;
     }
-
-    std::ifstream in(path, std::ios::binary);
-    if (!in.is_open()) {
-        return false;
-    }
-
-    uint8_t riff[12]{};
-    if (!readExact(in, riff, sizeof(riff))) {
-        return false;
-    }
-    if (std::memcmp(riff + 0, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
-        return false;
-    }
-
-    struct Fmt {
-        uint16_t audioFormat{0};
-        uint16_t channels{0};
-        uint32_t sampleRate{0};
-        uint16_t bitsPerSample{0};
-        uint16_t blockAlign{0};
-    } fmt{};
-
-    bool haveFmt = false;
-    bool haveData = false;
-    std::vector<uint8_t> data{};
-
-    while (in.good() && !(haveFmt && haveData)) {
-        uint8_t chunkHeader[8]{};
-        if (!readExact(in, chunkHeader, sizeof(chunkHeader))) {
-            break;
-        }
-        const uint32_t chunkSize = readU32Le(chunkHeader + 4);
-        const bool hasPad = (chunkSize & 1U) != 0U;
-
-        if (std::memcmp(chunkHeader, "fmt ", 4) == 0) {
-            if (chunkSize < 16U) {
-                return false;
-            }
-            std::vector<uint8_t> fmtBuf(chunkSize);
-            if (!readExact(in, fmtBuf.data(), chunkSize)) {
-                return false;
-            }
-            fmt.audioFormat = readU16Le(fmtBuf.data() + 0);
-            fmt.channels = readU16Le(fmtBuf.data() + 2);
-            fmt.sampleRate = readU32Le(fmtBuf.data() + 4);
-            fmt.blockAlign = readU16Le(fmtBuf.data() + 12);
-            fmt.bitsPerSample = readU16Le(fmtBuf.data() + 14);
-            haveFmt = true;
-        } else if (std::memcmp(chunkHeader, "data", 4) == 0) {
-            data.resize(chunkSize);
-            if (chunkSize > 0U && !readExact(in, data.data(), chunkSize)) {
-                return false;
-            }
-            haveData = true;
-        } else {
-            in.seekg(static_cast<std::streamoff>(chunkSize), std::ios::cur);
-            if (!in.good()) {
-                return false;
-            }
-        }
-
-        if (hasPad) {
-            in.seekg(1, std::ios::cur);
-            if (!in.good()) {
-                return false;
-            }
-        }
-    }
-
-    if (!haveFmt || !haveData) {
-        return false;
-    }
-    if (!(fmt.audioFormat == 1U || fmt.audioFormat == 3U)) {
-        return false;
-    }
-    if (!(fmt.channels == 1U || fmt.channels == 2U)) {
-        return false;
-    }
-    if (!(fmt.bitsPerSample == 16U || fmt.bitsPerSample == 24U || fmt.bitsPerSample == 32U)) {
-        return false;
-    }
-    if (fmt.blockAlign == 0U || fmt.sampleRate == 0U) {
-        return false;
-    }
-
-    const uint32_t frames = static_cast<uint32_t>(data.size() / fmt.blockAlign);
-    if (frames == 0U) {
-        return false;
-    }
-
-    monoOut.assign(frames, 0.0f);
-    const uint8_t* src = data.data();
-    auto clamp1 = [](float x) noexcept {
-        return std::clamp(x, -1.0f, 1.0f);
-    };
-
-    if (fmt.audioFormat == 3U && fmt.bitsPerSample == 32U) {
-        for (uint32_t i = 0; i < frames; ++i) {
-            const float* frame = reinterpret_cast<const float*>(src + i * fmt.blockAlign);
-            const float l = clamp1(frame[0]);
-            const float r = (fmt.channels == 2U) ? clamp1(frame[1]) : l;
-            monoOut[i] = 0.5f * (l + r);
-        }
-        return true;
-    }
-
-    if (fmt.audioFormat == 1U && fmt.bitsPerSample == 16U) {
-        for (uint32_t i = 0; i < frames; ++i) {
-            const uint8_t* frame = src + i * fmt.blockAlign;
-            const int16_t s0 = static_cast<int16_t>(readU16Le(frame + 0));
-            const float l = static_cast<float>(s0) / 32768.0f;
-            float r = l;
-            if (fmt.channels == 2U) {
-                const int16_t s1 = static_cast<int16_t>(readU16Le(frame + 2));
-                r = static_cast<float>(s1) / 32768.0f;
-            }
-            monoOut[i] = 0.5f * (l + r);
-        }
-        return true;
-    }
-
-    if (fmt.audioFormat == 1U && fmt.bitsPerSample == 24U) {
-        auto readS24 = [](const uint8_t* p) noexcept {
-            int32_t v = static_cast<int32_t>(p[0] | (p[1] << 8) | (p[2] << 16));
-            if ((v & 0x00800000) != 0) {
-                v |= 0xFF000000;
-            }
-            return v;
-        };
-        for (uint32_t i = 0; i < frames; ++i) {
-            const uint8_t* frame = src + i * fmt.blockAlign;
-            const float l = static_cast<float>(readS24(frame + 0)) / 8388608.0f;
-            float r = l;
-            if (fmt.channels == 2U) {
-                r = static_cast<float>(readS24(frame + 3)) / 8388608.0f;
-            }
-            monoOut[i] = 0.5f * (l + r);
-        }
-        return true;
-    }
-
-    return false;
+    int sampleRate = 0;
+    return decodeWavFileMono(path, sampleRate, monoOut);
 }
 
 std::vector<float> SampleEditWidget::getWavePeaksForPath_(const std::string& path) const {
@@ -2,6 +2,12 @@
 
 namespace avantgarde {
 
+uint8_t TrackContextMenuWidget::selectedTrack_(const UiState& rtState, const UiNavState& navState) noexcept {
+    return (navState.selectedTrack >= rtState.tracks.size())
+               ? static_cast<uint8_t>(rtState.tracks.size() - 1U)
+               : navState.selectedTrack;
+}
+
 TrackContextMenuWidget::TrackContextMenuWidget(
     uint16_t frameWidth,
     std::optional<UiLayoutTemplate> layoutTemplate) noexcept
@@ -14,8 +20,9 @@ TrackContextMenuWidget::TrackContextMenuWidget(
           std::move(layoutTemplate)) {}
 
 std::vector<ContextMenuWidgetBase::MenuItem> TrackContextMenuWidget::buildMenuItems_(const UiState& rtState,
-                                                                                      const UiNavState&) const {
+                                                                                      const UiNavState& navState) const {
     const bool hasTracks = !rtState.tracks.empty();
+    const bool frozen = hasTracks && rtState.tracks[selectedTrack_(rtState, navState)].frozen;
     return {
         {
             UiAction::Id::SceneTrackMenuClear,
@@ -47,6 +54,12 @@ std::vector<ContextMenuWidgetBase::MenuItem> TrackContextMenuWidget::buildMenuIt
             " action:OPEN PATTERN EDIT ",
             true,
         },
+        {
+            UiAction::Id::SceneTrackMenuFreeze,
+            frozen ? "UNFREEZE" : "FREEZE",
+            frozen ? " action:UNFREEZE (restore live FX) " : " action:FREEZE (render FX into clip) ",
+            hasTracks,
+        },
     };
 }
 
@@ -61,12 +74,9 @@ WidgetOutput TrackContextMenuWidget::applyMenuItem_(UiAction::Id actionId,
             if (rtState.tracks.empty()) {
                 break;
             }
-            const uint8_t t = (navState.selectedTrack >= rtState.tracks.size())
-                                  ? static_cast<uint8_t>(rtState.tracks.size() - 1U)
-                                  : navState.selectedTrack;
             UiIntent clear{};
             clear.type = UiIntentType::ClearTrackSample;
-            clear.track = t;
+            clear.track = selectedTrack_(rtState, navState);
             out.intents.push_back(std::move(clear));
             UiIntent back{};
             back.type = UiIntentType::Back;
@@ -74,6 +84,22 @@ WidgetOutput TrackContextMenuWidget::applyMenuItem_(UiAction::Id actionId,
             back.resetSceneActionIndex = true;
             out.intents.push_back(std::move(back));
         } break;
+        case UiAction::Id::SceneTrackMenuFreeze: {
+            if (rtState.tracks.empty()) {
+                break;
+            }
+            const uint8_t t = selectedTrack_(rtState, navState);
+            UiIntent freeze{};
+            freeze.type = UiIntentType::SetTrackFrozen;
+            freeze.track = t;
+            freeze.value = rtState.tracks[t].frozen ? 0.0f : 1.0f;
+            out.intents.push_back(std::move(freeze));
+            UiIntent back{};
+            back.type = UiIntentType::Back;
+            back.scene = UiScene::Tracks;
+            back.resetSceneActionIndex = true;
+            out.intents.push_back(std::move(back));
+        } break;
         case UiAction::Id::SceneTrackMenuFxList: {
             if (rtState.tracks.empty()) {
                 break;
@@ -22,6 +22,10 @@ protected:
     WidgetOutput applyMenuItem_(UiAction::Id actionId,
                                 const UiState& rtState,
                                 UiNavState& navState) const override;
+
+private:
+    // Индекс выбранного трека, ограниченный числом треков (tracks не пуст).
+    static uint8_t selectedTrack_(const UiState& rtState, const UiNavState& navState) noexcept;
 };
 
 } // namespace avantgarde
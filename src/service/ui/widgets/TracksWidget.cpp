@@ -183,6 +183,7 @@ const char* trackStateToStr(UiTrackState s) noexcept {
         case UiTrackState::Stopped: return "STOP ";
         case UiTrackState::Playing: return "PLAY ";
         case UiTrackState::Recording: return "REC  ";
+        case UiTrackState::Loading: return "LOAD ";
         default: return "UNK  ";
     }
 }
@@ -276,9 +277,11 @@ UiPreparedParams TracksWidget::buildPreparedLayoutParams_(const UiState& rtState
         if (patternPending) {
             pendingPart = "->" + std::to_string(static_cast<unsigned>(rtState.pattern.pendingId));
         }
-        std::snprintf(line, sizeof(line), " ACTIVE:T%u XRUN:%llu PG:%u/%u PAT:%u%s%s ",
+        // DSP — p99 нагрузки блока за последнее окно профайлера (% длительности блока).
+        std::snprintf(line, sizeof(line), " ACTIVE:T%u XRUN:%llu DSP:%u%% PG:%u/%u PAT:%u%s%s ",
                       static_cast<unsigned>(activeTrack + 1U),
                       static_cast<unsigned long long>(rtState.telemetry.xruns),
+                      static_cast<unsigned>(std::lround(std::max(0.0f, rtState.telemetry.dspLoadP99Pct))),
                       static_cast<unsigned>(pageIndex + 1U),
                       static_cast<unsigned>(totalPages),
                       static_cast<unsigned>(rtState.pattern.activeId == kInvalidPatternId ? 0U : rtState.pattern.activeId),
@@ -10,8 +10,12 @@
 
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cmath>
+#include <thread>
 
 using namespace avantgarde;
 
@@ -623,3 +627,393 @@ TEST_CASE("Full ordering: ParamBridge -> Transport -> RtExtension(begin) -> Trac
     REQUIRE(sink.writes == 1);
     REQUIRE(phase == 60);
 }
+
+// --- Parallel track rendering ---
+
+TEST_CASE("Parallel track rendering matches serial mix bit-exactly") {
+    struct RampTrack : MockTrack {
+        float gain = 0.0f;
+        uint64_t phase = 0;
+        void process(const AudioProcessContext& ctx) override {
+            ++calls;
+            for (std::size_t i = 0; i < ctx.nframes; ++i) {
+                const float v = gain * static_cast<float>((phase + i) % 97U) / 97.0f;
+                ctx.out[0][i] += v;
+                if (ctx.numOut > 1) ctx.out[1][i] += -0.5f * v;
+            }
+            phase += ctx.nframes;
+        }
+    };
+
+    constexpr int kTracks = 6;
+    constexpr int kBlocks = 8;
+
+    auto makeEngine = [](MockRtQueue& q, MockParamBridge& p, std::vector<RampTrack*>& ptrs) {
+        auto eng = avantgarde::MakeAudioEngine(&q, &p);
+        eng->setSampleRate(48000.0);
+        for (int t = 0; t < kTracks; ++t) {
+            auto tr = std::make_unique<RampTrack>();
+            tr->gain = 0.1f + 0.137f * static_cast<float>(t);
+            ptrs.push_back(tr.get());
+            eng->registerTrack(std::move(tr));
+        }
+        return eng;
+    };
+
+    MockRtQueue qs, qp;
+    MockParamBridge ps, pp;
+    std::vector<RampTrack*> serialTracks, parallelTracks;
+    auto serial = makeEngine(qs, ps, serialTracks);
+    auto parallel = makeEngine(qp, pp, parallelTracks);
+    REQUIRE(parallel->setRenderWorkers(3));
+
+    for (int b = 0; b < kBlocks; ++b) {
+        auto a = makeCtx(256);
+        auto c = makeCtx(256);
+        serial->processBlock(a.ctx);
+        parallel->processBlock(c.ctx);
+        for (std::size_t i = 0; i < a.out0.size(); ++i) {
+            REQUIRE(a.out0[i] == c.out0[i]);
+            REQUIRE(a.out1[i] == c.out1[i]);
+        }
+    }
+    for (int t = 0; t < kTracks; ++t) {
+        REQUIRE(parallelTracks[static_cast<std::size_t>(t)]->calls == kBlocks);
+    }
+
+    // Disabling the pool falls back to the serial path.
+    REQUIRE(parallel->setRenderWorkers(0));
+    auto ctx = makeCtx(256);
+    REQUIRE_NOTHROW(parallel->processBlock(ctx.ctx));
+    REQUIRE(parallelTracks[0]->calls == kBlocks + 1);
+}
+
+TEST_CASE("Aux buses: track sends pass through the shared FX chain into master") {
+    struct ConstTrack : MockTrack {
+        float level = 0.0f;
+        float sends[kMaxAuxBuses]{};
+        void process(const AudioProcessContext& ctx) override {
+            ++calls;
+            for (uint32_t ch = 0; ch < ctx.numOut; ++ch) {
+                for (std::size_t i = 0; i < ctx.nframes; ++i) ctx.out[ch][i] += level;
+            }
+        }
+        float auxSendLevel(uint32_t bus) const noexcept override {
+            return bus < kMaxAuxBuses ? sends[bus] : 0.0f;
+        }
+    };
+    struct ScaleModule : IAudioModule {
+        float scale = 1.0f;
+        int inits = 0;
+        void init(double, std::size_t) override { ++inits; }
+        void reset() override {}
+        void process(const AudioProcessContext& ctx) override {
+            for (uint32_t ch = 0; ch < ctx.numOut; ++ch) {
+                for (std::size_t i = 0; i < ctx.nframes; ++i) ctx.out[ch][i] = ctx.in[ch][i] * scale;
+            }
+        }
+        std::size_t getParamCount() const override { return 1; }
+        float getParam(std::size_t) const override { return scale; }
+        void setParam(std::size_t, float v) override { scale = v; }
+        const ParamMeta& getParamMeta(std::size_t) const override {
+            static const ParamMeta kMeta{};
+            return kMeta;
+        }
+    };
+
+    MockRtQueue q;
+    MockParamBridge p;
+    auto eng = avantgarde::MakeAudioEngine(&q, &p);
+    eng->setSampleRate(48000.0);
+
+    auto a = std::make_unique<ConstTrack>();
+    a->level = 0.5f;
+    a->sends[0] = 0.5f;
+    auto b = std::make_unique<ConstTrack>();
+    b->level = 0.25f;
+    b->sends[0] = 1.0f;
+    b->sends[1] = 1.0f; // bus 1 is not enabled
+    eng->registerTrack(std::move(a));
+    eng->registerTrack(std::move(b));
+
+    REQUIRE_FALSE(eng->setAuxBusCount(kMaxAuxBuses + 1));
+    REQUIRE(eng->setAuxBusCount(1));
+    auto mod = std::make_unique<ScaleModule>();
+    mod->scale = 0.5f;
+    auto* modPtr = mod.get();
+    REQUIRE_FALSE(eng->addAuxModule(1, std::make_unique<ScaleModule>()));
+    REQUIRE(eng->addAuxModule(0, std::move(mod)));
+    REQUIRE(modPtr->inits == 1);
+    REQUIRE(eng->getAuxModule(0, 0) == modPtr);
+    REQUIRE(eng->getAuxModule(0, 1) == nullptr);
+
+    // dry = 0.5 + 0.25; aux = (0.5 * 0.5 + 1.0 * 0.25) * 0.5
+    auto ctx = makeCtx(64);
+    eng->processBlock(ctx.ctx);
+    for (std::size_t i = 0; i < 64; ++i) {
+        REQUIRE(ctx.out0[i] == Catch::Approx(0.75f + 0.25f));
+        REQUIRE(ctx.out1[i] == Catch::Approx(0.75f + 0.25f));
+    }
+
+    // Aux FX params are addressable through RtCommand (track = kRtTrackAuxBase - bus).
+    RtCommand c{};
+    c.id = toWireCmdId(CmdId::ParamSet);
+    c.track = toRtAuxTrack(0);
+    c.slot = 0;
+    c.index = 0;
+    c.value = 1.0f;
+    REQUIRE(q.push(c));
+    auto ctx2 = makeCtx(64);
+    eng->processBlock(ctx2.ctx);
+    REQUIRE(modPtr->scale == 1.0f);
+    REQUIRE(ctx2.out0[0] == Catch::Approx(0.75f + 0.5f));
+
+    // Disabling the buses restores the plain mix.
+    REQUIRE(eng->setAuxBusCount(0));
+    auto ctx3 = makeCtx(64);
+    eng->processBlock(ctx3.ctx);
+    REQUIRE(ctx3.out0[0] == Catch::Approx(0.75f));
+}
+
+TEST_CASE("Meters: per-track and master peak/RMS are published each block") {
+    struct LevelTrack : MockTrack {
+        float level = 0.0f;
+        void process(const AudioProcessContext& ctx) override {
+            ++calls;
+            for (uint32_t ch = 0; ch < ctx.numOut; ++ch) {
+                for (std::size_t i = 0; i < ctx.nframes; ++i) {
+                    ctx.out[ch][i] += (i % 2 == 0) ? level : -level;
+                }
+            }
+        }
+    };
+
+    MockRtQueue q;
+    MockParamBridge p;
+    auto eng = avantgarde::MakeAudioEngine(&q, &p);
+    eng->setSampleRate(48000.0);
+    auto a = std::make_unique<LevelTrack>();
+    a->level = 0.5f;
+    auto b = std::make_unique<LevelTrack>();
+    b->level = 0.75f;
+    eng->registerTrack(std::move(a));
+    eng->registerTrack(std::move(b));
+
+    const EngineMeterFrame* before = eng->readMeters();
+    REQUIRE(before->blockIndex == 0);
+
+    auto ctx = makeCtx(64);
+    eng->processBlock(ctx.ctx);
+    const EngineMeterFrame* m = eng->readMeters();
+    REQUIRE(m->blockIndex == 1);
+    REQUIRE(m->trackCount == 2);
+    REQUIRE(m->tracks[0].peak == Catch::Approx(0.5f));
+    REQUIRE(m->tracks[0].rms == Catch::Approx(0.5f));
+    REQUIRE(m->tracks[1].peak == Catch::Approx(0.75f));
+    REQUIRE(m->master[0].peak == Catch::Approx(1.25f));
+    REQUIRE(m->master[1].rms == Catch::Approx(1.25f));
+    REQUIRE(m->limiterGain == 1.0f);
+
+    // The limiter keeps the (delayed) master under the ceiling.
+    MasterLimiterConfig cfg{};
+    cfg.enabled = true;
+    cfg.ceiling = 0.9f;
+    cfg.lookaheadMs = 0.5f;
+    REQUIRE(eng->setMasterLimiter(cfg));
+    for (int blk = 0; blk < 4; ++blk) {
+        auto c = makeCtx(64);
+        eng->processBlock(c.ctx);
+        for (std::size_t i = 0; i < 64; ++i) {
+            REQUIRE(std::fabs(c.out0[i]) <= 0.9f);
+        }
+    }
+    m = eng->readMeters();
+    REQUIRE(m->blockIndex == 5);
+    REQUIRE(m->limiterGain < 0.75f);
+    REQUIRE(m->master[0].peak <= 0.9f);
+}
+
+TEST_CASE("Idle path: silent tracks and decayed aux chains are not rendered") {
+    struct IdleTrack : MockTrack {
+        bool idle = true;
+        bool isIdleRt() noexcept override { return idle; }
+        void process(const AudioProcessContext& ctx) override {
+            ++calls;
+            if (idle) return;
+            for (uint32_t ch = 0; ch < ctx.numOut; ++ch) {
+                for (std::size_t i = 0; i < ctx.nframes; ++i) ctx.out[ch][i] += 0.5f;
+            }
+        }
+        float auxSendLevel(uint32_t bus) const noexcept override { return bus == 0 ? 1.0f : 0.0f; }
+    };
+    struct TailModule : IAudioModule {
+        int calls = 0;
+        void init(double, std::size_t) override {}
+        void reset() override {}
+        uint32_t tailFrames() const noexcept override { return 128; }
+        void process(const AudioProcessContext& ctx) override {
+            ++calls;
+            for (uint32_t ch = 0; ch < ctx.numOut; ++ch) {
+                for (std::size_t i = 0; i < ctx.nframes; ++i) ctx.out[ch][i] = ctx.in[ch][i];
+            }
+        }
+        std::size_t getParamCount() const override { return 0; }
+        float getParam(std::size_t) const override { return 0.0f; }
+        void setParam(std::size_t, float) override {}
+        const ParamMeta& getParamMeta(std::size_t) const override {
+            static const ParamMeta kMeta{};
+            return kMeta;
+        }
+    };
+
+    MockRtQueue q;
+    MockParamBridge p;
+    auto eng = avantgarde::MakeAudioEngine(&q, &p);
+    eng->setSampleRate(48000.0);
+    auto track = std::make_unique<IdleTrack>();
+    auto* trackPtr = track.get();
+    eng->registerTrack(std::move(track));
+    REQUIRE(eng->setAuxBusCount(1));
+    auto mod = std::make_unique<TailModule>();
+    auto* modPtr = mod.get();
+    REQUIRE(eng->addAuxModule(0, std::move(mod)));
+
+    auto run = [&]() {
+        auto ctx = makeCtx(64);
+        eng->processBlock(ctx.ctx);
+        return ctx.out0[0];
+    };
+
+    // A fresh aux chain has not proven silent yet: 128 frames of silence go through it,
+    // after that the engine stops rendering altogether.
+    for (int blk = 0; blk < 6; ++blk) {
+        REQUIRE(run() == 0.0f);
+    }
+    REQUIRE(trackPtr->calls == 2);
+    REQUIRE(modPtr->calls == 2);
+    REQUIRE(eng->readMeters()->trackCount == 1);
+    REQUIRE(eng->readMeters()->tracks[0].peak == 0.0f);
+
+    // Sound resumes: dry + aux return.
+    trackPtr->idle = false;
+    REQUIRE(run() == Catch::Approx(1.0f));
+    REQUIRE(trackPtr->calls == 3);
+    REQUIRE(modPtr->calls == 3);
+
+    // The aux tail is counted again from the last audible block.
+    trackPtr->idle = true;
+    for (int blk = 0; blk < 6; ++blk) {
+        REQUIRE(run() == 0.0f);
+    }
+    REQUIRE(trackPtr->calls == 5);
+    REQUIRE(modPtr->calls == 5);
+}
+
+TEST_CASE("Render-ahead: untouched tracks are rendered by the background worker, commands return them to RT") {
+    struct AdvancingTransport : MockTransportBridge {
+        void advanceSampleTime(uint64_t frames) noexcept override { snap.sampleTime += frames; }
+    };
+    // Output is a pure function of the position, so a track that was rendered ahead and
+    // rewound must reproduce the reference stream exactly.
+    struct AheadTrack : MockTrack {
+        bool aheadOk = true;
+        float gain = 0.0f;
+        double phase = 0.0;
+        std::atomic<int> rendered{0};
+        std::atomic<int> offThread{0};
+        std::thread::id rtThread = std::this_thread::get_id();
+        void process(const AudioProcessContext& ctx) override {
+            rendered.fetch_add(1);
+            if (std::this_thread::get_id() != rtThread) offThread.fetch_add(1);
+            for (std::size_t i = 0; i < ctx.nframes; ++i) {
+                const float v = gain * static_cast<float>(std::fmod(phase + static_cast<double>(i), 89.0) / 89.0);
+                ctx.out[0][i] += v;
+                if (ctx.numOut > 1) ctx.out[1][i] += -v;
+            }
+            phase += static_cast<double>(ctx.nframes);
+        }
+        bool canRenderAheadRt() noexcept override { return aheadOk; }
+        double renderPositionRt() const noexcept override { return phase; }
+        void seekRenderPositionRt(double position) noexcept override { phase = position; }
+    };
+
+    constexpr uint32_t kAhead = 4;
+    auto makeEngine = [](MockRtQueue& q, MockParamBridge& p, AdvancingTransport& tb, std::vector<AheadTrack*>& ptrs) {
+        auto eng = avantgarde::MakeAudioEngine(&q, &p);
+        eng->setSampleRate(48000.0);
+        eng->setTransportBridge(&tb);
+        for (int t = 0; t < 2; ++t) {
+            auto tr = std::make_unique<AheadTrack>();
+            tr->gain = 0.25f + 0.5f * static_cast<float>(t);
+            tr->aheadOk = (t == 0); // track 1 is "interactive" and stays in RT
+            ptrs.push_back(tr.get());
+            eng->registerTrack(std::move(tr));
+        }
+        return eng;
+    };
+
+    MockRtQueue qr, qa;
+    MockParamBridge pr, pa;
+    AdvancingTransport tr, ta;
+    std::vector<AheadTrack*> refTracks, aheadTracks;
+    auto ref = makeEngine(qr, pr, tr, refTracks);
+    auto ahead = makeEngine(qa, pa, ta, aheadTracks);
+    REQUIRE(ahead->setRenderAhead(kAhead));
+
+    // The worker is asynchronous: let it fill the ring before the next deadline.
+    auto waitRendered = [](AheadTrack* t, int expected) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (t->rendered.load() < expected && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return t->rendered.load();
+    };
+    auto runBlock = [&]() {
+        auto a = makeCtx(128);
+        auto b = makeCtx(128);
+        ref->processBlock(a.ctx);
+        ahead->processBlock(b.ctx);
+        for (std::size_t i = 0; i < a.out0.size(); ++i) {
+            REQUIRE(a.out0[i] == b.out0[i]);
+            REQUIRE(a.out1[i] == b.out1[i]);
+        }
+    };
+
+    // Hold period: the track must stay untouched for a few blocks before it is handed over.
+    constexpr int kHold = 8;
+    for (int blk = 1; blk <= kHold; ++blk) {
+        runBlock();
+    }
+    REQUIRE(waitRendered(aheadTracks[0], kHold + static_cast<int>(kAhead)) == kHold + static_cast<int>(kAhead));
+    for (int blk = 1; blk <= 12; ++blk) {
+        runBlock();
+        REQUIRE(waitRendered(aheadTracks[0], kHold + blk + static_cast<int>(kAhead)) ==
+                kHold + blk + static_cast<int>(kAhead));
+    }
+    REQUIRE(aheadTracks[0]->offThread.load() == 12 + static_cast<int>(kAhead));
+    REQUIRE(aheadTracks[1]->offThread.load() == 0);
+    REQUIRE(aheadTracks[1]->rendered.load() == kHold + 12);
+
+    // A ParamSet pulls the track back: rendered-ahead blocks are dropped, position rewinds.
+    RtCommand rc{};
+    rc.id = static_cast<uint16_t>(CmdId::ParamSet);
+    rc.track = 0;
+    rc.index = 3;
+    rc.value = 0.5f;
+    qr.push(rc);
+    qa.push(rc);
+    const int offBefore = aheadTracks[0]->offThread.load();
+    for (int blk = 0; blk < kHold - 1; ++blk) {
+        runBlock();
+    }
+    REQUIRE(aheadTracks[0]->seen.size() == 1);
+    REQUIRE(aheadTracks[0]->offThread.load() == offBefore);
+
+    // Untouched again: handed back to the worker, output still identical.
+    runBlock();
+    for (int blk = 0; blk < 6; ++blk) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        runBlock();
+    }
+    REQUIRE(aheadTracks[0]->offThread.load() > offBefore);
+}
@@ -0,0 +1,302 @@
+#include <catch2/catch_all.hpp>
+
+#include "contracts/IAudioEngine.h"
+#include "contracts/IAudioModule.h"
+#include "contracts/IParamBridge.h"
+#include "contracts/IRtCommandQueue.h"
+#include "contracts/ITrack.h"
+#include "contracts/types.h"
+#include "runtime/AudioGraph.h"
+#include "runtime/CompiledAudioGraph.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace avantgarde {
+std::unique_ptr<IAudioEngine> MakeAudioEngine(IRtCommandQueue*, IParamBridge*);
+}
+
+using namespace avantgarde;
+
+namespace {
+
+constexpr NodeKind kSource = static_cast<NodeKind>(GraphNodeKindValue::TrackSource);
+constexpr NodeKind kMix = static_cast<NodeKind>(GraphNodeKindValue::Mix);
+constexpr NodeKind kModule = static_cast<NodeKind>(GraphNodeKindValue::Module);
+constexpr NodeKind kMaster = static_cast<NodeKind>(GraphNodeKindValue::MasterOut);
+
+struct SawTrack : ITrack {
+    float gain = 1.0f;
+    uint64_t phase = 0;
+    int calls = 0;
+
+    bool healthcheck() const noexcept override { return true; }
+    void addModule(std::unique_ptr<IAudioModule>) override {}
+    IAudioModule* getModule(std::size_t) override { return nullptr; }
+    void onRtCommand(const RtCommand&) noexcept override {}
+    bool getSnapshot(SnapshotRecord& out) const noexcept override {
+        out = SnapshotRecord{};
+        return true;
+    }
+
+    void process(const AudioProcessContext& ctx) override {
+        ++calls;
+        for (std::size_t i = 0; i < ctx.nframes; ++i) {
+            const float v = gain * static_cast<float>((phase + i) % 61U) / 61.0f;
+            ctx.out[0][i] += v;
+            if (ctx.numOut > 1) ctx.out[1][i] += 0.25f * v;
+        }
+        phase += ctx.nframes;
+    }
+};
+
+struct GainModule : IAudioModule {
+    float gain = 0.5f;
+    int inits = 0;
+    double initRate = 0.0;
+    std::size_t initMaxFrames = 0;
+    void init(double sampleRate, std::size_t maxFrames) override {
+        ++inits;
+        initRate = sampleRate;
+        initMaxFrames = maxFrames;
+    }
+    void reset() override {}
+    void process(const AudioProcessContext& ctx) override {
+        for (uint32_t ch = 0; ch < ctx.numOut; ++ch) {
+            for (std::size_t i = 0; i < ctx.nframes; ++i) {
+                ctx.out[ch][i] = ctx.in[ch][i] * gain;
+            }
+        }
+    }
+    std::size_t getParamCount() const override { return 0; }
+    float getParam(std::size_t) const override { return 0.0f; }
+    void setParam(std::size_t, float) override {}
+    const ParamMeta& getParamMeta(std::size_t) const override {
+        static const ParamMeta kNoMeta{};
+        return kNoMeta;
+    }
+};
+
+struct Block {
+    std::vector<float> out0;
+    std::vector<float> out1;
+    float* outs[2];
+    AudioProcessContext ctx{};
+
+    explicit Block(std::size_t n) : out0(n, 0.0f), out1(n, 0.0f) {
+        outs[0] = out0.data();
+        outs[1] = out1.data();
+        ctx.in = nullptr;
+        ctx.out = outs;
+        ctx.nframes = n;
+        ctx.numOut = 2;
+    }
+};
+
+std::unique_ptr<IAudioEngine> makeEngine(int tracks, std::vector<SawTrack*>& ptrs) {
+    auto eng = MakeAudioEngine(nullptr, nullptr);
+    eng->setSampleRate(48000.0);
+    for (int t = 0; t < tracks; ++t) {
+        auto tr = std::make_unique<SawTrack>();
+        tr->gain = 0.2f + 0.11f * static_cast<float>(t);
+        ptrs.push_back(tr.get());
+        eng->registerTrack(std::move(tr));
+    }
+    return eng;
+}
+
+} // namespace
+
+TEST_CASE("AudioGraph: rejects cycles, self-loops, duplicates and dangling edges") {
+    AudioGraph g;
+    REQUIRE(g.addNode({1, kMix, 0}));
+    REQUIRE(g.addNode({2, kMix, 0}));
+    REQUIRE(g.addNode({3, kMix, 0}));
+    REQUIRE_FALSE(g.addNode({2, kMix, 0}));                     // duplicate id
+    REQUIRE_FALSE(g.addNode({4, kMix, kMaxParamsPerNode + 1}));  // param limit
+
+    REQUIRE(g.addEdge({1, 2}));
+    REQUIRE(g.addEdge({2, 3}));
+    REQUIRE_FALSE(g.addEdge({3, 1}));  // cycle
+    REQUIRE_FALSE(g.addEdge({2, 2}));  // self-loop
+    REQUIRE_FALSE(g.addEdge({1, 2}));  // duplicate edge
+    REQUIRE_FALSE(g.addEdge({1, 9}));  // unknown node
+    REQUIRE(g.edgeCount() == 2);
+
+    // Removing a node drops its edges.
+    REQUIRE(g.removeNode(2));
+    REQUIRE(g.nodeCount() == 2);
+    REQUIRE(g.edgeCount() == 0);
+    REQUIRE_FALSE(g.removeEdge(1, 2));
+}
+
+TEST_CASE("AudioGraph: setTopology sorts and getTopology returns a deterministic snapshot") {
+    GraphNodeDesc nodes[] = {{7, kMaster, 0}, {3, kSource, 0}, {5, kSource, 0}};
+    GraphEdgeDesc edges[] = {{5, 7}, {3, 7}};
+    uint16_t nn = 3, ne = 2;
+    AudioGraph g;
+    REQUIRE(g.setTopology(GraphTopoView{nodes, edges, &nn, &ne}));
+
+    GraphNodeDesc outNodes[4]{};
+    GraphEdgeDesc outEdges[4]{};
+    uint16_t cn = 4, ce = 4;
+    GraphTopoView view{outNodes, outEdges, &cn, &ce};
+    REQUIRE(g.getTopology(view));
+    REQUIRE(cn == 3);
+    REQUIRE(ce == 2);
+    REQUIRE(outNodes[0].id == 3);
+    REQUIRE(outNodes[1].id == 5);
+    REQUIRE(outNodes[2].id == 7);
+    REQUIRE(outEdges[0].fromId == 3);
+    REQUIRE(outEdges[1].fromId == 5);
+
+    uint16_t small = 1, ce2 = 4;
+    GraphTopoView tooSmall{outNodes, outEdges, &small, &ce2};
+    REQUIRE_FALSE(g.getTopology(tooSmall));
+}
+
+TEST_CASE("CompiledAudioGraph: validates bindings and master") {
+    AudioGraph g;
+    REQUIRE(g.addNode({1, kSource, 0}));
+    GraphCompileError err{};
+    REQUIRE(CompiledAudioGraph::compile(g, 1, 48000.0, {}, &err) == nullptr);
+    REQUIRE(err == GraphCompileError::UnboundTrack);
+
+    REQUIRE(g.bindTrack(1, 0));
+    REQUIRE(CompiledAudioGraph::compile(g, 1, 48000.0, {}, &err) == nullptr);
+    REQUIRE(err == GraphCompileError::NoMaster);
+
+    REQUIRE(g.addNode({9, kMaster, 0}));
+    REQUIRE(g.addEdge({1, 9}));
+    REQUIRE(CompiledAudioGraph::compile(g, 1, 48000.0, {}, &err) != nullptr);
+    REQUIRE(err == GraphCompileError::None);
+
+    REQUIRE(g.addNode({4, kModule, 0}));
+    REQUIRE(g.addEdge({1, 4}));
+    REQUIRE(g.addEdge({4, 9}));
+    REQUIRE(CompiledAudioGraph::compile(g, 1, 48000.0, {}, &err) == nullptr);
+    REQUIRE(err == GraphCompileError::UnboundModule);
+}
+
+TEST_CASE("CompiledAudioGraph: scratch buffers are reused by liveness") {
+    // 8 sources -> 4 pairwise mixes -> 2 mixes -> master.
+    AudioGraph g;
+    for (NodeId s = 0; s < 8; ++s) {
+        REQUIRE(g.addNode({static_cast<NodeId>(10 + s), kSource, 0}));
+        REQUIRE(g.bindTrack(static_cast<NodeId>(10 + s), s));
+    }
+    for (NodeId m = 0; m < 4; ++m) {
+        REQUIRE(g.addNode({static_cast<NodeId>(20 + m), kMix, 0}));
+        REQUIRE(g.addEdge({static_cast<NodeId>(10 + 2 * m), static_cast<NodeId>(20 + m)}));
+        REQUIRE(g.addEdge({static_cast<NodeId>(11 + 2 * m), static_cast<NodeId>(20 + m)}));
+    }
+    REQUIRE(g.addNode({30, kMix, 0}));
+    REQUIRE(g.addNode({31, kMix, 0}));
+    REQUIRE(g.addEdge({20, 30}));
+    REQUIRE(g.addEdge({21, 30}));
+    REQUIRE(g.addEdge({22, 31}));
+    REQUIRE(g.addEdge({23, 31}));
+    REQUIRE(g.addNode({40, kMaster, 0}));
+    REQUIRE(g.addEdge({30, 40}));
+    REQUIRE(g.addEdge({31, 40}));
+
+    auto compiled = CompiledAudioGraph::compile(g, 8, 48000.0);
+    REQUIRE(compiled != nullptr);
+    REQUIRE(compiled->stepCount() == 8 + 4 + 2 + 1);
+    // 14 producing nodes, but with in-place mixes only one buffer per tree level is live.
+    REQUIRE(compiled->bufferCount() == 4);
+}
+
+TEST_CASE("AudioEngine: graph routing matches fixed routing bit-exactly") {
+    constexpr int kTracks = 4;
+    std::vector<SawTrack*> fixedTracks, graphTracks;
+    auto fixed = makeEngine(kTracks, fixedTracks);
+    auto routed = makeEngine(kTracks, graphTracks);
+
+    AudioGraph g;
+    REQUIRE(g.addNode({100, kMaster, 0}));
+    for (NodeId t = 0; t < kTracks; ++t) {
+        REQUIRE(g.addNode({static_cast<NodeId>(1 + t), kSource, 0}));
+        REQUIRE(g.bindTrack(static_cast<NodeId>(1 + t), t));
+        REQUIRE(g.addEdge({static_cast<NodeId>(1 + t), 100}));
+    }
+    REQUIRE(routed->setRoutingGraph(&g));
+
+    for (int b = 0; b < 6; ++b) {
+        Block a(256), c(256);
+        fixed->processBlock(a.ctx);
+        routed->processBlock(c.ctx);
+        for (std::size_t i = 0; i < a.out0.size(); ++i) {
+            REQUIRE(a.out0[i] == c.out0[i]);
+            REQUIRE(a.out1[i] == c.out1[i]);
+        }
+    }
+
+    // Back to fixed routing at the next block boundary.
+    REQUIRE(routed->setRoutingGraph(nullptr));
+    Block a(128), c(128);
+    fixed->processBlock(a.ctx);
+    routed->processBlock(c.ctx);
+    REQUIRE(a.out0 == c.out0);
+    REQUIRE(graphTracks[0]->calls == 7);
+}
+
+TEST_CASE("AudioEngine: module node processes its bus and unrouted tracks still run") {
+    std::vector<SawTrack*> tracks;
+    auto eng = makeEngine(3, tracks);
+    auto gain = std::make_shared<GainModule>();
+    gain->gain = 0.5f;
+
+    // Track 0 -> gain -> master; track 1 -> dead-end mix (pruned); track 2 not in the graph.
+    AudioGraph g;
+    REQUIRE(g.addNode({1, kSource, 0}));
+    REQUIRE(g.addNode({2, kSource, 0}));
+    REQUIRE(g.addNode({5, kModule, 0}));
+    REQUIRE(g.addNode({6, kMix, 0}));
+    REQUIRE(g.addNode({9, kMaster, 0}));
+    REQUIRE(g.bindTrack(1, 0));
+    REQUIRE(g.bindTrack(2, 1));
+    REQUIRE(g.bindModule(5, gain));
+    REQUIRE(g.addEdge({1, 5}));
+    REQUIRE(g.addEdge({5, 9}));
+    REQUIRE(g.addEdge({2, 6}));
+    REQUIRE(eng->setRoutingGraph(&g));
+
+    // compile() prepared the module for the engine rate and the largest graph block.
+    REQUIRE(gain->inits == 1);
+    REQUIRE(gain->initRate == 48000.0);
+    REQUIRE(gain->initMaxFrames == CompiledAudioGraph::kMaxBlockFrames);
+
+    Block blk(64);
+    eng->processBlock(blk.ctx);
+
+    SawTrack ref;
+    ref.gain = tracks[0]->gain;
+    Block expected(64);
+    ref.process(expected.ctx);
+    for (std::size_t i = 0; i < 64; ++i) {
+        REQUIRE(blk.out0[i] == Catch::Approx(expected.out0[i] * 0.5f));
+        REQUIRE(blk.out1[i] == Catch::Approx(expected.out1[i] * 0.5f));
+    }
+    for (auto* t : tracks) {
+        REQUIRE(t->calls == 1);
+    }
+
+    // A failed compile keeps the current schedule.
+    AudioGraph broken;
+    REQUIRE(broken.addNode({1, kSource, 0}));
+    REQUIRE_FALSE(eng->setRoutingGraph(&broken));
+    Block blk2(64);
+    eng->processBlock(blk2.ctx);
+    REQUIRE(tracks[1]->calls == 2);
+
+    // Republishing a graph with a module that is already playing keeps its state;
+    // a new sample rate (before the stream restarts) re-inits it.
+    REQUIRE(eng->setRoutingGraph(&g));
+    REQUIRE(gain->inits == 1);
+    eng->setSampleRate(44100.0);
+    REQUIRE(gain->inits == 2);
+    REQUIRE(gain->initRate == 44100.0);
+}
@@ -0,0 +1,187 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "contracts/WavDecoder.h"
+#include "service/audio/AudioRecorder.h"
+
+using namespace avantgarde;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int kRate = 48000;
+constexpr int kBlock = 256;
+
+// Deterministic stereo test signal: a ramp on the left, a sine on the right.
+void fillBlock(int blockIndex, std::vector<float>& l, std::vector<float>& r) {
+    for (int i = 0; i < kBlock; ++i) {
+        const int frame = blockIndex * kBlock + i;
+        l[static_cast<std::size_t>(i)] = static_cast<float>((frame % 2000) - 1000) / 1100.0f;
+        r[static_cast<std::size_t>(i)] = 0.5f * static_cast<float>(std::sin(0.01 * frame));
+    }
+}
+
+std::vector<uint8_t> readBytes(const fs::path& p) {
+    std::ifstream in(p, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+bool containsTag(const std::vector<uint8_t>& bytes, const char* tag) {
+    for (std::size_t i = 0; i + 4 <= bytes.size(); ++i) {
+        if (std::memcmp(bytes.data() + i, tag, 4) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_CASE("AudioRecorder: master blocks round-trip through a 24-bit WAV with markers") {
+    const fs::path p = fs::temp_directory_path() / "avantgarde_recorder_s24.wav";
+    AudioRecorder rec;
+    RecordConfig cfg{};
+    cfg.sampleRate = kRate;
+    cfg.bitDepth = 24;
+    REQUIRE(rec.start(p.string(), cfg));
+    REQUIRE(rec.isRecording());
+    IRtRecordSink* sink = rec.rtSink();
+    REQUIRE(sink != nullptr);
+
+    // More than one 1 MiB write: the aligned flush path and the tail are both exercised.
+    constexpr int kBlocks = 600;
+    std::vector<float> l(kBlock), r(kBlock);
+    for (int b = 0; b < kBlocks; ++b) {
+        fillBlock(b, l, r);
+        const float* ch[2] = {l.data(), r.data()};
+        if (b == 10 || b == 400) {
+            sink->mark(static_cast<uint32_t>(b));
+        }
+        REQUIRE(sink->writeBlock(ch, kBlock));
+    }
+    rec.stop();
+    REQUIRE_FALSE(rec.isRecording());
+    REQUIRE(rec.lastError().empty());
+    REQUIRE(rec.droppedBlocks() == 0u);
+    REQUIRE(rec.totalFramesWritten() == static_cast<uint64_t>(kBlocks * kBlock));
+    REQUIRE_FALSE(rec.wroteRf64());
+
+    // Markers land on the file frame where they were set.
+    REQUIRE(rec.markers().size() == 2u);
+    REQUIRE(rec.markers()[0].frame == 10u * kBlock);
+    REQUIRE(rec.markers()[0].code == 10u);
+    REQUIRE(rec.markers()[1].frame == 400u * kBlock);
+
+    const std::vector<uint8_t> bytes = readBytes(p);
+    REQUIRE(std::memcmp(bytes.data(), "RIFF", 4) == 0);
+    REQUIRE(containsTag(bytes, "cue "));
+    REQUIRE(containsTag(bytes, "labl"));
+
+    WavDecodedPlanar decoded{};
+    std::string error;
+    REQUIRE(decodeWavFile(p.string(), decoded, &error));
+    REQUIRE(decoded.sampleRate == kRate);
+    REQUIRE(decoded.channels == 2);
+    REQUIRE(decoded.frames == kBlocks * kBlock);
+    for (int b = 0; b < kBlocks; ++b) {
+        fillBlock(b, l, r);
+        for (int i = 0; i < kBlock; ++i) {
+            const std::size_t at = static_cast<std::size_t>(b * kBlock + i);
+            REQUIRE(decoded.ch0[at] == Catch::Approx(l[static_cast<std::size_t>(i)]).margin(2e-7));
+            REQUIRE(decoded.ch1[at] == Catch::Approx(r[static_cast<std::size_t>(i)]).margin(2e-7));
+        }
+    }
+    fs::remove(p);
+}
+
+TEST_CASE("AudioRecorder: a full ring drops whole blocks instead of blocking") {
+    const fs::path p = fs::temp_directory_path() / "avantgarde_recorder_overflow.wav";
+    // ~10 ms ring: the writer, polling every 20 ms, cannot keep up with a burst.
+    AudioRecorder rec(0.01);
+    RecordConfig cfg{};
+    cfg.sampleRate = kRate;
+    cfg.bitDepth = 16;
+    REQUIRE(rec.start(p.string(), cfg));
+
+    constexpr int kBlocks = 400;
+    std::vector<float> l(kBlock), r(kBlock);
+    int rejected = 0;
+    for (int b = 0; b < kBlocks; ++b) {
+        fillBlock(b, l, r);
+        const float* ch[2] = {l.data(), r.data()};
+        if (!rec.rtSink()->writeBlock(ch, kBlock)) {
+            ++rejected;
+        }
+    }
+    rec.stop();
+    REQUIRE(rejected > 0);
+    REQUIRE(rec.droppedBlocks() == static_cast<uint64_t>(rejected));
+    REQUIRE(rec.totalFramesWritten() == static_cast<uint64_t>((kBlocks - rejected) * kBlock));
+
+    WavDecodedPlanar decoded{};
+    REQUIRE(decodeWavFile(p.string(), decoded));
+    REQUIRE(decoded.frames == (kBlocks - rejected) * kBlock);
+    fs::remove(p);
+
+    // Outside a recording the sink is a no-op.
+    const float* ch[2] = {l.data(), r.data()};
+    REQUIRE(rec.rtSink()->writeBlock(ch, kBlock));
+    REQUIRE(rec.droppedBlocks() == static_cast<uint64_t>(rejected));
+}
+
+TEST_CASE("AudioRecorder: rf64 float files decode bit-exact and bad configs are rejected") {
+    const fs::path p = fs::temp_directory_path() / "avantgarde_recorder_rf64.wav";
+    AudioRecorder rec;
+    RecordConfig cfg{};
+    cfg.sampleRate = kRate;
+    cfg.channels = 1;
+    cfg.bitDepth = 32;
+    cfg.format = "rf64";
+    REQUIRE(rec.start(p.string(), cfg));
+    std::vector<float> l(kBlock), r(kBlock);
+    for (int b = 0; b < 7; ++b) {
+        fillBlock(b, l, r);
+        const float* ch[2] = {l.data(), r.data()};
+        REQUIRE(rec.rtSink()->writeBlock(ch, kBlock));
+    }
+    rec.rtSink()->mark(42u);
+    rec.stop();
+    REQUIRE(rec.wroteRf64());
+
+    const std::vector<uint8_t> bytes = readBytes(p);
+    REQUIRE(std::memcmp(bytes.data(), "RF64", 4) == 0);
+    REQUIRE(std::memcmp(bytes.data() + 12, "ds64", 4) == 0);
+
+    WavDecodedPlanar decoded{};
+    std::string error;
+    REQUIRE(decodeWavFile(p.string(), decoded, &error));
+    REQUIRE(decoded.channels == 1);
+    REQUIRE(decoded.frames == 7 * kBlock);
+    for (int b = 0; b < 7; ++b) {
+        fillBlock(b, l, r);
+        for (int i = 0; i < kBlock; ++i) {
+            REQUIRE(decoded.ch0[static_cast<std::size_t>(b * kBlock + i)] == l[static_cast<std::size_t>(i)]);
+        }
+    }
+    REQUIRE(rec.markers().size() == 1u);
+    REQUIRE(rec.markers()[0].frame == 7u * kBlock);
+    fs::remove(p);
+
+    cfg.format = "flac";
+    REQUIRE_FALSE(rec.start(p.string(), cfg));
+    REQUIRE_FALSE(rec.lastError().empty());
+    cfg.format = "wav";
+    cfg.bitDepth = 20;
+    REQUIRE_FALSE(rec.start(p.string(), cfg));
+    REQUIRE_FALSE(rec.isRecording());
+}
@@ -288,3 +288,60 @@ TEST_CASE("BufferFx: buffer knob changes lookback depth (small vs large buffer d
 
     REQUIRE(maxAbsDiff(outFresh, outDeep) > 1e-3f);
 }
+
+TEST_CASE("BufferFx: reset output matches a freshly initialised module") {
+    // reset() leaves the ring to be cleared over the next blocks; the stale part must read as silence.
+    constexpr std::size_t kBlock = 256;
+    BufferFxModule used{};
+    BufferFxModule fresh{};
+    used.init(48000.0, kBlock);
+    fresh.init(48000.0, kBlock);
+    for (BufferFxModule* fx : {&used, &fresh}) {
+        fx->setParam(BufferFxModule::P_MIX, 1.0f);
+        fx->setParam(BufferFxModule::P_SLICE_SIZE, 1.0f);
+        fx->setParam(BufferFxModule::P_REPEAT, 0.8f);
+        fx->setParam(BufferFxModule::P_SPEED, 0.5f);
+        fx->setParam(BufferFxModule::P_BUFFER_SIZE, 1.0f); // deep lookback
+        fx->setParam(BufferFxModule::P_RETRIG, 0.0f); // retrig off: the first slice starts right away
+        fx->setParam(BufferFxModule::P_REVERSE, 1.0f); // reverse slices read ahead of the write head
+        fx->beginBlock();
+    }
+
+    std::vector<float> in(kBlock), outUsed(kBlock), outFresh(kBlock);
+    const float* inPtr[2] = {in.data(), in.data()};
+    float* usedPtr[2] = {outUsed.data(), outUsed.data()};
+    float* freshPtr[2] = {outFresh.data(), outFresh.data()};
+    AudioProcessContext ctx{};
+    ctx.in = inPtr;
+    ctx.nframes = kBlock;
+    ctx.transportValid = true;
+    ctx.transportPlaying = true;
+    ctx.transportBpm = 20.0f; // slowest tempo: a reverse 1/8-bar slice reads 72000 frames ahead
+    ctx.transportTsNum = 4;
+    ctx.transportTsDen = 4;
+
+    // Fill the whole 8 s ring with noise.
+    uint32_t seed = 0x12345678u;
+    ctx.out = usedPtr;
+    for (int b = 0; b < 1600; ++b) {
+        for (float& v : in) {
+            seed = seed * 1664525u + 1013904223u;
+            v = static_cast<float>(seed) / static_cast<float>(UINT32_MAX) * 2.0f - 1.0f;
+        }
+        ctx.transportSampleTime = static_cast<uint64_t>(b) * kBlock;
+        used.process(ctx);
+    }
+    used.reset();
+
+    for (int b = 0; b < 400; ++b) {
+        for (std::size_t i = 0; i < kBlock; ++i) {
+            in[i] = std::sin(2.0f * static_cast<float>(kPi) * static_cast<float>(b * kBlock + i) / 96.0f);
+        }
+        ctx.transportSampleTime = static_cast<uint64_t>(b) * kBlock;
+        ctx.out = usedPtr;
+        used.process(ctx);
+        ctx.out = freshPtr;
+        fresh.process(ctx);
+        REQUIRE(outUsed == outFresh);
+    }
+}
@@ -1,5 +1,8 @@
+#include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
@@ -9,6 +12,7 @@
 #include "contracts/ids.h"
 #include "contracts/types.h"
 #include "runtime/ClipTrack.cpp"
+#include "service/audio/ClipStream.h"
 #include "service/pattern/ClipBufferPool.h"
 
 namespace fs = std::filesystem;
@@ -98,6 +102,26 @@ void send_play(ClipTrackImpl& tr) {
     tr.onRtCommand(c);
 }
 
+void send_param(ClipTrackImpl& tr, TrackParamId id, float value) {
+    RtCommand c{};
+    c.id = toWireCmdId(CmdId::ParamSet);
+    c.track = 0;
+    c.slot = -1;
+    c.index = toParamIndex(id);
+    c.value = value;
+    tr.onRtCommand(c);
+}
+
+// Stereo ramp-like signal with distinct channels, so misplaced frames show up.
+std::vector<int16_t> make_stereo_signal(int frames) {
+    std::vector<int16_t> pcm(static_cast<std::size_t>(frames) * 2u);
+    for (int i = 0; i < frames; ++i) {
+        pcm[2u * i] = static_cast<int16_t>(((i * 37) % 2000 - 1000) * 16);
+        pcm[2u * i + 1u] = static_cast<int16_t>(((i * 11) % 3000 - 1500) * 8);
+    }
+    return pcm;
+}
+
 int count_non_zero(const std::vector<float>& v, float eps = 1e-5f) {
     int n = 0;
     for (float x : v) {
@@ -139,3 +163,325 @@ TEST_CASE("ClipBufferPool: bind fails for unknown ref") {
     REQUIRE_FALSE(pool.bindClipToTrack(tr, 0, 9999));
 }
 
+
+TEST_CASE("ClipStream: streamed loop over a trimmed region matches the decoded clip") {
+    const fs::path tmp = fs::temp_directory_path() / "avantgarde_pool_stream_loop.wav";
+    constexpr int kFrames = 40000;
+    write_wav_pcm16(tmp, 48000, 2, make_stereo_signal(kFrames));
+
+    ClipBufferPool pool{};
+    std::string err{};
+    REQUIRE(pool.loadFromFile(1, tmp.string(), &err));
+    SharedClipBuffer decoded{};
+    REQUIRE(pool.get(1, decoded));
+    REQUIRE(decoded.stream == nullptr);
+
+    SharedClipBuffer streamed{};
+    const auto stream = ClipStream::open(tmp.string(), 0.05, streamed, &err);
+    REQUIRE(stream);
+    REQUIRE(streamed.valid());
+    CHECK(streamed.frames == kFrames);
+    CHECK(streamed.residentFrames() == 2400);
+
+    ClipTrackImpl ref{48000.0};
+    ClipTrackImpl tr{48000.0};
+    REQUIRE(ref.loadSlotFromBuffer(0, decoded));
+    REQUIRE(tr.loadSlotFromBuffer(0, streamed));
+    for (ClipTrackImpl* t : {&ref, &tr}) {
+        REQUIRE(t->setSlotLooping(0, true));
+        // Region starts and ends well past the resident head.
+        send_param(*t, TrackParamId::StartNorm, 0.25f);
+        send_param(*t, TrackParamId::EndNorm, 0.75f);
+        send_play(*t);
+    }
+
+    auto a = make_ctx(256);
+    auto b = make_ctx(256);
+    // Nothing is prefetched before the first read: the first block misses.
+    ref.process(a.ctx);
+    tr.process(b.ctx);
+    const uint64_t firstMiss = stream->underruns();
+    CHECK(firstMiss > 0);
+
+    // ~5 passes through the 20000-frame loop, I/O serviced between blocks.
+    for (int block = 0; block < 400; ++block) {
+        while (stream->serviceIo()) {
+        }
+        std::fill(a.out0.begin(), a.out0.end(), 0.0f);
+        std::fill(a.out1.begin(), a.out1.end(), 0.0f);
+        std::fill(b.out0.begin(), b.out0.end(), 0.0f);
+        std::fill(b.out1.begin(), b.out1.end(), 0.0f);
+        ref.process(a.ctx);
+        tr.process(b.ctx);
+        for (std::size_t i = 0; i < a.out0.size(); ++i) {
+            REQUIRE(b.out0[i] == Catch::Approx(a.out0[i]).margin(1e-6));
+            REQUIRE(b.out1[i] == Catch::Approx(a.out1[i]).margin(1e-6));
+        }
+    }
+    CHECK(count_non_zero(b.out0) > 0);
+    CHECK(stream->underruns() == firstMiss);
+}
+
+TEST_CASE("ClipStream: missing frames play as silence and count as underruns") {
+    const fs::path tmp = fs::temp_directory_path() / "avantgarde_pool_stream_underrun.wav";
+    write_wav_pcm16(tmp, 48000, 2, make_stereo_signal(20000));
+
+    SharedClipBuffer streamed{};
+    std::string err{};
+    const auto stream = ClipStream::open(tmp.string(), 0.01, streamed, &err);
+    REQUIRE(stream);
+    REQUIRE(streamed.residentFrames() == 480);
+
+    ClipTrackImpl tr{48000.0};
+    REQUIRE(tr.loadSlotFromBuffer(0, streamed));
+    REQUIRE(tr.setSlotLooping(0, false));
+    send_play(tr);
+
+    // The head plays from memory; without I/O everything after it is silence.
+    auto tc = make_ctx(1024);
+    tr.process(tc.ctx);
+    CHECK(count_non_zero(std::vector<float>(tc.out0.begin(), tc.out0.begin() + 400)) > 0);
+    CHECK(count_non_zero(std::vector<float>(tc.out0.begin() + 600, tc.out0.end())) == 0);
+    CHECK(stream->underruns() > 0);
+}
+
+TEST_CASE("ClipBufferPool: setStreaming keeps only the head of long clips resident") {
+    const fs::path shortClip = fs::temp_directory_path() / "avantgarde_pool_stream_short.wav";
+    const fs::path longClip = fs::temp_directory_path() / "avantgarde_pool_stream_long.wav";
+    write_wav_pcm16(shortClip, 48000, 2, make_stereo_signal(2400));
+    write_wav_pcm16(longClip, 48000, 2, make_stereo_signal(48000));
+
+    ClipBufferPool pool{};
+    pool.setStreaming(0.5, 0.1);
+    std::string err{};
+    REQUIRE(pool.loadFromFile(1, shortClip.string(), &err));
+    REQUIRE(pool.loadFromFile(2, longClip.string(), &err));
+
+    SharedClipBuffer a{};
+    SharedClipBuffer b{};
+    REQUIRE(pool.get(1, a));
+    REQUIRE(pool.get(2, b));
+    CHECK(a.stream == nullptr);
+    CHECK(a.residentFrames() == 2400);
+    REQUIRE(b.stream != nullptr);
+    CHECK(b.frames == 48000);
+    CHECK(b.residentFrames() == 4800);
+
+    ClipTrackImpl tr{48000.0};
+    REQUIRE(pool.bindClipToTrack(tr, 0, 2));
+    CHECK(pool.streamUnderruns() == 0);
+}
+
+TEST_CASE("ClipBufferPool: int16 storage of a PCM16 clip plays exactly like float") {
+    const fs::path tmp = fs::temp_directory_path() / "avantgarde_pool_int16.wav";
+    constexpr int kFrames = 6000;
+    write_wav_pcm16(tmp, 48000, 2, make_stereo_signal(kFrames));
+
+    ClipBufferPool pool{};
+    std::string err{};
+    REQUIRE(pool.loadFromFile(1, tmp.string(), &err));
+    pool.setStorageFormat(ClipSampleFormat::Int16);
+    REQUIRE(pool.loadFromFile(2, tmp.string(), &err));
+    REQUIRE(pool.loadFromFile(3, tmp.string(), &err));
+    REQUIRE(pool.convertClip(3, ClipSampleFormat::Float16));
+
+    SharedClipBuffer packed{};
+    REQUIRE(pool.get(2, packed));
+    CHECK(packed.format == ClipSampleFormat::Int16);
+    CHECK(packed.ch0 == nullptr);
+    REQUIRE(packed.ch1Packed != nullptr);
+
+    // 44.1k host: non-unit increment through the gather path of the kernel.
+    ClipTrackImpl ref{44100.0};
+    ClipTrackImpl s16{44100.0};
+    ClipTrackImpl f16{44100.0};
+    REQUIRE(pool.bindClipToTrack(ref, 0, 1));
+    REQUIRE(pool.bindClipToTrack(s16, 0, 2));
+    REQUIRE(pool.bindClipToTrack(f16, 0, 3));
+    for (ClipTrackImpl* t : {&ref, &s16, &f16}) {
+        REQUIRE(t->setSlotLooping(0, true));
+        send_play(*t);
+    }
+
+    auto a = make_ctx(256);
+    auto b = make_ctx(256);
+    auto c = make_ctx(256);
+    for (int block = 0; block < 40; ++block) {
+        for (TestCtx* tc : {&a, &b, &c}) {
+            std::fill(tc->out0.begin(), tc->out0.end(), 0.0f);
+            std::fill(tc->out1.begin(), tc->out1.end(), 0.0f);
+        }
+        ref.process(a.ctx);
+        s16.process(b.ctx);
+        f16.process(c.ctx);
+        for (std::size_t i = 0; i < a.out0.size(); ++i) {
+            REQUIRE(b.out0[i] == a.out0[i]);
+            REQUIRE(b.out1[i] == a.out1[i]);
+            // Half keeps 11 significant bits of the |x| <= 0.5 signal.
+            REQUIRE(c.out0[i] == Catch::Approx(a.out0[i]).margin(1e-3));
+            REQUIRE(c.out1[i] == Catch::Approx(a.out1[i]).margin(1e-3));
+        }
+    }
+    CHECK(count_non_zero(b.out0) > 0);
+
+    // Back to float is lossless for the int16 clip.
+    REQUIRE(pool.convertClip(2, ClipSampleFormat::Float32));
+    SharedClipBuffer unpacked{};
+    SharedClipBuffer original{};
+    REQUIRE(pool.get(2, unpacked));
+    REQUIRE(pool.get(1, original));
+    for (int i = 0; i < kFrames; ++i) {
+        REQUIRE(unpacked.ch0[i] == original.ch0[i]);
+        REQUIRE(unpacked.ch1[i] == original.ch1[i]);
+    }
+    fs::remove(tmp);
+}
+
+TEST_CASE("ClipBufferPool: identical content under two paths shares one buffer") {
+    const fs::path a = fs::temp_directory_path() / "avantgarde_pool_dedup_a.wav";
+    const fs::path b = fs::temp_directory_path() / "avantgarde_pool_dedup_b.wav";
+    const fs::path c = fs::temp_directory_path() / "avantgarde_pool_dedup_c.wav";
+    write_wav_pcm16(a, 48000, 2, make_stereo_signal(3000));
+    write_wav_pcm16(b, 48000, 2, make_stereo_signal(3000));
+    auto other = make_stereo_signal(3000);
+    other[1234] = static_cast<int16_t>(other[1234] + 1);
+    write_wav_pcm16(c, 48000, 2, other);
+
+    ClipBufferPool pool{};
+    std::string err{};
+    REQUIRE(pool.loadFromFile(1, a.string(), &err));
+    REQUIRE(pool.loadFromFile(2, b.string(), &err));
+    REQUIRE(pool.loadFromFile(3, c.string(), &err));
+
+    SharedClipBuffer x{}, y{}, z{};
+    REQUIRE(pool.get(1, x));
+    REQUIRE(pool.get(2, y));
+    REQUIRE(pool.get(3, z));
+    CHECK(x.ch0 == y.ch0);
+    CHECK(x.ch0 != z.ch0);
+
+    const ClipPoolStats st = pool.stats();
+    CHECK(st.dedupHits == 1);
+    CHECK(st.clips == 3);
+    CHECK(st.buffers == 2);
+    CHECK(st.residentBytes == 2u * 3000u * 2u * sizeof(float));
+
+    // The shared buffer lives until its last clipRefId goes.
+    REQUIRE(pool.erase(1));
+    CHECK(pool.stats().residentBytes == 2u * 3000u * 2u * sizeof(float));
+    REQUIRE(pool.erase(2));
+    CHECK(pool.stats().residentBytes == 3000u * 2u * sizeof(float));
+
+    fs::remove(a);
+    fs::remove(b);
+    fs::remove(c);
+}
+
+TEST_CASE("ClipBufferPool: budget evicts least recently used clips that no track holds") {
+    constexpr int kFrames = 2000;
+    constexpr uint64_t kClipBytes = kFrames * 2u * sizeof(float);
+    std::vector<fs::path> paths;
+    for (int i = 0; i < 4; ++i) {
+        paths.push_back(fs::temp_directory_path() / ("avantgarde_pool_budget_" + std::to_string(i) + ".wav"));
+        auto pcm = make_stereo_signal(kFrames);
+        pcm[0] = static_cast<int16_t>(i); // distinct content, no dedup
+        write_wav_pcm16(paths.back(), 48000, 2, pcm);
+    }
+
+    ClipBufferPool pool{};
+    pool.setMemoryBudget(3 * kClipBytes);
+    std::string err{};
+    REQUIRE(pool.loadFromFile(1, paths[0].string(), &err));
+    REQUIRE(pool.loadFromFile(2, paths[1].string(), &err));
+    REQUIRE(pool.loadFromFile(3, paths[2].string(), &err));
+
+    // Clip 1 is the oldest but playing on a track; clip 2 is untouched since load.
+    ClipTrackImpl tr{48000.0};
+    REQUIRE(pool.bindClipToTrack(tr, 0, 1));
+    SharedClipBuffer tmp{};
+    REQUIRE(pool.get(3, tmp));
+    tmp = SharedClipBuffer{};
+
+    REQUIRE(pool.loadFromFile(4, paths[3].string(), &err));
+    CHECK(pool.contains(1));
+    CHECK_FALSE(pool.contains(2));
+    CHECK(pool.contains(3));
+    CHECK(pool.contains(4));
+    CHECK_FALSE(pool.get(2, tmp));
+
+    ClipPoolStats st = pool.stats();
+    CHECK(st.evictions == 1);
+    CHECK(st.misses == 1);
+    CHECK(st.hits == 2);
+    CHECK(st.residentBytes == 3 * kClipBytes);
+
+    // Everything else pinned or newest: shrinking the budget can only drop clips 3 and 4.
+    pool.setMemoryBudget(kClipBytes);
+    st = pool.stats();
+    CHECK(pool.contains(1));
+    CHECK(st.evictions == 3);
+    CHECK(st.residentBytes == kClipBytes);
+
+    for (const auto& p : paths) {
+        fs::remove(p);
+    }
+}
+
+TEST_CASE("ClipBufferPool: target sample rate converts 44.1k clips once at load") {
+    const fs::path tmp = fs::temp_directory_path() / "avantgarde_pool_src.wav";
+    constexpr int kFrames = 4410;
+    std::vector<int16_t> pcm(static_cast<std::size_t>(kFrames) * 2u);
+    for (int i = 0; i < kFrames; ++i) {
+        const double t = static_cast<double>(i) / 44100.0;
+        pcm[2u * i] = static_cast<int16_t>(12000.0 * std::sin(6.283185307179586 * 440.0 * t));
+        pcm[2u * i + 1u] = static_cast<int16_t>(-8000.0 * std::sin(6.283185307179586 * 1000.0 * t));
+    }
+    write_wav_pcm16(tmp, 44100, 2, pcm);
+
+    ClipBufferPool pool{};
+    pool.setTargetSampleRate(48000);
+    std::string err{};
+    REQUIRE(pool.loadFromFile(1, tmp.string(), &err));
+    SharedClipBuffer clip{};
+    REQUIRE(pool.get(1, clip));
+    REQUIRE(clip.sampleRate == 48000);
+    REQUIRE(clip.frames == 4800);
+    for (int i = 64; i < clip.frames - 64; ++i) {
+        const double t = static_cast<double>(i) / 48000.0;
+        REQUIRE(clip.ch0[i] == Catch::Approx(12000.0 / 32768.0 * std::sin(6.283185307179586 * 440.0 * t)).margin(2e-4));
+        REQUIRE(clip.ch1[i] == Catch::Approx(-8000.0 / 32768.0 * std::sin(6.283185307179586 * 1000.0 * t)).margin(2e-4));
+    }
+
+    // At the engine rate and speed 1.0 the track reads stored frames without interpolating.
+    ClipTrackImpl tr{48000.0};
+    REQUIRE(pool.bindClipToTrack(tr, 0, 1));
+    REQUIRE(tr.setSlotLooping(0, true));
+    send_play(tr);
+    auto tc = make_ctx(256);
+    for (int block = 0; block < 8; ++block) {
+        std::fill(tc.out0.begin(), tc.out0.end(), 0.0f);
+        std::fill(tc.out1.begin(), tc.out1.end(), 0.0f);
+        tr.process(tc.ctx);
+        if (block < 2) {
+            continue;
+        }
+        // Output is the stored sample times the track gain, frame for frame.
+        const int base = block * 256;
+        const float g0 = tc.out0[0] / clip.ch0[base];
+        const float g1 = tc.out1[0] / clip.ch1[base];
+        for (std::size_t i = 0; i < tc.out0.size(); ++i) {
+            REQUIRE(tc.out0[i] == Catch::Approx(g0 * clip.ch0[base + static_cast<int>(i)]).margin(1e-6));
+            REQUIRE(tc.out1[i] == Catch::Approx(g1 * clip.ch1[base + static_cast<int>(i)]).margin(1e-6));
+        }
+    }
+
+    // Clips already at the target rate are stored untouched.
+    ClipBufferPool native{};
+    native.setTargetSampleRate(44100);
+    REQUIRE(native.loadFromFile(1, tmp.string(), &err));
+    SharedClipBuffer same{};
+    REQUIRE(native.get(1, same));
+    REQUIRE(same.frames == kFrames);
+    REQUIRE(same.ch0[100] == static_cast<float>(pcm[200]) / 32768.0f);
+    fs::remove(tmp);
+}
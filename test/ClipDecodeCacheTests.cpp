@@ -0,0 +1,249 @@
+#include <catch2/catch_all.hpp>
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "service/audio/ClipDecodeCache.h"
+#include "service/audio/WavFileWriter.h"
+#include "service/pattern/ClipBufferPool.h"
+
+namespace fs = std::filesystem;
+using namespace avantgarde;
+
+namespace {
+
+fs::path writeSine(const std::string& name, std::size_t frames, float freq, int channels = 2) {
+    std::vector<float> l(frames), r(frames);
+    for (std::size_t i = 0; i < frames; ++i) {
+        l[i] = 0.5f * std::sin(freq * static_cast<float>(i));
+        r[i] = -0.25f * std::sin(freq * static_cast<float>(i));
+    }
+    const float* chs[2] = {l.data(), r.data()};
+    const fs::path path = fs::temp_directory_path() / name;
+    WavFileWriter writer;
+    std::string err;
+    REQUIRE(writer.open(path.string(), 48000, channels, WavSampleFormat::Pcm16, err));
+    REQUIRE(writer.write(chs, frames));
+    REQUIRE(writer.close(err));
+    return path;
+}
+
+fs::path freshCacheDir(const std::string& name) {
+    const fs::path dir = fs::temp_directory_path() / name;
+    fs::remove_all(dir);
+    return dir;
+}
+
+// Every page under [p, p + bytes) is in RAM right now.
+bool allResident(const void* p, std::size_t bytes) {
+    const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(p) / page * page;
+    const std::size_t len = reinterpret_cast<std::uintptr_t>(p) + bytes - begin;
+    std::vector<unsigned char> vec((len + page - 1) / page);
+    if (::mincore(reinterpret_cast<void*>(begin), len, vec.data()) != 0) {
+        return false;
+    }
+    for (unsigned char v : vec) {
+        if ((v & 1u) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("ClipDecodeCache: second pool load maps the decoded buffer instead of decoding") {
+    const fs::path wav = writeSine("ag_decode_cache_src.wav", 5000, 0.01f);
+    const fs::path dir = freshCacheDir("ag_decode_cache_hit");
+
+    ClipBufferPool first;
+    first.setDecodeCache(dir.string(), 0);
+    std::string err;
+    REQUIRE(first.loadFromFile(1, wav.string(), &err));
+    REQUIRE(first.decodeCache()->misses() == 1);
+    REQUIRE(first.decodeCache()->diskBytes() > 0);
+    SharedClipBuffer decoded{};
+    REQUIRE(first.get(1, decoded));
+
+    // A fresh pool (project reload) hits the cache.
+    ClipBufferPool second;
+    second.setDecodeCache(dir.string(), 0);
+    REQUIRE(second.loadFromFile(7, wav.string(), &err));
+    REQUIRE(second.decodeCache()->hits() == 1);
+    SharedClipBuffer mapped{};
+    REQUIRE(second.get(7, mapped));
+    REQUIRE(mapped.valid());
+    REQUIRE(mapped.sampleRate == decoded.sampleRate);
+    REQUIRE(mapped.channels == 2);
+    REQUIRE(mapped.frames == decoded.frames);
+    // Channel data starts on a page boundary of the mapping.
+    REQUIRE(reinterpret_cast<std::uintptr_t>(mapped.ch0.get()) % 4096u == 0u);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(mapped.ch1.get()) % 4096u == 0u);
+    for (int i = 0; i < decoded.frames; ++i) {
+        REQUIRE(mapped.ch0[i] == decoded.ch0[i]);
+        REQUIRE(mapped.ch1[i] == decoded.ch1[i]);
+    }
+
+    // The mapping outlives the pool entry and the cache file.
+    second.erase(7);
+    fs::remove_all(dir);
+    REQUIRE(mapped.ch0[100] == decoded.ch0[100]);
+    fs::remove(wav);
+}
+
+TEST_CASE("ClipDecodeCache: rewritten source misses and gets a new entry") {
+    const fs::path dir = freshCacheDir("ag_decode_cache_rewrite");
+    ClipDecodeCache cache(dir.string(), 0);
+
+    const fs::path wav = writeSine("ag_decode_cache_rewrite.wav", 3000, 0.01f, 1);
+    ClipBufferPool pool;
+    std::string err;
+    REQUIRE(pool.loadFromFile(1, wav.string(), &err));
+    SharedClipBuffer a{};
+    REQUIRE(pool.get(1, a));
+    REQUIRE(cache.store(wav.string(), a));
+
+    SharedClipBuffer out{};
+    REQUIRE(cache.load(wav.string(), out));
+    REQUIRE(out.channels == 1);
+    REQUIRE(out.ch1 == nullptr);
+
+    // Same length, different content.
+    (void)writeSine("ag_decode_cache_rewrite.wav", 3000, 0.02f, 1);
+    REQUIRE_FALSE(cache.load(wav.string(), out));
+    REQUIRE(cache.misses() == 1);
+    fs::remove(wav);
+    fs::remove_all(dir);
+}
+
+TEST_CASE("ClipDecodeCache: size cap evicts the least recently used entries") {
+    const fs::path dir = freshCacheDir("ag_decode_cache_evict");
+    std::vector<fs::path> wavs;
+    std::vector<SharedClipBuffer> clips;
+    ClipBufferPool pool;
+    std::string err;
+    for (int i = 0; i < 4; ++i) {
+        wavs.push_back(writeSine("ag_decode_cache_evict_" + std::to_string(i) + ".wav", 4000,
+                                 0.01f * static_cast<float>(i + 1), 1));
+        REQUIRE(pool.loadFromFile(static_cast<uint32_t>(i + 1), wavs.back().string(), &err));
+        clips.emplace_back();
+        REQUIRE(pool.get(static_cast<uint32_t>(i + 1), clips.back()));
+    }
+
+    // One mono entry: a header page plus one page-aligned channel.
+    ClipDecodeCache probe(dir.string(), 0);
+    REQUIRE(probe.store(wavs[0].string(), clips[0]));
+    const uint64_t entryBytes = probe.diskBytes();
+    fs::remove_all(dir);
+
+    ClipDecodeCache cache(dir.string(), entryBytes * 2);
+    REQUIRE(cache.store(wavs[0].string(), clips[0]));
+    REQUIRE(cache.store(wavs[1].string(), clips[1]));
+    // Touch clip 0 so clip 1 becomes the oldest.
+    const auto past = fs::file_time_type::clock::now() - std::chrono::hours(1);
+    for (const auto& e : fs::directory_iterator(dir)) {
+        fs::last_write_time(e.path(), past);
+    }
+    SharedClipBuffer out{};
+    REQUIRE(cache.load(wavs[0].string(), out));
+    REQUIRE(cache.store(wavs[2].string(), clips[2]));
+
+    REQUIRE(cache.diskBytes() <= entryBytes * 2);
+    REQUIRE(cache.load(wavs[0].string(), out));
+    REQUIRE(cache.load(wavs[2].string(), out));
+    REQUIRE_FALSE(cache.load(wavs[1].string(), out));
+
+    for (const auto& w : wavs) {
+        fs::remove(w);
+    }
+    fs::remove_all(dir);
+}
+
+TEST_CASE("ClipDecodeCache: int16 clips are cached packed and converted on format mismatch") {
+    const fs::path wav = writeSine("ag_decode_cache_s16.wav", 5000, 0.01f);
+    const fs::path dir = freshCacheDir("ag_decode_cache_s16");
+    std::string err;
+
+    ClipBufferPool first;
+    first.setDecodeCache(dir.string(), 0);
+    first.setStorageFormat(ClipSampleFormat::Int16);
+    REQUIRE(first.loadFromFile(1, wav.string(), &err));
+    SharedClipBuffer packed{};
+    REQUIRE(first.get(1, packed));
+    // Half the float entry: a header page plus two page-aligned int16 channels.
+    REQUIRE(first.decodeCache()->diskBytes() == 3u * 16384u);
+
+    ClipBufferPool second;
+    second.setDecodeCache(dir.string(), 0);
+    second.setStorageFormat(ClipSampleFormat::Int16);
+    REQUIRE(second.loadFromFile(1, wav.string(), &err));
+    REQUIRE(second.decodeCache()->hits() == 1);
+    SharedClipBuffer mapped{};
+    REQUIRE(second.get(1, mapped));
+    REQUIRE(mapped.format == ClipSampleFormat::Int16);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(mapped.ch1Packed.get()) % 4096u == 0u);
+    for (int i = 0; i < packed.frames; ++i) {
+        REQUIRE(mapped.ch0Packed[i] == packed.ch0Packed[i]);
+        REQUIRE(mapped.ch1Packed[i] == packed.ch1Packed[i]);
+    }
+
+    // A float pool still hits and gets the exact PCM16 values back.
+    ClipBufferPool third;
+    third.setDecodeCache(dir.string(), 0);
+    REQUIRE(third.loadFromFile(1, wav.string(), &err));
+    REQUIRE(third.decodeCache()->hits() == 1);
+    SharedClipBuffer floats{};
+    REQUIRE(third.get(1, floats));
+    REQUIRE(floats.format == ClipSampleFormat::Float32);
+    REQUIRE(floats.ch0[100] == static_cast<float>(packed.ch0Packed[100]) / 32768.0f);
+
+    fs::remove(wav);
+    fs::remove_all(dir);
+}
+
+TEST_CASE("ClipDecodeCache: hits are resident before the audio thread reads them") {
+    const fs::path wav = writeSine("ag_decode_cache_resident.wav", 200000, 0.02f);
+    const fs::path dir = freshCacheDir("ag_decode_cache_resident");
+    std::string err;
+    SharedClipBuffer decoded{};
+    {
+        ClipBufferPool warm;
+        warm.setDecodeCache(dir.string(), 0);
+        REQUIRE(warm.loadFromFile(1, wav.string(), &err));
+        REQUIRE(warm.get(1, decoded));
+    }
+
+    // Locked mapping when allowed, else (RLIMIT_MEMLOCK == 0 without CAP_IPC_LOCK)
+    // the anonymous copy: both paths must hand out resident, identical data.
+    for (const bool restrictLock : {false, true}) {
+        rlimit saved{};
+        REQUIRE(::getrlimit(RLIMIT_MEMLOCK, &saved) == 0);
+        if (restrictLock) {
+            rlimit none = saved;
+            none.rlim_cur = 0;
+            REQUIRE(::setrlimit(RLIMIT_MEMLOCK, &none) == 0);
+        }
+        ClipDecodeCache cache(dir.string(), 0);
+        SharedClipBuffer mapped{};
+        const bool hit = cache.load(wav.string(), mapped);
+        REQUIRE(::setrlimit(RLIMIT_MEMLOCK, &saved) == 0);
+        REQUIRE(hit);
+        REQUIRE(mapped.frames == decoded.frames);
+        const std::size_t bytes = static_cast<std::size_t>(mapped.frames) * sizeof(float);
+        REQUIRE(allResident(mapped.ch0.get(), bytes));
+        REQUIRE(allResident(mapped.ch1.get(), bytes));
+        REQUIRE(std::memcmp(mapped.ch0.get(), decoded.ch0.get(), bytes) == 0);
+        REQUIRE(std::memcmp(mapped.ch1.get(), decoded.ch1.get(), bytes) == 0);
+    }
+    fs::remove_all(dir);
+    fs::remove(wav);
+}
@@ -0,0 +1,163 @@
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "service/audio/ClipLoader.h"
+#include "service/audio/WavFileWriter.h"
+#include "service/pattern/ClipBufferPool.h"
+
+namespace fs = std::filesystem;
+using namespace avantgarde;
+
+namespace {
+
+fs::path writeSine(const std::string& name, std::size_t frames, float freq) {
+    std::vector<float> l(frames), r(frames);
+    for (std::size_t i = 0; i < frames; ++i) {
+        l[i] = 0.5f * std::sin(freq * static_cast<float>(i));
+        r[i] = -0.25f * std::sin(freq * static_cast<float>(i));
+    }
+    const float* chs[2] = {l.data(), r.data()};
+    const fs::path path = fs::temp_directory_path() / name;
+    WavFileWriter writer;
+    std::string err;
+    REQUIRE(writer.open(path.string(), 48000, 2, WavSampleFormat::Pcm16, err));
+    REQUIRE(writer.write(chs, frames));
+    REQUIRE(writer.close(err));
+    return path;
+}
+
+// Polls like the control loop does, with a generous deadline for slow CI.
+std::vector<ClipLoadCompletion> drain(ClipLoader& loader, std::size_t expected) {
+    std::vector<ClipLoadCompletion> out;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (out.size() < expected && std::chrono::steady_clock::now() < deadline) {
+        ClipLoadCompletion c{};
+        if (loader.poll(c)) {
+            out.push_back(std::move(c));
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("ClipLoader: completions carry the job result and failures") {
+    ClipLoader loader(2);
+    const uint64_t ok = loader.submit("a.wav", [](const std::string& path, ClipLoadResult& r, const std::atomic<bool>&) {
+        r.sourceBpm = (path == "a.wav") ? 120.0f : 0.0f;
+        return true;
+    });
+    const uint64_t bad = loader.submit("b.wav", [](const std::string&, ClipLoadResult& r, const std::atomic<bool>&) {
+        r.error = "broken";
+        return false;
+    });
+    REQUIRE(ok != bad);
+
+    const auto done = drain(loader, 2);
+    REQUIRE(done.size() == 2);
+    for (const auto& c : done) {
+        if (c.ticket == ok) {
+            REQUIRE(c.ok);
+            REQUIRE(c.path == "a.wav");
+            REQUIRE(c.result.sourceBpm == 120.0f);
+        } else {
+            REQUIRE(c.ticket == bad);
+            REQUIRE_FALSE(c.ok);
+            REQUIRE(c.result.error == "broken");
+        }
+    }
+    REQUIRE(loader.state(ok) == ClipLoadState::None);
+    REQUIRE(loader.inFlight() == 0);
+}
+
+TEST_CASE("ClipLoader: cancelled tickets never complete") {
+    ClipLoader loader(1);
+    std::atomic<bool> started{false};
+    std::atomic<bool> sawCancel{false};
+    const uint64_t busy = loader.submit("busy.wav", [&](const std::string&, ClipLoadResult&,
+                                                       const std::atomic<bool>& cancelled) {
+        started = true;
+        while (!cancelled.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        sawCancel = true;
+        return true;
+    });
+    std::atomic<int> queuedRuns{0};
+    const uint64_t queued = loader.submit("queued.wav", [&](const std::string&, ClipLoadResult&,
+                                                           const std::atomic<bool>&) {
+        ++queuedRuns;
+        return true;
+    });
+    while (!started.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(loader.state(busy) == ClipLoadState::Decoding);
+    REQUIRE(loader.state(queued) == ClipLoadState::Queued);
+
+    // Queued job is dropped outright, the running one is told to stop and its result is discarded.
+    REQUIRE(loader.cancel(queued));
+    REQUIRE(loader.cancel(busy));
+    REQUIRE_FALSE(loader.cancel(busy));
+    const uint64_t after = loader.submit("after.wav", [](const std::string&, ClipLoadResult&,
+                                                         const std::atomic<bool>&) { return true; });
+
+    const auto done = drain(loader, 1);
+    REQUIRE(done.size() == 1);
+    REQUIRE(done[0].ticket == after);
+    ClipLoadCompletion extra{};
+    REQUIRE_FALSE(loader.poll(extra));
+    REQUIRE(queuedRuns.load() == 0);
+    REQUIRE(sawCancel.load());
+}
+
+TEST_CASE("ClipLoader: workers decode files in parallel through the pool") {
+    std::vector<fs::path> wavs;
+    for (int i = 0; i < 4; ++i) {
+        wavs.push_back(writeSine("ag_clip_loader_" + std::to_string(i) + ".wav", 6000,
+                                 0.01f * static_cast<float>(i + 1)));
+    }
+    ClipBufferPool pool;
+    ClipLoader loader(3);
+    for (const auto& w : wavs) {
+        (void)loader.submit(w.string(), [&pool](const std::string& path, ClipLoadResult& r,
+                                                      const std::atomic<bool>& cancelled) {
+            return pool.decodeFile(path, r.buffer, &r.error, &cancelled);
+        });
+    }
+    const auto done = drain(loader, wavs.size());
+    REQUIRE(done.size() == wavs.size());
+
+    // Only the control thread touches the pool: insert the decoded buffers here.
+    uint32_t ref = 1;
+    for (const auto& c : done) {
+        REQUIRE(c.ok);
+        REQUIRE(c.result.buffer.frames == 6000);
+        REQUIRE(c.result.buffer.channels == 2);
+        REQUIRE(pool.put(ref++, c.result.buffer));
+    }
+    REQUIRE(pool.stats().buffers == wavs.size());
+
+    ClipLoadResult missing{};
+    REQUIRE_FALSE(pool.decodeFile("/nonexistent/ag_clip_loader.wav", missing.buffer, &missing.error));
+    REQUIRE_FALSE(missing.error.empty());
+
+    // A raised cancel flag stops the decode before it reads the data chunk.
+    const std::atomic<bool> cancelled{true};
+    ClipLoadResult aborted{};
+    REQUIRE_FALSE(pool.decodeFile(wavs[0].string(), aborted.buffer, &aborted.error, &cancelled));
+    REQUIRE(aborted.error == "cancelled");
+    REQUIRE_FALSE(aborted.buffer.valid());
+    for (const auto& w : wavs) {
+        fs::remove(w);
+    }
+}
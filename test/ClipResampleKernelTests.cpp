@@ -0,0 +1,169 @@
+#include <catch2/catch_all.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "runtime/ClipTrack.cpp"
+
+using namespace avantgarde;
+
+namespace {
+
+std::vector<float> makeSignal(int len, float phase) {
+    std::vector<float> s(static_cast<std::size_t>(len));
+    for (int i = 0; i < len; ++i) {
+        s[static_cast<std::size_t>(i)] = std::sin(0.037f * static_cast<float>(i) + phase) *
+                                         (0.5f + 0.25f * std::cos(0.011f * static_cast<float>(i)));
+    }
+    return s;
+}
+
+// Scalar reference: same formula ClipTrack used before the kernel.
+template <bool Stereo>
+void renderReference(const std::vector<float>& a,
+                     const std::vector<float>& b,
+                     double ph,
+                     double inc,
+                     float gain,
+                     std::size_t n,
+                     std::vector<float>& out0,
+                     std::vector<float>& out1) {
+    const int len = static_cast<int>(a.size());
+    for (std::size_t k = 0; k < n; ++k) {
+        const float s0 = detail_interp::sampleCubic(a.data(), len, ph, false);
+        const float s1 = Stereo ? detail_interp::sampleCubic(b.data(), len, ph, false) : s0;
+        out0[k] = s0 * gain;
+        out1[k] = s1 * gain;
+        ph += inc;
+    }
+}
+
+template <bool Stereo>
+void checkKernelMatchesScalar(double ph0, double inc) {
+    const int len = 4096;
+    const auto a = makeSignal(len, 0.0f);
+    const auto b = makeSignal(len, 1.3f);
+    const std::size_t n = 1000;
+    const float gain = 0.8f;
+
+    std::vector<float> ref0(n), ref1(n), out0(n), out1(n);
+    renderReference<Stereo>(a, b, ph0, inc, gain, n, ref0, ref1);
+
+    clip_kernel::CubicRun r{};
+    r.c0 = a.data();
+    r.c1 = Stereo ? b.data() : a.data();
+    r.inc = inc;
+    r.gain = gain;
+    r.out0 = out0.data();
+    r.out1 = out1.data();
+    double ph = ph0;
+    clip_kernel::renderCubicRun<Stereo, false>(r, ph, n);
+
+    REQUIRE(ph == Catch::Approx(ph0 + inc * static_cast<double>(n)));
+    for (std::size_t k = 0; k < n; ++k) {
+        REQUIRE(out0[k] == Catch::Approx(ref0[k]).margin(1e-6));
+        REQUIRE(out1[k] == Catch::Approx(ref1[k]).margin(1e-6));
+    }
+}
+
+// Packed storage: the kernel must produce what the float path produces on the decoded samples.
+template <typename S>
+void checkPackedKernelMatchesScalar(double ph0, double inc, S (*encode)(float), float (*decode)(S)) {
+    const int len = 4096;
+    const auto a = makeSignal(len, 0.0f);
+    const auto b = makeSignal(len, 1.3f);
+    std::vector<S> pa(a.size()), pb(b.size());
+    std::vector<float> da(a.size()), db(b.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        pa[i] = encode(a[i]);
+        pb[i] = encode(b[i]);
+        da[i] = decode(pa[i]);
+        db[i] = decode(pb[i]);
+    }
+    const std::size_t n = 1000;
+    std::vector<float> ref0(n), ref1(n), out0(n), out1(n);
+    renderReference<true>(da, db, ph0, inc, 0.8f, n, ref0, ref1);
+
+    clip_kernel::CubicRunT<S> r{};
+    r.c0 = pa.data();
+    r.c1 = pb.data();
+    r.inc = inc;
+    r.gain = 0.8f;
+    r.out0 = out0.data();
+    r.out1 = out1.data();
+    double ph = ph0;
+    clip_kernel::renderCubicRun<true, false>(r, ph, n);
+    for (std::size_t k = 0; k < n; ++k) {
+        REQUIRE(out0[k] == Catch::Approx(ref0[k]).margin(1e-6));
+        REQUIRE(out1[k] == Catch::Approx(ref1[k]).margin(1e-6));
+    }
+}
+
+int16_t encodeInt16(float x) { return clipSampleToInt16(x); }
+float decodeInt16(int16_t v) { return clipSampleFromInt16(v); }
+uint16_t encodeHalf(float x) { return clipSampleToHalf(x); }
+float decodeHalf(uint16_t v) { return clipSampleFromHalf(v); }
+
+} // namespace
+
+TEST_CASE("ClipResampleKernel: matches scalar cubic Hermite for arbitrary increments") {
+    checkKernelMatchesScalar<false>(3.25, 0.918);
+    checkKernelMatchesScalar<true>(3.25, 0.918);
+    checkKernelMatchesScalar<true>(17.7, 1.5);
+}
+
+TEST_CASE("ClipResampleKernel: unit increment uses FIR and exact copy fast paths") {
+    checkKernelMatchesScalar<false>(10.0, 1.0);  // frac == 0 -> copy * gain
+    checkKernelMatchesScalar<true>(10.0, 1.0);
+    checkKernelMatchesScalar<true>(10.375, 1.0); // constant frac -> 4-tap FIR
+}
+
+TEST_CASE("ClipResampleKernel: fade ramp follows (num0 + step * k) / den") {
+    const std::vector<float> ones(64, 1.0f);
+    std::vector<float> out0(16), out1(16);
+
+    clip_kernel::CubicRun r{};
+    r.c0 = ones.data();
+    r.c1 = ones.data();
+    r.inc = 1.0;
+    r.gain = 0.5f;
+    r.fadeNum0 = 1;
+    r.fadeStep = 1;
+    r.fadeDen = 16.0f;
+    r.out0 = out0.data();
+    r.out1 = out1.data();
+    double ph = 4.0;
+    clip_kernel::renderCubicRun<false, true>(r, ph, 16);
+
+    for (std::size_t k = 0; k < 16; ++k) {
+        const float expected = 0.5f * static_cast<float>(k + 1) / 16.0f;
+        REQUIRE(out0[k] == Catch::Approx(expected).margin(1e-7));
+        REQUIRE(out1[k] == out0[k]);
+    }
+}
+
+TEST_CASE("ClipResampleKernel: int16 and half storage convert inside the kernel") {
+    for (const double inc : {0.918, 1.0, 1.5}) {
+        checkPackedKernelMatchesScalar<int16_t>(10.375, inc, encodeInt16, decodeInt16);
+        checkPackedKernelMatchesScalar<uint16_t>(10.375, inc, encodeHalf, decodeHalf);
+    }
+    checkPackedKernelMatchesScalar<int16_t>(10.0, 1.0, encodeInt16, decodeInt16);
+    checkPackedKernelMatchesScalar<uint16_t>(10.0, 1.0, encodeHalf, decodeHalf);
+}
+
+TEST_CASE("ClipSampleFormat: half round trip keeps 11 significant bits") {
+    REQUIRE(clipSampleFromHalf(clipSampleToHalf(0.0f)) == 0.0f);
+    REQUIRE(clipSampleFromHalf(clipSampleToHalf(1.0f)) == 1.0f);
+    REQUIRE(clipSampleFromHalf(clipSampleToHalf(-0.5f)) == -0.5f);
+    // Subnormal halves (below 2^-14) are representable too.
+    REQUIRE(clipSampleFromHalf(clipSampleToHalf(0x1p-20f)) == 0x1p-20f);
+    for (int i = -1000; i <= 1000; ++i) {
+        const float x = 0.000997f * static_cast<float>(i);
+        const float y = clipSampleFromHalf(clipSampleToHalf(x));
+        REQUIRE(std::fabs(y - x) <= std::max(std::fabs(x) * 0x1p-11f, 0x1p-25f));
+    }
+    REQUIRE(clipSampleToInt16(1.5f) == 32767);
+    REQUIRE(clipSampleToInt16(-1.0f) == -32768);
+}
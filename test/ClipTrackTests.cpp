@@ -1,6 +1,8 @@
 // test/test_cliptrack.cpp
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
@@ -181,6 +183,58 @@ namespace {
         }
     };
 
+    // Pass-through FX with a declared tail; counts process() calls.
+    struct TailCountingFx final : avantgarde::IAudioModule {
+        uint32_t tail{avantgarde::IAudioModule::kInfiniteTailFrames};
+        int calls{0};
+        avantgarde::ParamMeta meta{"noop", 0.0f, 1.0f, false, ""};
+
+        void init(double, std::size_t) override {}
+        void reset() override {}
+        uint32_t tailFrames() const noexcept override { return tail; }
+        std::size_t getParamCount() const override { return 0; }
+        float getParam(std::size_t) const override { return 0.0f; }
+        void setParam(std::size_t, float) override {}
+        const avantgarde::ParamMeta& getParamMeta(std::size_t) const override { return meta; }
+
+        void process(const avantgarde::AudioProcessContext& ctx) override {
+            ++calls;
+            for (std::size_t i = 0; i < ctx.nframes; ++i) {
+                ctx.out[0][i] = ctx.in[0][i];
+                ctx.out[1][i] = ctx.in[1][i];
+            }
+        }
+    };
+
+    // Pass-through FX that owns a ring buffer and counts init()/reset() calls.
+    struct LifecycleFx final : avantgarde::IAudioModule {
+        int inits{0};
+        int resets{0};
+        std::vector<float> ring{};
+        avantgarde::ParamMeta meta{"noop", 0.0f, 1.0f, false, ""};
+
+        void init(double sampleRate, std::size_t) override {
+            ++inits;
+            ring.assign(static_cast<std::size_t>(sampleRate), 0.0f);
+        }
+        void reset() override {
+            ++resets;
+            std::fill(ring.begin(), ring.end(), 0.0f);
+        }
+        std::size_t getParamCount() const override { return 0; }
+        float getParam(std::size_t) const override { return 0.0f; }
+        void setParam(std::size_t, float) override {}
+        const avantgarde::ParamMeta& getParamMeta(std::size_t) const override { return meta; }
+
+        void process(const avantgarde::AudioProcessContext& ctx) override {
+            for (std::size_t i = 0; i < ctx.nframes; ++i) {
+                ring[i % ring.size()] = ctx.in[0][i];
+                ctx.out[0][i] = ctx.in[0][i];
+                ctx.out[1][i] = ctx.in[1][i];
+            }
+        }
+    };
+
 } // namespace
 
 // -------------------------
@@ -689,10 +743,16 @@ TEST_CASE("ClipTrack: clearSlot resets audio (no playback after clear)") {
 TEST_CASE("ClipTrack: IParameterized surface exposes and applies track params") {
     avantgarde::ClipTrackImpl tr;
 
-    REQUIRE(tr.getParamCount() == 13);
+    REQUIRE(tr.getParamCount() == 18);
     REQUIRE(tr.getParamMeta(avantgarde::toParamIndex(avantgarde::TrackParamId::MuteEnabled)).name == "track.mute");
     REQUIRE(tr.getParamMeta(avantgarde::toParamIndex(avantgarde::TrackParamId::PlayheadNorm)).name == "track.playhead_norm");
     REQUIRE(tr.getParamMeta(avantgarde::toParamIndex(avantgarde::TrackParamId::TempoSyncEnabled)).name == "track.tempo_sync");
+    REQUIRE(tr.getParamMeta(avantgarde::auxSendParamIndex(1)).name == "track.send_b");
+
+    tr.setParam(avantgarde::auxSendParamIndex(1), 0.4f);
+    REQUIRE(tr.auxSendLevel(1) == Catch::Approx(0.4f));
+    REQUIRE(tr.auxSendLevel(0) == 0.0f);
+    REQUIRE(tr.auxSendLevel(avantgarde::kMaxAuxBuses) == 0.0f);
 
     tr.setParam(avantgarde::toParamIndex(avantgarde::TrackParamId::Gain01), 0.25f);
     REQUIRE(absf(tr.getParam(avantgarde::toParamIndex(avantgarde::TrackParamId::Gain01)) - 0.25f) < 1e-6f);
@@ -792,3 +852,494 @@ TEST_CASE("ClipTrack: note mode policies stop playback on NoteOff and retrigger
     for (float v : t.out0) sumOff += absf(v);
     REQUIRE(sumOff < 1e-4f);
 }
+
+TEST_CASE("ClipTrack: NoteOn with frameInBlock starts audio on the exact sample") {
+    avantgarde::ClipTrackImpl tr;
+
+    std::vector<int16_t> pcm(4096, 16384);
+    const fs::path tmp = fs::temp_directory_path() / "ag_cliptrack_test_frame_offset.wav";
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+    REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()) == true);
+    REQUIRE(tr.setSlotLooping(0, false) == true);
+
+    // Offset inside the block: silence before, signal from the target sample on.
+    avantgarde::RtCommand cmd{};
+    cmd.id = avantgarde::toWireCmdId(avantgarde::CmdId::NoteOn);
+    cmd.track = 0;
+    cmd.slot = -1;
+    cmd.index = 60;
+    cmd.value = 1.0f;
+    cmd.frameInBlock = 100;
+    tr.onRtCommand(cmd);
+
+    auto t = make_ctx(256);
+    clear_out(t);
+    tr.process(t.ctx);
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(t.out0[(size_t)i] == 0.0f);
+    }
+    REQUIRE(absf(t.out0[100]) > 0.1f);
+    REQUIRE(absf(t.out0[255]) > 0.1f);
+
+    // Offset beyond the block is carried into the next block.
+    send_cmd(tr, avantgarde::CmdId::Stop, /*slot*/0);
+    cmd.frameInBlock = 256 + 10;
+    tr.onRtCommand(cmd);
+
+    clear_out(t);
+    tr.process(t.ctx);
+    for (int i = 0; i < 256; ++i) {
+        REQUIRE(t.out0[(size_t)i] == 0.0f);
+    }
+    clear_out(t);
+    tr.process(t.ctx);
+    REQUIRE(t.out0[9] == 0.0f);
+    REQUIRE(absf(t.out0[10]) > 0.1f);
+}
+
+TEST_CASE("ClipTrack: immediate commands do not overtake timed commands carried from the last block") {
+    avantgarde::ClipTrackImpl tr;
+
+    std::vector<int16_t> pcm(4096, 16384);
+    const fs::path tmp = fs::temp_directory_path() / "ag_cliptrack_carried_order.wav";
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+    REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()) == true);
+    REQUIRE(tr.setSlotLooping(0, false) == true);
+    send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/-1,
+             avantgarde::toParamIndex(avantgarde::TrackParamId::FollowTransportEnabled), 0.0f);
+    send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/-1,
+             avantgarde::toParamIndex(avantgarde::TrackParamId::PlaybackMode),
+             avantgarde::toParamValue(avantgarde::TrackPlaybackModeValue::Note));
+    send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/-1,
+             avantgarde::toParamIndex(avantgarde::TrackParamId::StopPolicy),
+             avantgarde::toParamValue(avantgarde::TrackStopPolicyValue::ByNoteOff));
+
+    // NoteOn lands exactly on the next block's first sample and is carried over.
+    avantgarde::RtCommand on{};
+    on.id = avantgarde::toWireCmdId(avantgarde::CmdId::NoteOn);
+    on.track = 0;
+    on.slot = -1;
+    on.index = 60;
+    on.value = 1.0f;
+    on.frameInBlock = 256;
+    tr.onRtCommand(on);
+
+    auto t = make_ctx(256);
+    clear_out(t);
+    tr.process(t.ctx);
+
+    // The NoteOff for the same block start must apply after the carried NoteOn.
+    send_cmd(tr, avantgarde::CmdId::NoteOff, /*slot*/-1, /*index=*/60, /*value=*/0.0f);
+    clear_out(t);
+    tr.process(t.ctx);
+    clear_out(t);
+    tr.process(t.ctx);
+    float sum = 0.0f;
+    for (float v : t.out0) sum += absf(v);
+    REQUIRE(sum < 1e-4f);
+}
+
+TEST_CASE("ClipTrack: polyphonic note mode layers voices and steals the oldest") {
+    avantgarde::ClipTrackImpl tr;
+
+    // Constant 0.25 clip, long enough to stay inside the region for the test.
+    std::vector<int16_t> pcm(8192, 8192);
+    const fs::path tmp = fs::temp_directory_path() / "ag_cliptrack_poly.wav";
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+    REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()) == true);
+    REQUIRE(tr.setSlotLooping(0, false) == true);
+    REQUIRE(tr.setNotePolyphony(2, avantgarde::VoiceStealPolicyValue::Oldest) == true);
+    REQUIRE(tr.setNotePolyphony(0, avantgarde::VoiceStealPolicyValue::Oldest) == false);
+
+    send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/-1,
+             avantgarde::toParamIndex(avantgarde::TrackParamId::FollowTransportEnabled), 0.0f);
+    send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/-1,
+             avantgarde::toParamIndex(avantgarde::TrackParamId::PlaybackMode),
+             avantgarde::toParamValue(avantgarde::TrackPlaybackModeValue::Note));
+    send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/-1,
+             avantgarde::toParamIndex(avantgarde::TrackParamId::StopPolicy),
+             avantgarde::toParamValue(avantgarde::TrackStopPolicyValue::ByNoteOff));
+
+    auto t = make_ctx(256);
+    auto lastSample = [&]() {
+        clear_out(t);
+        tr.process(t.ctx);
+        return t.out0.back();
+    };
+
+    send_cmd(tr, avantgarde::CmdId::NoteOn, /*slot*/-1, /*index=*/60, 1.0f);
+    const float one = lastSample();
+    REQUIRE(one == Catch::Approx(0.25f).margin(1e-3));
+
+    // Second note does not cut the first one: two voices sum.
+    send_cmd(tr, avantgarde::CmdId::NoteOn, /*slot*/-1, /*index=*/64, 1.0f);
+    REQUIRE(lastSample() == Catch::Approx(0.5f).margin(1e-3));
+
+    // Third note steals the oldest voice (note 60): still two voices.
+    send_cmd(tr, avantgarde::CmdId::NoteOn, /*slot*/-1, /*index=*/67, 1.0f);
+    REQUIRE(lastSample() == Catch::Approx(0.5f).margin(1e-3));
+
+    // NoteOff for the stolen note is a no-op; NoteOff 64 leaves only note 67.
+    send_cmd(tr, avantgarde::CmdId::NoteOff, /*slot*/-1, /*index=*/60, 0.0f);
+    REQUIRE(lastSample() == Catch::Approx(0.5f).margin(1e-3));
+    send_cmd(tr, avantgarde::CmdId::NoteOff, /*slot*/-1, /*index=*/64, 0.0f);
+    REQUIRE(lastSample() == Catch::Approx(0.25f).margin(1e-3));
+    send_cmd(tr, avantgarde::CmdId::NoteOff, /*slot*/-1, /*index=*/67, 0.0f);
+    REQUIRE(lastSample() == 0.0f);
+}
+
+TEST_CASE("ClipTrack: stolen, released and finished note voices fade out without clicks") {
+    avantgarde::ClipTrackImpl tr;
+
+    // Constant 0.5 clip: any hard cut would show up as a 0.5 step between samples.
+    std::vector<int16_t> pcm(4096, 16384);
+    const fs::path tmp = fs::temp_directory_path() / "ag_cliptrack_poly_fade.wav";
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+    REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()) == true);
+    REQUIRE(tr.setSlotLooping(0, false) == true);
+    REQUIRE(tr.setNotePolyphony(2, avantgarde::VoiceStealPolicyValue::Oldest) == true);
+
+    send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/-1,
+             avantgarde::toParamIndex(avantgarde::TrackParamId::FollowTransportEnabled), 0.0f);
+    send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/-1,
+             avantgarde::toParamIndex(avantgarde::TrackParamId::PlaybackMode),
+             avantgarde::toParamValue(avantgarde::TrackPlaybackModeValue::Note));
+    send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/-1,
+             avantgarde::toParamIndex(avantgarde::TrackParamId::StopPolicy),
+             avantgarde::toParamValue(avantgarde::TrackStopPolicyValue::ByNoteOff));
+
+    auto t = make_ctx(256);
+    std::vector<float> out;
+    auto block = [&]() {
+        clear_out(t);
+        tr.process(t.ctx);
+        out.insert(out.end(), t.out0.begin(), t.out0.end());
+    };
+
+    send_cmd(tr, avantgarde::CmdId::NoteOn, /*slot*/-1, /*index=*/60, 1.0f);
+    block();
+    send_cmd(tr, avantgarde::CmdId::NoteOn, /*slot*/-1, /*index=*/64, 1.0f);
+    block();
+    REQUIRE(out.back() == Catch::Approx(1.0f).margin(1e-3));
+    // Steal: note 60 fades out while note 67 fades in, the sum never jumps.
+    send_cmd(tr, avantgarde::CmdId::NoteOn, /*slot*/-1, /*index=*/67, 1.0f);
+    block();
+    REQUIRE(out.back() == Catch::Approx(1.0f).margin(1e-3));
+    // Release: note 64 fades out to the single remaining voice.
+    send_cmd(tr, avantgarde::CmdId::NoteOff, /*slot*/-1, /*index=*/64, 0.0f);
+    block();
+    REQUIRE(out.back() == Catch::Approx(0.5f).margin(1e-3));
+    // Note 67 runs into the end of the one-shot region and fades out there.
+    for (int b = 0; b < 20; ++b) {
+        block();
+    }
+    REQUIRE(out.back() == 0.0f);
+
+    float maxStep = 0.0f;
+    for (std::size_t i = 1; i < out.size(); ++i) {
+        maxStep = std::max(maxStep, std::fabs(out[i] - out[i - 1]));
+    }
+    // One fade step is 0.5 / 64; a cut voice would step by 0.5.
+    REQUIRE(maxStep < 0.02f);
+}
+
+TEST_CASE("ClipTrack: muted track advances its playhead like an audible one") {
+    // Ramp clip: the sample value encodes the playhead position.
+    std::vector<int16_t> pcm(1000);
+    for (std::size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = static_cast<int16_t>(i * 30U);
+    }
+    const fs::path tmp = fs::temp_directory_path() / "ag_cliptrack_muted_advance.wav";
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+
+    for (const bool loop : {true, false}) {
+        auto setup = [&](avantgarde::ClipTrackImpl& tr) {
+            REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()) == true);
+            REQUIRE(tr.setSlotLooping(0, loop) == true);
+            // Fractional speed: the playhead wraps / hits the region end mid-block.
+            send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/0, /*index*/2, /*value*/0.73f);
+            send_cmd(tr, avantgarde::CmdId::Play, 0);
+        };
+        const uint16_t muteIndex = avantgarde::toParamIndex(avantgarde::TrackParamId::MuteEnabled);
+
+        avantgarde::ClipTrackImpl audible;
+        avantgarde::ClipTrackImpl muted;
+        setup(audible);
+        setup(muted);
+        send_cmd(muted, avantgarde::CmdId::ParamSet, /*slot*/-1, muteIndex, 1.0f);
+
+        auto a = make_ctx(300);
+        auto m = make_ctx(300);
+        for (int blk = 0; blk < 10; ++blk) {
+            clear_out(a);
+            clear_out(m);
+            audible.process(a.ctx);
+            muted.process(m.ctx);
+            REQUIRE(count_non_zero(m.out0, 0.0f) == 0);
+        }
+
+        send_cmd(muted, avantgarde::CmdId::ParamSet, /*slot*/-1, muteIndex, 0.0f);
+        clear_out(a);
+        clear_out(m);
+        audible.process(a.ctx);
+        muted.process(m.ctx);
+        for (std::size_t i = 0; i < a.out0.size(); ++i) {
+            REQUIRE(m.out0[i] == Catch::Approx(a.out0[i]).margin(1e-4));
+        }
+        // A one-shot runs out while muted and closes its gate just like the audible one.
+        REQUIRE(muted.isIdleRt() == !loop);
+        REQUIRE(audible.isIdleRt() == !loop);
+    }
+}
+
+TEST_CASE("ClipTrack: FX chain is skipped once its tail has decayed on silent input") {
+    // 512 frames of 0.5, then silence up to the end of the (non-looping) clip.
+    std::vector<int16_t> pcm(4096, 0);
+    std::fill_n(pcm.begin(), 512, static_cast<int16_t>(16384));
+    const fs::path tmp = fs::temp_directory_path() / "ag_cliptrack_fx_tail_skip.wav";
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+
+    avantgarde::ClipTrackImpl finite;
+    avantgarde::ClipTrackImpl infinite;
+    auto finiteFx = std::make_unique<TailCountingFx>();
+    finiteFx->tail = 512;
+    auto* finitePtr = finiteFx.get();
+    auto infiniteFx = std::make_unique<TailCountingFx>();
+    auto* infinitePtr = infiniteFx.get();
+    finite.addModule(std::move(finiteFx));
+    infinite.addModule(std::move(infiniteFx));
+    for (auto* tr : {&finite, &infinite}) {
+        REQUIRE(tr->loadSlotFromFile(0, tmp.string().c_str()) == true);
+        REQUIRE(tr->setSlotLooping(0, false) == true);
+        send_cmd(*tr, avantgarde::CmdId::Play, 0);
+    }
+
+    auto t = make_ctx(256);
+    auto u = make_ctx(256);
+    for (int blk = 0; blk < 12; ++blk) {
+        clear_out(t);
+        clear_out(u);
+        finite.process(t.ctx);
+        infinite.process(u.ctx);
+        for (std::size_t i = 0; i < t.out0.size(); ++i) {
+            REQUIRE(t.out0[i] == u.out0[i]);
+        }
+    }
+    // 2 audible blocks + 512 frames of tail on silent input; the rest is skipped.
+    REQUIRE(finitePtr->calls == 4);
+    // Unknown tail (the IAudioModule default) is never skipped.
+    REQUIRE(infinitePtr->calls == 12);
+}
+
+TEST_CASE("ClipTrack: render-ahead only for transport-following clips, rewind restores the playhead") {
+    const fs::path tmp = fs::temp_directory_path() / "ag_cliptrack_render_ahead.wav";
+    std::vector<int16_t> pcm(512);
+    for (std::size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = static_cast<int16_t>(static_cast<int>(i) * 60 - 15000);
+    }
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+
+    avantgarde::ClipTrackImpl tr;
+    REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()) == true);
+    // One-shot gate: the worker would never see the triggers.
+    REQUIRE_FALSE(tr.canRenderAheadRt());
+
+    tr.setParam(avantgarde::toParamIndex(avantgarde::TrackParamId::FollowTransportEnabled), 1.0f);
+    REQUIRE_FALSE(tr.canRenderAheadRt()); // transport stopped
+    avantgarde::RtCommand play{};
+    play.id = static_cast<uint16_t>(avantgarde::CmdId::Play);
+    play.track = avantgarde::kRtTrackGlobal;
+    tr.onRtCommand(play);
+    REQUIRE(tr.canRenderAheadRt());
+
+    // Any publication outside RT moves the epoch.
+    const uint64_t epoch = tr.controlEpoch();
+    REQUIRE(tr.setSlotLooping(0, true) == true);
+    REQUIRE(tr.controlEpoch() > epoch);
+
+    // Rewinding to a captured position replays the same audio.
+    auto t = make_ctx(64);
+    tr.process(t.ctx);
+    const double pos = tr.renderPositionRt();
+    clear_out(t);
+    tr.process(t.ctx);
+    const std::vector<float> first = t.out0;
+    tr.seekRenderPositionRt(pos);
+    clear_out(t);
+    tr.process(t.ctx);
+    REQUIRE(t.out0 == first);
+}
+
+TEST_CASE("ClipTrack: clip swap keeps FX buffers, optional reset runs at the next block") {
+    const fs::path a = fs::temp_directory_path() / "ag_cliptrack_swap_a.wav";
+    const fs::path b = fs::temp_directory_path() / "ag_cliptrack_swap_b.wav";
+    write_wav_pcm16(a, 48000, 1, std::vector<int16_t>(1024, 8192));
+    write_wav_pcm16(b, 48000, 1, std::vector<int16_t>(1024, -8192));
+
+    avantgarde::ClipTrackImpl tr;
+    auto fx = std::make_unique<LifecycleFx>();
+    auto* fxPtr = fx.get();
+    tr.addModule(std::move(fx));
+    REQUIRE(fxPtr->inits == 1);
+    const int resetsAfterAdd = fxPtr->resets;
+    const float* ringData = fxPtr->ring.data();
+
+    REQUIRE(tr.loadSlotFromFile(0, a.string().c_str()) == true);
+    send_cmd(tr, avantgarde::CmdId::Play, 0);
+    auto t = make_ctx(256);
+    tr.process(t.ctx);
+    REQUIRE(fxPtr->ring[0] != 0.0f);
+
+    // Default: swapping clips neither re-inits nor resets the chain, the FX state survives.
+    REQUIRE(tr.loadSlotFromFile(0, b.string().c_str()) == true);
+    REQUIRE(fxPtr->inits == 1);
+    REQUIRE(fxPtr->resets == resetsAfterAdd);
+    REQUIRE(fxPtr->ring.data() == ringData);
+    REQUIRE(fxPtr->ring[100] != 0.0f);
+
+    // Opt-in reset happens inside process(), not on the loading thread.
+    tr.setFxResetOnClipSwap(true);
+    REQUIRE(tr.loadSlotFromFile(0, a.string().c_str()) == true);
+    REQUIRE(fxPtr->resets == resetsAfterAdd);
+    send_cmd(tr, avantgarde::CmdId::Play, 0);
+    clear_out(t);
+    tr.process(t.ctx);
+    REQUIRE(fxPtr->resets == resetsAfterAdd + 1);
+    REQUIRE(fxPtr->inits == 1);
+    REQUIRE(fxPtr->ring.data() == ringData);
+    // Only the first block after the swap resets.
+    clear_out(t);
+    tr.process(t.ctx);
+    REQUIRE(fxPtr->resets == resetsAfterAdd + 1);
+
+    fs::remove(a);
+    fs::remove(b);
+}
+
+TEST_CASE("ClipTrack: tempo sync Stretch keeps the loop length of varispeed and the pitch of the clip") {
+    // 1.5 s of 440 Hz stretched to one 120 BPM bar (2 s): playback speed 0.75.
+    constexpr int kRate = 48000;
+    constexpr int kFrames = kRate * 3 / 2;
+    std::unique_ptr<float[]> samples(new float[kFrames]);
+    for (int i = 0; i < kFrames; ++i) {
+        samples[i] = 0.5f * static_cast<float>(std::sin(6.283185307179586 * 440.0 * i / kRate));
+    }
+    const avantgarde::SharedClipBuffer clip{kRate, 1, kFrames,
+                                            std::shared_ptr<const float[]>(samples.release()), {}};
+
+    auto run = [&](avantgarde::TempoSyncModeValue mode, float& playheadNorm) {
+        avantgarde::ClipTrackImpl tr(kRate);
+        REQUIRE(tr.loadSlotFromBuffer(0, clip));
+        REQUIRE(tr.setSlotLooping(0, true));
+        REQUIRE(tr.setSlotLengthInBars(0, 1));
+        send_cmd(tr, avantgarde::CmdId::ParamSet, -1,
+                 avantgarde::toParamIndex(avantgarde::TrackParamId::TempoSyncMode), avantgarde::toParamValue(mode));
+        send_cmd(tr, avantgarde::CmdId::Play, 0);
+        std::vector<float> out;
+        auto t = make_ctx(256);
+        // One and a half bars: the loop wraps once.
+        for (int block = 0; block < 3 * kRate / 256; ++block) {
+            clear_out(t);
+            tr.process(t.ctx);
+            out.insert(out.end(), t.out0.begin(), t.out0.end());
+        }
+        REQUIRE(std::fabs(tr.getParam(avantgarde::toParamIndex(avantgarde::TrackParamId::PlaybackInc)) - 0.75f) < 1e-3f);
+        REQUIRE(tr.getParam(avantgarde::toParamIndex(avantgarde::TrackParamId::TempoSyncMode)) ==
+                avantgarde::toParamValue(mode));
+        playheadNorm = tr.getParam(avantgarde::toParamIndex(avantgarde::TrackParamId::PlayheadNorm));
+        return out;
+    };
+    auto hz = [](const std::vector<float>& y, std::size_t from, std::size_t to) {
+        int crossings = 0;
+        for (std::size_t i = from + 1; i < to; ++i) {
+            crossings += ((y[i - 1] < 0.0f) != (y[i] < 0.0f)) ? 1 : 0;
+        }
+        return 0.5 * crossings * kRate / static_cast<double>(to - from);
+    };
+
+    float varispeedPh = 0.0f;
+    float stretchPh = 0.0f;
+    const std::vector<float> varispeed = run(avantgarde::TempoSyncModeValue::Varispeed, varispeedPh);
+    const std::vector<float> stretched = run(avantgarde::TempoSyncModeValue::Stretch, stretchPh);
+
+    // Same playhead: the loop stays on the bar grid in both modes.
+    REQUIRE(stretchPh == Catch::Approx(varispeedPh).margin(1e-4));
+    REQUIRE(stretchPh == Catch::Approx(0.5f).margin(0.01));
+    // Varispeed drops the tone by the speed, Stretch keeps it.
+    REQUIRE(hz(varispeed, 4096, 90000) == Catch::Approx(330.0).epsilon(0.01));
+    REQUIRE(hz(stretched, 4096, 90000) == Catch::Approx(440.0).epsilon(0.01));
+    // Across the loop wrap too.
+    REQUIRE(hz(stretched, 90000, stretched.size() - 4096) == Catch::Approx(440.0).epsilon(0.02));
+}
+
+TEST_CASE("ClipTrack: stem sink gets the track output, padded with silence while muted") {
+    // Collects every frame the track hands to its stem; nullptr channels are silence.
+    struct CaptureSink final : avantgarde::IRtRecordSink {
+        std::vector<float> l;
+        std::vector<float> r;
+        bool writeBlock(const float* const* ch, int nframes) noexcept override {
+            for (int i = 0; i < nframes; ++i) {
+                l.push_back(ch[0] ? ch[0][i] : 0.0f);
+                r.push_back(ch[1] ? ch[1][i] : 0.0f);
+            }
+            return true;
+        }
+        void mark(uint32_t) noexcept override {}
+    };
+
+    avantgarde::ClipTrackImpl tr;
+    std::vector<int16_t> pcm(4096);
+    for (std::size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = (int16_t)((int)(i % 64) * 400 - 12000);
+    }
+    const fs::path tmp = fs::temp_directory_path() / "ag_cliptrack_stem_sink.wav";
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+    REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()) == true);
+    REQUIRE(tr.setSlotLooping(0, true) == true);
+
+    CaptureSink sink;
+    tr.setStemSink(&sink);
+    // While a stem is attached the track is never skipped or rendered ahead.
+    REQUIRE_FALSE(tr.isIdleRt());
+    REQUIRE_FALSE(tr.canRenderAheadRt());
+
+    auto t = make_ctx(256);
+    std::vector<float> expected0;
+    std::vector<float> expected1;
+    auto run_block = [&]() {
+        clear_out(t);
+        tr.process(t.ctx);
+        expected0.insert(expected0.end(), t.out0.begin(), t.out0.end());
+        expected1.insert(expected1.end(), t.out1.begin(), t.out1.end());
+    };
+
+    // Stopped: the stem still advances with silence.
+    run_block();
+    // Sample-accurate start inside the block splits the render into segments.
+    avantgarde::RtCommand cmd{};
+    cmd.id = avantgarde::toWireCmdId(avantgarde::CmdId::Play);
+    cmd.track = 0;
+    cmd.slot = 0;
+    cmd.frameInBlock = 100;
+    tr.onRtCommand(cmd);
+    run_block();
+    run_block();
+    send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/-1,
+             avantgarde::toParamIndex(avantgarde::TrackParamId::MuteEnabled), 1.0f);
+    run_block();
+    send_cmd(tr, avantgarde::CmdId::ParamSet, /*slot*/-1,
+             avantgarde::toParamIndex(avantgarde::TrackParamId::MuteEnabled), 0.0f);
+    run_block();
+
+    REQUIRE(sink.l.size() == 5u * 256u);
+    REQUIRE(count_non_zero(sink.l) > 256);
+    for (std::size_t i = 0; i < sink.l.size(); ++i) {
+        REQUIRE(sink.l[i] == expected0[i]);
+        REQUIRE(sink.r[i] == expected1[i]);
+    }
+
+    // Detached: nothing more reaches the sink.
+    tr.setStemSink(nullptr);
+    run_block();
+    REQUIRE(sink.l.size() == 5u * 256u);
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+
+#include "runtime/DspLoadProfiler.h"
+
+using namespace avantgarde;
+
+namespace {
+
+const DspLoadSiteCounters* findSite(const DspLoadCapture& cap, DspLoadSiteKind kind, uint16_t owner, uint16_t slot = 0) {
+    for (const auto& s : cap.sites) {
+        if (s.kind == kind && s.owner == owner && s.slot == slot) return &s;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST_CASE("DspLoadProfiler: histogram bins are log-linear and round-trip their lower bounds") {
+    for (uint32_t b = 0; b < kDspLoadHistogramBins; ++b) {
+        REQUIRE(DspLoadProfiler::binOf(DspLoadProfiler::binLowerTicks(b)) == b);
+        if (b > 0) {
+            REQUIRE(DspLoadProfiler::binLowerTicks(b) > DspLoadProfiler::binLowerTicks(b - 1));
+        }
+    }
+    // Four bins per octave: relative bin width never exceeds 25%.
+    REQUIRE(DspLoadProfiler::binOf(1000) == DspLoadProfiler::binOf(1023));
+    REQUIRE(DspLoadProfiler::binOf(1024) != DspLoadProfiler::binOf(1023));
+    // Huge values land in the last bin instead of overflowing.
+    REQUIRE(DspLoadProfiler::binOf(UINT64_MAX) == kDspLoadHistogramBins - 1);
+}
+
+TEST_CASE("DspLoadProfiler: sites map to fixed slots and out-of-range owners are rejected") {
+    REQUIRE(DspLoadProfiler::siteOf(DspLoadSiteKind::TrackFx, 0, 0) !=
+            DspLoadProfiler::siteOf(DspLoadSiteKind::TrackFx, 0, 1));
+    REQUIRE(DspLoadProfiler::siteOf(DspLoadSiteKind::Track, DspLoadProfiler::kMaxTracks) == DspLoadProfiler::kNoSite);
+    REQUIRE(DspLoadProfiler::siteOf(DspLoadSiteKind::TrackFx, 0, DspLoadProfiler::kMaxFxSlots) ==
+            DspLoadProfiler::kNoSite);
+
+    DspLoadProfiler prof;
+    prof.recordRt(DspLoadProfiler::kNoSite, 100); // ignored, must not crash
+    prof.recordRt(DspLoadProfiler::siteOf(DspLoadSiteKind::TrackFx, 3, 2), 100);
+    prof.recordRt(DspLoadProfiler::siteOf(DspLoadSiteKind::RtExtEnd, 1), 50);
+
+    DspLoadCapture cap;
+    prof.capture(cap);
+    REQUIRE(cap.sites.size() == 2);
+    const auto* fx = findSite(cap, DspLoadSiteKind::TrackFx, 3, 2);
+    REQUIRE(fx != nullptr);
+    REQUIRE(fx->count == 1);
+    REQUIRE(fx->maxTicks == 100);
+    REQUIRE(findSite(cap, DspLoadSiteKind::RtExtEnd, 1) != nullptr);
+}
+
+TEST_CASE("DspLoadProfiler: report covers the window between two captures") {
+    DspLoadProfiler prof;
+    const uint32_t block = DspLoadProfiler::siteOf(DspLoadSiteKind::Block);
+    const uint32_t light = DspLoadProfiler::siteOf(DspLoadSiteKind::Track, 0);
+    const uint32_t heavy = DspLoadProfiler::siteOf(DspLoadSiteKind::TrackFx, 1, 0);
+
+    for (int i = 0; i < 100; ++i) {
+        prof.recordRt(block, 1000);
+        prof.recordRt(light, 200);
+    }
+    DspLoadCapture first;
+    prof.capture(first);
+
+    for (int i = 0; i < 100; ++i) {
+        prof.recordRt(block, i == 99 ? 5000 : 2000); // one slow block
+        prof.recordRt(light, 200);
+        prof.recordRt(heavy, 1500);
+    }
+    DspLoadCapture second;
+    prof.capture(second);
+    // Fixed calibration keeps the numbers deterministic: 1 tick == 1 ns.
+    second.ticksPerUs = 1000.0;
+
+    DspLoadReport window;
+    DspLoadProfiler::buildReport(second, &first, /*budgetUs*/ 10.0, window);
+    REQUIRE(window.block.blocks == 100);
+    REQUIRE(window.block.meanUs == Catch::Approx(2.03f).margin(0.01f));
+    REQUIRE(window.block.p50Us == Catch::Approx(2.0f).epsilon(0.25f));
+    REQUIRE(window.block.maxUs == Catch::Approx(5.0f)); // exact lifetime max sits in the top window bin
+    REQUIRE(window.block.meanPct == Catch::Approx(20.3f).margin(0.1f));
+
+    // The heaviest site comes first; the window excludes the first 100 blocks.
+    REQUIRE(window.siteCount == 2);
+    REQUIRE(window.sites[0].kind == DspLoadSiteKind::TrackFx);
+    REQUIRE(window.sites[0].owner == 1);
+    REQUIRE(window.sites[0].blocks == 100);
+    REQUIRE(window.sites[1].kind == DspLoadSiteKind::Track);
+    REQUIRE(window.sites[1].blocks == 100);
+
+    DspLoadReport lifetime;
+    DspLoadProfiler::buildReport(second, nullptr, 10.0, lifetime);
+    REQUIRE(lifetime.block.blocks == 200);
+    REQUIRE(lifetime.block.meanUs == Catch::Approx(1.515f).margin(0.01f));
+}
@@ -46,3 +46,23 @@ TEST_CASE("OnePoleHPF: low frequency attenuates stronger with higher cutoff") {
 
     REQUIRE(rmsHigh < rmsLow * 0.75f);
 }
+
+TEST_CASE("OnePoleHPF: tail is finite for a decaying pole and infinite when the pole reaches 1") {
+    OnePoleHPFModule hpf;
+    hpf.init(48000.0, 256);
+    hpf.setCutoff01(0.0f);
+    hpf.beginBlock();
+    const uint32_t tail = hpf.tailFrames();
+    REQUIRE(tail > 0u);
+    REQUIRE(tail < IAudioModule::kInfiniteTailFrames);
+
+    // At an absurd rate the 10 Hz pole rounds to exactly 1.0f: the state never decays.
+    hpf.init(1e12, 256);
+    hpf.setCutoff01(0.0f);
+    hpf.beginBlock();
+    REQUIRE(hpf.tailFrames() == IAudioModule::kInfiniteTailFrames);
+
+    REQUIRE(IAudioModule::onePoleTailFrames(1.0f) == IAudioModule::kInfiniteTailFrames);
+    REQUIRE(IAudioModule::onePoleTailFrames(0.0f) == 0u);
+    REQUIRE(IAudioModule::onePoleTailFrames(0.5f) == 22u);
+}
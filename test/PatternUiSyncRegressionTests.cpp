@@ -37,17 +37,9 @@ void writeU32Le(std::ofstream& f, uint32_t v) {
     f.write(reinterpret_cast<const char*>(b), 4);
 }
 
-fs::path writeTestWav(const fs::path& path, int sampleRate, float hz) {
+fs::path writeMonoWav(const fs::path& path, int sampleRate, const std::vector<int16_t>& pcm) {
     constexpr int channels = 1;
     constexpr int bitsPerSample = 16;
-    constexpr int frames = 1024;
-    std::vector<int16_t> pcm(frames * channels, 0);
-    for (int i = 0; i < frames; ++i) {
-        const float t = static_cast<float>(i) / static_cast<float>(sampleRate);
-        const float s = std::sin(2.0f * 3.14159265359f * hz * t);
-        pcm[static_cast<std::size_t>(i)] = static_cast<int16_t>(std::round(s * 12000.0f));
-    }
-
     const uint16_t blockAlign = static_cast<uint16_t>(channels * (bitsPerSample / 8));
     const uint32_t byteRate = static_cast<uint32_t>(sampleRate) * blockAlign;
     const uint32_t dataSize = static_cast<uint32_t>(pcm.size() * sizeof(int16_t));
@@ -75,6 +67,17 @@ fs::path writeTestWav(const fs::path& path, int sampleRate, float hz) {
     return path;
 }
 
+fs::path writeTestWav(const fs::path& path, int sampleRate, float hz) {
+    constexpr int frames = 1024;
+    std::vector<int16_t> pcm(frames, 0);
+    for (int i = 0; i < frames; ++i) {
+        const float t = static_cast<float>(i) / static_cast<float>(sampleRate);
+        const float s = std::sin(2.0f * 3.14159265359f * hz * t);
+        pcm[static_cast<std::size_t>(i)] = static_cast<int16_t>(std::round(s * 12000.0f));
+    }
+    return writeMonoWav(path, sampleRate, pcm);
+}
+
 class MockStream final : public avantgarde::IAudioStream {
 public:
     explicit MockStream(const avantgarde::StreamConfig& cfg)
@@ -105,6 +108,8 @@ public:
     uint64_t totalCallbacks() const noexcept override { return totalCallbacks_; }
     uint64_t xruns() const noexcept override { return 0; }
 
+    const std::vector<float>& lastOutL() const noexcept { return outL_; }
+
     void pump(int blocks) {
         if (!running_ || !render_) {
             return;
@@ -154,6 +159,10 @@ public:
         }
     }
 
+    float lastSampleL() const noexcept {
+        return (stream_ && !stream_->lastOutL().empty()) ? stream_->lastOutL().back() : 0.0f;
+    }
+
 private:
     MockStream* stream_{nullptr};
 };
@@ -274,3 +283,100 @@ TEST_CASE("Transport play/stop is reflected in UI cache without extra key press"
 
     engine.stop();
 }
+
+TEST_CASE("Pattern switch: clips referenced by a pattern survive the pool budget") {
+    auto host = std::make_shared<MockAudioHost>();
+
+    avantgarde::SamplerEngineLayer engine{};
+    avantgarde::SamplerEngineConfig cfg{};
+    cfg.trackCount = 1;
+    cfg.sampleRate = 48000.0;
+    cfg.blockFrames = 128;
+    cfg.numInput = 0;
+    cfg.numOutput = 2;
+    // Room for about two of the 1024-frame test clips.
+    cfg.clipPoolMaxBytes = 2u * 1024u * sizeof(float) + 16u;
+
+    avantgarde::UiState bootstrap{};
+    std::string err{};
+    REQUIRE(engine.init(cfg, host, bootstrap, err));
+    REQUIRE(engine.start(err));
+
+    const fs::path dir = fs::temp_directory_path();
+    const fs::path wavA = writeTestWav(dir / "ag_pattern_pin_A.wav", 48000, 110.0f);
+    std::vector<fs::path> others{};
+    for (int i = 0; i < 3; ++i) {
+        others.push_back(writeTestWav(dir / ("ag_pattern_pin_" + std::to_string(i) + ".wav"), 48000,
+                                      300.0f + 100.0f * static_cast<float>(i)));
+    }
+
+    std::string clipName{};
+    REQUIRE(engine.loadSampleToTrack(0, wavA.string(), clipName));
+    REQUIRE(engine.requestPatternSwitchTo(2));
+    REQUIRE(waitPatternSwitch(engine, *host));
+
+    // Pattern 2 cycles through more clips than the budget holds; pattern 1's clip is
+    // now the least recently used one and no track holds it.
+    for (const fs::path& p : others) {
+        REQUIRE(engine.loadSampleToTrack(0, p.string(), clipName));
+    }
+    REQUIRE(engine.telemetryAndResetOverflow().clipPoolEvictions >= 1u);
+
+    // With the source gone, switching back can only succeed from the pool.
+    fs::remove(wavA);
+    REQUIRE(engine.requestPatternSwitchTo(1));
+    REQUIRE(waitPatternSwitch(engine, *host));
+    avantgarde::UiTransportState uiTransport = bootstrap.transport;
+    std::vector<avantgarde::UiTrackStateView> uiTracks = bootstrap.tracks;
+    REQUIRE(engine.syncUiCache(uiTransport, uiTracks));
+    REQUIRE(uiTracks[0].clipPath == wavA.string());
+
+    engine.setTransportPlaying(true);
+    host->pump(8);
+    engine.stop();
+    for (const fs::path& p : others) {
+        fs::remove(p);
+    }
+}
+
+TEST_CASE("Engine config: note polyphony reaches the tracks") {
+    avantgarde::VoiceStealPolicyValue unused{};
+    REQUIRE_FALSE(avantgarde::parseVoiceStealPolicy("loudest", unused));
+    // Constant 0.25 clip: the output level counts the sounding voices.
+    const fs::path wav = writeMonoWav(fs::temp_directory_path() / "ag_engine_note_voices.wav", 48000,
+                                      std::vector<int16_t>(24000, 8192));
+
+    auto levelAfterTwoNotes = [&](uint8_t voices, const char* steal) {
+        auto host = std::make_shared<MockAudioHost>();
+        avantgarde::SamplerEngineLayer engine{};
+        avantgarde::SamplerEngineConfig cfg{};
+        cfg.trackCount = 1;
+        cfg.blockFrames = 128;
+        cfg.notePolyphony = voices;
+        REQUIRE(avantgarde::parseVoiceStealPolicy(steal, cfg.voiceSteal));
+
+        avantgarde::UiState bootstrap{};
+        std::string err{};
+        REQUIRE(engine.init(cfg, host, bootstrap, err));
+        REQUIRE(engine.start(err));
+        std::string clipName{};
+        REQUIRE(engine.loadSampleToTrack(0, wav.string(), clipName));
+        REQUIRE(engine.setTrackLooperMode(0, false));
+        host->pump(2);
+
+        REQUIRE(engine.triggerTrackNoteOn(0, 60, 1.0f));
+        host->pump(2);
+        const float one = host->lastSampleL();
+        REQUIRE(engine.triggerTrackNoteOn(0, 64, 1.0f));
+        host->pump(2);
+        const float two = host->lastSampleL();
+        engine.stop();
+        REQUIRE(one > 0.05f);
+        return two / one;
+    };
+
+    // Mono note mode retriggers; two voices sound together.
+    REQUIRE(levelAfterTwoNotes(1, "oldest") == Catch::Approx(1.0f).margin(0.02));
+    REQUIRE(levelAfterTwoNotes(2, "quietest") == Catch::Approx(2.0f).margin(0.02));
+    fs::remove(wav);
+}
@@ -0,0 +1,93 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "service/audio/PolyphaseResampler.h"
+
+using namespace avantgarde;
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586;
+
+std::vector<float> sine(int rate, double hz, int frames, float amp = 0.5f) {
+    std::vector<float> out(static_cast<std::size_t>(frames));
+    for (int i = 0; i < frames; ++i) {
+        out[static_cast<std::size_t>(i)] = amp * static_cast<float>(std::sin(kTwoPi * hz * i / rate));
+    }
+    return out;
+}
+
+// Largest deviation from the ideal sine, away from the zero-padded edges.
+double maxError(const std::vector<float>& y, int rate, double hz, float amp, int margin) {
+    double err = 0.0;
+    for (std::size_t i = static_cast<std::size_t>(margin); i + static_cast<std::size_t>(margin) < y.size(); ++i) {
+        const double ideal = amp * std::sin(kTwoPi * hz * static_cast<double>(i) / rate);
+        err = std::max(err, std::fabs(static_cast<double>(y[i]) - ideal));
+    }
+    return err;
+}
+
+double rms(const std::vector<float>& y, int margin) {
+    double acc = 0.0;
+    std::size_t n = 0;
+    for (std::size_t i = static_cast<std::size_t>(margin); i + static_cast<std::size_t>(margin) < y.size(); ++i) {
+        acc += static_cast<double>(y[i]) * y[i];
+        ++n;
+    }
+    return std::sqrt(acc / static_cast<double>(n));
+}
+
+} // namespace
+
+TEST_CASE("PolyphaseResampler: 44.1k -> 48k keeps a sine in place") {
+    const PolyphaseResampler src(44100, 48000);
+    REQUIRE(src.valid());
+    REQUIRE(src.upFactor() == 160u);
+    REQUIRE(src.downFactor() == 147u);
+    REQUIRE(src.outputFrames(44100) == 48000);
+    REQUIRE(src.outputFrames(1) == 2);
+
+    const std::vector<float> in = sine(44100, 1000.0, 44100);
+    std::vector<float> out(static_cast<std::size_t>(src.outputFrames(44100)));
+    src.process(in.data(), 44100, out.data());
+    REQUIRE(maxError(out, 48000, 1000.0, 0.5f, 64) < 1e-4);
+
+    // Near the top of the passband too.
+    const std::vector<float> high = sine(44100, 16000.0, 8820);
+    std::vector<float> highOut(static_cast<std::size_t>(src.outputFrames(8820)));
+    src.process(high.data(), 8820, highOut.data());
+    REQUIRE(maxError(highOut, 48000, 16000.0, 0.5f, 64) < 5e-3);
+}
+
+TEST_CASE("PolyphaseResampler: downsampling removes content above the new Nyquist") {
+    const PolyphaseResampler src(96000, 48000);
+    REQUIRE(src.upFactor() == 1u);
+    REQUIRE(src.downFactor() == 2u);
+
+    // 30 kHz would alias to 18 kHz without the anti-alias filter.
+    const std::vector<float> in = sine(96000, 30000.0, 19200);
+    std::vector<float> out(static_cast<std::size_t>(src.outputFrames(19200)));
+    src.process(in.data(), 19200, out.data());
+    REQUIRE(rms(out, 128) < 1e-3);
+
+    const std::vector<float> pass = sine(96000, 440.0, 19200);
+    src.process(pass.data(), 19200, out.data());
+    REQUIRE(maxError(out, 48000, 440.0, 0.5f, 128) < 1e-4);
+}
+
+TEST_CASE("PolyphaseResampler: DC gain is unity for interpolated phases") {
+    // 47999/48000 has more phases than the table holds.
+    const PolyphaseResampler src(47999, 48000);
+    REQUIRE(src.upFactor() > PolyphaseResampler::kMaxPhases);
+    const std::vector<float> in(4000, 0.25f);
+    std::vector<float> out(static_cast<std::size_t>(src.outputFrames(4000)));
+    src.process(in.data(), 4000, out.data());
+    for (std::size_t i = 64; i + 64 < out.size(); ++i) {
+        REQUIRE(out[i] == Catch::Approx(0.25f).margin(1e-5));
+    }
+    REQUIRE_FALSE(PolyphaseResampler(0, 48000).valid());
+}
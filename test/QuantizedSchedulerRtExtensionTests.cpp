@@ -104,6 +104,8 @@ TEST_CASE("QuantizedScheduler: QuantizeMode command sets internal mode") {
     }
 
     REQUIRE(firedAt == 89);
+    // Beat at 24000: block starts at 1000 + 89 * 256 = 23784.
+    CHECK(outQ.q[0].frameInBlock == 216);
 }
 
 TEST_CASE("QuantizedScheduler: Quantize Bar aligns to next bar") {
@@ -135,6 +137,8 @@ TEST_CASE("QuantizedScheduler: Quantize Bar aligns to next bar") {
     }
 
     REQUIRE(firedAt == 89);
+    // Bar at 96000: block starts at 50000 + 89 * 512 = 95568.
+    CHECK(outQ.q[0].frameInBlock == 432);
 }
 
 TEST_CASE("QuantizedScheduler: Stop is immediate even when quantization mode is active") {
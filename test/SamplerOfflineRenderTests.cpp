@@ -0,0 +1,193 @@
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "app/SamplerApplication.h"
+#include "platform/offline/OfflineAudioHost.h"
+#include "service/audio/WavFileWriter.h"
+#include "service/pattern/ClipBufferPool.h"
+
+namespace fs = std::filesystem;
+using namespace avantgarde;
+
+namespace {
+
+struct RampRender {
+    uint32_t calls{0};
+    float next{0.0f};
+};
+
+void rampRender(AudioProcessContext& ctx, void* user) noexcept {
+    auto* r = static_cast<RampRender*>(user);
+    ++r->calls;
+    for (std::size_t i = 0; i < ctx.nframes; ++i) {
+        ctx.out[0][i] = r->next;
+        ctx.out[1][i] = -r->next;
+        r->next += 1.0f / 4096.0f;
+    }
+}
+
+// The app config is built in one designated initializer, like main.cpp does:
+// assigning fields into a value-initialized SamplerAppConfig trips GCC 12's
+// -Wmaybe-uninitialized on the nested strings.
+SamplerEngineConfig offlineEngineConfig() {
+    SamplerEngineConfig engine{};
+    engine.trackCount = 2;
+    engine.blockFrames = 1024;
+    return engine;
+}
+
+SamplerIoConfig headlessIoConfig() {
+    return SamplerIoConfig{};
+}
+
+SamplerEngineConfig auxEngineConfig(uint8_t auxBuses) {
+    SamplerEngineConfig engine = offlineEngineConfig();
+    engine.auxBuses = auxBuses;
+    return engine;
+}
+
+} // namespace
+
+TEST_CASE("OfflineAudioHost: renders blocks synchronously on the caller thread") {
+    OfflineAudioHost host;
+    std::vector<float> l(512), r(512);
+    float* out[2] = {l.data(), r.data()};
+    // Nothing to render into before openStream.
+    REQUIRE_FALSE(host.renderBlock(out, 256));
+
+    StreamConfig cfg{};
+    cfg.blockFrames = 512;
+    cfg.numOutput = 2;
+    auto stream = host.openStream(cfg, "offline", "offline");
+    REQUIRE(stream);
+    REQUIRE_FALSE(host.renderBlock(out, 256)); // stream not started yet
+
+    RampRender ramp{};
+    REQUIRE(stream->start(&rampRender, &ramp));
+    REQUIRE(host.renderBlock(out, 512));
+    REQUIRE(host.renderBlock(out, 100)); // short tail block
+    REQUIRE_FALSE(host.renderBlock(out, 1024)); // larger than the declared blockFrames
+    REQUIRE(ramp.calls == 2);
+    REQUIRE(stream->totalCallbacks() == 2);
+    REQUIRE(stream->xruns() == 0);
+    REQUIRE(l[99] == Catch::Approx((512.0f + 99.0f) / 4096.0f));
+    REQUIRE(r[99] == Catch::Approx(-l[99]));
+
+    stream.reset();
+    REQUIRE_FALSE(host.renderBlock(out, 256)); // stream released by the engine
+}
+
+TEST_CASE("SamplerApplication: renderOffline bounces a pattern with a clip to WAV") {
+    // 0.5 s stereo sine clip at the engine rate.
+    constexpr int kRate = 48000;
+    std::vector<float> l(kRate / 2), r(kRate / 2);
+    for (std::size_t i = 0; i < l.size(); ++i) {
+        l[i] = 0.5f * std::sin(2.0f * 3.14159265f * 220.0f * static_cast<float>(i) / kRate);
+        r[i] = l[i];
+    }
+    const fs::path clipPath = fs::temp_directory_path() / "ag_offline_render_clip.wav";
+    const fs::path outPath = fs::temp_directory_path() / "ag_offline_render_out.wav";
+    {
+        WavFileWriter clipWriter;
+        std::string err;
+        const float* chs[2] = {l.data(), r.data()};
+        REQUIRE(clipWriter.open(clipPath.string(), kRate, 2, WavSampleFormat::Float32, err));
+        REQUIRE(clipWriter.write(chs, l.size()));
+        REQUIRE(clipWriter.close(err));
+    }
+
+    const SamplerAppConfig config{.engine = offlineEngineConfig(),
+                                  .io = headlessIoConfig(),
+                                  .startupClipLoads = {{0, clipPath.string()}}};
+    SamplerOfflineRenderConfig render{};
+    render.pattern = 1;
+    render.bars = 1;
+    render.tailSeconds = 0.25f;
+    render.outPath = outPath.string();
+    render.format = WavSampleFormat::Float32;
+
+    SamplerApplication app;
+    REQUIRE(app.renderOffline(config, render) == 0);
+
+    // One 4/4 bar at the default 120 BPM plus the tail, not rounded up to whole blocks.
+    ClipBufferPool pool;
+    std::string err;
+    REQUIRE(pool.loadFromFile(1, outPath.string(), &err));
+    SharedClipBuffer out{};
+    REQUIRE(pool.get(1, out));
+    REQUIRE(out.sampleRate == kRate);
+    REQUIRE(out.channels == 2);
+    REQUIRE(out.frames == kRate * 2 + kRate / 4);
+    float peak = 0.0f;
+    for (int i = 0; i < out.frames; ++i) {
+        peak = std::max(peak, std::fabs(out.ch0[static_cast<std::size_t>(i)]));
+    }
+    REQUIRE(peak > 0.1f);
+
+    fs::remove(clipPath);
+    fs::remove(outPath);
+}
+
+TEST_CASE("SamplerApplication: aux buses get a default reverb fed by the track sends") {
+    // 0.5 s looping clip: a 20 ms burst, then digital silence.
+    constexpr int kRate = 48000;
+    std::vector<float> l(kRate / 2, 0.0f);
+    for (std::size_t i = 0; i < static_cast<std::size_t>(kRate / 50); ++i) {
+        l[i] = 0.5f * std::sin(2.0f * 3.14159265f * 440.0f * static_cast<float>(i) / kRate);
+    }
+    const fs::path clipPath = fs::temp_directory_path() / "ag_offline_aux_clip.wav";
+    const fs::path outPath = fs::temp_directory_path() / "ag_offline_aux_out.wav";
+    {
+        WavFileWriter clipWriter;
+        std::string err;
+        const float* chs[2] = {l.data(), l.data()};
+        REQUIRE(clipWriter.open(clipPath.string(), kRate, 2, WavSampleFormat::Float32, err));
+        REQUIRE(clipWriter.write(chs, l.size()));
+        REQUIRE(clipWriter.close(err));
+    }
+
+    // Share of the bounced bar that is silent: the reverb return fills the gaps between bursts.
+    auto silentShare = [&](uint8_t auxBuses, float send) {
+        const SamplerAppConfig config{.engine = auxEngineConfig(auxBuses),
+                                      .io = headlessIoConfig(),
+                                      .startupClipLoads = {{0, clipPath.string()}},
+                                      .auxSendLevel = send};
+        SamplerOfflineRenderConfig render{};
+        render.pattern = 1;
+        render.bars = 1;
+        render.outPath = outPath.string();
+        render.format = WavSampleFormat::Float32;
+        SamplerApplication app;
+        REQUIRE(app.renderOffline(config, render) == 0);
+
+        ClipBufferPool pool;
+        std::string err;
+        REQUIRE(pool.loadFromFile(1, outPath.string(), &err));
+        SharedClipBuffer out{};
+        REQUIRE(pool.get(1, out));
+        REQUIRE(out.frames > 0);
+        int silent = 0;
+        for (int i = 0; i < out.frames; ++i) {
+            if (std::fabs(out.ch0[static_cast<std::size_t>(i)]) < 1e-5f) {
+                ++silent;
+            }
+        }
+        return static_cast<double>(silent) / out.frames;
+    };
+
+    const double dry = silentShare(0, 1.0f);         // no buses: the send goes nowhere
+    const double unsent = silentShare(1, 0.0f);      // bus with the reverb, sends left at 0
+    const double wet = silentShare(1, 1.0f);
+    REQUIRE(dry > 0.5);
+    REQUIRE(unsent == Catch::Approx(dry).margin(0.01));
+    REQUIRE(wet < 0.2);
+
+    fs::remove(clipPath);
+    fs::remove(outPath);
+}
@@ -186,3 +186,46 @@ TEST_CASE("SchroederReverb: high wet keeps reasonable loudness") {
     REQUIRE(dryRms > 1e-4f);
     REQUIRE(wetRms > dryRms * 0.65f);
 }
+
+TEST_CASE("SchroederReverb: output falls below silence level within tailFrames") {
+    SchroederReverbModule rev;
+    rev.init(48000.0, 512);
+    rev.setParam(SchroederReverbModule::P_WET, 1.0f);
+    rev.setParam(SchroederReverbModule::P_ROOM, 0.0f);
+    rev.setParam(SchroederReverbModule::P_DAMP, 0.0f);
+    rev.beginBlock();
+    const uint32_t smallRoomTail = rev.tailFrames();
+    REQUIRE(smallRoomTail > 0U);
+    REQUIRE(smallRoomTail < IAudioModule::kInfiniteTailFrames);
+
+    // Worst case for the combs: full-scale DC drives them to resonance.
+    StereoBlock b(512);
+    std::fill(b.inL.begin(), b.inL.end(), 1.0f);
+    std::fill(b.inR.begin(), b.inR.end(), 1.0f);
+    for (int iter = 0; iter < 40; ++iter) {
+        rev.beginBlock();
+        rev.process(b.ctx);
+    }
+
+    std::fill(b.inL.begin(), b.inL.end(), 0.0f);
+    std::fill(b.inR.begin(), b.inR.end(), 0.0f);
+    uint64_t quiet = 0;
+    while (quiet < smallRoomTail) {
+        rev.beginBlock();
+        rev.process(b.ctx);
+        quiet += b.inL.size();
+    }
+    for (int iter = 0; iter < 8; ++iter) {
+        rev.beginBlock();
+        rev.process(b.ctx);
+        for (std::size_t i = 0; i < b.outL.size(); ++i) {
+            REQUIRE(std::abs(b.outL[i]) < IAudioModule::kSilenceLevel);
+            REQUIRE(std::abs(b.outR[i]) < IAudioModule::kSilenceLevel);
+        }
+    }
+
+    // A larger room rings longer.
+    rev.setParam(SchroederReverbModule::P_ROOM, 1.0f);
+    rev.beginBlock();
+    REQUIRE(rev.tailFrames() > smallRoomTail);
+}
@@ -0,0 +1,204 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "contracts/WavDecoder.h"
+#include "service/audio/StemRecorder.h"
+
+using namespace avantgarde;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int kRate = 48000;
+constexpr int kBlock = 256;
+
+// Frame index encoded in the sample (exact in float32), negated on the right channel.
+void fillBlock(int blockIndex, float sign, std::vector<float>& l, std::vector<float>& r) {
+    for (int i = 0; i < kBlock; ++i) {
+        const float v = sign * static_cast<float>(blockIndex * kBlock + i + 1) / 1048576.0f;
+        l[static_cast<std::size_t>(i)] = v;
+        r[static_cast<std::size_t>(i)] = -v;
+    }
+}
+
+} // namespace
+
+TEST_CASE("StemRecorder: stems stay frame-aligned and dropped blocks become silence") {
+    const fs::path dir = fs::temp_directory_path();
+    const std::vector<std::string> paths = {
+        (dir / "avantgarde_stem_01.wav").string(),
+        (dir / "avantgarde_stem_02.wav").string(),
+    };
+    // ~10 ms rings: a burst overflows them before the writer's first pass.
+    StemRecorder rec(0.01);
+    RecordConfig cfg{};
+    cfg.sampleRate = kRate;
+    cfg.bitDepth = 32;
+    REQUIRE(rec.start(paths, cfg));
+    REQUIRE(rec.isRecording());
+    REQUIRE(rec.stemCount() == 2u);
+
+    AudioProcessContext ctx{};
+    ctx.nframes = kBlock;
+    std::vector<float> l(kBlock), r(kBlock);
+    const float* ch[2] = {l.data(), r.data()};
+
+    // Before the first block boundary the stems are still closed.
+    fillBlock(0, 1.0f, l, r);
+    REQUIRE(rec.stemSink(0)->writeBlock(ch, kBlock));
+
+    constexpr int kBlocks = 400;
+    for (int b = 0; b < kBlocks; ++b) {
+        rec.onBlockBegin(ctx);
+        for (std::size_t s = 0; s < 2; ++s) {
+            fillBlock(b, s == 0 ? 1.0f : 2.0f, l, r);
+            (void)rec.stemSink(s)->writeBlock(ch, kBlock);
+        }
+        rec.onBlockEnd(ctx);
+    }
+    rec.stop();
+    REQUIRE_FALSE(rec.isRecording());
+    REQUIRE(rec.lastError().empty());
+    REQUIRE(rec.droppedBlocks() > 0u);
+    REQUIRE(rec.stemFramesWritten(0) == static_cast<uint64_t>(kBlocks * kBlock));
+    REQUIRE(rec.stemFramesWritten(1) == static_cast<uint64_t>(kBlocks * kBlock));
+
+    for (std::size_t s = 0; s < 2; ++s) {
+        WavDecodedPlanar decoded{};
+        std::string error;
+        REQUIRE(decodeWavFile(paths[s], decoded, &error));
+        REQUIRE(decoded.channels == 2);
+        REQUIRE(decoded.frames == kBlocks * kBlock);
+        // Every frame is either its own value or silence, so nothing has shifted.
+        int silent = 0;
+        for (int b = 0; b < kBlocks; ++b) {
+            fillBlock(b, s == 0 ? 1.0f : 2.0f, l, r);
+            const std::size_t at = static_cast<std::size_t>(b * kBlock);
+            if (decoded.ch0[at] == 0.0f) {
+                ++silent;
+                for (int i = 0; i < kBlock; ++i) {
+                    REQUIRE(decoded.ch0[at + static_cast<std::size_t>(i)] == 0.0f);
+                }
+                continue;
+            }
+            for (int i = 0; i < kBlock; ++i) {
+                REQUIRE(decoded.ch0[at + static_cast<std::size_t>(i)] == l[static_cast<std::size_t>(i)]);
+                REQUIRE(decoded.ch1[at + static_cast<std::size_t>(i)] == r[static_cast<std::size_t>(i)]);
+            }
+        }
+        REQUIRE(silent > 0);
+        fs::remove(paths[s]);
+    }
+
+    // Outside a recording the sinks are no-ops.
+    rec.onBlockBegin(ctx);
+    REQUIRE(rec.stemSink(0)->writeBlock(ch, kBlock));
+    REQUIRE(rec.stemSink(StemRecorder::kMaxStems) == nullptr);
+}
+
+TEST_CASE("StemRecorder: bad configs and unwritable paths are rejected") {
+    const fs::path p = fs::temp_directory_path() / "avantgarde_stem_bad.wav";
+    fs::remove(p);
+    StemRecorder rec;
+    RecordConfig cfg{};
+    cfg.sampleRate = kRate;
+    cfg.bitDepth = 20;
+    REQUIRE_FALSE(rec.start({p.string()}, cfg));
+    REQUIRE_FALSE(rec.lastError().empty());
+    cfg.bitDepth = 24;
+    REQUIRE_FALSE(rec.start({}, cfg));
+    REQUIRE_FALSE(rec.start({p.string(), "/nonexistent_dir/avantgarde_stem.wav"}, cfg));
+    REQUIRE_FALSE(rec.isRecording());
+    fs::remove(p);
+}
+
+TEST_CASE("StemRecorder: stop racing the block boundary keeps stems the same length") {
+    const fs::path dir = fs::temp_directory_path();
+    const std::vector<std::string> paths = {
+        (dir / "avantgarde_stem_race_01.wav").string(),
+        (dir / "avantgarde_stem_race_02.wav").string(),
+        (dir / "avantgarde_stem_race_03.wav").string(),
+    };
+    RecordConfig cfg{};
+    cfg.sampleRate = kRate;
+    cfg.bitDepth = 16;
+
+    auto requireSameLength = [&](const StemRecorder& rec) {
+        REQUIRE(rec.lastError().empty());
+        const uint64_t frames = rec.stemFramesWritten(0);
+        REQUIRE(frames > 0u);
+        REQUIRE(frames % kBlock == 0u);
+        for (std::size_t s = 1; s < paths.size(); ++s) {
+            REQUIRE(rec.stemFramesWritten(s) == frames);
+        }
+        for (const std::string& p : paths) {
+            WavDecodedPlanar decoded{};
+            REQUIRE(decodeWavFile(p, decoded));
+            REQUIRE(static_cast<uint64_t>(decoded.frames) == frames);
+        }
+    };
+
+    AudioProcessContext ctx{};
+    ctx.nframes = kBlock;
+    std::vector<float> l(kBlock, 0.25f), r(kBlock, -0.25f);
+    const float* ch[2] = {l.data(), r.data()};
+
+    SECTION("audio thread stalls mid-block past the close timeout") {
+        StemRecorder rec;
+        REQUIRE(rec.start(paths, cfg));
+        for (int b = 0; b < 3; ++b) {
+            rec.onBlockBegin(ctx);
+            for (std::size_t s = 0; s < paths.size(); ++s) {
+                (void)rec.stemSink(s)->writeBlock(ch, kBlock);
+            }
+        }
+        // Only the first stem gets this block before stop() gives up waiting.
+        rec.onBlockBegin(ctx);
+        (void)rec.stemSink(0)->writeBlock(ch, kBlock);
+        std::thread control([&]() { rec.stop(); });
+        control.join();
+        for (std::size_t s = 1; s < paths.size(); ++s) {
+            (void)rec.stemSink(s)->writeBlock(ch, kBlock);
+        }
+        requireSameLength(rec);
+    }
+
+    SECTION("stop lands on random block boundaries") {
+        for (int round = 0; round < 20; ++round) {
+            StemRecorder rec;
+            REQUIRE(rec.start(paths, cfg));
+            std::atomic<bool> quit{false};
+            std::atomic<int> blocks{0};
+            // Audio thread: back-to-back blocks, the stems written one after another.
+            std::thread audio([&]() {
+                while (!quit.load()) {
+                    rec.onBlockBegin(ctx);
+                    for (std::size_t s = 0; s < paths.size(); ++s) {
+                        (void)rec.stemSink(s)->writeBlock(ch, kBlock);
+                        std::this_thread::yield();
+                    }
+                    rec.onBlockEnd(ctx);
+                    blocks.fetch_add(1);
+                }
+            });
+            while (blocks.load() < 4 + round) {
+                std::this_thread::yield();
+            }
+            rec.stop();
+            quit = true;
+            audio.join();
+            requireSameLength(rec);
+        }
+    }
+
+    for (const std::string& p : paths) {
+        fs::remove(p);
+    }
+}
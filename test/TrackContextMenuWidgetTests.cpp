@@ -15,7 +15,7 @@ TEST_CASE("TrackContextMenuWidget: list navigation wraps between menu items") {
 
     const WidgetOutput up = widget.onGesture(UiGesture::ListUp, state, nav);
     REQUIRE(up.handled);
-    REQUIRE(nav.sceneActionIndex == 4);
+    REQUIRE(nav.sceneActionIndex == 5);
 
     const WidgetOutput down = widget.onGesture(UiGesture::ListDown, state, nav);
     REQUIRE(down.handled);
@@ -114,3 +114,30 @@ TEST_CASE("TrackContextMenuWidget: apply PATTERN EDIT opens pattern edit scene")
     REQUIRE(out.intents[0].scene == UiScene::PatternEdit);
     REQUIRE(out.intents[0].resetSceneActionIndex);
 }
+
+TEST_CASE("TrackContextMenuWidget: FREEZE toggles by selected track frozen state") {
+    TrackContextMenuWidget widget(60);
+    UiState state{};
+    state.tracks.resize(2);
+
+    UiNavState nav{};
+    nav.scene = UiScene::TrackContext;
+    nav.selectedTrack = 1;
+    nav.sceneActionIndex = 5; // FREEZE
+
+    const WidgetOutput freeze = widget.onGesture(UiGesture::ListEnter, state, nav);
+    REQUIRE(freeze.handled);
+    REQUIRE(freeze.intents.size() == 2);
+    REQUIRE(freeze.intents[0].type == UiIntentType::SetTrackFrozen);
+    REQUIRE(freeze.intents[0].track == 1);
+    REQUIRE(freeze.intents[0].value == 1.0f);
+    REQUIRE(freeze.intents[1].type == UiIntentType::Back);
+    REQUIRE(freeze.intents[1].scene == UiScene::Tracks);
+
+    state.tracks[1].frozen = true;
+    nav.sceneActionIndex = 5; // UNFREEZE
+    const WidgetOutput unfreeze = widget.onGesture(UiGesture::ListEnter, state, nav);
+    REQUIRE(unfreeze.intents.size() == 2);
+    REQUIRE(unfreeze.intents[0].type == UiIntentType::SetTrackFrozen);
+    REQUIRE(unfreeze.intents[0].value == 0.0f);
+}
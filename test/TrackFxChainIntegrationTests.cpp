@@ -50,10 +50,17 @@ struct MockQueue final : IRtCommandQueue {
 
 struct GainFxModule final : IAudioModule {
     float gain01{1.0f};
+    int calls{0};
+    int resets{0};
     ParamMeta meta{"Gain", 0.0f, 1.0f, false, "x"};
 
     void init(double, std::size_t) override {}
-    void reset() override {}
+    void reset() override { ++resets; }
+    std::unique_ptr<IAudioModule> cloneForOffline(double, std::size_t) const override {
+        auto copy = std::make_unique<GainFxModule>();
+        copy->gain01 = gain01;
+        return copy;
+    }
     std::size_t getParamCount() const override { return 1; }
     float getParam(std::size_t) const override { return gain01; }
     void setParam(std::size_t index, float value) override {
@@ -64,6 +71,7 @@ struct GainFxModule final : IAudioModule {
     const ParamMeta& getParamMeta(std::size_t) const override { return meta; }
 
     void process(const AudioProcessContext& ctx) override {
+        ++calls;
         const float* in0 = ctx.in[0];
         const float* in1 = ctx.in[1] ? ctx.in[1] : in0;
         float* out0 = ctx.out[0];
@@ -75,6 +83,38 @@ struct GainFxModule final : IAudioModule {
     }
 };
 
+// Pure delay by `delay` frames (tail == delay); clonable for freeze.
+struct DelayFxModule final : IAudioModule {
+    std::size_t delay{20};
+    std::vector<float> ring{};
+    std::size_t pos{0};
+    ParamMeta meta{"noop", 0.0f, 1.0f, false, ""};
+
+    void init(double, std::size_t) override { ring.assign(delay, 0.0f); pos = 0; }
+    void reset() override { std::fill(ring.begin(), ring.end(), 0.0f); }
+    uint32_t tailFrames() const noexcept override { return static_cast<uint32_t>(delay); }
+    std::unique_ptr<IAudioModule> cloneForOffline(double sampleRate, std::size_t maxFrames) const override {
+        auto copy = std::make_unique<DelayFxModule>();
+        copy->delay = delay;
+        copy->init(sampleRate, maxFrames);
+        return copy;
+    }
+    std::size_t getParamCount() const override { return 0; }
+    float getParam(std::size_t) const override { return 0.0f; }
+    void setParam(std::size_t, float) override {}
+    const ParamMeta& getParamMeta(std::size_t) const override { return meta; }
+
+    void process(const AudioProcessContext& ctx) override {
+        for (std::size_t i = 0; i < ctx.nframes; ++i) {
+            const float x = ctx.in[0][i];
+            ctx.out[0][i] = ring[pos];
+            ctx.out[1][i] = ring[pos];
+            ring[pos] = x;
+            pos = (pos + 1) % delay;
+        }
+    }
+};
+
 static std::array<ITrack*, 2> gTracks{};
 
 IParameterized* ResolveTarget(Target t) noexcept {
@@ -243,3 +283,257 @@ TEST_CASE("ClipTrack FX slot can be bypassed without removing module") {
     engine->processBlock(ctx);
     REQUIRE(out0[0] == Catch::Approx(1.0f).margin(0.08f));
 }
+
+TEST_CASE("ClipTrack FX chain removal keeps module alive until RT acknowledges new snapshot") {
+    struct LifetimeFxModule final : IAudioModule {
+        bool* destroyed{nullptr};
+        ParamMeta meta{"Lifetime", 0.0f, 1.0f, false, ""};
+        explicit LifetimeFxModule(bool* flag) : destroyed(flag) {}
+        ~LifetimeFxModule() override { *destroyed = true; }
+        void init(double, std::size_t) override {}
+        void reset() override {}
+        std::size_t getParamCount() const override { return 0; }
+        float getParam(std::size_t) const override { return 0.0f; }
+        void setParam(std::size_t, float) override {}
+        const ParamMeta& getParamMeta(std::size_t) const override { return meta; }
+        void process(const AudioProcessContext& ctx) override {
+            for (std::size_t i = 0; i < ctx.nframes; ++i) {
+                ctx.out[0][i] = ctx.in[0][i];
+                ctx.out[1][i] = ctx.in[1][i];
+            }
+        }
+    };
+
+    ClipTrackImpl tr;
+    const fs::path tmp = fs::temp_directory_path() / "ag_fx_chain_reclaim.wav";
+    std::vector<int16_t> pcm(32, 16384);
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+    REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()));
+    REQUIRE(tr.setSlotLooping(0, true));
+
+    bool destroyed = false;
+    tr.addModule(std::make_unique<LifetimeFxModule>(&destroyed));
+    tr.addModule(std::make_unique<GainFxModule>());
+    tr.onRtCommand(makeCmd(CmdId::Play, 0, 0, 0, 1.0f));
+
+    std::vector<float> out0(16, 0.0f), out1(16, 0.0f);
+    auto ctx = makeCtx(out0, out1);
+    tr.process(ctx);
+
+    // RT has not picked up the snapshot without the module yet: it must stay alive.
+    REQUIRE(tr.removeModuleAt(0));
+    tr.reclaimRetiredFx();
+    REQUIRE_FALSE(destroyed);
+    REQUIRE(tr.getModule(1) == nullptr);
+    REQUIRE(tr.getModule(0) != nullptr);
+
+    // Enabled flag travels with the slot when indices shift.
+    tr.onRtCommand(makeCmd(CmdId::ParamSet, 0, 0, toParamIndex(FxCommonParamId::Enabled), 0.0f));
+    std::fill(out0.begin(), out0.end(), 0.0f);
+    tr.process(ctx);
+    REQUIRE(out0[0] == Catch::Approx(0.5f).margin(0.05f));
+
+    // Once RT runs on the new snapshot, the control-side tick reclaims the stale one
+    // without waiting for another chain edit.
+    tr.reclaimRetiredFx();
+    REQUIRE(destroyed);
+}
+
+TEST_CASE("Engine: DSP load profiler attributes block time to tracks and their FX slots") {
+    MockQueue q;
+    auto engine = MakeAudioEngine(&q, nullptr);
+
+    auto tr0 = std::make_unique<ClipTrackImpl>();
+    auto tr1 = std::make_unique<ClipTrackImpl>();
+    const fs::path tmp = fs::temp_directory_path() / "ag_fx_chain_dsp_load.wav";
+    std::vector<int16_t> pcm(64, 16000);
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+    REQUIRE(tr0->loadSlotFromFile(0, tmp.string().c_str()));
+    REQUIRE(tr0->setSlotLooping(0, true));
+    tr0->addModule(std::make_unique<GainFxModule>());
+    tr0->addModule(std::make_unique<GainFxModule>());
+    engine->registerTrack(std::move(tr0));
+    engine->registerTrack(std::move(tr1)); // empty track: timed as a whole, no FX sites
+
+    q.push(makeCmd(CmdId::Play, 0, 0, 0, 1.0f));
+    std::vector<float> out0(64, 0.0f), out1(64, 0.0f);
+    auto ctx = makeCtx(out0, out1);
+    constexpr int kBlocks = 20;
+    for (int i = 0; i < kBlocks; ++i) {
+        engine->processBlock(ctx);
+    }
+
+    DspLoadCapture cap;
+    engine->captureDspLoad(cap);
+    auto countOf = [&cap](DspLoadSiteKind kind, uint16_t owner, uint16_t slot) -> uint64_t {
+        for (const auto& s : cap.sites) {
+            if (s.kind == kind && s.owner == owner && s.slot == slot) return s.count;
+        }
+        return 0;
+    };
+    REQUIRE(countOf(DspLoadSiteKind::Block, 0, 0) == kBlocks);
+    REQUIRE(countOf(DspLoadSiteKind::MasterBus, 0, 0) == kBlocks);
+    REQUIRE(countOf(DspLoadSiteKind::Track, 0, 0) == kBlocks);
+    REQUIRE(countOf(DspLoadSiteKind::Track, 1, 0) == kBlocks);
+    REQUIRE(countOf(DspLoadSiteKind::TrackFx, 0, 0) == kBlocks);
+    REQUIRE(countOf(DspLoadSiteKind::TrackFx, 0, 1) == kBlocks);
+    REQUIRE(countOf(DspLoadSiteKind::TrackFx, 1, 0) == 0);
+
+    DspLoadReport report;
+    DspLoadProfiler::buildReport(cap, nullptr, 1000.0, report);
+    REQUIRE(report.block.blocks == kBlocks);
+    REQUIRE(report.block.meanUs > 0.0f);
+    REQUIRE(report.siteCount >= 5);
+    fs::remove(tmp);
+}
+
+TEST_CASE("ClipTrack freeze plays the offline render and bypasses the live FX chain") {
+    // Three sine cycles per loop: smooth across the wrap, so live and frozen must agree.
+    std::vector<int16_t> pcm(300);
+    for (std::size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = static_cast<int16_t>(16384.0 * std::sin(2.0 * 3.14159265358979 * 3.0 * static_cast<double>(i) / 300.0));
+    }
+    const fs::path tmp = fs::temp_directory_path() / "ag_fx_chain_freeze.wav";
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+
+    ClipTrackImpl live;
+    ClipTrackImpl frozen;
+    std::array<GainFxModule*, 2> fx{};
+    std::array<ClipTrackImpl*, 2> tracks{&live, &frozen};
+    for (std::size_t i = 0; i < tracks.size(); ++i) {
+        REQUIRE(tracks[i]->loadSlotFromFile(0, tmp.string().c_str()));
+        REQUIRE(tracks[i]->setSlotLooping(0, true));
+        auto gain = std::make_unique<GainFxModule>();
+        fx[i] = gain.get();
+        tracks[i]->addModule(std::move(gain));
+        tracks[i]->getModule(0)->setParam(0, 0.5f);
+        tracks[i]->setParam(toParamIndex(TrackParamId::PlaybackInc), 0.75f);
+    }
+
+    TrackFreezeJob job;
+    REQUIRE(frozen.captureFreezeJob(job));
+    REQUIRE(job.fx.size() == 1);
+    SharedClipBuffer rendered{};
+    REQUIRE(frozen.renderFreezeJob(job, rendered));
+    // One loop pass at speed 0.75, already in the output rate.
+    REQUIRE(rendered.frames == 400);
+    REQUIRE(rendered.sampleRate == 48000);
+    REQUIRE(frozen.applyFreeze(job, rendered));
+    REQUIRE(frozen.isFrozen());
+    // Speed is baked into the buffer, the track parameter itself is untouched.
+    REQUIRE(frozen.getParam(toParamIndex(TrackParamId::PlaybackInc)) == Catch::Approx(0.75f));
+
+    live.onRtCommand(makeCmd(CmdId::Play, 0, 0, 0, 1.0f));
+    frozen.onRtCommand(makeCmd(CmdId::Play, 0, 0, 0, 1.0f));
+    std::vector<float> l0(128, 0.0f), l1(128, 0.0f), f0(128, 0.0f), f1(128, 0.0f);
+    auto runBlock = [&]() {
+        std::fill(l0.begin(), l0.end(), 0.0f);
+        std::fill(l1.begin(), l1.end(), 0.0f);
+        std::fill(f0.begin(), f0.end(), 0.0f);
+        std::fill(f1.begin(), f1.end(), 0.0f);
+        live.process(makeCtx(l0, l1));
+        frozen.process(makeCtx(f0, f1));
+        for (std::size_t i = 0; i < f0.size(); ++i) {
+            REQUIRE(f0[i] == Catch::Approx(l0[i]).margin(2e-3));
+            REQUIRE(f1[i] == Catch::Approx(l1[i]).margin(2e-3));
+        }
+    };
+    // Several loop wraps: the frozen loop stays in phase with the live one.
+    for (int blk = 0; blk < 12; ++blk) {
+        runBlock();
+    }
+    REQUIRE(fx[0]->calls > 0);
+    REQUIRE(fx[1]->calls == 0);
+
+    // Unfreeze resumes the live chain from the same playback position.
+    // The chain is reset by the audio thread on the block that picks up the source clip.
+    const int resetsBefore = fx[1]->resets;
+    REQUIRE(frozen.unfreeze());
+    REQUIRE_FALSE(frozen.isFrozen());
+    REQUIRE(fx[1]->resets == resetsBefore);
+    runBlock();
+    REQUIRE(fx[1]->resets == resetsBefore + 1);
+    for (int blk = 0; blk < 3; ++blk) {
+        runBlock();
+    }
+    REQUIRE(fx[1]->resets == resetsBefore + 1);
+    REQUIRE(fx[1]->calls > 0);
+}
+
+TEST_CASE("ClipTrack freeze wraps FX tails into the loop and appends them to one-shots") {
+    // Impulse near the end of a 100-frame clip through a 20-frame delay.
+    std::vector<int16_t> pcm(100, 0);
+    pcm[90] = 32767;
+    const fs::path tmp = fs::temp_directory_path() / "ag_fx_chain_freeze_tail.wav";
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+
+    for (const bool loop : {true, false}) {
+        ClipTrackImpl tr;
+        REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()));
+        REQUIRE(tr.setSlotLooping(0, loop));
+        tr.addModule(std::make_unique<DelayFxModule>());
+
+        TrackFreezeJob job;
+        REQUIRE(tr.captureFreezeJob(job));
+        SharedClipBuffer rendered{};
+        REQUIRE(tr.renderFreezeJob(job, rendered));
+        REQUIRE(rendered.channels == 2);
+        if (loop) {
+            // Steady-state loop: the echo of frame 90 lands at frame 10 of the next pass.
+            REQUIRE(rendered.frames == 100);
+            REQUIRE(rendered.ch0[10] == Catch::Approx(1.0f).margin(1e-3));
+        } else {
+            // Region plus the audible part of the tail.
+            REQUIRE(rendered.frames == 111);
+            REQUIRE(rendered.ch0[110] == Catch::Approx(1.0f).margin(1e-3));
+            REQUIRE(std::fabs(rendered.ch0[10]) < 1e-6f);
+        }
+    }
+}
+
+TEST_CASE("ClipTrack freeze is dropped when the track changes under it") {
+    const fs::path tmp = fs::temp_directory_path() / "ag_fx_chain_freeze_stale.wav";
+    std::vector<int16_t> pcm(64, 16384);
+    write_wav_pcm16(tmp, 48000, 1, pcm);
+
+    ClipTrackImpl tr;
+    REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()));
+    tr.addModule(std::make_unique<GainFxModule>());
+
+    // FX chain edited while the render was running.
+    TrackFreezeJob chainJob;
+    REQUIRE(tr.captureFreezeJob(chainJob));
+    SharedClipBuffer rendered{};
+    REQUIRE(tr.renderFreezeJob(chainJob, rendered));
+    tr.addModule(std::make_unique<GainFxModule>());
+    REQUIRE_FALSE(tr.applyFreeze(chainJob, rendered));
+
+    // Clip replaced while the render was running.
+    TrackFreezeJob clipJob;
+    REQUIRE(tr.captureFreezeJob(clipJob));
+    REQUIRE(tr.renderFreezeJob(clipJob, rendered));
+    REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()));
+    REQUIRE_FALSE(tr.applyFreeze(clipJob, rendered));
+
+    // A module that cannot be cloned makes the track unfreezable.
+    struct OpaqueFx final : IAudioModule {
+        ParamMeta meta{"noop", 0.0f, 1.0f, false, ""};
+        void init(double, std::size_t) override {}
+        void reset() override {}
+        std::size_t getParamCount() const override { return 0; }
+        float getParam(std::size_t) const override { return 0.0f; }
+        void setParam(std::size_t, float) override {}
+        const ParamMeta& getParamMeta(std::size_t) const override { return meta; }
+        void process(const AudioProcessContext&) override {}
+    };
+    TrackFreezeJob job;
+    REQUIRE(tr.captureFreezeJob(job));
+    REQUIRE(tr.renderFreezeJob(job, rendered));
+    REQUIRE(tr.applyFreeze(job, rendered));
+    REQUIRE_FALSE(tr.captureFreezeJob(job)); // already frozen
+    // Loading new material into the slot lifts the freeze.
+    REQUIRE(tr.loadSlotFromFile(0, tmp.string().c_str()));
+    REQUIRE_FALSE(tr.isFrozen());
+    tr.addModule(std::make_unique<OpaqueFx>());
+    REQUIRE_FALSE(tr.captureFreezeJob(job));
+}
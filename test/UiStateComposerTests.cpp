@@ -49,3 +49,57 @@ TEST_CASE("UiStateComposer: merges runtime telemetry with UiState snapshot") {
     REQUIRE(out.telemetry.xruns == 3);
     REQUIRE(out.telemetry.rtQueueOverflow == true);
 }
+
+TEST_CASE("UiStateComposer: maps engine meter frame onto master and tracks") {
+    UiStateComposer composer;
+    UiState base{};
+    base.tracks.resize(3);
+    for (uint8_t t = 0; t < 3; ++t) base.tracks[t].id = t;
+
+    EngineMeterFrame frame{};
+    frame.trackCount = 2;
+    frame.tracks[0] = LevelMeter{0.5f, 0.25f};
+    frame.tracks[1] = LevelMeter{0.9f, 0.6f};
+    frame.master[0] = LevelMeter{0.95f, 0.7f};
+    frame.master[1] = LevelMeter{0.85f, 0.65f};
+    frame.limiterGain = 0.8f;
+
+    UiRuntimeTelemetryView rt{};
+    rt.meters = &frame;
+    const UiState out = composer.compose(base, rt);
+
+    REQUIRE(out.telemetry.masterPeak[0] == Catch::Approx(0.95f));
+    REQUIRE(out.telemetry.masterRms[1] == Catch::Approx(0.65f));
+    REQUIRE(out.telemetry.limiterGain == Catch::Approx(0.8f));
+    REQUIRE(out.tracks[0].meterPeak == Catch::Approx(0.5f));
+    REQUIRE(out.tracks[1].meterRms == Catch::Approx(0.6f));
+    REQUIRE(out.tracks[2].meterPeak == 0.0f); // not metered by the engine
+
+    // Without a frame the meters stay at their defaults.
+    const UiState plain = composer.compose(base, UiRuntimeTelemetryView{});
+    REQUIRE(plain.telemetry.limiterGain == 1.0f);
+}
+
+TEST_CASE("UiStateComposer: maps DSP load report onto telemetry") {
+    UiStateComposer composer;
+    DspLoadReport report{};
+    report.block.meanPct = 31.0f;
+    report.block.p99Pct = 72.5f;
+    report.siteCount = 2;
+    report.sites[0].kind = DspLoadSiteKind::TrackFx;
+    report.sites[0].owner = 2;
+    report.sites[0].slot = 1;
+    report.sites[0].p99Pct = 40.0f;
+    report.sites[1].kind = DspLoadSiteKind::Track;
+
+    UiRuntimeTelemetryView rt{};
+    rt.dspLoad = &report;
+    const UiState out = composer.compose(UiState{}, rt);
+
+    REQUIRE(out.telemetry.dspLoadPct == Catch::Approx(31.0f));
+    REQUIRE(out.telemetry.dspLoadP99Pct == Catch::Approx(72.5f));
+    REQUIRE(out.telemetry.dspTopKind == DspLoadSiteKind::TrackFx);
+    REQUIRE(out.telemetry.dspTopOwner == 2);
+    REQUIRE(out.telemetry.dspTopSlot == 1);
+    REQUIRE(out.telemetry.dspTopP99Pct == Catch::Approx(40.0f));
+}
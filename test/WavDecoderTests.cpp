@@ -0,0 +1,227 @@
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "contracts/WavDecoder.h"
+
+namespace fs = std::filesystem;
+using namespace avantgarde;
+
+namespace {
+
+struct WavSpec {
+    uint16_t tag{1};      // 1 = PCM, 3 = float
+    uint16_t bits{16};
+    uint16_t channels{2};
+    bool extensible{false};
+    bool rf64{false};
+    uint32_t declaredDataBytes{0}; // 0 = actual size
+};
+
+void put16(std::vector<uint8_t>& b, uint16_t v) {
+    b.push_back(static_cast<uint8_t>(v));
+    b.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void put32(std::vector<uint8_t>& b, uint32_t v) {
+    put16(b, static_cast<uint16_t>(v));
+    put16(b, static_cast<uint16_t>(v >> 16));
+}
+
+void put64(std::vector<uint8_t>& b, uint64_t v) {
+    put32(b, static_cast<uint32_t>(v));
+    put32(b, static_cast<uint32_t>(v >> 32));
+}
+
+void putTag(std::vector<uint8_t>& b, const char* tag) {
+    b.insert(b.end(), tag, tag + 4);
+}
+
+// Deterministic interleaved payload that exercises the full range, including negative values.
+std::vector<uint8_t> makePayload(const WavSpec& spec, uint32_t frames) {
+    const uint32_t bytes = spec.bits / 8u;
+    std::vector<uint8_t> data;
+    for (uint32_t i = 0; i < frames * spec.channels; ++i) {
+        const float x = 1.1f * std::sin(0.37f * static_cast<float>(i));
+        if (spec.tag == 3) {
+            uint32_t u = 0;
+            std::memcpy(&u, &x, 4);
+            put32(data, u);
+        } else {
+            const auto v = static_cast<uint32_t>(static_cast<int32_t>(std::clamp(x, -1.0f, 0.999f) * 2147483647.0f));
+            for (uint32_t k = 4u - bytes; k < 4u; ++k) {
+                data.push_back(static_cast<uint8_t>(v >> (8u * k)));
+            }
+        }
+    }
+    return data;
+}
+
+fs::path writeWav(const std::string& name, const WavSpec& spec, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> b;
+    putTag(b, spec.rf64 ? "RF64" : "RIFF");
+    put32(b, spec.rf64 ? 0xFFFFFFFFu : 0u);
+    putTag(b, "WAVE");
+    if (spec.rf64) {
+        putTag(b, "ds64");
+        put32(b, 28);
+        put64(b, 0);
+        put64(b, data.size());
+        put64(b, 0);
+        put32(b, 0);
+    }
+    // A chunk the decoder has to skip, with an odd size and a pad byte.
+    putTag(b, "LIST");
+    put32(b, 3);
+    b.insert(b.end(), {'a', 'b', 'c', 0});
+    putTag(b, "fmt ");
+    put32(b, spec.extensible ? 40u : 16u);
+    put16(b, spec.extensible ? 0xFFFEu : spec.tag);
+    put16(b, spec.channels);
+    put32(b, 44100);
+    put32(b, 44100u * spec.channels * spec.bits / 8u);
+    put16(b, static_cast<uint16_t>(spec.channels * spec.bits / 8u));
+    put16(b, spec.bits);
+    if (spec.extensible) {
+        put16(b, 22);
+        put16(b, spec.bits);
+        put32(b, spec.channels == 2 ? 3u : 4u);
+        put16(b, spec.tag);
+        b.insert(b.end(), {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71});
+    }
+    putTag(b, "data");
+    put32(b, spec.rf64 ? 0xFFFFFFFFu
+                       : (spec.declaredDataBytes ? spec.declaredDataBytes : static_cast<uint32_t>(data.size())));
+    b.insert(b.end(), data.begin(), data.end());
+
+    const fs::path path = fs::temp_directory_path() / name;
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(b.data()), static_cast<std::streamsize>(b.size()));
+    return path;
+}
+
+// Straightforward per-sample reference.
+float referenceSample(const WavSpec& spec, const std::vector<uint8_t>& data, uint32_t frame, uint32_t channel) {
+    const uint32_t bytes = spec.bits / 8u;
+    const uint8_t* p = data.data() + (static_cast<std::size_t>(frame) * spec.channels + channel) * bytes;
+    if (spec.tag == 3) {
+        float v = 0.0f;
+        std::memcpy(&v, p, 4);
+        return std::clamp(v, -1.0f, 1.0f);
+    }
+    int64_t v = 0;
+    for (uint32_t k = 0; k < bytes; ++k) {
+        v |= static_cast<int64_t>(p[k]) << (8u * k);
+    }
+    const int64_t sign = int64_t{1} << (8u * bytes - 1u);
+    v = (v ^ sign) - sign;
+    return static_cast<float>(static_cast<double>(v) / static_cast<double>(sign));
+}
+
+} // namespace
+
+TEST_CASE("WavDecoder: every encoding decodes exactly across chunk boundaries") {
+    const uint32_t frames = WavDecoder::kChunkFrames + 13u;
+    const WavSpec specs[] = {
+        {1, 16, 1}, {1, 16, 2}, {1, 24, 1}, {1, 24, 2}, {1, 32, 1}, {1, 32, 2}, {3, 32, 1}, {3, 32, 2},
+    };
+    for (const WavSpec& spec : specs) {
+        INFO("tag=" << spec.tag << " bits=" << spec.bits << " channels=" << spec.channels);
+        const std::vector<uint8_t> data = makePayload(spec, frames);
+        const fs::path path = writeWav("ag_wav_decoder_enc.wav", spec, data);
+
+        WavDecodedPlanar wav{};
+        std::string err;
+        REQUIRE(decodeWavFile(path.string(), wav, &err));
+        REQUIRE(wav.sampleRate == 44100);
+        REQUIRE(wav.channels == spec.channels);
+        REQUIRE(wav.frames == static_cast<int>(frames));
+        REQUIRE((wav.ch1 != nullptr) == (spec.channels == 2));
+        for (uint32_t i = 0; i < frames; ++i) {
+            REQUIRE(wav.ch0[i] == referenceSample(spec, data, i, 0));
+            if (spec.channels == 2) {
+                REQUIRE(wav.ch1[i] == referenceSample(spec, data, i, 1));
+            }
+        }
+        fs::remove(path);
+    }
+}
+
+TEST_CASE("WavDecoder: RF64 and WAVE_FORMAT_EXTENSIBLE headers") {
+    WavSpec spec{3, 32, 2};
+    spec.rf64 = true;
+    spec.extensible = true;
+    const std::vector<uint8_t> data = makePayload(spec, 1000);
+    const fs::path path = writeWav("ag_wav_decoder_rf64.wav", spec, data);
+
+    WavDecoder dec;
+    std::string err;
+    REQUIRE(dec.open(path.string(), &err));
+    REQUIRE(dec.isRf64());
+    REQUIRE(dec.encoding() == WavDecoder::Encoding::Float32);
+    REQUIRE(dec.frames() == 1000);
+    std::vector<float> l(1000), r(1000);
+    REQUIRE(dec.readAll(l.data(), r.data()));
+    REQUIRE(l[999] == referenceSample(spec, data, 999, 0));
+    REQUIRE(r[500] == referenceSample(spec, data, 500, 1));
+
+    WavSpec pcm24{1, 24, 1};
+    pcm24.extensible = true;
+    const std::vector<uint8_t> monoData = makePayload(pcm24, 300);
+    const fs::path monoPath = writeWav("ag_wav_decoder_ext24.wav", pcm24, monoData);
+    REQUIRE(dec.open(monoPath.string(), &err));
+    REQUIRE_FALSE(dec.isRf64());
+    REQUIRE(dec.encoding() == WavDecoder::Encoding::Pcm24);
+    REQUIRE(dec.channels() == 1);
+    fs::remove(path);
+    fs::remove(monoPath);
+}
+
+TEST_CASE("WavDecoder: random access, dropped channel and mono mixdown") {
+    const WavSpec spec{1, 16, 2};
+    const std::vector<uint8_t> data = makePayload(spec, 5000);
+    const fs::path path = writeWav("ag_wav_decoder_access.wav", spec, data);
+
+    WavDecoder dec;
+    REQUIRE(dec.open(path.string()));
+    std::vector<float> l(37);
+    REQUIRE(dec.read(4001, 37, l.data(), nullptr));
+    for (uint32_t i = 0; i < 37; ++i) {
+        REQUIRE(l[i] == referenceSample(spec, data, 4001 + i, 0));
+    }
+    REQUIRE_FALSE(dec.read(4990, 37, l.data(), nullptr));
+
+    int sampleRate = 0;
+    std::vector<float> mono;
+    REQUIRE(decodeWavFileMono(path.string(), sampleRate, mono));
+    REQUIRE(sampleRate == 44100);
+    REQUIRE(mono.size() == 5000u);
+    REQUIRE(mono[1234] == 0.5f * (referenceSample(spec, data, 1234, 0) + referenceSample(spec, data, 1234, 1)));
+    fs::remove(path);
+}
+
+TEST_CASE("WavDecoder: truncated data chunk and unsupported formats") {
+    WavSpec spec{1, 16, 1};
+    spec.declaredDataBytes = 1000000; // writer crashed before patching the size
+    const std::vector<uint8_t> data = makePayload(spec, 777);
+    const fs::path path = writeWav("ag_wav_decoder_trunc.wav", spec, data);
+    WavDecoder dec;
+    REQUIRE(dec.open(path.string()));
+    REQUIRE(dec.frames() == 777);
+
+    const WavSpec eightBit{1, 8, 1};
+    const fs::path bad = writeWav("ag_wav_decoder_u8.wav", eightBit, std::vector<uint8_t>(100, 0x80));
+    std::string err;
+    REQUIRE_FALSE(dec.open(bad.string(), &err));
+    REQUIRE(err == "unsupported wav format");
+    REQUIRE_FALSE(dec.isOpen());
+    fs::remove(path);
+    fs::remove(bad);
+}
@@ -0,0 +1,63 @@
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "service/audio/WavFileWriter.h"
+#include "service/pattern/ClipBufferPool.h"
+
+namespace fs = std::filesystem;
+using namespace avantgarde;
+
+TEST_CASE("WavFileWriter: s16/s24/f32 round-trip through ClipBufferPool decoder") {
+    constexpr std::size_t kFrames = 1000;
+    std::vector<float> l(kFrames), r(kFrames);
+    for (std::size_t i = 0; i < kFrames; ++i) {
+        l[i] = 0.8f * std::sin(0.05f * static_cast<float>(i));
+        r[i] = -0.5f * std::cos(0.03f * static_cast<float>(i));
+    }
+    // Out of range: PCM is clipped on write, the decoder clamps float on read.
+    l[10] = 1.5f;
+    const float* chs[2] = {l.data(), r.data()};
+
+    const auto format = GENERATE(WavSampleFormat::Pcm16, WavSampleFormat::Pcm24, WavSampleFormat::Float32);
+    const float tolerance = (format == WavSampleFormat::Pcm16) ? 1.0f / 16384.0f : 1.0f / 2'000'000.0f;
+    const fs::path path = fs::temp_directory_path() /
+                          ("ag_wav_writer_" + std::to_string(static_cast<int>(format)) + ".wav");
+
+    WavFileWriter writer;
+    std::string err;
+    REQUIRE(writer.open(path.string(), 44100, 2, format, err));
+    // Several chunks, the way the offline render writes.
+    REQUIRE(writer.write(chs, 300));
+    const float* tail[2] = {l.data() + 300, r.data() + 300};
+    REQUIRE(writer.write(tail, kFrames - 300));
+    REQUIRE(writer.framesWritten() == kFrames);
+    REQUIRE(writer.close(err));
+
+    ClipBufferPool pool;
+    REQUIRE(pool.loadFromFile(1, path.string(), &err));
+    SharedClipBuffer clip{};
+    REQUIRE(pool.get(1, clip));
+    REQUIRE(clip.sampleRate == 44100);
+    REQUIRE(clip.channels == 2);
+    REQUIRE(clip.frames == static_cast<int>(kFrames));
+    for (std::size_t i = 0; i < kFrames; ++i) {
+        const float expectL = std::min(l[i], 1.0f);
+        REQUIRE(std::fabs(clip.ch0[i] - expectL) <= tolerance);
+        REQUIRE(std::fabs(clip.ch1[i] - r[i]) <= tolerance);
+    }
+    fs::remove(path);
+}
+
+TEST_CASE("WavFileWriter: rejects unknown CLI format") {
+    WavSampleFormat f = WavSampleFormat::Pcm16;
+    REQUIRE(parseWavSampleFormat("f32", f));
+    REQUIRE(f == WavSampleFormat::Float32);
+    REQUIRE_FALSE(parseWavSampleFormat("mp3", f));
+    REQUIRE(f == WavSampleFormat::Float32);
+}
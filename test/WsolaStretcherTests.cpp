@@ -0,0 +1,176 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "contracts/ClipStretchAnalysis.h"
+#include "runtime/WsolaStretcher.h"
+
+using namespace avantgarde;
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586;
+constexpr int kRate = 48000;
+
+std::vector<float> sine(double hz, int frames, float amp = 0.5f) {
+    std::vector<float> out(static_cast<std::size_t>(frames));
+    for (int i = 0; i < frames; ++i) {
+        out[static_cast<std::size_t>(i)] = amp * static_cast<float>(std::sin(kTwoPi * hz * i / kRate));
+    }
+    return out;
+}
+
+// Short decaying bursts every `period` frames starting at `first`, silence in between.
+std::vector<float> clicks(int frames, int first, int period) {
+    std::vector<float> out(static_cast<std::size_t>(frames), 0.0f);
+    for (int at = first; at < frames; at += period) {
+        for (int k = 0; k < 64 && at + k < frames; ++k) {
+            const float sign = (k % 2 == 0) ? 1.0f : -1.0f;
+            out[static_cast<std::size_t>(at + k)] = sign * 0.9f * std::exp(-static_cast<float>(k) / 16.0f);
+        }
+    }
+    return out;
+}
+
+// Drives the stretcher the way ClipTrack does: the playhead advances by `inc` per output
+// frame, the grains read the clip at `rate`. Stops at the region end unless looping.
+std::vector<float> stretch(const std::vector<float>& clip, const ClipStretchAnalysis* analysis, double inc,
+                           double rate, std::size_t outFrames, bool loop, WsolaStretcher* used = nullptr) {
+    WsolaStretcher local;
+    WsolaStretcher& st = used ? *used : local;
+    WsolaSource src{};
+    src.c0 = clip.data();
+    src.frames = static_cast<int>(clip.size());
+    src.regionStart = 0.0;
+    src.regionEnd = static_cast<double>(clip.size());
+    src.loop = loop;
+    src.analysis = analysis;
+
+    std::vector<float> out(outFrames, 0.0f);
+    double ph = 0.0;
+    std::size_t produced = 0;
+    while (produced < outFrames) {
+        if (ph >= src.regionEnd) {
+            if (!loop) {
+                break;
+            }
+            ph -= src.regionEnd;
+        }
+        // 256-frame host blocks, split at the region end like renderStretchChunk_.
+        std::size_t run = std::min<std::size_t>(256, outFrames - produced);
+        run = std::min(run, static_cast<std::size_t>(std::max(1.0, std::ceil((src.regionEnd - ph) / inc))));
+        const std::size_t n = st.render(src, ph, rate, 1.0f, out.data() + produced, nullptr, run);
+        REQUIRE(n > 0);
+        ph += static_cast<double>(n) * inc;
+        produced += n;
+    }
+    out.resize(produced);
+    return out;
+}
+
+double zeroCrossingHz(const std::vector<float>& y, std::size_t from, std::size_t to) {
+    int crossings = 0;
+    for (std::size_t i = from + 1; i < to; ++i) {
+        if ((y[i - 1] < 0.0f) != (y[i] < 0.0f)) {
+            ++crossings;
+        }
+    }
+    return 0.5 * crossings * kRate / static_cast<double>(to - from);
+}
+
+// Peaks above `level` at least `minGap` frames apart.
+std::vector<std::size_t> peaks(const std::vector<float>& y, float level, std::size_t minGap, float& minPeak) {
+    std::vector<std::size_t> at;
+    minPeak = 1e9f;
+    std::size_t i = 0;
+    while (i < y.size()) {
+        if (std::fabs(y[i]) < level) {
+            ++i;
+            continue;
+        }
+        float peak = 0.0f;
+        const std::size_t end = std::min(y.size(), i + minGap);
+        for (std::size_t k = i; k < end; ++k) {
+            peak = std::max(peak, std::fabs(y[k]));
+        }
+        at.push_back(i);
+        minPeak = std::min(minPeak, peak);
+        i = end;
+    }
+    return at;
+}
+
+} // namespace
+
+TEST_CASE("WsolaStretcher: playhead speed equal to the read rate reproduces the clip") {
+    std::vector<float> clip = sine(441.0, 20000);
+    // Broadband content on top, so a wrong splice could not hide behind periodicity.
+    uint32_t seed = 1;
+    for (float& x : clip) {
+        seed = seed * 1664525u + 1013904223u;
+        x += 0.1f * (static_cast<float>(seed >> 8) / 8388608.0f - 1.0f);
+    }
+    const auto analysis = analyzeClipForStretch(clip.data(), nullptr, static_cast<int>(clip.size()));
+    REQUIRE(analysis);
+
+    // 2.5 passes of a looped region: wraps must be seamless too.
+    const std::vector<float> out = stretch(clip, analysis.get(), 1.0, 1.0, 50000, true);
+    REQUIRE(out.size() == 50000u);
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        REQUIRE(out[i] == Catch::Approx(clip[i % clip.size()]).margin(1e-5));
+    }
+}
+
+TEST_CASE("WsolaStretcher: tempo change keeps the pitch of a tone") {
+    const std::vector<float> clip = sine(440.0, kRate);
+    const auto analysis = analyzeClipForStretch(clip.data(), nullptr, kRate);
+    REQUIRE(analysis);
+
+    for (const double inc : {0.75, 1.33}) {
+        const std::size_t frames = static_cast<std::size_t>(kRate / inc) - 1024;
+        WsolaStretcher st;
+        const std::vector<float> out = stretch(clip, analysis.get(), inc, 1.0, frames, false, &st);
+        REQUIRE(out.size() == frames);
+        // Varispeed at this speed would play 440 * inc Hz.
+        REQUIRE(zeroCrossingHz(out, 2048, out.size() - 2048) == Catch::Approx(440.0).epsilon(0.01));
+
+        // Splices stay in phase: no dips in the envelope.
+        for (std::size_t w = 2048; w + 1024 < out.size() - 2048; w += 1024) {
+            double acc = 0.0;
+            for (std::size_t k = 0; k < 1024; ++k) {
+                acc += static_cast<double>(out[w + k]) * out[w + k];
+            }
+            const double rms = std::sqrt(acc / 1024.0);
+            REQUIRE(rms == Catch::Approx(0.5 / std::sqrt(2.0)).epsilon(0.05));
+        }
+        REQUIRE(st.grains() > 0u);
+    }
+}
+
+TEST_CASE("WsolaStretcher: attacks are neither doubled nor dropped") {
+    const std::vector<float> clip = clicks(kRate, 1000, 4800);
+    const auto analysis = analyzeClipForStretch(clip.data(), nullptr, kRate);
+    REQUIRE(analysis);
+    REQUIRE(analysis->onsets.size() == 10u);
+
+    for (const double inc : {0.5, 1.5}) {
+        WsolaStretcher st;
+        const std::vector<float> out =
+            stretch(clip, analysis.get(), inc, 1.0, static_cast<std::size_t>(kRate / inc) + 1, false, &st);
+        float minPeak = 0.0f;
+        const std::vector<std::size_t> at = peaks(out, 0.3f, 1024, minPeak);
+        REQUIRE(at.size() == 10u);
+        // The overlapping grains carry an attack in phase: it keeps its level.
+        REQUIRE(minPeak > 0.8f);
+        // And it lands where the playhead reaches it (within a grain).
+        for (std::size_t i = 0; i < at.size(); ++i) {
+            const double expected = (1000.0 + 4800.0 * static_cast<double>(i)) / inc;
+            REQUIRE(std::fabs(static_cast<double>(at[i]) - expected) < static_cast<double>(WsolaStretcher::kGrain));
+        }
+        REQUIRE(st.onsetHolds() > 0u);
+    }
+}